@@ -23,7 +23,7 @@ import os
 import string
 import sys
 import textwrap
-from typing import cast, List, Mapping, Union
+from typing import cast, Dict, List, Mapping, Union
 
 from . import ast
 from . import bson
@@ -70,6 +70,22 @@ def _get_field_constant_name(field):
         'k${constant_name}FieldName', constant_name=common.title_case(field.cpp_name))
 
 
+def _get_field_predicate(field):
+    # type: (ast.Field) -> unicode
+    """
+    Get the C++ check that fieldName names a field.
+
+    The caller has already dispatched on the length of fieldName, so the first character is checked
+    inline before falling back to a full comparison.
+    """
+    if not field.name:
+        return 'fieldName == %s' % (_get_field_constant_name(field))
+
+    first_char = field.name[0].replace('\\', '\\\\').replace("'", "\\'")
+    return "fieldName[0] == '%s' && fieldName == %s" % (first_char,
+                                                         _get_field_constant_name(field))
+
+
 def _access_member(field):
     # type: (ast.Field) -> unicode
     """Get the declaration to access a member for a field."""
@@ -965,7 +981,7 @@ class _CppSourceFileWriter(_CppFileWriterBase):
     def _gen_fields_deserializer_common(self, struct, bson_object):
         # type: (ast.Struct, unicode) -> _FieldUsageCheckerBase
         """Generate the C++ code to deserialize list of fields."""
-        # pylint: disable=too-many-branches
+        # pylint: disable=too-many-branches,too-many-nested-blocks
         field_usage_check = _get_field_usage_checker(self._writer, struct)
         if isinstance(struct, ast.Command):
             self._writer.write_line('BSONElement commandElement;')
@@ -991,41 +1007,55 @@ class _CppSourceFileWriter(_CppFileWriterBase):
             field_usage_check.add_store("fieldName")
             self._writer.write_empty_line()
 
-            first_field = True
+            # Dispatch on the length of the field name first so that each element is compared
+            # against at most the handful of known fields which share its length, instead of
+            # against every field of the struct.
+            fields_by_length = {}  # type: Dict[int, List[ast.Field]]
             for field in struct.fields:
                 # Do not parse chained fields as fields since they are actually chained types.
                 if field.chained and not field.chained_struct_field:
                     continue
 
-                field_predicate = 'fieldName == %s' % (_get_field_constant_name(field))
+                fields_by_length.setdefault(len(field.name), []).append(field)
 
-                with self._predicate(field_predicate, not first_field):
-                    field_usage_check.add(field, "element")
+            if fields_by_length:
+                with self._block('switch (fieldName.size()) {', '}'):
+                    for length in sorted(fields_by_length):
+                        with self._block('case %d: {' % (length), '}'):
+                            for field in fields_by_length[length]:
+                                with self._predicate(_get_field_predicate(field)):
+                                    field_usage_check.add(field, "element")
 
-                    if field.ignore:
-                        self._writer.write_line('// ignore field')
-                    else:
-                        if _is_required_serializer_field(field):
-                            self._writer.write_line('%s = true;' %
-                                                    (_get_has_field_member_name(field)))
+                                    if field.ignore:
+                                        self._writer.write_line('// ignore field')
+                                    else:
+                                        if _is_required_serializer_field(field):
+                                            self._writer.write_line('%s = true;' % (
+                                                _get_has_field_member_name(field)))
 
-                        self.gen_field_deserializer(field, bson_object)
+                                        self.gen_field_deserializer(field, bson_object)
 
-                if first_field:
-                    first_field = False
+                                    self._writer.write_line('continue;')
+
+                            self._writer.write_line('break;')
+
+                    self._writer.write_line('default:')
+                    self._writer.indent()
+                    self._writer.write_line('break;')
+                    self._writer.unindent()
+                self._writer.write_empty_line()
 
             # End of for fields
             # Generate strict check for extranous fields
             if struct.strict:
-                with self._block('else {', '}'):
-                    # For commands, check if this a well known command field that the IDL parser
-                    # should ignore regardless of strict mode.
-                    command_predicate = None
-                    if isinstance(struct, ast.Command):
-                        command_predicate = "!Command::isGenericArgument(fieldName)"
-
-                    with self._predicate(command_predicate):
-                        self._writer.write_line('ctxt.throwUnknownField(fieldName);')
+                # For commands, check if this a well known command field that the IDL parser
+                # should ignore regardless of strict mode.
+                command_predicate = None
+                if isinstance(struct, ast.Command):
+                    command_predicate = "!Command::isGenericArgument(fieldName)"
+
+                with self._predicate(command_predicate):
+                    self._writer.write_line('ctxt.throwUnknownField(fieldName);')
 
         # Parse chained structs if not inlined
         # Parse chained types always here
@@ -0,0 +1,72 @@
+// Tests that a $group which outputs the distinct values of an indexed field is answered with a
+// DISTINCT_SCAN, and that it returns the same groups as when every document is examined.
+//
+// Cannot implicitly shard accessed collections because the explain output from a mongod when run
+// against a sharded collection is wrapped in a "shards" object with keys for each shard.
+//
+// This test assumes that an initial $match will be absorbed by the query system, which will not
+// happen if the $match is wrapped within a $facet stage.
+// @tags: [do_not_wrap_aggregations_in_facets,assumes_unsharded_collection]
+load('jstests/libs/analyze_plan.js');
+
+(function() {
+    "use strict";
+
+    const coll = db.group_distinct_scan;
+    coll.drop();
+
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({a: i % 4, b: i}));
+    }
+    assert.writeOK(coll.insert({a: null, b: 100}));
+    assert.writeOK(coll.insert({b: 101}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    function usesDistinctScan(pipeline) {
+        const explained = coll.explain().aggregate(pipeline);
+        return explained.hasOwnProperty("stages") &&
+            planHasStage(explained.stages[0].$cursor.queryPlanner.winningPlan, "DISTINCT_SCAN");
+    }
+
+    function sortedIds(pipeline) {
+        return coll.aggregate(pipeline).toArray().map(doc => doc._id).sort();
+    }
+
+    function assertSameGroups(pipeline) {
+        const expected =
+            coll.aggregate(pipeline, {hint: {$natural: 1}}).toArray().map(doc => doc._id).sort();
+        assert.eq(expected, sortedIds(pipeline), tojson(pipeline));
+    }
+
+    let pipeline = [{$group: {_id: "$a"}}];
+    assert(usesDistinctScan(pipeline));
+    assertSameGroups(pipeline);
+    assert.eq([0, 1, 2, 3, null], sortedIds(pipeline));
+
+    pipeline = [{$match: {a: {$gte: 2}}}, {$group: {_id: "$a"}}];
+    assert(usesDistinctScan(pipeline));
+    assertSameGroups(pipeline);
+
+    // A $group with accumulators needs every document.
+    pipeline = [{$group: {_id: "$a", count: {$sum: 1}}}];
+    assert(!usesDistinctScan(pipeline));
+
+    // Grouping on a field which is not a prefix of an index with an empty query cannot use the
+    // index.
+    pipeline = [{$group: {_id: "$b"}}];
+    assert(!usesDistinctScan(pipeline));
+
+    // Once 'a' holds an array, each array is a group of its own, so the index cannot be used.
+    assert.writeOK(coll.insert({a: [1, 2], b: 102}));
+    pipeline = [{$group: {_id: "$a"}}];
+    assert(!usesDistinctScan(pipeline));
+    assertSameGroups(pipeline);
+
+    // A sparse index has no keys for the documents which are missing the field.
+    coll.drop();
+    assert.writeOK(coll.insert([{a: 1}, {a: 2}, {b: 1}]));
+    assert.commandWorked(coll.createIndex({a: 1}, {sparse: true}));
+    pipeline = [{$group: {_id: "$a"}}];
+    assert(!usesDistinctScan(pipeline));
+    assert.eq([1, 2, null], sortedIds(pipeline));
+}());
@@ -0,0 +1,72 @@
+// Tests that $geoLookup joins each point with the polygons that contain it, matching the results
+// of a $geoWithin query against the polygons' collection for each point.
+load("jstests/aggregation/extras/utils.js");  // For "assertErrorCode".
+
+(function() {
+    'use strict';
+
+    const points = db.geo_lookup_points;
+    const fences = db.geo_lookup_fences;
+    points.drop();
+    fences.drop();
+
+    function square(min, max) {
+        return {
+            type: "Polygon",
+            coordinates: [[[min, min], [max, min], [max, max], [min, max], [min, min]]]
+        };
+    }
+
+    assert.writeOK(fences.insert({_id: "small", area: square(0, 1)}));
+    assert.writeOK(fences.insert({_id: "medium", area: square(0, 10)}));
+    assert.writeOK(fences.insert({_id: "offset", area: square(5, 15)}));
+    assert.writeOK(
+        fences.insert({_id: "line", area: {type: "LineString", coordinates: [[0, 0], [9, 9]]}}));
+    assert.writeOK(fences.insert({_id: "none"}));
+
+    for (let i = 0; i < 40; ++i) {
+        assert.writeOK(points.insert({_id: i, loc: {type: "Point", coordinates: [i / 2, i / 3]}}));
+    }
+    assert.writeOK(points.insert({_id: "legacy", loc: [7, 7]}));
+    assert.writeOK(points.insert({_id: "missing"}));
+    assert.writeOK(points.insert({_id: "notAPoint", loc: "here"}));
+
+    const results = points
+                        .aggregate([
+                            {
+                              $geoLookup: {
+                                  from: fences.getName(),
+                                  localField: "loc",
+                                  foreignField: "area",
+                                  as: "fences"
+                              }
+                            },
+                            {$sort: {_id: 1}}
+                        ])
+                        .toArray();
+    assert.eq(points.count(), results.length);
+
+    results.forEach(function(result) {
+        const ids = result.fences.map(fence => fence._id).sort();
+        let expected = [];
+        if (result.loc !== undefined && typeof result.loc === "object") {
+            // Only polygons can contain a point.
+            expected = fences.find({area: {$exists: true}, "area.type": "Polygon"})
+                           .toArray()
+                           .filter(fence => points.findOne({
+                               _id: result._id,
+                               loc: {$geoWithin: {$geometry: fence.area}}
+                           }) !== null)
+                           .map(fence => fence._id)
+                           .sort();
+        }
+        assert.eq(expected, ids, tojson(result));
+    });
+
+    const legacy = results.find(result => result._id === "legacy");
+    assert.eq(["medium", "offset"], legacy.fences.map(fence => fence._id).sort(), tojson(legacy));
+
+    // The stage requires all of its options.
+    assertErrorCode(
+        points, [{$geoLookup: {from: fences.getName(), localField: "loc", as: "fences"}}], 40696);
+})();
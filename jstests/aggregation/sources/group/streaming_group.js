@@ -0,0 +1,48 @@
+// Tests that a $group on fields the input is sorted by, which streams its groups rather than
+// exhausting its input, returns the same groups as a blocking $group. This includes nullish and
+// array values in the sorted fields.
+(function() {
+    "use strict";
+
+    const coll = db.streaming_group;
+    coll.drop();
+
+    const docs = [
+        {_id: 0, a: 1, b: 1},
+        {_id: 1, a: 1, b: 2},
+        {_id: 2, a: null, b: 1},
+        {_id: 3, b: 1},
+        {_id: 4, a: null, b: 1},
+        {_id: 5},
+        {_id: 6, a: 2, b: 2},
+        {_id: 7, a: 1, b: 1},
+    ];
+    assert.writeOK(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    function groupResults(pipeline) {
+        return coll.aggregate(pipeline).toArray().sort(function(lhs, rhs) {
+            const lhsId = tojson(lhs._id), rhsId = tojson(rhs._id);
+            return lhsId < rhsId ? -1 : (lhsId > rhsId ? 1 : 0);
+        });
+    }
+
+    function assertSameGroups(groupSpec) {
+        const unsorted = groupResults([{$group: groupSpec}]);
+        const sorted = groupResults([{$sort: {a: 1, b: 1}}, {$group: groupSpec}]);
+        assert.eq(unsorted, sorted, tojson(groupSpec));
+    }
+
+    assertSameGroups({_id: {x: "$a", y: "$b"}, count: {$sum: 1}, maxId: {$max: "$_id"}});
+    assertSameGroups({_id: {y: "$b", x: "$a"}, count: {$sum: 1}});
+
+    // Array values take the streaming $group out of streaming mode, but the groups must be the
+    // same and must still come back in sorted order.
+    assert.writeOK(coll.insert({_id: 8, a: [0, 3], b: 1}));
+    assertSameGroups({_id: {x: "$a", y: "$b"}, count: {$sum: 1}});
+
+    const sortedIds = coll.aggregate([{$sort: {a: 1, b: 1}}, {$group: {_id: {x: "$a", y: "$b"}}}])
+                          .toArray()
+                          .map(doc => doc._id);
+    assert.eq(new Set(sortedIds.map(id => tojson(id))).size, sortedIds.length, tojson(sortedIds));
+}());
@@ -0,0 +1,51 @@
+// Tests the 'upsertDocuments' mode of $out, which writes into an existing collection without
+// replacing it.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const source = db.out_upsert_mode_source;
+    const target = db.out_upsert_mode_target;
+    source.drop();
+    target.drop();
+
+    assert.writeOK(source.insert(
+        [{_id: 1, k: "a", v: 1}, {_id: 2, k: "a", v: 2}, {_id: 3, k: "b", v: 3}]));
+    assert.writeOK(target.insert([{_id: "a", total: -1}, {_id: "z", total: 100}]));
+    assert.commandWorked(target.createIndex({total: 1}));
+
+    const rollup = [
+        {$group: {_id: "$k", total: {$sum: "$v"}}},
+        {$out: {to: target.getName(), mode: "upsertDocuments"}}
+    ];
+
+    // Existing documents with a matching _id are replaced, new ones are inserted, and all other
+    // documents and the indexes of the target collection are left alone.
+    source.aggregate(rollup);
+    assert.eq([{_id: "a", total: 3}, {_id: "b", total: 3}, {_id: "z", total: 100}],
+              target.find().sort({_id: 1}).toArray());
+    assert.eq(2, target.getIndexes().length);
+
+    // Running it again only touches the groups produced by the pipeline.
+    assert.writeOK(source.insert({_id: 4, k: "c", v: 4}));
+    source.aggregate([{$match: {k: "c"}}].concat(rollup));
+    assert.eq(
+        [{_id: "a", total: 3}, {_id: "b", total: 3}, {_id: "c", total: 4}, {_id: "z", total: 100}],
+        target.find().sort({_id: 1}).toArray());
+
+    // The default mode still replaces the whole collection.
+    source.aggregate([{$out: {to: target.getName(), mode: "replaceCollection"}}]);
+    assert.eq(source.find().sort({_id: 1}).toArray(), target.find().sort({_id: 1}).toArray());
+
+    // Every document must have an _id in upsert mode.
+    assertErrorCode(source,
+                    [{$project: {_id: 0}}, {$out: {to: target.getName(), mode: "upsertDocuments"}}],
+                    ErrorCodes.BadValue);
+
+    // Malformed specs are rejected.
+    assertErrorCode(source, [{$out: {mode: "upsertDocuments"}}], ErrorCodes.FailedToParse);
+    assertErrorCode(source, [{$out: {to: target.getName(), mode: "merge"}}], ErrorCodes.BadValue);
+    assertErrorCode(source, [{$out: {to: target.getName(), other: 1}}], ErrorCodes.FailedToParse);
+    assertErrorCode(source, [{$out: {to: 1}}], ErrorCodes.TypeMismatch);
+}());
@@ -2260,6 +2260,19 @@ var authCommandsLib = {
               },
           ]
         },
+        {
+          testname: "cpuSamplingProfile",
+          command: {cpuSamplingProfile: 1, durationMillis: 100},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_hostManager,
+                privileges: [{resource: {cluster: true}, actions: ["cpuProfiler"]}]
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "createRole_authenticationRestrictions",
           command: {
@@ -3875,6 +3888,20 @@ var authCommandsLib = {
               }
           ]
         },
+        {
+          testname: "flushHighFrequencyDiagnosticData",
+          command: {flushHighFrequencyDiagnosticData: 1},
+          skipSharded: true,
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}]
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "flushRouterConfig",
           command: {flushRouterConfig: 1},
@@ -138,3 +138,12 @@ explain = db.runCommand(
     {explain: {count: collName, query: {a: 2}, limit: 2}, verbosity: "executionStats"});
 checkCountExplain(explain, 1);
 checkCountScanIndexExplain(explain, {a: 2}, {a: 2}, true, true);
+
+// An $in is counted with one key range per value.
+assert.eq(11, db.runCommand({count: collName, query: {a: {$in: [1, 2]}}}).n);
+explain = db.runCommand(
+    {explain: {count: collName, query: {a: {$in: [1, 2]}}}, verbosity: "executionStats"});
+checkCountExplain(explain, 11);
+checkCountScanIndexExplain(explain, {a: 1}, {a: 2}, true, true);
+var countScan = getPlanStage(explain.executionStats.executionStages, "COUNT_SCAN");
+assert.eq(2, countScan.indexBounds.numKeyRanges);
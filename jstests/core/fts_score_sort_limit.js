@@ -0,0 +1,52 @@
+// Tests that a limited sort on the text score returns the same results as an unlimited sort, even
+// though the TEXT stage is allowed to stop reading postings and skip fetching documents.
+(function() {
+    "use strict";
+
+    const coll = db.fts_score_sort_limit;
+    coll.drop();
+
+    // Give the documents varying term frequencies so that their scores differ.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        const words = ["common"];
+        for (let j = 0; j < i % 7; ++j) {
+            words.push("rare");
+        }
+        for (let j = 0; j < i % 5; ++j) {
+            words.push("filler" + j);
+        }
+        bulk.insert({_id: i, a: words.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: "text"}));
+
+    function textScores(search, limit) {
+        let cursor = coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                         .sort({score: {$meta: "textScore"}});
+        if (limit) {
+            cursor = cursor.limit(limit);
+        }
+        return cursor.toArray().map(doc => doc.score);
+    }
+
+    for (let search of ["common", "rare", "common rare", "rare filler3", "common -filler1"]) {
+        for (let limit of [1, 10, 100, 3000]) {
+            const expected = textScores(search, 0).slice(0, limit);
+            assert.eq(expected,
+                      textScores(search, limit),
+                      "search: " + search + ", limit: " + limit);
+        }
+    }
+
+    // A limited sort on the text score only fetches the documents it returns.
+    const isMongos = db.runCommand({isdbgrid: 1}).isdbgrid;
+    if (!isMongos) {
+        const explain = coll.find({$text: {$search: "common rare"}}, {score: {$meta: "textScore"}})
+                            .sort({score: {$meta: "textScore"}})
+                            .limit(10)
+                            .explain("executionStats");
+        assert.eq(10, explain.executionStats.nReturned, tojson(explain));
+        assert.eq(10, explain.executionStats.totalDocsExamined, tojson(explain));
+    }
+})();
@@ -83,3 +83,55 @@ assert.eq({_id: 1}, t.find({_id: 1}).returnKey().next());
 
 // Non-simple: .returnKey() overrides other projections.
 assert.eq({_id: 1}, t.find({_id: 1}, {a: 1}).returnKey().next());
+
+//
+// Batched ID hack for {_id: {$in: [...]}}.
+//
+
+t.drop();
+for (var i = 0; i < 20; i++) {
+    assert.writeOK(t.insert({_id: i, a: i}));
+}
+assert.writeOK(t.insert({_id: {x: 1}, a: 100}));
+
+function sortedIds(cursor) {
+    return cursor.toArray()
+        .map(function(doc) {
+            return doc._id;
+        })
+        .sort(function(lhs, rhs) {
+            return bsonWoCompare({_: lhs}, {_: rhs});
+        });
+}
+
+// Missing and duplicate _ids are tolerated, and literal objects can be looked up.
+query = {_id: {$in: [7, 3, 30, 3, 12, {x: 1}]}};
+assert.eq([3, 7, 12, {x: 1}], sortedIds(t.find(query)), "H1");
+explain = t.find(query).explain("executionStats");
+assert(isIdhack(explain.queryPlanner.winningPlan), "H2");
+assert.eq(4, explain.executionStats.nReturned, "H3");
+assert.eq(4, explain.executionStats.totalKeysExamined, "H4");
+assert.eq(4, explain.executionStats.totalDocsExamined, "H5");
+
+// Projections and returnKey apply to each document.
+var projected = t.find({_id: {$in: [3, 7]}}, {_id: 0, a: 1}).toArray().map(function(doc) {
+    return doc.a;
+});
+assert.eq([3, 7], projected.sort(), "I1");
+assert.eq([3, 7], sortedIds(t.find({_id: {$in: [3, 7]}}).returnKey()), "I2");
+
+// Queries which order, limit or filter on other fields use the planner.
+assert(!isIdhack(t.find(query).sort({_id: 1}).explain().queryPlanner.winningPlan), "J1");
+assert(!isIdhack(t.find(query).limit(2).explain().queryPlanner.winningPlan), "J2");
+assert(!isIdhack(t.find({_id: {$in: [1, 2]}, a: 1}).explain().queryPlanner.winningPlan), "J3");
+assert(!isIdhack(t.find({_id: {$in: [1, /2/]}}).explain().queryPlanner.winningPlan), "J4");
+assert.eq([1, 2], t.find({_id: {$in: [2, 1]}}).sort({_id: 1}).toArray().map(function(doc) {
+    return doc._id;
+}),
+          "J5");
+
+// Updates and removes by a list of _ids.
+assert.writeOK(t.update({_id: {$in: [4, 5, 6]}}, {$set: {b: 1}}, {multi: true}));
+assert.eq(3, t.find({b: 1}).itcount(), "K1");
+assert.writeOK(t.remove({_id: {$in: [4, 5, 6]}}));
+assert.eq(0, t.find({b: 1}).itcount(), "K2");
@@ -0,0 +1,38 @@
+// Tests that multi-document inserts maintain every index of the collection, including multikey
+// and unique indexes, when their keys are inserted for the whole batch at once.
+(function() {
+    'use strict';
+
+    const coll = db.insert_batch_indexes;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: -1, a: 1}));
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true, sparse: true}));
+
+    const docs = [];
+    for (let i = 0; i < 500; ++i) {
+        docs.push({_id: i, a: (i * 7919) % 500, b: (i % 3 === 0) ? [i, -i] : i});
+    }
+    assert.writeOK(coll.insert(docs));
+
+    assert.eq(500, coll.find().hint({a: 1}).itcount());
+    assert.eq(500, coll.find().hint({b: -1, a: 1}).itcount());
+    assert.eq(1, coll.find({b: -3}).hint({b: -1, a: 1}).itcount());
+    assert.eq(0, coll.find().hint({u: 1}).itcount());
+
+    const sorted = coll.find({}, {_id: 0, a: 1}).sort({a: 1}).hint({a: 1}).toArray();
+    for (let i = 0; i < sorted.length; ++i) {
+        assert.eq(i, sorted[i].a, tojson(sorted[i]));
+    }
+
+    // A duplicate within the batch must only fail that document of an unordered insert.
+    const res = coll.insert([{_id: 1000, u: 1}, {_id: 1001, u: 2}, {_id: 1002, u: 1}],
+                            {ordered: false});
+    assert.writeError(res);
+    assert.eq(1, res.getWriteErrors().length, tojson(res));
+    assert.eq(2, res.getWriteErrors()[0].index, tojson(res));
+    assert.eq(2, coll.find({u: {$exists: true}}).hint({u: 1}).itcount());
+
+    assert.commandWorked(coll.validate({full: true}));
+})();
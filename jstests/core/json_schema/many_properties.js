@@ -0,0 +1,54 @@
+// @tags: [requires_non_retryable_commands]
+
+/**
+ * Tests schemas with many 'properties', some of which are also matched by 'patternProperties'.
+ * Validators resolve the fields of such schemas in a single pass over the document and dispatch
+ * listed property names without running the patterns, which must not change the outcome.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/assert_schema_match.js");
+
+    const coll = db.schema_many_properties;
+
+    const schema = {
+        properties: {
+            _id: {},
+            name: {bsonType: "string", minLength: 1},
+            age: {bsonType: "int", minimum: 0, maximum: 150},
+            phoneNum: {type: "string"},
+            address: {bsonType: "object", required: ["zip"], properties: {zip: {type: "string"}}},
+            tags: {bsonType: "array", maxItems: 3, items: {type: "string"}},
+            score: {type: "number"},
+        },
+        required: ["name"],
+        patternProperties: {Num$: {maxLength: 10}, "^x": {type: "boolean"}},
+        additionalProperties: false,
+    };
+
+    assertSchemaMatch(coll, schema, {name: "a"}, true);
+    assertSchemaMatch(coll, schema, {}, false);
+    assertSchemaMatch(coll, schema, {name: ""}, false);
+    assertSchemaMatch(
+        coll,
+        schema,
+        {name: "a", age: NumberInt(3), phoneNum: "555", address: {zip: "1"}, tags: ["t"], score: 1},
+        true);
+    assertSchemaMatch(coll, schema, {name: "a", age: NumberInt(151)}, false);
+    assertSchemaMatch(coll, schema, {name: "a", age: 3.5}, false);
+    assertSchemaMatch(coll, schema, {name: "a", address: {}}, false);
+    assertSchemaMatch(coll, schema, {name: "a", address: {zip: 1}}, false);
+    assertSchemaMatch(coll, schema, {name: "a", tags: ["t", "u", "v", "w"]}, false);
+    assertSchemaMatch(coll, schema, {name: "a", tags: [1]}, false);
+
+    // 'phoneNum' is listed, but must also satisfy the pattern that matches its name.
+    assertSchemaMatch(coll, schema, {name: "a", phoneNum: "12345678901"}, false);
+
+    // Unlisted fields must match a pattern, and then satisfy it.
+    assertSchemaMatch(coll, schema, {name: "a", houseNum: "12"}, true);
+    assertSchemaMatch(coll, schema, {name: "a", houseNum: "12345678901"}, false);
+    assertSchemaMatch(coll, schema, {name: "a", xFlag: true}, true);
+    assertSchemaMatch(coll, schema, {name: "a", xFlag: 1}, false);
+    assertSchemaMatch(coll, schema, {name: "a", other: 1}, false);
+}());
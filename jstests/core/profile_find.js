@@ -39,6 +39,9 @@
     assert.eq(profileObj.nreturned, 1, tojson(profileObj));
     assert.eq(profileObj.planSummary, "IXSCAN { a: 1 }", tojson(profileObj));
     assert(profileObj.execStats.hasOwnProperty("stage"), tojson(profileObj));
+    if (getBuildInfo().buildEnvironment.target_os === "linux") {
+        assert.gte(profileObj.cpuNanos, 0, tojson(profileObj));
+    }
     assert.eq(profileObj.command.filter, {a: 1}, tojson(profileObj));
     if (isLegacyReadMode) {
         assert.eq(profileObj.command.ntoreturn, -1, tojson(profileObj));
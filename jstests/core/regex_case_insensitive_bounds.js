@@ -0,0 +1,60 @@
+// Tests that case insensitive prefix regexes match the same documents with and without an index,
+// including strings that only match through non-ASCII case folding, and that the index bounds
+// only cover the case variants of the prefix.
+(function() {
+    'use strict';
+
+    const coll = db.regex_case_insensitive_bounds;
+    coll.drop();
+
+    const names = [
+        "john",
+        "John Smith",
+        "JOHNNY",
+        "jOhAnna",
+        "jon",
+        "ajohn",
+        "kate",
+        "Kate",
+        "Kate",  // Kelvin sign, which matches 'k' case insensitively.
+        "ſam",   // Long s, which matches 's' case insensitively.
+        "sam",
+        "mask",
+        "maK",
+    ];
+    names.forEach(function(name, i) {
+        assert.writeOK(coll.insert({_id: i, name: name}));
+    });
+
+    const queries = [
+        {name: /^john/i},
+        {name: /^jo/i},
+        {name: /^kate/i},
+        {name: /^sam/i},
+        {name: /mask/i},
+        {name: /smith/i},
+        {name: /smith/},
+        {name: /^j[a-z]+ smith/i},
+        {name: /n{2}/i},
+    ];
+
+    function ids(query, hint) {
+        return coll.find(query, {_id: 1}).hint(hint).sort({_id: 1}).toArray().map(doc => doc._id);
+    }
+
+    const unindexed = queries.map(query => ids(query, {$natural: 1}));
+
+    assert.commandWorked(coll.createIndex({name: 1}));
+    queries.forEach(function(query, i) {
+        assert.eq(unindexed[i], ids(query, {name: 1}), tojson(query));
+    });
+
+    assert.eq(3, unindexed[0].length, tojson(unindexed[0]));
+    assert.eq(3, unindexed[2].length, tojson(unindexed[2]));
+    assert.eq(2, unindexed[3].length, tojson(unindexed[3]));
+    assert.eq(2, unindexed[4].length, tojson(unindexed[4]));
+
+    // Only keys starting with a case variant of "john" are examined.
+    const explain = coll.find({name: /^john/i}).hint({name: 1}).explain("executionStats");
+    assert.eq(3, explain.executionStats.totalKeysExamined, tojson(explain));
+})();
@@ -0,0 +1,63 @@
+// Tests that an equality query on a field with a unique index is answered by a point lookup on that
+// index without multi-planning, and that the ineligible cases still go through the planner.
+// @tags: [assumes_no_implicit_index_creation]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.unique_index_point_lookup;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({email: 1}, {unique: true}));
+    assert.commandWorked(coll.createIndex({email: 1, name: 1}));
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({_id: i, email: "user" + i + "@example.com", name: "n" + i}));
+    }
+
+    // The unique index answers the lookup directly, so no alternative plan is considered.
+    let explain = coll.find({email: "user7@example.com"}).explain("executionStats");
+    assert.eq(1, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(1, explain.executionStats.totalKeysExamined, tojson(explain));
+    assert(!hasRejectedPlans(explain), tojson(explain));
+    let ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+    assert.neq(null, ixscan, tojson(explain));
+    assert.eq("email_1", ixscan.indexName, tojson(explain));
+
+    // Misses return nothing.
+    assert.eq(0, coll.find({email: "nobody@example.com"}).itcount());
+
+    // Projections are applied on top of the lookup.
+    assert.eq([{name: "n3"}],
+              coll.find({email: "user3@example.com"}, {_id: 0, name: 1}).toArray());
+
+    // A sort or limit is irrelevant to a single result.
+    assert.eq(
+        [{_id: 4}],
+        coll.find({email: "user4@example.com"}, {_id: 1}).sort({name: -1}).limit(1).toArray());
+
+    // Hints, skips and range predicates still go through the planner.
+    explain = coll.find({email: "user7@example.com"}).hint({email: 1, name: 1}).explain();
+    assert.eq("email_1_name_1",
+              getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN").indexName,
+              tojson(explain));
+    assert.eq(0, coll.find({email: "user7@example.com"}).skip(1).itcount());
+    explain = coll.find({email: {$gte: "user7@example.com"}}).explain();
+    assert(hasRejectedPlans(explain), tojson(explain));
+
+    // A string lookup under a non-simple collation cannot use the raw index keys.
+    const caseInsensitive = {locale: "en", strength: 2};
+    assert.eq(1, coll.find({email: "USER7@EXAMPLE.COM"}).collation(caseInsensitive).itcount());
+    coll.drop();
+    assert.commandWorked(
+        coll.createIndex({email: 1}, {unique: true, collation: caseInsensitive}));
+    assert.writeOK(coll.insert({_id: 0, email: "user0@example.com"}));
+    assert.eq(1, coll.find({email: "USER0@EXAMPLE.COM"}).collation(caseInsensitive).itcount());
+    assert.eq(0, coll.find({email: "USER0@EXAMPLE.COM"}).itcount());
+
+    // A multikey unique index is not used for a point lookup.
+    coll.drop();
+    assert.commandWorked(coll.createIndex({tags: 1}, {unique: true}));
+    assert.writeOK(coll.insert({_id: 0, tags: ["a", "b"]}));
+    assert.eq(1, coll.find({tags: "b"}).itcount());
+})();
@@ -501,6 +501,7 @@
         },
         unsetSharding: {skip: isAnInternalCommand},
         update: {command: {update: "view", updates: [{q: {x: 1}, u: {x: 2}}]}, expectFailure: true},
+        updateIndexStats: {command: {updateIndexStats: "view"}, expectFailure: true},
         updateRole: {
             command: {
                 updateRole: "testrole",
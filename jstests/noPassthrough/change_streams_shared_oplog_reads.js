@@ -0,0 +1,76 @@
+// Tests that change streams return the same events, and can still be resumed, when their oplog
+// scans read new entries through the shared oplog reader.
+(function() {
+    "use strict";
+
+    load("jstests/replsets/rslib.js");  // For startSetIfSupportsReadMajority.
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {
+            enableMajorityReadConcern: "",
+            setParameter:
+                {internalQueryShareOplogReads: true, internalQuerySharedOplogReadBatchSize: 3}
+        }
+    });
+    if (!startSetIfSupportsReadMajority(rst)) {
+        jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+        rst.stopSet();
+        return;
+    }
+    rst.initiate();
+
+    const db = rst.getPrimary().getDB("change_streams_shared_oplog_reads");
+    const collNames = ["a", "b", "c"];
+    collNames.forEach(name => assert.commandWorked(db.createCollection(name)));
+
+    // Open several streams on each collection, so that most of them are served by entries another
+    // stream read.
+    const streamsPerColl = 4;
+    const streams = [];
+    collNames.forEach(function(name) {
+        for (let i = 0; i < streamsPerColl; ++i) {
+            streams.push({name: name, cursor: db[name].watch()});
+        }
+    });
+
+    const nDocs = 20;
+    for (let i = 0; i < nDocs; ++i) {
+        collNames.forEach(function(name) {
+            assert.writeOK(db[name].insert({_id: i, coll: name}, {writeConcern: {w: "majority"}}));
+        });
+    }
+
+    let resumeToken;
+    streams.forEach(function(stream) {
+        for (let i = 0; i < nDocs; ++i) {
+            assert.soon(() => stream.cursor.hasNext());
+            const change = stream.cursor.next();
+            assert.eq("insert", change.operationType, tojson(change));
+            assert.eq({_id: i, coll: stream.name}, change.fullDocument, tojson(change));
+            if (stream.name === "a" && i === nDocs / 2) {
+                resumeToken = change._id;
+            }
+        }
+    });
+
+    // A stream resumed from an earlier event returns the rest of the events in order.
+    const resumed = db.a.watch([], {resumeAfter: resumeToken});
+    for (let i = nDocs / 2 + 1; i < nDocs; ++i) {
+        assert.soon(() => resumed.hasNext());
+        assert.eq(i, resumed.next().fullDocument._id);
+    }
+
+    // Events written after the streams caught up are still seen.
+    assert.writeOK(db.a.insert({_id: nDocs, coll: "a"}, {writeConcern: {w: "majority"}}));
+    streams.filter(stream => stream.name === "a").forEach(function(stream) {
+        assert.soon(() => stream.cursor.hasNext());
+        assert.eq(nDocs, stream.cursor.next().fullDocument._id);
+    });
+    assert.soon(() => resumed.hasNext());
+    assert.eq(nDocs, resumed.next().fullDocument._id);
+
+    streams.forEach(stream => stream.cursor.close());
+    resumed.close();
+    rst.stopSet();
+}());
@@ -0,0 +1,34 @@
+// Tests that compact with online: true compacts in rounds, reports the storage size it reclaimed,
+// and is allowed on a primary without force.
+// @tags: [requires_wiredtiger, requires_replication]
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const db = primary.getDB("test");
+    const coll = db.compact_online;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({_id: i, padding: "x".repeat(1000)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: {$gte: 1000}}));
+
+    // An offline compaction still needs force on a primary.
+    assert.commandFailed(db.runCommand({compact: coll.getName()}));
+
+    const res = assert.commandWorked(db.runCommand({compact: coll.getName(), online: true}));
+    assert.gte(res.rounds, 1, tojson(res));
+    assert.lte(res.storageSizeAfter, res.storageSizeBefore, tojson(res));
+    assert.eq(1000, coll.find().itcount());
+
+    assert.commandFailedWithCode(db.runCommand({compact: "does_not_exist", online: true}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    rst.stopSet();
+})();
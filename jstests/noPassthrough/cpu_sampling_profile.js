@@ -0,0 +1,53 @@
+// Tests that the cpuSamplingProfile command returns collapsed stacks tagged with the command and
+// namespace of the operation that was running when each sample was taken.
+(function() {
+    "use strict";
+
+    if (_isWindows()) {
+        return;
+    }
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    const adminDB = conn.getDB("admin");
+    const coll = conn.getDB("test").cpu_sampling_profile;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, x: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Keep the server busy with collection scans while the profiler is running.
+    const awaitShell = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").cpu_sampling_profile;
+        while (db.getSiblingDB("test").stop.findOne() === null) {
+            coll.find({x: {$regex: "y"}}).itcount();
+        }
+    }, conn.port);
+
+    const res = assert.commandWorked(
+        adminDB.runCommand({cpuSamplingProfile: 1, durationMillis: 3000, samplesPerSecond: 500}));
+
+    assert.writeOK(conn.getDB("test").stop.insert({}));
+    awaitShell();
+
+    assert.gt(res.numSamples, 0, tojson(res));
+    assert.eq(false, res.truncated, tojson(res));
+    assert(res.collapsedStacks.some(s => s.startsWith("find test.cpu_sampling_profile;")),
+           tojson(res));
+    for (let stack of res.collapsedStacks) {
+        assert(/ \d+$/.test(stack), stack);
+    }
+
+    // A second profiling window can be opened once the first has closed.
+    assert.commandWorked(adminDB.runCommand({cpuSamplingProfile: 1, durationMillis: 100}));
+
+    assert.commandFailedWithCode(adminDB.runCommand({cpuSamplingProfile: 1, durationMillis: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        adminDB.runCommand({cpuSamplingProfile: 1, durationMillis: 100, samplesPerSecond: 0}),
+        ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,47 @@
+// Tests that with enableDbHashCache dbHash reuses the hash of each collection which has not been
+// written to since it was last hashed, and that every kind of write invalidates it.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {enableDbHashCache: true}});
+    assert.neq(null, conn, "mongod failed to start");
+    const db = conn.getDB("test");
+
+    assert.writeOK(db.a.insert([{_id: 1, x: 1}, {_id: 2, x: 2}]));
+    assert.writeOK(db.b.insert({_id: 1}));
+
+    function dbHash() {
+        const res = db.runCommand({dbHash: 1});
+        assert.commandWorked(res);
+        return res;
+    }
+
+    // Returns the hashes computed with the cache disabled.
+    function uncachedDbHash() {
+        assert.commandWorked(db.adminCommand({setParameter: 1, enableDbHashCache: false}));
+        const res = dbHash();
+        assert.commandWorked(db.adminCommand({setParameter: 1, enableDbHashCache: true}));
+        return res;
+    }
+
+    let res = dbHash();
+    assert.eq(0, res.numCachedCollections, tojson(res));
+    res = dbHash();
+    assert.eq(2, res.numCachedCollections, tojson(res));
+
+    function checkInvalidated(write) {
+        write();
+        const res = dbHash();
+        assert.eq(1, res.numCachedCollections, tojson(res));
+        assert.eq(uncachedDbHash().collections, res.collections);
+        assert.eq(2, dbHash().numCachedCollections);
+    }
+
+    checkInvalidated(() => assert.writeOK(db.a.insert({_id: 3})));
+    checkInvalidated(() => assert.writeOK(db.a.update({_id: 1}, {$inc: {x: 1}})));
+    checkInvalidated(() => assert.writeOK(db.a.update({_id: 2}, {$set: {y: "grown"}})));
+    checkInvalidated(() => assert.writeOK(db.a.remove({_id: 3})));
+    checkInvalidated(() => assert.commandWorked(db.runCommand({emptycapped: "a"})));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,50 @@
+// Tests that repeating a 2dsphere $near query around the same point reuses the cached annulus
+// coverings and returns the same results, and that the cache can be disabled at startup.
+(function() {
+    'use strict';
+
+    function getCoveringCacheMetrics(conn) {
+        return assert.commandWorked(conn.adminCommand({serverStatus: 1}))
+            .metrics.query.geoNear.coveringCache;
+    }
+
+    function runNearQuery(coll) {
+        return coll
+            .find({loc: {$near: {$geometry: {type: "Point", coordinates: [0, 0]}}}}, {_id: 1})
+            .limit(50)
+            .toArray();
+    }
+
+    function setUp(conn) {
+        const coll = conn.getDB("test").geo_near_covering_cache;
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 500; ++i) {
+            bulk.insert({_id: i, loc: {type: "Point", coordinates: [(i % 25) / 10, i / 250]}});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndex({loc: "2dsphere"}));
+        return coll;
+    }
+
+    let conn = MongoRunner.runMongod();
+    let coll = setUp(conn);
+
+    const first = runNearQuery(coll);
+    const afterFirst = getCoveringCacheMetrics(conn);
+    assert.gt(afterFirst.misses, 0, tojson(afterFirst));
+
+    assert.eq(first, runNearQuery(coll));
+    const afterSecond = getCoveringCacheMetrics(conn);
+    assert.gt(afterSecond.hits, afterFirst.hits, tojson(afterSecond));
+    assert.eq(afterSecond.misses, afterFirst.misses, tojson(afterSecond));
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod({setParameter: {internalQueryS2GeoNearCoveringCacheSize: 0}});
+    coll = setUp(conn);
+    assert.eq(first, runNearQuery(coll));
+    assert.eq(first, runNearQuery(coll));
+    const disabled = getCoveringCacheMetrics(conn);
+    assert.eq(0, disabled.hits, tojson(disabled));
+    assert.eq(0, disabled.misses, tojson(disabled));
+    MongoRunner.stopMongod(conn);
+})();
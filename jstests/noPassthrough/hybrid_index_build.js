@@ -0,0 +1,77 @@
+// Tests that a hybrid background index build applies the writes made while it bulk loads the
+// index, and leaves an index consistent with the collection.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+    load("jstests/noPassthrough/libs/index_build.js");
+
+    const conn = MongoRunner.runMongod({setParameter: "useHybridIndexBuilds=true"});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.hybrid_index_build;
+    coll.drop();
+
+    const nDocs = 100;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'alwaysOn'}));
+    const createIdx = startParallelShell(
+        "assert.commandWorked(db.getSiblingDB('test').runCommand({" +
+            "    createIndexes: 'hybrid_index_build'," +
+            "    indexes: [" +
+            "        {key: {a: 1}, name: 'a_1', background: true}," +
+            "        {key: {a: 1, b: 1}, name: 'a_1_b_1', background: true," +
+            "         partialFilterExpression: {b: {$exists: true}}}" +
+            "    ]}));",
+        conn.port);
+    assert.soon(function() {
+        return getIndexBuildOpId(testDB) != -1;
+    }, "Index build operation not found after starting via parallelShell");
+
+    // Writes made while the collection is scanned must not be lost, whether or not the scan has
+    // already seen the documents they change.
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.update({_id: i}, {$set: {a: -i}}));
+    }
+    assert.writeOK(coll.remove({_id: {$gte: 20, $lt: 30}}));
+    for (let i = nDocs; i < nDocs + 20; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i}));
+    }
+    assert.writeOK(coll.update({_id: 40}, {$set: {a: [1000, 1001]}}));
+    assert.writeOK(coll.update({_id: 41}, {$set: {b: 1}}));
+    assert.writeOK(coll.update({_id: 1}, {$set: {a: 1}}));
+
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'off'}));
+    assert.soon(function() {
+        return getIndexBuildOpId(testDB) == -1;
+    });
+    assert.eq(0, createIdx(), 'expected shell to exit cleanly');
+
+    const res = assert.commandWorked(coll.validate({full: true}));
+    assert(res.valid, tojson(res));
+
+    assert.eq(coll.find().itcount(), coll.find().hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: -5}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 5}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 1}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 25}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: nDocs + 5}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 1001}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 40}).hint({a: 1}).itcount());
+
+    const explain = coll.find({a: 1000}).hint({a: 1}).explain();
+    assert(getPlanStage(explain.queryPlanner.winningPlan, 'IXSCAN').isMultiKey, tojson(explain));
+
+    // Only documents with 'b' belong to the partial index.
+    assert.eq(21, coll.find({b: {$exists: true}}).hint({a: 1, b: 1}).itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
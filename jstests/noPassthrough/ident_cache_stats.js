@@ -0,0 +1,64 @@
+// Tests that $collStats, $indexStats and FTDC report the storage engine cache residency and I/O
+// statistics of collections and indexes.
+(function() {
+    "use strict";
+
+    const storageEngine = jsTest.options().storageEngine || "wiredTiger";
+    if (storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storage engine is not wiredTiger: " + storageEngine);
+        return;
+    }
+
+    const conn = MongoRunner.runMongod({setParameter: {diagnosticDataCollectionIdentCacheTopN: 5}});
+    assert.neq(null, conn, "mongod failed to start");
+    const testDB = conn.getDB("test");
+    const coll = testDB.ident_cache_stats;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+    assert.eq(1, coll.find({a: 50}).itcount());
+
+    function assertCacheStats(stats) {
+        assert(stats.hasOwnProperty("bytesInCache"), tojson(stats));
+        assert(stats.hasOwnProperty("pagesEvicted"), tojson(stats));
+        assert.gte(stats.cursorInserts, 100, tojson(stats));
+    }
+
+    // $collStats reports the collection and each of its indexes.
+    const collStats = coll.aggregate([{$collStats: {cacheStats: {}}}]).toArray();
+    assert.eq(1, collStats.length, tojson(collStats));
+    const cacheStats = collStats[0].cacheStats;
+    assertCacheStats(cacheStats.collection);
+    assertCacheStats(cacheStats.indexes._id_);
+    assertCacheStats(cacheStats.indexes.a_1);
+    assert.gte(cacheStats.indexes.a_1.cursorSearches, 1, tojson(cacheStats));
+
+    assert.commandFailedWithCode(
+        testDB.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$collStats: {cacheStats: 1}}], cursor: {}}),
+        40691);
+
+    // $indexStats attaches the cache statistics of each index.
+    const indexStats = coll.aggregate([{$indexStats: {}}]).toArray();
+    assert.eq(2, indexStats.length, tojson(indexStats));
+    indexStats.forEach(function(index) {
+        assertCacheStats(index.cache);
+    });
+
+    // FTDC samples the idents with the most bytes in the cache.
+    const adminDB = conn.getDB("admin");
+    assert.soon(function() {
+        const data = assert.commandWorked(adminDB.runCommand("getDiagnosticData")).data;
+        return data.hasOwnProperty("identCache") &&
+            Object.keys(data.identCache).filter(k => k !== "start" && k !== "end").length > 0;
+    }, "getDiagnosticData did not report identCache");
+
+    assert.commandFailed(
+        adminDB.runCommand({setParameter: 1, diagnosticDataCollectionIdentCacheTopN: 1001}));
+    assert.commandWorked(
+        adminDB.runCommand({setParameter: 1, diagnosticDataCollectionIdentCacheTopN: 0}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,48 @@
+// Tests that the indexAdvisor command proposes indexes for query shapes which examine far more
+// documents than they return, and lists the indexes no query has used.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const testDB = conn.getDB('test');
+    const coll = testDB.index_advisor;
+
+    assert.commandFailedWithCode(testDB.runCommand({indexAdvisor: 'missing'}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    for (let i = 0; i < 200; i++) {
+        assert.writeOK(coll.insert({a: i, b: i % 10, c: i}));
+    }
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    // Each of these scans the whole collection to return one document.
+    for (let i = 0; i < 5; i++) {
+        assert.eq(1, coll.find({a: i, c: {$gte: 0}}).sort({c: -1}).itcount());
+    }
+
+    let res = assert.commandWorked(testDB.runCommand({indexAdvisor: coll.getName()}));
+    assert.eq(1, res.candidates.length, tojson(res));
+    assert.eq({a: 1, c: -1}, res.candidates[0].key, tojson(res));
+    assert.eq(5, res.candidates[0].numQueries, tojson(res));
+    assert.gt(res.candidates[0].estimatedExaminedSaved, 5 * 150, tojson(res));
+    assert.eq({a: 0, c: {$gte: 0}}, res.candidates[0].exampleShape.query, tojson(res));
+    assert.eq(['b_1'],
+              res.unusedIndexes.map(function(index) {
+                  return index.name;
+              }),
+              tojson(res));
+
+    // Once the proposed index exists it is no longer a candidate, and it is not unused.
+    assert.commandWorked(coll.createIndex(res.candidates[0].key));
+    assert.eq(1, coll.find({a: 7, c: {$gte: 0}}).sort({c: -1}).itcount());
+    res = assert.commandWorked(testDB.runCommand({indexAdvisor: coll.getName()}));
+    assert.eq(0, res.candidates.length, tojson(res));
+    assert.eq(['b_1'],
+              res.unusedIndexes.map(function(index) {
+                  return index.name;
+              }),
+              tojson(res));
+
+    MongoRunner.stopMongod(conn);
+})();
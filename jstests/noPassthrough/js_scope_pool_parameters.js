@@ -0,0 +1,36 @@
+// Tests that $where keeps working as the JavaScript scope pool parameters change, including when
+// scopes are not pooled at all.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {jsScopeMaxReuse: 1000}});
+    assert.neq(null, conn, "mongod failed to start");
+    const testDB = conn.getDB("test");
+    const coll = testDB.js_scope_pool_parameters;
+    coll.drop();
+
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+
+    function runWhereQueries() {
+        for (let i = 0; i < 30; i++) {
+            const where = "this._id < " + (i % 10);
+            assert.eq(i % 10, coll.find({$where: where}).itcount(), where);
+        }
+    }
+
+    runWhereQueries();
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, jsScopeMaxCachedFunctions: 2}));
+    runWhereQueries();
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, jsScopePoolSize: 0}));
+    runWhereQueries();
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, jsScopePoolSize: 2, jsScopeMaxReuse: 0}));
+    runWhereQueries();
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,46 @@
+// Tests that lock waits are recorded by the lock contention sampler and surfaced through the
+// $lockContention aggregation stage and the lockContention serverStatus section.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {lockContentionSampleMinWaitMicros: 0}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const admin = conn.getDB('admin');
+    const testDB = conn.getDB('test');
+    assert.writeOK(testDB.contended.insert({_id: 0}));
+
+    // The stage may only be run against the database, with an empty specification.
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: 'contended', pipeline: [{$lockContention: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        admin.runCommand({aggregate: 1, pipeline: [{$lockContention: {x: 1}}], cursor: {}}),
+        ErrorCodes.BadValue);
+
+    // Hold the global lock in S mode so that a write has to wait for it.
+    assert.commandWorked(admin.runCommand({fsync: 1, lock: true}));
+    const awaitInsert = startParallelShell(function() {
+        assert.writeOK(db.getSiblingDB('test').contended.insert({_id: 1}));
+    }, conn.port);
+
+    assert.soon(function() {
+        return admin.currentOp({waitingForLock: true}).inprog.length > 0;
+    });
+    sleep(100);
+    assert.commandWorked(admin.fsyncUnlock());
+    awaitInsert();
+
+    const samples = admin.aggregate([{$lockContention: {}}]).toArray();
+    const globalWaits = samples.filter(function(sample) {
+        return sample.resourceType === 'Global' && sample.mode === 'IX' &&
+            sample.result === 'granted';
+    });
+    assert.gt(globalWaits.length, 0, tojson(samples));
+    assert.gte(globalWaits[0].waitMicros, 100 * 1000, tojson(globalWaits));
+
+    const stats = assert.commandWorked(admin.runCommand({serverStatus: 1})).lockContention;
+    assert.gte(stats.samplesRecorded, globalWaits.length, tojson(stats));
+    assert.gt(stats.sampledWaitMicros, 0, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,76 @@
+// Tests that map and reduce functions which mapReduce runs natively produce the same results as
+// running them in JavaScript.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    const testDB = conn.getDB("test");
+    const coll = testDB.mr_native_functions;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        const doc = {k: "key" + (i % 17), v: i % 7 === 0 ? NumberInt(i) : i + 0.25};
+        if (i % 11 === 0) {
+            doc.v = NumberLong(i);
+        } else if (i % 13 === 0) {
+            doc.v = NumberDecimal("1.5");
+        } else if (i % 19 === 0) {
+            delete doc.v;
+        }
+        if (i % 23 === 0) {
+            doc.k = {nested: NumberInt(i % 3)};
+        } else if (i % 29 === 0) {
+            doc.k = NumberInt(i % 5);
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    const mapOne = function() {
+        emit(this.k, 1);
+    };
+    const mapValue = function() {
+        emit(this.k, this.v);
+    };
+    const reduceSum = function(key, values) {
+        return Array.sum(values);
+    };
+
+    function runMapReduce(map, out) {
+        const res = testDB.runCommand(
+            {mapReduce: coll.getName(), map: map, reduce: reduceSum, out: out});
+        assert.commandWorked(res);
+        if (out.inline) {
+            return res.results;
+        }
+        return testDB[res.result].find().sort({_id: 1}).toArray();
+    }
+
+    function setTranslate(enabled) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalMapReduceTranslateFunctions: enabled}));
+    }
+
+    for (let map of [mapOne, mapValue]) {
+        for (let out of [{inline: 1}, "mr_native_functions_out"]) {
+            setTranslate(false);
+            const expected = runMapReduce(map, out);
+            setTranslate(true);
+            const actual = runMapReduce(map, out);
+
+            // Compare the BSON, so that the numeric types of the results must match as well.
+            assert.eq(bsonWoCompare({r: expected}, {r: actual}), 0, tojson({expected, actual}));
+            assert.eq(expected.length, actual.length);
+            for (let i = 0; i < expected.length; i++) {
+                assert.eq(typeof expected[i].value, typeof actual[i].value, tojson(actual[i]));
+                assert.eq(expected[i].value instanceof NumberLong,
+                          actual[i].value instanceof NumberLong,
+                          tojson(actual[i]));
+            }
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
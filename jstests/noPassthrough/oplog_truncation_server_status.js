@@ -0,0 +1,51 @@
+/**
+ * Tests that serverStatus reports the state of the oplog stones used to truncate the oplog, and
+ * that limiting the number of records truncated at once still keeps the oplog within its
+ * configured size.
+ */
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {oplogSize: 1, setParameter: {oplogTruncateMaxRecordsPerBatch: 100}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+
+    const stats = assert.commandWorked(testDB.serverStatus()).oplogTruncation;
+    assert(stats, "missing oplogTruncation in serverStatus");
+    assert.contains(stats.processingMethod, ["scanning", "sampling"], tojson(stats));
+    assert.gte(stats.totalTimeProcessingMicros, 0, tojson(stats));
+    assert.gt(stats.minBytesPerStone, 0, tojson(stats));
+
+    // Write several times the oplog's size so that the oldest stones must be truncated.
+    const padding = "x".repeat(1024);
+    for (let i = 0; i < 10; ++i) {
+        const bulk = testDB.oplog_truncation.initializeUnorderedBulkOp();
+        for (let j = 0; j < 500; ++j) {
+            bulk.insert({i: i, j: j, padding: padding});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    assert.soon(function() {
+        const stats = assert.commandWorked(testDB.serverStatus()).oplogTruncation;
+        return stats.truncateCount > 0;
+    }, "the oplog was never truncated");
+
+    assert.soon(function() {
+        const oplogStats = primary.getDB("local").oplog.rs.stats();
+        return oplogStats.size <= 2 * oplogStats.maxSize;
+    }, "the oplog kept growing beyond its configured size");
+
+    rst.stopSet();
+})();
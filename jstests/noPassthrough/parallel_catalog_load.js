@@ -0,0 +1,40 @@
+/**
+ * Tests that a mongod opening its collections on several threads at startup finds all of them,
+ * along with their documents and indexes.
+ * @tags: [requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    let conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const numDbs = 12;
+    const numCollsPerDb = 5;
+    for (let i = 0; i < numDbs; i++) {
+        const testDB = conn.getDB("parallel_catalog_load_" + i);
+        for (let j = 0; j < numCollsPerDb; j++) {
+            const coll = testDB["coll" + j];
+            assert.writeOK(coll.insert({_id: j, x: i}));
+            assert.commandWorked(coll.createIndex({x: 1}));
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: conn, cleanData: false, setParameter: "storageCatalogLoadThreads=4"});
+    assert.neq(null, conn, "mongod failed to restart");
+
+    for (let i = 0; i < numDbs; i++) {
+        const testDB = conn.getDB("parallel_catalog_load_" + i);
+        assert.eq(numCollsPerDb, testDB.getCollectionNames().length, testDB.getName());
+        for (let j = 0; j < numCollsPerDb; j++) {
+            const coll = testDB["coll" + j];
+            assert.eq([{_id: j, x: i}], coll.find().toArray());
+            assert.eq(2, coll.getIndexes().length, coll.getFullName());
+            assert.eq(1, coll.find({x: i}).hint({x: 1}).itcount());
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,28 @@
+// Tests that with deferProfilerWrites set, profiled operations are written to system.profile by a
+// background writer.
+(function() {
+    'use strict';
+
+    var mongod = MongoRunner.runMongod({setParameter: {deferProfilerWrites: true}});
+    assert.neq(null, mongod, 'mongod was unable to start up');
+    var testDB = mongod.getDB(jsTest.name());
+    var coll = testDB.coll;
+
+    assert.writeOK(coll.insert({a: 1}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    for (var i = 0; i < 10; ++i) {
+        assert.eq(1, coll.find({a: 1}).comment('deferred_' + i).itcount());
+    }
+
+    // The entries show up once the background writer gets to them.
+    assert.soon(function() {
+        return testDB.system.profile.find({'command.comment': /^deferred_/}).itcount() === 10;
+    }, 'profile entries were not written: ' + tojson(testDB.system.profile.find().toArray()));
+
+    var serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert.eq(0, serverStatus.metrics.profiler.writesDropped, tojson(serverStatus.metrics));
+
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    MongoRunner.stopMongod(mongod);
+})();
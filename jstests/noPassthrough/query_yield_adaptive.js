@@ -0,0 +1,40 @@
+// Tests that under adaptive yielding, a query only yields at its periodic yield checks when
+// yielding would help another operation or its storage snapshot has grown old.
+(function() {
+    'use strict';
+
+    var mongod = MongoRunner.runMongod({});
+    assert.neq(null, mongod, 'mongod was unable to start up');
+    var db = mongod.getDB('test');
+    var coll = db.getCollection(jsTest.name());
+
+    for (var i = 0; i < 400; ++i) {
+        assert.writeOK(coll.insert({}));
+    }
+
+    // Check whether to yield every 10 work cycles. The whole result set is returned in a single
+    // batch, so the number of "saveState" calls is the number of yields.
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 10}));
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 10000}));
+
+    function countYields() {
+        var explainRes = coll.find().batchSize(1000).explain('executionStats');
+        return explainRes.executionStats.executionStages.saveState;
+    }
+
+    // Without adaptive yielding, every check yields.
+    assert.gte(countYields(), 400 / 10 / 2);
+
+    // With adaptive yielding and nothing waiting on the query, the checks do not yield.
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryExecYieldAdaptive: true}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecYieldMaxSnapshotAgeMS: 1000 * 1000}));
+    assert.lt(countYields(), 5);
+
+    // A snapshot which has been held too long makes the checks yield again.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecYieldMaxSnapshotAgeMS: 0}));
+    assert.gte(countYields(), 400 / 10 / 2);
+
+    MongoRunner.stopMongod(mongod);
+})();
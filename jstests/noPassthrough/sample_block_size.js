@@ -0,0 +1,48 @@
+// Tests that a larger internalDocumentSourceSampleBlockSize lets $sample serve proportionally larger
+// samples from a storage engine random cursor, and that the samples still contain no duplicates.
+// @tags: [requires_wiredtiger]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod failed to start");
+    const db = conn.getDB("test");
+    const coll = db.sample_block_size;
+
+    const nDocs = 10000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, padding: "abcdefghijklmnopqrstuvwxyz"});
+    }
+    assert.writeOK(bulk.execute());
+
+    function usesRandomCursor(sampleSize) {
+        const explain = coll.explain().aggregate([{$sample: {size: sampleSize}}]);
+        return explain.stages.some((stage) => stage.hasOwnProperty("$sampleFromRandomCursor"));
+    }
+
+    function checkSample(sampleSize) {
+        const results = coll.aggregate([{$sample: {size: sampleSize}}]).toArray();
+        assert.eq(sampleSize, results.length);
+        const seen = new Set();
+        results.forEach((doc) => {
+            assert(!seen.has(doc._id), "$sample returned the same document twice: " + doc._id);
+            seen.add(doc._id);
+        });
+    }
+
+    // A 10% sample is too large for per-record random sampling.
+    const sampleSize = nDocs / 10;
+    assert(!usesRandomCursor(sampleSize));
+    checkSample(sampleSize);
+
+    // With blocks of 16 records only one random seek is needed per block.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceSampleBlockSize: 16}));
+    assert(usesRandomCursor(sampleSize));
+    for (let i = 0; i < 10; ++i) {
+        checkSample(sampleSize);
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,60 @@
+// Tests that operations slower than slowms are kept by the slow operation recorder, together with
+// the execution stats of their plans, and surfaced through the $slowOps aggregation stage.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({slowms: 0});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const admin = conn.getDB('admin');
+    const testDB = conn.getDB('test');
+    const coll = testDB.slow_op_recorder;
+
+    // The stage may only be run against the database, with an empty specification.
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: coll.getName(), pipeline: [{$slowOps: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        admin.runCommand({aggregate: 1, pipeline: [{$slowOps: {x: 1}}], cursor: {}}),
+        ErrorCodes.BadValue);
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i % 10}));
+    }
+    assert.eq(10, coll.find({a: 3}).comment('slow_op_recorder_find').itcount());
+
+    const finds =
+        admin
+            .aggregate([
+                {$slowOps: {}},
+                {$match: {ns: coll.getFullName(), 'command.comment': 'slow_op_recorder_find'}}
+            ])
+            .toArray();
+    assert.eq(1, finds.length, tojson(finds));
+    const find = finds[0];
+    assert.eq('COLLSCAN', find.planSummary, tojson(find));
+    assert.eq(100, find.docsExamined, tojson(find));
+    assert.eq('COLLSCAN', find.execStats.stage, tojson(find));
+    assert.eq(100, find.execStats.docsExamined, tojson(find));
+    assert(find.execStats.hasOwnProperty('works'), tojson(find));
+    assert(find.execStats.hasOwnProperty('executionTimeMillisEstimate'), tojson(find));
+    assert(find.hasOwnProperty('millis'), tojson(find));
+
+    // Recording does not write to system.profile.
+    assert.eq(0, testDB.system.profile.find().itcount());
+
+    // The recorder keeps at most slowOpRecorderMaxEntries operations.
+    assert.commandWorked(admin.runCommand({setParameter: 1, slowOpRecorderMaxEntries: 5}));
+    for (let i = 0; i < 10; i++) {
+        coll.findOne({_id: i});
+    }
+    assert.lte(admin.aggregate([{$slowOps: {}}]).itcount(), 5);
+
+    assert.commandFailed(admin.runCommand({setParameter: 1, slowOpRecorderMaxEntries: -1}));
+    assert.commandWorked(admin.runCommand({setParameter: 1, slowOpRecorderMaxEntries: 0}));
+    // Verify that setting it to zero stops recording.
+    const before = admin.aggregate([{$slowOps: {}}]).itcount();
+    coll.findOne({_id: 1});
+    assert.eq(before, admin.aggregate([{$slowOps: {}}]).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
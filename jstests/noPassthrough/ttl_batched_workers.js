@@ -0,0 +1,66 @@
+// Tests that TTL workers expire documents from several indexes concurrently in batches and report
+// per-index statistics.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorNumWorkers: 2, ttlMonitorBatchSize: 10}
+    });
+    assert.neq(null, conn, "mongod failed to start");
+    const testDB = conn.getDB("test");
+
+    const numDocs = 95;
+    const past = new Date(Date.now() - 60 * 60 * 1000);
+    for (let collName of ["ttl_batched_a", "ttl_batched_b"]) {
+        const coll = testDB[collName];
+        coll.drop();
+        assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < numDocs; i++) {
+            bulk.insert({x: new Date(past.getTime() + i)});
+        }
+        // Not expired.
+        bulk.insert({x: new Date(Date.now() + 60 * 60 * 1000)});
+        assert.writeOK(bulk.execute());
+    }
+
+    function getIndexStats(collName) {
+        const indexes = testDB.serverStatus().metrics.ttl.indexes;
+        return indexes.find((index) => index.ns === "test." + collName && index.name === "x_1");
+    }
+
+    assert.soon(function() {
+        return testDB.ttl_batched_a.count() === 1 && testDB.ttl_batched_b.count() === 1;
+    }, "TTL monitor didn't expire documents before timing out.");
+
+    for (let collName of ["ttl_batched_a", "ttl_batched_b"]) {
+        let stats;
+        assert.soon(function() {
+            stats = getIndexStats(collName);
+            return stats && stats.deletedDocuments === numDocs && !stats.inProgress;
+        }, () => "unexpected stats for " + collName + ": " + tojson(stats));
+        assert.eq(0, stats.backlogSecs, tojson(stats));
+    }
+
+    // Ten batches of ten keys delete each collection's expired documents.
+    assert.gte(testDB.serverStatus().metrics.ttl.deleteBatches, 20);
+
+    // Statistics of dropped indexes are dropped too.
+    assert.commandWorked(testDB.ttl_batched_a.dropIndex({x: 1}));
+    const ttlPass = testDB.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return testDB.serverStatus().metrics.ttl.passes >= ttlPass + 2;
+    }, "TTL monitor didn't run before timing out.");
+    assert.eq(undefined, getIndexStats("ttl_batched_a"));
+    assert.neq(undefined, getIndexStats("ttl_batched_b"));
+
+    // The deletion budget can be changed at runtime.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, ttlMonitorDeletesPerSecond: 5}));
+    assert.writeOK(testDB.ttl_batched_b.insert({x: past}));
+    assert.soon(function() {
+        return testDB.ttl_batched_b.count() === 1;
+    }, "TTL monitor didn't expire documents with a deletion budget before timing out.");
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,59 @@
+// Tests collections which hold a single time window: writes outside of the window are rejected,
+// queries outside of it don't read the collection, and expired windows are dropped as a whole.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod({setParameter: "ttlMonitorSleepSecs=1"});
+    assert.neq(null, conn, "mongod failed to start");
+    const testDB = conn.getDB("test");
+
+    const hour = 60 * 60 * 1000;
+    const start = new Date(Date.now() - 2 * hour);
+    const end = new Date(start.getTime() + hour);
+    const inWindow = new Date(start.getTime() + 1000);
+
+    // Invalid windows are rejected.
+    assert.commandFailed(testDB.createCollection("bad", {timeWindow: {field: "ts"}}));
+    assert.commandFailed(
+        testDB.createCollection("bad", {timeWindow: {field: "ts", start: end, end: start}}));
+
+    assert.commandWorked(
+        testDB.createCollection("window_current", {timeWindow: {field: "ts", start, end}}));
+    const coll = testDB.window_current;
+    const collInfo = testDB.getCollectionInfos({name: "window_current"})[0];
+    assert.eq({field: "ts", start, end}, collInfo.options.timeWindow, tojson(collInfo));
+
+    assert.writeOK(coll.insert({ts: inWindow, x: 1}));
+    assert.writeError(coll.insert({ts: end}));
+    assert.writeError(coll.insert({ts: new Date(start.getTime() - 1)}));
+    assert.writeError(coll.insert({ts: inWindow.getTime()}));
+    assert.writeError(coll.insert({x: 2}));
+    assert.writeError(coll.insert({ts: end}, {bypassDocumentValidation: true}));
+    assert.writeError(coll.update({x: 1}, {$set: {ts: end}}));
+
+    // Queries outside of the window are answered without reading the collection.
+    let explain = coll.find({ts: {$gte: end}}).explain("executionStats");
+    assert(planHasStage(explain.queryPlanner.winningPlan, "EOF"), tojson(explain));
+    assert.eq(0, explain.executionStats.totalDocsExamined, tojson(explain));
+    assert.eq(0, coll.find({ts: {$lt: start}}).itcount());
+    assert.eq(0, coll.find({$or: [{ts: {$lt: start}}, {ts: {$gte: end}}]}).itcount());
+
+    explain = coll.find({ts: {$gte: start}}).explain();
+    assert(!planHasStage(explain.queryPlanner.winningPlan, "EOF"), tojson(explain));
+    assert.eq(1, coll.find({ts: {$gte: start}}).itcount());
+    assert.eq(1, coll.find({ts: inWindow}).itcount());
+
+    // A window which has expired is dropped by the TTL monitor, while the current one is kept.
+    assert.commandWorked(testDB.createCollection(
+        "window_expired", {timeWindow: {field: "ts", start, end, expireAfterSeconds: 0}}));
+    assert.writeOK(testDB.window_expired.insert({ts: inWindow}));
+    assert.soon(function() {
+        return testDB.getCollectionInfos({name: "window_expired"}).length === 0;
+    }, "TTL monitor didn't drop the expired time window before timing out.");
+    assert.gte(testDB.serverStatus().metrics.ttl.droppedTimeWindows, 1);
+    assert.eq(1, coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,44 @@
+// Tests that validate with background: true runs while other operations write to the collection,
+// and that it checks the indexes against the records of its own snapshot.
+// @tags: [requires_wiredtiger]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod failed to start");
+    const db = conn.getDB("test");
+    const coll = db.validate_background;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    let res = assert.commandWorked(coll.validate({background: true}));
+    assert(res.valid, tojson(res));
+    assert.eq(1000, res.nrecords, tojson(res));
+    assert.eq(1000, res.keysPerIndex[coll.getFullName() + ".$a_1"], tojson(res));
+
+    // Keep writing from a parallel shell while validating in the background.
+    const awaitWrites = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").validate_background;
+        for (let i = 1000; i < 3000; ++i) {
+            assert.writeOK(coll.insert({_id: i, a: i}));
+        }
+    }, conn.port);
+    for (let i = 0; i < 5; ++i) {
+        res = assert.commandWorked(coll.validate({background: true}));
+        assert(res.valid, tojson(res));
+    }
+    awaitWrites();
+
+    res = assert.commandWorked(coll.validate({background: true}));
+    assert(res.valid, tojson(res));
+    assert.eq(3000, res.nrecords, tojson(res));
+
+    assert.commandFailed(coll.validate({background: true, full: true}));
+
+    MongoRunner.stopMongod(conn);
+})();
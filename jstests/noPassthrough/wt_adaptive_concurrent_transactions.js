@@ -0,0 +1,53 @@
+/**
+ * Tests that with wiredTigerAdaptiveConcurrentTransactions enabled the configured concurrent
+ * transaction limits act as ceilings on the ticket counts reported by serverStatus.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {wiredTigerAdaptiveConcurrentTransactions: true}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const admin = conn.getDB('admin');
+
+    assert.commandWorked(
+        admin.runCommand({setParameter: 1, wiredTigerConcurrentReadTransactions: 20}));
+    assert.commandWorked(
+        admin.runCommand({setParameter: 1, wiredTigerConcurrentWriteTransactions: 10}));
+
+    // getParameter reports the configured values, not whatever the tuner has chosen.
+    let res = assert.commandWorked(admin.runCommand({
+        getParameter: 1,
+        wiredTigerConcurrentReadTransactions: 1,
+        wiredTigerConcurrentWriteTransactions: 1
+    }));
+    assert.eq(20, res.wiredTigerConcurrentReadTransactions);
+    assert.eq(10, res.wiredTigerConcurrentWriteTransactions);
+
+    // Do some work and make sure the tuner never exceeds the ceilings.
+    const coll = conn.getDB('test').adaptive;
+    for (let i = 0; i < 5; i++) {
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < 1000; j++) {
+            bulk.insert({i: i, j: j, pad: 'x'.repeat(100)});
+        }
+        assert.writeOK(bulk.execute());
+        sleep(500);
+
+        const tickets = admin.serverStatus().wiredTiger.concurrentTransactions;
+        assert.lte(tickets.read.totalTickets, 20, tojson(tickets));
+        assert.lte(tickets.write.totalTickets, 10, tojson(tickets));
+        assert.gte(tickets.read.totalTickets, 5, tojson(tickets));
+        assert.gte(tickets.write.totalTickets, 5, tojson(tickets));
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
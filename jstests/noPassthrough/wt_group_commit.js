@@ -0,0 +1,64 @@
+/**
+ * Tests that j:true writes on WiredTiger are made durable through journal flushes that are
+ * reported in serverStatus, with and without a group commit delay.
+ */
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {wiredTigerGroupCommitMaxDelayMicros: 2000}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+
+    function getGroupCommitStats() {
+        return assert.commandWorked(testDB.serverStatus()).wiredTiger.groupCommit;
+    }
+
+    function histogramTotal(histogram) {
+        return histogram.reduce((total, bucket) => total + bucket.count, 0);
+    }
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({setParameter: 1, wiredTigerGroupCommitMaxDelayMicros: -1}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        adminDB.runCommand({setParameter: 1, wiredTigerGroupCommitMaxDelayMicros: 10001}),
+        ErrorCodes.BadValue);
+
+    function runJournaledWriters(nWriters) {
+        const before = getGroupCommitStats();
+        const writers = [];
+        for (let i = 0; i < nWriters; ++i) {
+            writers.push(startParallelShell(function() {
+                for (let j = 0; j < 50; ++j) {
+                    assert.writeOK(db.getSiblingDB("test").group_commit.insert(
+                        {x: j}, {writeConcern: {j: true}}));
+                }
+            }, conn.port));
+        }
+        writers.forEach(awaitShell => awaitShell());
+        const after = getGroupCommitStats();
+
+        assert.gt(after.flushes, before.flushes, tojson({before, after}));
+        assert.gte(after.waiters - before.waiters,
+                   after.flushes - before.flushes,
+                   tojson({before, after}));
+        assert.lte(after.flushes, histogramTotal(after.flushLatencyMicros), tojson(after));
+        assert.lte(after.flushes, histogramTotal(after.waitersPerFlush), tojson(after));
+    }
+
+    runJournaledWriters(4);
+
+    assert.commandWorked(
+        adminDB.runCommand({setParameter: 1, wiredTigerGroupCommitMaxDelayMicros: 0}));
+    runJournaledWriters(4);
+
+    assert.eq(400, testDB.group_commit.count());
+    MongoRunner.stopMongod(conn);
+})();
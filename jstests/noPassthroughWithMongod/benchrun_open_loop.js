@@ -0,0 +1,50 @@
+// Tests benchRun's open-loop mode, latency percentiles, aggregate op and multi-host option.
+(function() {
+    "use strict";
+
+    const coll = db.benchrun_open_loop;
+    coll.drop();
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, x: i % 2}));
+    }
+
+    const seconds = 5;
+    const opsPerSecond = 200;
+    const res = benchRun({
+        parallel: 2,
+        seconds: seconds,
+        opsPerSecond: opsPerSecond,
+        hosts: [db.getMongo().host, db.getMongo().host],
+        ops: [{
+            op: "aggregate",
+            ns: coll.getFullName(),
+            pipeline: [{$match: {x: 1}}, {$project: {_id: 1}}],
+            expected: 5
+        }]
+    });
+
+    assert.eq(0, res.errCount, tojson(res));
+    assert.gt(res.aggregate, 0, tojson(res));
+
+    // The arrival rate is capped by the schedule, so the achieved rate cannot notably exceed it.
+    assert.lte(res["totalOps/s"], opsPerSecond * 1.2, tojson(res));
+
+    const percentiles = res.aggregateLatencyPercentilesMicros;
+    assert(percentiles, tojson(res));
+    assert.lte(percentiles.p50, percentiles.p95, tojson(res));
+    assert.lte(percentiles.p95, percentiles.p99, tojson(res));
+    assert.lte(percentiles.p99, percentiles.p999, tojson(res));
+    assert.lte(percentiles.p999, percentiles.max, tojson(res));
+
+    assert.throws(() => benchRun({
+        seconds: 1,
+        host: db.getMongo().host,
+        ops: [{op: "aggregate", ns: coll.getFullName()}]
+    }));
+    assert.throws(() => benchRun({
+        seconds: 1,
+        opsPerSecond: -1,
+        host: db.getMongo().host,
+        ops: [{op: "nop", ns: coll.getFullName()}]
+    }));
+})();
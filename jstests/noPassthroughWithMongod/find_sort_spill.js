@@ -0,0 +1,62 @@
+// Tests that blocking sorts in find spill to disk instead of failing when
+// internalQueryExecSortAllowDiskUse is enabled.
+(function() {
+    'use strict';
+
+    const coll = db.find_sort_spill;
+    coll.drop();
+
+    const nDocs = 2000;
+    const padding = 'x'.repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, a: (i * 7) % nDocs, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+
+    function getParameter(name) {
+        const cmd = {getParameter: 1};
+        cmd[name] = 1;
+        return assert.commandWorked(db.adminCommand(cmd))[name];
+    }
+
+    function setParameter(name, value) {
+        const cmd = {setParameter: 1};
+        cmd[name] = value;
+        assert.commandWorked(db.adminCommand(cmd));
+    }
+
+    function checkSorted(docs, expectedCount) {
+        assert.eq(expectedCount, docs.length);
+        for (let i = 0; i < docs.length; ++i) {
+            assert.eq(i, docs[i].a, tojson(docs[i]));
+        }
+    }
+
+    const originalMaxBytes = getParameter('internalQueryExecMaxBlockingSortBytes');
+    const originalAllowDiskUse = getParameter('internalQueryExecSortAllowDiskUse');
+    try {
+        setParameter('internalQueryExecMaxBlockingSortBytes', 100 * 1024);
+
+        // Without disk use the sort exceeds the memory limit.
+        setParameter('internalQueryExecSortAllowDiskUse', false);
+        assert.throws(() => coll.find().sort({a: 1}).itcount());
+
+        setParameter('internalQueryExecSortAllowDiskUse', true);
+        checkSorted(coll.find({}, {padding: 0}).sort({a: 1}).toArray(), nDocs);
+        checkSorted(coll.find({}, {padding: 0}).sort({a: 1}).limit(1500).toArray(), 1500);
+        checkSorted(coll.find({}, {padding: 0}).sort({a: 1}).batchSize(10).toArray(), nDocs);
+
+        const explain = coll.find().sort({a: 1}).explain('executionStats');
+        assert.eq(nDocs, explain.executionStats.nReturned, tojson(explain));
+        const sortStage = explain.executionStats.executionStages;
+        assert.eq('SORT', sortStage.stage, tojson(explain));
+        assert.eq(true, sortStage.usedDisk, tojson(explain));
+
+        // Spilled results have no RecordId, so sorts that must report one still fail.
+        assert.throws(() => coll.find().sort({a: 1}).showRecordId().itcount());
+    } finally {
+        setParameter('internalQueryExecMaxBlockingSortBytes', originalMaxBytes);
+        setParameter('internalQueryExecSortAllowDiskUse', originalAllowDiskUse);
+    }
+})();
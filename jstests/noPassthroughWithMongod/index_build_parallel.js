@@ -0,0 +1,66 @@
+// Tests that foreground index builds which generate and sort keys on several threads build the
+// same indexes as serial builds, including multikey and unique indexes.
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.index_build_parallel;
+    coll.drop();
+
+    const nDocs = 10000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, a: i % 7, b: nDocs - i, c: (i % 100 === 0) ? [i, i + 1] : i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const original =
+        assert.commandWorked(db.adminCommand({getParameter: 1, maxIndexBuildParallelism: 1}))
+            .maxIndexBuildParallelism;
+
+    try {
+        assert.commandFailedWithCode(
+            db.adminCommand({setParameter: 1, maxIndexBuildParallelism: 0}), ErrorCodes.BadValue);
+        assert.commandWorked(db.adminCommand({setParameter: 1, maxIndexBuildParallelism: 4}));
+
+        // Duplicates that end up in different threads' runs must still be detected.
+        assert.writeOK(coll.insert({_id: nDocs, b: 1}));
+        assert.commandFailedWithCode(coll.createIndex({b: 1}, {unique: true}),
+                                     ErrorCodes.DuplicateKey);
+        assert.writeOK(coll.remove({_id: nDocs}));
+
+        assert.commandWorked(coll.createIndexes([{a: 1, b: -1}, {c: 1}]));
+        assert.commandWorked(coll.createIndex({b: 1}, {unique: true}));
+        assert.commandWorked(coll.createIndex({b: 1, a: 1}, {partialFilterExpression: {a: 3}}));
+
+        // Every index must be complete and in order.
+        assert.eq(nDocs, coll.find().hint({a: 1, b: -1}).itcount());
+        assert.eq(nDocs, coll.find().hint({b: 1}).itcount());
+        assert.eq(nDocs / 100, coll.find({c: {$type: 'array'}}).hint({c: 1}).itcount());
+        assert.eq(coll.find({a: 3}).itcount(), coll.find({a: 3}).hint({b: 1, a: 1}).itcount());
+
+        let last = null;
+        coll.find({}, {_id: 0, a: 1, b: 1}).hint({a: 1, b: -1}).forEach(doc => {
+            if (last !== null) {
+                assert(last.a < doc.a || (last.a === doc.a && last.b > doc.b),
+                       tojson([last, doc]));
+            }
+            last = doc;
+        });
+
+        // The multikey flag has to be set even if only one of the threads saw an array.
+        const explain = coll.find({c: 5}).hint({c: 1}).explain();
+        const ixscan = getPlanStage(explain.queryPlanner.winningPlan, 'IXSCAN');
+        assert(ixscan.isMultiKey, tojson(explain));
+
+        // Key generation errors are reported from the worker threads.
+        assert.writeOK(coll.insert({_id: nDocs + 1, p: [1, 2], q: [1, 2]}));
+        assert.commandFailedWithCode(coll.createIndex({p: 1, q: 1}),
+                                     ErrorCodes.CannotIndexParallelArrays);
+        assert.commandWorked(db.runCommand({validate: coll.getName(), full: true}));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, maxIndexBuildParallelism: original}));
+    }
+})();
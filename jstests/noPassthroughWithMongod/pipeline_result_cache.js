@@ -0,0 +1,50 @@
+// Tests that aggregations served from the pipeline result cache see every committed write.
+(function() {
+    'use strict';
+
+    const coll = db.pipeline_result_cache;
+    coll.drop();
+    assert.writeOK(coll.insert([{_id: 1, k: "a", v: 1}, {_id: 2, k: "b", v: 2}]));
+
+    const original =
+        assert
+            .commandWorked(
+                db.adminCommand({getParameter: 1, internalPipelineResultCacheMaxBytes: 1}))
+            .internalPipelineResultCacheMaxBytes;
+
+    const pipeline = [{$group: {_id: "$k", total: {$sum: "$v"}}}, {$sort: {_id: 1}}];
+
+    try {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalPipelineResultCacheMaxBytes: 1024 * 1024}));
+
+        // The second run may be served from the cache.
+        const expected = [{_id: "a", total: 1}, {_id: "b", total: 2}];
+        assert.eq(expected, coll.aggregate(pipeline).toArray());
+        assert.eq(expected, coll.aggregate(pipeline).toArray());
+
+        // Inserts, updates and deletes must each be visible to the next run.
+        assert.writeOK(coll.insert({_id: 3, k: "a", v: 10}));
+        assert.eq([{_id: "a", total: 11}, {_id: "b", total: 2}],
+                  coll.aggregate(pipeline).toArray());
+
+        assert.writeOK(coll.update({_id: 2}, {$set: {v: 5}}));
+        assert.eq([{_id: "a", total: 11}, {_id: "b", total: 5}],
+                  coll.aggregate(pipeline).toArray());
+
+        assert.writeOK(coll.remove({k: "a"}));
+        assert.eq([{_id: "b", total: 5}], coll.aggregate(pipeline).toArray());
+
+        // A cached result that does not fit in the requested batch must still return every
+        // result.
+        assert.eq(1, coll.aggregate(pipeline, {cursor: {batchSize: 0}}).itcount());
+
+        // Dropping and recreating the collection must not serve the old results.
+        coll.drop();
+        assert.writeOK(coll.insert({_id: 1, k: "c", v: 7}));
+        assert.eq([{_id: "c", total: 7}], coll.aggregate(pipeline).toArray());
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalPipelineResultCacheMaxBytes: original}));
+    }
+})();
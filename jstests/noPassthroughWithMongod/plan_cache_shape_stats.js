@@ -0,0 +1,41 @@
+// Tests the planning counters reported per query shape by planCacheListPlans and in total by the
+// query.planning and query.planCache serverStatus metrics.
+(function() {
+    "use strict";
+
+    const coll = db.plan_cache_shape_stats;
+    coll.drop();
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({a: i, b: i % 10}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    const query = {a: {$gte: 0}, b: 3};
+    const metricsBefore = db.serverStatus().metrics.query;
+
+    // The first query is multi-planned and cached, the second uses the cached plan.
+    assert.eq(10, coll.find(query).itcount());
+    assert.eq(10, coll.find(query).itcount());
+
+    const res = assert.commandWorked(coll.runCommand("planCacheListPlans", {query: query}));
+    assert.gt(res.plans.length, 1, tojson(res));
+    const shapeStats = res.shapeStats;
+    assert.eq(1, shapeStats.numPlanned, tojson(res));
+    assert.gt(shapeStats.totalTrialWorks, 0, tojson(res));
+    assert.gte(shapeStats.totalPlanningMicros, 0, tojson(res));
+    assert.eq(1, shapeStats.numCacheHits, tojson(res));
+    assert.eq(0, shapeStats.numReplans, tojson(res));
+    assert.eq(0, shapeStats.numPlanFlips, tojson(res));
+
+    const metricsAfter = db.serverStatus().metrics.query;
+    assert.gt(metricsAfter.planning.multiPlanned, metricsBefore.planning.multiPlanned);
+    assert.gt(metricsAfter.planning.trialWorks, metricsBefore.planning.trialWorks);
+    assert.gt(metricsAfter.planCache.hits, metricsBefore.planCache.hits);
+    assert.gt(metricsAfter.planCache.misses, metricsBefore.planCache.misses);
+    assert(metricsAfter.planCache.hasOwnProperty("evictions"), tojson(metricsAfter));
+    assert(metricsAfter.planCache.hasOwnProperty("planFlips"), tojson(metricsAfter));
+
+    coll.drop();
+}());
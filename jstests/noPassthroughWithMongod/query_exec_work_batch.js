@@ -0,0 +1,57 @@
+// Tests that queries return the same results when the PlanExecutor works its stage tree in
+// batches, including across getMores and concurrent deletes of buffered results.
+(function() {
+    'use strict';
+
+    const coll = db.query_exec_work_batch;
+    coll.drop();
+
+    const nDocs = 100;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, a: i % 10, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    const original =
+        assert.commandWorked(db.adminCommand({getParameter: 1, internalQueryExecWorkBatchSize: 1}))
+            .internalQueryExecWorkBatchSize;
+
+    try {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryExecWorkBatchSize: 16}));
+
+        // Collection scan with a filter, returned over several getMores.
+        assert.eq(50, coll.find({b: {$gte: 50}}).batchSize(7).itcount());
+
+        // Index scan with a fetch and a projection.
+        const results = coll.find({a: 3}, {_id: 0, b: 1}).sort({a: 1}).batchSize(3).toArray();
+        assert.eq(10, results.length, tojson(results));
+        results.forEach(doc => assert.eq(3, doc.b % 10, tojson(doc)));
+
+        // A limit must still be honored exactly.
+        assert.eq(5, coll.find().limit(5).itcount());
+
+        // Delete documents between getMores, which may remove results that have already been
+        // buffered by the executor. Those results may or may not be returned, but the cursor
+        // must remain usable and never return a document twice.
+        const cursor = coll.find().batchSize(10);
+        const seen = {};
+        for (let i = 0; i < 10; ++i) {
+            const doc = cursor.next();
+            assert(!seen.hasOwnProperty(doc._id), tojson(doc));
+            seen[doc._id] = true;
+        }
+        assert.writeOK(coll.remove({b: {$lt: 30}}));
+        while (cursor.hasNext()) {
+            const doc = cursor.next();
+            assert(!seen.hasOwnProperty(doc._id), tojson(doc));
+            seen[doc._id] = true;
+        }
+        assert.eq(70, coll.find().itcount());
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryExecWorkBatchSize: original}));
+    }
+})();
@@ -0,0 +1,47 @@
+// Tests that find operations are aggregated per query shape and reported by $queryStats.
+(function() {
+    'use strict';
+
+    const coll = db.query_stats_stage;
+    coll.drop();
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i % 2}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Queries which differ only in their literals share a shape.
+    for (let i = 0; i < 5; ++i) {
+        assert.eq(1, coll.find({a: i}).itcount());
+    }
+    assert.eq(5, coll.find({b: 1}).sort({a: 1}).itcount());
+
+    // The specification must be empty.
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: coll.getName(), pipeline: [{$queryStats: {x: 1}}], cursor: {}}),
+        ErrorCodes.BadValue);
+
+    const stats = coll.aggregate([{$queryStats: {}}]).toArray();
+    assert.eq(2, stats.length, tojson(stats));
+
+    const pointStats = stats.find(entry => bsonWoCompare(entry.shape.sort, {}) === 0);
+    assert.neq(undefined, pointStats, tojson(stats));
+    assert.eq(coll.getFullName(), pointStats.ns, tojson(pointStats));
+    assert.eq({a: 0}, pointStats.shape.query, tojson(pointStats));
+    assert.eq(5, pointStats.count, tojson(pointStats));
+    assert.eq(5, pointStats.nReturned, tojson(pointStats));
+    assert.eq(5, pointStats.keysExamined, tojson(pointStats));
+    assert.eq(5, pointStats.latencyStats.reads.ops, tojson(pointStats));
+    assert.lte(pointStats.latencyMicros.min, pointStats.latencyMicros.max, tojson(pointStats));
+    assert(pointStats.lastPlanSummary.startsWith("IXSCAN"), tojson(pointStats));
+
+    const sortStats = stats.find(entry => bsonWoCompare(entry.shape.sort, {a: 1}) === 0);
+    assert.neq(undefined, sortStats, tojson(stats));
+    assert.eq(1, sortStats.count, tojson(sortStats));
+    assert.eq(5, sortStats.nReturned, tojson(sortStats));
+
+    // Dropping the collection discards its statistics.
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0}));
+    assert.eq(0, coll.aggregate([{$queryStats: {}}]).itcount());
+})();
@@ -0,0 +1,54 @@
+// Tests that the planner considers skipping over the leading field of a compound index when the
+// query only constrains the second field and index statistics show few leading values.
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.skip_scan;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i % 4, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.commandWorked(db.runCommand({updateIndexStats: coll.getName(), index: "a_1_b_1"}));
+
+    const original = assert
+                         .commandWorked(db.adminCommand(
+                             {getParameter: 1, internalQueryPlannerSkipScanMaxDistinctPrefixes: 1}))
+                         .internalQueryPlannerSkipScanMaxDistinctPrefixes;
+
+    try {
+        // Disabled by default: only a collection scan is possible.
+        let explain = coll.find({b: {$gte: 990}}).explain();
+        assert(isCollscan(explain.queryPlanner.winningPlan), tojson(explain));
+        assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerSkipScanMaxDistinctPrefixes: 10}));
+
+        // The skip scan races the collection scan and should examine far fewer keys than there
+        // are documents.
+        explain = coll.find({b: {$gte: 990}}).explain("executionStats");
+        assert(isIxscan(explain.queryPlanner.winningPlan), tojson(explain));
+        assert.eq(10, explain.executionStats.nReturned, tojson(explain));
+        assert.lt(explain.executionStats.totalKeysExamined, 100, tojson(explain));
+        assert.eq(10, coll.find({b: {$gte: 990}}).itcount());
+        assert.eq(1, coll.find({b: 7}).itcount());
+
+        // A predicate on the leading field uses the index normally, not a skip scan.
+        assert.eq(1, coll.find({a: 3, b: 7}).itcount());
+
+        // Too many distinct leading values for the threshold.
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerSkipScanMaxDistinctPrefixes: 2}));
+        explain = coll.find({b: {$gte: 990}}).explain();
+        assert(isCollscan(explain.queryPlanner.winningPlan), tojson(explain));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerSkipScanMaxDistinctPrefixes: original}));
+    }
+})();
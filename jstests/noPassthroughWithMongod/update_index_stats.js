@@ -0,0 +1,61 @@
+// Tests the updateIndexStats command, the statistics it reports through $indexStats, and the
+// planner's use of those statistics to prune candidate plans.
+(function() {
+    'use strict';
+
+    const coll = db.update_index_stats;
+    coll.drop();
+
+    // Most documents belong to a single tenant.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({tenant: i < 990 ? 0 : i - 989, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({tenant: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    assert.commandFailedWithCode(db.runCommand({updateIndexStats: coll.getName(), index: "nope"}),
+                                 ErrorCodes.IndexNotFound);
+    assert.commandFailedWithCode(db.runCommand({updateIndexStats: coll.getName(), buckets: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({updateIndexStats: "does_not_exist"}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    let res = assert.commandWorked(
+        db.runCommand({updateIndexStats: coll.getName(), index: "tenant_1", buckets: 10}));
+    assert.eq({tenant_1: {numKeys: 1000, numDistinct: 11, numBuckets: 2}}, res.indexes, tojson(res));
+
+    res = assert.commandWorked(db.runCommand({updateIndexStats: coll.getName()}));
+    assert.eq(["_id_", "b_1", "tenant_1"], Object.keys(res.indexes).sort(), tojson(res));
+
+    const indexStats = coll.aggregate([{$indexStats: {}}]).toArray();
+    assert.eq(3, indexStats.length, tojson(indexStats));
+    indexStats.forEach(function(stats) {
+        assert(stats.hasOwnProperty("statistics"), tojson(stats));
+        assert.eq(1000, stats.statistics.numKeys, tojson(stats));
+        assert.gt(stats.statistics.histogram.length, 0, tojson(stats));
+    });
+
+    const original =
+        assert
+            .commandWorked(db.adminCommand(
+                {getParameter: 1, internalQueryPlannerIndexStatisticsPruneRatio: 1}))
+            .internalQueryPlannerIndexStatisticsPruneRatio;
+    try {
+        // Without pruning, both indexes are trialed.
+        let explain = coll.find({tenant: 5, b: {$gte: 0}}).explain();
+        assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+        // The statistics show that the scan over {b: 1} examines far more keys, so it is never
+        // trialed.
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerIndexStatisticsPruneRatio: 10}));
+        explain = coll.find({tenant: 5, b: {$gte: 0}}).explain();
+        assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+        assert.eq(1, coll.find({tenant: 5, b: {$gte: 0}}).itcount());
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerIndexStatisticsPruneRatio: original}));
+    }
+})();
@@ -0,0 +1,32 @@
+// Tests that serverStatus reports how often WiredTiger sessions and cursors are reused.
+(function() {
+    'use strict';
+
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTestLog("Skipping test because this server does not have WiredTiger enabled");
+        return;
+    }
+
+    function getStats() {
+        const stats = assert.commandWorked(db.serverStatus()).wiredTiger.sessionCache;
+        assert(stats, "missing wiredTiger.sessionCache in serverStatus");
+        return stats;
+    }
+
+    const coll = db.wt_session_cache_stats;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0}));
+
+    const before = getStats();
+    for (let i = 0; i < 20; ++i) {
+        assert.eq(1, coll.find({_id: 0}).itcount());
+    }
+    const after = getStats();
+
+    // Repeated queries against the same collection must be served from cached sessions and
+    // cursors, and the counters never go backwards.
+    assert.gt(after.sessionsReused, before.sessionsReused, tojson({before, after}));
+    assert.gt(after.cursorsReused, before.cursorsReused, tojson({before, after}));
+    assert.gte(after.sessionsOpened, before.sessionsOpened, tojson({before, after}));
+    assert.gte(after.cursorsOpened, before.cursorsOpened, tojson({before, after}));
+})();
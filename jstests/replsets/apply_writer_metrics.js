@@ -0,0 +1,38 @@
+// Tests that secondaries report how long their writer threads are busy applying oplog batches and
+// how many writer vectors they applied, including when batches are split into more vectors than
+// there are writer threads.
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({
+        nodes: 2,
+        nodeOptions: {setParameter: {replWriterThreadCount: 2, replWriterVectorsPerThread: 4}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    secondary.setSlaveOk();
+
+    function getApplyMetrics() {
+        return assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.apply;
+    }
+
+    const before = getApplyMetrics();
+
+    const bulk = primary.getDB("test").apply_writer_metrics.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+
+    const after = getApplyMetrics();
+    assert.gt(after.writerVectors, before.writerVectors, tojson({before, after}));
+    assert.gt(after.writerBusyMicros, before.writerBusyMicros, tojson({before, after}));
+    assert.gte(after.writerIdleMicros, before.writerIdleMicros, tojson({before, after}));
+
+    assert.eq(1000, secondary.getDB("test").apply_writer_metrics.find().itcount());
+
+    rst.stopSet();
+})();
@@ -0,0 +1,49 @@
+// Tests that with logReplacementUpdatesAsDiffs enabled, a replacement that changes one field of a
+// large document is logged as $set and $unset operations, and that secondaries applying those
+// operations end up with the same document as the primary.
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({
+        nodes: 2,
+        nodeOptions: {setParameter: {logReplacementUpdatesAsDiffs: true}},
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").oplog_replacement_diff;
+
+    function getLastOplogEntry() {
+        return primary.getDB("local").oplog.rs.find().sort({$natural: -1}).limit(1).next();
+    }
+
+    const payload = "x".repeat(16 * 1024);
+    assert.writeOK(coll.insert({_id: 0, a: 1, payload: payload, b: 1}));
+
+    // Changing one field and removing another is logged as a diff.
+    assert.writeOK(coll.update({_id: 0}, {a: 2, payload: payload}));
+    let entry = getLastOplogEntry();
+    assert.eq("u", entry.op, tojson(entry));
+    assert.docEq({$v: 1, $set: {a: 2}, $unset: {b: true}}, entry.o);
+
+    // Adding a field after the existing ones is logged as a diff.
+    assert.writeOK(coll.update({_id: 0}, {a: 2, payload: payload, c: 1}));
+    entry = getLastOplogEntry();
+    assert.docEq({$v: 1, $set: {c: 1}}, entry.o);
+
+    // Reordering fields cannot be expressed as $set and $unset, so the whole document is logged.
+    assert.writeOK(coll.update({_id: 0}, {payload: payload, a: 2, c: 1}));
+    entry = getLastOplogEntry();
+    assert.docEq({_id: 0, payload: payload, a: 2, c: 1}, entry.o);
+
+    assert.writeOK(coll.update({_id: 0}, {payload: payload, a: 3, c: 1}));
+
+    rst.awaitReplication();
+    const secondaryColl = rst.getSecondary().getDB("test").oplog_replacement_diff;
+    assert.eq(bsonWoCompare(coll.findOne({_id: 0}), secondaryColl.findOne({_id: 0})),
+              0,
+              "secondary document differs from primary document");
+
+    rst.stopSet();
+})();
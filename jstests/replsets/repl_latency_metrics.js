@@ -0,0 +1,45 @@
+// Tests that secondaries report histograms of the time replicated operations spend fetching,
+// waiting in the oplog buffer, being batched, being written to the oplog, being applied and
+// waiting for the journal.
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+
+    const stages = ["fetch", "bufferWait", "batching", "oplogWrite", "apply", "journalWait"];
+
+    function getLatencyMetrics() {
+        return assert.commandWorked(secondary.adminCommand({serverStatus: 1}))
+            .metrics.repl.latency;
+    }
+
+    const before = getLatencyMetrics();
+    stages.forEach(function(stage) {
+        const histogram = before[stage];
+        assert(histogram, "missing repl.latency." + stage + ": " + tojson(before));
+        assert.eq(26, histogram.buckets.length, tojson(histogram));
+        assert.eq(histogram.count,
+                  histogram.buckets.reduce((total, bucket) => total + bucket, 0),
+                  tojson(histogram));
+    });
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(primary.getDB("test").repl_latency_metrics.insert(
+            {_id: i}, {writeConcern: {w: 2, j: true}}));
+    }
+
+    const after = getLatencyMetrics();
+    ["fetch", "bufferWait", "batching", "oplogWrite", "apply"].forEach(function(stage) {
+        assert.gt(after[stage].count, before[stage].count, stage + ": " + tojson({before, after}));
+    });
+    if (jsTest.options().storageEngine !== "inMemory") {
+        assert.gt(after.journalWait.count, before.journalWait.count, tojson({before, after}));
+    }
+
+    rst.stopSet();
+})();
@@ -0,0 +1,69 @@
+// Tests sharding a collection on a hashed shard key which uses the fast hash function (hashVersion
+// 1), and that mongos targets equality queries and inserts with that hash function.
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2});
+    var mongos = st.s0;
+    var testDB = mongos.getDB('test');
+    var configDB = mongos.getDB('config');
+
+    assert.commandWorked(mongos.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', st.shard1.shardName);
+
+    // Unknown hash versions and hash versions on non-hashed shard keys are rejected.
+    assert.commandFailedWithCode(
+        mongos.adminCommand({shardCollection: 'test.bad', key: {x: 'hashed'}, hashVersion: 2}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        mongos.adminCommand({shardCollection: 'test.bad', key: {x: 1}, hashVersion: 1}),
+        ErrorCodes.InvalidOptions);
+
+    assert.commandWorked(mongos.adminCommand(
+        {shardCollection: 'test.user', key: {x: 'hashed'}, hashVersion: 1, numInitialChunks: 4}));
+
+    // The hash version is recorded in the sharding metadata and in the shard key index.
+    var collEntry = configDB.collections.findOne({_id: 'test.user'});
+    assert.eq(1, collEntry.hashVersion, tojson(collEntry));
+    var indexes = st.shard1.getDB('test').user.getIndexes();
+    var hashedIndex = indexes.filter(function(index) {
+        return index.key.x === 'hashed';
+    })[0];
+    assert.eq(1, hashedIndex.hashVersion, tojson(indexes));
+
+    // Resharding with a different hash version is rejected.
+    assert.commandFailedWithCode(
+        mongos.adminCommand({shardCollection: 'test.user', key: {x: 'hashed'}}),
+        ErrorCodes.AlreadyInitialized);
+
+    var numDocs = 200;
+    var bulk = testDB.user.initializeUnorderedBulkOp();
+    for (var i = 0; i < numDocs; i++) {
+        bulk.insert({x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Every document landed on the shard which owns the chunk of its version 1 hash, so the
+    // shards together hold each document exactly once and each shard holds some of them.
+    var onShard0 = st.shard0.getDB('test').user.count();
+    var onShard1 = st.shard1.getDB('test').user.count();
+    assert.eq(numDocs, onShard0 + onShard1);
+    assert.gt(onShard0, 0);
+    assert.gt(onShard1, 0);
+
+    // Equality queries on the shard key are targeted to a single shard and use the index.
+    for (var i = 0; i < numDocs; i += 17) {
+        assert.eq(1, testDB.user.find({x: i}).itcount());
+
+        var explain = testDB.user.find({x: i}).explain();
+        assert.eq(1, explain.queryPlanner.winningPlan.shards.length, tojson(explain));
+    }
+
+    // Targeted updates and removes find their documents.
+    assert.writeOK(testDB.user.update({x: 5}, {$set: {y: 1}}));
+    assert.eq(1, testDB.user.find({x: 5, y: 1}).itcount());
+    assert.writeOK(testDB.user.remove({x: 5}, {justOne: true}));
+    assert.eq(numDocs - 1, testDB.user.find().itcount());
+
+    st.stop();
+})();
@@ -0,0 +1,76 @@
+// Tests that a $lookup whose foreign collection is sharded identically to the local collection is
+// executed as a shard-local join when internalQueryAllowShardLocalLookup is enabled on mongos, and
+// that any other $lookup from a sharded collection is still rejected.
+load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({
+        shards: 2,
+        mongos: 1,
+        other: {mongosOptions: {setParameter: {internalQueryAllowShardLocalLookup: true}}}
+    });
+
+    const dbName = "test";
+    const mongosDB = st.s.getDB(dbName);
+    const local = mongosDB.local;
+    const foreign = mongosDB.foreign;
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+
+    // Shard both collections on {a: 1}, with the chunk [0, MaxKey) on the second shard.
+    for (let coll of[local, foreign]) {
+        assert.commandWorked(
+            st.s.adminCommand({shardCollection: coll.getFullName(), key: {a: 1}}));
+        assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {a: 0}}));
+        assert.commandWorked(st.s.adminCommand(
+            {moveChunk: coll.getFullName(), find: {a: 1}, to: st.shard1.shardName}));
+    }
+
+    for (let a of[-2, -1, 1, 2]) {
+        assert.writeOK(local.insert({_id: a, a: a}));
+        assert.writeOK(foreign.insert({_id: a, a: a, value: a * 10}));
+    }
+
+    const pipeline = [
+        {$lookup: {from: "foreign", localField: "a", foreignField: "a", as: "matches"}},
+        {$sort: {a: 1}}
+    ];
+
+    // The join is executed by the shards.
+    const explain = local.explain().aggregate(pipeline);
+    assert(explain.hasOwnProperty("splitPipeline"), tojson(explain));
+    assert.eq(explain.splitPipeline.shardsPart[0].$lookup.from, "foreign", tojson(explain));
+    assert.eq(explain.splitPipeline.shardsPart[0].$lookup.$_internalShardLocal,
+              true,
+              tojson(explain));
+
+    const results = local.aggregate(pipeline).toArray();
+    assert.eq(results.length, 4, tojson(results));
+    for (let doc of results) {
+        assert.eq(doc.matches.length, 1, tojson(results));
+        assert.eq(doc.matches[0].value, doc.a * 10, tojson(results));
+    }
+
+    // A $lookup on a field other than the shard key cannot be executed shard-locally.
+    assertErrorCode(local,
+                    [{$lookup: {from: "foreign", localField: "_id", foreignField: "a", as: "m"}}],
+                    28769);
+
+    // Neither can a $lookup which follows a stage that may modify the shard key.
+    assertErrorCode(local,
+                    [
+                      {$addFields: {a: {$add: ["$a", 1]}}},
+                      {$lookup: {from: "foreign", localField: "a", foreignField: "a", as: "m"}}
+                    ],
+                    28769);
+
+    // Once the chunk distributions differ, the collections are no longer co-located.
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: foreign.getFullName(), find: {a: 1}, to: st.shard0.shardName}));
+    assertErrorCode(local, pipeline, 28769);
+
+    st.stop();
+}());
@@ -0,0 +1,44 @@
+//
+// Tests that chunk migrations clone all documents correctly when the recipient inserts them in
+// batches and throttles between the batches.
+//
+
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2});
+    var kDbName = 'db';
+    var ns = kDbName + '.foo';
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: kDbName}));
+    st.ensurePrimaryShard(kDbName, st.shard0.shardName);
+    assert.commandWorked(st.s0.adminCommand({shardCollection: ns, key: {_id: 1}}));
+
+    // Leave an orphan on the recipient, which must not survive the migration
+    assert.writeOK(st.shard1.getCollection(ns).insert({_id: 5, orphan: true}));
+
+    var coll = st.s0.getCollection(ns);
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(st.shard1.adminCommand({
+        setParameter: 1,
+        migrateCloneInsertionBatchSize: 7,
+        migrateCloneInsertionBatchDelayMS: 1
+    }));
+
+    assert.commandWorked(st.s0.adminCommand(
+        {moveChunk: ns, find: {_id: 0}, to: st.shard1.shardName, _waitForDelete: true}));
+
+    assert.eq(0, st.shard0.getCollection(ns).count());
+    assert.eq(100, st.shard1.getCollection(ns).count());
+    assert.eq(0, st.shard1.getCollection(ns).count({orphan: true}));
+    for (var i = 0; i < 100; i++) {
+        assert.eq({_id: i, x: i}, coll.findOne({_id: i}));
+    }
+
+    st.stop();
+})();
@@ -27,9 +27,9 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -307,9 +307,11 @@ Status validateElementInfo(Buffer* buffer,
     }
 }
 
+// Almost all documents nest less deeply than this, so validating them does not allocate.
+const size_t kInlineValidationFrames = 32;
+
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    boost::container::small_vector<ValidationObjectFrame, kInlineValidationFrames> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
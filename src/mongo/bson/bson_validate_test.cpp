@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -333,6 +334,31 @@ TEST(BSONValidateFast, StringHasSomething) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
 }
 
+/**
+ * Returns an object nested 'depth' levels deep, counting the outermost object as the first.
+ */
+BSONObj makeNestedObject(size_t depth) {
+    BSONObj obj = BSON("a" << 1);
+    for (size_t i = 1; i < depth; ++i) {
+        obj = BSON("a" << obj);
+    }
+    return obj;
+}
+
+TEST(BSONValidateFast, DeeplyNestedObjectUpToMaxDepth) {
+    // Nest past the number of frames the validator keeps inline, up to the maximum depth.
+    for (size_t depth : {size_t(16), size_t(33), size_t(BSONDepth::getMaxAllowableDepth())}) {
+        BSONObj obj = makeNestedObject(depth);
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+}
+
+TEST(BSONValidateFast, NestedObjectPastMaxDepthFails) {
+    BSONObj obj = makeNestedObject(BSONDepth::getMaxAllowableDepth() + 2);
+    ASSERT_EQ(ErrorCodes::Overflow,
+              validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateBool, BoolValuesAreValidated) {
     BSONObjBuilder bob;
     bob.append("x", false);
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/oid.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+MONGO_BENCHMARK(BSONObjBuilderSmallDocument) {
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        bob.append("_id", 1);
+        bob.append("name", "joe");
+        bob.append("score", 3.5);
+        unittest::doNotOptimizeAway(bob.obj());
+    }
+}
+
+MONGO_BENCHMARK(BSONObjBuilderTypicalDocument) {
+    const OID oid = OID::gen();
+    const Date_t now = Date_t::now();
+    const std::string text(64, 'x');
+
+    std::uint64_t bytes = 0;
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        bob.append("_id", oid);
+        bob.appendDate("created", now);
+        bob.append("text", text);
+        bob.append("count", 12345LL);
+        {
+            BSONObjBuilder sub(bob.subobjStart("address"));
+            sub.append("street", "Main St");
+            sub.append("number", 42);
+            sub.append("zip", "10001");
+        }
+        {
+            BSONArrayBuilder arr(bob.subarrayStart("tags"));
+            for (int i = 0; i < 8; ++i) {
+                arr.append(i);
+            }
+        }
+        BSONObj obj = bob.obj();
+        bytes += obj.objsize();
+        unittest::doNotOptimizeAway(obj);
+    }
+    state.setBytesProcessed(bytes);
+}
+
+MONGO_BENCHMARK(BSONObjBuilderManyFields) {
+    const std::vector<std::string> names = [] {
+        std::vector<std::string> names;
+        for (int i = 0; i < 100; ++i) {
+            names.push_back("field" + std::to_string(i));
+        }
+        return names;
+    }();
+
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        for (const auto& name : names) {
+            bob.append(name, 1);
+        }
+        unittest::doNotOptimizeAway(bob.obj());
+    }
+    state.setItemsProcessed(state.iterations() * names.size());
+}
+
+MONGO_BENCHMARK(BSONObjFieldLookup) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < 20; ++i) {
+        bob.append("field" + std::to_string(i), i);
+    }
+    const BSONObj obj = bob.obj();
+
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(obj["field19"]);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -65,8 +65,7 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
+    FIELD_RESERVE_SIZE = 64,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -95,6 +94,21 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
+    // Plain numbers and strings make up most values, and none of the keywords below can start
+    // with a digit or a quote, so dispatch on the first character before trying each keyword.
+    const char* next = _input;
+    while (next < _input_end && isspace(*reinterpret_cast<const unsigned char*>(next))) {
+        ++next;
+    }
+    if (next < _input_end) {
+        const char* digit = (*next == '-' && next + 1 < _input_end) ? next + 1 : next;
+        if (isdigit(*reinterpret_cast<const unsigned char*>(digit))) {
+            return number(fieldName, builder);
+        } else if (*next == '"' || *next == '\'') {
+            return stringValue(fieldName, builder);
+        }
+    }
+
     if (peekToken(LBRACE)) {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
@@ -151,13 +165,10 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
             return ret;
         }
     } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
+        Status ret = stringValue(fieldName, builder);
         if (ret != Status::OK()) {
             return ret;
         }
-        builder.append(fieldName, valueString);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -181,6 +192,18 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     return Status::OK();
 }
 
+Status JParse::stringValue(StringData fieldName, BSONObjBuilder& builder) {
+    // The value is appended before any nested parsing can happen, so one buffer serves every
+    // string value in the input and its capacity is only paid for once.
+    _stringValue.clear();
+    Status ret = quotedString(&_stringValue);
+    if (ret != Status::OK()) {
+        return ret;
+    }
+    builder.append(fieldName, _stringValue);
+    return Status::OK();
+}
+
 Status JParse::parse(BSONObjBuilder& builder) {
     return isArray() ? array("UNUSED", builder, false) : object("UNUSED", builder, false);
 }
@@ -314,9 +337,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reuse one buffer for the remaining field names rather than allocating one per field.
+        std::string fieldName;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -1100,8 +1124,22 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
         return parseError("Unexpected end of input");
     }
     const char* q = _input;
+    // Quoted strings end at a single terminal character and allow anything else, so copy each
+    // run of characters that need no escape or control character handling in one append.
+    const bool singleTerminal = allowedSet == NULL && *terminalSet != '\0' && !terminalSet[1];
     while (q < _input_end && !match(*q, terminalSet)) {
         MONGO_JSON_DEBUG("q: " << q);
+        if (singleTerminal) {
+            const char* run = q;
+            while (q < _input_end && *q != *terminalSet && *q != '\\' &&
+                   !(0x00 <= *q && *q <= 0x1F)) {
+                ++q;
+            }
+            result->append(run, q - run);
+            if (q >= _input_end || *q == *terminalSet) {
+                break;
+            }
+        }
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
                 _input = q;
@@ -375,6 +375,11 @@ private:
      */
     Status quotedString(std::string* result);
 
+    /*
+     * Parses a quoted string value and appends it to builder under fieldName.
+     */
+    Status stringValue(StringData fieldName, BSONObjBuilder& builder);
+
     /*
      * CHARS :
      *     CHAR
@@ -492,6 +497,11 @@ private:
     const char* const _buf;
     const char* _input;
     const char* const _input_end;
+
+    /*
+     * Scratch buffer for string values, reused across the whole parse.
+     */
+    std::string _stringValue;
 };
 
 }  // namespace mongo
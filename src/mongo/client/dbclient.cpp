@@ -1142,6 +1142,9 @@ unsigned long long DBClientBase::query(stdx::function<void(DBClientCursorBatchIt
     // mask options
     queryOptions &= (int)(QueryOption_NoCursorTimeout | QueryOption_SlaveOk);
 
+    // Without exhaust, have the server produce each batch while 'f' consumes the previous one
+    queryOptions |= (int)DBClientCursor::QueryOptionLocal_prefetchNextBatch;
+
     unique_ptr<DBClientCursor> c(this->query(ns, query, 0, 0, fieldsToReturn, queryOptions));
     uassert(16090, "socket error for mapping query", c.get());
 
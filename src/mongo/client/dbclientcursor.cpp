@@ -167,6 +167,7 @@ bool DBClientCursor::init() {
         return false;
     }
     dataReceived(reply);
+    _prefetchIfEnabled();
     return true;
 }
 
@@ -208,6 +209,19 @@ void DBClientCursor::requestMore() {
         return exhaustReceiveMore();
     }
 
+    if (_prefetchInFlight) {
+        _receivePrefetchedBatch();
+    }
+
+    if (!_prefetchedReply.empty()) {
+        verify(cursorId && batch.pos == batch.objs.size());
+        Message response = std::move(_prefetchedReply);
+        _prefetchedReply.reset();
+        dataReceived(response);
+        _prefetchIfEnabled();
+        return;
+    }
+
     invariant(!_connectionHasPendingReplies);
     verify(cursorId && batch.pos == batch.objs.size());
 
@@ -237,6 +251,32 @@ void DBClientCursor::requestMore() {
     });
 
     dataReceived(response);
+    _prefetchIfEnabled();
+}
+
+void DBClientCursor::_prefetchIfEnabled() {
+    if (!_prefetchNextBatch || !cursorId || _connectionHasPendingReplies || !_client ||
+        !_client->lazySupported()) {
+        return;
+    }
+
+    Message toSend = _assembleGetMore();
+    _client->say(toSend);
+    _lastRequestId = toSend.header().getId();
+    _connectionHasPendingReplies = true;
+    _prefetchInFlight = true;
+}
+
+void DBClientCursor::_receivePrefetchedBatch() {
+    invariant(_prefetchInFlight && _client);
+    Message response;
+    const bool received = _client->recv(response, _lastRequestId);
+    _connectionHasPendingReplies = false;
+    _prefetchInFlight = false;
+    if (!received) {
+        uasserted(ErrorCodes::HostUnreachable, "recv failed while prefetching the next batch");
+    }
+    _prefetchedReply = std::move(response);
 }
 
 /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
@@ -443,6 +483,11 @@ void DBClientCursor::attach(AScopedConnection* conn) {
     verify(conn);
     verify(conn->get());
 
+    // The connection is about to go back to the pool, so it must not have a reply on the way
+    if (_prefetchInFlight) {
+        _receivePrefetchedBatch();
+    }
+
     if (conn->get()->type() == ConnectionString::SET) {
         if (_lazyHost.size() > 0)
             _scopedHost = _lazyHost;
@@ -512,13 +557,15 @@ DBClientCursor::DBClientCursor(DBClientBase* client,
       haveLimit(nToReturn > 0 && !(queryOptions & QueryOption_CursorTailable)),
       nToSkip(nToSkip),
       fieldsToReturn(fieldsToReturn),
-      opts(queryOptions & ~QueryOptionLocal_forceOpQuery),
+      opts(queryOptions & ~(QueryOptionLocal_forceOpQuery | QueryOptionLocal_prefetchNextBatch)),
       batchSize(batchSize == 1 ? 2 : batchSize),
       resultFlags(0),
       cursorId(cursorId),
       _ownCursor(true),
       wasError(false),
-      _enabledBSONVersion(Validator<BSONObj>::enabledBSONVersion()) {
+      _enabledBSONVersion(Validator<BSONObj>::enabledBSONVersion()),
+      _prefetchNextBatch((queryOptions & QueryOptionLocal_prefetchNextBatch) && !haveLimit &&
+                         !(queryOptions & (QueryOption_Exhaust | QueryOption_CursorTailable))) {
     if (queryOptions & QueryOptionLocal_forceOpQuery)
         _useFindCommand = false;
 }
@@ -529,6 +576,11 @@ DBClientCursor::~DBClientCursor() {
 
 void DBClientCursor::kill() {
     DESTRUCTOR_GUARD({
+        // Drain the reply to a prefetched getMore so the connection can be used again
+        if (_prefetchInFlight) {
+            _receivePrefetchedBatch();
+        }
+
         if (cursorId && _ownCursor && !globalInShutdownDeprecated()) {
             auto killCursor = [&](auto& conn) {
                 if (_useFindCommand) {
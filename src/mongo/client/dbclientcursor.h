@@ -139,6 +139,15 @@ public:
      */
     enum { QueryOptionLocal_forceOpQuery = 1 << 30 };
 
+    /**
+     * Fold this in with queryOptions to have the cursor request each batch as soon as the previous
+     * one arrives, so the server produces it while the caller consumes the previous batch. The
+     * connection has a pending reply while such a request is outstanding. Ignored for exhaust,
+     * tailable and limited queries, and for connections which do not support lazy requests. This
+     * flag is never sent over the wire and is only used locally.
+     */
+    enum { QueryOptionLocal_prefetchNextBatch = 1 << 29 };
+
     DBClientCursor(DBClientBase* client,
                    const std::string& ns,
                    const BSONObj& query,
@@ -208,8 +217,8 @@ public:
      * If true, you should not try to use the connection for any other purpose or return it to a
      * pool.
      *
-     * This can happen if either initLazy() was called without initLazyFinish() or an exhaust query
-     * was started but not completed.
+     * This can happen if either initLazy() was called without initLazyFinish(), an exhaust query
+     * was started but not completed, or a getMore requested ahead of time has not been received.
      */
     bool connectionHasPendingReplies() const {
         return _connectionHasPendingReplies;
@@ -256,6 +265,9 @@ private:
     bool _useFindCommand = true;
     bool _connectionHasPendingReplies = false;
     int _lastRequestId = 0;
+    const bool _prefetchNextBatch;
+    bool _prefetchInFlight = false;
+    Message _prefetchedReply;
 
     void dataReceived(const Message& reply) {
         bool retry;
@@ -272,6 +284,18 @@ private:
 
     void requestMore();
 
+    /**
+     * If prefetching is enabled and the cursor is still open, sends the getMore for the next batch
+     * without waiting for its reply.
+     */
+    void _prefetchIfEnabled();
+
+    /**
+     * Receives the reply to the getMore sent by _prefetchIfEnabled and holds onto it until the
+     * current batch has been consumed, leaving the connection free of pending replies.
+     */
+    void _receivePrefetchedBatch();
+
     // init pieces
     Message _assembleInit();
     Message _assembleGetMore();
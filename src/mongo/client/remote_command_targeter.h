@@ -106,6 +106,20 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host, const Status& status) = 0;
 
+    /**
+     * Reports to the targeter that a request has been sent to 'host' and that it is waiting for
+     * a response. Every call must be followed by a call to noteResponseReceived for the same host,
+     * once the request completes, regardless of its outcome. Used to take into account the number
+     * of outstanding requests when selecting among multiple eligible hosts.
+     */
+    virtual void noteRequestSent(const HostAndPort& host) = 0;
+
+    /**
+     * Reports to the targeter that a request previously reported through noteRequestSent has
+     * completed.
+     */
+    virtual void noteResponseReceived(const HostAndPort& host) = 0;
+
 protected:
     RemoteCommandTargeter() = default;
 };
@@ -65,6 +65,14 @@ public:
         _mock->markHostUnreachable(host, status);
     }
 
+    void noteRequestSent(const HostAndPort& host) override {
+        _mock->noteRequestSent(host);
+    }
+
+    void noteResponseReceived(const HostAndPort& host) override {
+        _mock->noteResponseReceived(host);
+    }
+
 private:
     const std::shared_ptr<RemoteCommandTargeter> _mock;
 };
@@ -70,6 +70,10 @@ public:
      */
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void noteRequestSent(const HostAndPort& host) override;
+
+    void noteResponseReceived(const HostAndPort& host) override;
+
     /**
      * Sets the return value for the next call to connectionString.
      */
@@ -94,6 +94,18 @@ void RemoteCommandTargeterRS::markHostNotMaster(const HostAndPort& host, const S
     _rsMonitor->failedHost(host, status);
 }
 
+void RemoteCommandTargeterRS::noteRequestSent(const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->noteRequestSent(host);
+}
+
+void RemoteCommandTargeterRS::noteResponseReceived(const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->noteResponseReceived(host);
+}
+
 void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host, const Status& status) {
     invariant(_rsMonitor);
 
@@ -62,4 +62,12 @@ void RemoteCommandTargeterStandalone::markHostUnreachable(const HostAndPort& hos
     dassert(host == _hostAndPort);
 }
 
+void RemoteCommandTargeterStandalone::noteRequestSent(const HostAndPort& host) {
+    dassert(host == _hostAndPort);
+}
+
+void RemoteCommandTargeterStandalone::noteResponseReceived(const HostAndPort& host) {
+    dassert(host == _hostAndPort);
+}
+
 }  // namespace mongo
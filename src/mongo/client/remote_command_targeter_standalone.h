@@ -53,6 +53,10 @@ public:
 
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void noteRequestSent(const HostAndPort& host) override;
+
+    void noteResponseReceived(const HostAndPort& host) override;
+
 private:
     const HostAndPort _hostAndPort;
 };
@@ -329,6 +329,23 @@ void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status
     DEV _state->checkInvariants();
 }
 
+void ReplicaSetMonitor::noteRequestSent(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node)
+        node->numOutstandingRequests++;
+}
+
+void ReplicaSetMonitor::noteResponseReceived(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+
+    // The node may have been removed and re-added to the set since the request was sent, in which
+    // case its count of outstanding requests starts from zero
+    if (node && node->numOutstandingRequests > 0)
+        node->numOutstandingRequests--;
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -1162,8 +1179,21 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     // only in tests
                     return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
                 } else {
-                    // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
+                    // normal case: pick two distinct nodes at random and use the one with fewer
+                    // outstanding requests, so that a member which is slow to respond, for
+                    // example because it is running a compaction or a backup, gets less of the
+                    // load, while the load is still spread randomly among the others
+                    const int32_t numNodes = matchingNodes.size();
+                    const int32_t first = rand.nextInt32(numNodes);
+                    int32_t second = rand.nextInt32(numNodes - 1);
+                    if (second >= first)
+                        second++;
+
+                    const Node* const firstNode = matchingNodes[first];
+                    const Node* const secondNode = matchingNodes[second];
+                    return secondNode->numOutstandingRequests < firstNode->numOutstandingRequests
+                        ? secondNode->host
+                        : firstNode->host;
                 };
             }
 
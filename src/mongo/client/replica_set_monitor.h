@@ -119,6 +119,21 @@ public:
      */
     void failedHost(const HostAndPort& host, const Status& status);
 
+    /**
+     * Notifies this Monitor that a request has been sent to the specified host and a response is
+     * outstanding. Must be paired with a call to noteResponseReceived once the request completes.
+     *
+     * The number of outstanding requests is used as a measure of each host's load when choosing
+     * among several hosts, which are eligible for a read preference.
+     */
+    void noteRequestSent(const HostAndPort& host);
+
+    /**
+     * Notifies this Monitor that a request previously reported through noteRequestSent has
+     * completed, either successfully or with an error.
+     */
+    void noteResponseReceived(const HostAndPort& host);
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
@@ -133,6 +133,7 @@ public:
         Date_t lastWriteDateUpdateTime{};  // set to the local system's time at the time of updating
                                            // lastWriteDate
         repl::OpTime opTime{};             // from isMasterReply
+        int numOutstandingRequests{0};     // requests sent to this node still awaiting a response
     };
 
     typedef std::vector<Node> Nodes;
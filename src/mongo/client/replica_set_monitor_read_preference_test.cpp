@@ -298,6 +298,26 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, SecOnlyPrefersNodeWithFewerOutstandingRequests) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[0].latencyMicros = 1 * 1000;
+    nodes[2].latencyMicros = 1 * 1000;
+    nodes[0].numOutstandingRequests = 10;
+    nodes[2].numOutstandingRequests = 1;
+
+    // Both secondaries are within the latency window, so the less loaded one must always win
+    for (int i = 0; i < 20; i++) {
+        bool isPrimarySelected = true;
+        HostAndPort host =
+            selectNode(nodes, mongo::ReadPreference::SecondaryOnly, tags, 3, &isPrimarySelected);
+
+        ASSERT_EQUALS("c", host.host());
+        ASSERT(!isPrimarySelected);
+    }
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
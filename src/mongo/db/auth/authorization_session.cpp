@@ -901,16 +901,67 @@ void AuthorizationSession::_buildAuthenticatedRolesVector() {
     }
 }
 
+namespace {
+
+// Bounds the number of resources for which a session remembers granted actions.
+const size_t kMaxAuthorizedActionsEntries = 64;
+
+}  // namespace
+
+bool AuthorizationSession::_canUseAuthorizedActions() {
+    if (_authenticatedUsers.getGeneration() != _authorizedActionsUsersGeneration) {
+        _authorizedActions.clear();
+        _authorizedActionsUsersGeneration = _authenticatedUsers.getGeneration();
+    }
+
+    for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
+         ++it) {
+        if (!(*it)->isValid()) {
+            _authorizedActions.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
 bool AuthorizationSession::_isAuthorizedForPrivilege(const Privilege& privilege) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
+    // The default privileges come and go with the localhost exception, so decisions are only
+    // recorded while there are none.
+    PrivilegeVector defaultPrivileges = getDefaultPrivileges();
+    const bool useAuthorizedActions = defaultPrivileges.empty() && _canUseAuthorizedActions();
+
+    if (useAuthorizedActions) {
+        auto it = _authorizedActions.find(target);
+        if (it != _authorizedActions.end() && it->second.isSupersetOf(privilege.getActions()))
+            return true;
+    }
+
+    if (!_searchPrivileges(privilege, defaultPrivileges))
+        return false;
+
+    if (useAuthorizedActions) {
+        if (_authorizedActions.size() >= kMaxAuthorizedActionsEntries &&
+            _authorizedActions.find(target) == _authorizedActions.end()) {
+            _authorizedActions.clear();
+        }
+        _authorizedActions[target].addAllActionsFromSet(privilege.getActions());
+    }
+    return true;
+}
+
+bool AuthorizationSession::_searchPrivileges(const Privilege& privilege,
+                                             const PrivilegeVector& defaultPrivileges) {
+    const ResourcePattern& target(privilege.getResourcePattern());
+
     ResourcePattern resourceSearchList[resourceSearchListCapacity];
     const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
 
     ActionSet unmetRequirements = privilege.getActions();
 
-    PrivilegeVector defaultPrivileges = getDefaultPrivileges();
-    for (PrivilegeVector::iterator it = defaultPrivileges.begin(); it != defaultPrivileges.end();
+    for (PrivilegeVector::const_iterator it = defaultPrivileges.begin();
+         it != defaultPrivileges.end();
          ++it) {
         for (int i = 0; i < resourceSearchListLength; ++i) {
             if (!(it->getResourcePattern() == resourceSearchList[i]))
@@ -39,9 +39,11 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authz_session_external_state.h"
 #include "mongo/db/auth/privilege.h"
+#include "mongo/db/auth/resource_pattern.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -341,8 +343,23 @@ private:
     // lock on the admin database (to update out-of-date user privilege information).
     bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+    // Does the work of _isAuthorizedForPrivilege() by searching the default privileges and the
+    // privileges of every authenticated user.
+    bool _searchPrivileges(const Privilege& privilege, const PrivilegeVector& defaultPrivileges);
+
+    // Returns true if decisions recorded in _authorizedActions may be used, clearing them first
+    // if the set of authenticated users changed since they were recorded.
+    bool _canUseAuthorizedActions();
+
     std::unique_ptr<AuthzSessionExternalState> _externalState;
 
+    // The actions this session was found to be authorized for, by resource. Only grants are
+    // recorded, so repeated checks for the same command skip searching the users' privileges.
+    // The entries are dropped when _authenticatedUsers changes and are not consulted while any
+    // authenticated user is marked invalid by the AuthorizationManager.
+    stdx::unordered_map<ResourcePattern, ActionSet> _authorizedActions;
+    uint64_t _authorizedActionsUsersGeneration = 0;
+
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
     std::vector<UserName> _impersonatedUserNames;
@@ -38,7 +38,10 @@
 #include "mongo/crypto/mechanism_scram.h"
 #include "mongo/crypto/sha1_block.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -47,9 +50,29 @@
 
 namespace mongo {
 
-using std::unique_ptr;
 using std::string;
 
+namespace {
+
+// Creating a SecureRandom opens the system's random source, so all conversations share one.
+stdx::mutex nonceGeneratorMutex;
+auto nonceGenerator = SecureRandom::create();
+
+// Latency of each part of the server side of the handshake. The user acquisition is included in
+// the first step, and is reported separately because it may need a round trip to the config
+// servers.
+TimerStats firstStepStats;
+ServerStatusMetricField<TimerStats> displayFirstStepStats("authentication.scramSha1.firstStep",
+                                                          &firstStepStats);
+TimerStats userAcquisitionStats;
+ServerStatusMetricField<TimerStats> displayUserAcquisitionStats(
+    "authentication.scramSha1.userAcquisition", &userAcquisitionStats);
+TimerStats secondStepStats;
+ServerStatusMetricField<TimerStats> displaySecondStepStats("authentication.scramSha1.secondStep",
+                                                           &secondStepStats);
+
+}  // namespace
+
 SaslSCRAMSHA1ServerConversation::SaslSCRAMSHA1ServerConversation(
     SaslAuthenticationSession* saslAuthSession)
     : SaslServerConversation(saslAuthSession), _step(0), _authMessage(""), _nonce("") {}
@@ -65,9 +88,11 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::step(StringData inputData,
             mongoutils::str::stream() << "Invalid SCRAM-SHA-1 authentication step: " << _step);
     }
     if (_step == 1) {
+        TimerHolder timer(&firstStepStats);
         return _firstStep(input, outputData);
     }
     if (_step == 2) {
+        TimerHolder timer(&secondStepStats);
         return _secondStep(input, outputData);
     }
 
@@ -167,9 +192,12 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::_firstStep(std::vector<string>
 
     // The authentication database is also the source database for the user.
     User* userObj;
-    Status status =
-        _saslAuthSession->getAuthorizationSession()->getAuthorizationManager().acquireUser(
+    Status status = Status::OK();
+    {
+        TimerHolder timer(&userAcquisitionStats);
+        status = _saslAuthSession->getAuthorizationSession()->getAuthorizationManager().acquireUser(
             _saslAuthSession->getOpCtxt(), user, &userObj);
+    }
 
     if (!status.isOK()) {
         return StatusWith<bool>(status);
@@ -199,11 +227,12 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::_firstStep(std::vector<string>
     const int nonceLenQWords = 3;
     uint64_t binaryNonce[nonceLenQWords];
 
-    unique_ptr<SecureRandom> sr(SecureRandom::create());
-
-    binaryNonce[0] = sr->nextInt64();
-    binaryNonce[1] = sr->nextInt64();
-    binaryNonce[2] = sr->nextInt64();
+    {
+        stdx::lock_guard<stdx::mutex> lk(nonceGeneratorMutex);
+        binaryNonce[0] = nonceGenerator->nextInt64();
+        binaryNonce[1] = nonceGenerator->nextInt64();
+        binaryNonce[2] = nonceGenerator->nextInt64();
+    }
 
     _nonce =
         clientNonce + base64::encode(reinterpret_cast<char*>(binaryNonce), sizeof(binaryNonce));
@@ -66,6 +66,7 @@ UserSet::UserSet() : _users(), _usersEnd(_users.end()) {}
 UserSet::~UserSet() {}
 
 User* UserSet::add(User* user) {
+    ++_generation;
     for (mutable_iterator it = mbegin(); it != mend(); ++it) {
         User* current = *it;
         if (current->getName().getDB() == user->getName().getDB()) {
@@ -95,6 +96,7 @@ User* UserSet::removeByDBName(StringData dbname) {
 }
 
 User* UserSet::replaceAt(iterator it, User* replacement) {
+    ++_generation;
     size_t offset = it - begin();
     User* old = _users[offset];
     _users[offset] = replacement;
@@ -102,6 +104,7 @@ User* UserSet::replaceAt(iterator it, User* replacement) {
 }
 
 User* UserSet::removeAt(iterator it) {
+    ++_generation;
     size_t offset = it - begin();
     User* old = _users[offset];
     --_usersEnd;
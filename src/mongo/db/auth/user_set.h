@@ -102,6 +102,11 @@ public:
     // valid until the next non-const method is called on the UserSet.
     UserNameIterator getNames() const;
 
+    // Returns a number that changes whenever users are added, replaced or removed.
+    uint64_t getGeneration() const {
+        return _generation;
+    }
+
     iterator begin() const {
         return _users.begin();
     }
@@ -123,6 +128,8 @@ private:
     // returning them to the AuthorizationManager when done with them.
     std::vector<User*> _users;
     std::vector<User*>::iterator _usersEnd;
+
+    uint64_t _generation = 0;
 };
 
 }  // namespace mongo
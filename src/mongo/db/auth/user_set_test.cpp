@@ -112,5 +112,29 @@ TEST(UserSetTest, IterateNames) {
     ASSERT(!iter.more());
 }
 
+TEST(UserSetTest, GenerationChangesWithMembership) {
+    UserSet set;
+
+    User* p1 = new User(UserName("Bob", "test"));
+    User* p2 = new User(UserName("George", "test"));
+    const std::unique_ptr<User> delp1(p1);
+    const std::unique_ptr<User> delp2(p2);
+
+    uint64_t generation = set.getGeneration();
+    ASSERT_NULL(set.add(p1));
+    ASSERT_NOT_EQUALS(generation, set.getGeneration());
+
+    generation = set.getGeneration();
+    ASSERT_EQUALS(p1, set.replaceAt(set.begin(), p2));
+    ASSERT_NOT_EQUALS(generation, set.getGeneration());
+
+    generation = set.getGeneration();
+    ASSERT_NULL(set.lookup(UserName("Bob", "test")));
+    ASSERT_EQUALS(generation, set.getGeneration());
+
+    ASSERT_EQUALS(p2, set.removeByDBName("test"));
+    ASSERT_NOT_EQUALS(generation, set.getGeneration());
+}
+
 }  // namespace
 }  // namespace mongo
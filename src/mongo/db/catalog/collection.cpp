@@ -64,8 +64,10 @@
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 // Emit the vtable in this TU
@@ -137,6 +139,10 @@ std::string CompactOptions::toString() const {
 
     ss << " validateDocuments: " << validateDocuments;
 
+    if (online) {
+        ss << " online: true onlineRoundSecs: " << onlineRoundSecs;
+    }
+
     return ss.str();
 }
 
@@ -146,30 +152,57 @@ std::string CompactOptions::toString() const {
 
 CappedInsertNotifier::CappedInsertNotifier() : _version(0), _dead(false) {}
 
+CappedInsertNotifier::Stripe& CappedInsertNotifier::_stripeForThisThread() const {
+    return _stripes[std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumStripes];
+}
+
 void CappedInsertNotifier::notifyAll() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    ++_version;
-    _notifier.notify_all();
+    _version.fetchAndAdd(1);
+    for (auto& stripe : _stripes) {
+        if (stripe.waiters.load() == 0)
+            continue;
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        stripe.notifier.notify_all();
+    }
 }
 
-void CappedInsertNotifier::waitUntil(uint64_t prevVersion, Date_t deadline) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    while (!_dead && prevVersion == _version) {
-        if (stdx::cv_status::timeout == _notifier.wait_until(lk, deadline.toSystemTimePoint())) {
-            return;
+void CappedInsertNotifier::waitUntil(uint64_t prevVersion,
+                                     Date_t deadline,
+                                     Milliseconds coalesceFor) const {
+    {
+        Stripe& stripe = _stripeForThisThread();
+        stdx::unique_lock<stdx::mutex> lk(stripe.mutex);
+        stripe.waiters.fetchAndAdd(1);
+        ON_BLOCK_EXIT([&] { stripe.waiters.fetchAndSubtract(1); });
+        while (!_dead.load() && prevVersion == _version.load()) {
+            if (stdx::cv_status::timeout ==
+                stripe.notifier.wait_until(lk, deadline.toSystemTimePoint())) {
+                return;
+            }
         }
     }
+
+    if (coalesceFor <= Milliseconds(0) || _dead.load())
+        return;
+
+    // Sleep rather than wait on the stripe, so that the inserts being coalesced do not wake us.
+    const Date_t coalesceDeadline = std::min(deadline, Date_t::now() + coalesceFor);
+    const Date_t now = Date_t::now();
+    if (coalesceDeadline > now) {
+        stdx::this_thread::sleep_for((coalesceDeadline - now).toSystemDuration());
+    }
 }
 
 void CappedInsertNotifier::kill() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    _dead = true;
-    _notifier.notify_all();
+    _dead.store(true);
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        stripe.notifier.notify_all();
+    }
 }
 
 bool CappedInsertNotifier::isDead() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    return _dead;
+    return _dead.load();
 }
 
 // ----
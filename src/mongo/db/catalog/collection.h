@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -53,6 +54,7 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -85,6 +87,14 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // Set when compacting while other operations keep reading and writing the collection, which
+    // only record stores that compact in place support. The caller then holds intent locks, and
+    // each call compacts the records for at most 'onlineRoundSecs' seconds before failing with
+    // ExceededTimeLimit, so that the caller can release its locks and continue in another round.
+    // The indexes are compacted once the records are done.
+    bool online = false;
+    int onlineRoundSecs = 1;
+
     std::string toString() const;
 
     unsigned computeRecordSize(unsigned recordSize) const {
@@ -115,15 +125,21 @@ public:
      * Waits until 'deadline', or until notifyAll() is called to indicate that new
      * data is available in the capped collection.
      *
+     * If 'coalesceFor' is positive, a thread woken by notifyAll() then waits that much longer,
+     * but not past 'deadline', so that inserts made shortly after the first are seen at once
+     * instead of each causing a wakeup of its own.
+     *
      * NOTE: Waiting threads can be signaled by calling kill or notify* methods.
      */
-    void waitUntil(uint64_t prevVersion, Date_t deadline) const;
+    void waitUntil(uint64_t prevVersion,
+                   Date_t deadline,
+                   Milliseconds coalesceFor = Milliseconds(0)) const;
 
     /**
      * Returns the version for use as an additional wake condition when used above.
      */
     uint64_t getVersion() const {
-        return _version;
+        return _version.load();
     }
 
     /**
@@ -137,20 +153,34 @@ public:
     bool isDead();
 
 private:
-    // Signalled when a successful insert is made into a capped collection.
-    mutable stdx::condition_variable _notifier;
+    // Waiting threads are spread over several stripes by thread id, so that a notification does
+    // not make every waiter contend for the same mutex when it wakes up.
+    struct Stripe {
+        // Signalled when a successful insert is made into a capped collection.
+        stdx::condition_variable notifier;
+
+        // Mutex used with 'notifier'.
+        stdx::mutex mutex;
+
+        // The number of threads waiting on 'notifier'. Lets notifyAll() skip idle stripes.
+        AtomicUInt32 waiters;
+    };
 
-    // Mutex used with '_notifier'. Protects access to '_version'.
-    mutable stdx::mutex _mutex;
+    static const size_t kNumStripes = 16;
+
+    Stripe& _stripeForThisThread() const;
+
+    mutable std::array<Stripe, kNumStripes> _stripes;
 
     // A counter, incremented on insertion of new data into the capped collection.
     //
-    // The condition which '_cappedNewDataNotifier' is being notified of is an increment of this
-    // counter. Access to this counter is synchronized with '_mutex'.
-    uint64_t _version;
+    // The condition which the stripes' notifiers are notified of is an increment of this counter.
+    // It is incremented before any stripe's mutex is taken, and read by waiters while holding
+    // their stripe's mutex, so no notification can be missed.
+    AtomicUInt64 _version;
 
     // True once the notifier is dead.
-    bool _dead;
+    AtomicBool _dead;
 };
 
 /**
@@ -255,6 +285,7 @@ public:
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const UpdateIndexData::IndexSet* affectedIndexes,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) = 0;
 
@@ -324,6 +355,12 @@ public:
         virtual void notifyCappedWaitersIfNeeded() = 0;
 
         virtual const CollatorInterface* getDefaultCollator() const = 0;
+
+        virtual const boost::optional<TimeWindowOptions>& getTimeWindow() const = 0;
+
+        virtual boost::optional<std::string> getCachedDataHash() const = 0;
+
+        virtual void setCachedDataHash(std::string hash) = 0;
     };
 
 private:
@@ -532,8 +569,39 @@ public:
                                    const bool indexesAffected,
                                    OpDebug* const opDebug,
                                    OplogUpdateEntryArgs* const args) {
-        return this->_impl().updateDocument(
-            opCtx, oldLocation, oldDoc, newDoc, enforceQuota, indexesAffected, opDebug, args);
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            nullptr,
+                                            opDebug,
+                                            args);
+    }
+
+    /**
+     * As above, but if the document does not move, only regenerates the keys of the indexes in
+     * 'affectedIndexes', as numbered by the UpdateIndexData of this collection's info cache.
+     */
+    inline RecordId updateDocument(OperationContext* const opCtx,
+                                   const RecordId& oldLocation,
+                                   const Snapshotted<BSONObj>& oldDoc,
+                                   const BSONObj& newDoc,
+                                   const bool enforceQuota,
+                                   const bool indexesAffected,
+                                   const UpdateIndexData::IndexSet& affectedIndexes,
+                                   OpDebug* const opDebug,
+                                   OplogUpdateEntryArgs* const args) {
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            &affectedIndexes,
+                                            opDebug,
+                                            args);
     }
 
     inline bool updateWithDamagesSupported() const {
@@ -728,6 +796,28 @@ public:
         return this->_impl().getDefaultCollator();
     }
 
+    /**
+     * Returns the time window whose documents this collection holds, if it was created with one.
+     */
+    inline const boost::optional<TimeWindowOptions>& getTimeWindow() const {
+        return this->_impl().getTimeWindow();
+    }
+
+    /**
+     * Returns the hash of this collection's documents last recorded by setCachedDataHash(), or
+     * boost::none if the collection has been written to since.
+     */
+    inline boost::optional<std::string> getCachedDataHash() const {
+        return this->_impl().getCachedDataHash();
+    }
+
+    /**
+     * Records the hash dbHash computed over this collection's documents, so that it can be reused
+     * until the next write. The caller must hold a lock which excludes writes to the collection.
+     */
+    inline void setCachedDataHash(std::string hash) {
+        return this->_impl().setCachedDataHash(std::move(hash));
+    }
 
 private:
     inline DatabaseCatalogEntry* dbce() const {
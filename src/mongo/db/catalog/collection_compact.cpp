@@ -107,7 +107,8 @@ private:
 
 StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                                  const CompactOptions* compactOptions) {
-    dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    dassert(opCtx->lockState()->isCollectionLockedForMode(
+        ns().toString(), compactOptions->online ? MODE_IX : MODE_X));
 
     DisableDocumentValidation validationDisabler(opCtx);
 
@@ -117,6 +118,12 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                             << "cannot compact collection with record store: "
                                             << _recordStore->name());
 
+    if (compactOptions->online && !_recordStore->compactsInPlace())
+        return StatusWith<CompactStats>(ErrorCodes::CommandNotSupported,
+                                        str::stream()
+                                            << "cannot compact online with record store: "
+                                            << _recordStore->name());
+
     if (_recordStore->compactsInPlace()) {
         CompactStats stats;
         Status status = _recordStore->compact(opCtx, NULL, compactOptions, &stats);
@@ -41,9 +41,11 @@
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/background.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_build_interceptor.h"
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/namespace_uuid_cache.h"
@@ -160,10 +162,12 @@ CollectionImpl::CollectionImpl(Collection* _this_init,
       _validatorDoc(_details->getCollectionOptions(opCtx).validator.getOwned()),
       _validator(uassertStatusOK(
           parseValidator(opCtx, _validatorDoc, MatchExpressionParser::kAllowAllSpecialFeatures))),
+      _validatorMatcher(stdx::make_unique<PathGroupedMatcher>(_validator.get())),
       _validationAction(uassertStatusOK(
           parseValidationAction(_details->getCollectionOptions(opCtx).validationAction))),
       _validationLevel(uassertStatusOK(
           parseValidationLevel(_details->getCollectionOptions(opCtx).validationLevel))),
+      _timeWindow(_details->getCollectionOptions(opCtx).timeWindow),
       _cursorManager(_ns),
       _cappedNotifier(_recordStore->isCapped() ? stdx::make_unique<CappedInsertNotifier>()
                                                : nullptr),
@@ -243,6 +247,19 @@ bool CollectionImpl::findDoc(OperationContext* opCtx,
 }
 
 Status CollectionImpl::checkValidation(OperationContext* opCtx, const BSONObj& document) const {
+    // Unlike validators, the time window can't be bypassed: queries rely on it to skip the
+    // collection. Replicated writes were already checked on the primary.
+    if (_timeWindow && opCtx->writesAreReplicated()) {
+        BSONElement timeElt =
+            dotted_path_support::extractElementAtPath(document, _timeWindow->field);
+        if (timeElt.type() != mongo::Date || !_timeWindow->contains(timeElt.date())) {
+            return {ErrorCodes::DocumentValidationFailure,
+                    str::stream() << "Document's '" << _timeWindow->field
+                                  << "' field must be a date within the collection's time window "
+                                  << _timeWindow->toBSON()};
+        }
+    }
+
     if (!_validator)
         return Status::OK();
 
@@ -252,7 +269,7 @@ Status CollectionImpl::checkValidation(OperationContext* opCtx, const BSONObj& d
     if (documentValidationDisabled(opCtx))
         return Status::OK();
 
-    if (_validator->matchesBSON(document))
+    if (_validatorMatcher->matchesBSON(document))
         return Status::OK();
 
     if (_validationAction == ValidationAction::WARN) {
@@ -298,7 +315,9 @@ StatusWithMatchExpression CollectionImpl::parseValidator(
     if (!statusWithMatcher.isOK())
         return statusWithMatcher.getStatus();
 
-    return statusWithMatcher;
+    // Optimizing flattens the nested $and nodes that $jsonSchema generates, so the checks for
+    // each property become children of the top-level $and that _validatorMatcher can group.
+    return MatchExpression::optimize(std::move(statusWithMatcher.getValue()));
 }
 
 Status CollectionImpl::insertDocumentsForOplog(OperationContext* opCtx,
@@ -409,6 +428,7 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
     }
 
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+    _invalidateDataHash();
 
     // TODO SERVER-30638: using timestamp 0 for these inserts, which are non-oplog so we don't yet
     // care about their correct timestamps.
@@ -449,6 +469,7 @@ Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
                                         bool enforceQuota,
                                         OpDebug* opDebug) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+    _invalidateDataHash();
 
     const size_t count = std::distance(begin, end);
     if (isCapped() && _indexCatalog.haveAnyIndexes() && count > 1) {
@@ -545,6 +566,8 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
         return;
     }
 
+    _invalidateDataHash();
+
     Snapshotted<BSONObj> doc = docFor(opCtx, loc);
     getGlobalServiceContext()->getOpObserver()->aboutToDelete(opCtx, ns(), doc.value());
 
@@ -577,6 +600,7 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const UpdateIndexData::IndexSet* affectedIndexes,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) {
     {
@@ -598,6 +622,7 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
     invariant(oldDoc.snapshotId() == opCtx->recoveryUnit()->getSnapshotId());
     invariant(newDoc.isOwned());
+    _invalidateDataHash();
 
     if (_needCappedLock) {
         // X-lock the metadata resource for this capped collection until the end of the WUOW. This
@@ -628,7 +653,14 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                 << " != "
                                 << newDoc.objsize());
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
+    // Only the indexes the update may affect need their keys regenerated, unless the caller did
+    // not say which those are.
+    const UpdateIndexData* indexData = affectedIndexes ? &_infoCache.getIndexKeys(opCtx) : nullptr;
+    auto isIndexAffected = [&](const IndexDescriptor* descriptor) {
+        return !indexData || indexData->isIndexAffected(*affectedIndexes, descriptor->indexName());
+    };
+
+    // At the end of this step, we will have a map of UpdateTickets, one per affected index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
     // newDoc.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
@@ -639,6 +671,11 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            // Indexes being built by a hybrid index build record the update instead.
+            if (entry->indexBuildInterceptor() || !isIndexAffected(descriptor)) {
+                continue;
+            }
+
             InsertDeleteOptions options;
             IndexCatalog::prepareInsertDeleteOptions(opCtx, descriptor, &options);
             UpdateTicket* updateTicket = new UpdateTicket();
@@ -671,6 +708,14 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            if (auto interceptor = ii.catalogEntry(descriptor)->indexBuildInterceptor()) {
+                interceptor->recordWrite(opCtx, oldLocation, &oldDoc.value());
+                continue;
+            }
+            if (!isIndexAffected(descriptor)) {
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
             uassertStatusOK(iam->update(
@@ -754,7 +799,7 @@ Status CollectionImpl::recordStoreGoingToUpdateInPlace(OperationContext* opCtx,
 
 
 bool CollectionImpl::updateWithDamagesSupported() const {
-    if (_validator)
+    if (_validator || _timeWindow)
         return false;
 
     return _recordStore->updateWithDamagesSupported();
@@ -769,6 +814,7 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     OplogUpdateEntryArgs* args) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
     invariant(oldRec.snapshotId() == opCtx->recoveryUnit()->getSnapshotId());
+    _invalidateDataHash();
     invariant(updateWithDamagesSupported());
 
     // Broadcast the mutation so that query results stay correct.
@@ -867,6 +913,7 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     _cursorManager.invalidateAll(opCtx, false, "collection truncated");
 
     // 3) truncate record store
+    _invalidateDataHash();
     auto status = _recordStore->truncate(opCtx);
     if (!status.isOK())
         return status;
@@ -888,6 +935,7 @@ void CollectionImpl::cappedTruncateAfter(OperationContext* opCtx, RecordId end,
     invariant(_indexCatalog.numIndexesInProgress(opCtx) == 0);
 
     _cursorManager.invalidateAll(opCtx, false, "capped collection truncated");
+    _invalidateDataHash();
     _recordStore->cappedTruncateAfter(opCtx, end, inclusive);
 }
 
@@ -908,6 +956,7 @@ Status CollectionImpl::setValidator(OperationContext* opCtx, BSONObj validatorDo
     _details->updateValidator(opCtx, validatorDoc, getValidationLevel(), getValidationAction());
 
     _validator = std::move(statusWithMatcher.getValue());
+    _validatorMatcher = stdx::make_unique<PathGroupedMatcher>(_validator.get());
     _validatorDoc = std::move(validatorDoc);
     return Status::OK();
 }
@@ -1029,6 +1078,29 @@ const CollatorInterface* CollectionImpl::getDefaultCollator() const {
     return _collator.get();
 }
 
+boost::optional<std::string> CollectionImpl::getCachedDataHash() const {
+    if (!_hasDataHash.load()) {
+        return boost::none;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_dataHashMutex);
+    return _dataHash;
+}
+
+void CollectionImpl::setCachedDataHash(std::string hash) {
+    stdx::lock_guard<stdx::mutex> lk(_dataHashMutex);
+    _dataHash = std::move(hash);
+    _hasDataHash.store(true);
+}
+
+void CollectionImpl::_invalidateDataHash() {
+    if (!_hasDataHash.load()) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_dataHashMutex);
+    _dataHash = boost::none;
+    _hasDataHash.store(false);
+}
+
 namespace {
 
 using ValidateResultsMap = std::map<std::string, ValidateResults>;
@@ -1122,17 +1194,22 @@ void _markIndexEntriesInvalid(ValidateResultsMap* indexNsResultsMap, ValidateRes
 void _validateIndexKeyCount(OperationContext* opCtx,
                             IndexCatalog* indexCatalog,
                             RecordStore* recordStore,
+                            bool background,
                             RecordStoreValidateAdaptor* indexValidator,
                             ValidateResultsMap* indexNsResultsMap) {
 
+    // The record store's count includes writes made since a background validation took its
+    // snapshot, so compare against the records it saw instead.
+    const int64_t numRecords =
+        background ? indexValidator->numTraversedRecords() : recordStore->numRecords(opCtx);
+
     IndexCatalog::IndexIterator indexIterator = indexCatalog->getIndexIterator(opCtx, false);
     while (indexIterator.more()) {
         IndexDescriptor* descriptor = indexIterator.next();
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
 
         if (curIndexResults.valid) {
-            indexValidator->validateIndexKeyCount(
-                descriptor, recordStore->numRecords(opCtx), curIndexResults);
+            indexValidator->validateIndexKeyCount(descriptor, numRecords, curIndexResults);
         }
     }
 }
@@ -1223,8 +1300,12 @@ Status CollectionImpl::validate(OperationContext* opCtx,
 
         // Validate index key count.
         if (results->valid) {
-            _validateIndexKeyCount(
-                opCtx, &_indexCatalog, _recordStore, &indexValidator, &indexNsResultsMap);
+            _validateIndexKeyCount(opCtx,
+                                   &_indexCatalog,
+                                   _recordStore,
+                                   background,
+                                   &indexValidator,
+                                   &indexNsResultsMap);
         }
 
         // Report the validation results for the user to see
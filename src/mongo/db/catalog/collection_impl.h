@@ -33,6 +33,7 @@
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/matcher/path_grouped_matcher.h"
 
 namespace mongo {
 class IndexConsistency;
@@ -218,6 +219,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const UpdateIndexData::IndexSet* affectedIndexes,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) final;
 
@@ -370,6 +372,14 @@ public:
      */
     const CollatorInterface* getDefaultCollator() const final;
 
+    const boost::optional<TimeWindowOptions>& getTimeWindow() const final {
+        return _timeWindow;
+    }
+
+    boost::optional<std::string> getCachedDataHash() const final;
+
+    void setCachedDataHash(std::string hash) final;
+
 private:
     inline DatabaseCatalogEntry* dbce() const final {
         return this->_dbce;
@@ -416,6 +426,11 @@ private:
 
     bool _enforceQuota(bool userEnforeQuota) const;
 
+    /**
+     * Discards the cached data hash. Called by every write to the collection's documents.
+     */
+    void _invalidateDataHash();
+
     int _magic;
 
     const NamespaceString _ns;
@@ -440,9 +455,17 @@ private:
     // Points into _validatorDoc. Null means no filter.
     std::unique_ptr<MatchExpression> _validator;
 
+    // Evaluates _validator on the write path, resolving the fields shared by several of its
+    // predicates once per document. Rebuilt whenever _validator changes.
+    std::unique_ptr<PathGroupedMatcher> _validatorMatcher;
+
     ValidationAction _validationAction;
     ValidationLevel _validationLevel;
 
+    // Set if the collection holds a single time window. Every document written is checked to be
+    // within the window, which lets queries outside of it skip the collection entirely.
+    const boost::optional<TimeWindowOptions> _timeWindow;
+
     // this is mutable because read only users of the Collection class
     // use it keep state.  This seems valid as const correctness of Collection
     // should be about the data.
@@ -457,6 +480,12 @@ private:
     // The earliest snapshot that is allowed to use this collection.
     boost::optional<Timestamp> _minVisibleSnapshot;
 
+    // The hash dbHash last computed over this collection's documents, if there has been no write
+    // since. Guarded by _dataHashMutex, which writers only take while _hasDataHash is set.
+    mutable stdx::mutex _dataHashMutex;
+    boost::optional<std::string> _dataHash;
+    AtomicWord<bool> _hasDataHash{false};
+
     Collection* _this;
 
     friend class NamespaceDetails;
@@ -38,6 +38,7 @@ namespace mongo {
 class Collection;
 class IndexDescriptor;
 class OperationContext;
+class QueryStatsStore;
 
 /**
  * this is for storing things that you want to cache about a single collection
@@ -53,10 +54,18 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual QueryStatsStore* getQueryStats() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
+        virtual void setIndexStatistics(StringData indexName,
+                                        std::shared_ptr<const IndexStatistics> statistics) = 0;
+
+        virtual std::shared_ptr<const IndexStatistics> getIndexStatistics(
+            StringData indexName) const = 0;
+
         virtual void init(OperationContext* opCtx) = 0;
 
         virtual void addedIndex(OperationContext* opCtx, const IndexDescriptor* desc) = 0;
@@ -103,6 +112,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the per-shape query execution statistics for this collection.
+     */
+    inline QueryStatsStore* getQueryStats() const {
+        return this->_impl().getQueryStats();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -121,6 +137,26 @@ public:
         return this->_impl().getIndexUsageStats();
     }
 
+    /**
+     * Replaces the data-distribution statistics of index 'indexName', which the planner may use
+     * to estimate the selectivity of its bounds.
+     *
+     * Must be called under exclusive collection lock.
+     */
+    inline void setIndexStatistics(const StringData indexName,
+                                   std::shared_ptr<const IndexStatistics> statistics) {
+        return this->_impl().setIndexStatistics(indexName, std::move(statistics));
+    }
+
+    /**
+     * Returns the data-distribution statistics of index 'indexName', or null if none have been
+     * built since the index was registered.
+     */
+    inline std::shared_ptr<const IndexStatistics> getIndexStatistics(
+        const StringData indexName) const {
+        return this->_impl().getIndexStatistics(indexName);
+    }
+
     /**
      * Register a newly-created index with the cache.  Must be called whenever an index is
      * built on the associated collection.
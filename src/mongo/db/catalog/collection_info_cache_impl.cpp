@@ -32,6 +32,8 @@
 
 #include "mongo/db/catalog/collection_info_cache_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -40,6 +42,8 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/ttl_collection_cache.h"
@@ -65,6 +69,8 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _queryStats(stdx::make_unique<QueryStatsStore>(
+          std::max(0, internalQueryStatsMaxShapesPerCollection.load()))),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -91,6 +97,7 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(opCtx, true);
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
+        const std::string& indexName = descriptor->indexName();
 
         if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
             BSONObj key = descriptor->keyPattern();
@@ -101,28 +108,28 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
             BSONObjIterator j(key);
             while (j.more()) {
                 BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
+                _indexedPaths.addPath(e.fieldName(), indexName);
             }
         } else {
             fts::FTSSpec ftsSpec(descriptor->infoObj());
 
             if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
+                _indexedPaths.allPathsIndexed(indexName);
             } else {
                 for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
+                    _indexedPaths.addPath(ftsSpec.extraBefore(i), indexName);
                 }
                 for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
                      it != ftsSpec.weights().end();
                      ++it) {
-                    _indexedPaths.addPath(it->first);
+                    _indexedPaths.addPath(it->first, indexName);
                 }
                 for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
+                    _indexedPaths.addPath(ftsSpec.extraAfter(i), indexName);
                 }
                 // Any update to a path containing "language" as a component could change the
                 // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
+                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField(), indexName);
             }
         }
 
@@ -133,11 +140,17 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
             unordered_set<std::string> paths;
             QueryPlannerIXSelect::getFields(filter, "", &paths);
             for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
+                _indexedPaths.addPath(*it, indexName);
             }
         }
     }
 
+    // Expiring time window collections are dropped by the TTL monitor, so it must visit them too.
+    const auto& timeWindow = _collection->getTimeWindow();
+    if (timeWindow && timeWindow->expireAfterSeconds) {
+        _hasTTLIndex = true;
+    }
+
     TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
 
     if (_hasTTLIndex != hadTTLIndex) {
@@ -174,6 +187,10 @@ PlanCache* CollectionInfoCacheImpl::getPlanCache() const {
     return _planCache.get();
 }
 
+QueryStatsStore* CollectionInfoCacheImpl::getQueryStats() const {
+    return _queryStats.get();
+}
+
 QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
@@ -248,4 +265,14 @@ void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
 CollectionIndexUsageMap CollectionInfoCacheImpl::getIndexUsageStats() const {
     return _indexUsageTracker.getUsageStats();
 }
+
+void CollectionInfoCacheImpl::setIndexStatistics(
+    StringData indexName, std::shared_ptr<const IndexStatistics> statistics) {
+    _indexUsageTracker.setIndexStatistics(indexName, std::move(statistics));
+}
+
+std::shared_ptr<const IndexStatistics> CollectionInfoCacheImpl::getIndexStatistics(
+    StringData indexName) const {
+    return _indexUsageTracker.getIndexStatistics(indexName);
+}
 }  // namespace mongo
@@ -61,6 +61,11 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the per-shape query execution statistics for this collection.
+     */
+    QueryStatsStore* getQueryStats() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -75,6 +80,18 @@ public:
      */
     CollectionIndexUsageMap getIndexUsageStats() const;
 
+    /**
+     * Replaces the data-distribution statistics of index 'indexName'. Must be called under
+     * exclusive collection lock.
+     */
+    void setIndexStatistics(StringData indexName,
+                            std::shared_ptr<const IndexStatistics> statistics);
+
+    /**
+     * Returns the data-distribution statistics of index 'indexName', or null if there are none.
+     */
+    std::shared_ptr<const IndexStatistics> getIndexStatistics(StringData indexName) const;
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog
      */
@@ -131,6 +148,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Execution statistics per query shape, for $queryStats.
+    std::unique_ptr<QueryStatsStore> _queryStats;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
@@ -175,6 +175,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const UpdateIndexData::IndexSet* affectedIndexes,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) {
         std::abort();
@@ -288,6 +289,18 @@ public:
         std::abort();
     }
 
+    const boost::optional<TimeWindowOptions>& getTimeWindow() const {
+        std::abort();
+    }
+
+    boost::optional<std::string> getCachedDataHash() const {
+        std::abort();
+    }
+
+    void setCachedDataHash(std::string hash) {
+        std::abort();
+    }
+
     OptionalCollectionUUID uuid() const {
         std::abort();
     }
@@ -53,6 +53,74 @@ bool CollectionOptions::validMaxCappedDocs(long long* max) {
     return false;
 }
 
+// static
+StatusWith<TimeWindowOptions> TimeWindowOptions::parse(const BSONElement& elem) {
+    if (elem.type() != mongo::Object) {
+        return {ErrorCodes::TypeMismatch, "'timeWindow' has to be a document."};
+    }
+
+    TimeWindowOptions window;
+    bool hasStart = false;
+    bool hasEnd = false;
+    for (auto&& option : elem.Obj()) {
+        const StringData optionName = option.fieldNameStringData();
+        if (optionName == "field") {
+            if (option.type() != mongo::String || option.valueStringData().empty()) {
+                return {ErrorCodes::BadValue, "'timeWindow.field' has to be a non-empty string."};
+            }
+            window.field = option.String();
+        } else if (optionName == "start" || optionName == "end") {
+            if (option.type() != mongo::Date) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "'timeWindow." << optionName << "' has to be a date."};
+            }
+            if (optionName == "start") {
+                window.start = option.date();
+                hasStart = true;
+            } else {
+                window.end = option.date();
+                hasEnd = true;
+            }
+        } else if (optionName == "expireAfterSeconds") {
+            if (!option.isNumber() || option.numberLong() < 0) {
+                return {ErrorCodes::BadValue,
+                        "'timeWindow.expireAfterSeconds' has to be a non-negative number."};
+            }
+            window.expireAfterSeconds = option.numberLong();
+        } else {
+            return {ErrorCodes::InvalidOptions,
+                    str::stream() << "The field 'timeWindow." << optionName
+                                  << "' is not a valid time window option."};
+        }
+    }
+
+    if (window.field.empty() || !hasStart || !hasEnd) {
+        return {ErrorCodes::BadValue, "'timeWindow' requires 'field', 'start' and 'end'."};
+    }
+    if (window.end <= window.start) {
+        return {ErrorCodes::BadValue, "'timeWindow.end' has to be after 'timeWindow.start'."};
+    }
+    return window;
+}
+
+BSONObj TimeWindowOptions::toBSON() const {
+    BSONObjBuilder b;
+    b.append("field", field);
+    b.append("start", start);
+    b.append("end", end);
+    if (expireAfterSeconds) {
+        b.append("expireAfterSeconds", *expireAfterSeconds);
+    }
+    return b.obj();
+}
+
+boost::optional<Date_t> TimeWindowOptions::expiresAt() const {
+    if (!expireAfterSeconds) {
+        return boost::none;
+    }
+    return end + Seconds(*expireAfterSeconds);
+}
+
 namespace {
 
 Status checkStorageEngineOptions(const BSONElement& elem) {
@@ -226,6 +294,13 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             collation = e.Obj().getOwned();
+        } else if (fieldName == "timeWindow") {
+            auto window = TimeWindowOptions::parse(e);
+            if (!window.isOK()) {
+                return window.getStatus();
+            }
+
+            timeWindow = std::move(window.getValue());
         } else if (fieldName == "viewOn") {
             if (e.type() != mongo::String) {
                 return Status(ErrorCodes::BadValue, "'viewOn' has to be a string.");
@@ -253,6 +328,11 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (timeWindow && (capped || !viewOn.empty())) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "'timeWindow' cannot be specified for capped collections or views");
+    }
+
     return Status::OK();
 }
 
@@ -309,6 +389,10 @@ BSONObj CollectionOptions::toBSON() const {
         b.append("collation", collation);
     }
 
+    if (timeWindow) {
+        b.append("timeWindow", timeWindow->toBSON());
+    }
+
     if (!viewOn.empty()) {
         b.append("viewOn", viewOn);
     }
@@ -33,6 +33,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/uuid.h"
 
@@ -51,6 +52,35 @@ using CollectionUUID = UUID;
 
 using OptionalCollectionUUID = boost::optional<CollectionUUID>;
 
+/**
+ * Describes a collection which holds the documents of one time window: every document has a Date
+ * in 'field' within [start, end). Queries whose predicate on 'field' can't match the window are
+ * answered without reading the collection, and the TTL monitor drops the whole collection once
+ * 'expireAfterSeconds' have passed since 'end'.
+ *
+ * Parsed from {field: <string>, start: <Date>, end: <Date>, expireAfterSeconds: <number>}, where
+ * 'expireAfterSeconds' is optional.
+ */
+struct TimeWindowOptions {
+    static StatusWith<TimeWindowOptions> parse(const BSONElement& elem);
+
+    BSONObj toBSON() const;
+
+    bool contains(Date_t date) const {
+        return start <= date && date < end;
+    }
+
+    /**
+     * Returns the time after which the window is dropped, if it expires at all.
+     */
+    boost::optional<Date_t> expiresAt() const;
+
+    std::string field;
+    Date_t start;
+    Date_t end;
+    boost::optional<long long> expireAfterSeconds;
+};
+
 struct CollectionOptions {
     /**
      * Returns true if the options indicate the namespace is a view.
@@ -129,6 +159,9 @@ struct CollectionOptions {
     // The namespace's default collation.
     BSONObj collation;
 
+    // Set if the collection holds the documents of a single time window.
+    boost::optional<TimeWindowOptions> timeWindow;
+
     // View-related options.
     // The namespace of the view or collection that "backs" this view, or the empty string if this
     // collection is not a view.
@@ -333,4 +333,44 @@ TEST(CollectionOptions, ParseUUID) {
     // Check that a collection options containing a UUID passes validation.
     ASSERT_OK(options.validateForStorage());
 }
+
+TEST(CollectionOptions, TimeWindowRoundTrip) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson(
+        "{timeWindow: {field: 'ts', start: {$date: 1000}, end: {$date: 2000}, "
+        "expireAfterSeconds: 60}}")));
+    ASSERT(options.timeWindow);
+    ASSERT_EQ(options.timeWindow->field, "ts");
+    ASSERT_EQ(options.timeWindow->start, Date_t::fromMillisSinceEpoch(1000));
+    ASSERT_EQ(options.timeWindow->end, Date_t::fromMillisSinceEpoch(2000));
+    ASSERT_EQ(*options.timeWindow->expiresAt(), Date_t::fromMillisSinceEpoch(62000));
+    ASSERT_TRUE(options.timeWindow->contains(Date_t::fromMillisSinceEpoch(1000)));
+    ASSERT_FALSE(options.timeWindow->contains(Date_t::fromMillisSinceEpoch(2000)));
+    checkRoundTrip(options);
+    ASSERT_OK(options.validateForStorage());
+
+    ASSERT_OK(options.parse(
+        fromjson("{timeWindow: {field: 'ts', start: {$date: 1000}, end: {$date: 2000}}}")));
+    ASSERT_FALSE(options.timeWindow->expiresAt());
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, InvalidTimeWindowsAreRejected) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{timeWindow: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeWindow: {start: {$date: 1}, end: {$date: 2}}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeWindow: {field: 'ts', start: {$date: 1}}}")));
+    ASSERT_NOT_OK(
+        options.parse(fromjson("{timeWindow: {field: 'ts', start: 1, end: {$date: 2}}}")));
+    ASSERT_NOT_OK(options.parse(
+        fromjson("{timeWindow: {field: 'ts', start: {$date: 2}, end: {$date: 2}}}")));
+    ASSERT_NOT_OK(options.parse(
+        fromjson("{timeWindow: {field: 'ts', start: {$date: 1}, end: {$date: 2}, "
+                 "expireAfterSeconds: -1}}")));
+    ASSERT_NOT_OK(options.parse(
+        fromjson("{timeWindow: {field: 'ts', start: {$date: 1}, end: {$date: 2}, other: 1}}")));
+    ASSERT_NOT_OK(options.parse(
+        fromjson("{capped: true, size: 1024, "
+                 "timeWindow: {field: 'ts', start: {$date: 1}, end: {$date: 2}}}")));
+}
 }  // namespace mongo
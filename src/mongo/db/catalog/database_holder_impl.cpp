@@ -99,13 +99,14 @@ Database* DatabaseHolderImpl::get(OperationContext* opCtx, StringData ns) const
     const StringData db = _todb(ns);
     invariant(opCtx->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
-        return it->second;
-    }
+    return _published.read([db](const DBs& dbs) -> Database* {
+        DBs::const_iterator it = dbs.find(db);
+        return it != dbs.end() ? it->second : nullptr;
+    });
+}
 
-    return NULL;
+void DatabaseHolderImpl::_publish_inlock() {
+    _published.publish(_dbs);
 }
 
 std::set<std::string> DatabaseHolderImpl::_getNamesWithConflictingCasing_inlock(StringData name) {
@@ -179,6 +180,7 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
     invariant(it != _dbs.end() && it->second == nullptr);
     it->second = newDb.release();
     invariant(_getNamesWithConflictingCasing_inlock(dbname.toString()).empty());
+    _publish_inlock();
 
     return it->second;
 }
@@ -206,6 +208,7 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
     db = nullptr;
 
     _dbs.erase(it);
+    _publish_inlock();
 
     getGlobalServiceContext()
         ->getGlobalStorageEngine()
@@ -245,6 +248,7 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
         delete db;
 
         _dbs.erase(name);
+        _publish_inlock();
 
         getGlobalServiceContext()
             ->getGlobalStorageEngine()
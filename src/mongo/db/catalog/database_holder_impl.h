@@ -36,6 +36,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/epoch_snapshot.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -91,8 +92,20 @@ public:
 private:
     std::set<std::string> _getNamesWithConflictingCasing_inlock(StringData name);
 
+    /**
+     * Makes the current contents of '_dbs' visible to get(). Must be called with '_m' held after
+     * every change to a non-null entry of '_dbs'.
+     */
+    void _publish_inlock();
+
     typedef StringMap<Database*> DBs;
+
+    // Protects '_dbs', which is the authoritative registry, including the transient nullptr
+    // entries used while a database is being opened. Also serializes publishing to '_published'.
     mutable SimpleMutex _m;
     DBs _dbs;
+
+    // Lock-free copy of '_dbs' used by get(), which runs on every database access.
+    EpochSnapshot<DBs> _published;
 };
 }  // namespace mongo
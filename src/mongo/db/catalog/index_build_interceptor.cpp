@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/index_build_interceptor.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+// Maximum number of RecordIds reconciled in one WriteUnitOfWork when draining.
+const size_t kDrainBatchSize = 1000;
+}  // namespace
+
+IndexBuildInterceptor::IndexBuildInterceptor(IndexCatalogEntry* entry) : _entry(entry) {}
+
+void IndexBuildInterceptor::recordWrite(OperationContext* opCtx,
+                                        const RecordId& loc,
+                                        const BSONObj* oldDoc) {
+    // A previous version outside of a partial index cannot have any keys in it.
+    const MatchExpression* filter = _entry->getFilterExpression();
+    BSONObj ownedOldDoc;
+    if (oldDoc && (!filter || filter->matchesBSON(*oldDoc))) {
+        ownedOldDoc = oldDoc->getOwned();
+    }
+
+    opCtx->recoveryUnit()->onCommit([this, loc, ownedOldDoc] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& oldDocs = _pending[loc];
+        if (!ownedOldDoc.isEmpty()) {
+            oldDocs.push_back(ownedOldDoc);
+        }
+    });
+}
+
+Status IndexBuildInterceptor::drain(OperationContext* opCtx,
+                                    const Collection* collection,
+                                    const InsertDeleteOptions& options,
+                                    bool keepRecordedWrites) {
+    if (keepRecordedWrites) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto&& pending : _pending) {
+            Status status = _reconcile(opCtx, collection, options, pending.first, pending.second);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    // Only drain the writes that were pending when we started, so that a steady stream of new
+    // writes cannot keep us here. Those are left for the final drain.
+    size_t remaining = numPending();
+    while (remaining > 0) {
+        opCtx->checkForInterrupt();
+
+        PendingWrites batch;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto end = _pending.begin();
+            while (end != _pending.end() && batch.size() < std::min(remaining, kDrainBatchSize)) {
+                batch.insert(batch.end(), std::move(*end));
+                ++end;
+            }
+            _pending.erase(_pending.begin(), end);
+        }
+        if (batch.empty()) {
+            break;
+        }
+        remaining -= std::min(remaining, batch.size());
+
+        Status status = writeConflictRetry(opCtx, "index build drain", collection->ns().ns(), [&] {
+            WriteUnitOfWork wunit(opCtx);
+            for (auto&& pending : batch) {
+                Status reconcileStatus =
+                    _reconcile(opCtx, collection, options, pending.first, pending.second);
+                if (!reconcileStatus.isOK()) {
+                    return reconcileStatus;
+                }
+            }
+            wunit.commit();
+            return Status::OK();
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    LOG(1) << "index build drain of " << _entry->descriptor()->indexName() << " left "
+           << numPending() << " writes for later";
+    return Status::OK();
+}
+
+size_t IndexBuildInterceptor::numPending() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _pending.size();
+}
+
+Status IndexBuildInterceptor::_reconcile(OperationContext* opCtx,
+                                         const Collection* collection,
+                                         const InsertDeleteOptions& options,
+                                         const RecordId& loc,
+                                         const std::vector<BSONObj>& oldDocs) {
+    IndexAccessMethod* iam = _entry->accessMethod();
+
+    // Remove whatever keys previous versions of the document may have left in the index, even if
+    // they are also keys of the current version, which are inserted again below. As for any
+    // unfinished index, the removal must match the RecordId.
+    InsertDeleteOptions removeOptions = options;
+    removeOptions.dupsAllowed = true;
+    removeOptions.getKeysMode = IndexAccessMethod::GetKeysMode::kRelaxConstraints;
+    for (auto&& oldDoc : oldDocs) {
+        int64_t numDeleted;
+        Status status = iam->remove(opCtx, oldDoc, loc, removeOptions, &numDeleted);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    Snapshotted<BSONObj> doc;
+    if (!collection->findDoc(opCtx, loc, &doc)) {
+        // The document was deleted.
+        return Status::OK();
+    }
+
+    const MatchExpression* filter = _entry->getFilterExpression();
+    if (filter && !filter->matchesBSON(doc.value())) {
+        return Status::OK();
+    }
+
+    int64_t numInserted;
+    return iam->insert(opCtx, doc.value(), loc, options, &numInserted);
+}
+
+}  // namespace mongo
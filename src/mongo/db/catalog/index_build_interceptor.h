@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class Collection;
+class IndexCatalogEntry;
+class OperationContext;
+struct InsertDeleteOptions;
+
+/**
+ * Records the writes made to the documents of a collection while a hybrid index build of one of
+ * its indexes is bulk loading the index, so that the index build can apply them afterwards.
+ *
+ * While an IndexBuildInterceptor is installed on an IndexCatalogEntry, inserts, updates and
+ * deletes do not modify the index. Instead, the interceptor remembers which RecordIds were written
+ * and the previous versions of their documents. The index build later reconciles each of these
+ * RecordIds: it removes the keys of the previous versions and inserts the keys of the version that
+ * is current at that time. This does not depend on the order in which the writes were recorded, so
+ * the collection scan feeding the bulk load may yield and see any committed version of a document.
+ *
+ * Writes are only recorded once their WriteUnitOfWork commits. All methods are thread-safe.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    explicit IndexBuildInterceptor(IndexCatalogEntry* entry);
+
+    /**
+     * Records a write to the document at 'loc'. 'oldDoc' is the version of the document that was
+     * replaced or deleted, and is null if the document was inserted.
+     */
+    void recordWrite(OperationContext* opCtx, const RecordId& loc, const BSONObj* oldDoc);
+
+    /**
+     * Reconciles the index with the current version of every document recorded by recordWrite(),
+     * in batches, each in its own WriteUnitOfWork.
+     *
+     * If 'keepRecordedWrites' is false, RecordIds are forgotten once their batch commits, and
+     * writes recorded concurrently are left for a later call. If it is true, the caller must hold
+     * the collection exclusively and is responsible for the enclosing WriteUnitOfWork, so that the
+     * drain can be retried after a WriteConflictException without losing any recorded writes.
+     */
+    Status drain(OperationContext* opCtx,
+                 const Collection* collection,
+                 const InsertDeleteOptions& options,
+                 bool keepRecordedWrites);
+
+    /**
+     * Returns the number of RecordIds waiting to be reconciled.
+     */
+    size_t numPending() const;
+
+private:
+    using PendingWrites = std::map<RecordId, std::vector<BSONObj>>;
+
+    Status _reconcile(OperationContext* opCtx,
+                      const Collection* collection,
+                      const InsertDeleteOptions& options,
+                      const RecordId& loc,
+                      const std::vector<BSONObj>& oldDocs);
+
+    IndexCatalogEntry* const _entry;
+
+    mutable stdx::mutex _mutex;
+
+    // Maps each written RecordId to the previous versions of its document.
+    PendingWrites _pending;
+};
+
+}  // namespace mongo
@@ -48,6 +48,7 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
@@ -100,6 +101,10 @@ public:
         virtual boost::optional<Timestamp> getMinimumVisibleSnapshot() = 0;
 
         virtual void setMinimumVisibleSnapshot(Timestamp name) = 0;
+
+        virtual IndexBuildInterceptor* indexBuildInterceptor() const = 0;
+
+        virtual void setIndexBuildInterceptor(IndexBuildInterceptor* interceptor) = 0;
     };
 
 private:
@@ -240,6 +245,18 @@ public:
         return this->_impl().setMinimumVisibleSnapshot(name);
     }
 
+    /**
+     * If not null, writes to this unfinished index are recorded by the returned interceptor instead
+     * of being applied to the index, and are applied when the index build drains them.
+     */
+    IndexBuildInterceptor* indexBuildInterceptor() const {
+        return this->_impl().indexBuildInterceptor();
+    }
+
+    void setIndexBuildInterceptor(IndexBuildInterceptor* const interceptor) {
+        return this->_impl().setIndexBuildInterceptor(interceptor);
+    }
+
 private:
     // This structure exists to give us a customization point to decide how to force users of this
     // class to depend upon the corresponding `index_catalog_entry.cpp` Translation Unit (TU).  All
@@ -49,6 +49,7 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
@@ -160,6 +161,14 @@ public:
         _minVisibleSnapshot = name;
     }
 
+    IndexBuildInterceptor* indexBuildInterceptor() const final {
+        return _indexBuildInterceptor;
+    }
+
+    void setIndexBuildInterceptor(IndexBuildInterceptor* interceptor) final {
+        _indexBuildInterceptor = interceptor;
+    }
+
 private:
     class SetMultikeyChange;
     class SetHeadChange;
@@ -227,5 +236,9 @@ private:
 
     // The earliest snapshot that is allowed to read this index.
     boost::optional<Timestamp> _minVisibleSnapshot;
+
+    // Not owned here. Only set while a hybrid index build of this index is in progress. It is set
+    // and cleared while holding the collection exclusively.
+    IndexBuildInterceptor* _indexBuildInterceptor = nullptr;
 };
 }  // namespace mongo
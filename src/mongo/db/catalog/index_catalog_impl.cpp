@@ -42,6 +42,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/index_build_interceptor.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/client.h"
@@ -1317,6 +1318,21 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    if (bsonRecords.size() > 1) {
+        // A failed batch fails the whole multi-document insert, whose WriteUnitOfWork is then
+        // rolled back, so there is no need for per-document cleanup here.
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertBatch(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1336,6 +1352,13 @@ Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
                                        int64_t* keysInsertedOut) {
+    if (auto interceptor = index->indexBuildInterceptor()) {
+        for (auto bsonRecord : bsonRecords) {
+            interceptor->recordWrite(opCtx, bsonRecord.id, nullptr);
+        }
+        return Status::OK();
+    }
+
     const MatchExpression* filter = index->getFilterExpression();
     if (!filter)
         return _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
@@ -1355,6 +1378,11 @@ Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
                                         const RecordId& loc,
                                         bool logIfError,
                                         int64_t* keysDeletedOut) {
+    if (auto interceptor = index->indexBuildInterceptor()) {
+        interceptor->recordWrite(opCtx, loc, &obj);
+        return Status::OK();
+    }
+
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
     options.logIfError = logIfError;
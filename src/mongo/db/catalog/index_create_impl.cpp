@@ -38,6 +38,7 @@
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_build_interceptor.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -47,8 +48,11 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -99,6 +103,39 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+AtomicInt32 maxIndexBuildParallelism(1);
+
+class ExportedMaxIndexBuildParallelismParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedMaxIndexBuildParallelismParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "maxIndexBuildParallelism",
+              &maxIndexBuildParallelism) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "maxIndexBuildParallelism must be between 1 and 64");
+        }
+
+        return Status::OK();
+    }
+
+} exportedMaxIndexBuildParallelismParameter;
+
+// Background builds of non-unique indexes bulk load the index from a collection scan which yields,
+// like a foreground build, while recording concurrent writes to apply to the index afterwards.
+MONGO_EXPORT_SERVER_PARAMETER(useHybridIndexBuilds, bool, false);
+
+namespace {
+// When foreground index keys are generated in parallel, documents are buffered until there are
+// this many for each partition, or until they use this many bytes.
+const size_t kParallelBatchDocumentsPerPartition = 1024;
+const size_t kParallelBatchMaxBytes = 64 * 1024 * 1024;
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -203,6 +240,14 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
     if (!status.isOK())
         return status;
 
+    // Foreground builds may generate and sort their keys on several threads, each filling its
+    // own partition of every bulk builder.
+    _numBulkPartitions =
+        _buildInBackground ? 1 : static_cast<size_t>(maxIndexBuildParallelism.load());
+
+    const bool useHybridBuild = _buildInBackground && useHybridIndexBuilds.load() &&
+        _opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
 
@@ -248,14 +293,22 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!status.isOK())
             return status;
 
+        const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
+
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
+            index.bulk =
+                index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes, _numBulkPartitions);
+        } else if (useHybridBuild && !descriptor->unique()) {
+            // Nothing changes the index under a hybrid build either, since writes are recorded by
+            // the interceptor until the build applies them. Unique indexes are excluded because
+            // recorded writes would no longer be rejected as duplicates when they are made.
+            index.interceptor = stdx::make_unique<IndexBuildInterceptor>(index.block->getEntry());
+            index.block->getEntry()->setIndexBuildInterceptor(index.interceptor.get());
             index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
         }
 
-        const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
-
         IndexCatalog::prepareInsertDeleteOptions(_opCtx, descriptor, &index.options);
         index.options.dupsAllowed = index.options.dupsAllowed || _ignoreUnique;
         if (_ignoreUnique) {
@@ -263,9 +316,16 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         }
 
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
-        if (index.bulk)
+        if (index.bulk) {
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+            if (_numBulkPartitions > 1) {
+                log() << "\t generating and sorting keys on " << _numBulkPartitions << " threads";
+            }
+            if (index.interceptor) {
+                log() << "\t recording concurrent writes to apply once the index is bulk loaded";
+            }
+        }
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -315,6 +375,24 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // Foreground builds with more than one bulk partition scan the collection on this thread as
+    // usual, but hand off batches of documents to a pool which generates and sorts their keys.
+    std::unique_ptr<ThreadPool> keyGeneratorPool;
+    std::vector<std::pair<BSONObj, RecordId>> batch;
+    size_t batchBytes = 0;
+    if (_numBulkPartitions > 1) {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGenerator";
+        options.threadNamePrefix = "IndexBuildKeyGenerator-";
+        options.minThreads = _numBulkPartitions;
+        options.maxThreads = _numBulkPartitions;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        keyGeneratorPool = stdx::make_unique<ThreadPool>(options);
+        keyGeneratorPool->startup();
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -345,6 +423,24 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
+            if (keyGeneratorPool) {
+                batch.emplace_back(objToIndex.value().getOwned(), loc);
+                batchBytes += static_cast<size_t>(batch.back().first.objsize());
+                if (batch.size() >= _numBulkPartitions * kParallelBatchDocumentsPerPartition ||
+                    batchBytes >= kParallelBatchMaxBytes) {
+                    Status ret = _insertBatchInParallel(keyGeneratorPool.get(), &batch);
+                    if (!ret.isOK()) {
+                        return ret;
+                    }
+                    batchBytes = 0;
+                }
+
+                progress->hit();
+                n++;
+                retries = 0;
+                continue;
+            }
+
             WriteUnitOfWork wunit(_opCtx);
             Status ret = insert(objToIndex.value(), loc);
             if (_buildInBackground)
@@ -392,6 +488,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
                 WorkingSetCommon::toStatusString(objToIndex.value()),
             state == PlanExecutor::IS_EOF);
 
+    if (keyGeneratorPool) {
+        Status ret = _insertBatchInParallel(keyGeneratorPool.get(), &batch);
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
         // Unlock before hanging so replication recognizes we've completed.
         Locker::LockSnapshot lockInfo;
@@ -437,6 +540,68 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::_insertBatchInParallel(
+    ThreadPool* pool, std::vector<std::pair<BSONObj, RecordId>>* batch) {
+    // Each partition is handed a contiguous slice of the batch, and only inserts into its own
+    // partition of each bulk builder. The bulk builders merge the sorted partitions at commit.
+    std::vector<Status> statuses(_numBulkPartitions, Status::OK());
+    for (size_t partition = 0; partition < _numBulkPartitions; ++partition) {
+        const size_t begin = batch->size() * partition / _numBulkPartitions;
+        const size_t end = batch->size() * (partition + 1) / _numBulkPartitions;
+        if (begin == end) {
+            continue;
+        }
+
+        Status scheduleStatus = pool->schedule([this, batch, partition, begin, end, &statuses] {
+            try {
+                for (size_t i = begin; i < end; ++i) {
+                    Status status = _insertIntoPartition(
+                        partition, (*batch)[i].first, (*batch)[i].second);
+                    if (!status.isOK()) {
+                        statuses[partition] = status;
+                        return;
+                    }
+                }
+            } catch (...) {
+                statuses[partition] = exceptionToStatus();
+            }
+        });
+        if (!scheduleStatus.isOK()) {
+            statuses[partition] = scheduleStatus;
+            break;
+        }
+    }
+    pool->waitForIdle();
+    batch->clear();
+
+    // Report the error for the earliest document in scan order, as a serial build would have.
+    for (auto&& status : statuses) {
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::_insertIntoPartition(size_t partition,
+                                                 const BSONObj& doc,
+                                                 const RecordId& loc) {
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
+            continue;
+        }
+
+        // The bulk builder only generates and sorts keys, so it does not use the
+        // OperationContext and may be called from a thread other than the one owning it.
+        int64_t unused;
+        Status idxStatus = _indexes[i].bulk->insertIntoPartition(
+            partition, _opCtx, doc, loc, _indexes[i].options, &unused);
+        if (!idxStatus.isOK())
+            return idxStatus;
+    }
+    return Status::OK();
+}
+
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].bulk == NULL)
@@ -453,15 +618,47 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
         }
     }
 
+    // Apply the writes recorded by hybrid builds so far while writes can still proceed, leaving
+    // only those made in the meantime for commit().
+    for (auto&& index : _indexes) {
+        if (!index.interceptor)
+            continue;
+        LOG(1) << "\t applying " << index.interceptor->numPending()
+               << " writes recorded during the bulk load of index: "
+               << index.block->getEntry()->descriptor()->indexName();
+        Status status = index.interceptor->drain(_opCtx, _collection, index.options, false);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     return Status::OK();
 }
 
 void MultiIndexBlockImpl::abortWithoutCleanup() {
+    for (auto&& index : _indexes) {
+        if (index.interceptor) {
+            index.block->getEntry()->setIndexBuildInterceptor(nullptr);
+        }
+    }
     _indexes.clear();
     _needToCleanup = false;
 }
 
 void MultiIndexBlockImpl::commit() {
+    // Apply the remaining writes recorded by hybrid builds. No more can be recorded since the
+    // collection is held exclusively. The interceptors keep their writes until this unit of work
+    // commits, so that the commit may be retried after a write conflict.
+    for (auto&& index : _indexes) {
+        if (!index.interceptor)
+            continue;
+        invariant(_opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
+        uassertStatusOK(index.interceptor->drain(_opCtx, _collection, index.options, true));
+
+        IndexCatalogEntry* entry = index.block->getEntry();
+        _opCtx->recoveryUnit()->onCommit([entry] { entry->setIndexBuildInterceptor(nullptr); });
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         _indexes[i].block->success();
     }
@@ -33,6 +33,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -47,7 +48,9 @@ namespace mongo {
 class BackgroundOperation;
 class BSONObj;
 class Collection;
+class IndexBuildInterceptor;
 class OperationContext;
+class ThreadPool;
 
 /**
  * Builds one or more indexes.
@@ -192,7 +195,23 @@ private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
 
+    /**
+     * Generates and sorts the keys of the documents in 'batch' on the threads of 'pool', each
+     * inserting a slice of the batch into its own bulk builder partition, and empties 'batch'.
+     */
+    Status _insertBatchInParallel(ThreadPool* pool,
+                                  std::vector<std::pair<BSONObj, RecordId>>* batch);
+
+    /**
+     * Like insert(), but only for bulk builds, and into bulk builder partition 'partition'.
+     */
+    Status _insertIntoPartition(size_t partition, const BSONObj& doc, const RecordId& loc);
+
     struct IndexToBuild {
+        // Only set for hybrid builds. Declared before 'block' so that it outlives the catalog
+        // entry that 'block' removes when the build fails.
+        std::unique_ptr<IndexBuildInterceptor> interceptor;
+
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
 
         IndexAccessMethod* real = NULL;           // owned elsewhere
@@ -215,6 +234,9 @@ private:
     bool _ignoreUnique;
 
     bool _needToCleanup;
+
+    // Number of partitions of each bulk builder, and so of threads generating keys for them.
+    size_t _numBulkPartitions = 1;
 };
 
 }  // namespace mongo
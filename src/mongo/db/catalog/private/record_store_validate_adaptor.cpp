@@ -164,7 +164,6 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
                                                      BSONObjBuilder* output) {
 
     long long nrecords = 0;
-    long long dataSizeTotal = 0;
     long long nInvalid = 0;
 
     results->valid = true;
@@ -180,7 +179,6 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
         }
 
         auto dataSize = record->data.size();
-        dataSizeTotal += dataSize;
         size_t validatedSize;
         Status status = validate(record->id, record->data, &validatedSize);
 
@@ -204,9 +202,7 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
         prevRecordId = record->id;
     }
 
-    if (results->valid) {
-        recordStore->updateStatsAfterRepair(_opCtx, nrecords, dataSizeTotal);
-    }
+    _numTraversedRecords = nrecords;
 
     output->append("nInvalidDocuments", nInvalid);
     output->appendNumber("nrecords", nrecords);
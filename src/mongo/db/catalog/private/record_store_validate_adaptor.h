@@ -80,12 +80,20 @@ public:
     /**
      * Traverses the record store to retrieve every record and go through its document key
      * set to keep track of the index consistency during a validation.
+     *
+     * Used by background validation, which reads a single snapshot while other operations may
+     * write to the collection. The record store's counts are therefore left alone, and the number
+     * of records seen is available from numTraversedRecords().
      */
     void traverseRecordStore(RecordStore* recordStore,
                              ValidateCmdLevel level,
                              ValidateResults* results,
                              BSONObjBuilder* output);
 
+    long long numTraversedRecords() const {
+        return _numTraversedRecords;
+    }
+
     /**
      * Validate that the number of document keys matches the number of index keys.
      */
@@ -97,5 +105,6 @@ private:
     ValidateCmdLevel _level;
     IndexCatalog* _indexCatalog;             // Not owned.
     ValidateResultsMap* _indexNsResultsMap;  // Not owned.
+    long long _numTraversedRecords = 0;
 };
 }  // namespace
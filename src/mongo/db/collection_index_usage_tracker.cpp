@@ -63,6 +63,24 @@ void CollectionIndexUsageTracker::unregisterIndex(StringData indexName) {
     _indexUsageMap.erase(indexName);
 }
 
+void CollectionIndexUsageTracker::setIndexStatistics(
+    StringData indexName, std::shared_ptr<const IndexStatistics> statistics) {
+    invariant(!indexName.empty());
+    auto it = _indexUsageMap.find(indexName);
+    invariant(it != _indexUsageMap.end());
+
+    it->second.statistics = std::move(statistics);
+}
+
+std::shared_ptr<const IndexStatistics> CollectionIndexUsageTracker::getIndexStatistics(
+    StringData indexName) const {
+    auto it = _indexUsageMap.find(indexName);
+    if (it == _indexUsageMap.end()) {
+        return nullptr;
+    }
+    return it->second.statistics;
+}
+
 CollectionIndexUsageMap CollectionIndexUsageTracker::getUsageStats() const {
     return _indexUsageMap;
 }
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
@@ -38,6 +40,7 @@
 namespace mongo {
 
 class ClockSource;
+class IndexStatistics;
 
 /**
  * CollectionIndexUsageTracker tracks index usage statistics for a collection.  An index is
@@ -58,12 +61,14 @@ public:
         IndexUsageStats(const IndexUsageStats& other)
             : accesses(other.accesses.load()),
               trackerStartTime(other.trackerStartTime),
-              indexKey(other.indexKey) {}
+              indexKey(other.indexKey),
+              statistics(other.statistics) {}
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
+            statistics = other.statistics;
             return *this;
         }
 
@@ -75,6 +80,9 @@ public:
 
         // An owned copy of the associated IndexDescriptor's index key.
         BSONObj indexKey;
+
+        // Data-distribution statistics for the index, or null if none have been built.
+        std::shared_ptr<const IndexStatistics> statistics;
     };
 
     /**
@@ -104,6 +112,19 @@ public:
      */
     void unregisterIndex(StringData indexName);
 
+    /**
+     * Replace the data-distribution statistics of index 'indexName', which must be registered.
+     * Must be called under exclusive collection lock.
+     */
+    void setIndexStatistics(StringData indexName,
+                            std::shared_ptr<const IndexStatistics> statistics);
+
+    /**
+     * Returns the data-distribution statistics of index 'indexName', or null if there are none.
+     * Must be called while holding the collection lock in any mode.
+     */
+    std::shared_ptr<const IndexStatistics> getIndexStatistics(StringData indexName) const;
+
     /**
      * Get the current state of the usage statistics map. This map will only include indexes that
      * exist at the time of calling. Must be called while holding the collection lock in any mode.
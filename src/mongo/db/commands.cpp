@@ -84,6 +84,20 @@ const WriteConcernOptions kMajorityWriteConcern(
 
 Command::~Command() = default;
 
+std::size_t Command::replyBufferSizeHint() const {
+    return std::max(reserveBytesForReply(),
+                    static_cast<std::size_t>(_averageReplySize.loadRelaxed()));
+}
+
+void Command::recordReplySize(std::size_t bytes) {
+    // Weight each new sample by 1/8 so that one unusually large reply does not oversize the buffers
+    // of the replies that follow it. Concurrent updates may drop a sample, which is harmless for a
+    // hint.
+    const long long sample = std::min(bytes, static_cast<std::size_t>(BSONObjMaxUserSize));
+    const long long average = _averageReplySize.loadRelaxed();
+    _averageReplySize.store(average + (sample - average) / 8);
+}
+
 BSONObj Command::appendPassthroughFields(const BSONObj& cmdObjWithPassthroughFields,
                                          const BSONObj& request) {
     BSONObjBuilder b;
@@ -42,6 +42,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/write_concern.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/net/op_msg.h"
@@ -180,9 +181,9 @@ public:
 
     /**
      * Return true if a replica set secondary should go into "recovering"
-     * (unreadable) state while running this command.
+     * (unreadable) state while running this command with the arguments 'cmdObj'.
      */
-    virtual bool maintenanceMode() const = 0;
+    virtual bool maintenanceMode(const BSONObj& cmdObj) const = 0;
 
     /**
      * Return true if command should be permitted when a replica set secondary is in "recovering"
@@ -315,7 +316,7 @@ public:
 
     BSONObj getRedactedCopyForLogging(const BSONObj& cmdObj) override;
 
-    bool maintenanceMode() const override {
+    bool maintenanceMode(const BSONObj& cmdObj) const override {
         return false;
     }
 
@@ -348,6 +349,18 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Returns how many bytes to reserve for this command's reply: the larger of
+     * reserveBytesForReply() and a running average of the command's recent reply sizes, so that
+     * commands with large replies do not regrow their reply buffer on every invocation.
+     */
+    std::size_t replyBufferSizeHint() const;
+
+    /**
+     * Folds the size of a completed reply into the running average used by replyBufferSizeHint().
+     */
+    void recordReplySize(std::size_t bytes);
+
     /**
      * Runs the command.
      *
@@ -542,6 +555,9 @@ private:
     Counter64 _commandsExecuted;
     Counter64 _commandsFailed;
 
+    // Exponentially weighted average of this command's reply sizes, in bytes.
+    AtomicInt64 _averageReplySize{0};
+
     // The full name of the command
     const std::string _name;
 
@@ -30,6 +30,7 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -46,13 +47,26 @@
 #include "mongo/db/index_builder.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
 using std::string;
 using std::stringstream;
 
+namespace {
+
+// How long each round of an online compaction may run before it releases its locks.
+MONGO_EXPORT_SERVER_PARAMETER(compactOnlineRoundSecs, int, 1);
+
+// How long an online compaction sleeps between rounds, which bounds the share of the disk's
+// bandwidth it takes from other operations.
+MONGO_EXPORT_SERVER_PARAMETER(compactOnlineThrottleMS, int, 100);
+
+}  // namespace
+
 class CompactCmd : public ErrmsgCommandDeprecated {
 public:
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -64,8 +78,9 @@ public:
     virtual bool slaveOk() const {
         return true;
     }
-    virtual bool maintenanceMode() const {
-        return true;
+    virtual bool maintenanceMode(const BSONObj& cmdObj) const {
+        // An online compaction leaves the collection available, so a secondary keeps serving reads.
+        return !cmdObj["online"].trueValue();
     }
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
@@ -79,8 +94,10 @@ public:
                 "warning: this operation locks the database and is slow. you can cancel with "
                 "killOp()\n"
                 "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
-                "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
+                "  [paddingFactor:<num>], [paddingBytes:<num>], [online:<bool>] }\n"
                 "  force - allows to run on a replica set primary\n"
+                "  online - compact in rounds between which other operations proceed, without\n"
+                "  locking the database. only for storage engines that compact in place\n"
                 "  validate - check records are noncorrupt before adding to newly compacting "
                 "extents. slower but safer (defaults to true in this version)\n";
     }
@@ -93,8 +110,10 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = parseNsCollectionRequired(db, cmdObj);
 
+        const bool online = cmdObj["online"].trueValue();
+
         repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue() && !online) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -143,6 +162,11 @@ public:
         if (cmdObj.hasElement("validate"))
             compactOptions.validateDocuments = cmdObj["validate"].trueValue();
 
+        if (online) {
+            return appendCommandStatus(result,
+                                       _compactOnline(opCtx, nss, &compactOptions, &result));
+        }
+
         AutoGetDb autoDb(opCtx, db, MODE_X);
         Database* const collDB = autoDb.getDb();
 
@@ -176,6 +200,69 @@ public:
 
         return true;
     }
+
+private:
+    /**
+     * Compacts 'nss' in rounds, each under intent locks, sleeping between them for
+     * compactOnlineThrottleMS. Reports the number of rounds and the collection's storage size
+     * before and after.
+     */
+    Status _compactOnline(OperationContext* opCtx,
+                          const NamespaceString& nss,
+                          CompactOptions* compactOptions,
+                          BSONObjBuilder* result) {
+        compactOptions->online = true;
+        compactOptions->onlineRoundSecs = std::max(1, compactOnlineRoundSecs.load());
+
+        log() << "compact " << nss.ns() << " begin, options: " << *compactOptions;
+
+        long long rounds = 0;
+        int64_t storageSizeBefore = 0;
+        int64_t storageSizeAfter = 0;
+        while (true) {
+            opCtx->checkForInterrupt();
+            ++rounds;
+
+            {
+                AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+                Collection* const collection = autoColl.getCollection();
+                if (!collection) {
+                    return {ErrorCodes::NamespaceNotFound, "collection does not exist"};
+                }
+                BackgroundOperation::assertNoBgOpInProgForNs(nss.ns());
+
+                RecordStore* const recordStore = collection->getRecordStore();
+                if (rounds == 1) {
+                    storageSizeBefore = recordStore->storageSize(opCtx);
+                }
+
+                StatusWith<CompactStats> status = collection->compact(opCtx, compactOptions);
+                if (status.isOK()) {
+                    storageSizeAfter = recordStore->storageSize(opCtx);
+                    break;
+                }
+                if (status.getStatus() != ErrorCodes::ExceededTimeLimit) {
+                    return status.getStatus();
+                }
+            }
+
+            {
+                const std::string message = str::stream() << "online compaction of " << nss.ns()
+                                                          << ", round " << rounds;
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                CurOp::get(opCtx)->setMessage_inlock(message.c_str());
+            }
+            opCtx->sleepFor(Milliseconds(std::max(0, compactOnlineThrottleMS.load())));
+        }
+
+        log() << "compact " << nss.ns() << " end after " << rounds << " rounds, storage size "
+              << storageSizeBefore << " -> " << storageSizeAfter;
+
+        result->append("rounds", rounds);
+        result->append("storageSizeBefore", static_cast<long long>(storageSizeBefore));
+        result->append("storageSizeAfter", static_cast<long long>(storageSizeAfter));
+        return Status::OK();
+    }
 };
 static CompactCmd compactCmd;
 }
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultDurationMillis = 10 * 1000;
+const long long kMaxDurationMillis = 10 * 60 * 1000;
+const long long kDefaultSamplesPerSecond = 100;
+const long long kDefaultMaxSamples = 100 * 1000;
+const long long kMaxMaxSamples = 1000 * 1000;
+
+// Leave room in the reply for the fields other than the stacks.
+const int kMaxStacksBytes = BSONObjMaxUserSize - 64 * 1024;
+
+/**
+ * Samples the stacks of the threads consuming CPU for a window of time and returns them in the
+ * "collapsed" format understood by flame graph tools: one string per distinct stack, holding the
+ * operation tag of the sampled thread (command name and namespace, if any) followed by the frames
+ * from the outermost caller inwards, separated by semicolons, then a space and the sample count.
+ *
+ * Format
+ * {
+ *     cpuSamplingProfile: 1,
+ *     durationMillis: <int>,     // length of the window, 10 seconds by default
+ *     samplesPerSecond: <int>,   // per second of process CPU time, 100 by default
+ *     maxSamples: <int>          // samples past this many are dropped, 100000 by default
+ * }
+ *
+ * Only one profiling window can be open at a time. Each sample costs roughly 600 bytes of memory
+ * for the duration of the command.
+ */
+class CpuSamplingProfileCommand final : public BasicCommand {
+public:
+    CpuSamplingProfileCommand() : BasicCommand("cpuSamplingProfile") {}
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "samples CPU stacks for a window of time and returns them in collapsed form";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long durationMillis;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefaultIf(
+            cmdObj,
+            "durationMillis",
+            kDefaultDurationMillis,
+            [](long long value) { return value > 0 && value <= kMaxDurationMillis; },
+            "durationMillis must be positive and at most 10 minutes",
+            &durationMillis));
+
+        long long samplesPerSecond;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "samplesPerSecond", kDefaultSamplesPerSecond, &samplesPerSecond));
+
+        long long maxSamples;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefaultIf(
+            cmdObj,
+            "maxSamples",
+            kDefaultMaxSamples,
+            [](long long value) { return value > 0 && value <= kMaxMaxSamples; },
+            "maxSamples must be between 1 and 1000000",
+            &maxSamples));
+
+        // The profiler itself validates the sampling rate.
+        uassertStatusOK(SamplingProfiler::start(
+            std::min<long long>(samplesPerSecond, std::numeric_limits<int>::max()), maxSamples));
+        log() << "Started CPU sampling profiler for " << durationMillis << "ms at "
+              << samplesPerSecond << " samples per second";
+
+        auto stopOnError = MakeGuard([] { SamplingProfiler::stop().getStatus().ignore(); });
+        opCtx->sleepFor(Milliseconds(durationMillis));
+        stopOnError.Dismiss();
+
+        auto profile = uassertStatusOK(SamplingProfiler::stop());
+
+        std::vector<std::pair<long long, const std::string*>> stacks;
+        stacks.reserve(profile.collapsedStacks.size());
+        for (const auto& stack : profile.collapsedStacks) {
+            stacks.emplace_back(stack.second, &stack.first);
+        }
+        std::sort(stacks.begin(), stacks.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+
+        result.append("durationMillis", durationMillis);
+        result.append("samplesPerSecond", samplesPerSecond);
+        result.append("numSamples", profile.numSamples);
+        result.append("numDroppedSamples", profile.numDroppedSamples);
+
+        bool truncated = false;
+        BSONArrayBuilder collapsed(result.subarrayStart("collapsedStacks"));
+        for (const auto& stack : stacks) {
+            if (collapsed.len() + static_cast<int>(stack.second->size()) + 32 > kMaxStacksBytes) {
+                truncated = true;
+                break;
+            }
+            collapsed.append(str::stream() << *stack.second << ' ' << stack.first);
+        }
+        collapsed.doneFast();
+        result.append("truncated", truncated);
+        return true;
+    }
+} cpuSamplingProfileCommand;
+
+}  // namespace
+}  // namespace mongo
@@ -212,7 +212,7 @@ public:
     virtual bool slaveOk() const {
         return true;
     }
-    virtual bool maintenanceMode() const {
+    virtual bool maintenanceMode(const BSONObj& cmdObj) const {
         return true;
     }
     virtual void help(stringstream& help) const {
@@ -44,6 +44,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
@@ -54,6 +55,11 @@ namespace mongo {
 
 namespace {
 
+// Whether the hash of each collection is kept until the collection is next written to, so that
+// dbHash only rehashes the collections changed since it last ran. Capped collections, whose
+// documents can be deleted without going through the Collection, are always rehashed.
+MONGO_EXPORT_SERVER_PARAMETER(enableDbHashCache, bool, false);
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -124,6 +130,7 @@ public:
                                                                "system.views"};
 
 
+        long long numCachedCollections = 0;
         BSONObjBuilder bb(result.subobjStart("collections"));
         for (const auto& collectionName : colls) {
 
@@ -149,7 +156,8 @@ public:
                 continue;
 
             // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            std::string hash =
+                _hashCollection(opCtx, db, collNss.toString(), &numCachedCollections);
 
             bb.append(collNss.coll(), hash);
             md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
@@ -161,6 +169,9 @@ public:
         std::string hash = digestToString(d);
 
         result.append("md5", hash);
+        if (enableDbHashCache.load()) {
+            result.appendNumber("numCachedCollections", numCachedCollections);
+        }
         result.appendNumber("timeMillis", timer.millis());
 
         return 1;
@@ -169,7 +180,8 @@ public:
 private:
     std::string _hashCollection(OperationContext* opCtx,
                                 Database* db,
-                                const std::string& fullCollectionName) {
+                                const std::string& fullCollectionName,
+                                long long* numCachedCollections) {
 
         NamespaceString ns(fullCollectionName);
 
@@ -177,6 +189,14 @@ private:
         if (!collection)
             return "";
 
+        const bool useCache = enableDbHashCache.load() && !collection->isCapped();
+        if (useCache) {
+            if (auto cachedHash = collection->getCachedDataHash()) {
+                ++*numCachedCollections;
+                return *cachedHash;
+            }
+        }
+
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
@@ -219,6 +239,9 @@ private:
         md5_finish(&st, d);
         std::string hash = digestToString(d);
 
+        if (useCache) {
+            collection->setCachedDataHash(hash);
+        }
         return hash;
     }
 
@@ -441,7 +441,7 @@ public:
                 // Fill out OpDebug with the number of deleted docs.
                 opDebug->ndeleted = getDeleteStats(exec.get())->docsDeleted;
 
-                if (curOp->shouldDBProfile()) {
+                if (curOp->shouldCaptureExecStats()) {
                     BSONObjBuilder execStatsBob;
                     Explain::getWinningPlanStats(exec.get(), &execStatsBob);
                     curOp->debug().execStats = execStatsBob.obj();
@@ -555,7 +555,7 @@ public:
                 UpdateStage::recordUpdateStatsInOpDebug(getUpdateStats(exec.get()), opDebug);
                 opDebug->setPlanSummaryMetrics(summaryStats);
 
-                if (curOp->shouldDBProfile()) {
+                if (curOp->shouldCaptureExecStats()) {
                     BSONObjBuilder execStatsBob;
                     Explain::getWinningPlanStats(exec.get(), &execStatsBob);
                     curOp->debug().execStats = execStatsBob.obj();
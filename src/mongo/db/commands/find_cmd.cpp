@@ -332,6 +332,13 @@ public:
 
         const QueryRequest& originalQR = exec->getCanonicalQuery()->getQueryRequest();
 
+        // Make room for the whole batch before streaming into it, so that documents are copied
+        // into the reply straight from the storage engine rather than again on each regrowth.
+        const int batchBytesHint =
+            FindCommon::estimateFirstBatchBytes(originalQR, collection->averageObjectSize(opCtx));
+        result.bb().reserveBytes(batchBytesHint);
+        result.bb().claimReservedBytes(batchBytesHint);
+
         // Stream query results, adding them to a BSONArray as we go.
         CursorResponseBuilder firstBatch(/*isInitialResponse*/ true, &result);
         BSONObj obj;
@@ -317,7 +317,7 @@ public:
 
         curOp->debug().setPlanSummaryMetrics(summary);
 
-        if (curOp->shouldDBProfile()) {
+        if (curOp->shouldCaptureExecStats()) {
             BSONObjBuilder execStatsBob;
             Explain::getWinningPlanStats(exec.get(), &execStatsBob);
             curOp->debug().execStats = execStatsBob.obj();
@@ -356,7 +356,8 @@ public:
         // the original request and subsequent getMore. It would be useful to have this information
         // for an aggregation, but the source PlanExecutor could be destroyed before we know whether
         // we need execStats and we do not want to generate for all operations due to cost.
-        if (!CursorManager::isGloballyManagedCursor(request.cursorid) && curOp->shouldDBProfile()) {
+        if (!CursorManager::isGloballyManagedCursor(request.cursorid) &&
+            curOp->shouldCaptureExecStats()) {
             BSONObjBuilder execStatsBob;
             Explain::getWinningPlanStats(exec, &execStatsBob);
             curOp->debug().execStats = execStatsBob.obj();
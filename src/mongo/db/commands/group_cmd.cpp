@@ -204,7 +204,7 @@ private:
         }
         curOp->debug().setPlanSummaryMetrics(summaryStats);
 
-        if (curOp->shouldDBProfile()) {
+        if (curOp->shouldCaptureExecStats()) {
             BSONObjBuilder execStatsBob;
             Explain::getWinningPlanStats(planExecutor.get(), &execStatsBob);
             curOp->debug().execStats = execStatsBob.obj();
@@ -0,0 +1,237 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/commands/plan_cache_commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/explain.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/index_advisor.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_stats_store.h"
+#include "mongo/db/stats/slow_op_recorder.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Where the workload of a query shape was taken from, in order of preference.
+ */
+enum class WorkloadSource { kQueryStats, kSlowOps, kPlanCache };
+
+/**
+ * The recorded cost of one query shape: how often it ran, and the keys and documents those runs
+ * examined and returned in total.
+ */
+struct ShapeWorkload {
+    BSONObj shape;
+    WorkloadSource source;
+    long long count = 0;
+    long long examined = 0;
+    long long nReturned = 0;
+};
+
+/**
+ * indexAdvisor
+ *
+ * { indexAdvisor: <collection> }
+ *
+ * Proposes indexes for the query shapes of the collection which examine many more keys and
+ * documents than they return, and lists the collection's indexes which no query has used since
+ * they were loaded. Each of those still costs a write on every insert and delete.
+ *
+ * The workload is taken from the collection's query statistics, then from the slow operations
+ * recorded for it and finally from its plan cache, each source only contributing shapes the
+ * previous ones did not have.
+ */
+class IndexAdvisorCommand : public PlanCacheCommand {
+public:
+    IndexAdvisorCommand()
+        : PlanCacheCommand("indexAdvisor",
+                           "Proposes indexes for the collection's costliest query shapes and "
+                           "lists its unused indexes.",
+                           ActionType::planCacheRead) {}
+
+    Status runPlanCacheCommand(OperationContext* opCtx,
+                               const std::string& ns,
+                               const BSONObj& cmdObj,
+                               BSONObjBuilder* bob) override {
+        AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return Status(ErrorCodes::NamespaceNotFound, "no such collection");
+        }
+
+        // Shapes are identified by their plan cache key, so that each is considered once. The
+        // first source to report a shape is the only one counted for it, since the query
+        // statistics already include the slow runs, for example.
+        std::map<PlanCacheKey, ShapeWorkload> workloads;
+        auto addWorkload = [&](WorkloadSource source,
+                               const BSONObj& shape,
+                               long long count,
+                               long long examined,
+                               long long nReturned) {
+            auto statusWithCQ = canonicalize(opCtx, ns, shape);
+            if (!statusWithCQ.isOK()) {
+                return;
+            }
+            const PlanCacheKey key =
+                collection->infoCache()->getPlanCache()->computeKey(*statusWithCQ.getValue());
+            auto it = workloads.find(key);
+            if (it == workloads.end()) {
+                it = workloads.emplace(key, ShapeWorkload()).first;
+                it->second.shape = shape.getOwned();
+                it->second.source = source;
+            } else if (it->second.source != source) {
+                return;
+            }
+            it->second.count += count;
+            it->second.examined += examined;
+            it->second.nReturned += nReturned;
+        };
+
+        for (auto&& stats : collection->infoCache()->getQueryStats()->getStats()) {
+            addWorkload(WorkloadSource::kQueryStats,
+                        stats["shape"].Obj(),
+                        stats["count"].numberLong(),
+                        stats["keysExamined"].numberLong() + stats["docsExamined"].numberLong(),
+                        stats["nReturned"].numberLong());
+        }
+
+        for (auto&& entry : SlowOpRecorder::get(opCtx->getServiceContext()).getEntries()) {
+            const BSONElement commandElt = entry["command"];
+            if (entry["ns"].str() != ns || commandElt.type() != Object ||
+                commandElt.Obj()["find"].eoo()) {
+                continue;
+            }
+            const BSONObj findCmd = commandElt.Obj();
+            BSONObjBuilder shape;
+            shape.append("query",
+                         findCmd["filter"].isABSONObj() ? findCmd["filter"].Obj() : BSONObj());
+            for (auto field : {"sort", "projection", "collation"}) {
+                if (findCmd[field].isABSONObj()) {
+                    shape.append(field, findCmd[field].Obj());
+                }
+            }
+            addWorkload(WorkloadSource::kSlowOps,
+                        shape.obj(),
+                        1,
+                        entry["keysExamined"].numberLong() + entry["docsExamined"].numberLong(),
+                        entry["nreturned"].numberLong());
+        }
+
+        // The plan cache only has the trial period of each shape's winning plan to go on.
+        std::vector<PlanCacheEntry*> entries =
+            collection->infoCache()->getPlanCache()->getAllEntries();
+        for (auto* entryRaw : entries) {
+            std::unique_ptr<PlanCacheEntry> entry(entryRaw);
+            if (!entry->decision || entry->decision->stats.empty()) {
+                continue;
+            }
+            const PlanStageStats& winnerStats = *entry->decision->stats[0];
+            BSONObjBuilder shape;
+            shape.append("query", entry->query);
+            shape.append("sort", entry->sort);
+            shape.append("projection", entry->projection);
+            if (!entry->collation.isEmpty()) {
+                shape.append("collation", entry->collation);
+            }
+            addWorkload(WorkloadSource::kPlanCache,
+                        shape.obj(),
+                        std::max(1LL, entry->stats.numPlanned + entry->stats.numCacheHits),
+                        Explain::getTotalKeysExamined(winnerStats) +
+                            Explain::getTotalDocsExamined(winnerStats),
+                        winnerStats.common.advanced);
+        }
+
+        IndexAdvisor advisor;
+        for (auto&& workload : workloads) {
+            auto statusWithCQ = canonicalize(opCtx, ns, workload.second.shape);
+            if (!statusWithCQ.isOK()) {
+                continue;
+            }
+            QueryPlannerParams params;
+            fillOutPlannerParams(opCtx, collection, statusWithCQ.getValue().get(), &params);
+            advisor.addQueryShape(*statusWithCQ.getValue(),
+                                  params,
+                                  workload.second.count,
+                                  workload.second.examined,
+                                  workload.second.nReturned);
+        }
+
+        BSONArrayBuilder candidatesBuilder(bob->subarrayStart("candidates"));
+        for (auto&& candidate : advisor.getCandidates()) {
+            candidatesBuilder.append(candidate.toBSON());
+        }
+        candidatesBuilder.doneFast();
+
+        std::vector<std::string> unusedIndexNames;
+        const CollectionIndexUsageMap usageStats = collection->infoCache()->getIndexUsageStats();
+        for (auto&& indexStats : usageStats) {
+            if (indexStats.first != "_id_" && indexStats.second.accesses.load() == 0) {
+                unusedIndexNames.push_back(indexStats.first);
+            }
+        }
+        std::sort(unusedIndexNames.begin(), unusedIndexNames.end());
+
+        BSONArrayBuilder unusedBuilder(bob->subarrayStart("unusedIndexes"));
+        for (auto&& name : unusedIndexNames) {
+            const auto& indexStats = usageStats.find(name)->second;
+            BSONObjBuilder indexBuilder(unusedBuilder.subobjStart());
+            indexBuilder.append("name", name);
+            indexBuilder.append("key", indexStats.indexKey);
+            indexBuilder.append("since", indexStats.trackerStartTime);
+        }
+        unusedBuilder.doneFast();
+
+        bob->append("numShapesConsidered", static_cast<long long>(workloads.size()));
+        return Status::OK();
+    }
+};
+
+MONGO_INITIALIZER_WITH_PREREQUISITES(SetupIndexAdvisorCommand, MONGO_NO_PREREQUISITES)
+(InitializerContext* context) {
+    // The command's constructor refers to a static ActionType instance, which a mongo static
+    // initializer is guaranteed to run after.
+    new IndexAdvisorCommand();
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <pcrecpp.h>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
@@ -63,6 +65,7 @@
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog_cache.h"
@@ -93,6 +96,8 @@ namespace dps = ::mongo::dotted_path_support;
 
 namespace mr {
 
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceTranslateFunctions, bool, true);
+
 AtomicUInt32 Config::JOB_NUMBER;
 
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
@@ -270,6 +275,163 @@ void JSReducer::_reduce(const BSONList& tuples, BSONObj& key, int& endSizeEstima
     _reduce(x, key, endSizeEstimate);
 }
 
+namespace {
+
+// Matches map functions which emit a top-level field of the document, with either 1 or another
+// top-level field as the value.
+const pcrecpp::RE kFieldMapRegex(
+    "^\\s*function\\s*\\(\\s*\\)\\s*\\{\\s*"
+    "emit\\s*\\(\\s*this\\.([A-Za-z_$][\\w$]*)\\s*,\\s*"
+    "(?:1|this\\.([A-Za-z_$][\\w$]*))\\s*\\)\\s*;?\\s*\\}\\s*;?\\s*$");
+
+// Matches reduce functions which return Array.sum() of their values.
+const pcrecpp::RE kSumReduceRegex(
+    "^\\s*function\\s*\\(\\s*[A-Za-z_$][\\w$]*\\s*,\\s*([A-Za-z_$][\\w$]*)\\s*\\)"
+    "\\s*\\{\\s*return\\s+Array\\.sum\\s*\\(\\s*\\1\\s*\\)\\s*;?\\s*\\}\\s*;?\\s*$");
+
+/**
+ * Returns the code of 'e' if it is JavaScript which can be translated, meaning it does not carry
+ * its own scope.
+ */
+boost::optional<std::string> translatableCode(const BSONElement& e) {
+    if (e.type() != Code && e.type() != String) {
+        return boost::none;
+    }
+    return e._asCode();
+}
+
+/**
+ * Appends 'e' as 'fieldName' the way it reads back from JavaScript after being passed to it
+ * through 'this'. Returns false, appending nothing, if the conversion is not a simple one.
+ */
+bool appendAsFromJS(BSONObjBuilder* b, StringData fieldName, const BSONElement& e) {
+    switch (e.type()) {
+        case NumberInt:
+            // JavaScript numbers are doubles.
+            b->append(fieldName, static_cast<double>(e._numberInt()));
+            return true;
+        case NumberDouble:
+        case NumberLong:
+        case String:
+        case Bool:
+        case jstNULL:
+        case Date:
+        case jstOID:
+            b->appendAs(e, fieldName);
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<NativeFieldMapper> NativeFieldMapper::parse(const BSONElement& code) {
+    auto source = translatableCode(code);
+    std::string keyField;
+    std::string valueField;
+    if (!source || !kFieldMapRegex.FullMatch(*source, &keyField, &valueField)) {
+        return nullptr;
+    }
+    return std::unique_ptr<NativeFieldMapper>(
+        new NativeFieldMapper(code, std::move(keyField), std::move(valueField)));
+}
+
+void NativeFieldMapper::init(State* state) {
+    _jsMapper.init(state);
+    _state = state;
+}
+
+bool NativeFieldMapper::buildTuple(const BSONObj& o, BSONObjBuilder* tuple) const {
+    // Missing fields are left to JavaScript, where the name might resolve to a property of
+    // Object.prototype.
+    if (!appendAsFromJS(tuple, "0", o[_keyField])) {
+        return false;
+    }
+    if (_valueField.empty()) {
+        tuple->append("1", 1.0);
+        return true;
+    }
+    return appendAsFromJS(tuple, "1", o[_valueField]);
+}
+
+void NativeFieldMapper::map(const BSONObj& o) {
+    // In JS mode the emitted tuples are kept by the JavaScript scope.
+    if (_state->jsMode()) {
+        return _jsMapper.map(o);
+    }
+
+    BSONObjBuilder tuple;
+    if (!buildTuple(o, &tuple)) {
+        return _jsMapper.map(o);
+    }
+    BSONObj args = tuple.obj();
+    uassert(13069,
+            "an emit can't be more than half max bson size",
+            args.objsize() < (BSONObjMaxUserSize / 2));
+    _state->emit(args);
+}
+
+std::unique_ptr<NativeSumReducer> NativeSumReducer::parse(const BSONElement& code) {
+    auto source = translatableCode(code);
+    if (!source || !kSumReduceRegex.FullMatch(*source)) {
+        return nullptr;
+    }
+    return std::unique_ptr<NativeSumReducer>(new NativeSumReducer(code));
+}
+
+void NativeSumReducer::init(State* state) {
+    _jsReducer.init(state);
+}
+
+bool NativeSumReducer::_sum(const BSONList& tuples,
+                            StringData fieldName,
+                            BSONObjBuilder* b) const {
+    // Array.sum() adds the values from left to right with JavaScript's '+', which converts them
+    // all to doubles.
+    double sum = 0;
+    for (size_t i = 0; i < tuples.size(); ++i) {
+        BSONObjIterator it(tuples[i]);
+        it.next();
+        BSONElement value = it.next();
+        if (value.type() != NumberInt && value.type() != NumberLong &&
+            value.type() != NumberDouble) {
+            return false;
+        }
+        sum = i == 0 ? value.numberDouble() : sum + value.numberDouble();
+    }
+    b->append(fieldName, sum);
+    return true;
+}
+
+BSONObj NativeSumReducer::reduce(const BSONList& tuples) {
+    if (tuples.size() <= 1)
+        return tuples[0];
+
+    ++numReduces;
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "0");
+    if (!_sum(tuples, "1", &b)) {
+        return _jsReducer.reduce(tuples);
+    }
+    return b.obj();
+}
+
+BSONObj NativeSumReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
+    if (tuples.size() <= 1) {
+        return _jsReducer.finalReduce(tuples, finalizer);
+    }
+
+    ++numReduces;
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "_id");
+    if (!_sum(tuples, "value", &b)) {
+        return _jsReducer.finalReduce(tuples, finalizer);
+    }
+    BSONObj res = b.obj();
+    return finalizer ? finalizer->finalize(res) : res;
+}
+
 Config::Config(const string& _dbname, const BSONObj& cmdObj) {
     dbname = _dbname;
     uassert(ErrorCodes::TypeMismatch,
@@ -318,8 +480,16 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck().getOwned();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
-        reducer.reset(new JSReducer(cmdObj["reduce"]));
+        // Functions of a few common forms run natively, unless the scope could change what the
+        // names they use refer to.
+        if (internalMapReduceTranslateFunctions.load() && scopeSetup.isEmpty()) {
+            mapper = NativeFieldMapper::parse(cmdObj["map"]);
+            reducer = NativeSumReducer::parse(cmdObj["reduce"]);
+        }
+        if (!mapper)
+            mapper.reset(new JSMapper(cmdObj["map"]));
+        if (!reducer)
+            reducer.reset(new JSReducer(cmdObj["reduce"]));
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
 
@@ -1531,7 +1701,7 @@ public:
                     // check to see if this is a new object we don't own yet
                     // because of a chunk migration
                     if (collMetadata) {
-                        ShardKeyPattern kp(collMetadata->getKeyPattern());
+                        const auto& kp = collMetadata->getChunkManager()->getShardKeyPattern();
                         if (!collMetadata->keyBelongsToMe(kp.extractShardKeyFromDoc(o))) {
                             continue;
                         }
@@ -1599,7 +1769,7 @@ public:
                 invariant(coll);  // 'exec' hasn't been killed, so collection must be alive.
                 coll->infoCache()->notifyOfQuery(opCtx, stats.indexesUsed);
 
-                if (curOp->shouldDBProfile()) {
+                if (curOp->shouldCaptureExecStats()) {
                     BSONObjBuilder execStatsBob;
                     Explain::getWinningPlanStats(exec.get(), &execStatsBob);
                     curOp->debug().execStats = execStatsBob.obj();
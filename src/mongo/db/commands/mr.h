@@ -175,6 +175,72 @@ private:
     JSFunction _func;
 };
 
+// ------------  native function implementations -----------
+
+/**
+ * Runs map functions of the form "function() { emit(this.k, 1); }" or
+ * "function() { emit(this.k, this.v); }" without calling into JavaScript. Emits the same tuples
+ * the JavaScript function would, and invokes it for documents whose fields it can't convert
+ * exactly as JavaScript does, and whenever the job is in JS mode.
+ */
+class NativeFieldMapper : public Mapper {
+public:
+    /**
+     * Returns a mapper for 'code' if it is a map function of a recognized form, and nullptr
+     * otherwise.
+     */
+    static std::unique_ptr<NativeFieldMapper> parse(const BSONElement& code);
+
+    virtual void map(const BSONObj& o);
+    virtual void init(State* state);
+
+    /**
+     * Builds into 'tuple' the tuple the map function emits for 'o'. Returns false if it can't be
+     * built without JavaScript.
+     */
+    bool buildTuple(const BSONObj& o, BSONObjBuilder* tuple) const;
+
+private:
+    NativeFieldMapper(const BSONElement& code, std::string keyField, std::string valueField)
+        : _keyField(std::move(keyField)), _valueField(std::move(valueField)), _jsMapper(code) {}
+
+    std::string _keyField;
+    std::string _valueField;  // Empty if the function emits the constant 1.
+    State* _state = nullptr;
+    JSMapper _jsMapper;
+};
+
+/**
+ * Runs reduce functions of the form "function(key, values) { return Array.sum(values); }"
+ * without calling into JavaScript when all of the values are numbers other than decimals, adding
+ * them as doubles in the order JavaScript would. Other values are reduced by the JavaScript
+ * function, which is also the one used in JS mode.
+ */
+class NativeSumReducer : public Reducer {
+public:
+    /**
+     * Returns a reducer for 'code' if it is a reduce function of a recognized form, and nullptr
+     * otherwise.
+     */
+    static std::unique_ptr<NativeSumReducer> parse(const BSONElement& code);
+
+    virtual void init(State* state);
+
+    virtual BSONObj reduce(const BSONList& tuples);
+    virtual BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer);
+
+private:
+    explicit NativeSumReducer(const BSONElement& code) : _jsReducer(code) {}
+
+    /**
+     * Appends the sum of the values in 'tuples' to 'b' as 'fieldName', and returns true. Returns
+     * false without appending anything if a value is not a summable number.
+     */
+    bool _sum(const BSONList& tuples, StringData fieldName, BSONObjBuilder* b) const;
+
+    JSReducer _jsReducer;
+};
+
 // -----------------
 
 
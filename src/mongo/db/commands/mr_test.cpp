@@ -255,4 +255,100 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), AssertionException);
 }
 
+/**
+ * Tests for translating map and reduce functions into native ones.
+ */
+
+BSONObj mapReduceCmd(const std::string& map, const std::string& reduce) {
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "myCollection");
+    bob.appendCode("map", map);
+    bob.appendCode("reduce", reduce);
+    bob.append("out", "outCollection");
+    return bob.obj();
+}
+
+TEST(ConfigTest, TranslatesRecognizedFunctions) {
+    mr::Config config("myDB",
+                      mapReduceCmd("function() {\n  emit(this.k, this.v);\n}",
+                                   "function(key, values) { return Array.sum(values); }"));
+    ASSERT(dynamic_cast<mr::NativeFieldMapper*>(config.mapper.get()));
+    ASSERT(dynamic_cast<mr::NativeSumReducer*>(config.reducer.get()));
+}
+
+TEST(ConfigTest, DoesNotTranslateOtherFunctions) {
+    mr::Config config("myDB",
+                      mapReduceCmd("function() { emit(this.k.x, 1); }",
+                                   "function(key, values) { return Array.sum(key); }"));
+    ASSERT(dynamic_cast<mr::JSMapper*>(config.mapper.get()));
+    ASSERT(dynamic_cast<mr::JSReducer*>(config.reducer.get()));
+}
+
+TEST(ConfigTest, DoesNotTranslateFunctionsWithScope) {
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "myCollection");
+    bob.appendCode("map", "function() { emit(this.k, 1); }");
+    bob.appendCode("reduce", "function(k, v) { return Array.sum(v); }");
+    bob.append("out", "outCollection");
+    bob.append("scope", BSON("Array" << 1));
+    mr::Config config("myDB", bob.obj());
+    ASSERT(dynamic_cast<mr::JSMapper*>(config.mapper.get()));
+    ASSERT(dynamic_cast<mr::JSReducer*>(config.reducer.get()));
+}
+
+BSONObj buildTuple(const mr::NativeFieldMapper& mapper, const BSONObj& doc) {
+    BSONObjBuilder tuple;
+    if (!mapper.buildTuple(doc, &tuple)) {
+        return BSONObj();
+    }
+    return tuple.obj();
+}
+
+TEST(NativeFieldMapperTest, EmitsConstantOne) {
+    BSONObj code = BSON("map" << BSONCode("function() { emit(this.k, 1); }"));
+    auto mapper = mr::NativeFieldMapper::parse(code.firstElement());
+    ASSERT(mapper);
+    ASSERT_BSONOBJ_EQ(buildTuple(*mapper, BSON("k" << "a")), BSON("0" << "a" << "1" << 1.0));
+}
+
+TEST(NativeFieldMapperTest, ConvertsValuesAsJavaScriptWould) {
+    BSONObj code = BSON("map" << BSONCode("function(){emit(this.k,this.v)}"));
+    auto mapper = mr::NativeFieldMapper::parse(code.firstElement());
+    ASSERT(mapper);
+
+    BSONObj tuple = buildTuple(*mapper, BSON("k" << 3 << "v" << 4LL));
+    ASSERT_BSONOBJ_EQ(tuple, BSON("0" << 3.0 << "1" << 4LL));
+    ASSERT_EQ(tuple["0"].type(), NumberDouble);
+    ASSERT_EQ(tuple["1"].type(), NumberLong);
+
+    // Missing fields and values of other types are left to JavaScript.
+    ASSERT_BSONOBJ_EQ(buildTuple(*mapper, BSON("k" << 3)), BSONObj());
+    ASSERT_BSONOBJ_EQ(buildTuple(*mapper, BSON("k" << BSON("x" << 1) << "v" << 1)), BSONObj());
+}
+
+TEST(NativeSumReducerTest, SumsNumbersAsDoubles) {
+    BSONObj code = BSON("reduce" << BSONCode("function(k, vals) { return Array.sum(vals); }"));
+    auto reducer = mr::NativeSumReducer::parse(code.firstElement());
+    ASSERT(reducer);
+
+    mr::BSONList tuples{BSON("0" << "a" << "1" << 1),
+                        BSON("0" << "a" << "1" << 2.5),
+                        BSON("0" << "a" << "1" << 3LL)};
+    BSONObj reduced = reducer->reduce(tuples);
+    ASSERT_BSONOBJ_EQ(reduced, BSON("0" << "a" << "1" << 6.5));
+    ASSERT_EQ(reduced["1"].type(), NumberDouble);
+    ASSERT_BSONOBJ_EQ(reducer->finalReduce(tuples, nullptr), BSON("_id" << "a" << "value" << 6.5));
+    ASSERT_EQ(reducer->numReduces, 2);
+}
+
+TEST(NativeSumReducerTest, ReturnsSingleTupleUnchanged) {
+    BSONObj code = BSON("reduce" << BSONCode("function(k, vals) { return Array.sum(vals); }"));
+    auto reducer = mr::NativeSumReducer::parse(code.firstElement());
+    ASSERT(reducer);
+
+    mr::BSONList tuples{BSON("0" << "a" << "1" << 2)};
+    ASSERT_BSONOBJ_EQ(reducer->reduce(tuples), tuples[0]);
+    ASSERT_EQ(reducer->numReduces, 0);
+}
+
 }  // namespace
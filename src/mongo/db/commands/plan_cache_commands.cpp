@@ -446,6 +446,9 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     // Append the time the entry was inserted into the plan cache.
     bob->append("timeOfCreation", entry->timeOfCreation);
 
+    // Append the planning counters of the query shape, which outlive replans of its entry.
+    bob->append("shapeStats", entry->stats.toBSON());
+
     return Status::OK();
 }
 
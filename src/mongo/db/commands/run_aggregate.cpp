@@ -50,6 +50,7 @@
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/pipeline/pipeline_result_cache.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find_common.h"
@@ -84,12 +85,15 @@ namespace {
  * requests). Otherwise, returns false. The passed 'nsForCursor' is only used to determine the
  * namespace used in the returned cursor, which will be registered with the global cursor manager,
  * and thus will be different from that in 'request'.
+ *
+ * If 'resultsToCache' is not null, a copy of every result returned is appended to it.
  */
 bool handleCursorCommand(OperationContext* opCtx,
                          const NamespaceString& nsForCursor,
                          ClientCursor* cursor,
                          const AggregationRequest& request,
-                         BSONObjBuilder& result) {
+                         BSONObjBuilder& result,
+                         std::vector<BSONObj>* resultsToCache) {
     invariant(cursor);
 
     long long batchSize = request.getBatchSize();
@@ -137,6 +141,9 @@ bool handleCursorCommand(OperationContext* opCtx,
 
         responseBuilder.setLatestOplogTimestamp(cursor->getExecutor()->getLatestOplogTimestamp());
         responseBuilder.append(next);
+        if (resultsToCache) {
+            resultsToCache->push_back(next.getOwned());
+        }
     }
 
     if (cursor) {
@@ -160,6 +167,59 @@ bool handleCursorCommand(OperationContext* opCtx,
     return static_cast<bool>(cursor);
 }
 
+/**
+ * Returns whether the results of running 'pipeline' against 'collection' may be served from, and
+ * added to, the PipelineResultCache.
+ */
+bool canUsePipelineResultCache(OperationContext* opCtx,
+                               const AggregationRequest& request,
+                               const LiteParsedPipeline& liteParsedPipeline,
+                               const ExpressionContext& expCtx,
+                               Collection* collection,
+                               const Pipeline& pipeline) {
+    if (!PipelineResultCache::isEnabled()) {
+        return false;
+    }
+
+    // Documents can leave a capped collection without any write being observed. A shard's view of
+    // its collection can change with its chunk ownership, also without any write.
+    if (!collection || collection->isCapped() || request.isFromMongos()) {
+        return false;
+    }
+
+    if (expCtx.explain || expCtx.tailableMode != TailableMode::kNormal ||
+        liteParsedPipeline.hasChangeStream() ||
+        !liteParsedPipeline.getInvolvedNamespaces().empty()) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsClusterTime() || readConcernArgs.getArgsOpTime()) {
+        return false;
+    }
+
+    return PipelineResultCache::isCacheable(pipeline);
+}
+
+/**
+ * Responds to the aggregate command with 'cachedResults' in a single exhausted batch.
+ */
+void appendCachedResults(OperationContext* opCtx,
+                         const NamespaceString& nsForCursor,
+                         const std::vector<BSONObj>& cachedResults,
+                         BSONObjBuilder& result) {
+    CursorResponseBuilder responseBuilder(true, &result);
+    for (auto&& obj : cachedResults) {
+        responseBuilder.append(obj);
+    }
+    responseBuilder.done(0LL, nsForCursor.ns());
+
+    auto& debug = CurOp::get(opCtx)->debug();
+    debug.cursorExhausted = true;
+    debug.nreturned = cachedResults.size();
+}
+
 StatusWith<StringMap<ExpressionContext::ResolvedNamespace>> resolveInvolvedNamespaces(
     OperationContext* opCtx, const AggregationRequest& request) {
     const LiteParsedPipeline liteParsedPipeline(request);
@@ -350,6 +410,10 @@ Status runAggregate(OperationContext* opCtx,
     boost::intrusive_ptr<ExpressionContext> expCtx;
     Pipeline* unownedPipeline;
     auto curOp = CurOp::get(opCtx);
+
+    // Set if the results of this aggregation should be added to the PipelineResultCache.
+    boost::optional<std::string> resultCacheKey;
+    uint64_t resultCacheWriteGeneration = 0;
     {
         const LiteParsedPipeline liteParsedPipeline(request);
         if (liteParsedPipeline.hasChangeStream()) {
@@ -487,6 +551,22 @@ Status runAggregate(OperationContext* opCtx,
             pipeline = reparsePipeline(pipeline.get(), request, expCtx);
         }
 
+        // Serve the results from the cache if they were computed since the latest write to the
+        // collection. Otherwise note the write generation before building the executor, which may
+        // read from the collection, so that the results can be cached once they are complete.
+        if (canUsePipelineResultCache(
+                opCtx, request, liteParsedPipeline, *expCtx, collection, *pipeline)) {
+            auto& resultCache = PipelineResultCache::get(opCtx);
+            resultCacheKey = PipelineResultCache::makeKey(nss, *pipeline, expCtx->getCollator());
+            auto cachedResults = resultCache.find(*resultCacheKey, nss);
+            if (cachedResults &&
+                static_cast<long long>(cachedResults->size()) <= request.getBatchSize()) {
+                appendCachedResults(opCtx, origNss, *cachedResults, result);
+                return Status::OK();
+            }
+            resultCacheWriteGeneration = resultCache.getWriteGeneration(nss);
+        }
+
         // Prepare a PlanExecutor to provide input into the pipeline, if needed.
         if (liteParsedPipeline.hasChangeStream()) {
             // If we are using a change stream, the cursor stage should have a simple collation,
@@ -549,10 +629,19 @@ Status runAggregate(OperationContext* opCtx,
         result << "stages" << Value(unownedPipeline->writeExplainOps(*expCtx->explain));
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor =
-            handleCursorCommand(opCtx, origNss, pin.getCursor(), request, result);
+        std::vector<BSONObj> resultsToCache;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    origNss,
+                                                    pin.getCursor(),
+                                                    request,
+                                                    result,
+                                                    resultCacheKey ? &resultsToCache : nullptr);
         if (keepCursor) {
             cursorFreer.Dismiss();
+        } else if (resultCacheKey) {
+            // Only complete results are cached.
+            PipelineResultCache::get(opCtx).add(
+                *resultCacheKey, nss, resultCacheWriteGeneration, std::move(resultsToCache));
         }
     }
 
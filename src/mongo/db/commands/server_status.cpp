@@ -53,6 +53,7 @@
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/periodic_runner.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/time_support.h"
@@ -363,6 +364,24 @@ public:
             getHostFQDNs(getHostNameCached(), HostnameCanonicalizationMode::kForwardAndReverse));
     }
 } advisoryHostFQDNs;
+
+class PeriodicRunnerSSS final : public ServerStatusSection {
+public:
+    PeriodicRunnerSSS() : ServerStatusSection("periodicRunner") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder bb;
+        if (auto runner = opCtx->getServiceContext()->getPeriodicRunner()) {
+            runner->appendStats(&bb);
+        }
+        return bb.obj();
+    }
+} periodicRunnerSSS;
 }  // namespace
 
 }  // namespace mongo
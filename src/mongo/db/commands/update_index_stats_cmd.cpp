@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+// The number of histogram buckets to build when the command does not specify it.
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 10000;
+
+// How many index keys are scanned between checks for interrupt.
+const long long kKeysPerInterruptCheck = 1024;
+
+/**
+ * Builds data-distribution statistics for the indexes of a collection by scanning them, and
+ * publishes them to the collection's info cache for the query planner and $indexStats.
+ *
+ * {updateIndexStats: <collection>, index: <optional index name>, buckets: <optional count>}
+ */
+class CmdUpdateIndexStats : public BasicCommand {
+public:
+    CmdUpdateIndexStats() : BasicCommand("updateIndexStats") {}
+
+    bool slaveOk() const final {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const final {
+        return false;
+    }
+
+    void help(std::stringstream& help) const final {
+        help << "build histograms and distinct value estimates for the indexes of a collection\n"
+                "{ updateIndexStats: <collection>, [index: <name>], [buckets: <count>] }";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) final {
+        AuthorizationSession* authzSession = AuthorizationSession::get(client);
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+        if (authzSession->isAuthorizedForActionsOnResource(ResourcePattern::forExactNamespace(nss),
+                                                           ActionType::planCacheWrite)) {
+            return Status::OK();
+        }
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) final {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        std::string indexName;
+        if (auto indexElt = cmdObj["index"]) {
+            if (indexElt.type() != String) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::TypeMismatch, "'index' must be a string"));
+            }
+            indexName = indexElt.str();
+        }
+
+        long long numBuckets = kDefaultNumBuckets;
+        if (auto bucketsElt = cmdObj["buckets"]) {
+            if (!bucketsElt.isNumber()) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::TypeMismatch, "'buckets' must be a number"));
+            }
+            numBuckets = bucketsElt.numberLong();
+            if (numBuckets < 1 || numBuckets > kMaxNumBuckets) {
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::BadValue,
+                                                  str::stream() << "'buckets' must be between 1 and "
+                                                                << kMaxNumBuckets));
+            }
+        }
+
+        struct BuiltStatistics {
+            std::string indexName;
+            BSONObj keyPattern;
+            std::shared_ptr<const IndexStatistics> statistics;
+        };
+        std::vector<BuiltStatistics> built;
+
+        // Scan the indexes while only holding the collection lock in intent shared mode.
+        {
+            AutoGetCollectionForReadCommand ctx(opCtx, nss);
+            Collection* collection = ctx.getCollection();
+            if (!collection) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::NamespaceNotFound, "collection not found"));
+            }
+
+            const long long keysPerBucket = collection->numRecords(opCtx) / numBuckets;
+            const Date_t now = opCtx->getServiceContext()->getFastClockSource()->now();
+            IndexCatalog* indexCatalog = collection->getIndexCatalog();
+            IndexCatalog::IndexIterator ii = indexCatalog->getIndexIterator(opCtx, false);
+            while (ii.more()) {
+                IndexDescriptor* desc = ii.next();
+                if (!indexName.empty() && desc->indexName() != indexName) {
+                    continue;
+                }
+
+                IndexStatisticsBuilder builder(keysPerBucket);
+                auto cursor = indexCatalog->getIndex(desc)->newCursor(opCtx, true);
+                long long numKeys = 0;
+                for (auto kv = cursor->seek(BSONObj(), true); kv; kv = cursor->next()) {
+                    builder.addKey(kv->key);
+                    if (++numKeys % kKeysPerInterruptCheck == 0) {
+                        opCtx->checkForInterrupt();
+                    }
+                }
+
+                built.push_back(
+                    {desc->indexName(), desc->keyPattern().getOwned(), builder.done(now)});
+            }
+        }
+
+        if (!indexName.empty() && built.empty()) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::IndexNotFound, str::stream() << "index not found: " << indexName));
+        }
+
+        // Publishing the statistics requires an exclusive collection lock. Skip indexes which were
+        // dropped while they were being scanned.
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX, MODE_X);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return appendCommandStatus(
+                result, Status(ErrorCodes::NamespaceNotFound, "collection dropped during scan"));
+        }
+
+        BSONObjBuilder indexesBuilder(result.subobjStart("indexes"));
+        for (auto&& stats : built) {
+            IndexDescriptor* desc =
+                collection->getIndexCatalog()->findIndexByName(opCtx, stats.indexName);
+            if (!desc || SimpleBSONObjComparator::kInstance.evaluate(desc->keyPattern() !=
+                                                                     stats.keyPattern)) {
+                continue;
+            }
+
+            BSONObjBuilder indexBuilder(indexesBuilder.subobjStart(stats.indexName));
+            indexBuilder.appendNumber("numKeys", stats.statistics->numKeys());
+            indexBuilder.appendNumber("numDistinct", stats.statistics->numDistinct());
+            indexBuilder.appendNumber(
+                "numBuckets", static_cast<long long>(stats.statistics->getBuckets().size()));
+            indexBuilder.doneFast();
+
+            collection->infoCache()->setIndexStatistics(stats.indexName,
+                                                        std::move(stats.statistics));
+        }
+        indexesBuilder.doneFast();
+
+        return true;
+    }
+} cmdUpdateIndexStats;
+
+}  // namespace
+}  // namespace mongo
@@ -38,7 +38,9 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -76,7 +78,9 @@ public:
              "Slow.\n"
              "Add full:true option to do a more thorough check\n"
              "Add scandata:false to skip the scan of the collection data without skipping scans "
-             "of any indexes";
+             "of any indexes\n"
+             "Add background:true to validate a snapshot without blocking writes to the "
+             "collection";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -89,7 +93,8 @@ public:
         actions.addAction(ActionType::validate);
         out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
     }
-    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> } */
+    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool>]
+    //  [, background: <bool>] } */
 
     bool run(OperationContext* opCtx,
              const string& dbname,
@@ -124,8 +129,30 @@ public:
             LOG(0) << "CMD: validate " << nss.ns();
         }
 
-        AutoGetDb ctx(opCtx, nss.db(), MODE_IX);
-        auto collLk = stdx::make_unique<Lock::CollectionLock>(opCtx->lockState(), nss.ns(), MODE_X);
+        // A background validation reads a single storage engine snapshot under intent locks, so
+        // writes to the collection continue while it runs. It relies on the snapshot isolation of
+        // storage engines with document-level locking.
+        const bool background = cmdObj["background"].trueValue();
+        if (background) {
+            if (full) {
+                return appendCommandStatus(
+                    result,
+                    {ErrorCodes::CommandFailed,
+                     "A full validate cannot run in the background, use full:false"});
+            }
+
+            StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+            if (!storageEngine->supportsDocLocking()) {
+                return appendCommandStatus(result,
+                                           {ErrorCodes::CommandFailed,
+                                            "This storage engine does not support the background "
+                                            "option, use background:false"});
+            }
+        }
+
+        AutoGetDb ctx(opCtx, nss.db(), background ? MODE_IS : MODE_IX);
+        auto collLk = stdx::make_unique<Lock::CollectionLock>(
+            opCtx->lockState(), nss.ns(), background ? MODE_IS : MODE_X);
         Collection* collection = ctx.getDb() ? ctx.getDb()->getCollection(opCtx, nss) : NULL;
         if (!collection) {
             if (ctx.getDb() && ctx.getDb()->getViewCatalog()->lookup(opCtx, nss.ns())) {
@@ -137,33 +164,12 @@ public:
             return false;
         }
 
-        // Omit background validation logic until it is fully implemented and vetted.
-        const bool background = false;
-        /*
-        bool isInRecordIdOrder = collection->getRecordStore()->isInRecordIdOrder();
-        if (isInRecordIdOrder && !full) {
-            background = true;
-        }
-
-        if (cmdObj.hasElement("background")) {
-            background = cmdObj["background"].trueValue();
-        }
-
-        if (!isInRecordIdOrder && background) {
-            appendCommandStatus(result,
-                                {ErrorCodes::CommandFailed,
-                                 "This storage engine does not support the background option, use "
-                                 "background:false"});
-            return false;
-        }
-
-        if (full && background) {
-            appendCommandStatus(result,
-                                {ErrorCodes::CommandFailed,
-                                 "A full validate cannot run in the background, use full:false"});
-            return false;
+        if (background && !collection->getRecordStore()->isInRecordIdOrder()) {
+            return appendCommandStatus(result,
+                                       {ErrorCodes::CommandFailed,
+                                        "This storage engine does not support the background "
+                                        "option, use background:false"});
         }
-        */
 
         result.append("ns", nss.ns());
 
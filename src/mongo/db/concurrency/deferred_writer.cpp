@@ -37,6 +37,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -44,61 +45,70 @@ namespace {
 auto kLogInterval = stdx::chrono::minutes(1);
 }
 
-void DeferredWriter::_logFailure(const Status& status) {
+void DeferredWriter::_logFailure(const NamespaceString& nss, const Status& status) {
     if (TimePoint::clock::now() - _lastLogged > kLogInterval) {
-        log() << "Unable to write to collection " << _nss.toString() << ": " << status.toString();
+        log() << "Unable to write to collection " << nss.toString() << ": " << status.toString();
         _lastLogged = stdx::chrono::system_clock::now();
     }
 }
 
-void DeferredWriter::_logDroppedEntry() {
+void DeferredWriter::_logDroppedEntry(const NamespaceString& nss) {
     _droppedEntries += 1;
     if (TimePoint::clock::now() - _lastLoggedDrop > kLogInterval) {
-        log() << "Deferred write buffer for " << _nss.toString() << " is full. " << _droppedEntries
+        log() << "Deferred write buffer for " << nss.toString() << " is full. " << _droppedEntries
               << " entries have been dropped.";
         _lastLoggedDrop = stdx::chrono::system_clock::now();
         _droppedEntries = 0;
     }
 }
 
-Status DeferredWriter::_makeCollection(OperationContext* opCtx) {
+Status DeferredWriter::_makeCollection(OperationContext* opCtx, const NamespaceString& nss) {
     BSONObjBuilder builder;
-    builder.append("create", _nss.coll());
+    builder.append("create", nss.coll());
     builder.appendElements(_collectionOptions.toBSON());
     try {
-        return createCollection(opCtx, _nss.db().toString(), builder.obj().getOwned());
+        return createCollection(opCtx, nss.db().toString(), builder.obj().getOwned());
     } catch (const DBException& exception) {
         return exception.toStatus();
     }
 }
 
 StatusWith<std::unique_ptr<AutoGetCollection>> DeferredWriter::_getCollection(
-    OperationContext* opCtx) {
+    OperationContext* opCtx, const NamespaceString& nss, bool mayCreateDatabase) {
     std::unique_ptr<AutoGetCollection> agc;
-    agc = stdx::make_unique<AutoGetCollection>(opCtx, _nss, MODE_IX);
+    agc = stdx::make_unique<AutoGetCollection>(opCtx, nss, MODE_IX);
 
     while (!agc->getCollection()) {
+        if (!mayCreateDatabase && !agc->getDb()) {
+            return Status(ErrorCodes::NamespaceNotFound,
+                          str::stream() << "Database " << nss.db() << " does not exist");
+        }
+
         // Release the previous AGC's lock before trying to rebuild the collection.
         agc.reset();
-        Status status = _makeCollection(opCtx);
+        Status status = _makeCollection(opCtx, nss);
 
         if (!status.isOK()) {
             return status;
         }
 
-        agc = stdx::make_unique<AutoGetCollection>(opCtx, _nss, MODE_IX);
+        agc = stdx::make_unique<AutoGetCollection>(opCtx, nss, MODE_IX);
     }
 
     return std::move(agc);
 }
 
-void DeferredWriter::_worker(InsertStatement stmt) {
+void DeferredWriter::_worker(const NamespaceString& nss,
+                             InsertStatement stmt,
+                             bool mayCreateDatabase) {
     auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
     OperationContext* opCtx = uniqueOpCtx.get();
-    auto result = _getCollection(opCtx);
+    auto result = _getCollection(opCtx, nss, mayCreateDatabase);
 
     if (!result.isOK()) {
-        _logFailure(result.getStatus());
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _numBytes -= stmt.doc.objsize();
+        _logFailure(nss, result.getStatus());
         return;
     }
 
@@ -106,7 +116,7 @@ void DeferredWriter::_worker(InsertStatement stmt) {
 
     Collection& collection = *agc->getCollection();
 
-    Status status = writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
+    Status status = writeConflictRetry(opCtx, "deferred insert", nss.ns(), [&] {
         WriteUnitOfWork wuow(opCtx);
         Status status = collection.insertDocument(opCtx, stmt, nullptr, false);
         if (!status.isOK()) {
@@ -123,7 +133,7 @@ void DeferredWriter::_worker(InsertStatement stmt) {
 
     // If a write to a deferred collection fails, periodically tell the log.
     if (!status.isOK()) {
-        _logFailure(status);
+        _logFailure(nss, status);
     }
 }
 
@@ -162,6 +172,16 @@ void DeferredWriter::shutdown(void) {
 }
 
 bool DeferredWriter::insertDocument(BSONObj obj) {
+    return _insertDocument(_nss, std::move(obj), true);
+}
+
+bool DeferredWriter::insertDocument(const NamespaceString& nss, BSONObj obj) {
+    return _insertDocument(nss, std::move(obj), false);
+}
+
+bool DeferredWriter::_insertDocument(const NamespaceString& nss,
+                                     BSONObj obj,
+                                     bool mayCreateDatabase) {
     // We can't insert documents if we haven't been started up.
     invariant(_pool);
 
@@ -171,14 +191,22 @@ bool DeferredWriter::insertDocument(BSONObj obj) {
     if (_numBytes + obj.objsize() >= _maxNumBytes) {
         // If not, drop it.  We always drop new entries rather than old ones; that way the caller
         // knows at the time of the call that the entry was dropped.
-        _logDroppedEntry();
+        _logDroppedEntry(nss);
         return false;
     }
 
-    // Add the object to the buffer.
+    // Add the object to the buffer. Take ownership now, as the caller's buffer may not outlive
+    // this call.
+    Status status = _pool->schedule([ this, nss, obj = obj.getOwned(), mayCreateDatabase ] {
+        _worker(nss, InsertStatement(obj), mayCreateDatabase);
+    });
+    if (status == ErrorCodes::ShutdownInProgress) {
+        // A writer shared by many callers may still be handed documents while it shuts down.
+        _logDroppedEntry(nss);
+        return false;
+    }
+    fassertStatusOK(40588, status);
     _numBytes += obj.objsize();
-    fassertStatusOK(40588,
-                    _pool->schedule([this, obj] { _worker(InsertStatement(obj.getOwned())); }));
     return true;
 }
 
@@ -102,6 +102,16 @@ public:
      */
     bool insertDocument(BSONObj obj);
 
+    /**
+     * Deferred-insert the given object into the collection 'nss' instead of the writer's own
+     * collection, sharing the writer's buffer and worker thread. Lets one writer serve a family of
+     * collections, such as every database's system.profile.
+     *
+     * Creates 'nss' with the writer's collection options if it doesn't exist, but never creates its
+     * database: if the database is gone by the time the insert runs, the insert is dropped.
+     */
+    bool insertDocument(const NamespaceString& nss, BSONObj obj);
+
     /**
      * Get the number of dropped writes due to a full buffer since the last log
      */
@@ -111,30 +121,38 @@ private:
     /**
      * Log failure, but only if a certain interval has passed since the last log.
      */
-    void _logFailure(const Status& status);
+    void _logFailure(const NamespaceString& nss, const Status& status);
 
     /**
      * Log number of entries dropped because of a full buffer. Rate limited and
      * each successful log resets the counter.
      */
-    void _logDroppedEntry();
+    void _logDroppedEntry(const NamespaceString& nss);
+
+    /**
+     * Buffer 'obj' and schedule its insert into 'nss'.
+     */
+    bool _insertDocument(const NamespaceString& nss, BSONObj obj, bool mayCreateDatabase);
 
     /**
      * Create the backing collection if it doesn't exist.
      *
      * Return whether creation succeeded.
      */
-    Status _makeCollection(OperationContext* opCtx);
+    Status _makeCollection(OperationContext* opCtx, const NamespaceString& nss);
 
     /**
-     * Ensure that the backing collection exists, and pass back a lock and handle to it.
+     * Ensure that the backing collection exists, and pass back a lock and handle to it. Fails with
+     * NamespaceNotFound if the database doesn't exist and 'mayCreateDatabase' is false.
      */
-    StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(OperationContext* opCtx);
+    StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(OperationContext* opCtx,
+                                                                   const NamespaceString& nss,
+                                                                   bool mayCreateDatabase);
 
     /**
      * The method that the worker thread will run.
      */
-    void _worker(InsertStatement stmt);
+    void _worker(const NamespaceString& nss, InsertStatement stmt, bool mayCreateDatabase);
 
     /**
      * The options for the collection, in case we need to create it.
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_sampler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+namespace {
+
+// Lock waits at least this long are kept for $lockContention. Negative disables sampling.
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionSampleMinWaitMicros, int, 1000);
+
+LockContentionSampler globalLockContentionSampler;
+
+const char* lockResultName(LockResult result) {
+    switch (result) {
+        case LOCK_OK:
+            return "granted";
+        case LOCK_TIMEOUT:
+            return "timeout";
+        case LOCK_DEADLOCK:
+            return "deadlock";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace
+
+BSONObj LockContentionSample::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("time", time);
+    builder.append("resourceType", resourceTypeName(resId.getType()));
+    builder.append("resourceId", resId.toString());
+    builder.append("mode", modeName(mode));
+    builder.append("result", lockResultName(result));
+    builder.append("lockerId", static_cast<long long>(lockerId));
+    builder.append("waitMicros", durationCount<Microseconds>(waitTime));
+    return builder.obj();
+}
+
+constexpr size_t LockContentionSampler::kDefaultCapacity;
+
+LockContentionSampler::LockContentionSampler(size_t capacity) : _capacity(capacity) {
+    invariant(_capacity > 0);
+}
+
+LockContentionSampler& LockContentionSampler::get() {
+    return globalLockContentionSampler;
+}
+
+void LockContentionSampler::recordWait(LockerId lockerId,
+                                       ResourceId resId,
+                                       LockMode mode,
+                                       LockResult result,
+                                       Microseconds waitTime) {
+    const int minWaitMicros = lockContentionSampleMinWaitMicros.load();
+    if (minWaitMicros < 0 || waitTime < Microseconds(minWaitMicros)) {
+        return;
+    }
+
+    LockContentionSample sample;
+    sample.time = Date_t::now();
+    sample.resId = resId;
+    sample.mode = mode;
+    sample.result = result;
+    sample.lockerId = lockerId;
+    sample.waitTime = waitTime;
+
+    _numRecorded.addAndFetch(1);
+    _totalWaitMicros.addAndFetch(durationCount<Microseconds>(waitTime));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_samples.size() < _capacity) {
+        _samples.push_back(std::move(sample));
+    } else {
+        _samples[_next] = std::move(sample);
+    }
+    _next = (_next + 1) % _capacity;
+}
+
+std::vector<LockContentionSample> LockContentionSampler::getSamples() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_samples.size() < _capacity) {
+        return _samples;
+    }
+
+    // The ring is full, so '_next' is the position of the oldest sample.
+    std::vector<LockContentionSample> samples;
+    samples.reserve(_samples.size());
+    samples.insert(samples.end(), _samples.begin() + _next, _samples.end());
+    samples.insert(samples.end(), _samples.begin(), _samples.begin() + _next);
+    return samples;
+}
+
+void LockContentionSampler::report(BSONObjBuilder* builder) const {
+    builder->append("samplesRecorded", _numRecorded.load());
+    builder->append("sampledWaitMicros", _totalWaitMicros.load());
+}
+
+void LockContentionSampler::reset() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _samples.clear();
+    _next = 0;
+    _numRecorded.store(0);
+    _totalWaitMicros.store(0);
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * One lock acquisition which had to wait at least lockContentionSampleMinWaitMicros.
+ */
+struct LockContentionSample {
+    BSONObj toBSON() const;
+
+    Date_t time;
+    ResourceId resId;
+    LockMode mode = MODE_NONE;
+    LockResult result = LOCK_INVALID;
+    LockerId lockerId = 0;
+    Microseconds waitTime;
+};
+
+/**
+ * Keeps the most recent slow lock waits in a fixed size ring buffer, so that the resources which
+ * operations queue on can be found after the fact. Only the slow path of lock acquisition, after
+ * an operation has already been blocked, reports here. This class is thread-safe.
+ */
+class LockContentionSampler {
+    MONGO_DISALLOW_COPYING(LockContentionSampler);
+
+public:
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    explicit LockContentionSampler(size_t capacity = kDefaultCapacity);
+
+    /**
+     * The process-wide sampler fed by LockerImpl.
+     */
+    static LockContentionSampler& get();
+
+    /**
+     * Records a completed wait for 'resId' if it lasted at least lockContentionSampleMinWaitMicros.
+     * A negative threshold disables sampling.
+     */
+    void recordWait(LockerId lockerId,
+                    ResourceId resId,
+                    LockMode mode,
+                    LockResult result,
+                    Microseconds waitTime);
+
+    /**
+     * Returns the samples currently in the ring buffer, oldest first.
+     */
+    std::vector<LockContentionSample> getSamples() const;
+
+    /**
+     * Appends the number of samples ever recorded and their total wait time. These are plain
+     * counters, so that the serverStatus section stays cheap for FTDC to compress.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+    /**
+     * Discards all samples and counters. Used by tests.
+     */
+    void reset();
+
+private:
+    const size_t _capacity;
+
+    mutable stdx::mutex _mutex;
+    std::vector<LockContentionSample> _samples;
+    size_t _next = 0;
+
+    AtomicInt64 _numRecorded;
+    AtomicInt64 _totalWaitMicros;
+};
+
+}  // namespace mongo
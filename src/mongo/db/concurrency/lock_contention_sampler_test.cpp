@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_sampler.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+void setMinWaitMicros(int micros) {
+    const auto& params = ServerParameterSet::getGlobal()->getMap();
+    auto param = params.find("lockContentionSampleMinWaitMicros");
+    ASSERT(param != params.end());
+    ASSERT_OK(param->second->setFromString(std::to_string(micros)));
+}
+
+TEST(LockContentionSampler, RingKeepsNewestSamplesInOrder) {
+    setMinWaitMicros(0);
+    ON_BLOCK_EXIT([] { setMinWaitMicros(1000); });
+
+    LockContentionSampler sampler(3);
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockContentionSampler.Ring"));
+    for (LockerId id = 1; id <= 5; id++) {
+        sampler.recordWait(id, resId, MODE_X, LOCK_OK, Microseconds(10));
+    }
+
+    auto samples = sampler.getSamples();
+    ASSERT_EQ(3U, samples.size());
+    ASSERT_EQ(3U, samples[0].lockerId);
+    ASSERT_EQ(4U, samples[1].lockerId);
+    ASSERT_EQ(5U, samples[2].lockerId);
+
+    BSONObjBuilder builder;
+    sampler.report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("samplesRecorded" << 5LL << "sampledWaitMicros" << 50LL),
+                      builder.obj());
+}
+
+TEST(LockContentionSampler, ShortWaitsAreNotRecorded) {
+    setMinWaitMicros(100);
+    ON_BLOCK_EXIT([] { setMinWaitMicros(1000); });
+
+    LockContentionSampler sampler;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockContentionSampler.Short"));
+    sampler.recordWait(1, resId, MODE_S, LOCK_OK, Microseconds(99));
+    ASSERT(sampler.getSamples().empty());
+
+    sampler.recordWait(1, resId, MODE_S, LOCK_OK, Microseconds(100));
+    ASSERT_EQ(1U, sampler.getSamples().size());
+
+    setMinWaitMicros(-1);
+    sampler.recordWait(1, resId, MODE_S, LOCK_OK, Microseconds(1000000));
+    ASSERT_EQ(1U, sampler.getSamples().size());
+}
+
+TEST(LockContentionSampler, BlockedLockerIsSampled) {
+    setMinWaitMicros(0);
+    ON_BLOCK_EXIT([] { setMinWaitMicros(1000); });
+    LockContentionSampler::get().reset();
+
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockContentionSampler.Blocked"));
+    LockerForTests locker(MODE_IX);
+    locker.lock(resId, MODE_X);
+
+    LockerForTests lockerConflict(MODE_IX);
+    ASSERT_EQUALS(LOCK_WAITING, lockerConflict.lockBegin(resId, MODE_S));
+    ASSERT_EQUALS(LOCK_TIMEOUT, lockerConflict.lockComplete(resId, MODE_S, Milliseconds(1), false));
+
+    auto samples = LockContentionSampler::get().getSamples();
+    ASSERT_EQ(1U, samples.size());
+    ASSERT_EQ(resId, samples[0].resId);
+    ASSERT_EQ(MODE_S, samples[0].mode);
+    ASSERT_EQ(LOCK_TIMEOUT, samples[0].result);
+    ASSERT_EQ(lockerConflict.getId(), samples[0].lockerId);
+
+    auto obj = samples[0].toBSON();
+    ASSERT_EQ("Collection", obj["resourceType"].String());
+    ASSERT_EQ("S", obj["mode"].String());
+    ASSERT_EQ("timeout", obj["result"].String());
+}
+
+}  // namespace
+}  // namespace mongo
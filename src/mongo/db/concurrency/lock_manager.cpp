@@ -414,10 +414,7 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
-LockManager::LockManager() {
-    _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
-}
+LockManager::LockManager() : _lockBuckets(_numLockBuckets), _partitions(_numPartitions) {}
 
 LockManager::~LockManager() {
     cleanupUnusedLocks();
@@ -426,9 +423,6 @@ LockManager::~LockManager() {
         // TODO: dump more information about the non-empty bucket to see what locks were leaked
         invariant(_lockBuckets[i].data.empty());
     }
-
-    delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -805,6 +799,14 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != nullptr));
 }
 
+bool LockManager::hasConflictingRequests(ResourceId resId) const {
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::const_iterator it = bucket->data.find(resId);
+    return it != bucket->data.end() && it->second->conflictList._front != nullptr;
+}
+
 LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <deque>
 #include <map>
+#include <boost/align/aligned_allocator.hpp>
 #include <vector>
 
 #include "mongo/bson/bsonobj.h"
@@ -43,6 +44,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -112,6 +114,12 @@ public:
      */
     void downgrade(LockRequest* request, LockMode newMode);
 
+    /**
+     * Returns true if some request for 'resId' is queued because its mode conflicts with the
+     * modes already granted. The answer is only a hint, as it may be stale by the time it is used.
+     */
+    bool hasConflictingRequests(ResourceId resId) const;
+
     /**
      * Iterates through all buckets and deletes all locks, which have no requests on them. This
      * call is kind of expensive and should only be used for reducing the memory footprint of
@@ -211,11 +219,18 @@ private:
      */
     void _cleanupUnusedLocksInBucket(LockBucket* bucket);
 
+    // Buckets and partitions are each given their own cache line. Every intent acquisition takes
+    // one of these mutexes, so lockers mapped to neighbouring entries must not bounce the same
+    // line between cores.
+    template <typename T>
+    using CacheAlignedVector = std::vector<CacheAligned<T>,
+                                           boost::alignment::aligned_allocator<CacheAligned<T>>>;
+
     static const unsigned _numLockBuckets;
-    LockBucket* _lockBuckets;
+    mutable CacheAlignedVector<LockBucket> _lockBuckets;
 
     static const unsigned _numPartitions;
-    Partition* _partitions;
+    mutable CacheAlignedVector<Partition> _partitions;
 };
 
 
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const ResourceId kCollectionResource(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+void lockManagerAcquireRelease(unittest::BenchmarkState& state, LockMode mode) {
+    LockManager lockMgr;
+    DefaultLockerImpl locker;
+    TrackingLockGrantNotification notify;
+
+    LockRequest request;
+    request.initNew(&locker, &notify);
+
+    while (state.keepRunning()) {
+        lockMgr.lock(kCollectionResource, &request, mode);
+        lockMgr.unlock(&request);
+    }
+}
+
+MONGO_BENCHMARK(LockManagerAcquireReleaseIS) {
+    lockManagerAcquireRelease(state, MODE_IS);
+}
+
+MONGO_BENCHMARK(LockManagerAcquireReleaseX) {
+    lockManagerAcquireRelease(state, MODE_X);
+}
+
+// Acquire with another compatible request already granted on the resource, so the request joins
+// the granted list instead of taking the empty-resource fast path
+MONGO_BENCHMARK(LockManagerAcquireReleaseISShared) {
+    LockManager lockMgr;
+    DefaultLockerImpl holderLocker;
+    DefaultLockerImpl locker;
+    TrackingLockGrantNotification notify;
+
+    LockRequest holder;
+    holder.initNew(&holderLocker, &notify);
+    lockMgr.lock(kCollectionResource, &holder, MODE_IS);
+
+    LockRequest request;
+    request.initNew(&locker, &notify);
+
+    while (state.keepRunning()) {
+        lockMgr.lock(kCollectionResource, &request, MODE_IS);
+        lockMgr.unlock(&request);
+    }
+
+    lockMgr.unlock(&holder);
+}
+
+// The full Locker path taken by a collection-level read: global, database and collection locks
+MONGO_BENCHMARK(LockerCollectionIntentShared) {
+    const ResourceId dbResource(RESOURCE_DATABASE, std::string("TestDB"));
+    DefaultLockerImpl locker;
+
+    while (state.keepRunning()) {
+        locker.lockGlobal(MODE_IS);
+        locker.lock(dbResource, MODE_IS);
+        locker.lock(kCollectionResource, MODE_IS);
+        locker.unlock(kCollectionResource);
+        locker.unlock(dbResource);
+        locker.unlockGlobal();
+    }
+}
+
+}  // namespace
+}  // namespace mongo
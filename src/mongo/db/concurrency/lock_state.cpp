@@ -34,6 +34,7 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/lock_contention_sampler.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
@@ -572,6 +573,27 @@ void LockerImpl<IsForMMAPV1>::getLockerInfo(LockerInfo* lockerInfo) const {
     lockerInfo->stats.append(_stats);
 }
 
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::hasConflictingWaiters() const {
+    // Only this locker's own thread modifies '_requests', so it may read them without '_lock'.
+    for (LockRequestsMap::ConstIterator it = _requests.begin(); !it.finished(); it.next()) {
+        if (it->status == LockRequest::STATUS_GRANTED &&
+            globalLockManager.hasConflictingRequests(it.key())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::isTicketPoolExhausted() const {
+    if (_modeForTicket == MODE_NONE) {
+        return false;
+    }
+    auto holder = ticketHolders[_modeForTicket];
+    return holder && holder->available() <= 0;
+}
+
 template <bool IsForMMAPV1>
 bool LockerImpl<IsForMMAPV1>::saveLockStateAndUnlock(Locker::LockSnapshot* stateOut) {
     // We shouldn't be saving and restoring lock state from inside a WriteUnitOfWork.
@@ -785,6 +807,13 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
         }
     }
 
+    LockContentionSampler::get().recordWait(
+        _id,
+        resId,
+        mode,
+        result,
+        Microseconds(static_cast<int64_t>(curTimeMicros64() - startOfTotalWaitTime)));
+
     // Cleanup the state, since this is an unused lock now.
     // Note: in case of the _notify object returning LOCK_TIMEOUT, it is possible to find that the
     // lock was still granted after all, but we don't try to take advantage of that and will return
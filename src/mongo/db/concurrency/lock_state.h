@@ -254,6 +254,9 @@ public:
     virtual bool hasLockPending() const {
         return getWaitingResource().isValid();
     }
+
+    bool hasConflictingWaiters() const override;
+    bool isTicketPoolExhausted() const override;
 };
 
 typedef LockerImpl<false> DefaultLockerImpl;
@@ -387,4 +387,38 @@ TEST(LockerImpl, GetLockerInfoShouldReportPendingLocks) {
     ASSERT(conflictingLocker.unlockGlobal());
 }
 
+TEST(LockerImpl, HasConflictingWaitersReportsQueuedConflictingRequests) {
+    const ResourceId dbId(RESOURCE_DATABASE, "TestDB"_sd);
+    const ResourceId collectionId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+
+    DefaultLockerImpl reader;
+    ASSERT_EQ(LOCK_OK, reader.lockGlobal(MODE_IS));
+    ASSERT_EQ(LOCK_OK, reader.lock(dbId, MODE_IS));
+    ASSERT_EQ(LOCK_OK, reader.lock(collectionId, MODE_IS));
+    ASSERT_FALSE(reader.hasConflictingWaiters());
+
+    // A writer queues behind the reader's collection lock.
+    DefaultLockerImpl writer;
+    ASSERT_EQ(LOCK_OK, writer.lockGlobal(MODE_IX));
+    ASSERT_EQ(LOCK_OK, writer.lock(dbId, MODE_IX));
+    ASSERT_EQ(LOCK_WAITING, writer.lockBegin(collectionId, MODE_X));
+
+    ASSERT_TRUE(reader.hasConflictingWaiters());
+    // The writer's own pending request does not count against it.
+    ASSERT_FALSE(writer.hasConflictingWaiters());
+
+    ASSERT(reader.unlock(collectionId));
+
+    const Milliseconds timeout = Milliseconds(0);
+    const bool checkDeadlock = false;
+    ASSERT_EQ(LOCK_OK, writer.lockComplete(collectionId, MODE_X, timeout, checkDeadlock));
+    ASSERT_FALSE(reader.hasConflictingWaiters());
+
+    ASSERT(writer.unlock(collectionId));
+    ASSERT(writer.unlock(dbId));
+    ASSERT(writer.unlockGlobal());
+    ASSERT(reader.unlock(dbId));
+    ASSERT(reader.unlockGlobal());
+}
+
 }  // namespace mongo
@@ -315,6 +315,19 @@ public:
      */
     virtual bool hasLockPending() const = 0;
 
+    /**
+     * Returns true if another locker is queued for a lock which conflicts with one this locker
+     * holds. This is a hint for deciding whether to yield, and may be stale.
+     */
+    virtual bool hasConflictingWaiters() const = 0;
+
+    /**
+     * Returns true if the ticket pool from which this locker took its global lock ticket has no
+     * tickets left, so that new operations of the same kind must queue. This is a hint for
+     * deciding whether to yield, and may be stale.
+     */
+    virtual bool isTicketPoolExhausted() const = 0;
+
     /**
      * If set to false, this opts out of conflicting with replication's use of the
      * ParallelBatchWriterMode lock. Code that opts-out must be ok with seeing an inconsistent view
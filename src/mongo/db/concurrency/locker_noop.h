@@ -164,6 +164,14 @@ public:
         invariant(false);
     }
 
+    bool hasConflictingWaiters() const override {
+        return false;
+    }
+
+    bool isTicketPoolExhausted() const override {
+        return false;
+    }
+
     bool isGlobalLockedRecursively() override {
         return false;
     }
@@ -48,8 +48,8 @@ public:
     WriteConflictException();
 
     /**
-     * Will log a message if sensible and will do an exponential backoff to make sure
-     * we don't hammer the same doc over and over.
+     * Will log a message if sensible and will do a jittered exponential backoff to make sure
+     * we don't hammer the same doc over and over. The conflict is counted against 'ns' in Top.
      * @param attempt - what attempt is this, 1 based
      * @param operation - e.g. "update"
      */
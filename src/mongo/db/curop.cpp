@@ -42,6 +42,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/slow_op_recorder.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -53,6 +54,20 @@ using std::string;
 
 namespace {
 
+#if defined(__linux__)
+/**
+ * Returns the current reading of the thread CPU clock 'clock' in nanoseconds, or -1 if it cannot
+ * be read, as happens once the thread has exited.
+ */
+long long readCpuClock(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return -1;
+    }
+    return static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+#endif
+
 // Lists the $-prefixed query options that can be passed alongside a wrapped query predicate for
 // OP_QUERY find. The $orderby field is omitted because "orderby" (no dollar sign) is also allowed,
 // and this requires special handling.
@@ -263,9 +278,39 @@ void CurOp::setNS_inlock(StringData ns) {
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+#if defined(__linux__)
+        if (pthread_getcpuclockid(pthread_self(), &_threadCpuClock) == 0) {
+            _startCpuNanos = readCpuClock(_threadCpuClock);
+        }
+#endif
     }
 }
 
+void CurOp::done() {
+    _end = curTimeMicros64();
+#if defined(__linux__)
+    if (_startCpuNanos >= 0) {
+        _endCpuNanos = readCpuClock(_threadCpuClock);
+    }
+#endif
+}
+
+long long CurOp::cpuNanos() const {
+    if (_startCpuNanos < 0) {
+        return -1;
+    }
+    long long endCpuNanos = _endCpuNanos;
+#if defined(__linux__)
+    if (!_end) {
+        endCpuNanos = readCpuClock(_threadCpuClock);
+    }
+#endif
+    if (endCpuNanos < 0) {
+        return -1;
+    }
+    return endCpuNanos - _startCpuNanos;
+}
+
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
@@ -278,6 +323,11 @@ void CurOp::raiseDbProfileLevel(int dbProfileLevel) {
     _dbprofile = std::max(dbProfileLevel, _dbprofile);
 }
 
+bool CurOp::shouldCaptureExecStats() {
+    return shouldDBProfile() ||
+        SlowOpRecorder::shouldRecord(durationCount<Microseconds>(elapsedTimeExcludingPauses()));
+}
+
 Command::ReadWriteType CurOp::getReadWriteType() const {
     if (_command) {
         return _command->getReadWriteType();
@@ -343,6 +393,10 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
     if (_start) {
         builder->append("secs_running", durationCount<Seconds>(elapsedTimeTotal()));
         builder->append("microsecs_running", durationCount<Microseconds>(elapsedTimeTotal()));
+        const long long cpu = cpuNanos();
+        if (cpu >= 0) {
+            builder->append("cpuNanos", cpu);
+        }
     }
 
     builder->append("op", logicalOpToString(_logicalOp));
@@ -395,6 +449,11 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
     }
 
     builder->append("numYields", _numYields);
+
+    const long long blockingMemoryBytes = _blockingMemoryBytes.load();
+    if (blockingMemoryBytes > 0) {
+        builder->append("blockingMemoryBytes", blockingMemoryBytes);
+    }
 }
 
 namespace {
@@ -518,6 +577,7 @@ string OpDebug::report(Client* client,
     if (responseLength > 0) {
         s << " reslen:" << responseLength;
     }
+    OPDEBUG_TOSTRING_HELP(cpuNanos);
 
     {
         BSONObjBuilder locks;
@@ -611,6 +671,7 @@ void OpDebug::append(const CurOp& curop,
 
     OPDEBUG_APPEND_NUMBER(nreturned);
     OPDEBUG_APPEND_NUMBER(responseLength);
+    OPDEBUG_APPEND_NUMBER(cpuNanos);
     if (iscommand) {
         b.append("protocol", getProtoString(networkOp));
     }
@@ -31,6 +31,10 @@
 
 #pragma once
 
+#if defined(__linux__)
+#include <time.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
@@ -125,6 +129,7 @@ public:
 
     // response info
     long long executionTimeMicros{0};
+    long long cpuNanos{-1};  // CPU time of the executing thread, -1 if it cannot be measured
     long long nreturned{-1};
     int responseLength{-1};
 };
@@ -240,6 +245,13 @@ public:
         return elapsedTimeExcludingPauses() >= Milliseconds{serverGlobalParams.slowMS};
     }
 
+    /**
+     * Returns true if the execution stats of this operation's plan should be gathered into
+     * OpDebug, either because the operation will be profiled or because it is slow enough to be
+     * kept by the SlowOpRecorder.
+     */
+    bool shouldCaptureExecStats();
+
     /**
      * Raises the profiling level for this operation to "dbProfileLevel" if it was previously
      * less than "dbProfileLevel".
@@ -284,13 +296,20 @@ public:
         ensureStarted();
         return _start;
     }
-    void done() {
-        _end = curTimeMicros64();
-    }
+    void done();
     bool isDone() const {
         return _end > 0;
     }
 
+    /**
+     * Returns the CPU time, in nanoseconds, which the thread executing this operation has spent
+     * on it since it started, up to when it was marked done if it has been. Returns -1 if the
+     * operation has not started or the platform cannot measure per-thread CPU time.
+     *
+     * This may be called from threads other than the one executing the operation.
+     */
+    long long cpuNanos() const;
+
     /**
      * Stops the operation latency timer from "ticking". Time spent paused is not included in the
      * latencies returned by elapsedTimeExcludingPauses().
@@ -427,6 +446,18 @@ public:
         return _numYields;
     }
 
+    /**
+     * Adds 'delta' to the bytes held by the blocking stages of this operation, as reported by
+     * currentOp. May be called without the client lock.
+     */
+    void addBlockingMemoryBytes(long long delta) {
+        _blockingMemoryBytes.addAndFetch(delta);
+    }
+
+    long long blockingMemoryBytes() const {
+        return _blockingMemoryBytes.load();
+    }
+
     /**
      * this should be used very sparingly
      * generally the Context should set this up
@@ -463,6 +494,16 @@ private:
     // The time at which this CurOp instance was marked as done.
     long long _end{0};
 
+#if defined(__linux__)
+    // The CPU clock of the thread which started this CurOp.
+    clockid_t _threadCpuClock;
+#endif
+
+    // Readings of the executing thread's CPU clock when this CurOp was started and marked done,
+    // or -1 if they were not taken.
+    long long _startCpuNanos{-1};
+    long long _endCpuNanos{-1};
+
     // The time at which this CurOp instance had its timer paused, or 0 if the timer is not
     // currently paused.
     long long _lastPauseTime{0};
@@ -486,6 +527,7 @@ private:
     std::string _message;
     ProgressMeter _progressMeter;
     int _numYields{0};
+    AtomicInt64 _blockingMemoryBytes{0};
 
     std::string _planSummary;
 };
@@ -633,28 +633,21 @@ size_t CursorManager::numCursors() const {
     return _cursorMap->size();
 }
 
-CursorId CursorManager::allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        // The leading two bits of a CursorId are used to determine if the cursor is registered on
-        // the global cursor manager.
-        CursorId id;
-        if (isGlobalManager()) {
-            // This is the global cursor manager, so generate a random number and make sure the
-            // first two bits are 01.
-            uint64_t mask = 0x3FFFFFFFFFFFFFFF;
-            uint64_t bitToSet = 1ULL << 62;
-            id = ((_random->nextInt64() & mask) | bitToSet);
-        } else {
-            // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
-            // bits are random.
-            uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
-            id = cursorIdFromParts(_collectionCacheRuntimeId, myPart);
-        }
-        auto partition = _cursorMap->lockOnePartition(id);
-        if (partition->count(id) == 0)
-            return id;
-    }
-    fassertFailed(17360);
+CursorId CursorManager::generateCursorId() {
+    // The leading two bits of a CursorId are used to determine if the cursor is registered on the
+    // global cursor manager.
+    stdx::lock_guard<SimpleMutex> lock(_randomLock);
+    if (isGlobalManager()) {
+        // This is the global cursor manager, so generate a random number and make sure the first
+        // two bits are 01.
+        uint64_t mask = 0x3FFFFFFFFFFFFFFF;
+        uint64_t bitToSet = 1ULL << 62;
+        return ((_random->nextInt64() & mask) | bitToSet);
+    }
+    // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32 bits are
+    // random.
+    uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, myPart);
 }
 
 ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
@@ -669,18 +662,22 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     cursorParams.exec.get_deleter().dismissDisposal();
     cursorParams.exec->unsetRegistered();
 
-    // Note we must hold the registration lock from now until insertion into '_cursorMap' to ensure
-    // we don't insert two cursors with the same cursor id.
-    stdx::lock_guard<SimpleMutex> lock(_registrationLock);
-    CursorId cursorId = allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(new ClientCursor(
-        std::move(cursorParams), this, cursorId, opCtx->getLogicalSessionId(), now));
-
-    // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
-    ClientCursor* unownedCursor = clientCursor.release();
-    partition->emplace(cursorId, unownedCursor);
-    return ClientCursorPin(opCtx, unownedCursor);
+    // The uniqueness check and the insertion happen under the lock of the one '_cursorMap'
+    // partition the candidate id hashes to, so concurrent registrations on this manager only
+    // serialize when their ids land in the same partition.
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId = generateCursorId();
+        auto partition = _cursorMap->lockOnePartition(cursorId);
+        if (partition->count(cursorId) != 0)
+            continue;
+
+        // Transfer ownership of the cursor to '_cursorMap'.
+        ClientCursor* unownedCursor = new ClientCursor(
+            std::move(cursorParams), this, cursorId, opCtx->getLogicalSessionId(), now);
+        partition->emplace(cursorId, unownedCursor);
+        return ClientCursorPin(opCtx, unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
@@ -246,7 +246,7 @@ private:
     struct PlanExecutorPartitioner {
         std::size_t operator()(const PlanExecutor* exec, std::size_t nPartitions);
     };
-    CursorId allocateCursorId_inlock();
+    CursorId generateCursorId();
 
     ClientCursorPin _registerCursor(
         OperationContext* opCtx, std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
@@ -274,17 +274,18 @@ private:
     // There are several mutexes at work to protect concurrent access to data structures managed by
     // this cursor manager. The two registration data structures '_registeredPlanExecutors' and
     // '_cursorMap' are partitioned to decrease contention, and each partition of the structure is
-    // protected by its own mutex. Separately, there is a '_registrationLock' which protects
-    // concurrent access to '_random' for cursor id generation, and must be held from cursor id
-    // generation until insertion into '_cursorMap'. If you ever need to acquire more than one of
-    // these mutexes at once, you must follow the following rules:
-    // - '_registrationLock' must be acquired first, if at all.
-    // - Mutex(es) for '_registeredPlanExecutors' must be acquired next.
+    // protected by its own mutex. Cursor ids are checked for uniqueness and inserted into
+    // '_cursorMap' under the mutex of the single partition they belong to. Separately, there is a
+    // '_randomLock' which protects concurrent access to '_random' for cursor id generation; it is
+    // only ever held while drawing a candidate id, and never together with any other mutex. If you
+    // ever need to acquire more than one of the partition mutexes at once, you must follow the
+    // following rules:
+    // - Mutex(es) for '_registeredPlanExecutors' must be acquired first.
     // - Mutex(es) for '_cursorMap' must be acquired next.
     // - If you need to access multiple partitions within '_registeredPlanExecutors' or '_cursorMap'
     //   at once, you must acquire the mutexes for those partitions in ascending order, or use the
     //   partition helpers to acquire mutexes for all partitions.
-    mutable SimpleMutex _registrationLock;
+    mutable SimpleMutex _randomLock;
     std::unique_ptr<PseudoRandom> _random;
     Partitioned<unordered_set<PlanExecutor*>, kNumPartitions, PlanExecutorPartitioner>
         _registeredPlanExecutors;
@@ -92,6 +92,7 @@
 #include "mongo/db/op_observer_impl.h"
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/pipeline_result_cache.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -694,6 +695,7 @@ ExitCode _initAndListen(int listenPort) {
     auto opObserverRegistry = stdx::make_unique<OpObserverRegistry>();
     opObserverRegistry->addObserver(stdx::make_unique<OpObserverImpl>());
     opObserverRegistry->addObserver(stdx::make_unique<UUIDCatalogObserver>());
+    opObserverRegistry->addObserver(stdx::make_unique<PipelineResultCacheObserver>());
     serviceContext->setOpObserver(std::move(opObserverRegistry));
 
     DBDirectClientFactory::get(serviceContext).registerImplementation([](OperationContext* opCtx) {
@@ -851,6 +853,9 @@ ExitCode _initAndListen(int listenPort) {
     // Start up health log writer thread.
     HealthLog::get(startupOpCtx.get()).startup();
 
+    // Start up the writer for deferred system.profile entries.
+    startProfileWriter(serviceContext);
+
     auto const globalAuthzManager = AuthorizationManager::get(serviceContext);
     uassertStatusOK(globalAuthzManager->initialize(startupOpCtx.get()));
 
@@ -1322,6 +1327,7 @@ void shutdownTask() {
     stopMongoDFTDC();
 
     HealthLog::get(serviceContext).shutdown();
+    shutdownProfileWriter(serviceContext);
 
     // We should always be able to acquire the global lock at shutdown.
     //
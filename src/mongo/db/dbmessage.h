@@ -446,6 +446,7 @@ Message makeGetMoreMessage(StringData ns, long long cursorId, int nToReturn, int
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+    BSONObj nextInvocation;  // OP_MSG exhaust command to run next without a request, else empty.
 };
 
 /**
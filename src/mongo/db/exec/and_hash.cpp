@@ -28,10 +28,14 @@
 
 #include "mongo/db/exec/and_hash.h"
 
+#include <algorithm>
+
 #include "mongo/db/exec/and_common-inl.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -58,6 +62,7 @@ AndHashStage::AndHashStage(OperationContext* opCtx, WorkingSet* ws, const Collec
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
+      _bloomFilterBitsPerKey(std::max(0, internalQueryExecAndHashBloomFilterBitsPerKey.load())),
       _hashingChildren(true),
       _currentChild(0),
       _memUsage(0),
@@ -70,15 +75,32 @@ AndHashStage::AndHashStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
+      _bloomFilterBitsPerKey(std::max(0, internalQueryExecAndHashBloomFilterBitsPerKey.load())),
       _hashingChildren(true),
       _currentChild(0),
       _memUsage(0),
       _maxMemUsage(maxMemUsage) {}
 
 void AndHashStage::addChild(PlanStage* child) {
+    // Every child but the first produces RecordIds that are checked against the hash table, so
+    // index scans among them can discard keys that the intersection will not use.
+    if (!_children.empty() && _bloomFilterBitsPerKey > 0 && STAGE_IXSCAN == child->stageType()) {
+        static_cast<IndexScan*>(child)->setRecordIdFilter(&_bloomFilter);
+    }
     _children.emplace_back(child);
 }
 
+void AndHashStage::rebuildBloomFilter() {
+    if (0 == _bloomFilterBitsPerKey) {
+        return;
+    }
+
+    _bloomFilter.reset(_dataMap.size(), _bloomFilterBitsPerKey);
+    for (auto&& entry : _dataMap) {
+        _bloomFilter.insert(entry.first);
+    }
+}
+
 size_t AndHashStage::getMemUsage() const {
     return _memUsage;
 }
@@ -224,7 +246,9 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
-    DataMap::iterator it = _dataMap.find(member->recordId);
+    DataMap::iterator it = _bloomFilter.mayContain(member->recordId)
+        ? _dataMap.find(member->recordId)
+        : _dataMap.end();
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
         _ws->free(*out);
@@ -295,6 +319,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         }
 
         _specificStats.mapAfterChild.push_back(_dataMap.size());
+        rebuildBloomFilter();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
@@ -335,7 +360,8 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         }
 
         verify(member->hasRecordId());
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
+        if (!_bloomFilter.mayContain(member->recordId) ||
+            _dataMap.end() == _dataMap.find(member->recordId)) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
@@ -390,6 +416,10 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
             _hashingChildren = false;
         }
 
+        // The map may have shrunk considerably, so rebuild the filter to keep it selective for
+        // the remaining children.
+        rebuildBloomFilter();
+
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
         *out = id;
@@ -470,6 +500,7 @@ unique_ptr<PlanStageStats> AndHashStage::getStats() {
 
     _specificStats.memLimit = _maxMemUsage;
     _specificStats.memUsage = _memUsage;
+    _specificStats.bloomFilterRejects = _bloomFilter.numRejected();
 
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_AND_HASH);
     ret->specific = make_unique<AndHashStats>(_specificStats);
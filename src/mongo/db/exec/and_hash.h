@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bloom_filter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
@@ -49,6 +50,11 @@ namespace mongo {
  * is fetched and added to the WorkingSet as "flagged for further review."  Because this stage
  * operates with RecordIds, we are unable to evaluate the AND for the invalidated RecordId, and it
  * must be fully matched later.
+ *
+ * After each child but the last is hashed, a bloom filter is built over the RecordIds that are
+ * still candidates. RecordIds output by later children are tested against the filter before
+ * probing the hash table, and index scan children use it to skip keys before allocating a
+ * WorkingSet member for them.
  */
 class AndHashStage final : public PlanStage {
 public:
@@ -92,6 +98,11 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Rebuilds _bloomFilter from the RecordIds currently in _dataMap.
+     */
+    void rebuildBloomFilter();
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -113,6 +124,13 @@ private:
     typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
     SeenMap _seenMap;
 
+    // Contains every RecordId in _dataMap once the first child has been hashed. Later children
+    // that are index scans hold a pointer to it.
+    RecordIdBloomFilter _bloomFilter;
+
+    // The number of bits per RecordId used by _bloomFilter. Zero if the filter is disabled.
+    const size_t _bloomFilterBitsPerKey;
+
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
 
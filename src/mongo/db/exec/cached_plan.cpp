@@ -32,7 +32,9 @@
 
 #include "mongo/db/exec/cached_plan.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/scoped_timer.h"
@@ -51,6 +53,20 @@
 
 namespace mongo {
 
+namespace {
+
+// Replans because the cached plan needed more than internalQueryCacheEvictionRatio times the works
+// it was cached with, and because it failed outright.
+Counter64 replansWorksExceededCounter;
+Counter64 replansPlanFailedCounter;
+
+ServerStatusMetricField<Counter64> displayReplansWorksExceeded(
+    "query.planCache.replans.worksExceeded", &replansWorksExceededCounter);
+ServerStatusMetricField<Counter64> displayReplansPlanFailed("query.planCache.replans.planFailed",
+                                                            &replansPlanFailedCounter);
+
+}  // namespace
+
 // static
 const char* CachedPlanStage::kStageType = "CACHED_PLAN";
 
@@ -144,6 +160,7 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
                    << " planSummary: " << redact(Explain::getPlanSummary(child().get()))
                    << " status: " << redact(statusObj);
 
+            replansPlanFailedCounter.increment();
             const bool shouldCache = false;
             return replan(yieldPolicy, shouldCache);
         } else if (PlanStage::DEAD == state) {
@@ -169,6 +186,7 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
            << redact(_canonicalQuery->toStringShort())
            << " plan summary before replan: " << redact(Explain::getPlanSummary(child().get()));
 
+    replansWorksExceededCounter.increment();
     const bool shouldCache = true;
     return replan(yieldPolicy, shouldCache);
 }
@@ -39,7 +39,9 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -62,6 +64,7 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _filter(filter),
+      _groupedFilter(_filter),
       _params(params),
       _isDead(false),
       _wsidForFetch(_workingSet->allocate()) {
@@ -97,6 +100,16 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_params.shareOplogReads && !_lastSeenId.isNull() &&
+        getOpCtx()->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        bool useOwnCursor = false;
+        const StageState state = workShared(out, &useOwnCursor);
+        if (!useOwnCursor) {
+            return state;
+        }
+    }
+    _sharedEntries.clear();
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -182,7 +195,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
-        auto status = setLatestOplogEntryTimestamp(*record);
+        auto status = setLatestOplogEntryTimestamp(record->data.toBson());
         if (!status.isOK()) {
             *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
             return PlanStage::FAILURE;
@@ -198,13 +211,67 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
-Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
-    auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
+PlanStage::StageState CollectionScan::workShared(WorkingSetID* out, bool* useOwnCursor) {
+    invariant(_params.tailable);
+
+    if (_sharedEntries.empty()) {
+        std::vector<SharedOplogReader::Entry> entries;
+        bool inWindow;
+        try {
+            inWindow = SharedOplogReader::get(getOpCtx()->getServiceContext())
+                           ->getEntriesAfter(getOpCtx(), _params.collection, _lastSeenId, &entries);
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!inWindow) {
+            // We are behind the shared entries, or our position is gone from the oplog. Either
+            // way, our own cursor will find out.
+            *useOwnCursor = true;
+            return PlanStage::NEED_TIME;
+        }
+
+        if (entries.empty()) {
+            // We are tailable and have already returned data, so we will pick up where we left
+            // off on the next call to work().
+            return PlanStage::IS_EOF;
+        }
+        _sharedEntries.assign(std::make_move_iterator(entries.begin()),
+                              std::make_move_iterator(entries.end()));
+    }
+
+    SharedOplogReader::Entry entry = std::move(_sharedEntries.front());
+    _sharedEntries.pop_front();
+
+    // Our own cursor, if we have one, is no longer positioned at '_lastSeenId'.
+    _cursor.reset();
+
+    _lastSeenId = entry.id;
+    if (_params.shouldTrackLatestOplogTimestamp) {
+        auto status = setLatestOplogEntryTimestamp(entry.obj);
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            return PlanStage::FAILURE;
+        }
+    }
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = entry.id;
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), std::move(entry.obj)};
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    return returnIfMatches(member, id, out);
+}
+
+Status CollectionScan::setLatestOplogEntryTimestamp(const BSONObj& obj) {
+    auto tsElem = obj[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
         Status status(ErrorCodes::InternalError,
                       str::stream() << "CollectionScan was asked to track latest operation time, "
                                        "but found a result without a valid 'ts' field: "
-                                    << record.data.toBson().toString());
+                                    << obj.toString());
         return status;
     }
     _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, tsElem.timestamp());
@@ -216,7 +283,7 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (!_filter || Filter::passes(member, _groupedFilter)) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
         }
@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/shared_oplog_reader.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/path_grouped_matcher.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -86,11 +89,18 @@ private:
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
     /**
-     * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
+     * Extracts the timestamp from the 'ts' field of 'obj', and sets '_latestOplogEntryTimestamp'
      * to that time if it isn't already greater.  Returns an error if the 'ts' field cannot be
      * extracted.
      */
-    Status setLatestOplogEntryTimestamp(const Record& record);
+    Status setLatestOplogEntryTimestamp(const BSONObj& obj);
+
+    /**
+     * Returns the next oplog entry read through the SharedOplogReader, if '_params' asks for it
+     * and the reader can provide one. Sets 'useOwnCursor' if the entries after '_lastSeenId' must
+     * be read with '_cursor' instead.
+     */
+    StageState workShared(WorkingSetID* out, bool* useOwnCursor);
 
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
@@ -98,6 +108,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Evaluates '_filter' against fetched documents. Must be declared after '_filter'.
+    const PathGroupedMatcher _groupedFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -111,6 +124,9 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Entries handed to us by the SharedOplogReader which we have not returned yet.
+    std::deque<SharedOplogReader::Entry> _sharedEntries;
+
     // We allocate a working set member with this id on construction of the stage. It gets used for
     // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
     // should remain in the INVALID state.
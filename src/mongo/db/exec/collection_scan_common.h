@@ -67,6 +67,10 @@ struct CollectionScanParams {
     // This is useful for oplog queries where we know we will see records ordered by the ts field.
     bool stopApplyingFilterAfterFirstMatch = false;
 
+    // Should a tailable scan of the oplog read new entries through the SharedOplogReader? This is
+    // only done while reading from the majority committed snapshot.
+    bool shareOplogReads = false;
+
     // If non-zero, how many documents will we look at?
     size_t maxScan = 0;
 };
@@ -88,11 +88,26 @@ CountScan::CountScan(OperationContext* opCtx, const CountScanParams& params, Wor
     _specificStats.isSparse = _params.descriptor->isSparse();
     _specificStats.isPartial = _params.descriptor->isPartial();
     _specificStats.indexVersion = static_cast<int>(_params.descriptor->version());
-
-    // endKey must be after startKey in index order since we only do forward scans.
-    dassert(_params.startKey.woCompare(_params.endKey,
-                                       Ordering::make(params.descriptor->keyPattern()),
-                                       /*compareFieldNames*/ false) <= 0);
+    _specificStats.numKeyRanges = 1 + _params.additionalRanges.size();
+
+    IndexKeyRange firstRange;
+    firstRange.startKey = _params.startKey;
+    firstRange.startKeyInclusive = _params.startKeyInclusive;
+    firstRange.endKey = _params.endKey;
+    firstRange.endKeyInclusive = _params.endKeyInclusive;
+    _ranges.push_back(std::move(firstRange));
+    _ranges.insert(_ranges.end(), _params.additionalRanges.begin(), _params.additionalRanges.end());
+
+    // Each endKey must be after its startKey in index order since we only do forward scans, and
+    // each range must start after the previous one ends.
+    const Ordering ordering = Ordering::make(params.descriptor->keyPattern());
+    for (size_t i = 0; i < _ranges.size(); ++i) {
+        dassert(_ranges[i].startKey.woCompare(
+                    _ranges[i].endKey, ordering, /*compareFieldNames*/ false) <= 0);
+        dassert(i == 0 ||
+                _ranges[i - 1].endKey.woCompare(
+                    _ranges[i].startKey, ordering, /*compareFieldNames*/ false) <= 0);
+    }
 }
 
 
@@ -109,9 +124,14 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         if (needInit) {
             // First call to work().  Perform cursor init.
             _cursor = _iam->newCursor(getOpCtx());
-            _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
+        }
 
-            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, kWantLoc);
+        if (_needSeek) {
+            // Position the cursor at the start of the current range.
+            const IndexKeyRange& range = _ranges[_currentRange];
+            _cursor->setEndPosition(range.endKey, range.endKeyInclusive);
+            entry = _cursor->seek(range.startKey, range.startKeyInclusive, kWantLoc);
+            _needSeek = false;
         } else {
             entry = _cursor->next(kWantLoc);
         }
@@ -127,6 +147,13 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     ++_specificStats.keysExamined;
 
     if (!entry) {
+        if (++_currentRange < _ranges.size()) {
+            // Move on to the next range. We keep '_returned' so that a document with keys in more
+            // than one range is counted once.
+            _needSeek = true;
+            return PlanStage::NEED_TIME;
+        }
+
         _commonStats.isEOF = true;
         _cursor.reset();
         return PlanStage::IS_EOF;
@@ -192,10 +219,12 @@ unique_ptr<PlanStageStats> CountScan::getStats() {
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
     countStats->keyPattern = _specificStats.keyPattern.getOwned();
 
-    countStats->startKey = replaceBSONFieldNames(_params.startKey, countStats->keyPattern);
-    countStats->startKeyInclusive = _params.startKeyInclusive;
-    countStats->endKey = replaceBSONFieldNames(_params.endKey, countStats->keyPattern);
-    countStats->endKeyInclusive = _params.endKeyInclusive;
+    const IndexKeyRange& firstRange = _ranges.front();
+    const IndexKeyRange& lastRange = _ranges.back();
+    countStats->startKey = replaceBSONFieldNames(firstRange.startKey, countStats->keyPattern);
+    countStats->startKeyInclusive = firstRange.startKeyInclusive;
+    countStats->endKey = replaceBSONFieldNames(lastRange.endKey, countStats->keyPattern);
+    countStats->endKeyInclusive = lastRange.endKeyInclusive;
 
     ret->specific = std::move(countStats);
 
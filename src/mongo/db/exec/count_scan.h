@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
 
@@ -54,10 +55,16 @@ struct CountScanParams {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // Further key ranges to count after [startKey, endKey], in index order. Every range must lie
+    // after the one before it, and none may overlap. Used when the predicate has several
+    // intervals, as {a: {$in: [...]}} does.
+    std::vector<IndexKeyRange> additionalRanges;
 };
 
 /**
- * Used by the count command. Scans an index from a start key to an end key. Creates a
+ * Used by the count command. Scans an index from a start key to an end key, and then over each of
+ * the additional key ranges in turn, if there are any. Creates a
  * WorkingSetMember for each matching index key in RID_AND_OBJ state. It has a null record id and an
  * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
  * since all we need is the count.
@@ -97,6 +104,12 @@ private:
 
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
+    // The key ranges to count, and which of them '_cursor' is positioned in. If '_needSeek' is
+    // set, the cursor must first seek to the start of the current range.
+    std::vector<IndexKeyRange> _ranges;
+    size_t _currentRange = 0;
+    bool _needSeek = true;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     unordered_set<RecordId, RecordId::Hasher> _returned;
@@ -185,8 +185,9 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
 
     if (!docStillMatches) {
         // Either the document has already been deleted, or it has been updated such that it no
-        // longer matches the predicate.
-        if (shouldRestartDeleteIfNoLongerMatches(_params)) {
+        // longer matches the predicate. If the child can still produce documents, the next one is
+        // the next candidate in sort order, so there is no need to restart.
+        if (shouldRestartDeleteIfNoLongerMatches(_params) && child()->isEOF()) {
             throw WriteConflictException();
         }
         return PlanStage::NEED_TIME;
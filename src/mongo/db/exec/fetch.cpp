@@ -30,11 +30,14 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -58,7 +61,12 @@ FetchStage::FetchStage(OperationContext* opCtx,
       _collection(collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _groupedFilter(_filter),
+      _idRetrying(WorkingSet::INVALID_ID),
+      _batchSize(std::max(1, internalQueryExecFetchBatchSize.load())),
+      _windowFull(false),
+      _nextFetch(0),
+      _nextReturn(0) {
     _children.emplace_back(child);
 }
 
@@ -71,6 +79,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    // We still have buffered results to fetch or return.
+    if (!_window.empty()) {
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -79,6 +92,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_windowFull) {
+        return workWindow(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -90,7 +107,26 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         _idRetrying = WorkingSet::INVALID_ID;
     }
 
-    if (PlanStage::ADVANCED == status) {
+    if (PlanStage::ADVANCED == status && _batchSize > 1) {
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasObj()) {
+            ++_specificStats.alreadyHasObj;
+        } else {
+            verify(WorkingSetMember::RID_AND_IDX == member->getState());
+            verify(member->hasRecordId());
+            _fetchOrder.push_back(_window.size());
+        }
+        _window.push_back(id);
+
+        if (_window.size() >= _batchSize) {
+            startFetchingWindow();
+        }
+        return NEED_TIME;
+    } else if (PlanStage::IS_EOF == status && !_window.empty()) {
+        // Fetch and return what we have buffered before reporting EOF.
+        startFetchingWindow();
+        return NEED_TIME;
+    } else if (PlanStage::ADVANCED == status) {
         WorkingSetMember* member = _ws->get(id);
 
         // If there's an obj there, there is no fetching to perform.
@@ -150,6 +186,74 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+void FetchStage::startFetchingWindow() {
+    std::sort(_fetchOrder.begin(), _fetchOrder.end(), [this](size_t lhs, size_t rhs) {
+        return _ws->get(_window[lhs])->recordId < _ws->get(_window[rhs])->recordId;
+    });
+    _nextFetch = 0;
+    _nextReturn = 0;
+    _windowFull = true;
+}
+
+PlanStage::StageState FetchStage::workWindow(WorkingSetID* out) {
+    // First fetch, in RecordId order, every member that needs it.
+    if (_nextFetch < _fetchOrder.size()) {
+        const size_t pos = _fetchOrder[_nextFetch];
+        const WorkingSetID id = _window[pos];
+        WorkingSetMember* member = _ws->get(id);
+
+        // An invalidation may have fetched the document already.
+        if (member->hasObj()) {
+            ++_nextFetch;
+            return NEED_TIME;
+        }
+
+        try {
+            if (!_cursor)
+                _cursor = _collection->getCursor(getOpCtx());
+
+            if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
+                // There's something to fetch. Hand the fetcher off to the WSM, and pass up a
+                // fetch request. We retry this member when we are called again.
+                member->setFetcher(fetcher.release());
+                *out = id;
+                return NEED_YIELD;
+            }
+
+            if (WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                // The object points into the cursor, which the next fetch will reposition.
+                member->makeObjOwnedIfNeeded();
+            } else {
+                _ws->free(id);
+                _window[pos] = WorkingSet::INVALID_ID;
+            }
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        ++_nextFetch;
+        return NEED_TIME;
+    }
+
+    // Then return the window in the order our child produced it.
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    while (WorkingSet::INVALID_ID == id && _nextReturn < _window.size()) {
+        id = _window[_nextReturn++];
+    }
+
+    if (_nextReturn == _window.size()) {
+        _window.clear();
+        _fetchOrder.clear();
+        _windowFull = false;
+    }
+
+    if (WorkingSet::INVALID_ID == id) {
+        return NEED_TIME;
+    }
+    return returnIfMatches(_ws->get(id), id, out);
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
@@ -180,6 +284,18 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    // The same goes for the members of our window that we have not returned yet.
+    for (size_t i = _nextReturn; i < _window.size(); ++i) {
+        if (WorkingSet::INVALID_ID == _window[i]) {
+            continue;
+        }
+        WorkingSetMember* member = _ws->get(_window[i]);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+            ++_specificStats.forcedFetches;
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -201,7 +317,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _groupedFilter)) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
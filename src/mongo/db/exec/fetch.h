@@ -29,10 +29,12 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/path_grouped_matcher.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -45,6 +47,11 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * If internalQueryExecFetchBatchSize is greater than one, the stage collects that many results
+ * from its child, fetches the ones that need it in RecordId order so that the reads are close
+ * together in the record store, and then returns all of them in the order the child produced
+ * them.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public PlanStage {
@@ -83,6 +90,18 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Sorts the positions of the window members that need a fetch by RecordId, and switches from
+     * filling the window to fetching it.
+     */
+    void startFetchingWindow();
+
+    /**
+     * Does one unit of work on a full window: fetches the next member in RecordId order, or once
+     * all are fetched, returns the next member in the child's order.
+     */
+    StageState workWindow(WorkingSetID* out);
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -95,9 +114,32 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Evaluates '_filter' against fetched documents. Must be declared after '_filter'.
+    const PathGroupedMatcher _groupedFilter;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // How many results we collect from the child before fetching them. 1 means we fetch each
+    // result as soon as the child produces it.
+    const size_t _batchSize;
+
+    // Results from the child, in the order it produced them. Members that were freed because
+    // their document is gone are replaced by INVALID_ID.
+    std::vector<WorkingSetID> _window;
+
+    // True once _window is full, or the child is EOF, and we are fetching or returning it.
+    bool _windowFull;
+
+    // Positions in _window of the members that need to be fetched, sorted by RecordId.
+    std::vector<size_t> _fetchOrder;
+
+    // The next position in _fetchOrder to fetch.
+    size_t _nextFetch;
+
+    // The next position in _window to return.
+    size_t _nextReturn;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -31,6 +31,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
+#include "mongo/db/matcher/path_grouped_matcher.h"
 
 namespace mongo {
 
@@ -157,6 +158,17 @@ public:
         return filter->matches(&doc, NULL);
     }
 
+    /**
+     * Like passes(wsm, matcher.getFilter()), but when 'wsm' has its full document the conjuncts of
+     * the filter that share a first field resolve it only once.
+     */
+    static bool passes(WorkingSetMember* wsm, const PathGroupedMatcher& matcher) {
+        if (wsm->hasObj()) {
+            return matcher.matchesBSON(wsm->obj.value());
+        }
+        return passes(wsm, matcher.getFilter());
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
@@ -37,8 +37,10 @@
 // For s2 search
 #include "third_party/s2/s2regionintersection.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/working_set_computed_data.h"
@@ -50,9 +52,12 @@
 #include "mongo/db/query/expression_index.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/lru_cache.h"
 
 #include <algorithm>
+#include <boost/functional/hash.hpp>
 
 namespace mongo {
 
@@ -843,6 +848,103 @@ S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Takes ownership of caps
     return new S2RegionIntersection(&regions);
 }
+
+Counter64 coveringCacheHits;
+ServerStatusMetricField<Counter64> displayCoveringCacheHits("query.geoNear.coveringCache.hits",
+                                                            &coveringCacheHits);
+Counter64 coveringCacheMisses;
+ServerStatusMetricField<Counter64> displayCoveringCacheMisses(
+    "query.geoNear.coveringCache.misses", &coveringCacheMisses);
+
+/**
+ * Identifies the covering of a 2dsphere $geoNear annulus: the annulus itself and the coverer
+ * settings that were in effect when the covering was computed.
+ */
+struct AnnulusCoveringKey {
+    AnnulusCoveringKey(const R2Annulus& annulus)
+        : centerX(annulus.center().x),
+          centerY(annulus.center().y),
+          inner(annulus.getInner()),
+          outer(annulus.getOuter()),
+          minLevel(internalQueryS2GeoCoarsestLevel.load()),
+          maxLevel(internalQueryS2GeoFinestLevel.load()),
+          maxCells(internalQueryS2GeoMaxCells.load()) {}
+
+    bool operator==(const AnnulusCoveringKey& other) const {
+        return centerX == other.centerX && centerY == other.centerY && inner == other.inner &&
+            outer == other.outer && minLevel == other.minLevel && maxLevel == other.maxLevel &&
+            maxCells == other.maxCells;
+    }
+
+    struct Hasher {
+        size_t operator()(const AnnulusCoveringKey& key) const {
+            size_t seed = 0;
+            boost::hash_combine(seed, key.centerX);
+            boost::hash_combine(seed, key.centerY);
+            boost::hash_combine(seed, key.inner);
+            boost::hash_combine(seed, key.outer);
+            boost::hash_combine(seed, key.minLevel);
+            boost::hash_combine(seed, key.maxLevel);
+            boost::hash_combine(seed, key.maxCells);
+            return seed;
+        }
+    };
+
+    double centerX;
+    double centerY;
+    double inner;
+    double outer;
+    int minLevel;
+    int maxLevel;
+    int maxCells;
+};
+
+/**
+ * A process-wide cache of annulus coverings. Repeated nearest-neighbor searches around the same
+ * point expand through the same sequence of annuli, so they can reuse the coverings instead of
+ * running the S2RegionCoverer again for each one.
+ */
+class AnnulusCoveringCache {
+public:
+    using Covering = std::vector<S2CellId>;
+
+    explicit AnnulusCoveringCache(size_t maxSize) : _enabled(maxSize > 0), _coverings(maxSize) {}
+
+    Covering getCovering(const R2Annulus& annulus, const S2Region& region) {
+        if (!_enabled) {
+            return ExpressionMapping::get2dsphereCovering(region);
+        }
+
+        AnnulusCoveringKey key(annulus);
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto it = _coverings.find(key);
+            if (it != _coverings.end()) {
+                coveringCacheHits.increment();
+                return it->second;
+            }
+        }
+
+        coveringCacheMisses.increment();
+        auto covering = ExpressionMapping::get2dsphereCovering(region);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _coverings.add(key, covering);
+        return covering;
+    }
+
+private:
+    const bool _enabled;
+
+    stdx::mutex _mutex;
+    LRUCache<AnnulusCoveringKey, Covering, AnnulusCoveringKey::Hasher> _coverings;
+};
+
+AnnulusCoveringCache::Covering getAnnulusCovering(const R2Annulus& annulus,
+                                                  const S2Region& region) {
+    static AnnulusCoveringCache cache(std::max(internalQueryS2GeoNearCoveringCacheSize, 0));
+    return cache.getCovering(annulus, region);
+}
 }
 
 // Estimate the density of data by search the nearest cells level by level around center.
@@ -1079,7 +1181,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     scanParams.bounds.fields[s2FieldPosition].intervals.clear();
     std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
 
-    std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
+    std::vector<S2CellId> cover = getAnnulusCovering(_currBounds, *region);
 
     // Generate a covering that does not intersect with any previous coverings
     S2CellUnion coverUnion;
@@ -30,6 +30,9 @@
 
 #include "mongo/db/exec/idhack.h"
 
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -38,8 +41,11 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/query/indexability.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -65,6 +71,20 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
     _specificStats.indexName = descriptor->indexName();
     _accessMethod = catalog->getIndex(descriptor);
 
+    const BSONObj& filter = query->getQueryRequest().getFilter();
+    if (isSimpleIdInQuery(filter)) {
+        for (auto&& elt : filter["_id"].Obj()["$in"].Obj()) {
+            _keys.push_back(elt.wrap("_id"));
+        }
+
+        // Looking the _ids up in key order keeps the walk over the _id index local.
+        std::sort(_keys.begin(), _keys.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+        _keys.erase(std::unique(_keys.begin(),
+                                _keys.end(),
+                                SimpleBSONObjComparator::kInstance.makeEqualTo()),
+                    _keys.end());
+    }
+
     if (NULL != query->getProj()) {
         _addKeyMetadata = query->getProj()->wantIndexKey();
     } else {
@@ -117,7 +137,10 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
         return advance(id, member, out);
     }
 
-    WorkingSetID id = WorkingSet::INVALID_ID;
+    if (!_keys.empty()) {
+        return doWorkBatched(out);
+    }
+
     try {
         // Look up the key by going directly to the index.
         RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
@@ -129,6 +152,93 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
         }
 
         ++_specificStats.keysExamined;
+
+        const StageState state = fetchRecord(recordId, out);
+        if (PlanStage::NEED_TIME == state) {
+            // _id is immutable so the index would return the only record that could
+            // possibly match the query.
+            _commonStats.isEOF = true;
+            _done = true;
+            return IS_EOF;
+        }
+        return state;
+    } catch (const WriteConflictException&) {
+        // Restart at the beginning on retry.
+        _recordCursor.reset();
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+}
+
+PlanStage::StageState IDHackStage::doWorkBatched(WorkingSetID* out) {
+    if (!_lookupsResolved) {
+        std::vector<PendingLookup> lookups;
+        try {
+            for (const auto& key : _keys) {
+                RecordId recordId = _accessMethod->findSingle(getOpCtx(), key);
+                if (!recordId.isNull()) {
+                    lookups.push_back({recordId, key});
+                }
+            }
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        _specificStats.keysExamined += lookups.size();
+
+        // Fetching in RecordId order visits the record store in storage order.
+        std::sort(lookups.begin(),
+                  lookups.end(),
+                  [](const PendingLookup& lhs, const PendingLookup& rhs) {
+                      return lhs.recordId < rhs.recordId;
+                  });
+        lookups.erase(std::unique(lookups.begin(),
+                                  lookups.end(),
+                                  [](const PendingLookup& lhs, const PendingLookup& rhs) {
+                                      return lhs.recordId == rhs.recordId;
+                                  }),
+                      lookups.end());
+
+        _lookups = std::move(lookups);
+        _lookupsResolved = true;
+        return NEED_TIME;
+    }
+
+    if (_nextLookup >= _lookups.size()) {
+        _done = true;
+        return IS_EOF;
+    }
+
+    RecordId recordId = _lookups[_nextLookup].recordId;
+    if (recordId.isNull()) {
+        // The record was invalidated since the _id was looked up. Since _id is immutable, looking
+        // the _id up again finds the document wherever it is now, if it still exists.
+        try {
+            recordId = _accessMethod->findSingle(getOpCtx(), _lookups[_nextLookup].key);
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (recordId.isNull()) {
+            ++_nextLookup;
+            return NEED_TIME;
+        }
+    }
+
+    ++_nextLookup;
+    const StageState state = fetchRecord(recordId, out);
+    if (PlanStage::NEED_YIELD == state && WorkingSet::INVALID_ID == _idBeingPagedIn) {
+        // A write conflict, retry the same _id.
+        --_nextLookup;
+    }
+    return state;
+}
+
+PlanStage::StageState IDHackStage::fetchRecord(const RecordId& recordId, WorkingSetID* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    try {
         ++_specificStats.docsExamined;
 
         // Create a new WSM for the result document.
@@ -152,12 +262,9 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
 
         // The doc was already in memory, so we go ahead and return it.
         if (!WorkingSetCommon::fetch(getOpCtx(), _workingSet, id, _recordCursor)) {
-            // _id is immutable so the index would return the only record that could
-            // possibly match the query.
+            // The record no longer exists.
             _workingSet->free(id);
-            _commonStats.isEOF = true;
-            _done = true;
-            return IS_EOF;
+            return NEED_TIME;
         }
 
         return advance(id, member, out);
@@ -184,7 +291,7 @@ PlanStage::StageState IDHackStage::advance(WorkingSetID id,
         member->addComputed(new IndexKeyComputedData(bob.obj()));
     }
 
-    _done = true;
+    _done = _keys.empty() || _nextLookup >= _lookups.size();
     *out = id;
     return PlanStage::ADVANCED;
 }
@@ -224,15 +331,73 @@ void IDHackStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inva
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    // A pending _id whose record is deleted, or moved by an update, is looked up again when its
+    // turn comes.
+    auto pending = std::lower_bound(_lookups.begin() + _nextLookup,
+                                    _lookups.end(),
+                                    dl,
+                                    [](const PendingLookup& lookup, const RecordId& recordId) {
+                                        return lookup.recordId < recordId;
+                                    });
+    if (pending != _lookups.end() && pending->recordId == dl) {
+        pending->recordId = RecordId();
+    }
 }
 
 // static
 bool IDHackStage::supportsQuery(Collection* collection, const CanonicalQuery& query) {
-    return !query.getQueryRequest().showRecordId() && query.getQueryRequest().getHint().isEmpty() &&
-        !query.getQueryRequest().getSkip() &&
-        CanonicalQuery::isSimpleIdQuery(query.getQueryRequest().getFilter()) &&
-        !query.getQueryRequest().isTailable() &&
-        CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.showRecordId() || !qr.getHint().isEmpty() || qr.getSkip() || qr.isTailable() ||
+        !CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator())) {
+        return false;
+    }
+
+    if (CanonicalQuery::isSimpleIdQuery(qr.getFilter())) {
+        return true;
+    }
+
+    // A batch of _ids may return several documents, which this stage neither sorts nor limits.
+    return isSimpleIdInQuery(qr.getFilter()) && qr.getSort().isEmpty() && !qr.getLimit() &&
+        !qr.getNToReturn() && qr.getMin().isEmpty() && qr.getMax().isEmpty() &&
+        qr.getFilter()["_id"].Obj()["$in"].Obj().nFields() <=
+        internalQueryMaxBatchedIdHackKeys.load();
+}
+
+// static
+bool IDHackStage::isSimpleIdInQuery(const BSONObj& query) {
+    if (query.nFields() != 1) {
+        return false;
+    }
+
+    BSONElement idElt = query.firstElement();
+    if (!str::equals("_id", idElt.fieldName()) || idElt.type() != Object) {
+        return false;
+    }
+
+    BSONObj predicate = idElt.Obj();
+    if (predicate.nFields() != 1 || !str::equals("$in", predicate.firstElementFieldName()) ||
+        predicate.firstElement().type() != Array) {
+        return false;
+    }
+
+    BSONObj inList = predicate.firstElement().Obj();
+    if (inList.isEmpty()) {
+        return false;
+    }
+
+    // The same values as a simple _id equality: exact values, and literal objects.
+    for (auto&& elt : inList) {
+        if (elt.type() == Object) {
+            if (elt.Obj().firstElementFieldName()[0] == '$') {
+                return false;
+            }
+        } else if (!Indexability::isExactBoundsGenerating(elt)) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 unique_ptr<PlanStageStats> IDHackStage::getStats() {
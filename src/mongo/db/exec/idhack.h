@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -44,6 +45,10 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * Besides a single _id equality, the stage answers {_id: {$in: [...]}} queries in batch: it looks
+ * up every _id in the _id index first, in key order, and then fetches the documents in RecordId
+ * order through a single record cursor.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -76,6 +81,12 @@ public:
      */
     static bool supportsQuery(Collection* collection, const CanonicalQuery& query);
 
+    /**
+     * Returns true if 'query' is of the form {_id: {$in: [...]}}, where every element of the $in
+     * list is a value which the _id index can look up exactly.
+     */
+    static bool isSimpleIdInQuery(const BSONObj& query);
+
     StageType stageType() const final {
         return STAGE_IDHACK;
     }
@@ -94,6 +105,24 @@ private:
      */
     StageState advance(WorkingSetID id, WorkingSetMember* member, WorkingSetID* out);
 
+    /**
+     * doWork() for a batch of _ids. Resolves all of the _ids to RecordIds on the first call, then
+     * returns one document per call.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Allocates a WSM for 'recordId' and fetches its document, or asks for a yield to page it in.
+     */
+    StageState fetchRecord(const RecordId& recordId, WorkingSetID* out);
+
+    // An _id waiting to be fetched in batched mode. 'recordId' is null if the record it referred
+    // to was invalidated, in which case the _id is looked up again before fetching.
+    struct PendingLookup {
+        RecordId recordId;
+        BSONObj key;
+    };
+
     // Not owned here.
     const Collection* _collection;
 
@@ -108,7 +137,16 @@ private:
     // The value to match against the _id field.
     BSONObj _key;
 
-    // Have we returned our one document?
+    // In batched mode, the values of the $in list to match against the _id field.
+    std::vector<BSONObj> _keys;
+
+    // In batched mode, the _ids found in the index sorted by RecordId, and the next one to fetch.
+    // '_lookupsResolved' is false until the index lookups have been done.
+    std::vector<PendingLookup> _lookups;
+    size_t _nextLookup = 0;
+    bool _lookupsResolved = false;
+
+    // Have we returned our one document, or in batched mode, all of them?
     bool _done;
 
     // Do we need to add index key metadata for returnKey?
@@ -43,6 +43,7 @@ namespace mongo {
 
 class IndexAccessMethod;
 class IndexDescriptor;
+class RecordIdBloomFilter;
 class WorkingSet;
 
 struct IndexScanParams {
@@ -107,6 +108,15 @@ public:
         return STAGE_IXSCAN;
     }
 
+    /**
+     * Makes the scan skip any key whose RecordId is rejected by 'filter', before a WorkingSet
+     * member is allocated for it. Used by a parent stage that already knows which RecordIds it
+     * can use. 'filter' is not owned and must outlive this stage's calls to work().
+     */
+    void setRecordIdFilter(const RecordIdBloomFilter* filter) {
+        _recordIdFilter = filter;
+    }
+
     std::unique_ptr<PlanStageStats> getStats() final;
 
     const SpecificStats* getSpecificStats() const final;
@@ -135,6 +145,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* const _filter;
 
+    // If set, keys whose RecordIds are rejected by this filter are skipped. Not owned by us.
+    const RecordIdBloomFilter* _recordIdFilter = nullptr;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     unordered_set<RecordId, RecordId::Hasher> _returned;
@@ -35,10 +35,12 @@
 #include <algorithm>
 #include <math.h>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -49,9 +51,25 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+Counter64 multiPlannedCounter;
+Counter64 trialWorksCounter;
+Counter64 planningMicrosCounter;
+
+ServerStatusMetricField<Counter64> displayMultiPlanned("query.planning.multiPlanned",
+                                                       &multiPlannedCounter);
+ServerStatusMetricField<Counter64> displayTrialWorks("query.planning.trialWorks",
+                                                     &trialWorksCounter);
+ServerStatusMetricField<Counter64> displayPlanningMicros("query.planning.planningMicros",
+                                                         &planningMicrosCounter);
+
+}  // namespace
+
 using std::endl;
 using std::list;
 using std::unique_ptr;
@@ -204,10 +222,17 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    Timer planningTimer;
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // When racing, periodically stop working the candidates which are clearly losing.
+    const double raceMargin = internalQueryPlanEvaluationRaceMargin.load();
+    const size_t raceInterval =
+        static_cast<size_t>(std::max(1, internalQueryPlanEvaluationRaceInterval.load()));
+    const bool racing = raceMargin > 0 && _candidates.size() > 1;
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
     for (size_t ix = 0; ix < numWorks; ++ix) {
@@ -215,6 +240,10 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+
+        if (racing && (ix + 1) % raceInterval == 0 && !raceCandidates(raceMargin)) {
+            break;
+        }
     }
 
     if (_failure) {
@@ -229,6 +258,13 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, ranking.get());
     verify(_bestPlanIdx >= 0 && _bestPlanIdx < static_cast<int>(_candidates.size()));
 
+    ranking->planningTime = Microseconds(planningTimer.micros());
+    multiPlannedCounter.increment();
+    planningMicrosCounter.increment(planningTimer.micros());
+    for (auto&& candidateStats : ranking->stats) {
+        trialWorksCounter.increment(candidateStats->common.works);
+    }
+
     // Copy candidate order. We will need this to sort candidate stats for explain
     // after transferring ownership of 'ranking' to plan cache.
     std::vector<size_t> candidateOrder = ranking->candidateOrder;
@@ -340,7 +376,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.eliminated) {
             continue;
         }
 
@@ -408,6 +444,42 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::raceCandidates(double margin) {
+    std::vector<std::pair<size_t, double>> scores;
+    double bestScore = 0;
+    size_t numRemaining = 0;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const CandidatePlan& candidate = _candidates[ix];
+        if (candidate.failed || candidate.eliminated) {
+            continue;
+        }
+
+        // A plan with a blocking stage produces nothing until its input is exhausted, so its
+        // score early in the trial period says little about how it will do.
+        if (candidate.solution->hasBlockingStage) {
+            ++numRemaining;
+            continue;
+        }
+
+        const double score = PlanRanker::scoreTree(candidate.root->getStats().get());
+        bestScore = std::max(bestScore, score);
+        scores.emplace_back(ix, score);
+    }
+
+    for (const auto& score : scores) {
+        if (bestScore - score.second > margin) {
+            LOG(2) << "Eliminating query plan from trial period: "
+                   << redact(Explain::getPlanSummary(_candidates[score.first].root))
+                   << " score=" << score.second << " leaderScore=" << bestScore;
+            _candidates[score.first].eliminated = true;
+        } else {
+            ++numRemaining;
+        }
+    }
+
+    return numRemaining > 1;
+}
+
 namespace {
 
 void invalidateHelper(OperationContext* opCtx,
@@ -168,6 +168,14 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Scores the candidates which are still being worked and eliminates those whose score trails
+     * the leader's by more than 'margin'.
+     *
+     * Returns true if more than one candidate remains, and false if the trial period can stop.
+     */
+    bool raceCandidates(double margin);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -56,6 +56,35 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* out,
+                                           WorkingSetID* last) {
+    invariant(_opCtx);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+
+    for (size_t works = 0; works < maxWorks; ++works) {
+        ++_commonStats.works;
+
+        *last = WorkingSet::INVALID_ID;
+        StageState workResult = doWork(last);
+
+        if (StageState::ADVANCED == workResult) {
+            ++_commonStats.advanced;
+            out->push_back(*last);
+            *last = WorkingSet::INVALID_ID;
+        } else if (StageState::NEED_TIME == workResult) {
+            ++_commonStats.needTime;
+        } else {
+            if (StageState::NEED_YIELD == workResult) {
+                ++_commonStats.needYield;
+            }
+            return workResult;
+        }
+    }
+
+    return StageState::NEED_TIME;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -188,6 +188,20 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Performs up to 'maxWorks' units of work on the query, appending the id of every result
+     * produced along the way to 'out'. This lets a caller draining many results from a stage
+     * tree pay for the per-call bookkeeping (execution timing, result plumbing, yield checks)
+     * once per batch rather than once per result.
+     *
+     * Returns NEED_TIME if all 'maxWorks' units of work were performed; 'out' may or may not have
+     * had results appended. Otherwise stops at the first unit of work which returned IS_EOF,
+     * NEED_YIELD, DEAD or FAILURE and returns that state, with *last set exactly as work() would
+     * have set its out parameter. Ids already appended to 'out' remain valid results which the
+     * caller must consume or free, and should be consumed before acting on the returned state.
+     */
+    StageState workBatch(size_t maxWorks, std::vector<WorkingSetID>* out, WorkingSetID* last);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
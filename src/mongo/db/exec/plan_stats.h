@@ -138,7 +138,12 @@ private:
 };
 
 struct AndHashStats : public SpecificStats {
-    AndHashStats() : flaggedButPassed(0), flaggedInProgress(0), memUsage(0), memLimit(0) {}
+    AndHashStats()
+        : flaggedButPassed(0),
+          flaggedInProgress(0),
+          memUsage(0),
+          memLimit(0),
+          bloomFilterRejects(0) {}
 
     SpecificStats* clone() const final {
         AndHashStats* specific = new AndHashStats(*this);
@@ -165,6 +170,10 @@ struct AndHashStats : public SpecificStats {
 
     // What's our memory limit?
     size_t memLimit;
+
+    // How many RecordIds from children after the first were discarded by the bloom filter,
+    // including keys skipped by index scan children?
+    size_t bloomFilterRejects;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -238,6 +247,7 @@ struct CountScanStats : public SpecificStats {
           isPartial(false),
           isSparse(false),
           isUnique(false),
+          numKeyRanges(1),
           keysExamined(0) {}
 
     SpecificStats* clone() const final {
@@ -265,6 +275,10 @@ struct CountScanStats : public SpecificStats {
     bool startKeyInclusive;
     bool endKeyInclusive;
 
+    // The number of disjoint key ranges counted. If there is more than one, startKey is the start
+    // of the first range and endKey is the end of the last.
+    size_t numKeyRanges;
+
     int indexVersion;
 
     // Set to true if the index used for the count scan is multikey.
@@ -513,7 +527,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -534,6 +548,9 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // Did we spill buffered results to an external sort on disk?
+    bool usedDisk;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -73,6 +73,12 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
 
         // Figure out what fields are in the projection.
         getSimpleInclusionFields(_projObj, &_includedFields);
+        for (auto&& includedField : _includedFields) {
+            if (includedField.first.find('.') != std::string::npos) {
+                getNestedInclusionTree(_projObj, &_includedPaths);
+                break;
+            }
+        }
 
         // If we're pulling data out of one index we can pre-compute the indices of the fields
         // in the key that we pull data from and avoid looking up the field name each time.
@@ -96,6 +102,8 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
                     _includeKey.push_back(true);
                 }
             }
+            // The key field names are dotted paths rather than a tree of subfields.
+            invariant(_includedPaths.empty());
         } else {
             invariant(ProjectionStageParams::SIMPLE_DOC == params.projImpl);
         }
@@ -142,6 +150,121 @@ void ProjectionStage::transformSimpleInclusion(const BSONObj& in,
     }
 }
 
+namespace {
+
+void appendNestedInclusion(const BSONObj& in,
+                           const ProjectionStage::InclusionTree& includedPaths,
+                           size_t node,
+                           BSONObjBuilder& bob);
+
+/**
+ * Applies the subtree rooted at 'node' to each element of the array 'in'. Documents, including
+ * those inside nested arrays, are projected; other values hold none of the included subfields
+ * and are dropped.
+ */
+void appendNestedInclusionToArray(const BSONObj& in,
+                                  const ProjectionStage::InclusionTree& includedPaths,
+                                  size_t node,
+                                  BSONArrayBuilder& bab) {
+    BSONObjIterator inputIt(in);
+    while (inputIt.more()) {
+        BSONElement elt = inputIt.next();
+        if (Object == elt.type()) {
+            BSONObjBuilder subBob(bab.subobjStart());
+            appendNestedInclusion(elt.embeddedObject(), includedPaths, node, subBob);
+        } else if (Array == elt.type()) {
+            BSONArrayBuilder subBab(bab.subarrayStart());
+            appendNestedInclusionToArray(elt.embeddedObject(), includedPaths, node, subBab);
+        }
+    }
+}
+
+/**
+ * Appends the fields of 'in' which are included by the subtree rooted at 'node' to 'bob'.
+ * Embedded documents and arrays are built directly in the output buffer.
+ */
+void appendNestedInclusion(const BSONObj& in,
+                           const ProjectionStage::InclusionTree& includedPaths,
+                           size_t node,
+                           BSONObjBuilder& bob) {
+    const auto& children = includedPaths[node];
+    BSONObjIterator inputIt(in);
+    while (inputIt.more()) {
+        BSONElement elt = inputIt.next();
+        auto childIt = children.find(elt.fieldNameStringData());
+        if (children.end() == childIt) {
+            continue;
+        }
+
+        if (ProjectionStage::kIncludeWholeElement == childIt->second) {
+            bob.append(elt);
+        } else if (Object == elt.type()) {
+            BSONObjBuilder subBob(bob.subobjStart(elt.fieldNameStringData()));
+            appendNestedInclusion(elt.embeddedObject(), includedPaths, childIt->second, subBob);
+        } else if (Array == elt.type()) {
+            BSONArrayBuilder subBab(bob.subarrayStart(elt.fieldNameStringData()));
+            appendNestedInclusionToArray(
+                elt.embeddedObject(), includedPaths, childIt->second, subBab);
+        }
+    }
+}
+
+}  // namespace
+
+// static
+void ProjectionStage::getNestedInclusionTree(const BSONObj& projObj,
+                                             InclusionTree* includedPaths) {
+    // The root.
+    includedPaths->resize(1);
+
+    // As in ProjectionExec, the _id field is included whole unless it is excluded, whatever paths
+    // inside it are listed.
+    if (projObj[kIdField].eoo() || projObj[kIdField].trueValue()) {
+        (*includedPaths)[0][kIdField] = kIncludeWholeElement;
+    }
+
+    BSONObjIterator projObjIt(projObj);
+    while (projObjIt.more()) {
+        StringData path = projObjIt.next().fieldNameStringData();
+        if (path == kIdField || path.startsWith("_id.")) {
+            continue;
+        }
+
+        // Walk down the tree, adding a node for each path component which has included
+        // subfields. The parent map is looked up by index since adding a node may reallocate.
+        size_t node = 0;
+        size_t dot;
+        bool includedWhole = false;
+        while (!includedWhole && (dot = path.find('.')) != std::string::npos) {
+            StringData fieldName = path.substr(0, dot);
+            auto childIt = (*includedPaths)[node].find(fieldName);
+            if ((*includedPaths)[node].end() == childIt) {
+                size_t child = includedPaths->size();
+                includedPaths->emplace_back();
+                (*includedPaths)[node][fieldName] = child;
+                node = child;
+            } else if (kIncludeWholeElement == childIt->second) {
+                // A path inside an element which is already included whole adds nothing.
+                includedWhole = true;
+            } else {
+                node = childIt->second;
+            }
+            path = path.substr(dot + 1);
+        }
+
+        if (!includedWhole) {
+            (*includedPaths)[node][path] = kIncludeWholeElement;
+        }
+    }
+}
+
+// static
+void ProjectionStage::transformNestedInclusion(const BSONObj& in,
+                                               const InclusionTree& includedPaths,
+                                               BSONObjBuilder& bob) {
+    appendNestedInclusion(in, includedPaths, 0, bob);
+}
+
 Status ProjectionStage::transform(WorkingSetMember* member) {
     // The default no-fast-path case.
     if (ProjectionStageParams::NO_FAST_PATH == _projImpl) {
@@ -161,7 +284,11 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         invariant(member->hasObj());
 
         // Apply the SIMPLE_DOC projection.
-        transformSimpleInclusion(member->obj.value(), _includedFields, bob);
+        if (_includedPaths.empty()) {
+            transformSimpleInclusion(member->obj.value(), _includedFields, bob);
+        } else {
+            transformNestedInclusion(member->obj.value(), _includedPaths, bob);
+        }
     } else {
         invariant(ProjectionStageParams::COVERED_ONE_INDEX == _projImpl);
         // We're pulling data out of the key.
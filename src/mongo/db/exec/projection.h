@@ -47,7 +47,8 @@ struct ProjectionStageParams {
         // The projection is simple inclusion and is totally covered by one index.
         COVERED_ONE_INDEX,
 
-        // The projection is simple inclusion and we expect an object.
+        // The projection is simple inclusion and we expect an object. The included paths may be
+        // dotted, provided none is positional and no included path lies inside another.
         SIMPLE_DOC
     };
 
@@ -110,6 +111,35 @@ public:
                                          const FieldSet& includedFields,
                                          BSONObjBuilder& bob);
 
+    /**
+     * Compiled form of a simple inclusion projection with dotted paths. Node 0 is the root, and
+     * each node maps a field name either to the index of the node holding its included
+     * subfields, or to kIncludeWholeElement. For example, {_id: 0, 'a.b': 1, 'a.c': 1, d: 1}
+     * compiles to [{a: 1, d: kIncludeWholeElement}, {b: kIncludeWholeElement,
+     * c: kIncludeWholeElement}].
+     */
+    using InclusionTree = std::vector<StringMap<size_t>>;
+
+    static const size_t kIncludeWholeElement = 0;
+
+    /**
+     * Given the projection spec for a simple inclusion projection which may contain dotted paths,
+     * 'projObj', populates 'includedPaths' with the tree of paths to be included.
+     */
+    static void getNestedInclusionTree(const BSONObj& projObj, InclusionTree* includedPaths);
+
+    /**
+     * Applies a simple inclusion projection with dotted paths to 'in' in a single pass over the
+     * document, matching the output of ProjectionExec: the included subfields of an embedded
+     * document are kept in a document of their own, the projection is applied to each document
+     * in an array, and other values on an included path are dropped.
+     *
+     * The resulting document is constructed using 'bob'.
+     */
+    static void transformNestedInclusion(const BSONObj& in,
+                                         const InclusionTree& includedPaths,
+                                         BSONObjBuilder& bob);
+
     static const char* kStageType;
 
 private:
@@ -133,6 +163,10 @@ private:
     // Has the field names present in the simple projection.
     FieldSet _includedFields;
 
+    // Used by the SIMPLE_DOC path instead of _includedFields when the projection has dotted
+    // paths. Empty otherwise.
+    InclusionTree _includedPaths;
+
     //
     // Used for the COVERED_ONE_INDEX path.
     //
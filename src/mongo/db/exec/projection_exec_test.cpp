@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/projection_exec.h"
 
+#include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -384,4 +385,69 @@ TEST(ProjectionExecTest, TransformMetaSortKeyCoveredCompound3) {
     ASSERT_BSONOBJ_EQ(actualOut, expectedOut);
 }
 
+//
+// Nested inclusion fast path
+//
+
+/**
+ * Applies the projection 'specStr' to 'objStr' with ProjectionStage's nested inclusion fast path,
+ * checks that ProjectionExec produces the same document, and returns it.
+ */
+BSONObj transformNestedInclusion(const char* specStr, const char* objStr) {
+    QueryTestServiceContext serviceCtx;
+    auto opCtx = serviceCtx.makeOperationContext();
+    BSONObj spec = fromjson(specStr);
+    BSONObj obj = fromjson(objStr);
+
+    ProjectionStage::InclusionTree includedPaths;
+    ProjectionStage::getNestedInclusionTree(spec, &includedPaths);
+    BSONObjBuilder fastBob;
+    ProjectionStage::transformNestedInclusion(obj, includedPaths, fastBob);
+    BSONObj fastOut = fastBob.obj();
+
+    ProjectionExec exec(opCtx.get(), spec, nullptr, nullptr);
+    WorkingSetMember wsm;
+    wsm.obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+    wsm.transitionToOwnedObj();
+    ASSERT_OK(exec.transform(&wsm));
+    ASSERT_BSONOBJ_EQ(wsm.obj.value(), fastOut);
+    return fastOut;
+}
+
+TEST(ProjectionExecTest, NestedInclusionEmbeddedDocument) {
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{_id: 1, a: {b: 1, d: 3}}"),
+        transformNestedInclusion("{'a.b': 1, 'a.d': 1}", "{_id: 1, a: {b: 1, c: 2, d: 3}, e: 4}"));
+}
+
+TEST(ProjectionExecTest, NestedInclusionKeepsSourceFieldOrder) {
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{b: 2, a: {c: 1, x: {y: 3}}}"),
+        transformNestedInclusion("{_id: 0, 'a.x.y': 1, b: 1, 'a.c': 1}",
+                                 "{_id: 1, b: 2, a: {c: 1, x: {y: 3, z: 4}, d: 5}}"));
+}
+
+TEST(ProjectionExecTest, NestedInclusionMissingAndScalarValues) {
+    ASSERT_BSONOBJ_EQ(fromjson("{}"), transformNestedInclusion("{_id: 0, 'a.b': 1}", "{a: 5}"));
+    ASSERT_BSONOBJ_EQ(fromjson("{a: {}}"),
+                      transformNestedInclusion("{_id: 0, 'a.b': 1}", "{a: {c: 1}}"));
+    ASSERT_BSONOBJ_EQ(fromjson("{}"), transformNestedInclusion("{_id: 0, 'a.b': 1}", "{c: 1}"));
+}
+
+TEST(ProjectionExecTest, NestedInclusionArrays) {
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{a: [{b: 1}, {}, [{b: 2}, []]]}"),
+        transformNestedInclusion("{_id: 0, 'a.b': 1}",
+                                 "{a: [{b: 1, c: 1}, 7, {c: 2}, [{b: 2}, 'x', [3]]]}"));
+}
+
+TEST(ProjectionExecTest, NestedInclusionIdField) {
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: {x: 1, y: 2}, a: {b: 1}}"),
+                      transformNestedInclusion("{'_id.x': 1, 'a.b': 1}",
+                                               "{_id: {x: 1, y: 2}, a: {b: 1, c: 2}}"));
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{a: {b: 1}}"),
+        transformNestedInclusion("{_id: 0, 'a.b': 1}", "{_id: {x: 1}, a: {b: 1, c: 2}}"));
+}
+
 }  // namespace
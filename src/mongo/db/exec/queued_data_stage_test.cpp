@@ -139,4 +139,57 @@ TEST_F(QueuedDataStageTest, validateStats) {
     unique_ptr<PlanStageStats> allStats(mock->getStats());
     ASSERT_TRUE(stats->isEOF);
 }
+
+//
+// Test that workBatch() collects results until it sees a state other than ADVANCED or NEED_TIME.
+//
+TEST_F(QueuedDataStageTest, workBatchStopsAtFirstNonAdvancingState) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+
+    WorkingSetID first = ws.allocate();
+    WorkingSetID second = ws.allocate();
+    mock->pushBack(first);
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(second);
+    mock->pushBack(PlanStage::NEED_YIELD);
+    mock->pushBack(ws.allocate());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID last = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_YIELD, mock->workBatch(10, &batch, &last));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_EQUALS(first, batch[0]);
+    ASSERT_EQUALS(second, batch[1]);
+    ASSERT_EQUALS(WorkingSet::INVALID_ID, last);
+
+    const CommonStats* stats = mock->getCommonStats();
+    ASSERT_EQUALS(stats->works, 4U);
+    ASSERT_EQUALS(stats->advanced, 2U);
+    ASSERT_EQUALS(stats->needTime, 1U);
+    ASSERT_EQUALS(stats->needYield, 1U);
+
+    // The remaining result is returned by the next batch, which is then cut short by EOF.
+    batch.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(10, &batch, &last));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(stats->works, 6U);
+}
+
+//
+// Test that workBatch() performs no more than the requested number of works.
+//
+TEST_F(QueuedDataStageTest, workBatchRespectsMaxWorks) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int i = 0; i < 5; ++i) {
+        mock->pushBack(ws.allocate());
+    }
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID last = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, mock->workBatch(3, &batch, &last));
+    ASSERT_EQUALS(3U, batch.size());
+    ASSERT_EQUALS(mock->getCommonStats()->works, 3U);
+}
 }
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bloom_filter.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+// The largest number of hash functions we will use, regardless of the bits per key.
+const unsigned kMaxHashes = 8;
+
+/**
+ * The 64-bit finalizer from MurmurHash3. RecordIds are frequently dense and sequential, so they
+ * must be mixed before they can be used to pick bits.
+ */
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+}  // namespace
+
+void RecordIdBloomFilter::reset(size_t expectedEntries, size_t bitsPerKey) {
+    _words.clear();
+    if (bitsPerKey == 0) {
+        _numBits = 0;
+        _numHashes = 0;
+        return;
+    }
+
+    // Round up to whole words, and always keep at least one so that the filter is active.
+    const uint64_t numWords = std::max<uint64_t>(1, (expectedEntries * bitsPerKey + 63) / 64);
+    _words.assign(numWords, 0);
+    _numBits = numWords * 64;
+
+    // The optimal number of hash functions is bitsPerKey * ln(2).
+    _numHashes = std::min(kMaxHashes, std::max(1u, static_cast<unsigned>(bitsPerKey * 69 / 100)));
+}
+
+void RecordIdBloomFilter::clear() {
+    _words.clear();
+    _words.shrink_to_fit();
+    _numBits = 0;
+    _numHashes = 0;
+}
+
+void RecordIdBloomFilter::insert(const RecordId& id) {
+    invariant(isActive());
+
+    // Derive all of the probes from two hashes, as described by Kirsch and Mitzenmacher.
+    const uint64_t h1 = mix(static_cast<uint64_t>(id.repr()));
+    const uint64_t h2 = (h1 >> 32) | 1;
+    for (unsigned i = 0; i < _numHashes; ++i) {
+        const uint64_t bit = (h1 + i * h2) % _numBits;
+        _words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+bool RecordIdBloomFilter::mayContain(const RecordId& id) const {
+    if (!isActive()) {
+        return true;
+    }
+
+    const uint64_t h1 = mix(static_cast<uint64_t>(id.repr()));
+    const uint64_t h2 = (h1 >> 32) | 1;
+    for (unsigned i = 0; i < _numHashes; ++i) {
+        const uint64_t bit = (h1 + i * h2) % _numBits;
+        if (!(_words[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+            ++_numRejected;
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
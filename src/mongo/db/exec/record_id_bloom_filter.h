@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A bloom filter over RecordIds. Used by stages that intersect RecordIds to cheaply discard
+ * RecordIds that cannot be part of the intersection before doing more expensive work with them.
+ *
+ * A default-constructed filter is inactive and reports that every RecordId may be contained.
+ * Once reset() is called, mayContain() returns false only for RecordIds that were definitely
+ * never inserted.
+ */
+class RecordIdBloomFilter {
+public:
+    /**
+     * Clears the filter and sizes it to hold 'expectedEntries' RecordIds with 'bitsPerKey' bits
+     * each. The filter is active after this call. If 'bitsPerKey' is zero, the filter is left
+     * inactive.
+     */
+    void reset(size_t expectedEntries, size_t bitsPerKey);
+
+    /**
+     * Makes the filter inactive and releases its memory.
+     */
+    void clear();
+
+    /**
+     * Adds 'id' to the filter. The filter must be active.
+     */
+    void insert(const RecordId& id);
+
+    /**
+     * Returns false if 'id' was definitely never inserted. Always returns true if the filter is
+     * inactive.
+     */
+    bool mayContain(const RecordId& id) const;
+
+    bool isActive() const {
+        return !_words.empty();
+    }
+
+    /**
+     * Returns how many calls to mayContain() have returned false. Not cleared by reset().
+     */
+    size_t numRejected() const {
+        return _numRejected;
+    }
+
+    size_t getMemUsage() const {
+        return _words.size() * sizeof(uint64_t);
+    }
+
+private:
+    std::vector<uint64_t> _words;
+    uint64_t _numBits = 0;
+    unsigned _numHashes = 0;
+
+    // A statistic, so it is updated from the logically const mayContain().
+    mutable size_t _numRejected = 0;
+};
+
+}  // namespace mongo
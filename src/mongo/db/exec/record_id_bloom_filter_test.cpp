@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bloom_filter.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBloomFilterTest, InactiveFilterContainsEverything) {
+    RecordIdBloomFilter filter;
+    ASSERT_FALSE(filter.isActive());
+    ASSERT_TRUE(filter.mayContain(RecordId(1)));
+    ASSERT_TRUE(filter.mayContain(RecordId(1000)));
+    ASSERT_EQ(0U, filter.numRejected());
+
+    // Zero bits per key leaves the filter disabled.
+    filter.reset(100, 0);
+    ASSERT_FALSE(filter.isActive());
+    ASSERT_TRUE(filter.mayContain(RecordId(1)));
+}
+
+TEST(RecordIdBloomFilterTest, NoFalseNegatives) {
+    RecordIdBloomFilter filter;
+    filter.reset(1000, 10);
+    ASSERT_TRUE(filter.isActive());
+    for (int64_t i = 1; i <= 1000; ++i) {
+        filter.insert(RecordId(i * 7));
+    }
+    for (int64_t i = 1; i <= 1000; ++i) {
+        ASSERT_TRUE(filter.mayContain(RecordId(i * 7)));
+    }
+    ASSERT_EQ(0U, filter.numRejected());
+}
+
+TEST(RecordIdBloomFilterTest, RejectsMostAbsentRecordIds) {
+    RecordIdBloomFilter filter;
+    filter.reset(1000, 10);
+    for (int64_t i = 1; i <= 1000; ++i) {
+        filter.insert(RecordId(i));
+    }
+
+    // With ten bits per key the false positive rate is around one percent.
+    size_t falsePositives = 0;
+    for (int64_t i = 1001; i <= 11000; ++i) {
+        if (filter.mayContain(RecordId(i))) {
+            ++falsePositives;
+        }
+    }
+    ASSERT_LT(falsePositives, 500U);
+    ASSERT_EQ(10000U - falsePositives, filter.numRejected());
+}
+
+TEST(RecordIdBloomFilterTest, ResetForgetsEntriesButKeepsRejectCount) {
+    RecordIdBloomFilter filter;
+    filter.reset(10, 10);
+    filter.insert(RecordId(5));
+    ASSERT_FALSE(filter.mayContain(RecordId(6)) && filter.mayContain(RecordId(7)) &&
+                 filter.mayContain(RecordId(8)));
+    const size_t rejected = filter.numRejected();
+    ASSERT_GT(rejected, 0U);
+
+    filter.reset(10, 10);
+    ASSERT_TRUE(filter.isActive());
+    ASSERT_EQ(rejected, filter.numRejected());
+    ASSERT_FALSE(filter.mayContain(RecordId(5)));
+
+    filter.clear();
+    ASSERT_FALSE(filter.isActive());
+    ASSERT_EQ(0U, filter.getMemUsage());
+    ASSERT_TRUE(filter.mayContain(RecordId(5)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -56,6 +56,9 @@ ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
                                    PlanStage* child)
     : PlanStage(kStageType, opCtx), _ws(ws), _metadata(std::move(metadata)) {
     _children.emplace_back(child);
+    if (_metadata) {
+        _shardKeyPattern.emplace(_metadata->getKeyPattern());
+    }
 }
 
 ShardFilterStage::~ShardFilterStage() {}
@@ -77,10 +80,9 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
         if (_metadata) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
             WorkingSetMember* member = _ws->get(*out);
             WorkingSetMatchableDocument matchable(member);
-            BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
+            BSONObj shardKey = _shardKeyPattern->extractShardKeyFromMatchable(matchable);
 
             if (shardKey.isEmpty()) {
                 // We can't find a shard key for this document - this should never happen with
@@ -106,10 +108,13 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                           << "document may have been inserted manually into shard";
             }
 
-            if (!_metadata->keyBelongsToMe(shardKey)) {
-                _ws->free(*out);
-                ++_specificStats.chunkSkips;
-                return PlanStage::NEED_TIME;
+            if (!_lastOwnedRange || !_lastOwnedRange->containsKey(shardKey)) {
+                _lastOwnedRange = _metadata->getOwnedRangeContaining(shardKey);
+                if (!_lastOwnedRange) {
+                    _ws->free(*out);
+                    ++_specificStats.chunkSkips;
+                    return PlanStage::NEED_TIME;
+                }
             }
         }
 
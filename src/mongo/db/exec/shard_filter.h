@@ -28,8 +28,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/metadata_manager.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -98,6 +102,14 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Shard key pattern of '_metadata', if the collection is sharded
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
+
+    // The owned range which contained the shard key of the last document which passed the filter.
+    // Since documents usually arrive in index order, most keys will fall into the same range and
+    // can be checked against it without looking up the metadata.
+    boost::optional<ChunkRange> _lastOwnedRange;
 };
 
 }  // namespace mongo
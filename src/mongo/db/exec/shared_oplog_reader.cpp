@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_reader.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/recovery_unit.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogReader = ServiceContext::declareDecoration<SharedOplogReader>();
+
+bool compareIds(const SharedOplogReader::Entry& entry, const RecordId& id) {
+    return entry.id < id;
+}
+
+}  // namespace
+
+SharedOplogReader* SharedOplogReader::get(ServiceContext* service) {
+    return &getSharedOplogReader(service);
+}
+
+bool SharedOplogReader::getEntriesAfter(OperationContext* opCtx,
+                                        const Collection* oplog,
+                                        const RecordId& lastSeenId,
+                                        std::vector<Entry>* entries) {
+    invariant(opCtx->recoveryUnit()->isReadingFromMajorityCommittedSnapshot());
+    const size_t batchSize =
+        static_cast<size_t>(std::max(1, internalQuerySharedOplogReadBatchSize.load()));
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    bool readByUs = false;
+    while (true) {
+        if (_oplogUUID != oplog->uuid()) {
+            // The oplog has been recreated since the window was read.
+            clear_inlock();
+            _oplogUUID = oplog->uuid();
+        }
+
+        if (!_window.empty() && lastSeenId < _window.back().id) {
+            if (lastSeenId < _window.front().id) {
+                return false;
+            }
+
+            auto it = std::lower_bound(_window.begin(), _window.end(), lastSeenId, compareIds);
+            if (it == _window.end() || it->id != lastSeenId) {
+                // 'lastSeenId' falls between two consecutive oplog entries, so it must have been
+                // removed from the oplog.
+                return false;
+            }
+            for (++it; it != _window.end() && entries->size() < batchSize; ++it) {
+                entries->push_back(*it);
+            }
+            return true;
+        }
+
+        if (readByUs) {
+            // There was nothing after 'lastSeenId' to read.
+            return true;
+        }
+
+        if (_readerActive) {
+            opCtx->waitForConditionOrInterrupt(_readerDone, lk, [&] { return !_readerActive; });
+            continue;
+        }
+
+        const bool extendWindow = !_window.empty() && _window.back().id == lastSeenId;
+        const uint64_t notifierVersion = oplog->getCappedInsertNotifier()->getVersion();
+        const Timestamp snapshot =
+            opCtx->recoveryUnit()->getMajorityCommittedSnapshot().value_or(Timestamp());
+        if (extendWindow && _emptyReadNotifierVersion == notifierVersion &&
+            snapshot <= _emptyReadSnapshot) {
+            // Nothing can have become visible since the last read found the end of the oplog.
+            return true;
+        }
+
+        // Become the reader. Other callers which reach the end of the window wait for us.
+        _readerActive = true;
+        const uint64_t generation = _generation;
+        lk.unlock();
+
+        std::vector<Entry> read;
+        bool foundLastSeen;
+        try {
+            foundLastSeen = readEntries(opCtx, oplog, lastSeenId, &read);
+        } catch (...) {
+            lk.lock();
+            _readerActive = false;
+            _readerDone.notify_all();
+            throw;
+        }
+
+        lk.lock();
+        _readerActive = false;
+        _readerDone.notify_all();
+        readByUs = true;
+
+        if (generation != _generation) {
+            // The window was emptied while we were reading.
+            continue;
+        }
+
+        if (!foundLastSeen) {
+            // The oplog has been truncated past 'lastSeenId', so the window no longer ends where
+            // the oplog continues.
+            clear_inlock();
+            return false;
+        }
+
+        if (!extendWindow) {
+            // Start a new window at 'lastSeenId'.
+            clear_inlock();
+        }
+
+        auto first = read.begin();
+        if (extendWindow) {
+            // The entry at 'lastSeenId' is already the last entry of the window.
+            ++first;
+        }
+        for (auto it = first; it != read.end(); ++it) {
+            _bytesUsed += it->obj.objsize();
+            _window.push_back(std::move(*it));
+        }
+
+        if (read.size() == 1) {
+            _emptyReadNotifierVersion = notifierVersion;
+            _emptyReadSnapshot = snapshot;
+        } else {
+            _emptyReadNotifierVersion = boost::none;
+        }
+
+        // Make room by dropping the oldest entries, always keeping the end of the window.
+        const size_t maxBytes =
+            static_cast<size_t>(std::max(0, internalQuerySharedOplogBufferMaxBytes.load()));
+        while (_bytesUsed > maxBytes && _window.size() > 1) {
+            _bytesUsed -= _window.front().obj.objsize();
+            _window.pop_front();
+        }
+    }
+}
+
+bool SharedOplogReader::readEntries(OperationContext* opCtx,
+                                    const Collection* oplog,
+                                    const RecordId& from,
+                                    std::vector<Entry>* entries) {
+    auto cursor = oplog->getCursor(opCtx, true);
+    auto record = cursor->seekExact(from);
+    if (!record) {
+        return false;
+    }
+    entries->push_back({record->id, record->data.releaseToBson().getOwned()});
+
+    const size_t batchSize =
+        static_cast<size_t>(std::max(1, internalQuerySharedOplogReadBatchSize.load()));
+    while (entries->size() <= batchSize && (record = cursor->next())) {
+        entries->push_back({record->id, record->data.releaseToBson().getOwned()});
+    }
+    return true;
+}
+
+void SharedOplogReader::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    clear_inlock();
+}
+
+void SharedOplogReader::clear_inlock() {
+    _window.clear();
+    _bytesUsed = 0;
+    _emptyReadNotifierVersion = boost::none;
+    ++_generation;
+}
+
+size_t SharedOplogReader::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _window.size();
+}
+
+size_t SharedOplogReader::bytesUsed() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _bytesUsed;
+}
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class Collection;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Lets tailable scans of the oplog share the work of reading new entries, so that the oplog is read
+ * once rather than once per scan when many change streams are open. The newest entries are held in
+ * a window of consecutive oplog records. A scan positioned inside the window is handed the entries
+ * which follow its position without touching the oplog. Only when scans reach the end of the window
+ * does one of them, at a time, read more entries into it; the others wait for it and then share
+ * what it read.
+ *
+ * Entries must only be added and handed out while reading from the majority committed snapshot.
+ * Every entry in the window is then majority committed, and no scan can see an entry that its own
+ * read would not eventually see.
+ */
+class SharedOplogReader {
+public:
+    struct Entry {
+        RecordId id;
+        BSONObj obj;  // Owned.
+    };
+
+    static SharedOplogReader* get(ServiceContext* service);
+
+    /**
+     * Appends to 'entries' the oplog entries which follow 'lastSeenId', reading them from 'oplog'
+     * into the window first if 'lastSeenId' is the last entry of the window or the window is
+     * empty. Returns true with no entries if there is nothing to read after 'lastSeenId' yet.
+     * Returns false if 'lastSeenId' is older than the window, or is no longer in the oplog, in
+     * which case the caller must read the oplog itself.
+     *
+     * The caller must hold a lock on 'oplog' and be reading from the majority committed snapshot.
+     * May throw if interrupted while waiting for another reader, or on a WriteConflictException.
+     */
+    bool getEntriesAfter(OperationContext* opCtx,
+                         const Collection* oplog,
+                         const RecordId& lastSeenId,
+                         std::vector<Entry>* entries);
+
+    /**
+     * Empties the window.
+     */
+    void clear();
+
+    /**
+     * Returns the number of entries in the window and the approximate number of bytes they use.
+     */
+    size_t size() const;
+    size_t bytesUsed() const;
+
+private:
+    /**
+     * Reads the entry at 'from' and up to one read batch of the entries which follow it from
+     * 'oplog' into 'entries'. Returns false if there is no entry at 'from'.
+     */
+    static bool readEntries(OperationContext* opCtx,
+                            const Collection* oplog,
+                            const RecordId& from,
+                            std::vector<Entry>* entries);
+
+    void clear_inlock();
+
+    mutable stdx::mutex _mutex;
+
+    // Signalled when '_readerActive' is cleared.
+    stdx::condition_variable _readerDone;
+    bool _readerActive = false;
+
+    // The UUID of the oplog the window was read from.
+    OptionalCollectionUUID _oplogUUID;
+
+    std::deque<Entry> _window;
+    size_t _bytesUsed = 0;
+
+    // Bumped whenever the window is emptied, so that a reader does not add entries which no longer
+    // follow the window.
+    uint64_t _generation = 0;
+
+    // When the last read found nothing after the end of the window, the version of the oplog's
+    // capped insert notifier and the committed snapshot it read at. Reading again is pointless
+    // until one of them has moved on.
+    boost::optional<uint64_t> _emptyReadNotifierVersion;
+    Timestamp _emptyReadSnapshot;
+};
+
+}  // namespace mongo
@@ -31,7 +31,11 @@
 #include "mongo/db/exec/sort.h"
 
 #include <algorithm>
+#include <cstring>
 
+#include "mongo/base/compare_numbers.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -41,6 +45,8 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -54,6 +60,105 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
+namespace {
+
+/**
+ * Orders the keys of spilled results. Each key is a sort key followed by the RecordId, and the
+ * RecordId field compares ascending because it is past the end of the pattern.
+ */
+class SortStageSpillComparator {
+public:
+    explicit SortStageSpillComparator(BSONObj pattern) : _pattern(std::move(pattern)) {}
+
+    int operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                   const std::pair<BSONObj, BSONObj>& rhs) const {
+        // False means ignore field names.
+        return lhs.first.woCompare(rhs.first, _pattern, false);
+    }
+
+private:
+    BSONObj _pattern;
+};
+
+/**
+ * Orders buffered items on a single-field sort key whose values all have the BSON type compared by
+ * 'KeyCompare', with RecordId as the tie-breaker. This gives the same order as
+ * SortStage::WorkingSetComparator without the generic comparison's dispatch on both keys' types.
+ */
+template <typename Item, typename KeyCompare>
+class SingleTypeKeyComparator {
+public:
+    explicit SingleTypeKeyComparator(int direction) : _direction(direction) {}
+
+    bool operator()(const Item& lhs, const Item& rhs) const {
+        int result = KeyCompare()(lhs.sortKey.firstElement(), rhs.sortKey.firstElement());
+        if (0 != result) {
+            return _direction * result < 0;
+        }
+        return lhs.recordId < rhs.recordId;
+    }
+
+private:
+    int _direction;
+};
+
+// Each of these compares two values of one BSON type as BSONElement::compareElements() does.
+
+struct CompareIntKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return compareInts(lhs._numberInt(), rhs._numberInt());
+    }
+};
+
+struct CompareLongKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return compareLongs(lhs._numberLong(), rhs._numberLong());
+    }
+};
+
+struct CompareDoubleKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return compareDoubles(lhs._numberDouble(), rhs._numberDouble());
+    }
+};
+
+struct CompareDateKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return compareLongs(lhs.date().toMillisSinceEpoch(), rhs.date().toMillisSinceEpoch());
+    }
+};
+
+struct CompareObjectIdKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return memcmp(lhs.value(), rhs.value(), OID::kOIDSize);
+    }
+};
+
+// Sort keys are already collation keys when the sort has a collation, so strings always compare
+// as binary.
+struct CompareStringKeys {
+    int operator()(const BSONElement& lhs, const BSONElement& rhs) const {
+        return lhs.valueStringData().compare(rhs.valueStringData());
+    }
+};
+
+/**
+ * Returns 'spillKey' without the RecordId that was appended to it.
+ */
+BSONObj stripRecordId(const BSONObj& spillKey) {
+    BSONObjBuilder bob;
+    BSONObjIterator it(spillKey);
+    while (it.more()) {
+        BSONElement elt = it.next();
+        if (it.more()) {
+            bob.append(elt);
+        }
+    }
+    return bob.obj();
+}
+
+}  // namespace
+
 SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
@@ -76,6 +181,7 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -84,11 +190,10 @@ SortStage::SortStage(OperationContext* opCtx,
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    if (sortComparator.nFields() == 1) {
+        _keyDirection = sortComparator.firstElement().number() < 0 ? -1 : 1;
+    } else {
+        _mixedKeyTypes = true;
     }
 }
 
@@ -97,18 +202,34 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _sorterIterator ? !_sorterIterator->more() : _data.end() == _resultIterator;
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
+    _memoryReservation.set(getOpCtx(), _memUsage);
+    const bool overGlobalLimit = BlockingMemoryTracker::get()->shouldRelease(_memUsage);
+    if ((_memUsage > maxBytes || overGlobalLimit) && _allowDiskUse) {
+        spillToSorter();
+        _memoryReservation.set(getOpCtx(), _memUsage);
+    } else if (_memUsage > maxBytes) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
            << " bytes of RAM. Add an index, or specify a smaller limit.";
         Status status(ErrorCodes::OperationFailed, ss);
         *out = WorkingSetCommon::allocateStatusMember(_ws, status);
         return PlanStage::FAILURE;
+    } else if (overGlobalLimit) {
+        mongoutils::str::stream ss;
+        ss << "Sort operation used " << _memUsage << " bytes of RAM while blocking stages on this"
+           << " node exceeded their limit of " << internalQueryGlobalBlockingMemoryLimitBytes.load()
+           << " bytes. Add an index, or specify a smaller limit.";
+        Status status(ErrorCodes::ExceededMemoryLimit, ss);
+        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        return PlanStage::FAILURE;
     }
 
     if (isEOF()) {
@@ -129,18 +250,13 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             // Planner must put a fetch before we get here.
             verify(member->hasObj());
 
-            // We might be sorting something that was invalidated at some point.
-            if (member->hasRecordId()) {
-                _wsidByRecordId[member->recordId] = id;
-            }
-
-            SortableDataItem item;
-            item.wsid = id;
-
             // We extract the sort key from the WSM's computed data. This must have been generated
             // by a SortKeyGeneratorStage descendent in the execution tree.
             auto sortKeyComputedData =
                 static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
+
+            SortableDataItem item;
+            item.wsid = id;
             item.sortKey = sortKeyComputedData->getSortKey();
 
             if (member->hasRecordId()) {
@@ -148,13 +264,29 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
+            // Once we have spilled, everything goes straight to the external sort.
+            if (_sorter) {
+                addToSorter(item);
+                return PlanStage::NEED_TIME;
+            }
+
+            // We might be sorting something that was invalidated at some point.
+            if (member->hasRecordId()) {
+                _wsidByRecordId[member->recordId] = id;
+            }
+
             addToBuffer(item);
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
+            if (_sorter) {
+                _sorterIterator.reset(_sorter->done());
+                _sorter.reset();
+            } else {
+                sortBuffer();
+            }
             _resultIterator = _data.begin();
             _sorted = true;
             return PlanStage::NEED_TIME;
@@ -178,8 +310,21 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+
+    if (_sorterIterator) {
+        // Results that went through the external sort are no longer tied to a RecordId, so they
+        // are returned as owned objects.
+        SpillSorter::Data next = _sorterIterator->next();
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), next.second.getOwned());
+        _ws->transitionToOwnedObj(*out);
+        member->addComputed(new SortKeyComputedData(stripRecordId(next.first)));
+        return PlanStage::ADVANCED;
+    }
+
+    verify(_resultIterator != _data.end());
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -221,7 +366,7 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = _memUsage + (_sorter ? _sorter->memUsed() : 0);
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
 
@@ -250,12 +395,21 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     addToBuffer() - Adds item to the heap in the vector.
+ *                     If size of heap exceeds limit, remove item from heap
+ *                     with highest key. Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
+    if (!_mixedKeyTypes) {
+        const BSONType keyType = item.sortKey.firstElementType();
+        if (_keyType == BSONType::EOO) {
+            _keyType = keyType;
+        } else if (keyType != _keyType) {
+            _mixedKeyTypes = true;
+        }
+    }
+
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
@@ -282,33 +436,28 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             _memUsage = member->getMemUsage();
         }
     } else {
-        // Update data item set instead of vector
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
         // Limit not reached - insert and return
         vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
+        if (_data.size() < limit) {
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.push_back(item);
+            std::push_heap(_data.begin(), _data.end(), cmp);
             _memUsage += member->getMemUsage();
             return;
         }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        // Limit will be exceeded - compare with item with highest key, at the front of the heap.
+        // If new item does not have a lower key value than that item, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
+        if (cmp(item, _data.front())) {
+            std::pop_heap(_data.begin(), _data.end(), cmp);
+            SortableDataItem& lastItem = _data.back();
             _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
             _memUsage += member->getMemUsage();
             wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            lastItem = item;
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
@@ -323,21 +472,156 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
     }
 }
 
-void SortStage::sortBuffer() {
+template <typename Comparator>
+void SortStage::sortBufferWith(const Comparator& cmp) {
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
         std::sort(_data.begin(), _data.end(), cmp);
     } else if (_limit == 1) {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        // The heap was built with _sortKeyComparator, but 'cmp' orders items the same way.
+        std::sort_heap(_data.begin(), _data.end(), cmp);
+    }
+}
+
+namespace {
+
+// Buffers smaller than this are sorted with the BSON comparator, as encoding them costs more than
+// it saves.
+const size_t kMinItemsForKeyStringSort = 64;
+
+/**
+ * An item's KeyString encoding in a shared buffer. The first bytes of the encoding are kept as a
+ * big-endian integer, so that most comparisons need not look at the buffer.
+ */
+struct EncodedSortKey {
+    uint64_t prefix;
+    uint32_t offset;
+    uint32_t size;
+    size_t index;
+};
+
+}  // namespace
+
+bool SortStage::canSortByKeyString() const {
+    // An Ordering describes at most 32 fields, and KeyString can only encode non-negative
+    // RecordIds.
+    return _limit != 1 && _data.size() >= kMinItemsForKeyStringSort &&
+        _sortKeyComparator->pattern.nFields() <= 32 &&
+        std::none_of(_data.begin(), _data.end(), [](const SortableDataItem& item) {
+               return item.recordId.repr() < 0;
+           });
+}
+
+void SortStage::sortBufferByKeyString() {
+    const Ordering ordering = Ordering::make(_sortKeyComparator->pattern);
+
+    std::vector<char> buffer;
+    std::vector<EncodedSortKey> keys;
+    keys.reserve(_data.size());
+    KeyString keyString(KeyString::Version::V1);
+    for (size_t i = 0; i < _data.size(); ++i) {
+        keyString.resetToKey(_data[i].sortKey, ordering, _data[i].recordId);
+
+        EncodedSortKey key;
+        char prefix[sizeof(uint64_t)] = {};
+        std::copy_n(keyString.getBuffer(),
+                    std::min(sizeof(prefix), keyString.getSize()),
+                    prefix);
+        key.prefix = ConstDataView(prefix).read<BigEndian<uint64_t>>();
+        key.offset = buffer.size();
+        key.size = keyString.getSize();
+        key.index = i;
+        buffer.insert(buffer.end(), keyString.getBuffer(), keyString.getBuffer() + key.size);
+        keys.push_back(key);
     }
+
+    // The encodings compare as the comparator would compare the sort keys and then the RecordIds.
+    const char* bytes = buffer.data();
+    std::sort(keys.begin(), keys.end(), [bytes](const EncodedSortKey& lhs,
+                                                const EncodedSortKey& rhs) {
+        if (lhs.prefix != rhs.prefix) {
+            return lhs.prefix < rhs.prefix;
+        }
+        const int result =
+            std::memcmp(bytes + lhs.offset, bytes + rhs.offset, std::min(lhs.size, rhs.size));
+        return result != 0 ? result < 0 : lhs.size < rhs.size;
+    });
+
+    std::vector<SortableDataItem> sorted;
+    sorted.reserve(_data.size());
+    for (auto&& key : keys) {
+        sorted.push_back(std::move(_data[key.index]));
+    }
+    _data.swap(sorted);
+}
+
+void SortStage::sortBuffer() {
+    switch (_mixedKeyTypes ? BSONType::EOO : _keyType) {
+        case BSONType::NumberInt:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareIntKeys>(_keyDirection));
+        case BSONType::NumberLong:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareLongKeys>(_keyDirection));
+        case BSONType::NumberDouble:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareDoubleKeys>(_keyDirection));
+        case BSONType::Date:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareDateKeys>(_keyDirection));
+        case BSONType::jstOID:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareObjectIdKeys>(_keyDirection));
+        case BSONType::String:
+            return sortBufferWith(
+                SingleTypeKeyComparator<SortableDataItem, CompareStringKeys>(_keyDirection));
+        default:
+            if (canSortByKeyString()) {
+                return sortBufferByKeyString();
+            }
+            return sortBufferWith(*_sortKeyComparator);
+    }
+}
+
+void SortStage::spillToSorter() {
+    invariant(!_sorter);
+    invariant(_allowDiskUse);
+
+    const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    SortOptions opts;
+    opts.Limit(_limit)
+        .MaxMemoryUsageBytes(maxBytes)
+        .ExtSortAllowed()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp")
+        .SortThreads(std::max(1, internalQueryExecSortThreads.load()));
+    _sorter.reset(
+        SpillSorter::make(opts, SortStageSpillComparator(_sortKeyComparator->pattern)));
+
+    for (auto&& item : _data) {
+        addToSorter(item);
+    }
+    _data.clear();
+    _memUsage = 0;
+    _specificStats.usedDisk = true;
+}
+
+void SortStage::addToSorter(const SortableDataItem& item) {
+    BSONObjBuilder key;
+    key.appendElements(item.sortKey);
+    key.append("", static_cast<long long>(item.recordId.repr()));
+
+    WorkingSetMember* member = _ws->get(item.wsid);
+    _sorter->add(key.obj(), member->obj.value());
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BSONObj, mongo::BSONObj, mongo::SortStageSpillComparator);
@@ -28,15 +28,17 @@
 
 #pragma once
 
-#include <set>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/blocking_memory_tracker.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +48,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +58,12 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, buffered results are spilled to an external sort on disk instead of failing once
+    // they exceed internalQueryExecMaxBlockingSortBytes. Results returned after a spill are
+    // owned objects with no RecordId, so this must only be set when the consumer does not need
+    // RecordIds.
+    bool allowDiskUse;
 };
 
 /**
@@ -65,6 +73,10 @@ public:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *
+ * With a limit greater than one, the stage keeps only the best 'limit' results seen so far in a
+ * bounded heap. If disk use is allowed and the buffered results exceed the memory limit, they are
+ * handed to an external Sorter along with all remaining input.
  */
 class SortStage final : public PlanStage {
 public:
@@ -106,6 +118,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether we may spill to disk rather than fail when we exceed the memory limit.
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -139,7 +154,7 @@ private:
     };
 
     /**
-     * Inserts one item into data buffer (vector or set).
+     * Inserts one item into the data buffer.
      * If limit is exceeded, remove item with lowest key.
      */
     void addToBuffer(const SortableDataItem& item);
@@ -147,29 +162,76 @@ private:
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
+    /**
+     * Sorts the data buffer as sortBuffer() does, ordering items with 'cmp', which must order them
+     * the same way as _sortKeyComparator.
+     */
+    template <typename Comparator>
+    void sortBufferWith(const Comparator& cmp);
+
+    /**
+     * Sorts the data buffer as sortBuffer() does, by encoding each item's sort key and RecordId
+     * once into a KeyString and ordering the items by comparing the encodings as bytes.
+     */
+    void sortBufferByKeyString();
+
+    /**
+     * Returns true if sortBufferByKeyString() can sort the data buffer and is expected to be
+     * faster than comparing the BSON sort keys.
+     */
+    bool canSortByKeyString() const;
+
+    /**
+     * Moves everything in the data buffer into _sorter, creating it. All subsequent input is
+     * added to _sorter directly.
+     */
+    void spillToSorter();
+
+    /**
+     * Adds the document, sort key and RecordId of 'item' to _sorter and frees its WSM.
+     */
+    void addToSorter(const SortableDataItem& item);
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // For a sort on a single field, the BSON type shared by every key added to the buffer so far,
+    // or EOO if there have been none. sortBuffer() uses a comparator specialized for that type
+    // rather than dispatching on the types of every pair of keys it compares.
+    BSONType _keyType = BSONType::EOO;
+
+    // True once the keys are known not to share a single type, or if the sort is on several
+    // fields.
+    bool _mixedKeyTypes = false;
+
+    // 1 if the single-field sort is ascending and -1 if it is descending.
+    int _keyDirection = 1;
+
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
     // and sorted.
     // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data is maintained as a heap whose front is the item with the highest key, so that
+    // it can be replaced cheaply when a lower key arrives.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // The external sort. Keys are sort keys with the RecordId appended as a final field, so
+    // that ties are broken as they are in memory. Values are the documents.
+    using SpillSorter = Sorter<BSONObj, BSONObj>;
+
+    // Non-null once we have spilled and until all input has been added.
+    std::unique_ptr<SpillSorter> _sorter;
+
+    // Non-null if we spilled, once all input has been sorted.
+    std::unique_ptr<SpillSorter::Iterator> _sorterIterator;
+
     // We buffer a lot of data and we want to look it up by RecordId quickly upon invalidation.
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
@@ -178,6 +240,9 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Reports _memUsage to the BlockingMemoryTracker.
+    BlockingMemoryTracker::Reservation _memoryReservation;
 };
 
 }  // namespace mongo
@@ -32,6 +32,9 @@
 
 #include "mongo/db/exec/sort.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/optional.hpp>
 
 #include "mongo/db/exec/queued_data_stage.h"
@@ -44,6 +47,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace mongo;
 
@@ -300,4 +304,94 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+//
+// Sorting on keys which all have the same type uses a comparator specialized for that type, and
+// should order them exactly as the generic comparison does.
+//
+
+TEST_F(SortStageTest, SortAscendingDoublesWithNaN) {
+    testWork("{a: 1}",
+             nullptr,
+             0,
+             "{input: [{a: 1.5}, {a: NaN}, {a: -2.5}, {a: 3.5}]}",
+             "{output: [{a: NaN}, {a: -2.5}, {a: 1.5}, {a: 3.5}]}");
+}
+
+TEST_F(SortStageTest, SortAscendingLongsWithLimit) {
+    testWork("{a: 1}",
+             nullptr,
+             2,
+             "{input: [{a: NumberLong(3)}, {a: NumberLong(-1)}, {a: NumberLong(2)}]}",
+             "{output: [{a: NumberLong(-1)}, {a: NumberLong(2)}]}");
+}
+
+TEST_F(SortStageTest, SortDescendingStrings) {
+    testWork("{a: -1}",
+             nullptr,
+             0,
+             "{input: [{a: 'ab'}, {a: 'a'}, {a: 'b'}]}",
+             "{output: [{a: 'b'}, {a: 'ab'}, {a: 'a'}]}");
+}
+
+TEST_F(SortStageTest, SortAscendingDates) {
+    testWork("{a: 1}",
+             nullptr,
+             0,
+             "{input: [{a: new Date(5)}, {a: new Date(-5)}, {a: new Date(0)}]}",
+             "{output: [{a: new Date(-5)}, {a: new Date(0)}, {a: new Date(5)}]}");
+}
+
+TEST_F(SortStageTest, SortDescendingObjectIds) {
+    testWork("{a: -1}",
+             nullptr,
+             0,
+             "{input: [{a: ObjectId('000000000000000000000002')},"
+             "{a: ObjectId('ff0000000000000000000000')},"
+             "{a: ObjectId('000000000000000000000001')}]}",
+             "{output: [{a: ObjectId('ff0000000000000000000000')},"
+             "{a: ObjectId('000000000000000000000002')},"
+             "{a: ObjectId('000000000000000000000001')}]}");
+}
+
+TEST_F(SortStageTest, SortAscendingMixedNumericTypes) {
+    testWork("{a: 1}",
+             nullptr,
+             0,
+             "{input: [{a: 2}, {a: 1.5}, {a: NumberLong(1)}]}",
+             "{output: [{a: NumberLong(1)}, {a: 1.5}, {a: 2}]}");
+}
+
+TEST_F(SortStageTest, SortManyMixedTypeCompoundKeys) {
+    // Enough documents that the stage compares their encoded sort keys.
+    const BSONObj pattern = BSON("a" << 1 << "b" << -1);
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 200; ++i) {
+        if (i % 3 == 0) {
+            docs.push_back(BSON("a" << str::stream() << "s" << i % 7 << "b" << i));
+        } else if (i % 3 == 1) {
+            docs.push_back(BSON("a" << i % 5 << "b" << i));
+        } else {
+            docs.push_back(BSON("a" << i % 5 + 0.5 << "b" << i));
+        }
+    }
+
+    BSONArrayBuilder input;
+    for (auto&& doc : docs) {
+        input.append(doc);
+    }
+    std::sort(docs.begin(), docs.end(), [&pattern](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, pattern, false) < 0;
+    });
+    BSONArrayBuilder output;
+    for (auto&& doc : docs) {
+        output.append(doc);
+    }
+
+    testWork(pattern.toString().c_str(),
+             nullptr,
+             0,
+             BSON("input" << input.arr()).toString().c_str(),
+             BSON("output" << output.arr()).toString().c_str());
+}
 }  // namespace
@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/subplan.h"
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -117,6 +118,9 @@ Status SubplanStage::planSubqueries() {
         LOG(5) << "Subplanner: index " << i << " is " << ie;
     }
 
+    // The first uncached branch of each shape, by plan cache key.
+    std::map<PlanCacheKey, size_t> firstBranchOfShape;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         // We need a place to shove the results from planning this branch.
         _branchResults.push_back(stdx::make_unique<BranchPlanningResult>());
@@ -148,33 +152,48 @@ Status SubplanStage::planSubqueries() {
                    << _orExpression->numChildren();
 
             branchResult->cachedSolution.reset(rawCS);
-        } else {
-            // No CachedSolution found. We'll have to plan from scratch.
-            LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
-
-            // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
-            // considering any plan that's a collscan.
-            invariant(branchResult->solutions.empty());
-            std::vector<QuerySolution*> rawSolutions;
-            Status status =
-                QueryPlanner::plan(*branchResult->canonicalQuery, _plannerParams, &rawSolutions);
-            branchResult->solutions = transitional_tools_do_not_use::spool_vector(rawSolutions);
-
-            if (!status.isOK()) {
-                mongoutils::str::stream ss;
-                ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
-                   << status.reason();
-                return Status(ErrorCodes::BadValue, ss);
-            }
-            LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+            continue;
+        }
 
-            if (0 == branchResult->solutions.size()) {
-                // If one child doesn't have an indexed solution, bail out.
-                mongoutils::str::stream ss;
-                ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
-                return Status(ErrorCodes::BadValue, ss);
+        if (PlanCache::shouldCacheQuery(*branchResult->canonicalQuery)) {
+            // An earlier branch of the same shape will be ranked, if it needs to be, and we can
+            // use whichever plan wins for it rather than planning this branch too.
+            const auto key =
+                _collection->infoCache()->getPlanCache()->computeKey(*branchResult->canonicalQuery);
+            const auto insertRes = firstBranchOfShape.emplace(key, i);
+            if (!insertRes.second) {
+                LOG(5) << "Subplanner: child " << i << " has the same shape as child "
+                       << insertRes.first->second;
+                branchResult->sameShapeAs = insertRes.first->second;
+                continue;
             }
         }
+
+        // No CachedSolution found. We'll have to plan from scratch.
+        LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
+
+        // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
+        // considering any plan that's a collscan.
+        invariant(branchResult->solutions.empty());
+        std::vector<QuerySolution*> rawSolutions;
+        Status status =
+            QueryPlanner::plan(*branchResult->canonicalQuery, _plannerParams, &rawSolutions);
+        branchResult->solutions = transitional_tools_do_not_use::spool_vector(rawSolutions);
+
+        if (!status.isOK()) {
+            mongoutils::str::stream ss;
+            ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
+               << status.reason();
+            return Status(ErrorCodes::BadValue, ss);
+        }
+        LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+
+        if (0 == branchResult->solutions.size()) {
+            // If one child doesn't have an indexed solution, bail out.
+            mongoutils::str::stream ss;
+            ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
+            return Status(ErrorCodes::BadValue, ss);
+        }
     }
 
     return Status::OK();
@@ -228,11 +247,31 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
     // This is the skeleton of index selections that is inserted into the cache.
     std::unique_ptr<PlanCacheIndexTree> cacheData(new PlanCacheIndexTree());
 
+    // The cache data of the plan chosen for each branch which later branches of the same shape
+    // will reuse.
+    std::vector<bool> hasSameShapeFollower(_orExpression->numChildren(), false);
+    for (const auto& branchResult : _branchResults) {
+        if (branchResult->sameShapeAs) {
+            hasSameShapeFollower[*branchResult->sameShapeAs] = true;
+        }
+    }
+    std::vector<std::unique_ptr<SolutionCacheData>> chosenCacheData(_orExpression->numChildren());
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         MatchExpression* orChild = _orExpression->getChild(i);
         BranchPlanningResult* branchResult = _branchResults[i].get();
 
-        if (branchResult->cachedSolution.get()) {
+        if (branchResult->sameShapeAs) {
+            // An earlier branch of the same shape has already been planned.
+            Status tagStatus =
+                tagOrChildAccordingToCache(cacheData.get(),
+                                           chosenCacheData[*branchResult->sameShapeAs].get(),
+                                           orChild,
+                                           _indexMap);
+            if (!tagStatus.isOK()) {
+                return tagStatus;
+            }
+        } else if (branchResult->cachedSolution.get()) {
             // We can get the index tags we need out of the cache.
             Status tagStatus = tagOrChildAccordingToCache(
                 cacheData.get(), branchResult->cachedSolution->plannerData[0], orChild, _indexMap);
@@ -246,6 +285,10 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             if (!tagStatus.isOK()) {
                 return tagStatus;
             }
+
+            if (hasSameShapeFollower[i]) {
+                chosenCacheData[i].reset(soln->cacheData->clone());
+            }
         } else {
             // N solutions, rank them.
 
@@ -324,6 +367,10 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             }
 
             cacheData->children.push_back(bestSoln->cacheData->tree->clone());
+
+            if (hasSameShapeFollower[i]) {
+                chosenCacheData[i].reset(bestSoln->cacheData->clone());
+            }
         }
     }
 
@@ -493,6 +540,10 @@ bool SubplanStage::branchPlannedFromCache(size_t i) const {
     return NULL != _branchResults[i]->cachedSolution.get();
 }
 
+bool SubplanStage::branchPlannedFromEarlierBranch(size_t i) const {
+    return bool(_branchResults[i]->sameShapeAs);
+}
+
 const SpecificStats* SubplanStage::getSpecificStats() const {
     return NULL;
 }
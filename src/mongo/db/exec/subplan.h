@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -66,6 +67,10 @@ class OperationContext;
  *   another rooted $or query, or shape C as its own query.
  *
  *   --Plans for entire rooted $or queries are neither written to nor read from the plan cache.
+ *
+ *   --Clauses which have the same shape as an earlier clause of the same $or, and which have no
+ *   cached plan, are not planned at all. They reuse the index tags of the plan chosen for that
+ *   earlier clause, just as they would reuse a cache entry for it.
  */
 class SubplanStage final : public PlanStage {
 public:
@@ -117,6 +122,12 @@ public:
      */
     bool branchPlannedFromCache(size_t i) const;
 
+    /**
+     * Returns true if the i-th branch reused the plan chosen for an earlier branch of the same
+     * shape, otherwise returns false.
+     */
+    bool branchPlannedFromEarlierBranch(size_t i) const;
+
     /**
      * Provide access to the query solution for our composite solution. Does not relinquish
      * ownership.
@@ -147,6 +158,10 @@ private:
 
         // Query solutions resulting from planning the $or branch.
         std::vector<std::unique_ptr<QuerySolution>> solutions;
+
+        // If set, the index of an earlier branch with the same plan cache shape. This branch is
+        // then neither planned nor ranked, and uses the plan chosen for that branch instead.
+        boost::optional<size_t> sameShapeAs;
     };
 
     /**
@@ -121,7 +121,15 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
         // compute their text scores. This is a blocking operation.
-        auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+        const auto& terms = _params.query.getTermsForBounds();
+        auto textScorer = make_unique<TextOrStage>(opCtx,
+                                                   _params.spec,
+                                                   ws,
+                                                   filter,
+                                                   _params.index,
+                                                   _params.topK,
+                                                   std::vector<std::string>(terms.begin(),
+                                                                            terms.end()));
 
         textScorer->addChildren(std::move(indexScanList));
 
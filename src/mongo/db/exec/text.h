@@ -67,6 +67,10 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If non-zero, only the 'topK' results with the highest text scores are needed. Must only be
+    // set when every document containing a positive term matches the query.
+    size_t topK = 0;
 };
 
 /**
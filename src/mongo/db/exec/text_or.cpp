@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -53,15 +55,43 @@ using fts::FTSSpec;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
+namespace {
+
+// The minimum number of postings read in top-k mode between two attempts to select the top-k
+// documents. Each attempt is linear in the number of buffered documents, so the interval also
+// grows with the size of the score map.
+const size_t kMinPostingsBetweenTopKChecks = 1024;
+
+/**
+ * Returns the score stored in the text index key 'key', which has the format
+ * {prefix, term, score, suffix}.
+ */
+double getTermScoreFromKey(const BSONObj& key, unsigned numExtraBefore) {
+    BSONObjIterator keyIt(key);
+    for (unsigned i = 0; i < numExtraBefore; i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    return keyIt.next().number();
+}
+
+}  // namespace
+
 TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t topK,
+                         std::vector<std::string> topKTerms)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _topK(topK),
+      _topKTerms(std::move(topKTerms)),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
       _index(index) {}
@@ -108,11 +138,22 @@ void TextOrStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inva
     // Remove the RecordID from the ScoreMap.
     ScoreMap::iterator scoreIt = _scores.find(dl);
     if (scoreIt != _scores.end()) {
-        if (scoreIt == _scoreIterator) {
+        if (!_topK && scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
         _scores.erase(scoreIt);
     }
+
+    // If the document was selected as one of the top-k but not returned yet, select again from
+    // the remaining documents.
+    if (_topK && _internalState == State::kReturningResults &&
+        std::find(_topKResults.begin() + _topKPosition, _topKResults.end(), dl) !=
+            _topKResults.end()) {
+        _topKResults.clear();
+        _topKPosition = 0;
+        _postingsUntilCheck = 0;
+        _internalState = State::kReadingTerms;
+    }
 }
 
 std::unique_ptr<PlanStageStats> TextOrStage::getStats() {
@@ -150,10 +191,10 @@ PlanStage::StageState TextOrStage::doWork(WorkingSetID* out) {
             stageState = initStage(out);
             break;
         case State::kReadingTerms:
-            stageState = readFromChildren(out);
+            stageState = _topK ? readFromChildrenTopK(out) : readFromChildren(out);
             break;
         case State::kReturningResults:
-            stageState = returnResults(out);
+            stageState = _topK ? returnTopKResults(out) : returnResults(out);
             break;
         case State::kDone:
             // Should have been handled above.
@@ -169,6 +210,14 @@ PlanStage::StageState TextOrStage::initStage(WorkingSetID* out) {
     try {
         _recordCursor = _index->getCollection()->getCursor(getOpCtx());
         _internalState = State::kReadingTerms;
+        if (_topK) {
+            // The documents' sets of seen children are tracked in a 64-bit mask.
+            invariant(_children.size() == _topKTerms.size());
+            invariant(_children.size() <= 64u);
+            _lastChildScore.assign(_children.size(), std::numeric_limits<double>::infinity());
+            _childEOF.assign(_children.size(), false);
+            _postingsUntilCheck = kMinPostingsBetweenTopKChecks;
+        }
         return PlanStage::NEED_TIME;
     } catch (const WriteConflictException&) {
         invariant(_internalState == State::kInit);
@@ -311,19 +360,220 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     }
 
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
-    }
-
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    double documentTermScore =
+        getTermScoreFromKey(newKeyData.keyData, _ftsSpec.numExtraBefore());
 
     // Aggregate relevance score, term keys.
     textRecordData->score += documentTermScore;
     return NEED_TIME;
 }
 
+PlanStage::StageState TextOrStage::readFromChildrenTopK(WorkingSetID* out) {
+    if (_children.size() == 0) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+
+    if (_postingsUntilCheck > 0 && _numChildrenEOF < _children.size()) {
+        // Move on to the next child which still has postings.
+        while (_childEOF[_currentChild]) {
+            _currentChild = (_currentChild + 1) % _children.size();
+        }
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState childState = _children[_currentChild]->work(&id);
+
+        if (PlanStage::ADVANCED == childState) {
+            addPosting(_currentChild, id);
+            _currentChild = (_currentChild + 1) % _children.size();
+        } else if (PlanStage::IS_EOF == childState) {
+            _childEOF[_currentChild] = true;
+            ++_numChildrenEOF;
+        } else if (PlanStage::FAILURE == childState) {
+            if (WorkingSet::INVALID_ID == id) {
+                mongoutils::str::stream ss;
+                ss << "TEXT_OR stage failed to read in results from child";
+                Status status(ErrorCodes::InternalError, ss);
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            } else {
+                *out = id;
+            }
+            return PlanStage::FAILURE;
+        } else {
+            // Propagate WSID from below.
+            *out = id;
+            return childState;
+        }
+
+        --_postingsUntilCheck;
+        if (_postingsUntilCheck > 0 && _numChildrenEOF < _children.size()) {
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    if (!selectTopK()) {
+        _postingsUntilCheck = std::max(kMinPostingsBetweenTopKChecks, _scores.size() / 2);
+        return PlanStage::NEED_TIME;
+    }
+
+    _internalState = State::kReturningResults;
+    return PlanStage::NEED_TIME;
+}
+
+void TextOrStage::addPosting(size_t childIndex, WorkingSetID wsid) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    const IndexKeyDatum& keyDatum = wsm->keyData.back();
+
+    // The child scans its term in descending score order, so this score bounds all of the
+    // child's remaining postings.
+    const double documentTermScore =
+        getTermScoreFromKey(keyDatum.keyData, _ftsSpec.numExtraBefore());
+    _lastChildScore[childIndex] = documentTermScore;
+
+    // Documents which were rejected or already returned have a negative score.
+    TextRecordData* textRecordData = &_scores[wsm->recordId];
+    const uint64_t childBit = uint64_t{1} << childIndex;
+    if (textRecordData->score >= 0 && !(textRecordData->childrenSeen & childBit)) {
+        if (!textRecordData->childrenSeen &&
+            !Filter::passes(keyDatum.keyData, keyDatum.indexKeyPattern, _filter)) {
+            textRecordData->score = -1;
+        } else {
+            textRecordData->score += documentTermScore;
+            textRecordData->childrenSeen |= childBit;
+        }
+    }
+
+    _ws->free(wsid);
+}
+
+bool TextOrStage::selectTopK() {
+    invariant(_numReturned < _topK);
+    size_t needed = _topK - _numReturned;
+    const bool allChildrenEOF = _numChildrenEOF == _children.size();
+
+    std::vector<ScoreMap::const_iterator> candidates;
+    for (auto it = _scores.begin(); it != _scores.end(); ++it) {
+        if (it->second.score >= 0) {
+            candidates.push_back(it);
+        }
+    }
+
+    if (candidates.size() < needed) {
+        if (!allChildrenEOF) {
+            return false;
+        }
+        needed = candidates.size();
+    }
+
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + needed,
+                     candidates.end(),
+                     [](ScoreMap::const_iterator lhs, ScoreMap::const_iterator rhs) {
+                         return lhs->second.score > rhs->second.score;
+                     });
+
+    // Once every child is exhausted the buffered scores are exact. Until then, the partial score
+    // of each selected document is a lower bound on its final score, and the selection is only
+    // proven once no other document, seen or unseen, can exceed the lowest of those bounds.
+    if (needed > 0 && !allChildrenEOF) {
+        double threshold = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < needed; ++i) {
+            threshold = std::min(threshold, candidates[i]->second.score);
+        }
+
+        double unseenBound = 0;
+        for (size_t child = 0; child < _children.size(); ++child) {
+            if (!_childEOF[child]) {
+                unseenBound += _lastChildScore[child];
+            }
+        }
+        if (unseenBound > threshold) {
+            return false;
+        }
+
+        for (size_t i = needed; i < candidates.size(); ++i) {
+            const TextRecordData& data = candidates[i]->second;
+            double bound = data.score;
+            for (size_t child = 0; child < _children.size(); ++child) {
+                if (!_childEOF[child] && !(data.childrenSeen & (uint64_t{1} << child))) {
+                    bound += _lastChildScore[child];
+                }
+            }
+            if (bound > threshold) {
+                return false;
+            }
+        }
+    }
+
+    _topKResults.clear();
+    for (size_t i = 0; i < needed; ++i) {
+        _topKResults.push_back(candidates[i]->first);
+    }
+    _topKPosition = 0;
+    return true;
+}
+
+PlanStage::StageState TextOrStage::returnTopKResults(WorkingSetID* out) {
+    if (_topKPosition == _topKResults.size()) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+
+    const RecordId recordId = _topKResults[_topKPosition];
+    boost::optional<Record> record;
+    try {
+        record = _recordCursor->seekExact(recordId);
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    ++_specificStats.fetches;
+    ++_topKPosition;
+
+    // Never consider this document again, whether or not we return it.
+    ScoreMap::iterator scoreIt = _scores.find(recordId);
+    if (scoreIt != _scores.end()) {
+        scoreIt->second.score = -1;
+    }
+
+    // Recompute the score from the document itself, since some of its postings may not have been
+    // read, and the document may have changed since they were.
+    double score = 0;
+    BSONObj obj;
+    if (record) {
+        obj = record->data.releaseToBson();
+        fts::TermFrequencyMap termFrequencies;
+        _ftsSpec.scoreDocument(obj, &termFrequencies);
+        for (auto&& term : _topKTerms) {
+            auto termIt = termFrequencies.find(term);
+            if (termIt != termFrequencies.end()) {
+                score += termIt->second;
+            }
+        }
+    }
+
+    if (score <= 0) {
+        // The document was deleted or no longer contains any of the terms. Select again from the
+        // remaining documents.
+        _topKResults.clear();
+        _topKPosition = 0;
+        _postingsUntilCheck = 0;
+        _internalState = State::kReadingTerms;
+        return NEED_TIME;
+    }
+
+    WorkingSetID wsid = _ws->allocate();
+    WorkingSetMember* wsm = _ws->get(wsid);
+    wsm->recordId = recordId;
+    wsm->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), obj};
+    _ws->transitionToRecordIdAndObj(wsid);
+    wsm->addComputed(new TextScoreComputedData(score));
+    ++_numReturned;
+
+    *out = wsid;
+    return PlanStage::ADVANCED;
+}
+
 }  // namespace mongo
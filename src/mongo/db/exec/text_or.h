@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "mongo/db/catalog/collection.h"
@@ -51,6 +52,13 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * If constructed with a non-zero 'topK', the stage only guarantees to return the 'topK' documents
+ * with the highest scores. The i-th child must then be an index scan over the i-th entry of
+ * 'topKTerms' in descending score order. The children are read in round-robin fashion, and reading
+ * stops as soon as the scores seen so far prove that no unread posting can move a document into
+ * the top 'topK'. Only the selected documents are fetched, and their scores are recomputed from
+ * the fetched documents.
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public PlanStage {
@@ -76,7 +84,9 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t topK = 0,
+                std::vector<std::string> topKTerms = {});
     ~TextOrStage();
 
     void addChild(unique_ptr<PlanStage> child);
@@ -122,6 +132,30 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Variant of readFromChildren used in top-k mode. Reads one posting from the next child in
+     * round-robin order and periodically checks whether the top-k documents have been determined.
+     */
+    StageState readFromChildrenTopK(WorkingSetID* out);
+
+    /**
+     * Helper called from readFromChildrenTopK to fold the posting held by 'wsid', which came from
+     * the child at index 'childIndex', into the partial score of its document.
+     */
+    void addPosting(size_t childIndex, WorkingSetID wsid);
+
+    /**
+     * Returns true if the partial scores read so far prove which documents are in the top-k. If
+     * so, fills out '_topKResults' with the RecordIds of those documents.
+     */
+    bool selectTopK();
+
+    /**
+     * Worker for kReturningResults in top-k mode. Fetches the next selected document, recomputes
+     * its score and returns it.
+     */
+    StageState returnTopKResults(WorkingSetID* out);
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -148,6 +182,10 @@ private:
         TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
         WorkingSetID wsid;
         double score;
+
+        // Only used in top-k mode. Bit i is set if this document's posting from child i has
+        // already been added to 'score'.
+        uint64_t childrenSeen = 0;
     };
 
     typedef unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
@@ -156,6 +194,31 @@ private:
 
     TextOrStats _specificStats;
 
+    // If non-zero, the number of top-scoring documents this stage must return. See the class
+    // comment.
+    const size_t _topK;
+    const std::vector<std::string> _topKTerms;
+
+    // The following members are only used in top-k mode.
+
+    // The score of the last posting read from each child, which bounds the scores of all of its
+    // unread postings. Infinite until the child has produced its first posting.
+    std::vector<double> _lastChildScore;
+
+    // Whether each child has hit EOF, and how many have.
+    std::vector<bool> _childEOF;
+    size_t _numChildrenEOF = 0;
+
+    // How many more postings to read before checking whether the top-k documents are known.
+    size_t _postingsUntilCheck = 0;
+
+    // The number of documents already returned to our parent.
+    size_t _numReturned = 0;
+
+    // The documents selected by selectTopK() which have not been returned yet.
+    std::vector<RecordId> _topKResults;
+    size_t _topKPosition = 0;
+
     // Members needed only for using the TextMatchableDocument.
     const MatchExpression* _filter;
     WorkingSetID _idRetrying;
@@ -198,22 +198,10 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (_collection->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     bool docWasModified = false;
 
-    Status status = Status::OK();
     const bool validateForStorage = getOpCtx()->writesAreReplicated() && _enforceOkForStorage;
     FieldRefSet immutablePaths;
     if (getOpCtx()->writesAreReplicated() && !request->isFromMigration()) {
@@ -227,48 +215,70 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(
-            StringData(), &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
+
+    // Simple $set and $inc updates which keep the binary layout of the document can be turned
+    // into damage events straight from the stored BSON, without building a mutable document.
+    const char* source = NULL;
+    bool inPlace = false;
+    if (_collection->updateWithDamagesSupported() &&
+        driver->updateInPlace(
+            oldObj.value(), immutablePaths, &_damages, &source, &logObj, &docWasModified)) {
+        inPlace = true;
     } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (_collection->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        Status status = Status::OK();
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(
+                StringData(), &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
 
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
 
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
 
-        status = driver->update(
-            matchedField, &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
-    }
+            status = driver->update(
+                matchedField, &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
+        }
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !_collection->isCapped();
+        // Skip adding _id field if the collection is capped (since capped collection documents can
+        // neither grow nor shrink).
+        const auto createIdField = !_collection->isCapped();
 
-    // Ensure if _id exists it is first
-    status = ensureIdFieldIsFirst(&_doc);
-    if (status.code() == ErrorCodes::InvalidIdField) {
-        // Create ObjectId _id field if we are doing that
-        if (createIdField) {
-            addObjectIDIdField(&_doc);
+        // Ensure if _id exists it is first
+        status = ensureIdFieldIsFirst(&_doc);
+        if (status.code() == ErrorCodes::InvalidIdField) {
+            // Create ObjectId _id field if we are doing that
+            if (createIdField) {
+                addObjectIDIdField(&_doc);
+            }
+        } else {
+            uassertStatusOK(status);
         }
-    } else {
-        uassertStatusOK(status);
-    }
 
-    // See if the changes were applied in place
-    const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+        // See if the changes were applied in place
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    }
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -335,6 +345,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                           newObj,
                                                           true,
                                                           driver->modsAffectIndices(),
+                                                          driver->getAffectedIndexes(),
                                                           _params.opDebug,
                                                           &args);
             }
@@ -606,8 +617,9 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
 
         if (!docStillMatches) {
             // Either the document has been deleted, or it has been updated such that it no longer
-            // matches the predicate.
-            if (shouldRestartUpdateIfNoLongerMatches(_params)) {
+            // matches the predicate. If the child can still produce documents, the next one is
+            // the next candidate in sort order, so there is no need to restart.
+            if (shouldRestartUpdateIfNoLongerMatches(_params) && child()->isEOF()) {
                 throw WriteConflictException();
             }
             return PlanStage::NEED_TIME;
@@ -46,7 +46,10 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyPeriod(0),
+          highFrequencyStallThreshold(0),
+          maxHighFrequencyBufferBytes(kMaxHighFrequencyBufferBytesDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,6 +86,25 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Period at which to run the high-frequency collectors into the in-memory ring buffer. Zero
+     * disables high-frequency capture.
+     */
+    Milliseconds highFrequencyPeriod;
+
+    /**
+     * If collecting a single high-frequency sample takes longer than this, or the gap between two
+     * high-frequency samples exceeds the high-frequency period by more than this, the ring buffer
+     * is flushed to disk. Zero disables the automatic flush.
+     */
+    Milliseconds highFrequencyStallThreshold;
+
+    /**
+     * Maximum size of the compressed metric chunks retained in the high-frequency ring buffer. The
+     * oldest chunks are discarded first.
+     */
+    std::uint64_t maxHighFrequencyBufferBytes;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -93,6 +115,9 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const std::uint64_t kMaxHighFrequencyBufferBytesDefault = 4 * 1024 * 1024;
+    static const std::uint32_t kSamplesPerHighFrequencyChunk = 100;
 };
 
 }  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include "mongo/db/ftdc/controller.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/util.h"
@@ -92,6 +94,30 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
+void FTDCController::setHighFrequencyStallThreshold(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyStallThreshold = millis;
+    _condvar.notify_one();
+}
+
+void FTDCController::setMaxHighFrequencyBufferBytes(std::uint64_t size) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.maxHighFrequencyBufferBytes = size;
+    _condvar.notify_one();
+}
+
+void FTDCController::requestHighFrequencyFlush() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _highFrequencyFlushRequested = true;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -118,6 +144,15 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -194,13 +229,28 @@ void FTDCController::doLoop() {
         Client::initThread("ftdc");
         Client* client = &cc();
 
+        // Start time of the previous high-frequency sample, used to detect collection stalls
+        Date_t lastHighFrequencySample;
+
         while (true) {
             // Compute the next interval to run regardless of how we were woken up
             // Skipping an interval due to a race condition with a config signal is harmless.
             auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
-            // Get next time to run at
-            auto next_time = FTDCUtil::roundTime(now, _config.period);
+            // Get next time to run at, the high-frequency collectors may need to run earlier than
+            // the periodic collectors
+            auto nextPeriodicTime = FTDCUtil::roundTime(now, _config.period);
+            auto nextTime = nextPeriodicTime;
+
+            bool highFrequencyEnabled = _config.highFrequencyPeriod > Milliseconds(0);
+            auto nextHighFrequencyTime = Date_t::max();
+            if (highFrequencyEnabled) {
+                nextHighFrequencyTime = FTDCUtil::roundTime(now, _config.highFrequencyPeriod);
+                nextTime = std::min(nextTime, nextHighFrequencyTime);
+            }
+
+            bool timedOut = false;
+            bool flushRequested = false;
 
             // Wait for the next run or signal to shutdown
             {
@@ -208,7 +258,11 @@ void FTDCController::doLoop() {
                 MONGO_IDLE_THREAD_BLOCK;
 
                 // We ignore spurious wakeups by just doing an iteration of the loop
-                auto status = _condvar.wait_until(lock, next_time.toSystemTimePoint());
+                // A flush request that arrived while collecting is handled without waiting.
+                if (!_highFrequencyFlushRequested) {
+                    timedOut = _condvar.wait_until(lock, nextTime.toSystemTimePoint()) ==
+                        stdx::cv_status::timeout;
+                }
 
                 // Are we done running?
                 if (_state == State::kStopRequested) {
@@ -222,13 +276,26 @@ void FTDCController::doLoop() {
                 // GetFileSystemTime for now which has ~10 ms granularity.
                 _config = _configTemp;
 
+                flushRequested = _highFrequencyFlushRequested;
+                _highFrequencyFlushRequested = false;
+
                 // if we hit a timeout on the condvar, we need to do another collection
-                // if we were signalled, then we have a config update only or were asked to stop
-                if (status == stdx::cv_status::no_timeout) {
+                // if we were signalled, then we have a config update only, a flush request, or were
+                // asked to stop
+                if (!timedOut && !flushRequested) {
                     continue;
                 }
             }
 
+            // Drop buffered samples as soon as high-frequency collection is turned off
+            highFrequencyEnabled = highFrequencyEnabled && _config.enabled &&
+                _config.highFrequencyPeriod > Milliseconds(0);
+            if (!highFrequencyEnabled) {
+                _highFrequencyBuffer.clear();
+                lastHighFrequencySample = Date_t();
+            }
+            _highFrequencyBuffer.setMaxBufferBytes(_config.maxHighFrequencyBufferBytes);
+
             // TODO: consider only running this thread if we are enabled
             // for now, we just keep an idle thread as it is simpler
             if (_config.enabled) {
@@ -241,17 +308,59 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                if (timedOut && highFrequencyEnabled && nextTime == nextHighFrequencyTime) {
+                    auto collectSample = _highFrequencyCollectors.collect(client);
+                    auto start = std::get<1>(collectSample);
+                    auto end = getGlobalServiceContext()->getPreciseClockSource()->now();
+
+                    uassertStatusOK(
+                        _highFrequencyBuffer.addSample(std::get<0>(collectSample), start));
+
+                    // A sample that takes too long to collect, or a sample that is late because
+                    // this thread could not run, both indicate a stall worth keeping
+                    auto threshold = _config.highFrequencyStallThreshold;
+                    if (threshold > Milliseconds(0)) {
+                        Milliseconds stall = end - start;
+                        if (lastHighFrequencySample != Date_t()) {
+                            stall = std::max(stall,
+                                             start - lastHighFrequencySample -
+                                                 _config.highFrequencyPeriod);
+                        }
+
+                        if (stall > threshold) {
+                            log() << "Writing high-frequency diagnostic data to disk after a "
+                                  << stall << " stall";
+                            flushRequested = true;
+                        }
+                    }
+
+                    lastHighFrequencySample = start;
+                }
+
+                if (timedOut && nextTime == nextPeriodicTime) {
+                    auto collectSample = _periodicCollectors.collect(client);
+
+                    Status s = _mgr->writeSampleAndRotateIfNeeded(
+                        client, std::get<0>(collectSample), std::get<1>(collectSample));
+
+                    uassertStatusOK(s);
+
+                    // Store a reference to the most recent document from the periodic collectors
+                    {
+                        stdx::lock_guard<stdx::mutex> lock(_mutex);
+                        _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    }
+                }
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                if (flushRequested) {
+                    auto swChunks = _highFrequencyBuffer.drain();
+                    uassertStatusOK(swChunks.getStatus());
 
-                uassertStatusOK(s);
+                    uassertStatusOK(
+                        _mgr->writeMetricChunksAndRotateIfNeeded(client, swChunks.getValue()));
 
-                // Store a reference to the most recent document from the periodic collectors
-                {
-                    stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    // Writing to disk delays the next sample, which must not count as a stall
+                    lastHighFrequencySample = Date_t();
                 }
             }
         }
@@ -36,6 +36,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/high_frequency_buffer.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -56,7 +57,10 @@ class FTDCController {
 
 public:
     FTDCController(const boost::filesystem::path path, FTDCConfig config)
-        : _path(path), _config(std::move(config)), _configTemp(_config) {}
+        : _path(path),
+          _config(std::move(config)),
+          _configTemp(_config),
+          _highFrequencyBuffer(_config.maxHighFrequencyBufferBytes) {}
 
     ~FTDCController() = default;
 
@@ -98,6 +102,30 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set the period for high-frequency data collection into the in-memory ring buffer. Zero
+     * disables high-frequency collection.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
+    /**
+     * Set the collection stall that causes the high-frequency ring buffer to be written to disk.
+     * Zero disables the automatic flush.
+     */
+    void setHighFrequencyStallThreshold(Milliseconds millis);
+
+    /**
+     * Set the maximum size in bytes of the high-frequency ring buffer.
+     */
+    void setMaxHighFrequencyBufferBytes(std::uint64_t size);
+
+    /**
+     * Ask the background thread to write the contents of the high-frequency ring buffer to disk.
+     *
+     * The flush happens asynchronously, and is a no-op if FTDC is disabled.
+     */
+    void requestHighFrequencyFlush();
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -110,6 +138,12 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high-frequency period into the ring buffer. These
+     * should be a reduced metric set that is cheap enough to run every few milliseconds.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -203,6 +237,15 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Set of high-frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
+    // Recent high-frequency samples, only accessed by the background thread
+    FTDCHighFrequencyBuffer _highFrequencyBuffer;
+
+    // Set by requestHighFrequencyFlush, and cleared by the background thread
+    bool _highFrequencyFlushRequested{false};
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
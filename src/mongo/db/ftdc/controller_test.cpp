@@ -41,6 +41,7 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/file_reader.h"
 #include "mongo/db/ftdc/ftdc_test.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
@@ -277,4 +278,76 @@ TEST(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs);
 }
 
+// Test the high-frequency ring buffer is only written to disk once a flush is requested
+TEST(FTDCControllerTest, TestHighFrequencyFlush) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.enabled = true;
+    // Keep the periodic collectors out of the way, they only run on day boundaries
+    config.period = Milliseconds(24 * 60 * 60 * 1000);
+    config.highFrequencyPeriod = Milliseconds(1);
+    config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+    config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+
+    FTDCController c(dir, config);
+
+    auto c1 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+    auto c2 = stdx::make_unique<FTDCMetricsCollectorMockRotate>();
+
+    auto c1Ptr = c1.get();
+    auto c2Ptr = c2.get();
+
+    c1Ptr->setSignalOnCount(150);
+
+    c.addHighFrequencyCollector(std::move(c1));
+
+    c.addOnRotateCollector(std::move(c2));
+
+    c.start();
+
+    // Wait for 150 samples to have occured
+    c1Ptr->wait();
+
+    c.requestHighFrequencyFlush();
+
+    // The flush is done before the collector runs more than once more
+    c1Ptr->setSignalOnCount(155);
+    c1Ptr->wait();
+
+    c.stop();
+
+    auto docsRotate = c2Ptr->getDocs();
+    ASSERT_EQUALS(docsRotate.size(), 1UL);
+
+    auto files = scanDirectory(dir);
+
+    ASSERT_EQUALS(files.size(), 1UL);
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(files[0]));
+
+    std::vector<BSONObj> list;
+    auto sw = reader.hasNext();
+    while (sw.isOK() && sw.getValue()) {
+        list.emplace_back(std::get<1>(reader.next()).getOwned());
+        sw = reader.hasNext();
+    }
+    ASSERT_OK(sw);
+
+    // The file has the rotate document followed by every high-frequency sample up to the flush
+    auto docsHighFrequency = c1Ptr->getDocs();
+    ASSERT_GREATER_THAN_OR_EQUALS(list.size(), 151UL);
+    ASSERT_LESS_THAN(list.size(), docsHighFrequency.size() + 1);
+
+    std::vector<BSONObj> allDocs(docsRotate.begin(), docsRotate.end());
+    allDocs.insert(
+        allDocs.end(), docsHighFrequency.begin(), docsHighFrequency.begin() + list.size() - 1);
+
+    ValidateDocumentList(list, allDocs);
+}
+
 }  // namespace mongo
@@ -306,6 +306,27 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeMetricChunksAndRotateIfNeeded(Client* client,
+                                                           const std::vector<BSONObj>& chunks) {
+    for (const auto& chunk : chunks) {
+        Status s = _writer.writeMetricChunk(chunk);
+
+        if (!s.isOK()) {
+            return s;
+        }
+
+        if (_writer.getSize() > _config->maxFileSizeBytes) {
+            s = rotate(client);
+
+            if (!s.isOK()) {
+                return s;
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
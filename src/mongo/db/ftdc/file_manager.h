@@ -84,6 +84,13 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes already compressed metric chunk documents to disk via FTDCFileWriter.
+     *
+     * Rotates files as needed.
+     */
+    Status writeMetricChunksAndRotateIfNeeded(Client* client, const std::vector<BSONObj>& chunks);
+
     /**
      * Closes the current file manager down.
      */
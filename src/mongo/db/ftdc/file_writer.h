@@ -79,6 +79,12 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write an already compressed metric chunk document directly to the archive log. Samples
+     * buffered for the next chunk of writeSample are not affected.
+     */
+    Status writeMetricChunk(const BSONObj& chunk);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
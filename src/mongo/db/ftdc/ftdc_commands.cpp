@@ -101,10 +101,58 @@ public:
     }
 };
 
+/**
+ * Write the samples FTDC holds in its high-frequency ring buffer to the diagnostic data directory.
+ *
+ * The write happens asynchronously on the FTDC thread.
+ */
+class FlushHighFrequencyDiagnosticDataCommand final : public BasicCommand {
+public:
+    FlushHighFrequencyDiagnosticDataCommand()
+        : BasicCommand("flushHighFrequencyDiagnosticData") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "write the high-frequency diagnostic data ring buffer to disk";
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        FTDCController::get(opCtx->getServiceContext())->requestHighFrequencyFlush();
+        return true;
+    }
+};
+
 Command* ftdcCommand;
+Command* ftdcFlushCommand;
 
 MONGO_INITIALIZER(CreateDiagnosticDataCommand)(InitializerContext* context) {
     ftdcCommand = new GetDiagnosticDataCommand();
+    ftdcFlushCommand = new FlushHighFrequencyDiagnosticDataCommand();
 
     return Status::OK();
 }
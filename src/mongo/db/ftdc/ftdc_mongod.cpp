@@ -32,17 +32,76 @@
 
 #include <boost/filesystem.hpp>
 
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_server.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
 namespace {
+
+/**
+ * Number of idents, ranked by bytes in the storage engine cache, whose cache statistics are
+ * sampled into FTDC. Zero disables the collector.
+ */
+AtomicInt32 diagnosticDataCollectionIdentCacheTopN(10);
+
+class IdentCacheTopNParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    IdentCacheTopNParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionIdentCacheTopN",
+              &diagnosticDataCollectionIdentCacheTopN) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0 || potentialNewValue > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionIdentCacheTopN must be between 0 and 1000");
+        }
+        return Status::OK();
+    }
+} identCacheTopNParameter;
+
+/**
+ * Collects the cache residency and I/O statistics of the idents that occupy the most of the
+ * storage engine cache.
+ */
+class FTDCIdentCacheStatsCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const final {
+        return "identCache";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        const int topN = diagnosticDataCollectionIdentCacheTopN.load();
+        if (topN <= 0) {
+            return;
+        }
+
+        Lock::GlobalLock lk(opCtx, MODE_IS, UINT_MAX);
+        StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+        if (!storageEngine) {
+            return;
+        }
+        storageEngine->appendIdentCacheStats(opCtx, static_cast<size_t>(topN), &builder);
+    }
+};
+
 void registerMongoDCollectors(FTDCController* controller) {
+    controller->addPeriodicCollector(stdx::make_unique<FTDCIdentCacheStatsCollector>());
+
     // These metrics are only collected if replication is enabled
     if (repl::getGlobalReplicationCoordinator()->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
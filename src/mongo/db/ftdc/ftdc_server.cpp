@@ -241,6 +241,91 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicInt32 localHighFrequencyPeriodMillis(0);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && (potentialNewValue < 10 || potentialNewValue > 1000)) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 to disable "
+                          "high-frequency collection, or between 10ms and 1000ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
+AtomicInt32 localHighFrequencyStallThresholdMillis(0);
+
+class ExportedFTDCHighFrequencyStallThresholdParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyStallThresholdParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyStallThresholdMillis",
+              &localHighFrequencyStallThresholdMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyStallThresholdMillis must be "
+                          "greater than or equal to 0");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyStallThreshold(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyStallThresholdParameter;
+
+AtomicInt32 localMaxHighFrequencyBufferSizeMB(FTDCConfig::kMaxHighFrequencyBufferBytesDefault /
+                                              (1024 * 1024));
+
+class ExportedFTDCHighFrequencyBufferSizeParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyBufferSizeParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyBufferSizeMB",
+              &localMaxHighFrequencyBufferSizeMB) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyBufferSizeMB must be greater than "
+                          "or equal to 1");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setMaxHighFrequencyBufferBytes(potentialNewValue * 1024 * 1024);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyBufferSizeParameter;
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -278,6 +363,10 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
+    config.highFrequencyStallThreshold =
+        Milliseconds(localHighFrequencyStallThresholdMillis.load());
+    config.maxHighFrequencyBufferBytes = localMaxHighFrequencyBufferSizeMB.load() * 1024 * 1024;
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
@@ -298,6 +387,24 @@ void startFTDC(boost::filesystem::path& path,
         "",
         BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false)));
 
+    // Install high-frequency collectors
+    // These are collected on the high-frequency period into the in-memory ring buffer, so only the
+    // sections needed to diagnose short stalls (globalLock, opcounters, storage engine cache and
+    // checkpoint statistics) are kept.
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
+        "serverStatus",
+        "serverStatus",
+        "",
+        BSON("serverStatus" << 1 << "asserts" << false << "locks" << false << "metrics" << false
+                            << "opLatencies"
+                            << false
+                            << "repl"
+                            << false
+                            << "sharding"
+                            << false
+                            << "tcmalloc"
+                            << false)));
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
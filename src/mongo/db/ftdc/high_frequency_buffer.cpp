@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/high_frequency_buffer.h"
+
+#include "mongo/db/ftdc/util.h"
+
+namespace mongo {
+
+FTDCHighFrequencyBuffer::FTDCHighFrequencyBuffer(std::uint64_t maxBufferBytes)
+    : _compressor(&_compressorConfig), _maxBufferBytes(maxBufferBytes) {
+    _compressorConfig.maxSamplesPerArchiveMetricChunk = FTDCConfig::kSamplesPerHighFrequencyChunk;
+}
+
+Status FTDCHighFrequencyBuffer::addSample(const BSONObj& sample, Date_t date) {
+    auto ret = _compressor.addSample(sample, date);
+
+    if (!ret.isOK()) {
+        return ret.getStatus();
+    }
+
+    if (ret.getValue().is_initialized()) {
+        _push(FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(ret.getValue().get()),
+                                                          std::get<2>(ret.getValue().get())));
+    }
+
+    return Status::OK();
+}
+
+StatusWith<std::vector<BSONObj>> FTDCHighFrequencyBuffer::drain() {
+    if (_compressor.hasDataToFlush()) {
+        auto swBuf = _compressor.getCompressedSamples();
+
+        if (!swBuf.isOK()) {
+            return swBuf.getStatus();
+        }
+
+        _push(FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
+                                                          std::get<1>(swBuf.getValue())));
+        _compressor.reset();
+    }
+
+    std::vector<BSONObj> chunks(_chunks.begin(), _chunks.end());
+
+    _chunks.clear();
+    _sizeBytes = 0;
+
+    return {std::move(chunks)};
+}
+
+void FTDCHighFrequencyBuffer::clear() {
+    _compressor.reset();
+    _chunks.clear();
+    _sizeBytes = 0;
+}
+
+void FTDCHighFrequencyBuffer::setMaxBufferBytes(std::uint64_t maxBufferBytes) {
+    _maxBufferBytes = maxBufferBytes;
+    _evict();
+}
+
+void FTDCHighFrequencyBuffer::_push(BSONObj chunk) {
+    _sizeBytes += chunk.objsize();
+    _chunks.push_back(std::move(chunk));
+    _evict();
+}
+
+void FTDCHighFrequencyBuffer::_evict() {
+    while (_chunks.size() > 1 && _sizeBytes > _maxBufferBytes) {
+        _sizeBytes -= _chunks.front().objsize();
+        _chunks.pop_front();
+    }
+}
+
+}  // namespace mongo
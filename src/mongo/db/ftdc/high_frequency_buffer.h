@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * FTDCHighFrequencyBuffer keeps the most recent high-frequency samples in memory so that they can
+ * be written to disk after a stall has been observed.
+ *
+ * Samples are delta encoded with FTDCCompressor into metric chunks of
+ * FTDCConfig::kSamplesPerHighFrequencyChunk samples. Completed chunks are kept as BSON metric chunk
+ * documents (see FTDCBSONUtil::createBSONMetricChunkDocument) in a ring which discards the oldest
+ * chunk once the configured byte limit is exceeded. The chunk under construction is only
+ * compressed when the buffer is drained.
+ *
+ * Not thread safe, it is owned by the FTDC background thread.
+ */
+class FTDCHighFrequencyBuffer {
+    MONGO_DISALLOW_COPYING(FTDCHighFrequencyBuffer);
+
+public:
+    explicit FTDCHighFrequencyBuffer(std::uint64_t maxBufferBytes);
+
+    /**
+     * Add a sample to the buffer, possibly completing a metric chunk and evicting old ones.
+     */
+    Status addSample(const BSONObj& sample, Date_t date);
+
+    /**
+     * Return all buffered metric chunk documents, oldest first, including the partially filled
+     * chunk. The buffer is empty afterwards.
+     */
+    StatusWith<std::vector<BSONObj>> drain();
+
+    /**
+     * Discard all buffered samples.
+     */
+    void clear();
+
+    /**
+     * Change the byte limit, evicting old chunks as needed.
+     */
+    void setMaxBufferBytes(std::uint64_t maxBufferBytes);
+
+    /**
+     * Size in bytes of the completed metric chunks in the buffer.
+     */
+    std::uint64_t getSizeBytes() const {
+        return _sizeBytes;
+    }
+
+    /**
+     * Number of completed metric chunks in the buffer.
+     */
+    std::size_t getChunkCount() const {
+        return _chunks.size();
+    }
+
+private:
+    /**
+     * Append a completed chunk and evict as needed.
+     */
+    void _push(BSONObj chunk);
+
+    /**
+     * Evict the oldest chunks while over the byte limit. The most recent chunk is always retained.
+     */
+    void _evict();
+
+private:
+    // Config used by the compressor, only the chunk size is meaningful.
+    FTDCConfig _compressorConfig;
+
+    FTDCCompressor _compressor;
+
+    // Completed metric chunk documents, oldest first
+    std::deque<BSONObj> _chunks;
+
+    // Sum of the objsize of _chunks
+    std::uint64_t _sizeBytes{0};
+
+    std::uint64_t _maxBufferBytes;
+};
+
+}  // namespace mongo
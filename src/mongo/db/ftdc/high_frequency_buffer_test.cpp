@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/decompressor.h"
+#include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/high_frequency_buffer.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeSample(int i) {
+    return BSON("name"
+                << "joe"
+                << "key1"
+                << (i * 37)
+                << "key2"
+                << static_cast<long long>(i) * i);
+}
+
+std::vector<BSONObj> uncompressChunks(const std::vector<BSONObj>& chunks) {
+    FTDCDecompressor decompressor;
+    std::vector<BSONObj> docs;
+
+    for (const auto& chunk : chunks) {
+        auto swType = FTDCBSONUtil::getBSONDocumentType(chunk);
+        ASSERT_OK(swType.getStatus());
+        ASSERT_TRUE(swType.getValue() == FTDCBSONUtil::FTDCType::kMetricChunk);
+
+        auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(chunk, &decompressor);
+        ASSERT_OK(swDocs.getStatus());
+
+        for (const auto& doc : swDocs.getValue()) {
+            docs.push_back(doc.getOwned());
+        }
+    }
+
+    return docs;
+}
+
+// Samples round trip through the buffer, including the partially filled chunk
+TEST(FTDCHighFrequencyBufferTest, TestDrain) {
+    FTDCHighFrequencyBuffer buffer(FTDCConfig::kMaxHighFrequencyBufferBytesDefault);
+
+    std::vector<BSONObj> samples;
+    for (int i = 0; i < 250; ++i) {
+        samples.push_back(makeSample(i));
+        ASSERT_OK(buffer.addSample(samples.back(), Date_t::fromMillisSinceEpoch(i)));
+    }
+
+    // Two full chunks, the rest is still in the compressor
+    ASSERT_EQUALS(buffer.getChunkCount(), 2UL);
+
+    auto swChunks = buffer.drain();
+    ASSERT_OK(swChunks.getStatus());
+    ASSERT_EQUALS(swChunks.getValue().size(), 3UL);
+
+    ValidateDocumentList(uncompressChunks(swChunks.getValue()), samples);
+
+    // The buffer is empty after a drain
+    ASSERT_EQUALS(buffer.getChunkCount(), 0UL);
+    ASSERT_EQUALS(buffer.getSizeBytes(), 0UL);
+
+    swChunks = buffer.drain();
+    ASSERT_OK(swChunks.getStatus());
+    ASSERT_EQUALS(swChunks.getValue().size(), 0UL);
+}
+
+// A schema change completes a chunk
+TEST(FTDCHighFrequencyBufferTest, TestSchemaChange) {
+    FTDCHighFrequencyBuffer buffer(FTDCConfig::kMaxHighFrequencyBufferBytesDefault);
+
+    std::vector<BSONObj> samples{makeSample(1), makeSample(2), BSON("other" << 1)};
+    for (const auto& sample : samples) {
+        ASSERT_OK(buffer.addSample(sample, Date_t()));
+    }
+
+    ASSERT_EQUALS(buffer.getChunkCount(), 1UL);
+
+    auto swChunks = buffer.drain();
+    ASSERT_OK(swChunks.getStatus());
+    ASSERT_EQUALS(swChunks.getValue().size(), 2UL);
+
+    ValidateDocumentList(uncompressChunks(swChunks.getValue()), samples);
+}
+
+// The oldest chunks are evicted once the buffer is over its limit, but never the newest one
+TEST(FTDCHighFrequencyBufferTest, TestEviction) {
+    FTDCHighFrequencyBuffer buffer(1);
+
+    std::vector<BSONObj> samples;
+    for (int i = 0; i < 300; ++i) {
+        samples.push_back(makeSample(i));
+        ASSERT_OK(buffer.addSample(samples.back(), Date_t::fromMillisSinceEpoch(i)));
+        ASSERT_LESS_THAN_OR_EQUALS(buffer.getChunkCount(), 1UL);
+    }
+
+    ASSERT_EQUALS(buffer.getChunkCount(), 1UL);
+
+    auto swChunks = buffer.drain();
+    ASSERT_OK(swChunks.getStatus());
+    ASSERT_EQUALS(swChunks.getValue().size(), 1UL);
+
+    std::vector<BSONObj> lastChunk(samples.end() - FTDCConfig::kSamplesPerHighFrequencyChunk,
+                                   samples.end());
+    ValidateDocumentList(uncompressChunks(swChunks.getValue()), lastChunk);
+}
+
+// Lowering the limit evicts immediately
+TEST(FTDCHighFrequencyBufferTest, TestSetMaxBufferBytes) {
+    FTDCHighFrequencyBuffer buffer(FTDCConfig::kMaxHighFrequencyBufferBytesDefault);
+
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_OK(buffer.addSample(makeSample(i), Date_t::fromMillisSinceEpoch(i)));
+    }
+
+    ASSERT_EQUALS(buffer.getChunkCount(), 5UL);
+
+    buffer.setMaxBufferBytes(1);
+    ASSERT_EQUALS(buffer.getChunkCount(), 1UL);
+
+    buffer.clear();
+    ASSERT_EQUALS(buffer.getChunkCount(), 0UL);
+    ASSERT_EQUALS(buffer.getSizeBytes(), 0UL);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -125,6 +125,26 @@ BSONElement extractNonFTSKeyElement(const BSONObj& obj, StringData path) {
     invariant(indexedElements.size() <= 1U);
     return indexedElements.empty() ? nullElt : *indexedElements.begin();
 }
+
+/**
+ * Returns an object holding 'elements' with their field names replaced by "", as they appear in
+ * index keys.
+ */
+BSONObj renameNonFTSKeyElements(const vector<BSONElement>& elements) {
+    BSONObjBuilder b;
+    for (auto&& element : elements) {
+        b.appendAs(element, "");
+    }
+    return b.obj();
+}
+
+/**
+ * Appends the elements of 'obj' to 'b' by copying their bytes.
+ */
+void appendElementBytes(BSONObjBuilder* b, const BSONObj& obj) {
+    // Skip the leading length and the trailing EOO byte.
+    b->bb().appendBuf(obj.objdata() + sizeof(int32_t), obj.objsize() - sizeof(int32_t) - 1);
+}
 }  // namespace
 
 MONGO_INITIALIZER(FTSIndexFormat)(InitializerContext* context) {
@@ -170,6 +190,11 @@ void FTSIndexFormat::getKeys(const FTSSpec& spec, const BSONObj& obj, BSONObjSet
     long long keyBSONSize = 0;
     const int MaxKeyBSONSizeMB = 4;
 
+    // The non FTS elements are the same in every key, so rename them once and copy their bytes
+    // into each key rather than re-appending them element by element.
+    const BSONObj extrasBeforeObj = renameNonFTSKeyElements(extrasBefore);
+    const BSONObj extrasAfterObj = renameNonFTSKeyElements(extrasAfter);
+
     for (TermFrequencyMap::const_iterator i = term_freqs.begin(); i != term_freqs.end(); ++i) {
         const string& term = i->first;
         double weight = i->second;
@@ -180,13 +205,9 @@ void FTSIndexFormat::getKeys(const FTSSpec& spec, const BSONObj& obj, BSONObjSet
             guessTermSize(term, spec.getTextIndexVersion()) + extraSize;
 
         BSONObjBuilder b(guess);  // builds a BSON object with guess length.
-        for (unsigned k = 0; k < extrasBefore.size(); k++) {
-            b.appendAs(extrasBefore[k], "");
-        }
+        appendElementBytes(&b, extrasBeforeObj);
         _appendIndexKey(b, weight, term, spec.getTextIndexVersion());
-        for (unsigned k = 0; k < extrasAfter.size(); k++) {
-            b.appendAs(extrasAfter[k], "");
-        }
+        appendElementBytes(&b, extrasAfterObj);
         BSONObj res = b.obj();
 
         verify(guess >= res.objsize());
@@ -44,6 +44,26 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+std::array<bool, 128> makeAsciiDelimiterTable(unicode::DelimiterListLanguage lang) {
+    std::array<bool, 128> table;
+    for (char32_t ch = 0; ch < table.size(); ++ch) {
+        table[ch] = unicode::codepointIsDelimiter(ch, lang);
+    }
+    return table;
+}
+
+const std::array<bool, 128>& asciiDelimiterTable(unicode::DelimiterListLanguage lang) {
+    static const auto englishTable =
+        makeAsciiDelimiterTable(unicode::DelimiterListLanguage::kEnglish);
+    static const auto notEnglishTable =
+        makeAsciiDelimiterTable(unicode::DelimiterListLanguage::kNotEnglish);
+    return lang == unicode::DelimiterListLanguage::kEnglish ? englishTable : notEnglishTable;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
     : _language(language),
       _stemmer(language),
@@ -52,18 +72,48 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
                              ? unicode::DelimiterListLanguage::kEnglish
                              : unicode::DelimiterListLanguage::kNotEnglish),
       _caseFoldMode(_language->str() == "turkish" ? unicode::CaseFoldMode::kTurkish
-                                                  : unicode::CaseFoldMode::kNormal) {}
+                                                  : unicode::CaseFoldMode::kNormal),
+      _stemsWords(_language->str() != "none"),
+      _asciiDelimiters(asciiDelimiterTable(_delimListLanguage)) {}
 
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
+
+    // Turkish lower cases the ASCII 'I' to a non-ASCII character, so documents containing it
+    // can't be lower cased in place.
+    _ascii = unicode::String::isAscii(document) &&
+        (_caseFoldMode == unicode::CaseFoldMode::kNormal || document.find('I') == string::npos);
+    if (_ascii) {
+        _resetAscii(document);
+        return;
+    }
+
     _document.resetData(document);  // Validates that document is valid UTF8.
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
     _skipDelimiters();
 }
 
+void UnicodeFTSTokenizer::_resetAscii(StringData document) {
+    _asciiDocument.assign(document.rawData(), document.size());
+
+    // Lower cases the whole document at once. ASCII lower casing maps each byte to one byte, so
+    // token offsets are the same in both copies.
+    _asciiLowered = unicode::String::caseFoldAndStripDiacritics(
+        &_asciiLowerBuf, _asciiDocument, unicode::String::kDiacriticSensitive, _caseFoldMode);
+    invariant(_asciiLowered.size() == _asciiDocument.size());
+
+    while (_pos < _asciiDocument.size() && _asciiDelimiters[uint8_t(_asciiDocument[_pos])]) {
+        ++_pos;
+    }
+}
+
 bool UnicodeFTSTokenizer::moveNext() {
+    if (_ascii) {
+        return _moveNextAscii();
+    }
+
     while (true) {
         if (_pos >= _document.size()) {
             _word = "";
@@ -83,27 +133,74 @@ bool UnicodeFTSTokenizer::moveNext() {
 
         // Stop words are case-sensitive and diacritic sensitive, so we need them to be lower cased
         // but with diacritics not removed to check against the stop word list.
-        _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        StringData lowered = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        if (_finishToken(lowered,
+                         [&] { return _document.substrToBuf(&_wordBuf, start, len); })) {
+            return true;
+        }
+    }
+}
 
-        if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
-            continue;
+bool UnicodeFTSTokenizer::_moveNextAscii() {
+    const size_t size = _asciiDocument.size();
+    while (true) {
+        if (_pos >= size) {
+            _word = "";
+            return false;
         }
 
-        if (_options & kGenerateCaseSensitiveTokens) {
-            _word = _document.substrToBuf(&_wordBuf, start, len);
+        size_t start = _pos++;
+        while (_pos < size && !_asciiDelimiters[uint8_t(_asciiDocument[_pos])]) {
+            ++_pos;
         }
+        const size_t len = _pos - start;
 
-        // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
-        _word = _stemmer.stem(_word);
+        while (_pos < size && _asciiDelimiters[uint8_t(_asciiDocument[_pos])]) {
+            ++_pos;
+        }
 
-        if (!(_options & kGenerateDiacriticSensitiveTokens)) {
-            // Can't use _wordbuf for output here because our input _word may point into it.
-            _word = unicode::String::caseFoldAndStripDiacritics(
-                &_finalBuf, _word, unicode::String::kCaseSensitive, _caseFoldMode);
+        StringData lowered = _asciiLowered.substr(start, len);
+        if (_finishToken(lowered, [&] { return StringData(_asciiDocument).substr(start, len); })) {
+            return true;
         }
+    }
+}
+
+template <typename OriginalFunc>
+bool UnicodeFTSTokenizer::_finishToken(StringData lowered, OriginalFunc original) {
+    if ((_options & kFilterStopWords) && _stopWords->isStopWord(lowered)) {
+        return false;
+    }
+
+    _word = (_options & kGenerateCaseSensitiveTokens) ? original() : lowered;
+
+    // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
+    _word = _stem(_word);
+
+    if (!(_options & kGenerateDiacriticSensitiveTokens)) {
+        // Can't use _wordbuf for output here because our input _word may point into it.
+        _word = unicode::String::caseFoldAndStripDiacritics(
+            &_finalBuf, _word, unicode::String::kCaseSensitive, _caseFoldMode);
+    }
+
+    return true;
+}
+
+StringData UnicodeFTSTokenizer::_stem(StringData word) {
+    if (!_stemsWords) {
+        return word;
+    }
 
-        return true;
+    // The cached stem stays valid until the next call to moveNext(), which is the lifetime
+    // promised by get(): only a later insertion can evict it.
+    string key = word.toString();
+    auto it = _stemCache.find(key);
+    if (it == _stemCache.end()) {
+        StringData stem = _stemmer.stem(word);
+        _stemCache.add(key, stem.toString());
+        it = _stemCache.begin();
     }
+    return it->second;
 }
 
 StringData UnicodeFTSTokenizer::get() const {
@@ -28,12 +28,16 @@
 
 #pragma once
 
+#include <array>
+#include <string>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_tokenizer.h"
 #include "mongo/db/fts/stemmer.h"
 #include "mongo/db/fts/tokenizer.h"
 #include "mongo/db/fts/unicode/string.h"
+#include "mongo/util/lru_cache.h"
 
 namespace mongo {
 namespace fts {
@@ -53,6 +57,9 @@ class StopWords;
  *
  * For each word returns a stem version of a word optimized for full text indexing.
  * Optionally supports returning case sensitive search terms.
+ *
+ * Documents made only of ASCII characters are lower cased in one vectorized pass and tokenized
+ * byte by byte. Stems are cached in a small LRU cache that lives as long as the tokenizer.
  */
 class UnicodeFTSTokenizer final : public FTSTokenizer {
     MONGO_DISALLOW_COPYING(UnicodeFTSTokenizer);
@@ -66,6 +73,12 @@ public:
 
     StringData get() const override;
 
+    /**
+     * Maximum number of distinct words whose stems are remembered by a tokenizer. A tokenizer is
+     * reused for every field of a document, so repeated words are only stemmed once.
+     */
+    static const size_t kStemCacheSize = 1024;
+
 private:
     /**
      * Helper that moves the tokenizer past all delimiters that shouldn't be considered part of
@@ -73,17 +86,53 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * Versions of reset() and moveNext() used when the document is entirely ASCII and can be
+     * tokenized byte by byte, without converting it to UTF-32.
+     */
+    void _resetAscii(StringData document);
+    bool _moveNextAscii();
+
+    /**
+     * Applies the stop word filter, stemming and diacritic removal shared by both paths to a
+     * token. 'lowered' is the lower cased token and 'original' is the token as it appears in the
+     * document, which is only read when case sensitive tokens are requested. Returns false if the
+     * token is a stop word that should be skipped.
+     */
+    template <typename OriginalFunc>
+    bool _finishToken(StringData lowered, OriginalFunc original);
+
+    /**
+     * Returns the stem of 'word', consulting and filling _stemCache.
+     */
+    StringData _stem(StringData word);
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
     const unicode::DelimiterListLanguage _delimListLanguage;
     const unicode::CaseFoldMode _caseFoldMode;
 
+    // True if this tokenizer stems words at all, and so should cache stems.
+    const bool _stemsWords;
+
+    // Whether each ASCII character is a delimiter for _delimListLanguage.
+    const std::array<bool, 128>& _asciiDelimiters;
+
     unicode::String _document;
     size_t _pos;
     StringData _word;
     Options _options;
 
+    // Set by reset() when the ASCII path is used. _asciiDocument holds a copy of the document and
+    // _asciiLowered its lower cased form, which has the same length.
+    bool _ascii = false;
+    std::string _asciiDocument;
+    StringData _asciiLowered;
+    StackBufBuilder _asciiLowerBuf;
+
+    LRUCache<std::string, std::string> _stemCache{kStemCacheSize};
+
     StackBufBuilder _wordBuf;
     StackBufBuilder _finalBuf;
 };
@@ -31,6 +31,7 @@
 #include "mongo/db/fts/fts_language.h"
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace fts {
@@ -241,5 +242,53 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that ASCII documents, which skip the conversion to UTF-32, produce the same tokens as the
+// general path. The trailing non-ASCII delimiter forces the general path without adding a token.
+TEST(FtsUnicodeTokenizer, AsciiDocumentsMatchUnicodePath) {
+    const char* kDocument = "  , Do you see Mark's dog RUNNING? ^He^ said `it' was runn-ing.   ";
+    const std::string kUnicodeDocument = std::string(kDocument) + " «";
+
+    for (auto language : {"english", "french", "turkish", "none"}) {
+        for (FTSTokenizer::Options options = 0; options < 8; ++options) {
+            ASSERT(tokenizeString(kDocument, language, options) ==
+                   tokenizeString(kUnicodeDocument.c_str(), language, options));
+        }
+    }
+}
+
+// Ensure that a Turkish ASCII document containing 'I' is still lower cased to a dotless i.
+TEST(FtsUnicodeTokenizer, TurkishAsciiDocumentWithCapitalI) {
+    const auto options = FTSTokenizer::kGenerateDiacriticSensitiveTokens;
+    ASSERT(tokenizeString("KITAP", "turkish", options) ==
+           tokenizeString("kıtap", "turkish", options));
+    ASSERT(tokenizeString("kitap", "turkish", options) ==
+           tokenizeString("kitap «", "turkish", options));
+}
+
+// Ensure that cached stems are the same as freshly computed ones, including once the stem cache
+// has evicted entries and when the tokenizer is reused.
+TEST(FtsUnicodeTokenizer, StemCacheReturnsSameStems) {
+    StatusWithFTSLanguage swl = FTSLanguage::make("english", TEXT_INDEX_VERSION_3);
+    ASSERT_OK(swl);
+
+    std::string document;
+    for (size_t i = 0; i < 2 * UnicodeFTSTokenizer::kStemCacheSize; ++i) {
+        document += str::stream() << "running" << i << " jumped ";
+    }
+
+    UnicodeFTSTokenizer tokenizer(swl.getValue());
+    for (int pass = 0; pass < 2; ++pass) {
+        tokenizer.reset(document, FTSTokenizer::kNone);
+        size_t i = 0;
+        while (tokenizer.moveNext()) {
+            std::string expected =
+                (i % 2) ? std::string("jump") : std::string(str::stream() << "running" << i / 2);
+            ASSERT_EQUALS(expected, tokenizer.get());
+            ++i;
+        }
+        ASSERT_EQUALS(4 * UnicodeFTSTokenizer::kStemCacheSize, i);
+    }
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -259,6 +259,22 @@ StringData String::caseFoldAndStripDiacritics(StackBufBuilder* buffer,
     return {buffer->buf(), size_t(buffer->len())};
 }
 
+bool String::isAscii(StringData utf8) {
+    auto it = utf8.begin();
+    const auto end = utf8.end();
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    for (; size_t(end - it) >= ByteVector::size; it += ByteVector::size) {
+        if (ByteVector::load(&*it).maskHigh())
+            return false;
+    }
+#endif
+    for (; it != end; ++it) {
+        if (uint8_t(*it) > 0x7f)
+            return false;
+    }
+    return true;
+}
+
 bool String::substrMatch(const std::string& str,
                          const std::string& find,
                          SubstrMatchOptions options,
@@ -142,6 +142,12 @@ public:
                                                  SubstrMatchOptions options,
                                                  CaseFoldMode mode);
 
+    /**
+     * Returns true if every byte of the utf8 input is 7-bit ASCII. Scans 16 bytes at a time where
+     * a fast byte vector is available.
+     */
+    static bool isAscii(StringData utf8);
+
 private:
     /**
      * Helper method for converting a UTF-8 string to a UTF-32 string.
@@ -261,5 +261,16 @@ TEST(UnicodeString, UTF32ToUTF8) {
     ASSERT_EQUALS(expected_result, result);
 }
 
+TEST(UnicodeString, IsAscii) {
+    ASSERT(String::isAscii(""));
+    ASSERT(String::isAscii("abc"));
+    ASSERT(String::isAscii(filler + "Do you see Mark's dog running?" + filler));
+    ASSERT_FALSE(String::isAscii("Ã©"));
+
+    // Non-ASCII bytes are found both inside and after the vectorized part of the scan.
+    ASSERT_FALSE(String::isAscii(filler + "Ã©" + filler));
+    ASSERT_FALSE(String::isAscii(filler + filler + "Ã©"));
+}
+
 }  // namespace unicode
 }  // namespace mongo
@@ -35,9 +35,12 @@
 #include "mongo/db/hasher.h"
 
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include <third_party/murmurhash3/MurmurHash3.h>
 
 namespace mongo {
 
@@ -79,7 +82,33 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+/**
+ * Hasher for hashVersion 1. MurmurHash3 is not incremental, so the input is gathered into a
+ * buffer, which stays on the stack for all but unusually large values, and hashed in one pass.
+ */
+class FastHasher {
+    MONGO_DISALLOW_COPYING(FastHasher);
+
+public:
+    explicit FastHasher(HashSeed seed) : _seed(seed) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buf.appendBuf(keyData, numBytes);
+    }
+
+    long long int finish() {
+        char digest[16];
+        MurmurHash3_x64_128(_buf.buf(), _buf.len(), static_cast<uint32_t>(_seed), digest);
+        return ConstDataView(digest).read<LittleEndian<long long int>>();
+    }
+
+private:
+    StackBufBuilder _buf;
+    HashSeed _seed;
+};
+
+template <typename H>
+void recursiveHash(H* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,12 +151,22 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(
+                   o.firstElement(), 0, BSONElementHasher::FAST_HASH_VERSION) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 
 }  // namespace
 
-long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    if (hashVersion == FAST_HASH_VERSION) {
+        FastHasher h(seed);
+        recursiveHash(&h, e, false);
+        return h.finish();
+    }
+
+    invariant(hashVersion == DEFAULT_HASH_VERSION);
     Hasher h(seed);
     recursiveHash(&h, e, false);
     HashDigest d;
@@ -54,6 +54,20 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* Hashed indexes and hashed shard keys record which hash function produced their keys in
+     * "hashVersion". Version 0 is the original MD5-based hash and remains the default, so that
+     * existing indexes and sharded collections keep the keys they were built with. Version 1 is
+     * a non-cryptographic 64-bit hash (MurmurHash3) which is considerably cheaper to compute.
+     *
+     * WARNING: the output of an existing version must never change.
+     */
+    static const int DEFAULT_HASH_VERSION = 0;
+    static const int FAST_HASH_VERSION = 1;
+
+    static bool isValidHashVersion(int hashVersion) {
+        return hashVersion == DEFAULT_HASH_VERSION || hashVersion == FAST_HASH_VERSION;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -65,8 +79,12 @@ public:
      * and hashed shard keys, and thus should not be changed unless
      * the associated "getKeys" and "makeSingleKey" method in the
      * hashindex type is changed accordingly.
+     *
+     * "hashVersion" must satisfy isValidHashVersion().
      */
-    static long long int hash64(const BSONElement& e, HashSeed seed);
+    static long long int hash64(const BSONElement& e,
+                                HashSeed seed,
+                                int hashVersion = DEFAULT_HASH_VERSION);
 
 private:
     BSONElementHasher();
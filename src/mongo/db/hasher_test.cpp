@@ -359,5 +359,30 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+TEST(BSONElementHasher, FastHashVersionIsConsistentAcrossPlatforms) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(
+        BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::FAST_HASH_VERSION),
+        8715208212397937794LL);
+}
+
+TEST(BSONElementHasher, FastHashVersionSquashesNumericTypes) {
+    auto fastHash = [](const BSONObj& o) {
+        return BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::FAST_HASH_VERSION);
+    };
+    ASSERT_EQUALS(fastHash(BSON("a" << 3)), fastHash(BSON("a" << 3LL)));
+    ASSERT_EQUALS(fastHash(BSON("a" << 3)), fastHash(BSON("a" << 3.1)));
+    ASSERT_EQUALS(fastHash(BSON("a" << BSON("b" << 4))), fastHash(BSON("a" << BSON("b" << 4.1))));
+    ASSERT_NOT_EQUALS(fastHash(BSON("a" << 3)), fastHash(BSON("a" << 4)));
+    ASSERT_NOT_EQUALS(fastHash(BSON("a" << BSON("b" << 4))), fastHash(BSON("a" << BSON("c" << 4))));
+}
+
+TEST(BSONElementHasher, FastHashVersionDependsOnSeed) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_NOT_EQUALS(
+        BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::FAST_HASH_VERSION),
+        BSONElementHasher::hash64(o.firstElement(), 1, BSONElementHasher::FAST_HASH_VERSION));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -252,8 +252,13 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
                                                     const PositionalPathInfo& positionalInfo,
                                                     const char** field,
                                                     bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    // Look up the first path component once, without copying it, and continue the descent from
+    // the element found rather than rescanning 'obj' from the top.
+    const char* dot = strchr(*field, '.');
+    const StringData firstField =
+        dot ? StringData(*field, dot - *field) : StringData(*field, strlen(*field));
+    BSONElement firstElt = obj.getField(firstField);
+    bool haveObjField = !firstElt.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -269,7 +274,17 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        *field += firstField.size();
+        if (!dot) {
+            return firstElt;
+        }
+        ++*field;
+        if (firstElt.type() == Array) {
+            return firstElt;
+        } else if (firstElt.type() == Object) {
+            return dps::extractElementAtPathOrArrayAlongPath(firstElt.embeddedObject(), *field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
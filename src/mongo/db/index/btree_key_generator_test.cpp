@@ -322,6 +322,15 @@ TEST(BtreeKeyGeneratorTest, GetKeysSubobjectMissing) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysDottedPathThroughScalarIsMissing) {
+    BSONObj keyPattern = fromjson("{'a.b.c': 1, 'ab.c': 1}");
+    BSONObj genKeysFrom = fromjson("{ab: {c: 2}, a: {b: 1}}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': null, '': 2}"));
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromCompound) {
     BSONObj keyPattern = fromjson("{x: 1, y: 1}");
     BSONObj genKeysFrom = fromjson("{x: 'a', y: 'b'}");
@@ -84,11 +84,14 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
         *seedOut = infoObj["seed"].numberInt();
     }
 
-    // In case we have hashed indexes based on other hash functions in the future, we store
-    // a hashVersion number. If hashVersion changes, "makeSingleHashKey" will need to change
-    // accordingly.  Defaults to 0 if "hashVersion" is not included in the index spec or if
+    // The hashVersion number identifies the hash function the index keys were built with, see
+    // BSONElementHasher. Defaults to 0 if "hashVersion" is not included in the index spec or if
     // the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
+    uassert(ErrorCodes::CannotCreateIndex,
+            str::stream() << "Unsupported hashVersion " << *versionOut << " in index spec "
+                          << infoObj,
+            BSONElementHasher::isValidHashVersion(*versionOut));
 
     // Get the hashfield name
     BSONElement firstElt = infoObj.getObjectField("key").firstElement();
@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -47,8 +48,10 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
@@ -179,6 +182,78 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& records,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    // Generate the keys of all the documents up front, tracking multikeyness per document just as
+    // insert() does.
+    std::vector<std::pair<BSONObj, RecordId>> keysToInsert;
+    bool isMultikey = false;
+    MultikeyPaths batchMultikeyPaths;
+    for (auto&& record : records) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*record.docPtr, options.getKeysMode, &keys, &multikeyPaths);
+
+        isMultikey = isMultikey || keys.size() > 1 || isMultikeyFromPaths(multikeyPaths);
+        if (!multikeyPaths.empty()) {
+            if (batchMultikeyPaths.empty()) {
+                batchMultikeyPaths = std::move(multikeyPaths);
+            } else {
+                invariant(batchMultikeyPaths.size() == multikeyPaths.size());
+                for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+                    batchMultikeyPaths[i].insert(multikeyPaths[i].begin(),
+                                                 multikeyPaths[i].end());
+                }
+            }
+        }
+
+        for (auto&& key : keys) {
+            keysToInsert.emplace_back(key, record.id);
+        }
+    }
+
+    const Ordering& ordering = _btreeState->ordering();
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&ordering](const std::pair<BSONObj, RecordId>& lhs,
+                          const std::pair<BSONObj, RecordId>& rhs) {
+                  const int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+              });
+
+    for (auto&& keyToInsert : keysToInsert) {
+        Status status = _newInterface->insert(
+            opCtx, keyToInsert.first, keyToInsert.second, options.dupsAllowed);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue && !_btreeState->isReady(opCtx)) {
+            LOG(3) << "key " << keyToInsert.first
+                   << " already in index during background indexing (ok)";
+            continue;
+        }
+
+        return status;
+    }
+
+    if (isMultikey) {
+        _btreeState->setMultikey(opCtx, batchMultikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -295,6 +370,10 @@ bool IndexAccessMethod::appendCustomStats(OperationContext* opCtx,
     return _newInterface->appendCustomStats(opCtx, output, scale);
 }
 
+bool IndexAccessMethod::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    return _newInterface->appendCacheStats(opCtx, output);
+}
+
 long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* opCtx) const {
     return _newInterface->getSpaceUsedBytes(opCtx);
 }
@@ -414,48 +493,70 @@ Status IndexAccessMethod::compact(OperationContext* opCtx) {
     return this->_newInterface->compact(opCtx);
 }
 
+namespace {
+SortOptions makeBulkBuilderSortOptions(size_t maxMemoryUsageBytes) {
+    return SortOptions()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp")
+        .ExtSortAllowed()
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+        .SortThreads(std::max(1, internalQueryExecSortThreads.load()));
+}
+
+BtreeExternalSortComparison makeBulkBuilderComparison(const IndexDescriptor* descriptor) {
+    return BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version());
+}
+}  // namespace
+
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
-    size_t maxMemoryUsageBytes) {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
+    size_t maxMemoryUsageBytes, size_t numPartitions) {
+    return std::unique_ptr<BulkBuilder>(
+        new BulkBuilder(this, _descriptor, maxMemoryUsageBytes, numPartitions));
 }
 
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
-                                            size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
-
-Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
-                                              const BSONObj& obj,
-                                              const RecordId& loc,
-                                              const InsertDeleteOptions& options,
-                                              int64_t* numInserted) {
+                                            size_t maxMemoryUsageBytes,
+                                            size_t numPartitions)
+    : _real(index), _partitions(numPartitions) {
+    invariant(numPartitions > 0);
+    for (auto&& partition : _partitions) {
+        partition.sorter.reset(
+            Sorter::make(makeBulkBuilderSortOptions(maxMemoryUsageBytes / numPartitions),
+                         makeBulkBuilderComparison(descriptor)));
+    }
+}
+
+Status IndexAccessMethod::BulkBuilder::insertIntoPartition(size_t partitionIndex,
+                                                           OperationContext* opCtx,
+                                                           const BSONObj& obj,
+                                                           const RecordId& loc,
+                                                           const InsertDeleteOptions& options,
+                                                           int64_t* numInserted) {
+    invariant(partitionIndex < _partitions.size());
+    Partition& partition = _partitions[partitionIndex];
+
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
     _real->getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
 
-    _everGeneratedMultipleKeys = _everGeneratedMultipleKeys || (keys.size() > 1);
+    partition.everGeneratedMultipleKeys = partition.everGeneratedMultipleKeys || (keys.size() > 1);
 
     if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
+        if (partition.indexMultikeyPaths.empty()) {
+            partition.indexMultikeyPaths = multikeyPaths;
         } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+            invariant(partition.indexMultikeyPaths.size() == multikeyPaths.size());
             for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+                partition.indexMultikeyPaths[i].insert(multikeyPaths[i].begin(),
+                                                       multikeyPaths[i].end());
             }
         }
     }
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
-        _sorter->add(*it, loc);
-        _keysInserted++;
+        partition.sorter->add(*it, loc);
+        partition.keysInserted++;
     }
 
     if (NULL != numInserted) {
@@ -473,13 +574,43 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      set<RecordId>* dupsToDrop) {
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    // Combine the sorted runs and multikey information of all partitions. The runs are merged
+    // with the same comparison they were sorted with, so the builder still sees keys in order.
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> runs;
+    for (auto&& partition : bulk->_partitions) {
+        runs.emplace_back(partition.sorter->done());
+        keysInserted += partition.keysInserted;
+        everGeneratedMultipleKeys =
+            everGeneratedMultipleKeys || partition.everGeneratedMultipleKeys;
+
+        if (partition.indexMultikeyPaths.empty()) {
+            continue;
+        }
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = std::move(partition.indexMultikeyPaths);
+        } else {
+            invariant(indexMultikeyPaths.size() == partition.indexMultikeyPaths.size());
+            for (size_t j = 0; j < indexMultikeyPaths.size(); ++j) {
+                indexMultikeyPaths[j].insert(partition.indexMultikeyPaths[j].begin(),
+                                             partition.indexMultikeyPaths[j].end());
+            }
+        }
+    }
+
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> i = runs.front();
+    if (runs.size() > 1) {
+        i.reset(BulkBuilder::Sorter::Iterator::merge(
+            runs, SortOptions(), makeBulkBuilderComparison(_descriptor)));
+    }
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(
         CurOp::get(opCtx)->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                              "Index: (2/3) BTree Bottom Up Progress",
-                                             bulk->_keysInserted,
+                                             keysInserted,
                                              10));
     lk.unlock();
 
@@ -488,8 +619,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     writeConflictRetry(opCtx, "setting index multikey flag", "", [&] {
         WriteUnitOfWork wunit(opCtx);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(opCtx, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(opCtx, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(opCtx, dupsAllowed));
@@ -30,6 +30,7 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -47,6 +48,7 @@ extern AtomicBool failIndexKeyTooLong;
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 /**
@@ -84,6 +86,19 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Like calling insert() for each record in 'records', but generates the keys of all of the
+     * documents first and inserts them in index order, so that consecutive insertions touch nearby
+     * parts of the index. 'numInserted' will be set to the total number of keys added.
+     *
+     * Unlike insert(), keys already inserted are not removed when an error is returned, so the
+     * caller must not commit its WriteUnitOfWork in that case.
+     */
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<BsonRecord>& records,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -176,6 +191,14 @@ public:
      */
     bool appendCustomStats(OperationContext* opCtx, BSONObjBuilder* result, double scale) const;
 
+    /**
+     * Add the storage engine's cache residency and I/O counters for this index to BSON object
+     * builder.
+     *
+     * Returns true if stats were appended.
+     */
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const;
+
     /**
      * @return The number of bytes consumed by this index.
      *         Exactly what is counted is not defined based on padding, re-use, etc...
@@ -203,28 +226,52 @@ public:
                       const BSONObj& obj,
                       const RecordId& loc,
                       const InsertDeleteOptions& options,
-                      int64_t* numInserted);
+                      int64_t* numInserted) {
+            return insertIntoPartition(0, opCtx, obj, loc, options, numInserted);
+        }
+
+        /**
+         * Like insert(), but sorts the generated keys in the run of partition 'partition'. The
+         * runs of all partitions are merged by commitBulk(). Different partitions may be inserted
+         * into concurrently, as long as each partition is only used by one thread at a time.
+         */
+        Status insertIntoPartition(size_t partition,
+                                   OperationContext* opCtx,
+                                   const BSONObj& obj,
+                                   const RecordId& loc,
+                                   const InsertDeleteOptions& options,
+                                   int64_t* numInserted);
+
+        size_t numPartitions() const {
+            return _partitions.size();
+        }
 
     private:
         friend class IndexAccessMethod;
 
         using Sorter = mongo::Sorter<BSONObj, RecordId>;
 
+        struct Partition {
+            std::unique_ptr<Sorter> sorter;
+            int64_t keysInserted = 0;
+
+            // Set to true if at least one document causes IndexAccessMethod::getKeys() to return
+            // a BSONObjSet with size strictly greater than one.
+            bool everGeneratedMultipleKeys = false;
+
+            // Holds the path components that cause this index to be multikey. The
+            // 'indexMultikeyPaths' vector remains empty if this index doesn't support path-level
+            // multikey tracking.
+            MultikeyPaths indexMultikeyPaths;
+        };
+
         BulkBuilder(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
-                    size_t maxMemoryUsageBytes);
+                    size_t maxMemoryUsageBytes,
+                    size_t numPartitions);
 
-        std::unique_ptr<Sorter> _sorter;
         const IndexAccessMethod* _real;
-        int64_t _keysInserted = 0;
-
-        // Set to true if at least one document causes IndexAccessMethod::getKeys() to return a
-        // BSONObjSet with size strictly greater than one.
-        bool _everGeneratedMultipleKeys = false;
-
-        // Holds the path components that cause this index to be multikey. The '_indexMultikeyPaths'
-        // vector remains empty if this index doesn't support path-level multikey tracking.
-        MultikeyPaths _indexMultikeyPaths;
+        std::vector<Partition> _partitions;
     };
 
     /**
@@ -235,9 +282,11 @@ public:
      * It is only legal to initiate bulk when the index is new and empty.
      *
      * maxMemoryUsageBytes: amount of memory consumed before the external sorter starts spilling to
-     *                      disk
+     *                      disk, shared evenly between the partitions
+     * numPartitions: number of separately sorted runs which may be inserted into concurrently
      */
-    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes);
+    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes,
+                                              size_t numPartitions = 1);
 
     /**
      * Call this when you are ready to finish your bulk work.
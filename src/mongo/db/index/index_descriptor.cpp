@@ -84,6 +84,7 @@ constexpr StringData IndexDescriptor::kDefaultLanguageFieldName;
 constexpr StringData IndexDescriptor::kDropDuplicatesFieldName;
 constexpr StringData IndexDescriptor::kExpireAfterSecondsFieldName;
 constexpr StringData IndexDescriptor::kGeoHaystackBucketSize;
+constexpr StringData IndexDescriptor::kHashVersionFieldName;
 constexpr StringData IndexDescriptor::kIndexNameFieldName;
 constexpr StringData IndexDescriptor::kIndexVersionFieldName;
 constexpr StringData IndexDescriptor::kKeyPatternFieldName;
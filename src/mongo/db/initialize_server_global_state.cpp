@@ -53,6 +53,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_file_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -63,6 +64,7 @@
 #include "mongo/logger/rotatable_file_writer.h"
 #include "mongo/logger/syslog_appender.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/listen.h"
@@ -212,10 +214,22 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+// When positive, log messages for the log file are queued and written by a background thread,
+// with at most this many messages waiting.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logAsyncBufferRecords, int, 0);
+
+// Whether messages are dropped, rather than waited for, when the log buffer is full.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logAsyncDropWhenFull, bool, false);
+
+}  // namespace
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
 (InitializerContext*) {
+    using logger::AsyncFileAppender;
     using logger::LogManager;
     using logger::MessageEventEphemeral;
     using logger::MessageEventDetailsEncoder;
@@ -296,9 +310,24 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
-                new MessageEventDetailsEncoder, writer.getValue())));
+        if (logAsyncBufferRecords > 0) {
+            auto appender = new AsyncFileAppender<MessageEventEphemeral>(
+                new MessageEventDetailsEncoder,
+                writer.getValue(),
+                static_cast<size_t>(logAsyncBufferRecords),
+                logAsyncDropWhenFull
+                    ? AsyncFileAppender<MessageEventEphemeral>::OverflowPolicy::kDrop
+                    : AsyncFileAppender<MessageEventEphemeral>::OverflowPolicy::kBlock);
+            manager->getGlobalDomain()->attachAppender(MessageLogDomain::AppenderAutoPtr(appender));
+
+            // Shutdown tasks run in the reverse order of registration, so this runs after the
+            // others and the messages logged while exiting are written directly.
+            registerShutdownTask([appender] { appender->flushAndStop(); });
+        } else {
+            manager->getGlobalDomain()->attachAppender(
+                MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
+                    new MessageEventDetailsEncoder, writer.getValue())));
+        }
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
@@ -32,15 +32,21 @@
 
 #include "mongo/db/introspect.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/deferred_writer.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/slow_op_recorder.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -54,6 +60,38 @@ using std::string;
 
 namespace {
 
+// If true, profile() hands system.profile entries to a background writer instead of inserting them
+// itself, so that a profiled operation neither waits for the insert nor takes a database lock for
+// it. Entries are dropped, and counted, when the writer's buffer is full.
+MONGO_EXPORT_SERVER_PARAMETER(deferProfilerWrites, bool, false);
+
+// How many bytes of system.profile entries the background writer may buffer.
+const int64_t kProfileWriterMaxBufferBytes = 16 * 1024 * 1024;
+
+Counter64 profilerWritesDropped;
+ServerStatusMetricField<Counter64> displayProfilerWritesDropped("profiler.writesDropped",
+                                                                &profilerWritesDropped);
+
+CollectionOptions profileCollectionOptions() {
+    CollectionOptions options;
+    options.capped = true;
+    options.cappedSize = 1024 * 1024;
+    return options;
+}
+
+/**
+ * The background writer which serves every database's system.profile collection.
+ */
+struct ProfileWriter {
+    ProfileWriter()
+        : writer(NamespaceString(), profileCollectionOptions(), kProfileWriterMaxBufferBytes) {}
+
+    DeferredWriter writer;
+    AtomicBool started{false};
+};
+
+const auto getProfileWriter = ServiceContext::declareDecoration<ProfileWriter>();
+
 void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSession* authSession) {
     UserNameIterator nameIter = authSession->getAuthenticatedUserNames();
 
@@ -79,15 +117,10 @@ void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSessi
     builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 }
 
-}  // namespace
-
-
-void profile(OperationContext* opCtx, NetworkOp op) {
-    // Initialize with 1kb at start in order to avoid realloc later
-    BufBuilder profileBufBuilder(1024);
-
-    BSONObjBuilder b(profileBufBuilder);
-
+/**
+ * Appends the fields of a system.profile document describing the current operation of 'opCtx'.
+ */
+void _appendProfileEntry(OperationContext* opCtx, BSONObjBuilder& b) {
     {
         Locker::LockerInfo lockerInfo;
         opCtx->lockState()->getLockerInfo(&lockerInfo);
@@ -108,6 +141,17 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     AuthorizationSession* authSession = AuthorizationSession::get(opCtx->getClient());
     _appendUserInfo(*CurOp::get(opCtx), b, authSession);
+}
+
+}  // namespace
+
+
+void profile(OperationContext* opCtx, NetworkOp op) {
+    // Initialize with 1kb at start in order to avoid realloc later
+    BufBuilder profileBufBuilder(1024);
+
+    BSONObjBuilder b(profileBufBuilder);
+    _appendProfileEntry(opCtx, b);
 
     const BSONObj p = b.done();
 
@@ -115,6 +159,14 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
 
+    auto& profileWriter = getProfileWriter(opCtx->getServiceContext());
+    if (deferProfilerWrites.load() && profileWriter.started.load()) {
+        if (!profileWriter.writer.insertDocument(NamespaceString(dbName, "system.profile"), p)) {
+            profilerWritesDropped.increment();
+        }
+        return;
+    }
+
     try {
         bool acquireDbXLock = false;
         while (true) {
@@ -165,6 +217,14 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 }
 
 
+void recordSlowOp(OperationContext* opCtx) {
+    BufBuilder entryBufBuilder(1024);
+    BSONObjBuilder b(entryBufBuilder);
+    _appendProfileEntry(opCtx, b);
+
+    SlowOpRecorder::get(opCtx->getServiceContext()).record(b.obj());
+}
+
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
 
@@ -183,16 +243,24 @@ Status createProfileCollection(OperationContext* opCtx, Database* db) {
     // system.profile namespace doesn't exist; create it
     log() << "Creating profile collection: " << dbProfilingNS;
 
-    CollectionOptions collectionOptions;
-    collectionOptions.capped = true;
-    collectionOptions.cappedSize = 1024 * 1024;
-
     WriteUnitOfWork wunit(opCtx);
     repl::UnreplicatedWritesBlock uwb(opCtx);
-    invariant(db->createCollection(opCtx, dbProfilingNS, collectionOptions));
+    invariant(db->createCollection(opCtx, dbProfilingNS, profileCollectionOptions()));
     wunit.commit();
 
     return Status::OK();
 }
 
+void startProfileWriter(ServiceContext* serviceContext) {
+    auto& profileWriter = getProfileWriter(serviceContext);
+    profileWriter.writer.startup("profile writer");
+    profileWriter.started.store(true);
+}
+
+void shutdownProfileWriter(ServiceContext* serviceContext) {
+    auto& profileWriter = getProfileWriter(serviceContext);
+    profileWriter.started.store(false);
+    profileWriter.writer.shutdown();
+}
+
 }  // namespace mongo
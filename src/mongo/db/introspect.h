@@ -35,15 +35,33 @@ namespace mongo {
 
 class Database;
 class OperationContext;
+class ServiceContext;
 
 /**
  * Invoked when database profile is enabled.
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Adds a system.profile-shaped description of the current operation to the SlowOpRecorder.
+ * Unlike profile(), this takes no locks and performs no writes.
+ */
+void recordSlowOp(OperationContext* opCtx);
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
 Status createProfileCollection(OperationContext* opCtx, Database* db);
 
+/**
+ * Starts the background writer which profile() uses when the deferProfilerWrites parameter is set.
+ */
+void startProfileWriter(ServiceContext* serviceContext);
+
+/**
+ * Stops the background profile writer, after it has written every entry it buffered. Entries
+ * profiled after this are written synchronously.
+ */
+void shutdownProfileWriter(ServiceContext* serviceContext);
+
 }  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/ops/write_ops.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
@@ -53,7 +54,12 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, false);
 
+// The periodic refresh writes the sessions collection in batches paced over at most this long,
+// rather than all at once. 0 means the batches are written back to back.
+MONGO_EXPORT_SERVER_PARAMETER(logicalSessionRefreshSpreadMillis, int, 0);
+
 constexpr Minutes LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumStripes;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiason> service,
@@ -66,10 +72,12 @@ LogicalSessionCacheImpl::LogicalSessionCacheImpl(
       _sessionsColl(std::move(collection)),
       _transactionReaper(std::move(transactionReaper)) {
     if (!disableLogicalSessionCacheRefresh) {
-        _service->scheduleJob(
-            {[this](Client* client) { _periodicRefresh(client); }, _refreshInterval});
-        _service->scheduleJob(
-            {[this](Client* client) { _periodicReap(client); }, _refreshInterval});
+        _service->scheduleJob({"logicalSessionCacheRefresh",
+                               [this](Client* client) { _periodicRefresh(client); },
+                               _refreshInterval});
+        _service->scheduleJob({"logicalSessionCacheReap",
+                               [this](Client* client) { _periodicReap(client); },
+                               _refreshInterval});
     }
     _stats.setLastSessionsCollectionJobTimestamp(now());
     _stats.setLastTransactionReaperJobTimestamp(now());
@@ -86,9 +94,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    auto& stripe = _getStripe(lsid);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    auto it = stripe.sessions.find(lsid);
+    if (it == stripe.sessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -154,13 +163,17 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    size_t size = 0;
+    for (const auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        size += stripe.sessions.size();
+    }
+    return size;
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
     try {
-        _refresh(client);
+        _refresh(client, true);
     } catch (...) {
         log() << "Failed to refresh session cache: " << exceptionToStatus();
     }
@@ -228,7 +241,7 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
-void LogicalSessionCacheImpl::_refresh(Client* client) {
+void LogicalSessionCacheImpl::_refresh(Client* client, bool spread) {
     // Do not run this job if we are not in FCV 3.6
     if (serverGlobalParams.featureCompatibility.getVersion() !=
         ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36) {
@@ -280,29 +293,39 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     LogicalSessionIdSet explicitlyEndingSessions;
     LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
 
-    // backSwapper creates a guard that in the case of a exception
-    // replaces the ending or active sessions that swapped out of of LogicalSessionCache,
-    // and merges in any records that had been added since we swapped them
-    // out.
-    auto backSwapper = [this](auto& member, auto& temp) {
-        return MakeGuard([this, &member, &temp] {
-            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-            using std::swap;
-            swap(member, temp);
-            for (const auto& it : temp) {
-                member.emplace(it);
-            }
-        });
-    };
+    // In the case of an exception, these guards put back the ending or active sessions that were
+    // taken out of the LogicalSessionCache, without overwriting any records that have been added
+    // since.
+    auto explicitlyEndingBackSwaper = MakeGuard([this, &explicitlyEndingSessions] {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        using std::swap;
+        swap(_endingSessions, explicitlyEndingSessions);
+        for (const auto& it : explicitlyEndingSessions) {
+            _endingSessions.emplace(it);
+        }
+    });
+    auto activeSessionsBackSwapper = MakeGuard([this, &activeSessions] {
+        for (const auto& it : activeSessions) {
+            auto& stripe = _getStripe(it.first);
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            stripe.sessions.emplace(it);
+        }
+    });
 
     {
         using std::swap;
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
     }
-    auto activeSessionsBackSwapper = backSwapper(_activeSessions, activeSessions);
-    auto explicitlyEndingBackSwaper = backSwapper(_endingSessions, explicitlyEndingSessions);
+    for (auto& stripe : _activeSessions) {
+        LogicalSessionIdMap<LogicalSessionRecord> stripeSessions;
+        {
+            using std::swap;
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            swap(stripeSessions, stripe.sessions);
+        }
+        activeSessions.insert(stripeSessions.begin(), stripeSessions.end());
+    }
 
     // remove all explicitlyEndingSessions from activeSessions
     for (const auto& lsid : explicitlyEndingSessions) {
@@ -327,7 +350,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     }
 
     // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    _refreshSessionRecords(opCtx, activeSessionRecords, spread);
     activeSessionsBackSwapper.Dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -379,34 +402,80 @@ void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
 }
 
 LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
+    const auto activeSessionsCount = size();
     stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _stats.setActiveSessionsCount(_activeSessions.size());
+    _stats.setActiveSessionsCount(activeSessionsCount);
     return _stats;
 }
 
 void LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    auto& stripe = _getStripe(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    stripe.sessions.insert(std::make_pair(record.getId(), record));
+}
+
+void LogicalSessionCacheImpl::_refreshSessionRecords(OperationContext* opCtx,
+                                                     const LogicalSessionRecordSet& records,
+                                                     bool spread) {
+    const Milliseconds spreadOver = std::min(Milliseconds(logicalSessionRefreshSpreadMillis.load()),
+                                             duration_cast<Milliseconds>(_refreshInterval) / 2);
+    const size_t numBatches =
+        (records.size() + write_ops::kMaxWriteBatchSize - 1) / write_ops::kMaxWriteBatchSize;
+    if (!spread || spreadOver <= Milliseconds(0) || numBatches <= 1) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, records));
+        return;
+    }
+
+    // Each batch is given an equal share of the time, and waits only for what remains of it.
+    const Milliseconds perBatch = spreadOver / static_cast<long long>(numBatches);
+    LogicalSessionRecordSet batch;
+    auto it = records.begin();
+    while (it != records.end()) {
+        const Date_t batchStart = now();
+        batch.clear();
+        for (; it != records.end() && batch.size() < write_ops::kMaxWriteBatchSize; ++it) {
+            batch.insert(*it);
+        }
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+
+        const Milliseconds remaining = perBatch - (now() - batchStart);
+        if (it != records.end() && remaining > Milliseconds(0)) {
+            opCtx->sleepFor(remaining);
+        }
+    }
+}
+
+LogicalSessionCacheImpl::Stripe& LogicalSessionCacheImpl::_getStripe(
+    const LogicalSessionId& lsid) {
+    return _activeSessions[LogicalSessionIdHash{}(lsid) % kNumStripes];
+}
+
+const LogicalSessionCacheImpl::Stripe& LogicalSessionCacheImpl::_getStripe(
+    const LogicalSessionId& lsid) const {
+    return _activeSessions[LogicalSessionIdHash{}(lsid) % kNumStripes];
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    for (const auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        for (const auto& id : stripe.sessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (const auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        for (const auto& it : stripe.sessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -414,9 +483,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    const auto& stripe = _getStripe(id);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    const auto it = stripe.sessions.find(id);
+    if (it == stripe.sessions.end()) {
         return boost::none;
     }
     return it->second;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -36,6 +38,7 @@
 #include "mongo/db/time_proof_service.h"
 #include "mongo/db/transaction_reaper.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/lru_cache.h"
 
@@ -133,7 +136,7 @@ private:
      * session records contained within the cache.
      */
     void _periodicRefresh(Client* client);
-    void _refresh(Client* client);
+    void _refresh(Client* client, bool spread = false);
 
     void _periodicReap(Client* client);
     Status _reap(Client* client);
@@ -148,6 +151,28 @@ private:
      */
     void _addToCache(LogicalSessionRecord record);
 
+    /**
+     * Writes the given records to the sessions collection. If 'spread' is true, the writes are
+     * broken into batches paced over at most logicalSessionRefreshSpreadMillis.
+     */
+    void _refreshSessionRecords(OperationContext* opCtx,
+                                const LogicalSessionRecordSet& records,
+                                bool spread);
+
+    /**
+     * The active sessions are split over several independently locked stripes, chosen by a hash
+     * of the session id, so that operations on different sessions don't contend.
+     */
+    struct Stripe {
+        mutable stdx::mutex mutex;
+        LogicalSessionIdMap<LogicalSessionRecord> sessions;
+    };
+
+    static constexpr size_t kNumStripes = 16;
+
+    Stripe& _getStripe(const LogicalSessionId& lsid);
+    const Stripe& _getStripe(const LogicalSessionId& lsid) const;
+
     const Minutes _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -161,9 +186,11 @@ private:
     mutable stdx::mutex _reaperMutex;
     std::shared_ptr<TransactionReaper> _transactionReaper;
 
+    // Protects _stats and _endingSessions. May be taken before, but never while holding, the
+    // mutex of a stripe.
     mutable stdx::mutex _cacheMutex;
 
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    std::array<Stripe, kNumStripes> _activeSessions;
 
     LogicalSessionIdSet _endingSessions;
 
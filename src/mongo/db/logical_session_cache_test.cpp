@@ -270,6 +270,38 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(client()).isOK());
 }
 
+// Test that a failed refresh keeps every session in the cache, and that a later refresh writes
+// them out
+TEST_F(LogicalSessionCacheTest, FailedRefreshKeepsSessions) {
+    const size_t count = 1000;
+    std::vector<LogicalSessionId> ids;
+    for (size_t i = 0; i < count; i++) {
+        auto record = makeLogicalSessionRecordForTest();
+        ids.push_back(record.getId());
+        cache()->startSession(opCtx(), record);
+    }
+    ASSERT_EQ(cache()->size(), count);
+    ASSERT_EQ(cache()->listIds().size(), count);
+
+    sessions()->setRefreshHook([](const LogicalSessionRecordSet& sessions) {
+        return Status(ErrorCodes::HostUnreachable, "refresh failed");
+    });
+    clearOpCtx();
+    ASSERT(!cache()->refreshNow(client()).isOK());
+
+    ASSERT_EQ(cache()->size(), count);
+    for (const auto& lsid : ids) {
+        ASSERT(cache()->promote(lsid).isOK());
+        ASSERT(cache()->peekCached(lsid));
+    }
+
+    sessions()->clearHooks();
+    ASSERT(cache()->refreshNow(client()).isOK());
+    for (const auto& lsid : ids) {
+        ASSERT(sessions()->has(lsid));
+    }
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const char kDocument[] =
+    "{_id: 1, a: 5, b: 'hello', c: {d: 3, e: [1, 2, 3, 4, 5]}, f: [{g: 1}, {g: 2}, {g: 3}], "
+    "h: 3.5}";
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(query, expCtx);
+    invariantOK(swExpr.getStatus());
+    return std::move(swExpr.getValue());
+}
+
+void matchDocument(unittest::BenchmarkState& state, const char* query) {
+    const BSONObj doc = fromjson(kDocument);
+    auto expr = parse(fromjson(query));
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(expr->matchesBSON(doc));
+    }
+}
+
+MONGO_BENCHMARK(MatchExpressionEquality) {
+    matchDocument(state, "{a: 5}");
+}
+
+MONGO_BENCHMARK(MatchExpressionRange) {
+    matchDocument(state, "{a: {$gt: 1, $lt: 10}}");
+}
+
+MONGO_BENCHMARK(MatchExpressionDottedPath) {
+    matchDocument(state, "{'c.d': 3}");
+}
+
+MONGO_BENCHMARK(MatchExpressionArrayTraversal) {
+    matchDocument(state, "{'f.g': 3}");
+}
+
+MONGO_BENCHMARK(MatchExpressionIn) {
+    matchDocument(state, "{a: {$in: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]}}");
+}
+
+MONGO_BENCHMARK(MatchExpressionConjunction) {
+    matchDocument(state, "{a: 5, b: 'hello', h: {$gte: 3}, 'c.e': 4}");
+}
+
+MONGO_BENCHMARK(MatchExpressionDisjunctionNoMatch) {
+    matchDocument(state, "{$or: [{a: 1}, {b: 'x'}, {h: {$lt: 0}}, {'c.d': 7}]}");
+}
+
+MONGO_BENCHMARK(MatchExpressionElemMatch) {
+    matchDocument(state, "{f: {$elemMatch: {g: {$gte: 2, $lt: 3}}}}");
+}
+
+MONGO_BENCHMARK(MatchExpressionParse) {
+    const BSONObj query = fromjson("{a: 5, b: 'hello', h: {$gte: 3}, 'c.e': 4}");
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(parse(query));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
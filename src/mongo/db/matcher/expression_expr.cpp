@@ -30,10 +30,14 @@
 
 #include "mongo/db/matcher/expression_expr.h"
 
+#include "mongo/db/pipeline/dependencies.h"
+
 namespace mongo {
 ExprMatchExpression::ExprMatchExpression(boost::intrusive_ptr<Expression> expr,
                                          const boost::intrusive_ptr<ExpressionContext>& expCtx)
-    : MatchExpression(MatchType::EXPRESSION), _expCtx(expCtx), _expression(expr) {}
+    : MatchExpression(MatchType::EXPRESSION), _expCtx(expCtx), _expression(expr) {
+    computeDependencies();
+}
 
 ExprMatchExpression::ExprMatchExpression(BSONElement elem,
                                          const boost::intrusive_ptr<ExpressionContext>& expCtx)
@@ -46,11 +50,43 @@ bool ExprMatchExpression::matches(const MatchableDocument* doc, MatchDetails* de
         return false;
     }
 
-    Document document(doc->toBSON());
-    auto value = _expression->evaluate(document);
+    auto value = _expression->evaluate(toDocument(doc->toBSON()));
     return value.coerceToBool();
 }
 
+void ExprMatchExpression::computeDependencies() {
+    // Text score metadata is never available to a MatchExpression, but requesting it should not
+    // fail here.
+    DepsTracker deps(DepsTracker::MetadataAvailable::kTextScore);
+    _doAddDependencies(&deps);
+
+    _needWholeDocument = deps.needWholeDocument;
+    _topLevelFields.clear();
+    for (auto&& path : deps.fields) {
+        auto topLevelField = path.substr(0, path.find('.'));
+        if (std::find(_topLevelFields.begin(), _topLevelFields.end(), topLevelField) ==
+            _topLevelFields.end()) {
+            _topLevelFields.push_back(std::move(topLevelField));
+        }
+    }
+}
+
+Document ExprMatchExpression::toDocument(const BSONObj& obj) const {
+    if (_needWholeDocument) {
+        return Document(obj);
+    }
+
+    MutableDocument document(_topLevelFields.size());
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (std::find(_topLevelFields.begin(), _topLevelFields.end(), fieldName) !=
+            _topLevelFields.end()) {
+            document.addField(fieldName, Value(elem));
+        }
+    }
+    return document.freeze();
+}
+
 void ExprMatchExpression::serialize(BSONObjBuilder* out) const {
     *out << "$expr" << _expression->serialize(false);
 }
@@ -95,6 +131,7 @@ MatchExpression::ExpressionOptimizerFunc ExprMatchExpression::getOptimizer() con
     return [](std::unique_ptr<MatchExpression> expression) {
         auto& exprMatchExpr = static_cast<ExprMatchExpression&>(*expression);
         exprMatchExpr._expression = exprMatchExpr._expression->optimize();
+        exprMatchExpr.computeDependencies();
 
         return expression;
     };
@@ -85,6 +85,17 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Records which top-level fields '_expression' depends on, so that only those fields are
+     * converted when a document is matched.
+     */
+    void computeDependencies();
+
+    /**
+     * Converts the fields of 'obj' that '_expression' may read into a Document.
+     */
+    Document toDocument(const BSONObj& obj) const;
+
     void _doSetCollator(const CollatorInterface* collator) final;
 
     void _doAddDependencies(DepsTracker* deps) const final {
@@ -98,6 +109,10 @@ private:
     boost::intrusive_ptr<Expression> _expression;
 
     boost::optional<RewriteExpr::RewriteResult> _rewriteResult;
+
+    // Unless '_needWholeDocument' is set, '_expression' reads only these top-level fields.
+    bool _needWholeDocument = true;
+    std::vector<std::string> _topLevelFields;
 };
 
 }  // namespace mongo
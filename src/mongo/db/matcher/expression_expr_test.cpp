@@ -110,6 +110,25 @@ TEST_F(ExprMatchTest, ComparisonBetweenTwoFieldPathsMatchesCorrectly) {
     ASSERT_FALSE(matches(BSON("a" << 2 << "b" << 10)));
 }
 
+TEST_F(ExprMatchTest, DottedFieldPathMatchesCorrectlyAmongUnrelatedFields) {
+    createMatcher(fromjson("{$expr: {$eq: ['$a.b', '$c']}}"));
+
+    ASSERT_TRUE(matches(fromjson("{x: 1, a: {b: 3, d: 4}, y: [1, 2], c: 3, z: 'z'}")));
+    ASSERT_TRUE(matches(fromjson("{a: [{b: 1}, {b: 2}], c: [1, 2]}")));
+
+    ASSERT_FALSE(matches(fromjson("{x: 1, a: {b: 3}, c: 4}")));
+    ASSERT_FALSE(matches(fromjson("{x: 3, c: 3}")));
+}
+
+TEST_F(ExprMatchTest, RootVariableSeesWholeDocument) {
+    createMatcher(fromjson("{$expr: {$eq: ['$$ROOT', {$literal: {a: 1, b: 2}}]}}"));
+
+    ASSERT_TRUE(matches(fromjson("{a: 1, b: 2}")));
+
+    ASSERT_FALSE(matches(fromjson("{a: 1}")));
+    ASSERT_FALSE(matches(fromjson("{a: 1, b: 2, c: 3}")));
+}
+
 TEST_F(ExprMatchTest, ComparisonThrowsWithUnboundVariable) {
     ASSERT_THROWS(createMatcher(BSON("$expr" << BSON("$eq" << BSON_ARRAY("$a"
                                                                          << "$$var")))),
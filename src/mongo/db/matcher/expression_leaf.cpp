@@ -223,7 +223,7 @@ RegexMatchExpression::RegexMatchExpression(StringData path, const BSONElement& e
     : LeafMatchExpression(REGEX, path),
       _regex(e.regex()),
       _flags(e.regexFlags()),
-      _re(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str()))) {
+      _re(std::make_shared<pcrecpp::RE>(_regex.c_str(), flags2options(_flags.c_str()))) {
     uassert(ErrorCodes::BadValue, "regex not a regex", e.type() == RegEx);
     _init();
 }
@@ -232,10 +232,30 @@ RegexMatchExpression::RegexMatchExpression(StringData path, StringData regex, St
     : LeafMatchExpression(REGEX, path),
       _regex(regex.toString()),
       _flags(options.toString()),
-      _re(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str()))) {
+      _re(std::make_shared<pcrecpp::RE>(_regex.c_str(), flags2options(_flags.c_str()))) {
     _init();
 }
 
+RegexMatchExpression::RegexMatchExpression(StringData path,
+                                           const std::string& regex,
+                                           const std::string& flags,
+                                           std::shared_ptr<const pcrecpp::RE> re,
+                                           RegexRequiredLiteral requiredLiteral)
+    : LeafMatchExpression(REGEX, path),
+      _regex(regex),
+      _flags(flags),
+      _re(std::move(re)),
+      _requiredLiteral(std::move(requiredLiteral)) {}
+
+std::unique_ptr<MatchExpression> RegexMatchExpression::shallowClone() const {
+    std::unique_ptr<RegexMatchExpression> e(
+        new RegexMatchExpression(path(), _regex, _flags, _re, _requiredLiteral));
+    if (getTag()) {
+        e->setTag(getTag()->clone());
+    }
+    return std::move(e);
+}
+
 void RegexMatchExpression::_init() {
     uassert(ErrorCodes::BadValue,
             "Regular expression cannot contain an embedded null byte",
@@ -248,6 +268,8 @@ void RegexMatchExpression::_init() {
     uassert(ErrorCodes::BadValue,
             str::stream() << "Regular expression is invalid: " << _re->error(),
             _re->error().empty());
+
+    _requiredLiteral = RegexRequiredLiteral::extract(_regex, _flags);
 }
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -265,10 +287,14 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetai
     switch (e.type()) {
         case String:
         case Symbol: {
-            // String values stored in documents can contain embedded NUL bytes. We construct a
-            // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
-            // 'data' early.
-            pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
+            // String values stored in documents can contain embedded NUL bytes. We use the full
+            // length of the string for both the literal check and PCRE to avoid truncating 'data'
+            // early. Strings without the required literal cannot match, so PCRE is skipped.
+            StringData str(e.valuestr(), e.valuestrsize() - 1);
+            if (!_requiredLiteral.isContainedIn(str)) {
+                return false;
+            }
+            pcrecpp::StringPiece data(str.rawData(), str.size());
             return _re->PartialMatch(data);
         }
         case RegEx:
@@ -385,7 +411,8 @@ bool ExistsMatchExpression::equivalent(const MatchExpression* other) const {
 InMatchExpression::InMatchExpression(StringData path)
     : LeafMatchExpression(MATCH_IN, path),
       _eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, _collator),
-      _equalitySet(_eltCmp.makeBSONEltFlatSet(_originalEqualityVector)) {}
+      _equalitySet(_eltCmp.makeBSONEltFlatSet(_originalEqualityVector)),
+      _hashedEqualitySet(_eltCmp.makeBSONEltUnorderedSet()) {}
 
 std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     auto next = stdx::make_unique<InMatchExpression>(path());
@@ -397,6 +424,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_updateHashedEqualitySet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -409,7 +437,11 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (!_hashedEqualitySet.empty()) {
+        if (_hashedEqualitySet.find(e) != _hashedEqualitySet.end()) {
+            return true;
+        }
+    } else if (_equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -501,6 +533,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _updateHashedEqualitySet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -521,10 +554,20 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     _originalEqualityVector = std::move(equalities);
 
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _updateHashedEqualitySet();
 
     return Status::OK();
 }
 
+void InMatchExpression::_updateHashedEqualitySet() {
+    _hashedEqualitySet = _eltCmp.makeBSONEltUnorderedSet();
+    if (_equalitySet.size() < kMinEqualitiesForHashedLookup) {
+        return;
+    }
+    _hashedEqualitySet.reserve(_equalitySet.size());
+    _hashedEqualitySet.insert(_equalitySet.begin(), _equalitySet.end());
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
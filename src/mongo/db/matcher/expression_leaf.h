@@ -33,6 +33,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_path.h"
+#include "mongo/db/matcher/regex_literal.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_map.h"
@@ -224,14 +225,7 @@ public:
     RegexMatchExpression(StringData path, StringData regex, StringData options);
     ~RegexMatchExpression();
 
-    virtual std::unique_ptr<MatchExpression> shallowClone() const {
-        std::unique_ptr<RegexMatchExpression> e =
-            stdx::make_unique<RegexMatchExpression>(path(), _regex, _flags);
-        if (getTag()) {
-            e->setTag(getTag()->clone());
-        }
-        return std::move(e);
-    }
+    virtual std::unique_ptr<MatchExpression> shallowClone() const;
 
     bool matchesSingleElement(const BSONElement&, MatchDetails* details = nullptr) const final;
 
@@ -252,7 +246,21 @@ public:
         return _flags;
     }
 
+    const RegexRequiredLiteral& getRequiredLiteral() const {
+        return _requiredLiteral;
+    }
+
 private:
+    /**
+     * Used by shallowClone() so that clones share the compiled pattern rather than compiling it
+     * again. Planning clones filters for every candidate plan.
+     */
+    RegexMatchExpression(StringData path,
+                         const std::string& regex,
+                         const std::string& flags,
+                         std::shared_ptr<const pcrecpp::RE> re,
+                         RegexRequiredLiteral requiredLiteral);
+
     ExpressionOptimizerFunc getOptimizer() const final {
         return [](std::unique_ptr<MatchExpression> expression) { return expression; };
     }
@@ -261,7 +269,10 @@ private:
 
     std::string _regex;
     std::string _flags;
-    std::unique_ptr<pcrecpp::RE> _re;
+    std::shared_ptr<const pcrecpp::RE> _re;
+
+    // A substring every matching string contains, checked before running '_re'.
+    RegexRequiredLiteral _requiredLiteral;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -332,6 +343,10 @@ private:
  */
 class InMatchExpression : public LeafMatchExpression {
 public:
+    // Lists with at least this many equalities are also kept in a hash set, so that matching an
+    // element costs one hash lookup instead of a binary search over the sorted equalities.
+    static const size_t kMinEqualitiesForHashedLookup = 32;
+
     explicit InMatchExpression(StringData path);
 
     virtual std::unique_ptr<MatchExpression> shallowClone() const;
@@ -376,6 +391,12 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Rebuilds '_hashedEqualitySet' from '_originalEqualityVector' using '_eltCmp', or empties it
+     * if there are too few equalities for hashing to pay off.
+     */
+    void _updateHashedEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -396,6 +417,11 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // The same elements as '_equalitySet' when there are at least kMinEqualitiesForHashedLookup of
+    // them, otherwise empty. '_eltCmp' provides its hash and equality, so lookups agree with the
+    // collation.
+    BSONEltUnorderedSet _hashedEqualitySet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
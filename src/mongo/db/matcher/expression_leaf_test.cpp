@@ -37,6 +37,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -1258,6 +1259,56 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, LargeInMatchesEquivalentNumbersAndNotOthers) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < static_cast<int>(InMatchExpression::kMinEqualitiesForHashedLookup) * 2;
+         ++i) {
+        operandBuilder.append(i * 2);
+    }
+    BSONArray operand = operandBuilder.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj matches = BSON("int" << 10 << "long" << 10LL << "double" << 10.0 << "decimal"
+                                 << Decimal128("10"));
+    for (auto&& elem : matches) {
+        ASSERT(in.matchesSingleElement(elem)) << elem;
+    }
+    BSONObj notMatches = BSON("odd" << 11 << "fraction" << 10.5 << "string"
+                                    << "10");
+    for (auto&& elem : notMatches) {
+        ASSERT(!in.matchesSingleElement(elem)) << elem;
+    }
+}
+
+TEST(InMatchExpression, LargeInRespectsCollationAndCollationChanges) {
+    BSONArrayBuilder operandBuilder;
+    for (size_t i = 0; i < InMatchExpression::kMinEqualitiesForHashedLookup; ++i) {
+        operandBuilder.append(str::stream() << "abc" << i);
+    }
+    BSONArray operand = operandBuilder.arr();
+    BSONObj match = BSON("a"
+                         << "ABC0");
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(!in.matchesSingleElement(match["a"]));
+
+    in.setCollator(&collator);
+    ASSERT(in.matchesSingleElement(match["a"]));
+    BSONObj notMatch = BSON("a"
+                            << "ABC");
+    ASSERT(!in.matchesSingleElement(notMatch["a"]));
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(match["a"]));
+    ASSERT(!clone->matchesSingleElement(notMatch["a"]));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
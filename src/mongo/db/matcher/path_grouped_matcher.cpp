@@ -0,0 +1,208 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/path_grouped_matcher.h"
+
+#include <boost/container/small_vector.hpp>
+
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/db/matcher/matchable.h"
+
+namespace mongo {
+
+namespace {
+
+const size_t kInlineGroupFields = 8;
+
+/**
+ * Adds the paths 'expr' matches on to 'numPaths' and sets 'field' to their shared first field.
+ * Returns false if 'expr' cannot be grouped, either because it reads the document in some other
+ * way or because its paths start with different fields.
+ *
+ * Logical nodes are looked through, because they only combine the results of their children on
+ * the same input. A $not only negates the match of its child, so it is grouped with its child's
+ * path, which covers $ne, $nin and {$exists: false}. Constant nodes don't read the document, and
+ * $jsonSchema leaves them in the trees it generates.
+ */
+bool collectGroupableField(const MatchExpression* expr, StringData* field, size_t* numPaths) {
+    switch (expr->matchType()) {
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            return true;
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+        case MatchExpression::INTERNAL_SCHEMA_XOR:
+        case MatchExpression::INTERNAL_SCHEMA_COND:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!collectGroupableField(expr->getChild(i), field, numPaths)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            break;
+    }
+
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!pathExpr) {
+        return false;
+    }
+    const StringData path = pathExpr->path();
+    const size_t dot = path.find('.');
+    const StringData firstField = dot == std::string::npos ? path : path.substr(0, dot);
+    if (firstField.empty() || (!field->empty() && *field != firstField)) {
+        return false;
+    }
+    *field = firstField;
+    ++*numPaths;
+    return true;
+}
+
+/**
+ * Returns the first field shared by the paths 'expr' matches on, or an empty StringData if 'expr'
+ * cannot be grouped. Sets 'numPaths' to the number of those paths.
+ */
+StringData groupableField(const MatchExpression* expr, size_t* numPaths) {
+    StringData field;
+    *numPaths = 0;
+    if (!collectGroupableField(expr, &field, numPaths)) {
+        return StringData();
+    }
+    return field;
+}
+
+}  // namespace
+
+PathGroupedMatcher::PathGroupedMatcher(const MatchExpression* filter) : _filter(filter) {
+    if (!_filter || _filter->matchType() != MatchExpression::AND || _filter->numChildren() < 2) {
+        return;
+    }
+
+    // Maps a first field to the index of its step in '_steps'.
+    StringMap<size_t> stepsByField;
+    for (size_t i = 0; i < _filter->numChildren(); ++i) {
+        const MatchExpression* child = _filter->getChild(i);
+        size_t numPaths;
+        const StringData field = groupableField(child, &numPaths);
+        if (field.empty()) {
+            _steps.emplace_back();
+            _steps.back().exprs.push_back(child);
+            continue;
+        }
+
+        auto it = stepsByField.find(field);
+        if (it == stepsByField.end()) {
+            stepsByField[field] = _steps.size();
+            _steps.emplace_back();
+            _steps.back().field = field.toString();
+            it = stepsByField.find(field);
+        }
+
+        Step& step = _steps[it->second];
+        step.exprs.push_back(child);
+        step.numPaths += numPaths;
+    }
+
+    for (auto&& step : _steps) {
+        if (step.numPaths >= 2) {
+            step.isGroup = true;
+            step.groupIndex = _numGroups++;
+        }
+    }
+
+    if (_numGroups == 0) {
+        _steps.clear();
+        return;
+    }
+
+    if (_numGroups >= kMinGroupsForSingleScan) {
+        for (auto&& step : _steps) {
+            if (step.isGroup) {
+                _groupIndexByField[step.field] = step.groupIndex;
+            }
+        }
+    }
+}
+
+bool PathGroupedMatcher::matchesBSON(const BSONObj& doc) const {
+    if (!_filter) {
+        return true;
+    }
+
+    BSONMatchableDocument matchableDoc(doc);
+    if (_steps.empty()) {
+        return _filter->matches(&matchableDoc);
+    }
+
+    // Finds the first occurrence of each group's field, which is the element getField() returns.
+    // Fields that are missing are left as EOO.
+    boost::container::small_vector<BSONElement, kInlineGroupFields> groupFields;
+    if (!_groupIndexByField.empty()) {
+        groupFields.resize(_numGroups);
+        size_t numFound = 0;
+        for (auto&& elem : doc) {
+            auto it = _groupIndexByField.find(elem.fieldNameStringData());
+            if (it == _groupIndexByField.end() || !groupFields[it->second].eoo()) {
+                continue;
+            }
+            groupFields[it->second] = elem;
+            if (++numFound == _numGroups) {
+                break;
+            }
+        }
+    }
+
+    for (auto&& step : _steps) {
+        if (!step.isGroup) {
+            for (auto&& expr : step.exprs) {
+                if (!expr->matches(&matchableDoc)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        // The view behaves like a document with 'field' as its only field, so the predicates
+        // traverse the rest of their paths from the element found here.
+        BSONElementViewMatchableDocument fieldView(groupFields.empty()
+                                                       ? doc.getField(step.field)
+                                                       : groupFields[step.groupIndex]);
+        for (auto&& expr : step.exprs) {
+            if (!expr->matches(&fieldView)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Evaluates a filter against whole documents, resolving the first field of a path once for all
+ * the conjuncts that share it. Evaluating a $and child by child makes every PathMatchExpression
+ * search the top-level document for its own first field, so a filter with six predicates on
+ * fields of the same subdocument scans the document six times.
+ *
+ * The constructor looks at the top-level children of a $and filter. Path predicates whose paths
+ * start with the same field form a group. For each document, the group's field is found once,
+ * and the group's predicates are matched against a view anchored at that field's element. That
+ * traversal behaves exactly like traversing the path from the document root, including when the
+ * field is missing or is an array. All other children are matched as usual, in their original
+ * order.
+ *
+ * A child may also be a logical tree ($and, $or, $nor, $not and the JSON Schema $_internalSchemaXor
+ * and $_internalSchemaCond), as long as all the paths in it start with the same field. This is
+ * the shape $jsonSchema gives each entry of 'properties', so a single such child already forms a
+ * group when it holds two or more path predicates. When there are many groups, all their fields
+ * are found in one scan of the document.
+ *
+ * 'filter' may be null, in which case every document matches. It is not owned and must outlive
+ * this object, and it must not be modified while this object is in use.
+ */
+class PathGroupedMatcher {
+    MONGO_DISALLOW_COPYING(PathGroupedMatcher);
+
+public:
+    explicit PathGroupedMatcher(const MatchExpression* filter);
+
+    const MatchExpression* getFilter() const {
+        return _filter;
+    }
+
+    /**
+     * Documents are scanned once for the fields of all groups, instead of once per group, when
+     * there are at least this many groups.
+     */
+    static const size_t kMinGroupsForSingleScan = 4;
+
+    /**
+     * Returns the number of groups of predicates that share the resolution of their first field.
+     */
+    size_t numGroups() const {
+        return _numGroups;
+    }
+
+    /**
+     * Returns whether 'doc' matches the filter, giving the same answer as
+     * getFilter()->matchesBSON(doc).
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+private:
+    // Either a single child to match on its own, or a group of path predicates whose paths all
+    // start with 'field'.
+    struct Step {
+        std::string field;
+        std::vector<const MatchExpression*> exprs;
+        size_t numPaths = 0;
+        bool isGroup = false;
+
+        // The position of this group's field among the fields found by a single scan.
+        size_t groupIndex = 0;
+    };
+
+    const MatchExpression* _filter;
+
+    // Empty unless '_filter' is a $and with at least one group.
+    std::vector<Step> _steps;
+
+    size_t _numGroups = 0;
+
+    // Maps the field of each group to its 'groupIndex'. Empty unless documents are scanned once
+    // for all the groups.
+    StringMap<size_t> _groupIndexByField;
+};
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/path_grouped_matcher.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto statusWithExpr = MatchExpressionParser::parse(query, std::move(expCtx));
+    ASSERT_OK(statusWithExpr.getStatus());
+    return std::move(statusWithExpr.getValue());
+}
+
+/**
+ * Asserts that the grouped matcher and the filter itself agree on every document.
+ */
+void assertAgreesWithFilter(const BSONObj& query, size_t expectedGroups) {
+    const std::vector<BSONObj> docs{
+        fromjson("{}"),
+        fromjson("{a: 1}"),
+        fromjson("{a: {b: 1, c: 2}}"),
+        fromjson("{a: {b: 1, c: 3}}"),
+        fromjson("{a: {b: null}}"),
+        fromjson("{a: {b: [1, 2], c: [2]}}"),
+        fromjson("{a: [{b: 1}, {c: 2}]}"),
+        fromjson("{a: [{b: 1, c: 2}]}"),
+        fromjson("{a: [[{b: 1}], {c: 2}]}"),
+        fromjson("{a: [1, 2]}"),
+        fromjson("{a: {'0': {b: 1}}, x: 5}"),
+        fromjson("{a: [{'0': 1}, {b: 1}], x: [5]}"),
+        fromjson("{x: 5, a: {b: 1, c: 2, d: {e: 1}}}"),
+        fromjson("{x: 6, a: {b: 1, c: 2, d: [{e: 1}, {e: 2}]}}"),
+    };
+
+    auto expr = parse(query);
+    PathGroupedMatcher matcher(expr.get());
+    ASSERT_EQ(expectedGroups, matcher.numGroups()) << query;
+    for (auto&& doc : docs) {
+        ASSERT_EQ(expr->matchesBSON(doc), matcher.matchesBSON(doc)) << query << " " << doc;
+    }
+}
+
+TEST(PathGroupedMatcherTest, NullFilterMatchesEverything) {
+    PathGroupedMatcher matcher(nullptr);
+    ASSERT(matcher.matchesBSON(fromjson("{a: 1}")));
+}
+
+TEST(PathGroupedMatcherTest, FiltersWithoutSharedFieldsAreNotGrouped) {
+    assertAgreesWithFilter(fromjson("{'a.b': 1}"), 0);
+    assertAgreesWithFilter(fromjson("{'a.b': 1, x: 5}"), 0);
+    assertAgreesWithFilter(fromjson("{$or: [{'a.b': 1}, {'a.c': 2}]}"), 0);
+}
+
+TEST(PathGroupedMatcherTest, SharedFirstFieldFormsOneGroup) {
+    assertAgreesWithFilter(fromjson("{'a.b': 1, 'a.c': 2}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': 1, 'a.c': 2, x: 5}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': 1, 'a.c': {$gt: 1}, 'a.d.e': 1}"), 1);
+    assertAgreesWithFilter(fromjson("{a: {$exists: true}, 'a.b': 1}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': 1, 'a.c': 2, x: 5, 'x.y': {$exists: false}}"), 2);
+}
+
+TEST(PathGroupedMatcherTest, NegationsAreGroupedWithTheirChildPath) {
+    assertAgreesWithFilter(fromjson("{'a.b': {$ne: 1}, 'a.c': {$ne: 3}}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': {$nin: [1]}, 'a.z': null}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': {$not: {$gt: 1}}, 'a.c': 2}"), 1);
+}
+
+TEST(PathGroupedMatcherTest, GroupsAgreeOnMissingFieldsAndNulls) {
+    assertAgreesWithFilter(fromjson("{'a.b': null, 'a.c': {$exists: false}}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.z': null, 'a.b': {$exists: true}}"), 1);
+}
+
+TEST(PathGroupedMatcherTest, GroupsAgreeOnArrays) {
+    assertAgreesWithFilter(fromjson("{'a.b': 1, 'a.c': 2, 'a.0': {$exists: true}}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.0.b': 1, 'a.1': {c: 2}}"), 1);
+    assertAgreesWithFilter(fromjson("{a: {$size: 2}, 'a.b': {$exists: true}}"), 1);
+    assertAgreesWithFilter(fromjson("{a: {$elemMatch: {b: 1}}, 'a.c': 2}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.b': {$elemMatch: {$gt: 1}}, 'a.c': {$in: [2, 3]}}"), 1);
+    assertAgreesWithFilter(fromjson("{'a.d.e': 2, 'a.d': {$type: 'array'}}"), 1);
+}
+
+TEST(PathGroupedMatcherTest, LogicalTreesOnOneFieldAreGrouped) {
+    assertAgreesWithFilter(fromjson("{$or: [{'a.b': 1}, {'a.c': 3}], x: 5}"), 1);
+    assertAgreesWithFilter(fromjson("{$or: [{a: {$exists: false}}, {'a.b': 1, 'a.c': 2}], x: 5}"),
+                           1);
+    assertAgreesWithFilter(fromjson("{$nor: [{'a.b': 2}, {'a.c': 3}], 'a.d': {$exists: false}}"),
+                           1);
+    assertAgreesWithFilter(fromjson("{$or: [{'a.b': 1}, {'x': 5}], 'a.c': 2}"), 0);
+    assertAgreesWithFilter(fromjson("{$or: [{'a.b': 1}, {$alwaysTrue: 1}], 'a.c': 2}"), 1);
+    assertAgreesWithFilter(fromjson("{$or: [{'a.b': 1}], x: 5}"), 0);
+}
+
+TEST(PathGroupedMatcherTest, ManyGroupsAreResolvedInOneScan) {
+    const BSONObj query = fromjson(
+        "{'a.x': 1, 'a.y': {$ne: 2}, 'b.x': 1, 'b.y': {$exists: false}, 'c.x': {$in: [1, 2]},"
+        " 'c.y': null, 'd.x': {$gte: 1}, 'd.y': {$lt: 3}, e: 1}");
+    const std::vector<BSONObj> docs{
+        fromjson("{}"),
+        fromjson("{a: {x: 1}, b: {x: 1}, c: {x: 1}, d: {x: 1}, e: 1}"),
+        fromjson("{e: 1, d: {x: 1, y: 2}, c: [{x: 2}], b: {x: 1}, a: {x: 1, y: 3}}"),
+        fromjson("{a: {x: 1}, b: {x: 1}, c: {x: 1}, d: {x: 1}, e: 1, a: {x: 2}}"),
+        fromjson("{a: {x: 2}, b: {x: 1}, c: {x: 1}, d: {x: 1}, e: 1, a: {x: 1}}"),
+        fromjson("{a: {x: 1, y: 2}, b: {x: 1}, c: {x: 1}, d: {x: 1}, e: 1}"),
+        fromjson("{a: {x: 1}, b: {x: 1, y: 1}, c: {x: 1}, d: {x: 1}, e: 1}"),
+        fromjson("{a: {x: 1}, c: {x: 1}, d: {x: 1}, e: 1}"),
+    };
+
+    auto expr = parse(query);
+    PathGroupedMatcher matcher(expr.get());
+    const size_t minGroupsForSingleScan = PathGroupedMatcher::kMinGroupsForSingleScan;
+    ASSERT_EQ(4U, matcher.numGroups());
+    ASSERT_GTE(matcher.numGroups(), minGroupsForSingleScan);
+    for (auto&& doc : docs) {
+        ASSERT_EQ(expr->matchesBSON(doc), matcher.matchesBSON(doc)) << doc;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,350 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_literal.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the position of the first \E at or after 'pos' in 'regex', or std::string::npos.
+ */
+size_t findQuoteEnd(StringData regex, size_t pos) {
+    if (pos >= regex.size()) {
+        return std::string::npos;
+    }
+    const size_t found = regex.substr(pos).find("\\E");
+    return found == std::string::npos ? found : pos + found;
+}
+
+bool isUTF8ContinuationByte(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+char toLowerASCII(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+/**
+ * Single-token escape sequences which take no argument: assertions, character types and \K.
+ */
+bool isArgumentlessEscape(char c) {
+    return c != '\0' && std::strchr("bBAzZGdDwWsShHvVRNXCK", c);
+}
+
+/**
+ * Returns the index just past the character class starting at 'regex[start]', which must be '[',
+ * or std::string::npos if the class is not terminated.
+ */
+size_t skipCharacterClass(StringData regex, size_t start) {
+    size_t i = start + 1;
+    if (i < regex.size() && regex[i] == '^') {
+        ++i;
+    }
+    // A ']' straight after the opening is a literal member of the class.
+    if (i < regex.size() && regex[i] == ']') {
+        ++i;
+    }
+    while (i < regex.size()) {
+        const char c = regex[i];
+        if (c == '\\') {
+            i += 2;
+        } else if (c == '[' && i + 1 < regex.size() && std::strchr(":.=", regex[i + 1])) {
+            // A POSIX class such as [:alpha:] ends with the same delimiter followed by ']'.
+            const char delimiter = regex[i + 1];
+            size_t end = i + 2;
+            while (end + 1 < regex.size() && !(regex[end] == delimiter && regex[end + 1] == ']')) {
+                ++end;
+            }
+            if (end + 1 >= regex.size()) {
+                return std::string::npos;
+            }
+            i = end + 2;
+        } else if (c == ']') {
+            return i + 1;
+        } else {
+            ++i;
+        }
+    }
+    return std::string::npos;
+}
+
+/**
+ * Returns the index just past the group starting at 'regex[start]', which must be '(', or
+ * std::string::npos if the group is not terminated.
+ */
+size_t skipGroup(StringData regex, size_t start) {
+    size_t depth = 0;
+    size_t i = start;
+    while (i < regex.size()) {
+        const char c = regex[i];
+        if (c == '\\') {
+            if (i + 1 < regex.size() && regex[i + 1] == 'Q') {
+                // Everything up to \E is literal, including parentheses.
+                const size_t end = findQuoteEnd(regex, i + 2);
+                if (end == std::string::npos) {
+                    return std::string::npos;
+                }
+                i = end + 2;
+            } else {
+                i += 2;
+            }
+        } else if (c == '[') {
+            i = skipCharacterClass(regex, i);
+            if (i == std::string::npos) {
+                return i;
+            }
+        } else if (c == '(') {
+            ++depth;
+            ++i;
+        } else if (c == ')') {
+            if (--depth == 0) {
+                return i + 1;
+            }
+            ++i;
+        } else {
+            ++i;
+        }
+    }
+    return std::string::npos;
+}
+
+/**
+ * Accumulates literal runs and remembers the longest one.
+ */
+class RunBuilder {
+public:
+    explicit RunBuilder(bool caseInsensitive) : _caseInsensitive(caseInsensitive) {}
+
+    /**
+     * Appends the literal character 'c', or ends the run if 'c' cannot be part of a literal.
+     */
+    void append(char c) {
+        if (_caseInsensitive && !RegexRequiredLiteral::foldsCaseWithinASCII(c)) {
+            endRun();
+            return;
+        }
+        _current.push_back(_caseInsensitive ? toLowerASCII(c) : c);
+        _lastTokenInRun = true;
+    }
+
+    /**
+     * Handles a quantifier. If 'mayBeAbsent', the quantified token is optional and is removed
+     * from the run; otherwise it stays. Either way the run cannot continue past a quantifier.
+     */
+    void quantify(bool mayBeAbsent) {
+        if (mayBeAbsent && _lastTokenInRun) {
+            // Remove the whole last character, which may span several UTF-8 bytes.
+            while (!_current.empty() && isUTF8ContinuationByte(_current.back())) {
+                _current.pop_back();
+            }
+            if (!_current.empty()) {
+                _current.pop_back();
+            }
+        }
+        endRun();
+    }
+
+    void endRun() {
+        if (_current.size() > _longest.size()) {
+            _longest = _current;
+        }
+        _current.clear();
+        _lastTokenInRun = false;
+    }
+
+    std::string finish() {
+        endRun();
+        return _longest;
+    }
+
+private:
+    const bool _caseInsensitive;
+    std::string _current;
+    std::string _longest;
+
+    // Whether the last token parsed is the last character of '_current', so that a quantifier
+    // following it applies to that character.
+    bool _lastTokenInRun = false;
+};
+
+}  // namespace
+
+bool RegexRequiredLiteral::foldsCaseWithinASCII(char c) {
+    const unsigned char uc = static_cast<unsigned char>(c);
+    return uc < 0x80 && c != 'k' && c != 'K' && c != 's' && c != 'S';
+}
+
+RegexRequiredLiteral RegexRequiredLiteral::extract(StringData regex, StringData flags) {
+    bool caseInsensitive = false;
+    for (char flag : flags) {
+        if (flag == 'i') {
+            caseInsensitive = true;
+        } else if (flag == 'x') {
+            // Whitespace and comments would need to be skipped; do not try.
+            return {};
+        }
+    }
+
+    RunBuilder runs(caseInsensitive);
+    size_t i = 0;
+    while (i < regex.size()) {
+        const char c = regex[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 >= regex.size()) {
+                    return {};
+                }
+                const char escaped = regex[i + 1];
+                if (escaped == 'Q') {
+                    const size_t end = findQuoteEnd(regex, i + 2);
+                    const size_t quotedEnd = end == std::string::npos ? regex.size() : end;
+                    for (size_t q = i + 2; q < quotedEnd; ++q) {
+                        runs.append(regex[q]);
+                    }
+                    i = end == std::string::npos ? regex.size() : end + 2;
+                } else if (std::isalnum(static_cast<unsigned char>(escaped))) {
+                    // Escapes such as \x41, \1 or \p{L} take arguments which must not be mistaken
+                    // for literals.
+                    if (!isArgumentlessEscape(escaped)) {
+                        return {};
+                    }
+                    runs.endRun();
+                    i += 2;
+                } else if (static_cast<unsigned char>(escaped) >= 0x80) {
+                    return {};
+                } else {
+                    runs.append(escaped);
+                    i += 2;
+                }
+                break;
+            }
+            case '.':
+            case '^':
+            case '$':
+                runs.endRun();
+                ++i;
+                break;
+            case '[':
+                runs.endRun();
+                i = skipCharacterClass(regex, i);
+                if (i == std::string::npos) {
+                    return {};
+                }
+                break;
+            case '(':
+                // Inline options such as (?i) and verbs such as (*UCP) change how the rest of the
+                // pattern matches.
+                if (i + 1 < regex.size() && (regex[i + 1] == '?' || regex[i + 1] == '*')) {
+                    return {};
+                }
+                runs.endRun();
+                i = skipGroup(regex, i);
+                if (i == std::string::npos) {
+                    return {};
+                }
+                break;
+            case ')':
+            case '|':
+                return {};
+            case '*':
+            case '?':
+            case '+':
+            case '{': {
+                runs.quantify(c != '+');
+                if (c == '{') {
+                    const size_t end = regex.find('}', i);
+                    if (end == std::string::npos) {
+                        return RegexRequiredLiteral(runs.finish(), caseInsensitive);
+                    }
+                    i = end + 1;
+                } else {
+                    ++i;
+                }
+                // Skip a lazy or possessive modifier.
+                if (i < regex.size() && (regex[i] == '?' || regex[i] == '+')) {
+                    ++i;
+                }
+                break;
+            }
+            default:
+                runs.append(c);
+                ++i;
+        }
+    }
+
+    return RegexRequiredLiteral(runs.finish(), caseInsensitive);
+}
+
+bool RegexRequiredLiteral::isContainedIn(StringData str) const {
+    const size_t literalSize = _literal.size();
+    if (literalSize == 0) {
+        return true;
+    }
+    if (literalSize > str.size()) {
+        return false;
+    }
+
+    const char* const begin = str.rawData();
+    const char* const last = begin + (str.size() - literalSize);
+
+    if (!_caseInsensitive) {
+        // Find candidates for the first byte with memchr, then compare the rest.
+        const char* cur = begin;
+        while (cur <= last) {
+            cur = static_cast<const char*>(std::memchr(cur, _literal[0], last - cur + 1));
+            if (!cur) {
+                return false;
+            }
+            if (std::memcmp(cur + 1, _literal.data() + 1, literalSize - 1) == 0) {
+                return true;
+            }
+            ++cur;
+        }
+        return false;
+    }
+
+    for (const char* cur = begin; cur <= last; ++cur) {
+        size_t matched = 0;
+        while (matched < literalSize && toLowerASCII(cur[matched]) == _literal[matched]) {
+            ++matched;
+        }
+        if (matched == literalSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A substring that every string matched by a regular expression must contain, used to reject
+ * most non-matching strings with a substring search before running PCRE.
+ */
+class RegexRequiredLiteral {
+public:
+    /**
+     * Returns the longest literal run that any match of the regex 'regex' with options 'flags'
+     * must contain. Returns an empty literal when none can be proven, for example when the
+     * pattern has a top-level alternation, inline options or the extended ('x') option. Parts of
+     * the pattern that are not plain literals, such as groups, classes and quantified characters,
+     * end the current run instead of being analyzed.
+     *
+     * With the case insensitive ('i') option, the literal only contains ASCII characters whose
+     * case folding PCRE cannot extend beyond ASCII, and it is stored lowercased.
+     */
+    static RegexRequiredLiteral extract(StringData regex, StringData flags);
+
+    /**
+     * Returns whether PCRE's case insensitive matching of 'c' only matches the ASCII upper and
+     * lower case forms of 'c'. This is true of every ASCII character except 'k' and 's', which
+     * also match the Kelvin sign and the long s in UTF-8 mode.
+     */
+    static bool foldsCaseWithinASCII(char c);
+
+    RegexRequiredLiteral() = default;
+
+    bool empty() const {
+        return _literal.empty();
+    }
+
+    const std::string& getLiteral() const {
+        return _literal;
+    }
+
+    bool isCaseInsensitive() const {
+        return _caseInsensitive;
+    }
+
+    /**
+     * Returns whether 'str' contains the literal. Always true for an empty literal.
+     */
+    bool isContainedIn(StringData str) const;
+
+private:
+    RegexRequiredLiteral(std::string literal, bool caseInsensitive)
+        : _literal(std::move(literal)), _caseInsensitive(caseInsensitive) {}
+
+    std::string _literal;
+    bool _caseInsensitive = false;
+};
+
+}  // namespace mongo
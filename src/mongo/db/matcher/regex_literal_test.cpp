@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_literal.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string extract(StringData regex, StringData flags = "") {
+    return RegexRequiredLiteral::extract(regex, flags).getLiteral();
+}
+
+TEST(RegexRequiredLiteralTest, PlainPatternIsItsOwnLiteral) {
+    ASSERT_EQ("abc", extract("abc"));
+    ASSERT_EQ("abc", extract("^abc$"));
+    ASSERT_EQ("a.b", extract("a\\.b"));
+    ASSERT_EQ("a(b", extract("\\Qa(b\\E"));
+}
+
+TEST(RegexRequiredLiteralTest, LongestRunIsChosen) {
+    ASSERT_EQ("world", extract("hi.world"));
+    ASSERT_EQ(" smith", extract("^j[a-z]+ smith"));
+    ASSERT_EQ("efgh", extract("ab(cd)efgh"));
+    ASSERT_EQ("xyz", extract("a\\d+xyz"));
+}
+
+TEST(RegexRequiredLiteralTest, QuantifiedCharactersAreDropped) {
+    ASSERT_EQ("ab", extract("abc*d"));
+    ASSERT_EQ("ab", extract("abc?d"));
+    ASSERT_EQ("ab", extract("abc{0,2}d"));
+    ASSERT_EQ("abc", extract("abc+d"));
+    ASSERT_EQ("ab", extract("abc*?d"));
+    ASSERT_EQ("de", extract("(abc)*de"));
+    // A quantifier after a multi-byte character removes all of its bytes.
+    ASSERT_EQ("ab", extract("ab\xc3\xa9*"));
+}
+
+TEST(RegexRequiredLiteralTest, NothingIsProvenForUnsafePatterns) {
+    ASSERT_EQ("", extract("abc|def"));
+    ASSERT_EQ("", extract("(?i)abc"));
+    ASSERT_EQ("", extract("(*UCP)abc"));
+    ASSERT_EQ("", extract("\\x41bc"));
+    ASSERT_EQ("", extract("(a)\\1bc"));
+    ASSERT_EQ("", extract("abc", "x"));
+    ASSERT_EQ("", extract("[abc"));
+    ASSERT_EQ("", extract("^.*$"));
+}
+
+TEST(RegexRequiredLiteralTest, ClassesAndGroupsAreSkipped) {
+    ASSERT_EQ("cd", extract("[]ab]cd"));
+    ASSERT_EQ("cd", extract("[[:alpha:]]cd"));
+    ASSERT_EQ("cd", extract("(a[)]b)cd"));
+    ASSERT_EQ("cd", extract("(a(b|c))cd"));
+}
+
+TEST(RegexRequiredLiteralTest, CaseInsensitiveLiteralIsLowercasedASCII) {
+    auto literal = RegexRequiredLiteral::extract("^John", "i");
+    ASSERT(literal.isCaseInsensitive());
+    ASSERT_EQ("john", literal.getLiteral());
+
+    // 'k' and 's' also match non-ASCII characters, as do non-ASCII characters themselves.
+    ASSERT_EQ("ma", extract("Mask", "i"));
+    ASSERT_EQ("ab", extract("ab\xc3\xa9", "i"));
+}
+
+TEST(RegexRequiredLiteralTest, IsContainedIn) {
+    auto caseSensitive = RegexRequiredLiteral::extract("smith", "");
+    ASSERT(caseSensitive.isContainedIn("john smith"));
+    ASSERT(caseSensitive.isContainedIn("smithers"));
+    ASSERT(!caseSensitive.isContainedIn("john Smith"));
+    ASSERT(!caseSensitive.isContainedIn("smit"));
+    ASSERT(caseSensitive.isContainedIn(StringData("a\0smith", 7)));
+
+    auto caseInsensitive = RegexRequiredLiteral::extract("SMITH", "i");
+    ASSERT(caseInsensitive.isContainedIn("john smith"));
+    ASSERT(caseInsensitive.isContainedIn("JOHN SMITH"));
+    ASSERT(caseInsensitive.isContainedIn("sMiThErS"));
+    ASSERT(!caseInsensitive.isContainedIn("smyth"));
+
+    ASSERT(RegexRequiredLiteral().isContainedIn(""));
+}
+
+}  // namespace
+}  // namespace mongo
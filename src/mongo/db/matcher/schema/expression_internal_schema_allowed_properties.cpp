@@ -50,6 +50,17 @@ InternalSchemaAllowedPropertiesMatchExpression::InternalSchemaAllowedPropertiesM
                 str::stream() << "Invalid regular expression: " << errorStr,
                 errorStr.empty());
     }
+
+    _patternsMatchingProperty.resize(_properties.size());
+    auto matchingPatterns = _patternsMatchingProperty.begin();
+    for (auto&& property : _properties) {
+        for (size_t i = 0; i < _patternProperties.size(); ++i) {
+            if (_patternProperties[i].first.matches(property)) {
+                matchingPatterns->push_back(i);
+            }
+        }
+        ++matchingPatterns;
+    }
 }
 
 void InternalSchemaAllowedPropertiesMatchExpression::debugString(StringBuilder& debug,
@@ -103,9 +114,23 @@ bool InternalSchemaAllowedPropertiesMatchExpression::matchesSingleElement(const
 
 bool InternalSchemaAllowedPropertiesMatchExpression::_matchesBSONObj(const BSONObj& obj) const {
     for (auto&& property : obj) {
+        const StringData fieldName = property.fieldNameStringData();
+
+        // The patterns that match a listed property were found at construction, and a listed
+        // property never needs to match '_otherwise'.
+        auto propertyIt = _properties.find(fieldName);
+        if (propertyIt != _properties.end()) {
+            for (auto i : _patternsMatchingProperty[propertyIt - _properties.begin()]) {
+                if (!_patternProperties[i].second->matchesBSONElement(property)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+
         bool checkOtherwise = true;
         for (auto&& constraint : _patternProperties) {
-            if (constraint.first.regex->PartialMatch(property.fieldName())) {
+            if (constraint.first.matches(fieldName)) {
                 checkOtherwise = false;
                 if (!constraint.second->matchesBSONElement(property)) {
                     return false;
@@ -113,11 +138,6 @@ bool InternalSchemaAllowedPropertiesMatchExpression::_matchesBSONObj(const BSONO
             }
         }
 
-        if (checkOtherwise &&
-            _properties.find(property.fieldNameStringData()) != _properties.end()) {
-            checkOtherwise = false;
-        }
-
         if (checkOtherwise && !_otherwise->matchesBSONElement(property)) {
             return false;
         }
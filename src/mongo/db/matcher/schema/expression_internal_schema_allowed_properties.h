@@ -35,6 +35,7 @@
 
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_with_placeholder.h"
+#include "mongo/db/matcher/regex_literal.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -90,14 +91,26 @@ class InternalSchemaAllowedPropertiesMatchExpression final : public MatchExpress
 public:
     /**
      * A container for regular expression data. Holds a pcrecpp::RE object, as well as the original
-     * string pattern, which is used for comparisons and serialization.
+     * string pattern, which is used for comparisons and serialization. Field names that lack a
+     * literal every match must contain are rejected without running the regex.
      */
     struct Pattern {
         explicit Pattern(StringData pattern)
-            : rawRegex(pattern), regex(stdx::make_unique<pcrecpp::RE>(pattern.toString())) {}
+            : rawRegex(pattern),
+              regex(stdx::make_unique<pcrecpp::RE>(pattern.toString())),
+              requiredLiteral(RegexRequiredLiteral::extract(pattern, "")) {}
+
+        /**
+         * Returns whether the regex matches anywhere in 'fieldName'.
+         */
+        bool matches(StringData fieldName) const {
+            return requiredLiteral.isContainedIn(fieldName) &&
+                regex->PartialMatch(pcrecpp::StringPiece(fieldName.rawData(), fieldName.size()));
+        }
 
         StringData rawRegex;
         std::unique_ptr<pcrecpp::RE> regex;
+        RegexRequiredLiteral requiredLiteral;
     };
 
     /**
@@ -172,6 +185,11 @@ private:
     // Since that BSONObj must outlive this object, we can safely store StringData.
     boost::container::flat_set<StringData> _properties;
 
+    // For each entry of '_properties', in order, the indexes of the patterns in
+    // '_patternProperties' that match its name. Fields named in '_properties' are dispatched
+    // through this table instead of being matched against every pattern.
+    std::vector<std::vector<size_t>> _patternsMatchingProperty;
+
     // The placeholder used in both '_patternProperties' and '_otherwise'.
     StringData _namePlaceholder;
 
@@ -84,6 +84,36 @@ TEST(InternalSchemaAllowedPropertiesMatchExpression,
     ASSERT_FALSE(expr.getValue()->matchesBSON(fromjson("{a: 4}")));
 }
 
+TEST(InternalSchemaAllowedPropertiesMatchExpression,
+     ListedPropertiesAreCheckedAgainstEveryMatchingPattern) {
+    auto filter = fromjson(R"(
+        {$_internalSchemaAllowedProperties: {
+            properties: ['phoneNum', 'name', 'zip'],
+            namePlaceholder: 'i',
+            patternProperties: [
+                {regex: /Num$/, expression: {i: {$type: 'number'}}},
+                {regex: /^pho/, expression: {i: {$gt: 100}}},
+                {regex: /ame/, expression: {i: {$type: 'string'}}}
+            ],
+            otherwise: {i: {$type: 'bool'}}
+        }})");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = MatchExpressionParser::parse(filter, expCtx);
+    ASSERT_OK(expr.getStatus());
+    auto clone = expr.getValue()->shallowClone();
+
+    for (auto&& matcher : {expr.getValue().get(), clone.get()}) {
+        ASSERT_TRUE(matcher->matchesBSON(fromjson("{phoneNum: 1234, name: 'x', zip: [1]}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{phoneNum: 12}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{phoneNum: '1234'}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{name: 1}")));
+        ASSERT_TRUE(matcher->matchesBSON(fromjson("{houseNum: 4, nickname: 'y', other: true}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{houseNum: 'x'}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{phone: 50}")));
+        ASSERT_FALSE(matcher->matchesBSON(fromjson("{other: 1}")));
+    }
+}
+
 TEST(InternalSchemaAllowedPropertiesMatchExpression, OtherwiseEnforcedWhenAppropriate) {
     auto filter = fromjson(R"(
         {$_internalSchemaAllowedProperties: {
@@ -64,6 +64,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/slow_op_recorder.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -88,6 +89,7 @@ void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
         long long executionTimeMicros =
             durationCount<Microseconds>(curOp->elapsedTimeExcludingPauses());
         curOp->debug().executionTimeMicros = executionTimeMicros;
+        curOp->debug().cpuNanos = curOp->cpuNanos();
 
         recordCurOpMetrics(opCtx);
         Top::get(opCtx->getServiceContext())
@@ -118,6 +120,10 @@ void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
             log() << curOp->debug().report(opCtx->getClient(), *curOp, lockerInfo.stats);
         }
 
+        if (shouldSample && SlowOpRecorder::shouldRecord(executionTimeMicros)) {
+            recordSlowOp(opCtx);
+        }
+
         if (curOp->shouldDBProfile(shouldSample)) {
             profile(opCtx, CurOp::get(opCtx)->getNetworkOp());
         }
@@ -599,7 +605,7 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
         collection->getCollection()->infoCache()->notifyOfQuery(opCtx, summary.indexesUsed);
     }
 
-    if (curOp.shouldDBProfile()) {
+    if (curOp.shouldCaptureExecStats()) {
         BSONObjBuilder execStatsBob;
         Explain::getWinningPlanStats(exec.get(), &execStatsBob);
         curOp.debug().execStats = execStatsBob.obj();
@@ -737,7 +743,7 @@ static SingleWriteResult performSingleDeleteOp(OperationContext* opCtx,
     }
     curOp.debug().setPlanSummaryMetrics(summary);
 
-    if (curOp.shouldDBProfile()) {
+    if (curOp.shouldCaptureExecStats()) {
         BSONObjBuilder execStatsBob;
         Explain::getWinningPlanStats(exec.get(), &execStatsBob);
         curOp.debug().execStats = execStatsBob.obj();
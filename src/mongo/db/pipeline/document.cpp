@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
@@ -186,6 +187,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    dassert(!isLazy());
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
@@ -222,6 +224,45 @@ DocumentStorage::~DocumentStorage() {
     }
 }
 
+namespace {
+// Converts 'elem', which lives inside 'owner', without converting any embedded objects yet.
+Value lazyValue(const BSONElement& elem, const BSONObj& owner) {
+    switch (elem.type()) {
+        case Object:
+            return Value(
+                Document::fromBsonLazy(BSONObj(elem.embeddedObject()).shareOwnershipWith(owner)));
+        case Array: {
+            vector<Value> values;
+            BSONForEach(sub, elem.embeddedObject()) {
+                values.push_back(lazyValue(sub, owner));
+            }
+            return Value(std::move(values));
+        }
+        default:
+            return Value(elem);
+    }
+}
+}  // namespace
+
+void DocumentStorage::loadLazyFields() const {
+    // This storage is only ever reachable as const through a Document, but it is heap allocated
+    // and converting the fields does not change what the document logically contains.
+    auto self = const_cast<DocumentStorage*>(this);
+    const BSONObj bson = std::move(self->_bson);
+    self->_bson = BSONObj();
+
+    self->reserveFields(bson.nFields());
+    BSONForEach(elem, bson) {
+        self->appendField(elem.fieldNameStringData()) = lazyValue(elem, bson);
+    }
+}
+
+Document Document::fromBsonLazy(BSONObj bson) {
+    if (bson.isEmpty())
+        return Document();
+    return Document(new DocumentStorage(bson.getOwned()));
+}
+
 Document::Document(const BSONObj& bson) {
     MutableDocument md(bson.nFields());
 
@@ -258,6 +299,12 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (_storage && _storage->isLazy()) {
+        // Nothing was accessed, so the fields are exactly those of the original BSON.
+        builder->appendElements(_storage->lazyBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
@@ -286,6 +333,21 @@ BSONObj Document::toBsonWithMetaData() const {
 }
 
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
+    // Only documents carrying metadata need to be taken apart right away.
+    bool hasMetaData = false;
+    BSONForEach(elem, bson) {
+        if (elem.fieldNameStringData()[0] == '$' &&
+            std::find(allMetadataFieldNames.begin(),
+                      allMetadataFieldNames.end(),
+                      elem.fieldNameStringData()) != allMetadataFieldNames.end()) {
+            hasMetaData = true;
+            break;
+        }
+    }
+    if (!hasMetaData) {
+        return fromBsonLazy(bson);
+    }
+
     MutableDocument md;
 
     BSONObjIterator it(bson);
@@ -381,6 +443,9 @@ size_t Document::getApproximateSize() const {
         return 0;  // we've allocated no memory
 
     size_t size = sizeof(DocumentStorage);
+    if (_storage->isLazy())
+        return size + _storage->lazyBson().objsize();
+
     size += storage().allocatedBytes();
 
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
@@ -394,8 +459,10 @@ size_t Document::getApproximateSize() const {
 void Document::hash_combine(size_t& seed,
                             const StringData::ComparatorInterface* stringComparator) const {
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        // Hash the field name a word at a time, the same way string values are hashed, rather
+        // than combining it into 'seed' one byte at a time.
         StringData name = it->nameSD();
-        boost::hash_range(seed, name.rawData(), name.rawData() + name.size());
+        MurmurHash3_x86_32(name.rawData(), name.size(), seed, &seed);
         it->val.hash_combine(seed, stringComparator);
     }
 }
@@ -217,6 +217,14 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like Document(BSONObj), but the fields are only converted once they are first accessed, and
+     * embedded objects only once they are themselves accessed. Serializing a document or
+     * sub-document that was never accessed copies its BSON verbatim. 'bson' is made owned if it
+     * is not already.
+     */
+    static Document fromBsonLazy(BSONObj bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -291,7 +299,11 @@ private:
     explicit Document(const DocumentStorage* ptr) : _storage(ptr){};
 
     const DocumentStorage& storage() const {
-        return (_storage ? *_storage : DocumentStorage::emptyDoc());
+        if (!_storage)
+            return DocumentStorage::emptyDoc();
+        if (MONGO_unlikely(_storage->isLazy()))
+            _storage->loadLazyFields();
+        return *_storage;
     }
     boost::intrusive_ptr<const DocumentStorage> _storage;
 };
@@ -564,6 +576,9 @@ private:
         if (MONGO_unlikely(!_storage))
             return newStorage();
 
+        if (MONGO_unlikely(storagePtr()->isLazy()))
+            storagePtr()->loadLazyFields();
+
         if (MONGO_unlikely(_storage->isShared()))
             return clonedStorage();
 
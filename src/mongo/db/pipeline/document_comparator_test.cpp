@@ -230,6 +230,15 @@ TEST(DocumentComparatorTest, DocumentHasherRespectsCollator) {
               documentCmp.hash(Document{{"foo", "FOOz"_sd}}));
 }
 
+TEST(DocumentComparatorTest, DocumentHasherDistinguishesFieldNames) {
+    DocumentComparator documentCmp;
+    ASSERT_EQ(documentCmp.hash(Document{{"a", 1}, {"bcdefgh", 2}}),
+              documentCmp.hash(Document{{"a", 1}, {"bcdefgh", 2}}));
+    ASSERT_NE(documentCmp.hash(Document{{"a", 1}, {"bcdefgh", 2}}),
+              documentCmp.hash(Document{{"a", 1}, {"bcdefgx", 2}}));
+    ASSERT_NE(documentCmp.hash(Document{{"ab", 1}}), documentCmp.hash(Document{{"ba", 1}}));
+}
+
 TEST(DocumentComparatorTest, DocumentHasherRespectsCollatorWithNestedObjects) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
     DocumentComparator documentCmp(&collator);
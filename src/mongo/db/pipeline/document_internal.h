@@ -191,6 +191,15 @@ public:
           _textScore(0),
           _randVal(0) {}
 
+    /**
+     * Constructs a storage whose fields are converted from 'bson', which must be owned, only when
+     * they are first needed. See loadLazyFields().
+     */
+    explicit DocumentStorage(BSONObj bson) : DocumentStorage() {
+        dassert(bson.isOwned());
+        _bson = std::move(bson);
+    }
+
     ~DocumentStorage();
 
     enum MetaType : char {
@@ -266,6 +275,27 @@ public:
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
+    /// True if the fields have not yet been converted from the BSON this was constructed from.
+    bool isLazy() const {
+        return !_bson.isEmpty();
+    }
+
+    /// The BSON this was constructed from. Only meaningful while isLazy().
+    const BSONObj& lazyBson() const {
+        return _bson;
+    }
+
+    /**
+     * Converts the top-level fields of the BSON this storage was constructed from. Embedded
+     * objects become lazy DocumentStorages themselves, sharing ownership of the same buffer, so
+     * that only the levels which are actually accessed are ever converted.
+     *
+     * Logically const: a lazy storage always represents the same fields, whether or not they have
+     * been converted yet. Like the rest of Document, this is not safe to call concurrently on a
+     * storage shared between threads.
+     */
+    void loadLazyFields() const;
+
     size_t allocatedBytes() const {
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
@@ -401,6 +431,10 @@ private:
     double _textScore;
     double _randVal;
     BSONObj _sortKey;
+
+    // Non-empty while the fields have not been converted yet. Never set on a storage with fields
+    // or metadata, so clone() does not need to copy it.
+    BSONObj _bson;
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
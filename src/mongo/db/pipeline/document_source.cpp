@@ -49,6 +49,30 @@ using std::vector;
 DocumentSource::DocumentSource(const intrusive_ptr<ExpressionContext>& pCtx)
     : pSource(NULL), pExpCtx(pCtx) {}
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    invariant(batch->empty());
+
+    if (_pendingBatchStatus) {
+        const auto status = *_pendingBatchStatus;
+        _pendingBatchStatus = boost::none;
+        return status;
+    }
+
+    while (batch->size() < maxBatchSize) {
+        auto next = getNext();
+        if (!next.isAdvanced()) {
+            if (batch->empty()) {
+                return next.getStatus();
+            }
+            _pendingBatchStatus = next.getStatus();
+            break;
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 namespace {
 // Used to keep track of which DocumentSources are registered under which name.
 static StringMap<Parser> parserMap;
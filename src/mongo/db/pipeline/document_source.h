@@ -400,6 +400,19 @@ public:
      */
     virtual GetNextResult getNext() = 0;
 
+    /**
+     * Appends up to 'maxBatchSize' results to 'batch', which must be empty. Stages which consume
+     * many documents at a time use this to avoid paying for a virtual call and a GetNextResult per
+     * document at every stage boundary. Returns kAdvanced if any results were appended; otherwise
+     * returns the kEOF or kPauseExecution that ended the batch. A pause encountered after results
+     * were appended is returned by the following call instead.
+     *
+     * The default implementation calls getNext(). A caller must not mix calls to getNextBatch()
+     * and getNext() on the same stage.
+     */
+    virtual GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                                     size_t maxBatchSize);
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -655,6 +668,10 @@ protected:
     boost::intrusive_ptr<ExpressionContext> pExpCtx;
 
 private:
+    // The status which ended the last batch returned by the default getNextBatch(), if it has not
+    // been returned yet.
+    boost::optional<GetNextResult::ReturnStatus> _pendingBatchStatus;
+
     /**
      * Create a Value that represents the document source.
      *
@@ -31,7 +31,9 @@
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
 
 #include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -91,7 +93,8 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     if (!_sorter) {
         SortOptions opts;
         opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
-        if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+        opts.sortThreads = std::max(1, internalQueryExecSortThreads.load());
+        if (pExpCtx->canSpillToDisk()) {
             opts.extSortAllowed = true;
             opts.tempDir = pExpCtx->tempDir;
         }
@@ -102,17 +105,54 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
         };
 
         _sorter.reset(Sorter<Value, Document>::make(opts, comparator));
+        computeAccumulatedFieldDependencies();
     }
 
     auto next = pSource->getNext();
     for (; next.isAdvanced(); next = pSource->getNext()) {
         auto nextDoc = next.releaseDocument();
-        _sorter->add(extractKey(nextDoc), nextDoc);
+        auto key = extractKey(nextDoc);
+        _sorter->add(std::move(key), trimToAccumulatedFields(std::move(nextDoc)));
         _nDocuments++;
     }
     return next;
 }
 
+void DocumentSourceBucketAuto::computeAccumulatedFieldDependencies() {
+    DepsTracker deps(DepsTracker::MetadataAvailable::kTextScore);
+    for (auto&& accumulatedField : _accumulatedFields) {
+        accumulatedField.expression->addDependencies(&deps);
+    }
+
+    // The documents built by trimToAccumulatedFields() carry no metadata.
+    _accumulatorsNeedWholeDocument =
+        deps.needWholeDocument || deps.getNeedTextScore() || deps.getNeedSortKey();
+    _accumulatorTopLevelFields.clear();
+    for (auto&& path : deps.fields) {
+        auto topLevelField = path.substr(0, path.find('.'));
+        if (std::find(_accumulatorTopLevelFields.begin(),
+                      _accumulatorTopLevelFields.end(),
+                      topLevelField) == _accumulatorTopLevelFields.end()) {
+            _accumulatorTopLevelFields.push_back(std::move(topLevelField));
+        }
+    }
+}
+
+Document DocumentSourceBucketAuto::trimToAccumulatedFields(Document&& doc) const {
+    if (_accumulatorsNeedWholeDocument) {
+        return std::move(doc);
+    }
+
+    MutableDocument trimmed(_accumulatorTopLevelFields.size());
+    for (auto&& fieldName : _accumulatorTopLevelFields) {
+        auto value = doc[fieldName];
+        if (!value.missing()) {
+            trimmed.addField(fieldName, std::move(value));
+        }
+    }
+    return trimmed.freeze();
+}
+
 Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     if (!_groupByExpression) {
         return Value(BSONNULL);
@@ -482,7 +522,12 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             groupByExpression && numBuckets);
 
     return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+        pExpCtx,
+        groupByExpression,
+        numBuckets.get(),
+        accumulationStatements,
+        granularityRounder,
+        static_cast<uint64_t>(internalDocumentSourceBucketAutoMaxMemoryBytes.load()));
 }
 }  // namespace mongo
 
@@ -118,6 +118,18 @@ private:
      */
     GetNextResult populateSorter();
 
+    /**
+     * Determines which top-level fields of the input documents are read by the accumulators, so
+     * that only those fields need to be held in the sorter and written to disk when it spills.
+     */
+    void computeAccumulatedFieldDependencies();
+
+    /**
+     * Returns a document with only the top-level fields of 'doc' which are read by the
+     * accumulators, or 'doc' itself if they need the whole document or its metadata.
+     */
+    Document trimToAccumulatedFields(Document&& doc) const;
+
     /**
      * Computes the 'groupBy' expression value for 'doc'.
      */
@@ -148,6 +160,8 @@ private:
     std::unique_ptr<Sorter<Value, Document>::Iterator> _sortedInput;
 
     std::vector<AccumulationStatement> _accumulatedFields;
+    bool _accumulatorsNeedWholeDocument = true;
+    std::vector<std::string> _accumulatorTopLevelFields;
 
     int _nBuckets;
     uint64_t _maxMemoryUsageBytes;
@@ -55,6 +55,20 @@ using std::vector;
 using std::string;
 using boost::intrusive_ptr;
 
+/**
+ * Returns the accumulators {count: {$sum: 1}, largeStr: {$last: "$largeStr"}}. The tests of memory
+ * usage accumulate 'largeStr' so that $bucketAuto has to buffer it.
+ */
+vector<AccumulationStatement> countAndLastLargeStr(const intrusive_ptr<ExpressionContext>& expCtx) {
+    return {AccumulationStatement("count",
+                                  ExpressionConstant::create(expCtx, Value(1)),
+                                  AccumulationStatement::getFactory("$sum")),
+            AccumulationStatement(
+                "largeStr",
+                ExpressionFieldPath::parse(expCtx, "$largeStr", expCtx->variablesParseState),
+                AccumulationStatement::getFactory("$last"))};
+}
+
 class BucketAutoTests : public AggregationContextFixture {
 public:
     intrusive_ptr<DocumentSource> createBucketAuto(BSONObj bucketAutoSpec) {
@@ -357,8 +371,12 @@ TEST_F(BucketAutoTests, ShouldBeAbleToCorrectlySpillToDisk) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(expCtx,
+                                                            groupByExpression,
+                                                            numBuckets,
+                                                            countAndLastLargeStr(expCtx),
+                                                            nullptr,
+                                                            maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes, 'x');
     auto mock = DocumentSourceMock::create({Document{{"a", 0}, {"largeStr", largeStr}},
@@ -370,12 +388,16 @@ TEST_F(BucketAutoTests, ShouldBeAbleToCorrectlySpillToDisk) {
     auto next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
     ASSERT_DOCUMENT_EQ(next.releaseDocument(),
-                       (Document{{"_id", Document{{"min", 0}, {"max", 2}}}, {"count", 2}}));
+                       (Document{{"_id", Document{{"min", 0}, {"max", 2}}},
+                                 {"count", 2},
+                                 {"largeStr", largeStr}}));
 
     next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
     ASSERT_DOCUMENT_EQ(next.releaseDocument(),
-                       (Document{{"_id", Document{{"min", 2}, {"max", 3}}}, {"count", 2}}));
+                       (Document{{"_id", Document{{"min", 2}, {"max", 3}}},
+                                 {"count", 2},
+                                 {"largeStr", largeStr}}));
 
     ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
 }
@@ -393,8 +415,12 @@ TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(expCtx,
+                                                            groupByExpression,
+                                                            numBuckets,
+                                                            countAndLastLargeStr(expCtx),
+                                                            nullptr,
+                                                            maxMemoryUsageBytes);
     auto sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), -1, maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes, 'x');
@@ -412,6 +438,44 @@ TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_TRUE(bucketAutoStage->getNext().isPaused());
 
     // Now we expect to get the results back.
+    auto next = bucketAutoStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", Document{{"min", 0}, {"max", 2}}},
+                                 {"count", 2},
+                                 {"largeStr", largeStr}}));
+
+    next = bucketAutoStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", Document{{"min", 2}, {"max", 3}}},
+                                 {"count", 2},
+                                 {"largeStr", largeStr}}));
+
+    ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
+}
+
+TEST_F(BucketAutoTests, ShouldOnlyBufferFieldsReadByAccumulators) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+
+    const int numBuckets = 2;
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+
+    // Neither the default 'count' accumulator nor the 'groupBy' key read 'largeStr', so these
+    // documents fit in memory even though they are larger than the limit in total.
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto mock = DocumentSourceMock::create({Document{{"a", 0}, {"largeStr", largeStr}},
+                                            Document{{"a", 1}, {"largeStr", largeStr}},
+                                            Document{{"a", 2}, {"largeStr", largeStr}},
+                                            Document{{"a", 3}, {"largeStr", largeStr}}});
+    bucketAutoStage->setSource(mock.get());
+
     auto next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
     ASSERT_DOCUMENT_EQ(next.releaseDocument(),
@@ -633,8 +697,12 @@ void assertCannotSpillToDisk(const boost::intrusive_ptr<ExpressionContext>& expC
     auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(expCtx,
+                                                            groupByExpression,
+                                                            numBuckets,
+                                                            countAndLastLargeStr(expCtx),
+                                                            nullptr,
+                                                            maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes, 'x');
     auto mock = DocumentSourceMock::create(
@@ -669,8 +737,12 @@ TEST_F(BucketAutoTests, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(expCtx,
+                                                            groupByExpression,
+                                                            numBuckets,
+                                                            countAndLastLargeStr(expCtx),
+                                                            nullptr,
+                                                            maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes / 2, 'x');
     auto mock = DocumentSourceMock::create({Document{{"a", 0}, {"largeStr", largeStr}},
@@ -207,6 +207,11 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) final {
+        MONGO_UNREACHABLE;
+    }
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final;
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
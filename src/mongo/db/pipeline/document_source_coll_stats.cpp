@@ -84,6 +84,12 @@ intrusive_ptr<DocumentSource> DocumentSourceCollStats::createFromBson(
                                   << " of type "
                                   << typeName(elem.type()),
                     elem.type() == BSONType::Object);
+        } else if ("cacheStats" == fieldName) {
+            uassert(40691,
+                    str::stream() << "cacheStats argument must be an object, but got " << elem
+                                  << " of type "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
         } else {
             uasserted(40168, str::stream() << "unrecognized option to $collStats: " << fieldName);
         }
@@ -148,6 +154,18 @@ DocumentSource::GetNextResult DocumentSourceCollStats::getNext() {
         }
     }
 
+    if (_collStatsSpec.hasField("cacheStats")) {
+        BSONObjBuilder cacheBuilder(builder.subobjStart("cacheStats"));
+        Status status = pExpCtx->mongoProcessInterface->appendCacheStats(
+            pExpCtx->opCtx, pExpCtx->ns, &cacheBuilder);
+        cacheBuilder.doneFast();
+        if (!status.isOK()) {
+            uasserted(40692,
+                      str::stream() << "Unable to retrieve cacheStats in $collStats stage: "
+                                    << status.reason());
+        }
+    }
+
     return {Document(builder.obj())};
 }
 
@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_geo_lookup.h"
+
+#include <algorithm>
+
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2cellid.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+namespace dps = ::mongo::dotted_path_support;
+
+std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGeoLookUp::liteParse(
+    const AggregationRequest& request, const BSONElement& spec) {
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << "the $geoLookup stage specification must be an object, but found "
+                          << typeName(spec.type()),
+            spec.type() == BSONType::Object);
+
+    auto fromElement = spec.Obj()["from"];
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << "'from' option to $geoLookup must be a string, but was type "
+                          << typeName(fromElement.type()),
+            fromElement.type() == BSONType::String);
+
+    NamespaceString nss(request.getNamespaceString().db(), fromElement.valueStringData());
+    uassert(ErrorCodes::InvalidNamespace,
+            str::stream() << "invalid $geoLookup namespace: " << nss.ns(),
+            nss.isValid());
+
+    PrivilegeVector privileges{
+        Privilege(ResourcePattern::forExactNamespace(nss), ActionType::find)};
+
+    return stdx::make_unique<LiteParsedDocumentSourceForeignCollections>(std::move(nss),
+                                                                         std::move(privileges));
+}
+
+REGISTER_DOCUMENT_SOURCE(geoLookup,
+                         DocumentSourceGeoLookUp::liteParse,
+                         DocumentSourceGeoLookUp::createFromBson);
+
+const char* DocumentSourceGeoLookUp::getSourceName() const {
+    return "$geoLookup";
+}
+
+DocumentSourceGeoLookUp::DocumentSourceGeoLookUp(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                 NamespaceString from,
+                                                 std::string localField,
+                                                 std::string foreignField,
+                                                 std::string as)
+    : DocumentSource(expCtx),
+      _from(std::move(from)),
+      _localField(std::move(localField)),
+      _foreignField(std::move(foreignField)),
+      _as(std::move(as)) {
+    const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
+    _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
+    _fromPipeline = resolvedNamespace.pipeline;
+}
+
+intrusive_ptr<DocumentSourceGeoLookUp> DocumentSourceGeoLookUp::create(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    NamespaceString fromNs,
+    std::string localField,
+    std::string foreignField,
+    std::string as) {
+    return new DocumentSourceGeoLookUp(
+        expCtx, std::move(fromNs), std::move(localField), std::move(foreignField), std::move(as));
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceGeoLookUp::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
+    NamespaceString from;
+    std::string localField;
+    std::string foreignField;
+    std::string as;
+
+    for (auto&& argument : elem.Obj()) {
+        const auto argName = argument.fieldNameStringData();
+
+        uassert(40694,
+                str::stream() << "expected string as argument for " << argName << ", found: "
+                              << argument.toString(false, false),
+                argument.type() == String);
+
+        if (argName == "from") {
+            from = NamespaceString(expCtx->ns.db().toString() + '.' + argument.String());
+        } else if (argName == "localField") {
+            localField = argument.String();
+        } else if (argName == "foreignField") {
+            foreignField = argument.String();
+        } else if (argName == "as") {
+            as = argument.String();
+        } else {
+            uasserted(40695,
+                      str::stream() << "Unknown argument to $geoLookup: " << argument.fieldName());
+        }
+    }
+
+    uassert(40696,
+            "$geoLookup requires 'from', 'localField', 'foreignField', and 'as' to be specified.",
+            !from.ns().empty() && !localField.empty() && !foreignField.empty() && !as.empty());
+
+    return create(
+        expCtx, std::move(from), std::move(localField), std::move(foreignField), std::move(as));
+}
+
+DocumentSource::GetNextResult DocumentSourceGeoLookUp::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    auto input = pSource->getNext();
+    if (!input.isAdvanced()) {
+        return input;
+    }
+
+    if (!_indexBuilt) {
+        buildIndex();
+    }
+
+    MutableDocument output(input.releaseDocument());
+    output.setNestedField(_as, Value(findContainingDocuments(output.peek())));
+    return output.freeze();
+}
+
+void DocumentSourceGeoLookUp::buildIndex() {
+    invariant(!_indexBuilt);
+
+    auto pipeline =
+        uassertStatusOK(pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
+
+    const long long maxMemoryBytes = internalDocumentSourceGeoLookupMaxMemoryBytes.load();
+    long long memoryBytes = 0;
+    _minLevel = S2CellId::kMaxLevel;
+    _maxLevel = 0;
+
+    while (auto result = pipeline->getNext()) {
+        IndexedGeometry indexed;
+        indexed.storage = result->toBson();
+
+        // Only polygons can contain a point, so documents without one can never be joined.
+        auto geometryElement = dps::extractElementAtPath(indexed.storage, _foreignField.fullPath());
+        if (!geometryElement.isABSONObj()) {
+            continue;
+        }
+        indexed.geometry = stdx::make_unique<GeometryContainer>();
+        if (!indexed.geometry->parseFromStorage(geometryElement).isOK() ||
+            indexed.geometry->getNativeCRS() != SPHERE || !indexed.geometry->supportsContains() ||
+            !indexed.geometry->hasS2Region()) {
+            continue;
+        }
+
+        const size_t position = _geometries.size();
+        auto covering = ExpressionMapping::get2dsphereCovering(indexed.geometry->getS2Region());
+        for (auto&& cell : covering) {
+            _minLevel = std::min(_minLevel, cell.level());
+            _maxLevel = std::max(_maxLevel, cell.level());
+            _cellIndex[cell.id()].push_back(position);
+        }
+
+        memoryBytes += 2 * indexed.storage.objsize() +
+            covering.size() * (sizeof(uint64_t) + sizeof(size_t));
+        uassert(40693,
+                str::stream() << "$geoLookup exceeded its memory limit of " << maxMemoryBytes
+                              << " bytes while indexing the polygons of "
+                              << _from.ns(),
+                memoryBytes <= maxMemoryBytes);
+
+        indexed.document = std::move(*result);
+        _geometries.push_back(std::move(indexed));
+    }
+
+    _indexBuilt = true;
+}
+
+std::vector<Value> DocumentSourceGeoLookUp::findContainingDocuments(const Document& input) const {
+    std::vector<Value> results;
+    if (_geometries.empty()) {
+        return results;
+    }
+
+    BSONObjBuilder pointBuilder;
+    input.getNestedField(_localField).addToBsonObj(&pointBuilder, "point");
+    auto pointObj = pointBuilder.obj();
+    auto pointElement = pointObj.firstElement();
+    if (!pointElement.isABSONObj()) {
+        return results;
+    }
+
+    // Parse and project the point the same way $geoWithin treats stored geometries.
+    GeometryContainer point;
+    if (!point.parseFromStorage(pointElement).isOK() || !point.isPoint() ||
+        !point.supportsProject(SPHERE)) {
+        return results;
+    }
+    point.projectInto(SPHERE);
+
+    // A polygon can only contain the point if one of its covering cells is an ancestor of the
+    // point's leaf cell. Coverings are normalized, so each polygon is found at most once.
+    auto leaf = S2CellId::FromPoint(point.getS2Region().GetCapBound().axis());
+    std::vector<size_t> candidates;
+    for (int level = _minLevel; level <= _maxLevel; ++level) {
+        auto cell = _cellIndex.find(leaf.parent(level).id());
+        if (cell != _cellIndex.end()) {
+            candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto position : candidates) {
+        const auto& indexed = _geometries[position];
+        if (indexed.geometry->contains(point)) {
+            results.push_back(Value(indexed.document));
+        }
+    }
+    return results;
+}
+
+Value DocumentSourceGeoLookUp::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec(DOC("from" << _from.coll() << "localField" << _localField.fullPath()
+                                    << "foreignField"
+                                    << _foreignField.fullPath()
+                                    << "as"
+                                    << _as.fullPath()));
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+void DocumentSourceGeoLookUp::doDispose() {
+    _geometries.clear();
+    _cellIndex.clear();
+}
+
+void DocumentSourceGeoLookUp::detachFromOperationContext() {
+    _fromExpCtx->opCtx = nullptr;
+}
+
+void DocumentSourceGeoLookUp::reattachToOperationContext(OperationContext* opCtx) {
+    _fromExpCtx->opCtx = opCtx;
+}
+
+}  // namespace mongo
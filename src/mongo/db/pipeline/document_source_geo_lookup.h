@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/geo/geometry_container.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * Joins each input document with the documents of the 'from' collection whose 'foreignField'
+ * GeoJSON polygon contains the input document's 'localField' point, following the semantics of
+ * $geoWithin. The matching documents are placed in the 'as' array, in the order they were read
+ * from the 'from' collection.
+ *
+ * Rather than querying the 'from' collection once per input document, the stage reads it once,
+ * indexes the S2 cell covering of each polygon in memory, and probes that index with the leaf
+ * cell of each input point. Only the polygons whose covering contains the point's cell are checked
+ * for exact containment.
+ */
+class DocumentSourceGeoLookUp final : public DocumentSource {
+public:
+    static std::unique_ptr<LiteParsedDocumentSourceForeignCollections> liteParse(
+        const AggregationRequest& request, const BSONElement& spec);
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    static boost::intrusive_ptr<DocumentSourceGeoLookUp> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        NamespaceString fromNs,
+        std::string localField,
+        std::string foreignField,
+        std::string as);
+
+    GetNextResult getNext() final;
+    const char* getSourceName() const final;
+
+    GetModPathsReturn getModifiedPaths() const final {
+        return {GetModPathsReturn::Type::kFiniteSet, std::set<std::string>{_as.fullPath()}, {}};
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kNone,
+                                     HostTypeRequirement::kPrimaryShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kAllowed);
+
+        constraints.canSwapWithMatch = true;
+        return constraints;
+    }
+
+    GetDepsReturn getDependencies(DepsTracker* deps) const final {
+        deps->fields.insert(_localField.fullPath());
+        return SEE_NEXT;
+    }
+
+    void addInvolvedCollections(std::vector<NamespaceString>* collections) const final {
+        collections->push_back(_from);
+    }
+
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+protected:
+    void doDispose() final;
+
+private:
+    /**
+     * A polygon read from the 'from' collection, along with the document it came from.
+     */
+    struct IndexedGeometry {
+        Document document;
+        BSONObj storage;
+        std::unique_ptr<GeometryContainer> geometry;
+    };
+
+    DocumentSourceGeoLookUp(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                            NamespaceString from,
+                            std::string localField,
+                            std::string foreignField,
+                            std::string as);
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Reads the 'from' collection and indexes the covering of every polygon in it. Throws if the
+     * indexed polygons exceed internalDocumentSourceGeoLookupMaxMemoryBytes.
+     */
+    void buildIndex();
+
+    /**
+     * Returns the documents whose polygon contains the point at '_localField' in 'input', or an
+     * empty array if 'input' has no point there.
+     */
+    std::vector<Value> findContainingDocuments(const Document& input) const;
+
+    NamespaceString _from;
+    FieldPath _localField;
+    FieldPath _foreignField;
+    FieldPath _as;
+
+    // The ExpressionContext and pipeline used to read the '_from' namespace.
+    boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
+    std::vector<BSONObj> _fromPipeline;
+
+    bool _indexBuilt = false;
+
+    // The levels of the cells in the coverings, recorded when the index is built.
+    int _minLevel = 0;
+    int _maxLevel = 0;
+
+    std::vector<IndexedGeometry> _geometries;
+
+    // Maps the id of each covering cell to the positions in '_geometries' of the polygons whose
+    // covering includes it.
+    stdx::unordered_map<uint64_t, std::vector<size_t>> _cellIndex;
+};
+
+}  // namespace mongo
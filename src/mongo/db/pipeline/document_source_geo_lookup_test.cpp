@@ -0,0 +1,230 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_geo_lookup.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+/**
+ * A MongoProcessInterface used for testing that makes pipelines reading 'results'.
+ */
+class MockMongoInterface final : public StubMongoProcessInterface {
+public:
+    MockMongoInterface(std::deque<DocumentSource::GetNextResult> results)
+        : _results(std::move(results)) {}
+
+    StatusWith<std::unique_ptr<Pipeline, PipelineDeleter>> makePipeline(
+        const std::vector<BSONObj>& rawPipeline,
+        const intrusive_ptr<ExpressionContext>& expCtx,
+        const MakePipelineOptions opts) final {
+        auto pipeline = Pipeline::parse(rawPipeline, expCtx);
+        if (!pipeline.isOK()) {
+            return pipeline.getStatus();
+        }
+
+        pipeline.getValue()->addInitialSource(DocumentSourceMock::create(_results));
+        return pipeline;
+    }
+
+private:
+    std::deque<DocumentSource::GetNextResult> _results;
+};
+
+class DocumentSourceGeoLookUpTest : public AggregationContextFixture {
+protected:
+    intrusive_ptr<DocumentSourceGeoLookUp> makeStage(
+        std::deque<DocumentSource::GetNextResult> fromContents) {
+        auto expCtx = getExpCtx();
+        expCtx->setResolvedNamespace(_fromNs, {_fromNs, std::vector<BSONObj>{}});
+        expCtx->mongoProcessInterface =
+            std::make_shared<MockMongoInterface>(std::move(fromContents));
+        return DocumentSourceGeoLookUp::create(expCtx, _fromNs, "loc", "area", "fences");
+    }
+
+    /**
+     * Returns the '_id' values of the documents in the 'fences' array of 'result'.
+     */
+    Value getFenceIds(const DocumentSource::GetNextResult& result) {
+        ASSERT_TRUE(result.isAdvanced());
+        std::vector<Value> ids;
+        for (auto&& fence : result.getDocument()["fences"].getArray()) {
+            ids.push_back(fence.getDocument()["_id"]);
+        }
+        return Value(std::move(ids));
+    }
+
+    Document makeSquare(StringData id, double min, double max) {
+        return Document{{"_id", id},
+                        {"area",
+                         Document{{"type", "Polygon"_sd},
+                                  {"coordinates",
+                                   std::vector<Value>{Value(std::vector<Value>{
+                                       Value(std::vector<Value>{Value(min), Value(min)}),
+                                       Value(std::vector<Value>{Value(max), Value(min)}),
+                                       Value(std::vector<Value>{Value(max), Value(max)}),
+                                       Value(std::vector<Value>{Value(min), Value(max)}),
+                                       Value(std::vector<Value>{Value(min), Value(min)})})}}}}};
+    }
+
+    Document makePoint(int id, double x, double y) {
+        return Document{{"_id", id},
+                        {"loc",
+                         Document{{"type", "Point"_sd},
+                                  {"coordinates", std::vector<Value>{Value(x), Value(y)}}}}};
+    }
+
+    const NamespaceString _fromNs{"unittests", "fences"};
+};
+
+TEST_F(DocumentSourceGeoLookUpTest, JoinsPointsWithTheirContainingPolygons) {
+    // Lines cannot contain points, so they are not indexed.
+    Document line{{"_id", "line"_sd},
+                  {"area",
+                   Document{{"type", "LineString"_sd},
+                            {"coordinates",
+                             std::vector<Value>{Value(std::vector<Value>{Value(0), Value(0)}),
+                                                Value(std::vector<Value>{Value(9), Value(9)})}}}}};
+    auto stage = makeStage({makeSquare("a", 0, 10),
+                            makeSquare("b", 5, 15),
+                            std::move(line),
+                            Document{{"_id", "none"_sd}}});
+    auto source = DocumentSourceMock::create({makePoint(0, 7, 7),
+                                              makePoint(1, 1, 1),
+                                              makePoint(2, 20, 20),
+                                              Document{{"_id", 3}},
+                                              Document{{"_id", 4}, {"loc", "bad"_sd}}});
+    stage->setSource(source.get());
+
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()),
+                    Value(std::vector<Value>{Value("a"_sd), Value("b"_sd)}));
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()), Value(std::vector<Value>{Value("a"_sd)}));
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()), Value(std::vector<Value>{}));
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()), Value(std::vector<Value>{}));
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()), Value(std::vector<Value>{}));
+    ASSERT_TRUE(stage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGeoLookUpTest, ProjectsLegacyCoordinatePairsOntoTheSphere) {
+    auto stage = makeStage({makeSquare("a", 0, 10), makeSquare("b", 5, 15)});
+    auto source = DocumentSourceMock::create(
+        {Document{{"_id", 0}, {"loc", std::vector<Value>{Value(12), Value(12)}}}});
+    stage->setSource(source.get());
+
+    ASSERT_VALUE_EQ(getFenceIds(stage->getNext()), Value(std::vector<Value>{Value("b"_sd)}));
+    ASSERT_TRUE(stage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGeoLookUpTest, ShouldFailWhenPolygonsExceedMemoryLimit) {
+    const auto maxMemoryBytes = internalDocumentSourceGeoLookupMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGeoLookupMaxMemoryBytes.store(maxMemoryBytes); });
+    internalDocumentSourceGeoLookupMaxMemoryBytes.store(100);
+
+    auto stage = makeStage({makeSquare("a", 0, 10), makeSquare("b", 5, 15)});
+    auto source = DocumentSourceMock::create({makePoint(0, 7, 7)});
+    stage->setSource(source.get());
+
+    ASSERT_THROWS_CODE(stage->getNext(), AssertionException, 40693);
+}
+
+TEST_F(DocumentSourceGeoLookUpTest, ShouldRoundTripThroughSerialization) {
+    auto expCtx = getExpCtx();
+    expCtx->setResolvedNamespace(_fromNs, {_fromNs, std::vector<BSONObj>{}});
+    auto spec = BSON("$geoLookup" << BSON("from"
+                                          << "fences"
+                                          << "localField"
+                                          << "loc"
+                                          << "foreignField"
+                                          << "area"
+                                          << "as"
+                                          << "fences"));
+    auto stage = DocumentSourceGeoLookUp::createFromBson(spec.firstElement(), expCtx);
+
+    std::vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(serialized.size(), 1UL);
+    ASSERT_VALUE_EQ(serialized[0], Value(spec));
+}
+
+TEST_F(DocumentSourceGeoLookUpTest, ShouldRejectInvalidSpecifications) {
+    auto expCtx = getExpCtx();
+    expCtx->setResolvedNamespace(_fromNs, {_fromNs, std::vector<BSONObj>{}});
+
+    auto parse = [&](BSONObj spec) {
+        return DocumentSourceGeoLookUp::createFromBson(BSON("$geoLookup" << spec).firstElement(),
+                                                       expCtx);
+    };
+
+    ASSERT_THROWS_CODE(parse(BSON("from"
+                                  << "fences"
+                                  << "localField"
+                                  << 1
+                                  << "foreignField"
+                                  << "area"
+                                  << "as"
+                                  << "fences")),
+                       AssertionException,
+                       40694);
+    ASSERT_THROWS_CODE(parse(BSON("from"
+                                  << "fences"
+                                  << "localField"
+                                  << "loc"
+                                  << "foreignField"
+                                  << "area"
+                                  << "as"
+                                  << "fences"
+                                  << "unknown"
+                                  << "x")),
+                       AssertionException,
+                       40695);
+    ASSERT_THROWS_CODE(parse(BSON("from"
+                                  << "fences"
+                                  << "localField"
+                                  << "loc"
+                                  << "as"
+                                  << "fences")),
+                       AssertionException,
+                       40696);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -104,11 +105,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisited()));
     }
 
     MutableDocument output(*_input);
@@ -127,7 +126,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -143,7 +142,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,13 +156,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -174,6 +171,8 @@ void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _spilledIds.clear();
+    _spilledVisited.clear();
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -184,7 +183,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
+        auto matchStages = makeMatchStagesFromFrontier(&cached);
 
         ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
         _frontier.swap(queried);
@@ -199,12 +198,11 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (matchStage) {
-            // Query for all keys that were in the frontier and not in the cache, populating
-            // '_frontier' for the next iteration of search.
-
+        // Query for all keys that were in the frontier and not in the cache, populating
+        // '_frontier' for the next iteration of search.
+        for (auto&& matchStage : matchStages) {
             // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
+            _fromPipeline.back() = std::move(matchStage);
             auto pipeline = uassertStatusOK(
                 pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
             while (auto next = pipeline->getNext()) {
@@ -228,12 +226,15 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
     _frontier.clear();
     _frontierUsageBytes = 0;
+
+    // The spilled '_id' values were only needed to de-duplicate the search.
+    _spilledIds.clear();
 }
 
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -280,7 +281,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
+std::vector<BSONObj> DocumentSourceGraphLookUp::makeMatchStagesFromFrontier(
     DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
@@ -298,6 +299,28 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
+    // Split the remaining values so that no single $in grows too large to build or to plan.
+    const size_t maxQueryBytes =
+        std::max(1, internalDocumentSourceGraphLookupMaxFrontierQueryBytes.load());
+    std::vector<BSONObj> matchStages;
+    std::vector<Value> values;
+    size_t valuesBytes = 0;
+    for (auto&& value : _frontier) {
+        values.push_back(value);
+        valuesBytes += value.getApproximateSize();
+        if (valuesBytes >= maxQueryBytes) {
+            matchStages.push_back(makeMatchStage(values));
+            values.clear();
+            valuesBytes = 0;
+        }
+    }
+    if (!values.empty()) {
+        matchStages.push_back(makeMatchStage(values));
+    }
+    return matchStages;
+}
+
+BSONObj DocumentSourceGraphLookUp::makeMatchStage(const std::vector<Value>& values) const {
     // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
     //
     // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
@@ -317,7 +340,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        for (auto&& value : values) {
                             in << value;
                         }
                     }
@@ -326,7 +349,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return match.obj();
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -388,13 +411,55 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes &&
+        pExpCtx->canSpillToDisk()) {
+        spillVisited();
+    }
     uassert(40099,
-            "$graphLookup reached maximum memory consumption",
+            "$graphLookup reached maximum memory consumption. Pass allowDiskUse:true to spill the"
+            " discovered documents to disk.",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    if (_visited.empty()) {
+        return;
+    }
+
+    // The documents are read back in no particular order, so there is no need to sort them.
+    SortedFileWriter<Value, Document> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& idAndDoc : _visited) {
+        writer.addAlreadySorted(idAndDoc.first, idAndDoc.second);
+        _spilledIds.insert(idAndDoc.first);
+    }
+    _spilledVisited.emplace_back(writer.done());
+    _visited.clear();
+
+    _visitedUsageBytes = 0;
+    for (auto&& id : _spilledIds) {
+        _visitedUsageBytes += id.getApproximateSize();
+    }
+}
+
+bool DocumentSourceGraphLookUp::hasVisited() {
+    while (!_spilledVisited.empty() && !_spilledVisited.back()->more()) {
+        _spilledVisited.pop_back();
+    }
+    return !_spilledVisited.empty() || !_visited.empty();
+}
+
+Document DocumentSourceGraphLookUp::popVisited() {
+    invariant(hasVisited());
+    if (!_spilledVisited.empty()) {
+        return _spilledVisited.back()->next().second;
+    }
+    auto it = _visited.begin();
+    auto result = std::move(it->second);
+    _visited.erase(it);
+    return result;
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -464,8 +529,10 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
@@ -607,3 +674,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
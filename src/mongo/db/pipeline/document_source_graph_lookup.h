@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -57,7 +58,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed);
 
         constraints.canSwapWithMatch = true;
@@ -120,15 +121,20 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * Prepares the queries to execute on the 'from' collection wrapped in $match stages by using
+     * the contents of '_frontier'. A large frontier is split across several queries, each of which
+     * holds at most 'internalDocumentSourceGraphLookupMaxFrontierQueryBytes' of values.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns no queries if none are necessary, i.e., all values were retrieved from the cache.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    std::vector<BSONObj> makeMatchStagesFromFrontier(DocumentUnorderedSet* cached);
+
+    /**
+     * Returns a $match stage querying for the documents connected to any of 'values'.
+     */
+    BSONObj makeMatchStage(const std::vector<Value>& values) const;
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -155,11 +161,30 @@ private:
     void addToCache(const Document& result, const ValueUnorderedSet& queried);
 
     /**
-     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, spilling
+     * the documents in '_visited' to disk first if disk use is allowed, and then evict from
+     * '_cache' until this source is using less than '_maxMemoryUsageBytes'.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a file, keeping only their '_id' values in memory to
+     * de-duplicate the rest of the search.
+     */
+    void spillVisited();
+
+    /**
+     * Returns whether any of the documents found by the last search, in memory or spilled, have
+     * yet to be returned.
+     */
+    bool hasVisited();
+
+    /**
+     * Removes and returns one of the documents found by the last search. Must only be called if
+     * hasVisited() is true.
+     */
+    Document popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -185,7 +210,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -199,6 +224,11 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // The '_id' values and the files of the discovered documents which were spilled to disk during
+    // the current search. The '_id' values count towards '_visitedUsageBytes'.
+    ValueUnorderedSet _spilledIds;
+    std::vector<std::shared_ptr<Sorter<Value, Document>::Iterator>> _spilledVisited;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
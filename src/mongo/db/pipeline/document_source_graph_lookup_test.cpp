@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -65,6 +68,7 @@ public:
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -87,6 +91,8 @@ public:
         return Status::OK();
     }
 
+    int numPipelinesMade = 0;
+
 private:
     std::deque<DocumentSource::GetNextResult> _results;
 };
@@ -615,5 +621,139 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSplitLargeFrontierAcrossSeveralQueries) {
+    const auto maxQueryBytes = internalDocumentSourceGraphLookupMaxFrontierQueryBytes.load();
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxFrontierQueryBytes.store(maxQueryBytes); });
+    // Query for one frontier value at a time.
+    internalDocumentSourceGraphLookupMaxFrontierQueryBytes.store(1);
+
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"_id", 0}, {"startVal", std::vector<Value>{Value(1), Value(2), Value(3)}}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    Document doc1{{"_id", 1}};
+    Document doc2{{"_id", 2}};
+    Document doc3{{"_id", 3}};
+    std::deque<DocumentSource::GetNextResult> fromContents{
+        Document(doc1), Document(doc2), Document(doc3)};
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(3U, resultsArray.size());
+    ASSERT(arrayContains(expCtx, resultsArray, Value(doc1)));
+    ASSERT(arrayContains(expCtx, resultsArray, Value(doc2)));
+    ASSERT(arrayContains(expCtx, resultsArray, Value(doc3)));
+    ASSERT(graphLookupStage->getNext().isEOF());
+
+    // Each of the three starting values was queried for separately.
+    ASSERT_EQ(3, mongoProcessInterface->numPipelinesMade);
+}
+
+/**
+ * Returns the documents of a chain 0 -> 1 -> ... -> 'length' - 1 of documents padded to be large.
+ */
+std::deque<DocumentSource::GetNextResult> makeLargeChain(int length) {
+    std::deque<DocumentSource::GetNextResult> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(Document{{"_id", i}, {"to", i + 1}, {"pad", std::string(200, 'x')}});
+    }
+    return chain;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsToDiskIfAllowed) {
+    const auto maxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(maxMemoryBytes); });
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(2000);
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeLargeChain(20));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    // The whole chain is found, although it does not fit in memory.
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(20U, resultsArray.size());
+    for (int i = 0; i < 20; ++i) {
+        ASSERT(arrayContains(
+            expCtx,
+            resultsArray,
+            Value(Document{{"_id", i}, {"to", i + 1}, {"pad", std::string(200, 'x')}})));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorIfOverMemoryLimitAndNotAllowedToSpill) {
+    const auto maxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(maxMemoryBytes); });
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(2000);
+
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeLargeChain(20));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
 }  // namespace
 }  // namespace mongo
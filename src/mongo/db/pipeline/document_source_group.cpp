@@ -38,7 +38,9 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -118,6 +120,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     if (_groups->empty())
         return GetNextResult::makeEOF();
 
+    if (_streamingAbandoned) {
+        // The groups must be returned in the order we reported while streaming.
+        const auto& group = *_sortedGroups[_sortedGroupsIndex];
+        Document out = makeDocument(group.first, group.second, pExpCtx->needsMerge);
+
+        if (++_sortedGroupsIndex == _sortedGroups.size())
+            dispose();
+
+        return std::move(out);
+    }
+
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
     if (++groupsIterator == _groups->end())
@@ -128,51 +141,149 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     // Streaming optimization is active.
-    if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+    while (_streamingOutput.empty()) {
+        if (_streamingInputExhausted) {
+            dispose();
+            return GetNextResult::makeEOF();
         }
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-    }
 
-    Value id;
-    do {
-        // Add to the current accumulator(s).
-        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
-            _currentAccumulators[i]->process(
-                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+            // A single run has grown too large to hold in memory. Only an unsorted $group can
+            // spill to disk.
+            abandonStreaming();
+            return getNext();
         }
 
-        // Retrieve the next document.
         auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
+        if (nextInput.isPaused()) {
             return nextInput;
         }
 
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-
+        if (nextInput.isEOF()) {
+            _streamingInputExhausted = true;
+            flushRun();
+            continue;
+        }
 
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId(*_firstDocOfNextGroup);
-    } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
+        auto rootDocument = nextInput.releaseDocument();
+        auto runKey = computeRunKey(rootDocument);
+        if (!runKey) {
+            accumulate(rootDocument);
+            abandonStreaming();
+            return getNext();
+        }
 
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
-    _currentId = std::move(id);
+        if (_currentRunKey) {
+            const auto& valueComparator = pExpCtx->getValueComparator();
+            for (size_t i = 0; i < runKey->size(); i++) {
+                if (valueComparator.evaluate((*runKey)[i] != (*_currentRunKey)[i])) {
+                    flushRun();
+                    break;
+                }
+            }
+        }
+        _currentRunKey = std::move(runKey);
+        accumulate(rootDocument);
+    }
 
+    Document out = std::move(_streamingOutput.front());
+    _streamingOutput.pop_front();
     return std::move(out);
 }
 
+boost::optional<std::vector<Value>> DocumentSourceGroup::computeRunKey(const Document& root) const {
+    std::vector<Value> runKey;
+    runKey.reserve(_runKeyExpressions.size());
+    for (auto&& expression : _runKeyExpressions) {
+        Value value = expression->evaluate(root);
+        if (value.isArray()) {
+            return boost::none;
+        }
+        // The input sort does not distinguish null, undefined and missing, so neither can we.
+        runKey.push_back(value.nullish() ? Value(BSONNULL) : std::move(value));
+    }
+    return runKey;
+}
+
+void DocumentSourceGroup::flushRun() {
+    for (auto&& group : *_groups) {
+        _streamingOutput.push_back(makeDocument(group.first, group.second, pExpCtx->needsMerge));
+    }
+    _groups->clear();
+    _memoryUsageBytes = 0;
+    _memoryReservation.set(pExpCtx->opCtx, 0);
+}
+
+void DocumentSourceGroup::abandonStreaming() {
+    invariant(_streamingOutput.empty());
+
+    // Remember the order we reported before leaving streaming mode.
+    for (auto&& sortField : getStreamingOutputSortPattern()) {
+        _outputSortPattern.emplace_back(FieldPath(sortField.fieldName()),
+                                        sortField.numberInt() < 0 ? -1 : 1);
+    }
+
+    _streaming = false;
+    _streamingAbandoned = true;
+    _currentRunKey = boost::none;
+
+    // Re-enter initialize() from getNext(), which will exhaust 'pSource' into '_groups'.
+    _initialized = false;
+}
+
+DocumentSourceGroup::IdComparator DocumentSourceGroup::makeIdComparator() const {
+    const ValueComparator valueComparator = pExpCtx->getValueComparator();
+    if (!_streamingAbandoned) {
+        return [valueComparator](const Value& lhs, const Value& rhs) {
+            return valueComparator.compare(lhs, rhs);
+        };
+    }
+
+    return [this, valueComparator](const Value& lhs, const Value& rhs) {
+        const Document lhsDoc(DOC("_id" << expandId(lhs)));
+        const Document rhsDoc(DOC("_id" << expandId(rhs)));
+        for (auto&& sortField : _outputSortPattern) {
+            const int cmp = valueComparator.compare(lhsDoc.getNestedField(sortField.first),
+                                                    rhsDoc.getNestedField(sortField.first));
+            if (cmp != 0) {
+                return cmp * sortField.second;
+            }
+        }
+        // Break ties so that only equal _id values compare equal.
+        return valueComparator.compare(lhs, rhs);
+    };
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
+    _threadPool.reset();
+    _parallelBatches.clear();
+    _parallelInput.clear();
+    _sortedGroups.clear();
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _streamingOutput.clear();
+    _currentRunKey = boost::none;
+    _memoryUsageBytes = 0;
+    _memoryReservation.set(pExpCtx->opCtx, 0);
 
     // Make us look done.
     groupsIterator = _groups->end();
+}
 
-    _firstDocOfNextGroup = boost::none;
+boost::optional<std::string> DocumentSourceGroup::getDistinctFieldPath() const {
+    if (_doingMerge || !_accumulatedFields.empty() || !_idFieldNames.empty()) {
+        return boost::none;
+    }
+
+    invariant(_idExpressions.size() == 1);
+    auto fieldPath = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get());
+    if (!fieldPath || !fieldPath->isRootFieldPath() ||
+        fieldPath->getFieldPath().getPathLength() == 1) {
+        // Grouping on $$ROOT itself, or on a user variable.
+        return boost::none;
+    }
+    return fieldPath->getFieldPath().tail().fullPath();
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
@@ -266,7 +377,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
-      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
+      _allowDiskUse(pExpCtx->canSpillToDisk()) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
     _accumulatedFields.push_back(accumulationStatement);
@@ -363,26 +474,28 @@ class SorterComparator {
 public:
     typedef pair<Value, Value> Data;
 
-    SorterComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+    SorterComparator(DocumentSourceGroup::IdComparator idComparator)
+        : _idComparator(std::move(idComparator)) {}
 
     int operator()(const Data& lhs, const Data& rhs) const {
-        return _valueComparator.compare(lhs.first, rhs.first);
+        return _idComparator(lhs.first, rhs.first);
     }
 
 private:
-    ValueComparator _valueComparator;
+    DocumentSourceGroup::IdComparator _idComparator;
 };
 
 class SpillSTLComparator {
 public:
-    SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+    SpillSTLComparator(DocumentSourceGroup::IdComparator idComparator)
+        : _idComparator(std::move(idComparator)) {}
 
     bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
+        return _idComparator(lhs->first, rhs->first) < 0;
     }
 
 private:
-    ValueComparator _valueComparator;
+    DocumentSourceGroup::IdComparator _idComparator;
 };
 
 bool containsOnlyFieldPathsAndConstants(ExpressionObject* expressionObj) {
@@ -446,107 +559,252 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
         }
     }
 }
-}  // namespace
 
-DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
-    const size_t numAccumulators = _accumulatedFields.size();
+/**
+ * Returns true if the serialized expression 'serialized' contains an expression which binds
+ * variables.
+ */
+bool containsVariableBinding(const Value& serialized) {
+    if (serialized.isArray()) {
+        for (auto&& elem : serialized.getArray()) {
+            if (containsVariableBinding(elem)) {
+                return true;
+            }
+        }
+    } else if (serialized.getType() == BSONType::Object) {
+        FieldIterator fields(serialized.getDocument());
+        while (fields.more()) {
+            auto field = fields.next();
+            if (field.first == "$let" || field.first == "$map" || field.first == "$filter" ||
+                field.first == "$reduce" || containsVariableBinding(field.second)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+}  // namespace
 
-    boost::optional<BSONObj> inputSort = findRelevantInputSort();
-    if (inputSort) {
-        // We can convert to streaming.
-        _streaming = true;
-        _inputSort = *inputSort;
+bool DocumentSourceGroup::canGroupInParallel() const {
+    if (internalDocumentSourceGroupParallelism.load() <= 1) {
+        return false;
+    }
 
-        // Set up accumulators.
-        _currentAccumulators.reserve(numAccumulators);
-        for (auto&& accumulatedField : _accumulatedFields) {
-            _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+    for (auto&& idExpression : _idExpressions) {
+        if (containsVariableBinding(idExpression->serialize(false))) {
+            return false;
         }
-
-        // We only need to load the first document.
-        auto firstInput = pSource->getNext();
-        if (!firstInput.isAdvanced()) {
-            // Leave '_firstDocOfNextGroup' uninitialized and return.
-            return firstInput;
+    }
+    for (auto&& accumulatedField : _accumulatedFields) {
+        if (containsVariableBinding(accumulatedField.expression->serialize(false))) {
+            return false;
         }
-        _firstDocOfNextGroup = firstInput.releaseDocument();
+    }
+    return true;
+}
 
-        // Compute the _id value.
-        _currentId = computeId(*_firstDocOfNextGroup);
-        _initialized = true;
-        return DocumentSource::GetNextResult::makeEOF();
+void DocumentSourceGroup::scheduleParallelBatch() {
+    auto batch = std::make_shared<ParallelBatch>(pExpCtx->getValueComparator());
+    batch->input = std::move(_parallelInput);
+    _parallelInput.clear();
+    _parallelBatches.push_back(batch);
+
+    uassertStatusOK(_threadPool->schedule([this, batch] { groupParallelBatch(batch.get()); }));
+}
+
+void DocumentSourceGroup::groupParallelBatch(ParallelBatch* batch) {
+    Status status = Status::OK();
+    try {
+        const size_t numAccumulators = _accumulatedFields.size();
+        for (auto&& rootDocument : batch->input) {
+            const size_t oldSize = batch->partialGroups.size();
+            Accumulators& group = batch->partialGroups[computeId(rootDocument)];
+            if (batch->partialGroups.size() != oldSize) {
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            }
+
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
+                                  _doingMerge);
+            }
+        }
+    } catch (...) {
+        status = exceptionToStatus();
     }
 
+    // The input is no longer needed, so free it before the batch is merged.
+    batch->input.clear();
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
-        }
-
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
+    stdx::lock_guard<stdx::mutex> lk(_parallelMutex);
+    batch->status = std::move(status);
+    batch->done = true;
+    _parallelBatchDone.notify_all();
+}
 
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
+void DocumentSourceGroup::mergeParallelBatches(bool waitForAll) {
+    const size_t maxScheduledBatches =
+        waitForAll ? 0 : static_cast<size_t>(internalDocumentSourceGroupParallelism.load());
 
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+    while (!_parallelBatches.empty()) {
+        auto batch = _parallelBatches.front();
+        {
+            stdx::unique_lock<stdx::mutex> lk(_parallelMutex);
+            if (!batch->done && _parallelBatches.size() <= maxScheduledBatches) {
+                return;
             }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+            _parallelBatchDone.wait(lk, [&] { return batch->done; });
+        }
+
+        _parallelBatches.pop_front();
+        uassertStatusOK(batch->status);
+        mergePartialGroups(batch.get());
+    }
+}
+
+void DocumentSourceGroup::mergePartialGroups(ParallelBatch* batch) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (auto&& partialGroup : batch->partialGroups) {
+        spillIfOverMemoryLimit();
+
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[partialGroup.first];
+        if (_groups->size() != oldSize) {
+            // The first batch to see this _id contributes its accumulators directly.
+            _memoryUsageBytes += partialGroup.first.getApproximateSize();
+            group = std::move(partialGroup.second);
+            for (auto&& accum : group) {
+                _memoryUsageBytes += accum->memUsageForSorter();
             }
+            continue;
         }
 
-        /* tickle all the accumulators for the group we found */
         dassert(numAccumulators == group.size());
-
         for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
+            _memoryUsageBytes -= group[i]->memUsageForSorter();
+            group[i]->process(partialGroup.second[i]->getValue(/*toBeMerged=*/true), true);
             _memoryUsageBytes += group[i]->memUsageForSorter();
         }
+    }
+    batch->partialGroups.clear();
+}
+
+void DocumentSourceGroup::spillIfOverMemoryLimit() {
+    _memoryReservation.set(pExpCtx->opCtx, _memoryUsageBytes);
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+    } else if (BlockingMemoryTracker::get()->shouldRelease(_memoryUsageBytes)) {
+        uassert(ErrorCodes::ExceededMemoryLimit,
+                str::stream() << "$group used " << _memoryUsageBytes
+                              << " bytes of RAM while blocking stages on this node exceeded their"
+                                 " limit of "
+                              << internalQueryGlobalBlockingMemoryLimitBytes.load()
+                              << " bytes. Pass allowDiskUse:true to opt in to external sort.",
+                _allowDiskUse);
+    } else {
+        return;
+    }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+    _sortedFiles.push_back(spill());
+    _memoryUsageBytes = 0;
+    _memoryReservation.set(pExpCtx->opCtx, 0);
+}
 
-                _sortedFiles.push_back(spill());
+DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    boost::optional<BSONObj> inputSort =
+        _streamingAbandoned ? boost::optional<BSONObj>() : findRelevantInputSort();
+    if (inputSort) {
+        // We can convert to streaming. The input is consumed as the groups are requested.
+        _streaming = true;
+        _inputSort = *inputSort;
+
+        _runKeyExpressions.clear();
+        for (auto&& sortField : _inputSort) {
+            _runKeyExpressions.push_back(ExpressionFieldPath::parse(
+                pExpCtx, "$" + sortField.fieldNameStringData().toString(),
+                pExpCtx->variablesParseState));
+        }
+
+        _initialized = true;
+        return DocumentSource::GetNextResult::makeEOF();
+    }
+
+    if (!_threadPool && canGroupInParallel()) {
+        ThreadPool::Options options;
+        options.poolName = "GroupParallel";
+        options.minThreads = 0;
+        options.maxThreads = static_cast<size_t>(internalDocumentSourceGroupParallelism.load());
+        _threadPool = stdx::make_unique<ThreadPool>(options);
+        _threadPool->startup();
+    }
+    const size_t parallelBatchSize =
+        static_cast<size_t>(std::max(1, internalDocumentSourceGroupParallelBatchSize.load()));
+
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. The input is
+    // requested in batches rather than one document at a time.
+    const size_t inputBatchSize =
+        static_cast<size_t>(std::max(1, internalDocumentSourceBatchSize.load()));
+    std::vector<Document> batch;
+    GetNextResult::ReturnStatus status;
+    while ((status = pSource->getNextBatch(&batch, inputBatchSize)) ==
+           GetNextResult::ReturnStatus::kAdvanced) {
+        for (auto&& input : batch) {
+            if (_threadPool) {
+                // The documents are grouped on the worker threads and merged into '_groups' as the
+                // batches finish.
+                _parallelInput.push_back(std::move(input));
+                if (_parallelInput.size() >= parallelBatchSize) {
+                    scheduleParallelBatch();
+                    mergeParallelBatches(false);
+                }
+                continue;
+            }
+
+            spillIfOverMemoryLimit();
+
+            // We release the result document here so that it does not outlive the end of this loop
+            // iteration. Not releasing could lead to an array copy when this group follows an
+            // unwind.
+            auto rootDocument = std::move(input);
+            const bool inserted = accumulate(rootDocument);
+
+            if (kDebugBuild && !storageGlobalParams.readOnly) {
+                // In debug mode, spill every time we have a duplicate id to stress merge logic.
+                if (!inserted &&                 // is a dup
+                    !pExpCtx->inMongos &&        // can't spill to disk in mongos
+                    !_allowDiskUse &&            // don't change behavior when testing external sort
+                    _sortedFiles.size() < 20) {  // don't open too many FDs
+
+                    _sortedFiles.push_back(spill());
+                }
             }
         }
+        batch.clear();
     }
 
-    switch (input.getStatus()) {
+    switch (status) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+            return GetNextResult::makePauseExecution();  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
+            if (_threadPool) {
+                if (!_parallelInput.empty()) {
+                    scheduleParallelBatch();
+                }
+                mergeParallelBatches(true);
+                _threadPool.reset();
+            }
+
             // Do any final steps necessary to prepare to output results.
             if (!_sortedFiles.empty()) {
                 _spilled = true;
@@ -556,9 +814,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 // We won't be using groups again so free its memory.
                 _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _memoryUsageBytes = 0;
+                _memoryReservation.set(pExpCtx->opCtx, 0);
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+                    _sortedFiles, SortOptions(), SorterComparator(makeIdComparator())));
 
                 // prepare current to accumulate data
                 _currentAccumulators.reserve(numAccumulators);
@@ -568,6 +828,14 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 verify(_sorterIterator->more());  // we put data in, we should get something out.
                 _firstPartOfNextGroup = _sorterIterator->next();
+            } else if (_streamingAbandoned) {
+                for (auto&& group : *_groups) {
+                    _sortedGroups.push_back(&group);
+                }
+                std::sort(_sortedGroups.begin(),
+                          _sortedGroups.end(),
+                          SpillSTLComparator(makeIdComparator()));
+                _sortedGroupsIndex = 0;
             } else {
                 // start the group iterator
                 groupsIterator = _groups->begin();
@@ -576,12 +844,50 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
-            return input;
+            return GetNextResult::makeEOF();
         }
     }
     MONGO_UNREACHABLE;
 }
 
+bool DocumentSourceGroup::accumulate(const Document& rootDocument) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    Value id = computeId(rootDocument);
+
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and looking it
+    // up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
+    const bool inserted = _groups->size() != oldSize;
+
+    if (inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
+        }
+    }
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument), _doingMerge);
+
+        _memoryUsageBytes += group[i]->memUsageForSorter();
+    }
+
+    return inserted;
+}
+
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(_groups->size());
@@ -589,7 +895,7 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
         ptrs.push_back(&*it);
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(makeIdComparator()));
 
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
     switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
@@ -623,12 +929,6 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 }
 
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
-    if (true) {
-        // Until streaming $group correctly handles nullish values, the streaming behavior is
-        // disabled. See SERVER-23318.
-        return boost::none;
-    }
-
     if (!pSource) {
         // Sometimes when performing an explain, or using $group as the merge point, 'pSource' will
         // not be set.
@@ -688,6 +988,55 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     return boost::none;
 }
 
+BSONObj DocumentSourceGroup::getStreamingOutputSortPattern() {
+    BSONObjBuilder sortOrder;
+
+    if (_idFieldNames.empty()) {
+        // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is, get
+        // the sort order out of it.
+        if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
+            FieldPath _idSort = obj->getFieldPath();
+
+            sortOrder.append(
+                "_id", _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
+        }
+        return sortOrder.obj();
+    }
+
+    // When streaming, _id must have only contained ExpressionObjects, ExpressionConstants or
+    // ExpressionFieldPaths. We now process each '_idExpression'.
+
+    // We populate 'fieldMap' such that each key is a field the input is sorted by, and the value is
+    // where that input field is located within the _id document. For example, if our _id object is
+    // {_id: {x: {y: "$a.b"}}}, 'fieldMap' would be: {'a.b': '_id.x.y'}.
+    StringMap<std::string> fieldMap;
+    for (size_t i = 0; i < _idFieldNames.size(); i++) {
+        intrusive_ptr<Expression> exp = _idExpressions[i];
+        if (auto obj = dynamic_cast<ExpressionObject*>(exp.get())) {
+            // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
+            getFieldPathMap(obj, "_id." + _idFieldNames[i], &fieldMap);
+        } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(exp.get())) {
+            FieldPath _idSort = fieldPath->getFieldPath();
+            fieldMap[_idSort.getFieldName(_idSort.getPathLength() - 1)] = "_id." + _idFieldNames[i];
+        }
+    }
+
+    // Because the order of '_inputSort' is important, we go through each field we are sorted on
+    // and append it to the BSONObjBuilder in order.
+    for (BSONElement sortField : _inputSort) {
+        std::string sortString = sortField.fieldNameStringData().toString();
+
+        auto itr = fieldMap.find(sortString);
+
+        // If our sort order is (a, b, c), we could not have converted to a streaming $group if our
+        // _id was predicated on (a, c) but not 'b'. Verify that this is true.
+        invariant(itr != fieldMap.end());
+
+        sortOrder.append(itr->second, _inputSort.getIntField(sortString));
+    }
+    return sortOrder.obj();
+}
+
 BSONObjSet DocumentSourceGroup::getOutputSorts() {
     if (!_initialized) {
         initialize();  // Note this might not finish initializing, but that's OK. We just want to
@@ -695,60 +1044,19 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
                        // False negatives are OK.
     }
 
-    if (!(_streaming || _spilled)) {
+    if (_streaming || _streamingAbandoned) {
+        // Once reported, the streaming order is kept even if streaming is later abandoned.
+        return allPrefixes(getStreamingOutputSortPattern());
+    }
+
+    if (!_spilled) {
         return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     }
 
     BSONObjBuilder sortOrder;
 
     if (_idFieldNames.empty()) {
-        if (_spilled) {
-            sortOrder.append("_id", 1);
-        } else {
-            // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
-            // get the sort order out of it.
-            if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
-                FieldPath _idSort = obj->getFieldPath();
-
-                sortOrder.append(
-                    "_id",
-                    _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
-            }
-        }
-    } else if (_streaming) {
-        // At this point, we know that _streaming is true, so _id must have only contained
-        // ExpressionObjects, ExpressionConstants or ExpressionFieldPaths. We now process each
-        // '_idExpression'.
-
-        // We populate 'fieldMap' such that each key is a field the input is sorted by, and the
-        // value is where that input field is located within the _id document. For example, if our
-        // _id object is {_id: {x: {y: "$a.b"}}}, 'fieldMap' would be: {'a.b': '_id.x.y'}.
-        StringMap<std::string> fieldMap;
-        for (size_t i = 0; i < _idFieldNames.size(); i++) {
-            intrusive_ptr<Expression> exp = _idExpressions[i];
-            if (auto obj = dynamic_cast<ExpressionObject*>(exp.get())) {
-                // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
-                getFieldPathMap(obj, "_id." + _idFieldNames[i], &fieldMap);
-            } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(exp.get())) {
-                FieldPath _idSort = fieldPath->getFieldPath();
-                fieldMap[_idSort.getFieldName(_idSort.getPathLength() - 1)] =
-                    "_id." + _idFieldNames[i];
-            }
-        }
-
-        // Because the order of '_inputSort' is important, we go through each field we are sorted on
-        // and append it to the BSONObjBuilder in order.
-        for (BSONElement sortField : _inputSort) {
-            std::string sortString = sortField.fieldNameStringData().toString();
-
-            auto itr = fieldMap.find(sortString);
-
-            // If our sort order is (a, b, c), we could not have converted to a streaming $group if
-            // our _id was predicated on (a, c) but not 'b'. Verify that this is true.
-            invariant(itr != fieldMap.end());
-
-            sortOrder.append(itr->second, _inputSort.getIntField(sortString));
-        }
+        sortOrder.append("_id", 1);
     } else {
         // We are blocking and have spilled to disk.
         std::vector<std::string> outputSort;
@@ -786,7 +1094,7 @@ Value DocumentSourceGroup::computeId(const Document& root) {
     return Value(std::move(vals));
 }
 
-Value DocumentSourceGroup::expandId(const Value& val) {
+Value DocumentSourceGroup::expandId(const Value& val) const {
     // _id doesn't get wrapped in a document
     if (_idFieldNames.empty())
         return val;
@@ -28,13 +28,19 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <utility>
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/query/blocking_memory_tracker.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 
@@ -42,6 +48,7 @@ class DocumentSourceGroup final : public DocumentSource, public SplittableDocume
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
     using GroupsMap = ValueUnorderedMap<Accumulators>;
+    using IdComparator = stdx::function<int(const Value&, const Value&)>;
 
     static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
@@ -98,6 +105,13 @@ public:
         return _streaming;
     }
 
+    /**
+     * If this $group has no accumulators and groups on a single field path of its input, such as
+     * {$group: {_id: "$a"}}, returns that path. Such a $group outputs the distinct values of the
+     * path, so one input document per value is enough. Otherwise returns boost::none.
+     */
+    boost::optional<std::string> getDistinctFieldPath() const;
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -113,6 +127,11 @@ private:
      * getNext() dispatches to one of these three depending on what type of $group it is. All three
      * of these methods expect '_currentAccumulators' to have been reset before being called, and
      * also expect initialize() to have been called already.
+     *
+     * A streaming $group consumes its input in runs: maximal sequences of documents whose values
+     * for the fields of '_inputSort' are equal, treating null, undefined and missing alike. The
+     * groups of a run are returned once the first document of the next run is seen, so only one
+     * run is ever held in memory.
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
@@ -126,9 +145,9 @@ private:
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
-     * initialize() requests the first document from the previous source, and uses it to prepare the
-     * accumulators. In an unsorted $group, initialize() exhausts the previous source before
-     * returning. The '_initialized' boolean indicates that initialize() has finished.
+     * initialize() only decides to stream and does not request any input. In an unsorted $group,
+     * initialize() exhausts the previous source before returning. The '_initialized' boolean
+     * indicates that initialize() has finished.
      *
      * This method may not be able to finish initialization in a single call if 'pSource' returns a
      * DocumentSource::GetNextResult::kPauseExecution, so it returns the last GetNextResult
@@ -136,6 +155,46 @@ private:
      */
     GetNextResult initialize();
 
+    /**
+     * Adds 'rootDocument' to its group in '_groups', creating the group if needed, and updates
+     * '_memoryUsageBytes'. Returns true if a new group was created.
+     */
+    bool accumulate(const Document& rootDocument);
+
+    /**
+     * Returns the values of the '_inputSort' fields of 'root' which identify its run, or
+     * boost::none if one of them is an array. Arrays are ordered by their smallest or largest
+     * element, so documents with array values need not be adjacent to the documents they group
+     * with.
+     */
+    boost::optional<std::vector<Value>> computeRunKey(const Document& root) const;
+
+    /**
+     * Moves every group of the current run from '_groups' to '_streamingOutput'.
+     */
+    void flushRun();
+
+    /**
+     * Gives up streaming when the input turns out not to be made of detectable runs, or when a
+     * single run exceeds the memory limit. The groups of the current run stay in '_groups' and the
+     * rest of the input is grouped as an unsorted $group would, but the final groups are still
+     * returned in the order reported by getOutputSorts().
+     */
+    void abandonStreaming();
+
+    /**
+     * Returns the sort pattern that the output of a streaming $group follows, without its
+     * prefixes.
+     */
+    BSONObj getStreamingOutputSortPattern();
+
+    /**
+     * Returns the order in which groups are spilled and returned from disk. This is the order of
+     * the _id values, unless streaming was abandoned, in which case it is the order reported by
+     * getOutputSorts().
+     */
+    IdComparator makeIdComparator() const;
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -143,6 +202,59 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Spills '_groups' to disk if it has grown past the memory limit, or if the blocking stages on
+     * this node hold more than their limit and this $group is among the largest of them. Throws
+     * if spilling is not allowed.
+     */
+    void spillIfOverMemoryLimit();
+
+    /**
+     * A batch of input documents grouped on '_threadPool'. Batches are merged into '_groups' in
+     * the order they were scheduled, so that order-sensitive accumulators such as $first and $push
+     * see the input in order.
+     */
+    struct ParallelBatch {
+        explicit ParallelBatch(const ValueComparator& comparator)
+            : partialGroups(comparator.makeUnorderedValueMap<Accumulators>()) {}
+
+        std::vector<Document> input;
+        GroupsMap partialGroups;
+
+        // Guarded by '_parallelMutex'.
+        Status status = Status::OK();
+        bool done = false;
+    };
+
+    /**
+     * Returns true if the number of worker threads allows grouping in parallel and the _id and
+     * accumulator expressions may safely be evaluated on several threads at once. Expressions
+     * which bind variables, such as $let and $map, write to the shared ExpressionContext.
+     */
+    bool canGroupInParallel() const;
+
+    /**
+     * Schedules the documents in '_parallelInput' to be grouped on '_threadPool'.
+     */
+    void scheduleParallelBatch();
+
+    /**
+     * Groups 'batch->input' into 'batch->partialGroups'. Runs on a '_threadPool' thread.
+     */
+    void groupParallelBatch(ParallelBatch* batch);
+
+    /**
+     * Merges scheduled batches into '_groups' in order for as long as they are done, then waits
+     * for batches to finish until no more than the number of worker threads remain scheduled. If
+     * 'waitForAll' is true, waits for and merges every scheduled batch.
+     */
+    void mergeParallelBatches(bool waitForAll);
+
+    /**
+     * Adds the partial groups of 'batch' to '_groups', spilling as needed.
+     */
+    void mergePartialGroups(ParallelBatch* batch);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -154,13 +266,17 @@ private:
      * Converts the internal representation of the group key to the _id shape specified by the
      * user.
      */
-    Value expandId(const Value& val);
+    Value expandId(const Value& val) const;
 
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
+
+    // Reports '_memoryUsageBytes' to the BlockingMemoryTracker whenever it is checked against the
+    // limits.
+    BlockingMemoryTracker::Reservation _memoryReservation;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
@@ -187,8 +303,33 @@ private:
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
-    // Only used when '_sorted' is true.
-    boost::optional<Document> _firstDocOfNextGroup;
+
+    // Only used when '_streaming' is true. Each expression evaluates one field of '_inputSort'.
+    // The groups of the run identified by '_currentRunKey' are held in '_groups', and the groups
+    // of finished runs wait in '_streamingOutput' to be returned.
+    std::vector<boost::intrusive_ptr<Expression>> _runKeyExpressions;
+    boost::optional<std::vector<Value>> _currentRunKey;
+    std::deque<Document> _streamingOutput;
+    bool _streamingInputExhausted = false;
+
+    // Only used once streaming has been abandoned. '_outputSortPattern' holds the fields of
+    // getStreamingOutputSortPattern(), which the final groups in '_sortedGroups' are ordered by
+    // when they did not need to be spilled.
+    bool _streamingAbandoned = false;
+    std::vector<std::pair<FieldPath, int>> _outputSortPattern;
+    std::vector<const GroupsMap::value_type*> _sortedGroups;
+    size_t _sortedGroupsIndex = 0;
+
+    // Only used when grouping in parallel. '_parallelBatches' holds the scheduled batches which
+    // have not been merged into '_groups' yet, in the order they were scheduled.
+    std::vector<Document> _parallelInput;
+    std::deque<std::shared_ptr<ParallelBatch>> _parallelBatches;
+    stdx::mutex _parallelMutex;
+    stdx::condition_variable _parallelBatchDone;
+
+    // Declared last so that destroying it waits for running batches before the state they use is
+    // destroyed.
+    std::unique_ptr<ThreadPool> _threadPool;
 };
 
 }  // namespace mongo
@@ -47,12 +47,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -189,6 +191,184 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndNodeIsOverMemoryLimit) {
+    const long long oldLimit = internalQueryGlobalBlockingMemoryLimitBytes.load();
+    internalQueryGlobalBlockingMemoryLimitBytes.store(1500);
+    ON_BLOCK_EXIT([&] { internalQueryGlobalBlockingMemoryLimitBytes.store(oldLimit); });
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+
+    // The $group stays well within its own limit, but holds more than the whole node may.
+    auto group = DocumentSourceGroup::create(expCtx, groupByExpression, {pushStatement}, 100000);
+
+    string largeStr(1000, 'x');
+    auto mock = DocumentSourceMock::create({Document{{"_id", 0}, {"largeStr", largeStr}},
+                                            Document{{"_id", 1}, {"largeStr", largeStr}},
+                                            Document{{"_id", 2}, {"largeStr", largeStr}}});
+    group->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(group->getNext(), AssertionException, ErrorCodes::ExceededMemoryLimit);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergeParallelBatchesInInputOrder) {
+    const int oldParallelism = internalDocumentSourceGroupParallelism.load();
+    const int oldBatchSize = internalDocumentSourceGroupParallelBatchSize.load();
+    ON_BLOCK_EXIT([oldParallelism, oldBatchSize] {
+        internalDocumentSourceGroupParallelism.store(oldParallelism);
+        internalDocumentSourceGroupParallelBatchSize.store(oldBatchSize);
+    });
+    internalDocumentSourceGroupParallelism.store(4);
+    internalDocumentSourceGroupParallelBatchSize.store(3);
+
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto valExpression = ExpressionFieldPath::parse(expCtx, "$val", vps);
+    AccumulationStatement sumStatement{
+        "sum", valExpression, AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement pushStatement{
+        "all", valExpression, AccumulationStatement::getFactory("$push")};
+    AccumulationStatement firstStatement{
+        "first", valExpression, AccumulationStatement::getFactory("$first")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             {sumStatement, pushStatement, firstStatement});
+
+    const int numDocs = 40;
+    const int numKeys = 3;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.push_back(Document{{"key", i % numKeys}, {"val", i}});
+        if (i == numDocs / 2) {
+            inputs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    std::map<int, Document> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        results[doc["_id"].getInt()] = doc;
+    }
+    ASSERT_EQ(static_cast<size_t>(numKeys), results.size());
+
+    for (int key = 0; key < numKeys; ++key) {
+        int sum = 0;
+        vector<Value> all;
+        for (int val = key; val < numDocs; val += numKeys) {
+            sum += val;
+            all.push_back(Value(val));
+        }
+        ASSERT_DOCUMENT_EQ(
+            results[key],
+            (Document{{"_id", key}, {"sum", sum}, {"all", all}, {"first", key}}));
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingShouldTreatNullAndMissingAsTheSameRun) {
+    auto expCtx = getExpCtx();
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: {x: '$a', y: '$b'}, count: {$sum: 1}}}").firstElement(), expCtx);
+
+    // An index on {a: 1, b: 1} orders null and missing together, so the two groups interleave.
+    auto mock = DocumentSourceMock::create(
+        {"{a: null, b: 1}", "{b: 1}", "{a: null, b: 1}", "{b: 1}", "{a: 1, b: 1}"});
+    mock->sorts = {BSON("a" << 1 << "b" << 1)};
+    group->setSource(mock.get());
+
+    std::vector<Document> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    ASSERT_TRUE(static_cast<DocumentSourceGroup*>(group.get())->isStreaming());
+
+    ASSERT_EQ(3U, results.size());
+    ASSERT_VALUE_EQ(Value(2), results[0]["count"]);
+    ASSERT_VALUE_EQ(Value(2), results[1]["count"]);
+    ASSERT_VALUE_NE(results[0]["_id"], results[1]["_id"]);
+    ASSERT_DOCUMENT_EQ(results[2], (Document{{"_id", Document{{"x", 1}, {"y", 1}}}, {"count", 1}}));
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingShouldBeAbleToPauseWithinARun) {
+    auto expCtx = getExpCtx();
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$a', count: {$sum: 1}}}").firstElement(), expCtx);
+    auto mock = DocumentSourceMock::create({Document{{"a", 0}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 0}},
+                                            Document{{"a", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 1}}});
+    mock->sorts = {BSON("a" << 1)};
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 0}, {"count", 2}}));
+
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 1}, {"count", 2}}));
+
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingShouldFallBackOnArraysAndKeepReportedSort) {
+    auto expCtx = getExpCtx();
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$a', count: {$sum: 1}}}").firstElement(), expCtx);
+    auto mock = DocumentSourceMock::create(
+        {"{a: 3}", "{a: [5, 1]}", "{a: 2}", "{a: 3}", "{a: 1}"});
+    mock->sorts = {BSON("a" << -1)};
+    group->setSource(mock.get());
+
+    ASSERT_EQUALS(1U, group->getOutputSorts().count(BSON("_id" << -1)));
+
+    std::vector<Document> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    ASSERT_FALSE(static_cast<DocumentSourceGroup*>(group.get())->isStreaming());
+    ASSERT_EQUALS(1U, group->getOutputSorts().count(BSON("_id" << -1)));
+
+    ASSERT_EQ(4U, results.size());
+    ASSERT_DOCUMENT_EQ(results[0],
+                       (Document{{"_id", vector<Value>{Value(5), Value(1)}}, {"count", 1}}));
+    ASSERT_DOCUMENT_EQ(results[1], (Document{{"_id", 3}, {"count", 2}}));
+    ASSERT_DOCUMENT_EQ(results[2], (Document{{"_id", 2}, {"count", 1}}));
+    ASSERT_DOCUMENT_EQ(results[3], (Document{{"_id", 1}, {"count", 1}}));
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReportDistinctFieldPathOnlyWithoutAccumulators) {
+    auto getDistinctFieldPath = [this](const char* spec) {
+        auto group = DocumentSourceGroup::createFromBson(fromjson(spec).firstElement(), getExpCtx());
+        return static_cast<DocumentSourceGroup*>(group.get())->getDistinctFieldPath();
+    };
+
+    ASSERT_EQ("a", *getDistinctFieldPath("{$group: {_id: '$a'}}"));
+    ASSERT_EQ("a.b", *getDistinctFieldPath("{$group: {_id: '$$ROOT.a.b'}}"));
+
+    ASSERT_FALSE(getDistinctFieldPath("{$group: {_id: '$a', count: {$sum: 1}}}"));
+    ASSERT_FALSE(getDistinctFieldPath("{$group: {_id: {x: '$a'}}}"));
+    ASSERT_FALSE(getDistinctFieldPath("{$group: {_id: '$$ROOT'}}"));
+    ASSERT_FALSE(getDistinctFieldPath("{$group: {_id: null}}"));
+    ASSERT_FALSE(getDistinctFieldPath("{$group: {_id: {$add: ['$a', 1]}}}"));
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -1157,8 +1337,6 @@ public:
         add<Dependencies>();
         add<StringConstantIdAndAccumulatorExpressions>();
         add<ArrayConstantAccumulatorExpression>();
-#if 0
-        // Disabled tests until SERVER-23318 is implemented.
         add<StreamingOptimization>();
         add<StreamingWithMultipleIdFields>();
         add<NoOptimizationIfMissingDoubleSort>();
@@ -1170,7 +1348,6 @@ public:
         add<StreamingWithRootSubfield>();
         add<StreamingWithConstantAndFieldPath>();
         add<StreamingWithFieldRepeated>();
-#endif
     }
 };
 
@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_index_stats.h"
 
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/server_options.h"
 #include "mongo/util/net/sock.h"
 
@@ -52,6 +53,13 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
     if (_indexStatsMap.empty()) {
         _indexStatsMap = pExpCtx->mongoProcessInterface->getIndexStats(pExpCtx->opCtx, pExpCtx->ns);
         _indexStatsIter = _indexStatsMap.begin();
+
+        BSONObjBuilder cacheStats;
+        if (pExpCtx->mongoProcessInterface
+                ->appendCacheStats(pExpCtx->opCtx, pExpCtx->ns, &cacheStats)
+                .isOK()) {
+            _indexCacheStats = cacheStats.obj().getObjectField("indexes").getOwned();
+        }
     }
 
     if (_indexStatsIter != _indexStatsMap.end()) {
@@ -62,6 +70,13 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+        if (stats.statistics) {
+            doc["statistics"] = Value(stats.statistics->toBSON());
+        }
+        BSONElement cacheStats = _indexCacheStats[_indexStatsIter->first];
+        if (cacheStats.type() == BSONType::Object) {
+            doc["cache"] = Value(cacheStats.Obj());
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
@@ -88,6 +88,9 @@ private:
 
     CollectionIndexUsageMap _indexStatsMap;
     CollectionIndexUsageMap::const_iterator _indexStatsIter;
+    // Per-index storage engine cache statistics, keyed by index name. Empty if the storage engine
+    // does not report them.
+    BSONObj _indexCacheStats;
     std::string _processName;
 };
 
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/stringutils.h"
 
 namespace mongo {
 
@@ -182,6 +183,10 @@ const char* DocumentSourceLookUp::getSourceName() const {
 
 namespace {
 
+// Internal field which is set on the $lookup specifications sent to the shards for a shard-local
+// join.
+constexpr StringData kShardLocalFieldName = "$_internalShardLocal"_sd;
+
 /**
  * Constructs a query of the following shape:
  *  {$or: [
@@ -201,8 +206,22 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Returns true if an equality match on 'value' finds the same documents as a lookup of 'value' in
+ * a hash table keyed by the values at the foreign field path.
+ */
+bool isHashJoinKey(const Value& value) {
+    return !value.nullish() && !value.isArray() && value.getType() != BSONType::RegEx;
+}
+
 }  // namespace
 
+void DocumentSourceLookUp::setRunShardLocal() {
+    invariant(!wasConstructedWithPipelineSyntax());
+    _runShardLocal = true;
+    _fromExpCtx->colocatedForeignCollection = true;
+}
+
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     pExpCtx->checkForInterrupt();
 
@@ -221,27 +240,40 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
+    maybeStartHashJoin(inputDoc);
 
     std::vector<Value> results;
     int objsize = 0;
 
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto addResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    std::vector<size_t> hashJoinMatches;
+    if (_hashJoinState == HashJoinState::kActive && lookUpInHashTable(inputDoc, &hashJoinMatches)) {
+        for (auto&& position : hashJoinMatches) {
+            addResult(_hashJoinDocs[position]);
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto pipeline = buildPipeline(inputDoc);
+
+        while (auto result = pipeline->getNext()) {
+            addResult(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -295,6 +327,137 @@ std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     return pipeline;
 }
 
+void DocumentSourceLookUp::maybeStartHashJoin(const Document& inputDoc) {
+    if (_hashJoinState != HashJoinState::kUndecided) {
+        return;
+    }
+
+    // Positional paths also match fields with numeric names in query semantics, which the hash
+    // table does not index.
+    bool foreignFieldIsPositional = false;
+    if (_foreignField) {
+        for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+            foreignFieldIsPositional = foreignFieldIsPositional ||
+                parseUnsignedBase10Integer(_foreignField->getFieldName(i));
+        }
+    }
+
+    if (wasConstructedWithPipelineSyntax() || foreignFieldIsPositional ||
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() <= 0) {
+        _hashJoinState = HashJoinState::kAbandoned;
+        return;
+    }
+
+    if (++_numLocalDocsJoined < internalDocumentSourceLookupHashJoinMinLocalDocs.load()) {
+        return;
+    }
+
+    if (!_foreignRecordCount) {
+        BSONObjBuilder countBuilder;
+        auto status = pExpCtx->mongoProcessInterface->appendRecordCount(
+            pExpCtx->opCtx, _resolvedNs, &countBuilder);
+        if (!status.isOK()) {
+            // The foreign collection does not exist, so querying it is cheap.
+            _hashJoinState = HashJoinState::kAbandoned;
+            return;
+        }
+        _foreignRecordCount = countBuilder.obj()["count"].safeNumberLong();
+    }
+
+    if (_numLocalDocsJoined * internalDocumentSourceLookupHashJoinForeignToLocalRatio.load() <
+        *_foreignRecordCount) {
+        return;
+    }
+
+    buildHashTable(inputDoc);
+}
+
+void DocumentSourceLookUp::buildHashTable(const Document& inputDoc) {
+    invariant(_hashJoinState == HashJoinState::kUndecided);
+
+    // The trailing $match of '_resolvedPipeline' is replaced for each input document. Use it to
+    // apply only the filter absorbed from a following $match while reading the foreign documents.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipeline(inputDoc);
+
+    _hashJoinTable =
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+
+    const long long maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    long long memoryBytes = 0;
+
+    while (auto result = pipeline->getNext()) {
+        const size_t position = _hashJoinDocs.size();
+        bool isIndexed = false;
+        document_path_support::visitAllValuesAtPath(
+            *result, *_foreignField, [&](const Value& key) {
+                if (!isHashJoinKey(key)) {
+                    return;
+                }
+                auto& positions = _hashJoinTable[key];
+                // An array may hold the same value more than once.
+                if (positions.empty() || positions.back() != position) {
+                    positions.push_back(position);
+                    memoryBytes += key.getApproximateSize() + sizeof(size_t);
+                }
+                isIndexed = true;
+            });
+
+        // A document without any indexed value can only join with null or missing local values,
+        // which are always looked up by querying the foreign collection.
+        if (!isIndexed) {
+            continue;
+        }
+
+        memoryBytes += result->getApproximateSize();
+        _hashJoinDocs.push_back(std::move(*result));
+
+        if (memoryBytes > maxMemoryBytes) {
+            _hashJoinDocs.clear();
+            _hashJoinTable.clear();
+            _hashJoinState = HashJoinState::kAbandoned;
+            return;
+        }
+    }
+
+    _hashJoinState = HashJoinState::kActive;
+}
+
+bool DocumentSourceLookUp::lookUpInHashTable(const Document& inputDoc,
+                                             std::vector<size_t>* matches) const {
+    invariant(_hashJoinState == HashJoinState::kActive);
+
+    bool canUseHashTable = true;
+    size_t numLocalValues = 0;
+    std::vector<size_t> positions;
+    document_path_support::visitAllValuesAtPath(
+        inputDoc, *_localField, [&](const Value& localValue) {
+            ++numLocalValues;
+            if (!canUseHashTable || !isHashJoinKey(localValue)) {
+                canUseHashTable = false;
+                return;
+            }
+            auto it = _hashJoinTable.find(localValue);
+            if (it != _hashJoinTable.end()) {
+                positions.insert(positions.end(), it->second.begin(), it->second.end());
+            }
+        });
+
+    // Missing local values are treated as null.
+    if (!canUseHashTable || numLocalValues == 0) {
+        return false;
+    }
+
+    // A foreign document matching several local values is only returned once.
+    if (numLocalValues > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    *matches = std::move(positions);
+    return true;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -433,6 +596,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashJoinDocs.clear();
+    _hashJoinTable.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -525,7 +690,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
+    while (!_nextValue) {
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
             return nextInput;
@@ -533,27 +698,36 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
+        maybeStartHashJoin(*_input);
 
-        if (_pipeline) {
-            _pipeline->dispose(pExpCtx->opCtx);
-        }
+        _hashJoinMatchIndex = 0;
+        _unwindingHashJoinMatches = _hashJoinState == HashJoinState::kActive &&
+            lookUpInHashTable(*_input, &_hashJoinMatches);
 
-        _pipeline = buildPipeline(*_input);
+        if (!_unwindingHashJoinMatches) {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            if (_pipeline) {
+                _pipeline->dispose(pExpCtx->opCtx);
+            }
+
+            _pipeline = buildPipeline(*_input);
+
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextUnwindMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -571,7 +745,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextUnwindMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -585,6 +759,17 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextUnwindMatch() {
+    if (!_unwindingHashJoinMatches) {
+        return _pipeline->getNext();
+    }
+
+    if (_hashJoinMatchIndex == _hashJoinMatches.size()) {
+        return boost::none;
+    }
+    return _hashJoinDocs[_hashJoinMatches[_hashJoinMatchIndex++]];
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
@@ -643,6 +828,10 @@ void DocumentSourceLookUp::serializeToArray(
     }
 
     MutableDocument output(doc);
+    if (_runShardLocal) {
+        output[getSourceName()][kShardLocalFieldName] = Value(true);
+    }
+
     if (explain) {
         if (_unwindSrc) {
             const boost::optional<FieldPath> indexPath = _unwindSrc->indexPath();
@@ -747,6 +936,7 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
     std::vector<BSONObj> pipeline;
     bool hasPipeline = false;
     bool hasLet = false;
+    bool runShardLocal = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -774,6 +964,16 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
             continue;
         }
 
+        if (argName == kShardLocalFieldName) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "$lookup argument '" << argument
+                                  << "' must be a boolean, is type "
+                                  << argument.type(),
+                    argument.type() == BSONType::Bool);
+            runShardLocal = argument.boolean();
+            continue;
+        }
+
         uassert(ErrorCodes::FailedToParse,
                 str::stream() << "$lookup argument '" << argument << "' must be a string, is type "
                               << argument.type(),
@@ -801,6 +1001,11 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
         uassert(ErrorCodes::FailedToParse,
                 "$lookup with 'pipeline' may not specify 'localField' or 'foreignField'",
                 localField.empty() && foreignField.empty());
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << "$lookup with 'pipeline' may not specify '"
+                              << kShardLocalFieldName
+                              << "'",
+                !runShardLocal);
 
         return new DocumentSourceLookUp(std::move(fromNs),
                                         std::move(as),
@@ -816,11 +1021,16 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
                 "$lookup with a 'let' argument must also specify 'pipeline'",
                 !hasLet);
 
-        return new DocumentSourceLookUp(std::move(fromNs),
-                                        std::move(as),
-                                        std::move(localField),
-                                        std::move(foreignField),
-                                        pExpCtx);
+        intrusive_ptr<DocumentSourceLookUp> lookupStage =
+            new DocumentSourceLookUp(std::move(fromNs),
+                                     std::move(as),
+                                     std::move(localField),
+                                     std::move(foreignField),
+                                     pExpCtx);
+        if (runShardLocal) {
+            lookupStage->setRunShardLocal();
+        }
+        return lookupStage;
     }
 }
 }
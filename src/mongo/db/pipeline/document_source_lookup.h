@@ -105,9 +105,12 @@ public:
                                 DiskUseRequirement::kWritesTmpData;
                         });
 
+        // A shard-local join reads the foreign documents owned by the shard it runs on, whereas
+        // the foreign collection of any other join is unsharded and lives on the primary shard.
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
-                                     HostTypeRequirement::kPrimaryShard,
+                                     _runShardLocal ? HostTypeRequirement::kAnyShard
+                                                    : HostTypeRequirement::kPrimaryShard,
                                      mayUseDisk ? DiskUseRequirement::kWritesTmpData
                                                 : DiskUseRequirement::kNoDiskUse,
                                      FacetRequirement::kAllowed);
@@ -123,10 +126,16 @@ public:
     }
 
     boost::intrusive_ptr<DocumentSource> getShardSource() final {
+        if (_runShardLocal) {
+            return this;
+        }
         return nullptr;
     }
 
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final {
+        if (_runShardLocal) {
+            return {};
+        }
         return {this};
     }
 
@@ -174,6 +183,36 @@ public:
         return !static_cast<bool>(_localField);
     }
 
+    const NamespaceString& getFromNs() const {
+        return _fromNs;
+    }
+
+    /**
+     * The local and foreign fields of a $lookup constructed with localField/foreignField syntax.
+     */
+    const FieldPath& getLocalField() const {
+        invariant(_localField);
+        return *_localField;
+    }
+
+    const FieldPath& getForeignField() const {
+        invariant(_foreignField);
+        return *_foreignField;
+    }
+
+    /**
+     * Marks this $lookup as a shard-local join. Only valid for a $lookup of localField/foreignField
+     * syntax. Mongos uses it when the local and the foreign collection are sharded on the joined
+     * field with an identical chunk distribution, in which case all the foreign documents matching
+     * a local document reside on the same shard. The stage then runs as part of the shards'
+     * pipeline, reading only the foreign documents owned by the shard it runs on.
+     */
+    void setRunShardLocal();
+
+    bool runsShardLocal() const {
+        return _runShardLocal;
+    }
+
     const Variables& getVariables_forTest() {
         return _variables;
     }
@@ -274,6 +313,35 @@ private:
      */
     std::string getUserPipelineDefinition();
 
+    /**
+     * Counts 'inputDoc' towards the decision of whether to execute this stage as a hash join, and
+     * builds the hash table once the foreign collection is small enough relative to the number of
+     * documents joined so far. Only localField/foreignField joins are eligible.
+     */
+    void maybeStartHashJoin(const Document& inputDoc);
+
+    /**
+     * Reads every document of the foreign pipeline that passes '_additionalFilter' into
+     * '_hashJoinDocs', indexed by its values of '_foreignField'. Abandons the hash join if the
+     * documents exceed internalDocumentSourceLookupHashJoinMaxMemoryBytes.
+     */
+    void buildHashTable(const Document& inputDoc);
+
+    /**
+     * Fills 'matches' with the positions in '_hashJoinDocs', in ascending order, of the foreign
+     * documents joining with 'inputDoc'. Returns false without modifying 'matches' if the values of
+     * '_localField' in 'inputDoc' cannot be looked up in the hash table, in which case the foreign
+     * collection must be queried instead. This is the case for null, missing, regular expression
+     * and array values, whose query semantics differ from Value equality.
+     */
+    bool lookUpInHashTable(const Document& inputDoc, std::vector<size_t>* matches) const;
+
+    /**
+     * Returns the next foreign document joining with '_input' for an absorbed $unwind, from either
+     * '_pipeline' or '_hashJoinMatches'.
+     */
+    boost::optional<Document> getNextUnwindMatch();
+
     /**
      * Reinitialize the cache with a new max size. May only be called if this DSLookup was created
      * with pipeline syntax, the cache has not been frozen or abandoned, and no data has been added
@@ -294,6 +362,9 @@ private:
     boost::optional<FieldPath> _localField;
     boost::optional<FieldPath> _foreignField;
 
+    // Whether this stage is executed on each shard against the shard's own foreign documents.
+    bool _runShardLocal = false;
+
     // Holds 'let' defined variables defined both in this stage and in parent pipelines. These are
     // copied to the '_fromExpCtx' ExpressionContext's 'variables' and 'variablesParseState' for use
     // in foreign pipeline execution.
@@ -331,6 +402,25 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    enum class HashJoinState { kUndecided, kActive, kAbandoned };
+
+    // Tracks whether the localField/foreignField join is executed by querying the foreign
+    // collection once per input document or by probing '_hashJoinTable'.
+    HashJoinState _hashJoinState = HashJoinState::kUndecided;
+    long long _numLocalDocsJoined = 0;
+    boost::optional<long long> _foreignRecordCount;
+
+    // The foreign documents of a hash join, and a map from each of their values of '_foreignField'
+    // to their positions in '_hashJoinDocs'.
+    std::vector<Document> _hashJoinDocs;
+    ValueUnorderedMap<std::vector<size_t>> _hashJoinTable =
+        ValueComparator::kInstance.makeUnorderedValueMap<std::vector<size_t>>();
+
+    // The hash join matches for '_input' when '_unwindSrc' is not null, in place of '_pipeline'.
+    bool _unwindingHashJoinMatches = false;
+    std::vector<size_t> _hashJoinMatches;
+    size_t _hashJoinMatchIndex = 0;
 };
 
 }  // namespace mongo
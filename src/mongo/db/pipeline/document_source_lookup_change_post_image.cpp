@@ -30,7 +30,11 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <map>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -53,27 +57,175 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
             val.getType() == expectedType);
     return val;
 }
+
+/**
+ * Sets the "fullDocument" field of the event held by 'result' to 'postImage'.
+ */
+void setPostImage(DocumentSource::GetNextResult* result, Value postImage) {
+    MutableDocument output(result->releaseDocument());
+    output[DocumentSourceLookupChangePostImage::kFullDocumentFieldName] = std::move(postImage);
+    *result = output.freeze();
+}
+
+/**
+ * Returns true if every field of 'documentKey', which may name a dotted path, has the same value
+ * in 'doc'.
+ */
+bool matchesDocumentKey(const Document& doc, const Document& documentKey) {
+    FieldIterator keyFields = documentKey.fieldIterator();
+    while (keyFields.more()) {
+        auto keyField = keyFields.next();
+        if (ValueComparator::kInstance.compare(doc.getNestedField(FieldPath(keyField.first)),
+                                               keyField.second) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * An update event whose post-image is looked up together with others in the same collection.
+ */
+struct PendingLookup {
+    size_t index;  // The position of the event in the buffer.
+    Document documentKey;
+    Timestamp clusterTime;
+};
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_buffer.empty()) {
+        fillBuffer();
+    }
+    auto next = std::move(_buffer.front());
+    _buffer.pop_front();
+    return next;
+}
+
+void DocumentSourceLookupChangePostImage::fillBuffer() {
+    const size_t batchSize =
+        std::max(1, internalDocumentSourceLookupChangePostImageBatchSize.load());
+
+    // Stop reading ahead at the first pause or EOF, so that it is returned no later than it would
+    // be without the read-ahead.
+    std::vector<size_t> updateIndexes;
+    while (_buffer.size() < batchSize) {
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            _buffer.push_back(std::move(input));
+            break;
+        }
+        auto opTypeVal = assertFieldHasType(
+            input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+        if (opTypeVal.getString() == DocumentSourceChangeStream::kUpdateOpType) {
+            updateIndexes.push_back(_buffer.size());
+        }
+        _buffer.push_back(std::move(input));
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+
+    if (updateIndexes.empty()) {
+        return;
     }
 
     // Temporarily remove any deadline from this operation to avoid timeout during lookup.
     OperationContext::DeadlineStash deadlineStash(pExpCtx->opCtx);
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    if (updateIndexes.size() == 1u) {
+        auto& input = _buffer[updateIndexes.front()];
+        setPostImage(&input, lookupPostImage(input.getDocument()));
+        return;
+    }
+    lookupPostImages(updateIndexes);
+}
+
+void DocumentSourceLookupChangePostImage::lookupPostImages(
+    const std::vector<size_t>& updateIndexes) {
+    // Make sure we have well-formed inputs, and group them by the collection they look up into.
+    std::map<UUID, std::vector<PendingLookup>> lookupsByUUID;
+    boost::optional<NamespaceString> nss;
+    for (auto index : updateIndexes) {
+        const auto& updateOp = _buffer[index].getDocument();
+        nss = assertNamespaceMatches(updateOp);
+        auto documentKey = assertFieldHasType(updateOp,
+                                              DocumentSourceChangeStream::kDocumentKeyField,
+                                              BSONType::Object)
+                               .getDocument();
+        auto resumeToken =
+            ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument())
+                .getData();
+        invariant(resumeToken.uuid);
+        lookupsByUUID[*resumeToken.uuid].push_back(
+            {index, std::move(documentKey), resumeToken.clusterTime});
+    }
+
+    for (auto&& uuidAndLookups : lookupsByUUID) {
+        const auto& lookups = uuidAndLookups.second;
+        if (lookups.size() == 1u) {
+            auto& input = _buffer[lookups.front().index];
+            setPostImage(&input, lookupPostImage(input.getDocument()));
+            continue;
+        }
+
+        // Match all the document keys with a single $in on _id when they consist only of the _id,
+        // as they do for unsharded collections, and with an $or of the whole keys otherwise.
+        bool idOnly = true;
+        Timestamp maxClusterTime;
+        for (auto&& lookup : lookups) {
+            idOnly = idOnly && lookup.documentKey.size() == 1u &&
+                !lookup.documentKey["_id"_sd].missing();
+            maxClusterTime = std::max(maxClusterTime, lookup.clusterTime);
+        }
+        BSONObjBuilder filterBuilder;
+        if (idOnly) {
+            BSONObjBuilder idBuilder(filterBuilder.subobjStart("_id"));
+            BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+            for (auto&& lookup : lookups) {
+                lookup.documentKey["_id"_sd].addToBsonArray(&inBuilder);
+            }
+        } else {
+            BSONArrayBuilder orBuilder(filterBuilder.subarrayStart("$or"));
+            for (auto&& lookup : lookups) {
+                orBuilder.append(lookup.documentKey.toBson());
+            }
+        }
+
+        // Reading after the latest of the events' cluster times reads after each of them.
+        const auto readConcern = pExpCtx->inMongos
+            ? boost::optional<BSONObj>(BSON("level"
+                                            << "majority"
+                                            << "afterClusterTime"
+                                            << maxClusterTime))
+            : boost::none;
+        auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+            pExpCtx, *nss, uuidAndLookups.first, filterBuilder.obj(), lookups.size(), readConcern);
+
+        for (auto&& lookup : lookups) {
+            auto& input = _buffer[lookup.index];
+            const Document* match = nullptr;
+            for (auto&& doc : lookedUpDocs) {
+                if (!matchesDocumentKey(doc, lookup.documentKey)) {
+                    continue;
+                }
+                uassert(ErrorCodes::TooManyMatchingDocuments,
+                        str::stream() << "found more than one document matching "
+                                      << lookup.documentKey.toString()
+                                      << " ["
+                                      << match->toString()
+                                      << ", "
+                                      << doc.toString()
+                                      << "]",
+                        !match);
+                match = &doc;
+            }
+
+            // A document may be missing because it was deleted since the update, because the
+            // reply was cut short, or because the collection's collation matched it differently,
+            // so look it up on its own to be sure.
+            setPostImage(&input, match ? Value(*match) : lookupPostImage(input.getDocument()));
+        }
+    }
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertNamespaceMatches(
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -37,7 +39,10 @@ namespace mongo {
  * Part of the change stream API machinery used to look up the post-image of a document. Uses
  * the "documentKey" field of the input to look up the new version of the document.
  *
- * Uses the ExpressionContext to determine what collection to look up into.
+ * Uses the ExpressionContext to determine what collection to look up into. Reads ahead up to
+ * 'internalDocumentSourceLookupChangePostImageBatchSize' events, so that the post-images of all
+ * the updates among them can be looked up with one query, and returns the events in their original
+ * order.
  * TODO SERVER-29134 When we allow change streams on multiple collections, this will need to change.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
@@ -89,7 +94,8 @@ public:
     }
 
     /**
-     * Performs the lookup to retrieve the full document.
+     * Returns the next event, performing the lookups for the next window of events if none are
+     * buffered.
      */
     GetNextResult getNext() final;
 
@@ -108,6 +114,19 @@ private:
     DocumentSourceLookupChangePostImage(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : DocumentSource(expCtx) {}
 
+    /**
+     * Reads the next window of events from the source into '_buffer', stopping after the first
+     * result which is not advanced, and fills in the post-images of the updates among them.
+     */
+    void fillBuffer();
+
+    /**
+     * Looks up the post-images of the update events at the given positions of '_buffer' with one
+     * query per collection, falling back to lookupPostImage() for any update whose document the
+     * query did not return.
+     */
+    void lookupPostImages(const std::vector<size_t>& updateIndexes);
+
     /**
      * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
      * Returns Value(BSONNULL) if the document couldn't be found.
@@ -119,6 +138,10 @@ private:
      * ExpressionContext.
      */
     NamespaceString assertNamespaceMatches(const Document& inputDoc) const;
+
+    // The events read ahead from the source, in order, with their post-images already filled in.
+    // If the last one is not advanced, no more events were read after it.
+    std::deque<GetNextResult> _buffer;
 };
 
 }  // namespace mongo
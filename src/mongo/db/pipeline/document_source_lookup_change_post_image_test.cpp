@@ -119,6 +119,7 @@ public:
         UUID collectionUUID,
         const Document& documentKey,
         boost::optional<BSONObj> readConcern) {
+        ++numSingleLookups;
         auto swPipeline = makePipeline({BSON("$match" << documentKey)}, expCtx);
         if (swPipeline == ErrorCodes::NamespaceNotFound) {
             return boost::none;
@@ -139,6 +140,25 @@ public:
         return lookedUpDocument;
     }
 
+    std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                          const NamespaceString& nss,
+                                          UUID collectionUUID,
+                                          const BSONObj& filter,
+                                          long long maxResults,
+                                          boost::optional<BSONObj> readConcern) final {
+        ++numBatchedLookups;
+        auto pipeline = uassertStatusOK(makePipeline({BSON("$match" << filter)}, expCtx));
+
+        std::vector<Document> lookedUpDocuments;
+        while (auto next = pipeline->getNext()) {
+            lookedUpDocuments.push_back(std::move(*next));
+        }
+        return lookedUpDocuments;
+    }
+
+    int numSingleLookups = 0;
+    int numBatchedLookups = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
 };
@@ -334,5 +354,140 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpPostImagesOfAllUpdatesInOneQuery) {
+    auto expCtx = getExpCtx();
+
+    // Set up the $lookup stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with several updates and an insert between them.
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto mockLocalSource = DocumentSourceMock::create(
+        {Document{{"_id", makeResumeToken(0)},
+                  {"documentKey", Document{{"_id", 0}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}},
+         Document{{"_id", makeResumeToken(3)},
+                  {"documentKey", Document{{"_id", 3}}},
+                  {"operationType", "insert"_sd},
+                  {"ns", ns},
+                  {"fullDocument", Document{{"_id", 3}}}},
+         Document{{"_id", makeResumeToken(2)},
+                  {"documentKey", Document{{"_id", 2}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}},
+         Document{{"_id", makeResumeToken(1)},
+                  {"documentKey", Document{{"_id", 1}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}}});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection.
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"x", 0}},
+                                                             Document{{"_id", 1}, {"x", 1}},
+                                                             Document{{"_id", 2}, {"x", 2}},
+                                                             Document{{"_id", 3}, {"x", 3}}};
+    auto mongoProcessInterface =
+        stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockInterface = mongoProcessInterface.get();
+    getExpCtx()->mongoProcessInterface = std::move(mongoProcessInterface);
+
+    // The events come out in their original order, each with its own post-image.
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 0}, {"x", 0}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 3}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 2}, {"x", 2}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 1}, {"x", 1}}));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+
+    // All three post-images were found with a single query.
+    ASSERT_EQ(mockInterface->numBatchedLookups, 1);
+    ASSERT_EQ(mockInterface->numSingleLookups, 0);
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest,
+       ShouldLookUpPostImagesNotReturnedByTheBatchedQueryIndividually) {
+    auto expCtx = getExpCtx();
+
+    // Set up the $lookup stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with two updates, one of which is to a document that has since been deleted.
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto mockLocalSource = DocumentSourceMock::create(
+        {Document{{"_id", makeResumeToken(0)},
+                  {"documentKey", Document{{"_id", 0}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}},
+         Document{{"_id", makeResumeToken(1)},
+                  {"documentKey", Document{{"_id", 1}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}}});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection.
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}}};
+    auto mongoProcessInterface =
+        stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockInterface = mongoProcessInterface.get();
+    getExpCtx()->mongoProcessInterface = std::move(mongoProcessInterface);
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 0}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(BSONNULL));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+
+    ASSERT_EQ(mockInterface->numBatchedLookups, 1);
+    ASSERT_EQ(mockInterface->numSingleLookups, 1);
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldErrorIfBatchedDocumentKeyIsNotUnique) {
+    auto expCtx = getExpCtx();
+
+    // Set up the $lookup stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with two updates.
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto mockLocalSource = DocumentSourceMock::create(
+        {Document{{"_id", makeResumeToken(0)},
+                  {"documentKey", Document{{"_id", 0}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}},
+         Document{{"_id", makeResumeToken(1)},
+                  {"documentKey", Document{{"_id", 1}}},
+                  {"operationType", "update"_sd},
+                  {"ns", ns}}});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection to have two documents with the same document key.
+    deque<DocumentSource::GetNextResult> foreignCollection = {
+        Document{{"_id", 0}}, Document{{"_id", 0}}, Document{{"_id", 1}}};
+    getExpCtx()->mongoProcessInterface =
+        stdx::make_unique<MockMongoInterface>(std::move(foreignCollection));
+
+    ASSERT_THROWS_CODE(
+        lookupChangeStage->getNext(), AssertionException, ErrorCodes::TooManyMatchingDocuments);
+}
+
 }  // namespace
 }  // namespace mongo
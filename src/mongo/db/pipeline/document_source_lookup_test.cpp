@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -434,6 +435,74 @@ TEST_F(DocumentSourceLookUpTest, ShouldBeAbleToReParseSerializedStage) {
     ASSERT_VALUE_EQ(newSerialization[0], serialization[0]);
 }
 
+TEST_F(DocumentSourceLookUpTest, ShardLocalLookupRunsOnShardsAndSurvivesReParsing) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "coll");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupStage = DocumentSourceLookUp::createFromBson(
+        BSON("$lookup" << BSON("from"
+                               << "coll"
+                               << "localField"
+                               << "a"
+                               << "foreignField"
+                               << "a"
+                               << "as"
+                               << "as"))
+            .firstElement(),
+        expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(lookupStage.get());
+
+    // By default the $lookup runs in the merging half of a split pipeline, on the primary shard.
+    ASSERT_FALSE(lookup->runsShardLocal());
+    ASSERT_FALSE(lookup->getShardSource());
+    ASSERT_EQ(1UL, lookup->getMergeSources().size());
+    ASSERT(lookupStage->constraints().hostRequirement ==
+           DocumentSource::StageConstraints::HostTypeRequirement::kPrimaryShard);
+
+    // A shard-local $lookup runs entirely in the shards' half of the pipeline.
+    lookup->setRunShardLocal();
+    ASSERT_TRUE(lookup->runsShardLocal());
+    ASSERT_EQ(lookupStage, lookup->getShardSource());
+    ASSERT_TRUE(lookup->getMergeSources().empty());
+    ASSERT(lookupStage->constraints().hostRequirement ==
+           DocumentSource::StageConstraints::HostTypeRequirement::kAnyShard);
+
+    // The shards must know that the join is shard-local, so the serialization carries it over.
+    vector<Value> serialization;
+    lookupStage->serializeToArray(serialization);
+    ASSERT_EQ(serialization.size(), 1UL);
+
+    auto roundTripped = DocumentSourceLookUp::createFromBson(
+        serialization[0].getDocument().toBson().firstElement(), expCtx);
+    ASSERT_TRUE(static_cast<DocumentSourceLookUp*>(roundTripped.get())->runsShardLocal());
+
+    vector<Value> newSerialization;
+    roundTripped->serializeToArray(newSerialization);
+    ASSERT_EQ(newSerialization.size(), 1UL);
+    ASSERT_VALUE_EQ(newSerialization[0], serialization[0]);
+}
+
+TEST_F(DocumentSourceLookUpTest, RejectsShardLocalWhenPipelineIsSpecified) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "coll");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    ASSERT_THROWS_CODE(DocumentSourceLookUp::createFromBson(
+                           BSON("$lookup" << BSON("from"
+                                                  << "coll"
+                                                  << "pipeline"
+                                                  << BSONArray()
+                                                  << "$_internalShardLocal"
+                                                  << true
+                                                  << "as"
+                                                  << "as"))
+                               .firstElement(),
+                           expCtx),
+                       AssertionException,
+                       ErrorCodes::FailedToParse);
+}
+
 TEST(MakeMatchStageFromInput, NonArrayValueUsesEqQuery) {
     auto input = Document{{"local", 1}};
     BSONObj matchStage = DocumentSourceLookUp::makeMatchStageFromInput(
@@ -497,10 +566,18 @@ public:
         return false;
     }
 
+    Status appendRecordCount(OperationContext* opCtx,
+                             const NamespaceString& nss,
+                             BSONObjBuilder* builder) const final {
+        builder->appendNumber("count", static_cast<long long>(_mockResults.size()));
+        return Status::OK();
+    }
+
     StatusWith<std::unique_ptr<Pipeline, PipelineDeleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -532,9 +609,14 @@ public:
         return Status::OK();
     }
 
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    int _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -641,6 +723,139 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, ShouldJoinAgainstHashTableOnceForeignCollectionIsSmallEnough) {
+    const int oldMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    const double oldRatio = internalDocumentSourceLookupHashJoinForeignToLocalRatio.load();
+    ON_BLOCK_EXIT([oldMinLocalDocs, oldRatio] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(oldMinLocalDocs);
+        internalDocumentSourceLookupHashJoinForeignToLocalRatio.store(oldRatio);
+    });
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(1);
+    internalDocumentSourceLookupHashJoinForeignToLocalRatio.store(1.0);
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The foreign collection holds two documents, so the first input document is joined by
+    // querying and the hash table is built while joining the second.
+    const Document foreignDoc0{{"_id", 0}, {"key", 1}};
+    const Document foreignDoc1{{"_id", 1}, {"key", vector<Value>{Value(2), Value(2)}}};
+    const vector<Value> bothKeys{Value(1), Value(2)};
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"foreignId", 1}},
+                                                       Document{{"foreignId", 2}},
+                                                       Document{{"foreignId", 3}},
+                                                       Document{{"foreignId", bothKeys}},
+                                                       Document{{"foreignId", BSONNULL}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreignDoc0),
+                                                             Document(foreignDoc1)};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(foreignDoc0)}}}));
+    ASSERT_EQ(1, mongoInterface->numPipelinesMade());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 2}, {"foreignDocs", vector<Value>{Value(foreignDoc1)}}}));
+    ASSERT_EQ(2, mongoInterface->numPipelinesMade());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 3}, {"foreignDocs", vector<Value>{}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", bothKeys},
+                  {"foreignDocs", vector<Value>{Value(foreignDoc0), Value(foreignDoc1)}}}));
+    ASSERT_EQ(2, mongoInterface->numPipelinesMade());
+
+    // Null local values are not looked up in the hash table.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", BSONNULL}, {"foreignDocs", vector<Value>{}}}));
+    ASSERT_EQ(3, mongoInterface->numPipelinesMade());
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldUnwindHashJoinMatches) {
+    const int oldMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    ON_BLOCK_EXIT([oldMinLocalDocs] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(oldMinLocalDocs);
+    });
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(1);
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDoc"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const bool preserveNullAndEmptyArrays = false;
+    const boost::optional<std::string> includeArrayIndex = std::string("arrIndex");
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "foreignDoc", preserveNullAndEmptyArrays, includeArrayIndex));
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 1}}, Document{{"foreignId", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"key", 1}},
+                                                             Document{{"_id", 1}, {"key", 1}}};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1},
+                                 {"foreignDoc", Document{{"_id", 0}, {"key", 1}}},
+                                 {"arrIndex", 0LL}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1},
+                                 {"foreignDoc", Document{{"_id", 1}, {"key", 1}}},
+                                 {"arrIndex", 1LL}}));
+
+    // The second input document has no matches.
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(1, mongoInterface->numPipelinesMade());
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -86,14 +86,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (matches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -108,6 +101,37 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
+
+    while (true) {
+        const auto status = pSource->getNextBatch(batch, maxBatchSize);
+        if (status != GetNextResult::ReturnStatus::kAdvanced) {
+            return status;
+        }
+
+        batch->erase(std::remove_if(batch->begin(),
+                                    batch->end(),
+                                    [this](const Document& doc) { return !matches(doc); }),
+                     batch->end());
+        if (!batch->empty()) {
+            return status;
+        }
+    }
+}
+
+bool DocumentSourceMatch::matches(const Document& doc) const {
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? doc.toBson()
+        : document_path_support::documentToBsonWithPaths(doc, _dependencies.fields);
+    return _expression->matchesBSON(toMatch);
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
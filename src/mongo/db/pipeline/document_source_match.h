@@ -42,6 +42,8 @@ public:
     virtual ~DocumentSourceMatch() = default;
 
     GetNextResult getNext() override;
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) override;
     boost::intrusive_ptr<DocumentSource> optimize() final;
     BSONObjSet getOutputSorts() final {
         return pSource ? pSource->getOutputSorts()
@@ -113,6 +115,11 @@ public:
      */
     BSONObj redactSafePortion() const;
 
+    /**
+     * Returns true if 'doc' matches '_expression'.
+     */
+    bool matches(const Document& doc) const;
+
     static bool isTextQuery(const BSONObj& query);
     bool isTextQuery() const {
         return _isTextQuery;
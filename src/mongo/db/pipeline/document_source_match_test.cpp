@@ -497,6 +497,43 @@ TEST_F(DocumentSourceMatchTest, ShouldPropagatePauses) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldFilterBatchesAndPropagatePauses) {
+    using ReturnStatus = DocumentSource::GetNextResult::ReturnStatus;
+
+    auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
+    auto mock = DocumentSourceMock::create({Document{{"a", 1}, {"b", 0}},
+                                            Document{{"a", 2}},
+                                            Document{{"a", 1}, {"b", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 2}},
+                                            Document{{"a", 2}},
+                                            Document{{"a", 1}, {"b", 2}},
+                                            Document{{"a", 1}, {"b", 3}}});
+    match->setSource(mock.get());
+
+    std::vector<Document> batch;
+    ASSERT(match->getNextBatch(&batch, 10) == ReturnStatus::kAdvanced);
+    ASSERT_EQ(2U, batch.size());
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 0}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 1}, {"b", 1}}));
+
+    // The pause which ended the previous batch is returned on its own.
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 10) == ReturnStatus::kPauseExecution);
+    ASSERT_TRUE(batch.empty());
+
+    // A batch holds at most 'maxBatchSize' documents before filtering, and batches which are
+    // filtered out entirely are skipped.
+    ASSERT(match->getNextBatch(&batch, 2) == ReturnStatus::kAdvanced);
+    ASSERT_EQ(2U, batch.size());
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 2}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 1}, {"b", 3}}));
+
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 2) == ReturnStatus::kEOF);
+    ASSERT(match->getNextBatch(&batch, 2) == ReturnStatus::kEOF);
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldCorrectlyJoinWithSubsequentMatch) {
     const auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
     const auto secondMatch = DocumentSourceMatch::create(BSON("b" << 1), getExpCtx());
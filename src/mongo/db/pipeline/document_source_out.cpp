@@ -39,6 +39,11 @@ namespace mongo {
 using boost::intrusive_ptr;
 using std::vector;
 
+constexpr StringData DocumentSourceOut::kToFieldName;
+constexpr StringData DocumentSourceOut::kModeFieldName;
+constexpr StringData DocumentSourceOut::kReplaceCollectionModeName;
+constexpr StringData DocumentSourceOut::kUpsertDocumentsModeName;
+
 DocumentSourceOut::~DocumentSourceOut() {
     DESTRUCTOR_GUARD(
         // Make sure we drop the temp collection if anything goes wrong. Errors are ignored
@@ -49,19 +54,74 @@ DocumentSourceOut::~DocumentSourceOut() {
         });
 }
 
-std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceOut::liteParse(
-    const AggregationRequest& request, const BSONElement& spec) {
+std::pair<std::string, DocumentSourceOut::Mode> DocumentSourceOut::parseSpec(
+    const BSONElement& spec) {
+    if (spec.type() == BSONType::String) {
+        return {spec.str(), Mode::kReplaceCollection};
+    }
+
     uassert(ErrorCodes::TypeMismatch,
-            str::stream() << "$out stage requires a string argument, but found "
+            str::stream() << "$out stage requires a string or object argument, but found "
                           << typeName(spec.type()),
-            spec.type() == BSONType::String);
+            spec.type() == BSONType::Object);
+
+    boost::optional<std::string> to;
+    Mode mode = Mode::kReplaceCollection;
+    for (auto&& elem : spec.embeddedObject()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kToFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "$out '" << kToFieldName
+                                  << "' option must be a string, but found "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::String);
+            to = elem.str();
+        } else if (fieldName == kModeFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "$out '" << kModeFieldName
+                                  << "' option must be a string, but found "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::String);
+            if (elem.valueStringData() == kReplaceCollectionModeName) {
+                mode = Mode::kReplaceCollection;
+            } else if (elem.valueStringData() == kUpsertDocumentsModeName) {
+                mode = Mode::kUpsertDocuments;
+            } else {
+                uasserted(ErrorCodes::BadValue,
+                          str::stream() << "unknown $out mode '" << elem.valueStringData()
+                                        << "', expected '"
+                                        << kReplaceCollectionModeName
+                                        << "' or '"
+                                        << kUpsertDocumentsModeName
+                                        << "'");
+            }
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "unknown option to $out: " << fieldName);
+        }
+    }
 
-    NamespaceString targetNss(request.getNamespaceString().db(), spec.valueStringData());
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << "$out requires a '" << kToFieldName << "' option",
+            to);
+    return {*to, mode};
+}
+
+std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceOut::liteParse(
+    const AggregationRequest& request, const BSONElement& spec) {
+    const auto parsedSpec = parseSpec(spec);
+
+    NamespaceString targetNss(request.getNamespaceString().db(), parsedSpec.first);
     uassert(ErrorCodes::InvalidNamespace,
             str::stream() << "Invalid $out target namespace, " << targetNss.ns(),
             targetNss.isValid());
 
-    ActionSet actions{ActionType::remove, ActionType::insert};
+    ActionSet actions{ActionType::insert};
+    if (parsedSpec.second == Mode::kReplaceCollection) {
+        actions.addAction(ActionType::remove);
+    } else {
+        actions.addAction(ActionType::update);
+    }
     if (request.shouldBypassDocumentValidation()) {
         actions.addAction(ActionType::bypassDocumentValidation);
     }
@@ -101,6 +161,12 @@ void DocumentSourceOut::initialize() {
                           << "' is capped so it can't be used for $out",
             _originalOutOptions["capped"].eoo());
 
+    if (_mode == Mode::kUpsertDocuments) {
+        // Results are written straight into the target collection, so there is nothing to set up.
+        _initialized = true;
+        return;
+    }
+
     // We will write all results into a temporary collection, then rename the temporary collection
     // to be the target collection once we are done.
     _tempNs = NamespaceString(str::stream() << _outputNs.db() << ".tmp.agg_out."
@@ -145,6 +211,14 @@ void DocumentSourceOut::initialize() {
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
+    if (_mode == Mode::kUpsertDocuments) {
+        BSONObj err = pExpCtx->mongoProcessInterface->upsert(pExpCtx, _outputNs, toInsert);
+        uassert(ErrorCodes::OperationFailed,
+                str::stream() << "upsert for $out failed: " << err,
+                DBClientBase::getLastErrorString(err).empty());
+        return;
+    }
+
     BSONObj err = pExpCtx->mongoProcessInterface->insert(pExpCtx, _tempNs, toInsert);
     uassert(16996,
             str::stream() << "insert for $out failed: " << err,
@@ -169,6 +243,11 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         BSONObj toInsert = nextInput.releaseDocument().toBson();
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "$out in '" << kUpsertDocumentsModeName
+                              << "' mode requires every document to have an _id, but found "
+                              << toInsert,
+                _mode != Mode::kUpsertDocuments || toInsert.hasField("_id"));
 
         bufferedBytes += toInsert.objsize();
         if (!bufferedObjects.empty() && (bufferedBytes > BSONObjMaxUserSize ||
@@ -190,6 +269,11 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            if (_mode == Mode::kUpsertDocuments) {
+                // The results were written directly into the target collection.
+                _done = true;
+                return nextInput;
+            }
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
@@ -211,32 +295,40 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
 }
 
 DocumentSourceOut::DocumentSourceOut(const NamespaceString& outputNs,
+                                     Mode mode,
                                      const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSource(pExpCtx),
       _done(false),
       _tempNs(""),  // Filled in during getNext().
-      _outputNs(outputNs) {}
+      _outputNs(outputNs),
+      _mode(mode) {}
 
 intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
     uassert(16990,
-            str::stream() << "$out only supports a string argument, not " << typeName(elem.type()),
-            elem.type() == String);
+            str::stream() << "$out only supports a string or object argument, not "
+                          << typeName(elem.type()),
+            elem.type() == String || elem.type() == Object);
+    const auto parsedSpec = parseSpec(elem);
 
     uassert(ErrorCodes::InvalidOptions,
             "$out can only be used with the 'local' read concern level",
             !pExpCtx->opCtx->recoveryUnit()->isReadingFromMajorityCommittedSnapshot());
 
-    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + elem.str());
-    uassert(17385, "Can't $out to special collection: " + elem.str(), !outputNs.isSpecial());
-    return new DocumentSourceOut(outputNs, pExpCtx);
+    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + parsedSpec.first);
+    uassert(17385, "Can't $out to special collection: " + parsedSpec.first, !outputNs.isSpecial());
+    return new DocumentSourceOut(outputNs, parsedSpec.second, pExpCtx);
 }
 
 Value DocumentSourceOut::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     massert(
         17000, "$out shouldn't have different db than input", _outputNs.db() == pExpCtx->ns.db());
 
-    return Value(DOC(getSourceName() << _outputNs.coll()));
+    if (_mode == Mode::kReplaceCollection) {
+        return Value(DOC(getSourceName() << _outputNs.coll()));
+    }
+    return Value(DOC(getSourceName() << DOC(kToFieldName << _outputNs.coll() << kModeFieldName
+                                                         << kUpsertDocumentsModeName)));
 }
 
 DocumentSource::GetDepsReturn DocumentSourceOut::getDependencies(DepsTracker* deps) const {
@@ -34,6 +34,24 @@ namespace mongo {
 
 class DocumentSourceOut final : public DocumentSource, public SplittableDocumentSource {
 public:
+    /**
+     * How the results of the pipeline are written to the target collection.
+     */
+    enum class Mode {
+        // Write into a temporary collection, then rename it over the target collection. This is
+        // the default, and the only mode available with the string form of the $out spec.
+        kReplaceCollection,
+
+        // Replace or insert each result in the existing target collection, keyed by _id, leaving
+        // any other documents in the target collection untouched.
+        kUpsertDocuments,
+    };
+
+    static constexpr StringData kToFieldName = "to"_sd;
+    static constexpr StringData kModeFieldName = "mode"_sd;
+    static constexpr StringData kReplaceCollectionModeName = "replaceCollection"_sd;
+    static constexpr StringData kUpsertDocumentsModeName = "upsertDocuments"_sd;
+
     static std::unique_ptr<LiteParsedDocumentSourceForeignCollections> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
@@ -64,6 +82,10 @@ public:
         return _outputNs;
     }
 
+    Mode getMode() const {
+        return _mode;
+    }
+
     /**
       Create a document source for output and pass-through.
 
@@ -79,8 +101,16 @@ public:
 
 private:
     DocumentSourceOut(const NamespaceString& outputNs,
+                      Mode mode,
                       const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    /**
+     * Parses either form of the $out spec, a collection name or an object of the form
+     * {to: <collection name>, mode: <"replaceCollection"|"upsertDocuments">}, into the name of the
+     * target collection and the write mode. Throws a user assertion if 'spec' is malformed.
+     */
+    static std::pair<std::string, Mode> parseSpec(const BSONElement& spec);
+
     /**
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
@@ -88,11 +118,15 @@ private:
      * and indexes from the target collection.
      *
      * Sets '_initialized' to true upon completion.
+     *
+     * In upsert mode, only the sharded and capped checks are made since the target collection is
+     * written to directly.
      */
     void initialize();
 
     /**
-     * Inserts all of 'toInsert' into the temporary collection.
+     * Inserts all of 'toInsert' into the temporary collection, or upserts them into the target
+     * collection in upsert mode.
      */
     void spill(const std::vector<BSONObj>& toInsert);
 
@@ -106,6 +140,7 @@ private:
 
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
+    const Mode _mode;
 };
 
 }  // namespace mongo
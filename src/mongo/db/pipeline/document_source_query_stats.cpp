@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_stats.h"
+
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(queryStats,
+                         DocumentSourceQueryStats::LiteParsed::parse,
+                         DocumentSourceQueryStats::createFromBson);
+
+const char* DocumentSourceQueryStats::kStageName = "$queryStats";
+
+DocumentSource::GetNextResult DocumentSourceQueryStats::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_loaded) {
+        _stats = pExpCtx->mongoProcessInterface->getQueryStats(pExpCtx->opCtx, pExpCtx->ns);
+        _loaded = true;
+    }
+
+    if (_nextStats < _stats.size()) {
+        MutableDocument doc(Document(_stats[_nextStats++]));
+        doc.addField("ns", Value(pExpCtx->ns.ns()));
+        doc.addField("host", Value(_processName));
+        return doc.freeze();
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceQueryStats::createFromBson(
+    BSONElement spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::BadValue,
+            str::stream() << kStageName << " must be run as { " << kStageName << ": {}}",
+            spec.isABSONObj() && spec.Obj().isEmpty());
+
+    return new DocumentSourceQueryStats(pExpCtx);
+}
+
+DocumentSourceQueryStats::DocumentSourceQueryStats(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(pExpCtx), _processName(getHostNameCachedAndPort()) {}
+
+}  // namespace mongo
@@ -67,6 +67,20 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNex
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::getNextBatch(std::vector<Document>* batch,
+                                                         size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    const auto status = pSource->getNextBatch(batch, maxBatchSize);
+    if (status == GetNextResult::ReturnStatus::kAdvanced) {
+        for (auto&& doc : *batch) {
+            doc = _parsedTransform->applyTransformation(doc);
+        }
+    }
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) 2017 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_slow_ops.h"
+
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(slowOps,
+                         DocumentSourceSlowOps::LiteParsed::parse,
+                         DocumentSourceSlowOps::createFromBson);
+
+const char* DocumentSourceSlowOps::kStageName = "$slowOps";
+
+DocumentSource::GetNextResult DocumentSourceSlowOps::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_nextSlowOp < _slowOps.size()) {
+        return Document(_slowOps[_nextSlowOp++]);
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceSlowOps::createFromBson(
+    BSONElement spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+
+    uassert(
+        ErrorCodes::InvalidNamespace,
+        str::stream() << kStageName
+                      << " must be run against the database with {aggregate: 1}, not a collection",
+        pExpCtx->ns.isCollectionlessAggregateNS());
+
+    uassert(ErrorCodes::BadValue,
+            str::stream() << kStageName << " must be run as { " << kStageName << ": {}}",
+            spec.isABSONObj() && spec.Obj().isEmpty());
+
+    uassert(ErrorCodes::IllegalOperation,
+            str::stream() << kStageName << " is only supported on mongod",
+            !pExpCtx->inMongos);
+
+    return new DocumentSourceSlowOps(pExpCtx);
+}
+
+DocumentSourceSlowOps::DocumentSourceSlowOps(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(pExpCtx),
+      _slowOps(pExpCtx->mongoProcessInterface->getSlowOps(pExpCtx->opCtx)) {}
+
+}  // namespace mongo
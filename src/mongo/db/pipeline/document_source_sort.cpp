@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -321,7 +322,8 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
         opts.limit = limitSrc->getLimit();
 
     opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
-    if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+    opts.sortThreads = std::max(1, internalQueryExecSortThreads.load());
+    if (pExpCtx->canSpillToDisk()) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
     }
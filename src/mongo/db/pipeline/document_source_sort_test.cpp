@@ -433,6 +433,39 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, ShouldSpillInMongosOnlyWithTempDir) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+    string largeStr(maxMemoryUsageBytes, 'x');
+
+    // Without a directory for temporary files mongos cannot spill.
+    auto sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), -1, maxMemoryUsageBytes);
+    auto mock = DocumentSourceMock::create({Document{{"_id", 0}, {"largeStr", largeStr}},
+                                            Document{{"_id", 1}, {"largeStr", largeStr}}});
+    sort->setSource(mock.get());
+    ASSERT_THROWS_CODE(sort->getNext(), AssertionException, 16819);
+
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+
+    sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), -1, maxMemoryUsageBytes);
+    mock = DocumentSourceMock::create({Document{{"_id", 0}, {"largeStr", largeStr}},
+                                       Document{{"_id", 1}, {"largeStr", largeStr}}});
+    sort->setSource(mock.get());
+
+    auto next = sort->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(1));
+
+    next = sort->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
+
+    ASSERT_TRUE(sort->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
@@ -42,6 +43,41 @@ using boost::intrusive_ptr;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * Returns true if every predicate in 'expression' is on a strict subfield of 'path', such that
+ * DocumentSourceMatch::descendMatchOnPath() can rewrite it as a predicate on the sub-document at
+ * 'path'.
+ */
+bool isMatchOnlyOnSubfieldsOf(MatchExpression* expression, const std::string& path) {
+    bool onlyOnSubfields = true;
+    expression::mapOver(expression, [&](MatchExpression* node, std::string) -> void {
+        switch (node->getCategory()) {
+            case MatchExpression::MatchCategory::kLogical:
+                return;
+            case MatchExpression::MatchCategory::kLeaf:
+            case MatchExpression::MatchCategory::kArrayMatching:
+                // An $elemMatch on 'path' itself cannot be descended, and descendMatchOnPath()
+                // does not rewrite the path of a $type.
+                if (node->matchType() == MatchExpression::ELEM_MATCH_OBJECT ||
+                    node->matchType() == MatchExpression::ELEM_MATCH_VALUE ||
+                    node->matchType() == MatchExpression::TYPE_OPERATOR) {
+                    onlyOnSubfields = false;
+                }
+                onlyOnSubfields =
+                    onlyOnSubfields && expression::isPathPrefixOf(path, node->path());
+                return;
+            case MatchExpression::MatchCategory::kOther:
+                onlyOnSubfields = false;
+                return;
+        }
+    });
+    return onlyOnSubfields;
+}
+
+}  // namespace
+
 /** Helper class to unwind array from a single document. */
 class DocumentSourceUnwind::Unwinder {
 public:
@@ -59,6 +95,22 @@ public:
      */
     DocumentSource::GetNextResult getNext();
 
+    /**
+     * Sets the $match, descended onto the unwound path, which array elements that are objects must
+     * pass to be returned. Elements which fail it are skipped without building an output document.
+     */
+    void setElementMatch(const DocumentSourceMatch* elementMatch) {
+        _elementMatch = elementMatch;
+    }
+
+    /**
+     * Returns true if the last document returned by getNext() is already known to pass the
+     * absorbed $match, because it was checked against the unwound array element.
+     */
+    bool outputMatched() const {
+        return _outputMatched;
+    }
+
 private:
     // Tracks whether or not we can possibly return any more documents. Note we may return
     // boost::none even if this is true.
@@ -84,6 +136,10 @@ private:
 
     // Index into the _inputArray to return next.
     size_t _index;
+
+    const DocumentSourceMatch* _elementMatch = nullptr;
+
+    bool _outputMatched = false;
 };
 
 DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath,
@@ -112,6 +168,7 @@ DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
     // Track which index this value came from. If 'includeArrayIndex' was specified, we will use
     // this index in the output document, or null if the value didn't come from an array.
     boost::optional<long long> indexForOutput;
+    _outputMatched = false;
 
     if (_inputArray.getType() == Array) {
         const size_t length = _inputArray.getArrayLength();
@@ -125,6 +182,20 @@ DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
             }
             _output.removeNestedField(_unwindPathFieldIndexes);
         } else {
+            if (_elementMatch) {
+                // Skip the elements which are objects and fail the absorbed $match. The other
+                // elements are checked against the whole output document by our caller.
+                while (_index < length && _inputArray[_index].getType() == Object &&
+                       !_elementMatch->matches(_inputArray[_index].getDocument())) {
+                    ++_index;
+                }
+                if (_index == length) {
+                    _haveNext = false;
+                    return GetNextResult::makeEOF();
+                }
+                _outputMatched = _inputArray[_index].getType() == Object;
+            }
+
             // Set field to be the next element in the array. If needed, this will automatically
             // clone all the documents along the field path so that the end values are not shared
             // across documents that have come out of this pipeline operator. This is a partial deep
@@ -189,21 +260,59 @@ intrusive_ptr<DocumentSourceUnwind> DocumentSourceUnwind::create(
 DocumentSource::GetNextResult DocumentSourceUnwind::getNext() {
     pExpCtx->checkForInterrupt();
 
-    auto nextOut = _unwinder->getNext();
-    while (nextOut.isEOF()) {
-        // No more elements in array currently being unwound. This will loop if the input
-        // document is missing the unwind field or has an empty array.
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+    while (true) {
+        auto nextOut = _unwinder->getNext();
+        if (nextOut.isEOF()) {
+            // No more elements in array currently being unwound. This will loop if the input
+            // document is missing the unwind field or has an empty array.
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                return nextInput;
+            }
+
+            // Try to extract an output document from the new input document.
+            _unwinder->resetDocument(nextInput.releaseDocument());
+            continue;
         }
 
-        // Try to extract an output document from the new input document.
-        _unwinder->resetDocument(nextInput.releaseDocument());
-        nextOut = _unwinder->getNext();
+        if (!_matchSrc || _unwinder->outputMatched() || _matchSrc->matches(nextOut.getDocument())) {
+            return nextOut;
+        }
+    }
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+
+    // The parts of a following $match which do not depend on the unwound path have already been
+    // swapped before us, so what remains is usually a predicate on the unwound elements. We do not
+    // absorb a $match when 'includeArrayIndex' is set, since the index may be written inside the
+    // unwound elements.
+    if (!nextMatch || nextMatch->isTextQuery() || _indexPath ||
+        !isMatchOnlyOnSubfieldsOf(nextMatch->getMatchExpression(), _unwindPath.fullPath())) {
+        return std::next(itr);
     }
 
-    return nextOut;
+    if (!_matchSrc) {
+        _matchSrc = nextMatch;
+    } else {
+        _matchSrc->joinMatchWith(nextMatch);
+    }
+    container->erase(std::next(itr));
+
+    // descendMatchOnPath() rewrites the paths of the expression it is given, so descend a copy to
+    // keep '_matchSrc' intact for serialization and for the elements which are not objects.
+    auto copy = DocumentSourceMatch::create(_matchSrc->getQuery(), pExpCtx);
+    _elementMatch = DocumentSourceMatch::descendMatchOnPath(
+        copy->getMatchExpression(), _unwindPath.fullPath(), pExpCtx);
+    _unwinder->setElementMatch(_elementMatch.get());
+
+    // There may be further optimization between this $unwind and the new neighbor, so we return an
+    // iterator pointing to ourself.
+    return itr;
 }
 
 BSONObjSet DocumentSourceUnwind::getOutputSorts() {
@@ -247,8 +356,19 @@ Value DocumentSourceUnwind::serialize(boost::optional<ExplainOptions::Verbosity>
                                 << (_indexPath ? Value((*_indexPath).fullPath()) : Value()))));
 }
 
+void DocumentSourceUnwind::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    DocumentSource::serializeToArray(array, explain);
+    if (_matchSrc) {
+        _matchSrc->serializeToArray(array, explain);
+    }
+}
+
 DocumentSource::GetDepsReturn DocumentSourceUnwind::getDependencies(DepsTracker* deps) const {
     deps->fields.insert(_unwindPath.fullPath());
+    if (_matchSrc) {
+        _matchSrc->getDependencies(deps);
+    }
     return SEE_NEXT;
 }
 
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/field_path.h"
 
 namespace mongo {
@@ -41,6 +42,13 @@ public:
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     BSONObjSet getOutputSorts() final;
 
+    /**
+     * Serializes this stage, followed by the $match it has absorbed, if any.
+     */
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
     /**
      * Returns the unwound path, and the 'includeArrayIndex' path, if specified.
      */
@@ -59,6 +67,14 @@ public:
 
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
 
+    /**
+     * Absorbs a following $match whose predicates are all on subfields of the unwound path. Those
+     * predicates are then evaluated directly against each array element which is an object, so
+     * that no output document is built for the elements which do not match.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
     /**
      * Creates a new $unwind DocumentSource from a BSON specification.
      */
@@ -98,6 +114,11 @@ private:
     // existing value, setting to null when the value was a non-array or empty array.
     const boost::optional<FieldPath> _indexPath;
 
+    // A $match absorbed from after this stage, and the same $match descended onto the unwound path
+    // to be evaluated against the array elements. Both are null if no $match has been absorbed.
+    boost::intrusive_ptr<DocumentSourceMatch> _matchSrc;
+    boost::intrusive_ptr<DocumentSourceMatch> _elementMatch;
+
     // Iteration state.
     class Unwinder;
     std::unique_ptr<Unwinder> _unwinder;
@@ -744,6 +744,98 @@ TEST_F(UnwindStageTest, UnwindIncludesIndexPathWhenIncludingIndex) {
     ASSERT_EQUALS(1U, modifiedPaths.paths.count("arrIndex"));
 }
 
+TEST_F(UnwindStageTest, ShouldAbsorbMatchOnSubfieldsOfUnwoundPath) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "items", false, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{'items.price': {$gt: 5}}"), getExpCtx());
+
+    Pipeline::SourceContainer container;
+    container.push_back(unwind);
+    container.push_back(match);
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(1U, container.size());
+
+    vector<Value> serialization;
+    unwind->serializeToArray(serialization);
+    ASSERT_EQUALS(2U, serialization.size());
+    ASSERT_VALUE_EQ(Value(fromjson("{$unwind: {path: '$items'}}")), serialization[0]);
+    ASSERT_VALUE_EQ(Value(fromjson("{$match: {'items.price': {$gt: 5}}}")), serialization[1]);
+
+    // Elements which are not objects are matched through the whole unwound document, so the array
+    // element below still matches by traversing into its subdocument.
+    auto source = DocumentSourceMock::create(
+        {Document(fromjson("{_id: 0, items: [{price: 1}, {price: 7}, 3, [{price: 9}], "
+                           "{price: 10}]}")),
+         Document(fromjson("{_id: 1, items: {price: 6}}")),
+         Document(fromjson("{_id: 2, items: [{price: 2}]}"))});
+    unwind->setSource(source.get());
+
+    auto next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, items: {price: 7}}")), next.releaseDocument());
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, items: [{price: 9}]}")), next.releaseDocument());
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, items: {price: 10}}")), next.releaseDocument());
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 1, items: {price: 6}}")), next.releaseDocument());
+    ASSERT_TRUE(unwind->getNext().isEOF());
+}
+
+TEST_F(UnwindStageTest, AbsorbedMatchShouldApplyToPreservedDocuments) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "items", true, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{'items.price': {$ne: 1}}"), getExpCtx());
+
+    Pipeline::SourceContainer container;
+    container.push_back(unwind);
+    container.push_back(match);
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(1U, container.size());
+
+    auto source = DocumentSourceMock::create({Document(fromjson("{_id: 0}")),
+                                              Document(fromjson("{_id: 1, items: []}")),
+                                              Document(fromjson("{_id: 2, items: {price: 1}}")),
+                                              Document(fromjson("{_id: 3, items: [{price: 1}]}")),
+                                              Document(fromjson("{_id: 4, items: [{price: 2}]}"))});
+    unwind->setSource(source.get());
+
+    auto next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0}")), next.releaseDocument());
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 1}")), next.releaseDocument());
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 4, items: {price: 2}}")), next.releaseDocument());
+    ASSERT_TRUE(unwind->getNext().isEOF());
+}
+
+TEST_F(UnwindStageTest, ShouldNotAbsorbMatchOnUnwoundPathItself) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "items", false, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{items: 1}"), getExpCtx());
+
+    Pipeline::SourceContainer container;
+    container.push_back(unwind);
+    container.push_back(match);
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(2U, container.size());
+}
+
+TEST_F(UnwindStageTest, ShouldNotAbsorbMatchWhenIncludingIndex) {
+    auto unwind = DocumentSourceUnwind::create(
+        getExpCtx(), "items", false, boost::optional<string>("items.index"));
+    auto match = DocumentSourceMatch::create(fromjson("{'items.index': 0}"), getExpCtx());
+
+    Pipeline::SourceContainer container;
+    container.push_back(unwind);
+    container.push_back(match);
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(2U, container.size());
+}
+
 //
 // Error cases.
 //
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeDocument() {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    bob.append("name", "joe");
+    bob.append("count", 12345);
+    bob.append("score", 3.5);
+    bob.append("address",
+               BSON("street"
+                    << "Main St"
+                    << "number"
+                    << 42));
+    bob.append("tags", BSON_ARRAY(1 << 2 << 3 << 4 << 5 << 6 << 7 << 8));
+    return bob.obj();
+}
+
+MONGO_BENCHMARK(DocumentFromBSON) {
+    const BSONObj obj = makeDocument();
+    while (state.keepRunning()) {
+        Document doc(obj);
+        unittest::doNotOptimizeAway(doc);
+    }
+    state.setBytesProcessed(state.iterations() * obj.objsize());
+}
+
+MONGO_BENCHMARK(DocumentFromBSONAndFieldAccess) {
+    const BSONObj obj = makeDocument();
+    while (state.keepRunning()) {
+        Document doc(obj);
+        unittest::doNotOptimizeAway(doc["score"]);
+    }
+}
+
+MONGO_BENCHMARK(DocumentToBSON) {
+    const Document doc(makeDocument());
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(doc.toBson());
+    }
+}
+
+MONGO_BENCHMARK(DocumentRoundTrip) {
+    const BSONObj obj = makeDocument();
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(Document(obj).toBson());
+    }
+}
+
+MONGO_BENCHMARK(MutableDocumentAddField) {
+    const Document doc(makeDocument());
+    while (state.keepRunning()) {
+        MutableDocument md(doc);
+        md.addField("added", Value(1));
+        unittest::doNotOptimizeAway(md.freeze());
+    }
+}
+
+MONGO_BENCHMARK(ValueFromBSONElement) {
+    const BSONObj obj = makeDocument();
+    const BSONElement elem = obj["address"];
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(Value(elem));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -113,6 +113,63 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, FromBsonLazyMatchesEagerConversion) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << BSON("d"
+                                                            << "x"))
+                            << "e"
+                            << BSON_ARRAY(BSON("f" << 2) << 3));
+    Document lazy = Document::fromBsonLazy(bson);
+    Document eager = fromBson(bson);
+
+    ASSERT_DOCUMENT_EQ(eager, lazy);
+    ASSERT_EQUALS(3U, lazy.size());
+    ASSERT_EQUALS("x", lazy.getNestedField(FieldPath("b.c.d")).getString());
+    ASSERT_EQUALS(2, lazy["e"][0]["f"].getInt());
+    assertRoundTrips(lazy);
+}
+
+TEST(DocumentConstruction, FromBsonLazySerializesUntouchedDocumentVerbatim) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2));
+    Document document = Document::fromBsonLazy(bson);
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+
+    // Touching the top level leaves the embedded object unconverted, and it still serializes the
+    // same way.
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+}
+
+TEST(DocumentConstruction, FromBsonLazyOutlivesUnownedSource) {
+    Document document;
+    {
+        BSONObj owned = BSON("a" << BSON("b" << 1));
+        document = Document::fromBsonLazy(BSONObj(owned.objdata()));
+    }
+    ASSERT_EQUALS(1, document.getNestedField(FieldPath("a.b")).getInt());
+}
+
+TEST(DocumentConstruction, FromBsonLazyCanBeModified) {
+    Document original = Document::fromBsonLazy(BSON("a" << 1 << "b" << BSON("c" << 2)));
+    MutableDocument md(original);
+    md.setNestedField(FieldPath("b.d"), mongo::Value(3));
+    md.addField("e", mongo::Value(4));
+    Document modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 2) << "e" << 4), original.toBson());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 2 << "d" << 3) << "e" << 4),
+                      modified.toBson());
+}
+
+TEST(DocumentConstruction, FromBsonWithMetaDataIsLazyOnlyWithoutMetaData) {
+    BSONObj plain = BSON("a" << 1);
+    ASSERT_DOCUMENT_EQ(fromBson(plain), Document::fromBsonWithMetaData(plain));
+
+    Document withMeta = Document::fromBsonWithMetaData(BSON("a" << 1 << "$textScore" << 2.0));
+    ASSERT_TRUE(withMeta.hasTextScore());
+    ASSERT_EQUALS(2.0, withMeta.getTextScore());
+    ASSERT_BSONOBJ_EQ(plain, withMeta.toBson());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -164,6 +164,15 @@ public:
         return tailableMode == TailableMode::kTailableAndAwaitData;
     }
 
+    /**
+     * Returns true if blocking stages which exceed their memory limit may spill to files under
+     * 'tempDir'. mongos can only spill if it has been configured with a directory for temporary
+     * files.
+     */
+    bool canSpillToDisk() const {
+        return allowDiskUse && (!inMongos || !tempDir.empty());
+    }
+
     // The explain verbosity requested by the user, or boost::none if no explain was requested.
     boost::optional<ExplainOptions::Verbosity> explain;
 
@@ -176,9 +185,14 @@ public:
     bool allowDiskUse = false;
     bool bypassDocumentValidation = false;
 
+    // Set on the ExpressionContext of a shard-local $lookup's foreign sub-pipeline, whose foreign
+    // collection is sharded identically to the local collection. Allows the sub-pipeline to read
+    // the documents of the sharded foreign collection which are owned by this shard.
+    bool colocatedForeignCollection = false;
+
     NamespaceString ns;
     boost::optional<UUID> uuid;
-    std::string tempDir;  // Defaults to empty to prevent external sorting in mongos.
+    std::string tempDir;  // Empty in mongos unless internalQueryMongosTempDir is set.
 
     OperationContext* opCtx;
 
@@ -99,9 +99,25 @@ public:
                            const NamespaceString& ns,
                            const std::vector<BSONObj>& objs) = 0;
 
+    /**
+     * Replaces the document in 'ns' with the same _id as each of 'objs', inserting it if no such
+     * document exists. Every element of 'objs' must have an _id. Returns the "detailed" last error
+     * object of the first write that failed, or of the last write if all succeeded.
+     */
+    virtual BSONObj upsert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                           const NamespaceString& ns,
+                           const std::vector<BSONObj>& objs) = 0;
+
     virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                   const NamespaceString& ns) = 0;
 
+    /**
+     * Returns one document per query shape whose execution statistics are kept for collection
+     * "ns", or none if the collection does not exist.
+     */
+    virtual std::vector<BSONObj> getQueryStats(OperationContext* opCtx,
+                                               const NamespaceString& ns) = 0;
+
     /**
      * Appends operation latency statistics for collection "nss" to "builder"
      */
@@ -118,6 +134,14 @@ public:
                                       const BSONObj& param,
                                       BSONObjBuilder* builder) const = 0;
 
+    /**
+     * Appends storage engine cache residency and I/O statistics for collection "nss" and each of
+     * its indexes to "builder".
+     */
+    virtual Status appendCacheStats(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    BSONObjBuilder* builder) const = 0;
+
     /**
      * Appends the record count for collection "nss" to "builder".
      */
@@ -200,11 +224,37 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern) = 0;
 
+    /**
+     * Returns the documents matching 'filter', which matches at most 'maxResults' documents, in no
+     * particular order. Used to look up the documents for many document keys with one query. To
+     * bound the size of the reply, fewer than all matching documents may be returned; callers can
+     * look up the remaining ones individually with lookupSingleDocument(). Returns no documents if
+     * the given namespace does not exist.
+     */
+    virtual std::vector<Document> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const BSONObj& filter,
+        long long maxResults,
+        boost::optional<BSONObj> readConcern) = 0;
+
     /**
      * Returns a vector of all local cursors.
      */
     virtual std::vector<GenericCursor> getCursors(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const = 0;
+
+    /**
+     * Returns the lock waits currently kept by the LockContentionSampler, oldest first, with the
+     * namespace of each database or collection resource filled in where it can be determined.
+     */
+    virtual std::vector<BSONObj> getLockContentionSamples(OperationContext* opCtx) const = 0;
+
+    /**
+     * Returns the slow operations currently kept by the SlowOpRecorder, oldest first.
+     */
+    virtual std::vector<BSONObj> getSlowOps(OperationContext* opCtx) const = 0;
 };
 
 }  // namespace mongo
@@ -659,8 +659,9 @@ Status Pipeline::_pipelineCanRunOnMongoS() const {
 
         const bool mustWriteToDisk =
             (constraints.diskRequirement == DiskUseRequirement::kWritesPersistentData);
+        // A mongoS with a directory for temporary files can spill just like a shard.
         const bool mayWriteTmpDataAndDiskUseIsAllowed =
-            (pCtx->allowDiskUse &&
+            (pCtx->allowDiskUse && !(pCtx->inMongos && pCtx->canSpillToDisk()) &&
              constraints.diskRequirement == DiskUseRequirement::kWritesTmpData);
         const bool needsDisk = (mustWriteToDisk || mayWriteTmpDataAndDiskUseIsAllowed);
 
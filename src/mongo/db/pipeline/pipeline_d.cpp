@@ -41,6 +41,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_contention_sampler.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -55,6 +56,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -64,14 +66,18 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/parsed_distinct.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/fill_locker_info.h"
+#include "mongo/db/stats/slow_op_recorder.h"
 #include "mongo/db/stats/storage_stats.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/record_store.h"
@@ -95,6 +101,78 @@ using std::unique_ptr;
 
 namespace {
 
+/**
+ * A RecordCursor which follows each record returned by a random cursor with up to 'blockSize' - 1
+ * of the records stored after it, read through a second, sequential cursor. Each block starts at a
+ * record chosen by the random cursor, so every record is as likely to appear in the sample as it
+ * would be under per-record random sampling; records are merely grouped. Blocks which overlap
+ * produce duplicates, which $sampleFromRandomCursor already discards.
+ */
+class BlockSamplingCursor final : public RecordCursor {
+public:
+    BlockSamplingCursor(std::unique_ptr<RecordCursor> randomCursor,
+                        std::unique_ptr<SeekableRecordCursor> sequentialCursor,
+                        int blockSize)
+        : _randomCursor(std::move(randomCursor)),
+          _sequentialCursor(std::move(sequentialCursor)),
+          _blockSize(blockSize) {}
+
+    boost::optional<Record> next() final {
+        if (_remainingInBlock > 0) {
+            if (auto record = _sequentialCursor->next()) {
+                --_remainingInBlock;
+                return record;
+            }
+            // The block ran off the end of the collection.
+            _remainingInBlock = 0;
+        }
+
+        auto record = _randomCursor->next();
+        if (!record) {
+            return {};
+        }
+
+        // Position the sequential cursor on the chosen record so that the rest of the block is
+        // read from the same storage page(s) rather than by further random seeks.
+        _remainingInBlock = _sequentialCursor->seekExact(record->id) ? _blockSize - 1 : 0;
+        return record;
+    }
+
+    void save() final {
+        _randomCursor->save();
+        _sequentialCursor->save();
+    }
+
+    bool restore() final {
+        const bool randomRestored = _randomCursor->restore();
+        if (!_sequentialCursor->restore()) {
+            _remainingInBlock = 0;
+        }
+        return randomRestored;
+    }
+
+    void detachFromOperationContext() final {
+        _randomCursor->detachFromOperationContext();
+        _sequentialCursor->detachFromOperationContext();
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _randomCursor->reattachToOperationContext(opCtx);
+        _sequentialCursor->reattachToOperationContext(opCtx);
+    }
+
+    void invalidate(OperationContext* opCtx, const RecordId& id) final {
+        _randomCursor->invalidate(opCtx, id);
+        _sequentialCursor->invalidate(opCtx, id);
+    }
+
+private:
+    const std::unique_ptr<RecordCursor> _randomCursor;
+    const std::unique_ptr<SeekableRecordCursor> _sequentialCursor;
+    const int _blockSize;
+    int _remainingInBlock = 0;
+};
+
 /**
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
@@ -102,8 +180,11 @@ namespace {
  */
 StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorExecutor(
     Collection* collection, OperationContext* opCtx, long long sampleSize, long long numRecords) {
+    // The limit bounds the number of random seeks, beyond which duplicates become common enough
+    // that a scan is cheaper. When sampling in blocks only one seek is made per block.
     double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
+    const int blockSize = std::max(1, internalDocumentSourceSampleBlockSize.load());
+    if (sampleSize / blockSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
         return {nullptr};
     }
 
@@ -111,6 +192,10 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
     // random cursors, attempt to get one from the _id index.
     std::unique_ptr<RecordCursor> rsRandCursor =
         collection->getRecordStore()->getRandomCursor(opCtx);
+    if (rsRandCursor && blockSize > 1) {
+        rsRandCursor = stdx::make_unique<BlockSamplingCursor>(
+            std::move(rsRandCursor), collection->getRecordStore()->getCursor(opCtx), blockSize);
+    }
 
     auto ws = stdx::make_unique<WorkingSet>();
     std::unique_ptr<PlanStage> stage;
@@ -218,6 +303,74 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
         opCtx, collection, nss, std::move(cq.getValue()), PlanExecutor::YIELD_AUTO, plannerOpts);
 }
 
+/**
+ * If the first stage of 'sources' is a $group which outputs the distinct values of a field, and the
+ * query system can answer 'queryObj' with a DISTINCT_SCAN over an index on that field, returns a
+ * PlanExecutor which produces one document for each distinct value. The $group stays in the
+ * pipeline to build its output from those documents. Otherwise returns nullptr.
+ */
+unique_ptr<PlanExecutor, PlanExecutor::Deleter> attemptToGetDistinctExecutor(
+    OperationContext* opCtx,
+    Collection* collection,
+    const NamespaceString& nss,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    const Pipeline::SourceContainer& sources,
+    bool oplogReplay,
+    const BSONObj& queryObj,
+    const AggregationRequest* aggRequest) {
+    if (!collection || sources.empty() || oplogReplay ||
+        pExpCtx->tailableMode != TailableMode::kNormal ||
+        DocumentSourceMatch::isTextQuery(queryObj)) {
+        return nullptr;
+    }
+
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+    if (!groupStage) {
+        return nullptr;
+    }
+    const auto distinctField = groupStage->getDistinctFieldPath();
+    if (!distinctField) {
+        return nullptr;
+    }
+
+    if (aggRequest && !aggRequest->getHint().isEmpty()) {
+        // Respect the user's choice of index.
+        return nullptr;
+    }
+
+    if (ShardingState::get(opCtx)->needCollectionMetadata(opCtx, nss.ns())) {
+        // A distinct plan does not filter out orphaned documents.
+        return nullptr;
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(queryObj);
+    qr->setCollation(pExpCtx->getCollator() ? pExpCtx->getCollator()->getSpec().toBSON()
+                                            : pExpCtx->collation);
+    if (aggRequest) {
+        qr->setExplain(static_cast<bool>(aggRequest->getExplain()));
+    }
+
+    const ExtensionsCallbackReal extensionsCallback(pExpCtx->opCtx, &nss);
+    auto cq = CanonicalQuery::canonicalize(
+        opCtx, std::move(qr), pExpCtx, extensionsCallback, Pipeline::kAllowedMatcherFeatures);
+    if (!cq.isOK()) {
+        return nullptr;
+    }
+
+    ParsedDistinct parsedDistinct(std::move(cq.getValue()), *distinctField);
+    auto swExec = getExecutorDistinct(opCtx,
+                                      collection,
+                                      nss.ns(),
+                                      &parsedDistinct,
+                                      PlanExecutor::YIELD_AUTO,
+                                      QueryPlannerParams::STRICT_DISTINCT_ONLY);
+    if (!swExec.isOK()) {
+        return nullptr;
+    }
+    return std::move(swExec.getValue());
+}
+
 BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     if (!projectionObj[Document::metaFieldSortKey]) {
         return projectionObj;
@@ -308,6 +461,17 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    if (!sortStage) {
+        // A $group on the distinct values of an indexed field can skip all but one index key for
+        // each value.
+        auto distinctExec = attemptToGetDistinctExecutor(
+            expCtx->opCtx, collection, nss, expCtx, sources, oplogReplay, queryObj, aggRequest);
+        if (distinctExec) {
+            addCursorSource(collection, pipeline, expCtx, std::move(distinctExec), deps, queryObj);
+            return;
+        }
+    }
+
     // Create the PlanExecutor.
     auto exec = uassertStatusOK(prepareExecutor(expCtx->opCtx,
                                                 collection,
@@ -603,6 +767,24 @@ BSONObj PipelineD::MongoDInterface::insert(const boost::intrusive_ptr<Expression
     return _client.getLastErrorDetailed();
 }
 
+BSONObj PipelineD::MongoDInterface::upsert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                           const NamespaceString& ns,
+                                           const std::vector<BSONObj>& objs) {
+    boost::optional<DisableDocumentValidation> maybeDisableValidation;
+    if (expCtx->bypassDocumentValidation)
+        maybeDisableValidation.emplace(expCtx->opCtx);
+
+    BSONObj err;
+    for (auto&& obj : objs) {
+        _client.update(ns.ns(), Query(BSON("_id" << obj["_id"])), obj, true /*upsert*/);
+        err = _client.getLastErrorDetailed();
+        if (!DBClientBase::getLastErrorString(err).empty()) {
+            break;
+        }
+    }
+    return err;
+}
+
 CollectionIndexUsageMap PipelineD::MongoDInterface::getIndexStats(OperationContext* opCtx,
                                                                   const NamespaceString& ns) {
     AutoGetCollectionForReadCommand autoColl(opCtx, ns);
@@ -616,6 +798,19 @@ CollectionIndexUsageMap PipelineD::MongoDInterface::getIndexStats(OperationConte
     return collection->infoCache()->getIndexUsageStats();
 }
 
+std::vector<BSONObj> PipelineD::MongoDInterface::getQueryStats(OperationContext* opCtx,
+                                                              const NamespaceString& ns) {
+    AutoGetCollectionForReadCommand autoColl(opCtx, ns);
+
+    Collection* collection = autoColl.getCollection();
+    if (!collection) {
+        LOG(2) << "Collection not found on query stats retrieval: " << ns.ns();
+        return {};
+    }
+
+    return collection->infoCache()->getQueryStats()->getStats();
+}
+
 void PipelineD::MongoDInterface::appendLatencyStats(OperationContext* opCtx,
                                                     const NamespaceString& nss,
                                                     bool includeHistograms,
@@ -630,6 +825,12 @@ Status PipelineD::MongoDInterface::appendStorageStats(OperationContext* opCtx,
     return appendCollectionStorageStats(opCtx, nss, param, builder);
 }
 
+Status PipelineD::MongoDInterface::appendCacheStats(OperationContext* opCtx,
+                                                    const NamespaceString& nss,
+                                                    BSONObjBuilder* builder) const {
+    return appendCollectionCacheStats(opCtx, nss, builder);
+}
+
 Status PipelineD::MongoDInterface::appendRecordCount(OperationContext* opCtx,
                                                      const NamespaceString& nss,
                                                      BSONObjBuilder* builder) const {
@@ -722,10 +923,14 @@ Status PipelineD::MongoDInterface::attachCursorSourceToPipeline(
     // until after we release the lock, leaving room for a collection to be sharded inbetween.
     // TODO SERVER-24960: Use CollectionShardingState::collectionIsSharded() to confirm sharding
     // state.
+    //
+    // The exception is the foreign collection of a shard-local $lookup, which mongos verified to be
+    // sharded identically to the local collection. Reads of the sub-pipeline are filtered by this
+    // shard's metadata for the foreign collection, because the operation is versioned.
     auto css = CollectionShardingState::get(expCtx->opCtx, expCtx->ns);
     uassert(4567,
             str::stream() << "from collection (" << expCtx->ns.ns() << ") cannot be sharded",
-            !bool(css->getMetadata()));
+            !bool(css->getMetadata()) || expCtx->colocatedForeignCollection);
 
     PipelineD::prepareCursorSource(autoColl->getCollection(), expCtx->ns, nullptr, pipeline);
 
@@ -855,6 +1060,41 @@ std::vector<GenericCursor> PipelineD::MongoDInterface::getCursors(
     return CursorManager::getAllCursors(expCtx->opCtx);
 }
 
+std::vector<BSONObj> PipelineD::MongoDInterface::getLockContentionSamples(
+    OperationContext* opCtx) const {
+    auto samples = LockContentionSampler::get().getSamples();
+
+    // Resource ids are hashes of the namespace, so recover the names by hashing every namespace
+    // that Top has seen operations on. The contended collections are all but certain to be
+    // there, and this avoids taking any locks.
+    Top::UsageMap usage;
+    Top::get(opCtx->getServiceContext()).cloneMap(usage);
+    std::map<ResourceId, std::string> names;
+    for (const auto& entry : usage) {
+        const std::string& ns = entry.first;
+        names.emplace(ResourceId(RESOURCE_COLLECTION, ns), ns);
+        const auto db = nsToDatabase(ns);
+        names.emplace(ResourceId(RESOURCE_DATABASE, db), db);
+    }
+
+    std::vector<BSONObj> results;
+    results.reserve(samples.size());
+    for (const auto& sample : samples) {
+        BSONObjBuilder builder;
+        builder.appendElements(sample.toBSON());
+        auto it = names.find(sample.resId);
+        if (it != names.end()) {
+            builder.append("ns", it->second);
+        }
+        results.push_back(builder.obj());
+    }
+    return results;
+}
+
+std::vector<BSONObj> PipelineD::MongoDInterface::getSlowOps(OperationContext* opCtx) const {
+    return SlowOpRecorder::get(opCtx->getServiceContext()).getEntries();
+}
+
 boost::optional<Document> PipelineD::MongoDInterface::lookupSingleDocument(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     const NamespaceString& nss,
@@ -887,6 +1127,33 @@ boost::optional<Document> PipelineD::MongoDInterface::lookupSingleDocument(
     return lookedUpDocument;
 }
 
+std::vector<Document> PipelineD::MongoDInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filter,
+    long long maxResults,
+    boost::optional<BSONObj> readConcern) {
+    invariant(!readConcern);  // We don't currently support a read concern on mongod - it's only
+                              // expected to be necessary on mongos.
+
+    // Be sure to do the lookup using the collection default collation.
+    auto foreignExpCtx = expCtx->copyWith(
+        nss, collectionUUID, _getCollectionDefaultCollator(expCtx->opCtx, nss, collectionUUID));
+    auto swPipeline = makePipeline({BSON("$match" << filter)}, foreignExpCtx);
+    if (swPipeline == ErrorCodes::NamespaceNotFound) {
+        return {};
+    }
+    auto pipeline = uassertStatusOK(std::move(swPipeline));
+
+    // The results are not sent anywhere, so there is no reply size to bound: return all of them.
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return lookedUpDocuments;
+}
+
 std::unique_ptr<CollatorInterface> PipelineD::MongoDInterface::_getCollectionDefaultCollator(
     OperationContext* opCtx, const NamespaceString& nss, UUID collectionUUID) {
     if (_collatorCache.find(collectionUUID) == _collatorCache.end()) {
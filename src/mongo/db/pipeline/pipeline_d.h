@@ -71,8 +71,13 @@ public:
         BSONObj insert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                        const NamespaceString& ns,
                        const std::vector<BSONObj>& objs) final;
+        BSONObj upsert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       const NamespaceString& ns,
+                       const std::vector<BSONObj>& objs) final;
         CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                               const NamespaceString& ns) final;
+        std::vector<BSONObj> getQueryStats(OperationContext* opCtx,
+                                           const NamespaceString& ns) final;
         void appendLatencyStats(OperationContext* opCtx,
                                 const NamespaceString& nss,
                                 bool includeHistograms,
@@ -81,6 +86,9 @@ public:
                                   const NamespaceString& nss,
                                   const BSONObj& param,
                                   BSONObjBuilder* builder) const final;
+        Status appendCacheStats(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final;
         Status appendRecordCount(OperationContext* opCtx,
                                  const NamespaceString& nss,
                                  BSONObjBuilder* builder) const final;
@@ -111,8 +119,16 @@ public:
             UUID collectionUUID,
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
+        std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                              const NamespaceString& nss,
+                                              UUID collectionUUID,
+                                              const BSONObj& filter,
+                                              long long maxResults,
+                                              boost::optional<BSONObj> readConcern) final;
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
+        std::vector<BSONObj> getLockContentionSamples(OperationContext* opCtx) const final;
+        std::vector<BSONObj> getSlowOps(OperationContext* opCtx) const final;
 
     private:
         /**
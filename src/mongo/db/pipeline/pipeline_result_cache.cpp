@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/pipeline_result_cache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+
+namespace mongo {
+namespace {
+const auto getPipelineResultCache = ServiceContext::declareDecoration<PipelineResultCache>();
+
+// Stages whose output depends only on their input documents and the pipeline definition. Before
+// adding a stage here, make sure it neither reads another collection nor produces different
+// results for the same input.
+const std::set<StringData> kCacheableStages = {"$addFields",
+                                               "$bucketAuto",
+                                               "$group",
+                                               "$limit",
+                                               "$match",
+                                               "$project",
+                                               "$redact",
+                                               "$replaceRoot",
+                                               "$skip",
+                                               "$sort",
+                                               "$unwind"};
+}  // namespace
+
+void PipelineResultCacheObserver::onInserts(OperationContext* opCtx,
+                                            const NamespaceString& nss,
+                                            OptionalCollectionUUID uuid,
+                                            std::vector<InsertStatement>::const_iterator begin,
+                                            std::vector<InsertStatement>::const_iterator end,
+                                            bool fromMigrate) {
+    PipelineResultCache::get(opCtx).notifyOfWrite(opCtx, nss);
+}
+
+void PipelineResultCacheObserver::onUpdate(OperationContext* opCtx,
+                                           const OplogUpdateEntryArgs& args) {
+    PipelineResultCache::get(opCtx).notifyOfWrite(opCtx, args.nss);
+}
+
+void PipelineResultCacheObserver::onDelete(OperationContext* opCtx,
+                                           const NamespaceString& nss,
+                                           OptionalCollectionUUID uuid,
+                                           StmtId stmtId,
+                                           bool fromMigrate,
+                                           const boost::optional<BSONObj>& deletedDoc) {
+    PipelineResultCache::get(opCtx).notifyOfWrite(opCtx, nss);
+}
+
+void PipelineResultCacheObserver::onDropDatabase(OperationContext* opCtx,
+                                                 const std::string& dbName) {
+    PipelineResultCache::get(opCtx).notifyOfDropDatabase(dbName);
+}
+
+repl::OpTime PipelineResultCacheObserver::onDropCollection(OperationContext* opCtx,
+                                                           const NamespaceString& collectionName,
+                                                           OptionalCollectionUUID uuid) {
+    PipelineResultCache::get(opCtx).notifyOfWrite(opCtx, collectionName);
+    return {};
+}
+
+repl::OpTime PipelineResultCacheObserver::onRenameCollection(OperationContext* opCtx,
+                                                             const NamespaceString& fromCollection,
+                                                             const NamespaceString& toCollection,
+                                                             OptionalCollectionUUID uuid,
+                                                             bool dropTarget,
+                                                             OptionalCollectionUUID dropTargetUUID,
+                                                             bool stayTemp) {
+    auto& cache = PipelineResultCache::get(opCtx);
+    cache.notifyOfWrite(opCtx, fromCollection);
+    cache.notifyOfWrite(opCtx, toCollection);
+    return {};
+}
+
+void PipelineResultCacheObserver::onEmptyCapped(OperationContext* opCtx,
+                                                const NamespaceString& collectionName,
+                                                OptionalCollectionUUID uuid) {
+    PipelineResultCache::get(opCtx).notifyOfWrite(opCtx, collectionName);
+}
+
+PipelineResultCache& PipelineResultCache::get(ServiceContext* service) {
+    return getPipelineResultCache(service);
+}
+
+PipelineResultCache& PipelineResultCache::get(OperationContext* opCtx) {
+    return getPipelineResultCache(opCtx->getServiceContext());
+}
+
+bool PipelineResultCache::isEnabled() {
+    return internalPipelineResultCacheMaxBytes.load() > 0;
+}
+
+bool PipelineResultCache::isCacheable(const Pipeline& pipeline) {
+    const auto& sources = pipeline.getSources();
+    return std::all_of(sources.begin(), sources.end(), [](const auto& source) {
+        return kCacheableStages.count(source->getSourceName()) > 0;
+    });
+}
+
+std::string PipelineResultCache::makeKey(const NamespaceString& nss,
+                                         const Pipeline& pipeline,
+                                         const CollatorInterface* collator) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", nss.ns());
+    {
+        BSONArrayBuilder stages(keyBuilder.subarrayStart("pipeline"));
+        for (auto&& stage : pipeline.serialize()) {
+            stage.addToBsonArray(&stages);
+        }
+    }
+    keyBuilder.append("collation", collator ? collator->getSpec().toBSON() : BSONObj());
+
+    const BSONObj key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+uint64_t PipelineResultCache::getWriteGeneration(const NamespaceString& nss) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _writeGenerations.find(nss.ns());
+    return it == _writeGenerations.end() ? 0 : it->second;
+}
+
+void PipelineResultCache::notifyOfWrite(OperationContext* opCtx, const NamespaceString& nss) {
+    // Advancing the generation before the write is visible would let an aggregation which started
+    // in between cache results that do not include the write under the new generation.
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit([this, nss] { bumpWriteGeneration(nss); });
+    } else {
+        bumpWriteGeneration(nss);
+    }
+}
+
+void PipelineResultCache::notifyOfDropDatabase(StringData dbName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& generation : _writeGenerations) {
+        if (nsToDatabaseSubstring(generation.first) == dbName) {
+            ++generation.second;
+        }
+    }
+
+    // Entries for collections which were never written to are at generation zero, which has no
+    // entry above to advance, so remove them directly.
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.nss.db() == dbName) {
+            _bytesUsed -= it->second.bytes;
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PipelineResultCache::bumpWriteGeneration(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_writeGenerations[nss.ns()];
+}
+
+boost::optional<std::vector<BSONObj>> PipelineResultCache::find(const std::string& key,
+                                                                const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return boost::none;
+    }
+
+    auto generation = _writeGenerations.find(nss.ns());
+    const uint64_t currentGeneration =
+        generation == _writeGenerations.end() ? 0 : generation->second;
+    if (it->second.writeGeneration != currentGeneration) {
+        // The entry can never be served again.
+        _bytesUsed -= it->second.bytes;
+        _entries.erase(it);
+        return boost::none;
+    }
+    return it->second.results;
+}
+
+void PipelineResultCache::add(const std::string& key,
+                              const NamespaceString& nss,
+                              uint64_t writeGeneration,
+                              std::vector<BSONObj> results) {
+    const long long maxBytes = internalPipelineResultCacheMaxBytes.load();
+    if (maxBytes <= 0) {
+        return;
+    }
+
+    size_t bytes = key.size();
+    for (auto&& result : results) {
+        bytes += result.objsize();
+    }
+    if (bytes > static_cast<size_t>(maxBytes)) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto generation = _writeGenerations.find(nss.ns());
+    const uint64_t currentGeneration =
+        generation == _writeGenerations.end() ? 0 : generation->second;
+    if (writeGeneration != currentGeneration) {
+        return;
+    }
+
+    auto existing = _entries.cfind(key);
+    if (existing != _entries.cend()) {
+        _bytesUsed -= existing->second.bytes;
+    }
+    _entries.add(key, Entry{nss, writeGeneration, std::move(results), bytes});
+    _bytesUsed += bytes;
+    evict_inlock(maxBytes);
+}
+
+void PipelineResultCache::evict_inlock(size_t maxBytes) {
+    while (_bytesUsed > maxBytes) {
+        invariant(!_entries.empty());
+        auto leastRecentlyUsed = std::prev(_entries.end());
+        _bytesUsed -= leastRecentlyUsed->second.bytes;
+        _entries.erase(leastRecentlyUsed);
+    }
+}
+
+void PipelineResultCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.clear();
+    _bytesUsed = 0;
+}
+
+size_t PipelineResultCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+size_t PipelineResultCache::bytesUsed() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _bytesUsed;
+}
+
+}  // namespace mongo
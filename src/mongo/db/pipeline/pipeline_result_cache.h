@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class CollatorInterface;
+class OperationContext;
+class Pipeline;
+class ServiceContext;
+
+/**
+ * Notifies the PipelineResultCache of every committed write to a collection, so that cached
+ * results computed before the write are no longer served.
+ */
+class PipelineResultCacheObserver : public OpObserver {
+public:
+    void onCreateIndex(OperationContext* opCtx,
+                       const NamespaceString& nss,
+                       OptionalCollectionUUID uuid,
+                       BSONObj indexDoc,
+                       bool fromMigrate) override {}
+    void onInserts(OperationContext* opCtx,
+                   const NamespaceString& nss,
+                   OptionalCollectionUUID uuid,
+                   std::vector<InsertStatement>::const_iterator begin,
+                   std::vector<InsertStatement>::const_iterator end,
+                   bool fromMigrate) override;
+    void onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) override;
+    void aboutToDelete(OperationContext* opCtx,
+                       const NamespaceString& nss,
+                       const BSONObj& doc) override {}
+    void onDelete(OperationContext* opCtx,
+                  const NamespaceString& nss,
+                  OptionalCollectionUUID uuid,
+                  StmtId stmtId,
+                  bool fromMigrate,
+                  const boost::optional<BSONObj>& deletedDoc) override;
+    void onInternalOpMessage(OperationContext* opCtx,
+                             const NamespaceString& nss,
+                             const boost::optional<UUID> uuid,
+                             const BSONObj& msgObj,
+                             const boost::optional<BSONObj> o2MsgObj) override {}
+    void onCreateCollection(OperationContext* opCtx,
+                            Collection* coll,
+                            const NamespaceString& collectionName,
+                            const CollectionOptions& options,
+                            const BSONObj& idIndex) override {}
+    void onCollMod(OperationContext* opCtx,
+                   const NamespaceString& nss,
+                   OptionalCollectionUUID uuid,
+                   const BSONObj& collModCmd,
+                   const CollectionOptions& oldCollOptions,
+                   boost::optional<TTLCollModInfo> ttlInfo) override {}
+    void onDropDatabase(OperationContext* opCtx, const std::string& dbName) override;
+    repl::OpTime onDropCollection(OperationContext* opCtx,
+                                  const NamespaceString& collectionName,
+                                  OptionalCollectionUUID uuid) override;
+    void onDropIndex(OperationContext* opCtx,
+                     const NamespaceString& nss,
+                     OptionalCollectionUUID uuid,
+                     const std::string& indexName,
+                     const BSONObj& idxDescriptor) override {}
+    repl::OpTime onRenameCollection(OperationContext* opCtx,
+                                    const NamespaceString& fromCollection,
+                                    const NamespaceString& toCollection,
+                                    OptionalCollectionUUID uuid,
+                                    bool dropTarget,
+                                    OptionalCollectionUUID dropTargetUUID,
+                                    bool stayTemp) override;
+    void onApplyOps(OperationContext* opCtx,
+                    const std::string& dbName,
+                    const BSONObj& applyOpCmd) override {}
+    void onEmptyCapped(OperationContext* opCtx,
+                       const NamespaceString& collectionName,
+                       OptionalCollectionUUID uuid) override;
+};
+
+/**
+ * A cache of the complete results of aggregations, keyed on the namespace, the serialized
+ * optimized pipeline and the collation. Each entry records the write generation of its collection
+ * at the time the aggregation started, and is only served while that generation is current.
+ * Each collection's write generation is advanced whenever a write to it commits.
+ *
+ * The cache is disabled unless 'internalPipelineResultCacheMaxBytes' is positive, and evicts the
+ * least recently used entries to stay within that many bytes.
+ *
+ * This class is thread-safe.
+ */
+class PipelineResultCache {
+    MONGO_DISALLOW_COPYING(PipelineResultCache);
+
+public:
+    static PipelineResultCache& get(ServiceContext* service);
+    static PipelineResultCache& get(OperationContext* opCtx);
+
+    PipelineResultCache() = default;
+
+    /**
+     * Returns whether the cache is enabled by 'internalPipelineResultCacheMaxBytes'.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns whether the results of 'pipeline' can be cached. This is the case only if every
+     * stage of the pipeline is deterministic and reads nothing but its input documents.
+     */
+    static bool isCacheable(const Pipeline& pipeline);
+
+    /**
+     * Returns the cache key for running 'pipeline' against 'nss' with 'collator', which may be
+     * null for the simple collation. 'pipeline' should already be optimized, so that equivalent
+     * pipelines share an entry.
+     */
+    static std::string makeKey(const NamespaceString& nss,
+                               const Pipeline& pipeline,
+                               const CollatorInterface* collator);
+
+    /**
+     * Returns the current write generation of 'nss'.
+     */
+    uint64_t getWriteGeneration(const NamespaceString& nss) const;
+
+    /**
+     * Advances the write generation of 'nss' once the current WriteUnitOfWork of 'opCtx' commits.
+     */
+    void notifyOfWrite(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * Advances the write generation of every collection in 'dbName', and removes all of their
+     * cached results.
+     */
+    void notifyOfDropDatabase(StringData dbName);
+
+    /**
+     * Returns the results cached under 'key', or boost::none if there are none or they were
+     * computed before the latest write to 'nss'.
+     */
+    boost::optional<std::vector<BSONObj>> find(const std::string& key, const NamespaceString& nss);
+
+    /**
+     * Caches 'results' under 'key', as computed against 'nss' at 'writeGeneration'. The results
+     * are not cached if 'nss' has since been written to, or if they would not fit in the cache.
+     */
+    void add(const std::string& key,
+             const NamespaceString& nss,
+             uint64_t writeGeneration,
+             std::vector<BSONObj> results);
+
+    void clear();
+
+    size_t size() const;
+    size_t bytesUsed() const;
+
+private:
+    struct Entry {
+        NamespaceString nss;
+        uint64_t writeGeneration;
+        std::vector<BSONObj> results;
+        size_t bytes;
+    };
+
+    void bumpWriteGeneration(const NamespaceString& nss);
+
+    // Removes least recently used entries until no more than 'maxBytes' are used.
+    void evict_inlock(size_t maxBytes);
+
+    mutable stdx::mutex _mutex;
+
+    // The write generation of each collection written to since startup. A collection which has
+    // not been written to has generation zero.
+    StringMap<uint64_t> _writeGenerations;
+
+    // The cache is bounded by bytes rather than by number of entries.
+    LRUCache<std::string, Entry> _entries{std::numeric_limits<size_t>::max()};
+    size_t _bytesUsed = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/pipeline_result_cache.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using PipelineResultCacheTest = AggregationContextFixture;
+
+const NamespaceString kTestNss("unittests.pipeline_result_cache_test");
+
+std::unique_ptr<Pipeline, PipelineDeleter> parsePipeline(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const std::vector<BSONObj>& stages) {
+    auto pipeline = uassertStatusOK(Pipeline::parse(stages, expCtx));
+    pipeline->optimizePipeline();
+    return pipeline;
+}
+
+TEST_F(PipelineResultCacheTest, ReturnsResultsAddedAtCurrentWriteGeneration) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+    internalPipelineResultCacheMaxBytes.store(1024 * 1024);
+
+    PipelineResultCache cache;
+    cache.add("key", kTestNss, cache.getWriteGeneration(kTestNss), {BSON("a" << 1)});
+
+    auto results = cache.find("key", kTestNss);
+    ASSERT(results);
+    ASSERT_EQ(results->size(), 1U);
+    ASSERT_BSONOBJ_EQ(results->front(), BSON("a" << 1));
+    ASSERT_FALSE(cache.find("otherKey", kTestNss));
+}
+
+TEST_F(PipelineResultCacheTest, DoesNotCacheWhenDisabled) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+    internalPipelineResultCacheMaxBytes.store(0);
+
+    PipelineResultCache cache;
+    ASSERT_FALSE(PipelineResultCache::isEnabled());
+    cache.add("key", kTestNss, cache.getWriteGeneration(kTestNss), {BSON("a" << 1)});
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST_F(PipelineResultCacheTest, WriteInvalidatesResultsForThatCollectionOnly) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+    internalPipelineResultCacheMaxBytes.store(1024 * 1024);
+
+    const NamespaceString otherNss("unittests.other");
+    PipelineResultCache cache;
+    cache.add("key", kTestNss, cache.getWriteGeneration(kTestNss), {BSON("a" << 1)});
+    cache.add("otherKey", otherNss, cache.getWriteGeneration(otherNss), {BSON("b" << 1)});
+
+    cache.notifyOfWrite(getExpCtx()->opCtx, kTestNss);
+    ASSERT_FALSE(cache.find("key", kTestNss));
+    ASSERT(cache.find("otherKey", otherNss));
+    ASSERT_EQ(cache.size(), 1U);
+}
+
+TEST_F(PipelineResultCacheTest, DoesNotAddResultsComputedBeforeLatestWrite) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+    internalPipelineResultCacheMaxBytes.store(1024 * 1024);
+
+    PipelineResultCache cache;
+    const auto writeGeneration = cache.getWriteGeneration(kTestNss);
+    cache.notifyOfWrite(getExpCtx()->opCtx, kTestNss);
+    cache.add("key", kTestNss, writeGeneration, {BSON("a" << 1)});
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST_F(PipelineResultCacheTest, DropDatabaseInvalidatesResultsForItsCollections) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+    internalPipelineResultCacheMaxBytes.store(1024 * 1024);
+
+    const NamespaceString otherDbNss("otherdb.coll");
+    PipelineResultCache cache;
+    cache.add("key", kTestNss, cache.getWriteGeneration(kTestNss), {BSON("a" << 1)});
+    cache.add("otherKey", otherDbNss, cache.getWriteGeneration(otherDbNss), {BSON("b" << 1)});
+
+    cache.notifyOfDropDatabase(kTestNss.db());
+    ASSERT_FALSE(cache.find("key", kTestNss));
+    ASSERT(cache.find("otherKey", otherDbNss));
+}
+
+TEST_F(PipelineResultCacheTest, EvictsLeastRecentlyUsedEntriesToStayWithinMaxBytes) {
+    const auto originalMaxBytes = internalPipelineResultCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalPipelineResultCacheMaxBytes.store(originalMaxBytes); });
+
+    const BSONObj result = BSON("s" << std::string(100, 'x'));
+    const size_t entryBytes = std::string("key0").size() + result.objsize();
+    internalPipelineResultCacheMaxBytes.store(2 * entryBytes);
+
+    PipelineResultCache cache;
+    cache.add("key0", kTestNss, 0, {result});
+    cache.add("key1", kTestNss, 0, {result});
+    ASSERT_EQ(cache.bytesUsed(), 2 * entryBytes);
+
+    // Using 'key0' makes 'key1' the least recently used entry.
+    ASSERT(cache.find("key0", kTestNss));
+    cache.add("key2", kTestNss, 0, {result});
+    ASSERT_EQ(cache.size(), 2U);
+    ASSERT_EQ(cache.bytesUsed(), 2 * entryBytes);
+    ASSERT(cache.find("key0", kTestNss));
+    ASSERT_FALSE(cache.find("key1", kTestNss));
+    ASSERT(cache.find("key2", kTestNss));
+
+    // Results larger than the whole cache are never added.
+    cache.add("big", kTestNss, 0, {result, result, result});
+    ASSERT_FALSE(cache.find("big", kTestNss));
+    ASSERT_EQ(cache.size(), 2U);
+}
+
+TEST_F(PipelineResultCacheTest, OnlyDeterministicSingleCollectionPipelinesAreCacheable) {
+    auto expCtx = getExpCtx();
+    ASSERT(PipelineResultCache::isCacheable(*parsePipeline(
+        expCtx,
+        {fromjson("{$match: {a: {$gt: 1}}}"),
+         fromjson("{$group: {_id: '$b', total: {$sum: '$a'}}}"),
+         fromjson("{$sort: {total: -1}}"),
+         fromjson("{$limit: 10}")})));
+    ASSERT_FALSE(PipelineResultCache::isCacheable(
+        *parsePipeline(expCtx, {fromjson("{$match: {a: 1}}"), fromjson("{$sample: {size: 5}}")})));
+}
+
+TEST_F(PipelineResultCacheTest, KeyDistinguishesNamespacePipelineAndCollation) {
+    auto expCtx = getExpCtx();
+    auto pipeline = parsePipeline(expCtx, {fromjson("{$match: {a: 1}}")});
+    auto otherPipeline = parsePipeline(expCtx, {fromjson("{$match: {a: 2}}")});
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+
+    const auto key = PipelineResultCache::makeKey(kTestNss, *pipeline, nullptr);
+    ASSERT_EQ(key, PipelineResultCache::makeKey(kTestNss, *pipeline, nullptr));
+    ASSERT_NE(key, PipelineResultCache::makeKey(kTestNss, *otherPipeline, nullptr));
+    ASSERT_NE(key,
+              PipelineResultCache::makeKey(NamespaceString("unittests.other"), *pipeline, nullptr));
+    ASSERT_NE(key, PipelineResultCache::makeKey(kTestNss, *pipeline, &collator));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -2227,6 +2227,24 @@ TEST_F(PipelineMustRunOnMongoSTest, UnsplittableMongoSPipelineAssertsIfDisallowe
         pipeline->requiredToRunOnMongos(), AssertionException, ErrorCodes::IllegalOperation);
 }
 
+TEST_F(PipelineMustRunOnMongoSTest, UnsplittableMongoSPipelineMaySpillWithTempDir) {
+    auto expCtx = getExpCtx();
+
+    expCtx->allowDiskUse = true;
+    expCtx->inMongos = true;
+    expCtx->tempDir = "/tmp/mongos";
+
+    auto match = DocumentSourceMatch::create(fromjson("{x: 5}"), expCtx);
+    auto runOnMongoS = DocumentSourceMustRunOnMongoS::create();
+    auto sort = DocumentSourceSort::create(expCtx, fromjson("{x: 1}"));
+
+    auto pipeline = uassertStatusOK(Pipeline::create({match, runOnMongoS, sort}, expCtx));
+    pipeline->optimizePipeline();
+
+    // A mongoS with a directory for temporary files can run a $sort which may spill.
+    ASSERT_TRUE(pipeline->requiredToRunOnMongos());
+}
+
 DEATH_TEST_F(PipelineMustRunOnMongoSTest,
              SplittablePipelineMustMergeOnMongoSAfterSplit,
              "invariant") {
@@ -63,11 +63,22 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj upsert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                   const NamespaceString& ns,
+                   const std::vector<BSONObj>& objs) override {
+        MONGO_UNREACHABLE;
+    }
+
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                           const NamespaceString& ns) override {
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getQueryStats(OperationContext* opCtx,
+                                       const NamespaceString& ns) override {
+        MONGO_UNREACHABLE;
+    }
+
     void appendLatencyStats(OperationContext* opCtx,
                             const NamespaceString& nss,
                             bool includeHistograms,
@@ -82,6 +93,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status appendCacheStats(OperationContext* opCtx,
+                            const NamespaceString& nss,
+                            BSONObjBuilder* builder) const override {
+        MONGO_UNREACHABLE;
+    }
+
     Status appendRecordCount(OperationContext* opCtx,
                              const NamespaceString& nss,
                              BSONObjBuilder* builder) const override {
@@ -139,9 +156,26 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                          const NamespaceString& nss,
+                                          UUID collectionUUID,
+                                          const BSONObj& filter,
+                                          long long maxResults,
+                                          boost::optional<BSONObj> readConcern) override {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<GenericCursor> getCursors(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const {
         MONGO_UNREACHABLE;
     }
+
+    std::vector<BSONObj> getLockContentionSamples(OperationContext* opCtx) const override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<BSONObj> getSlowOps(OperationContext* opCtx) const override {
+        MONGO_UNREACHABLE;
+    }
 };
 }  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/blocking_memory_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/db/curop.h"
+#include "mongo/db/query/query_knobs.h"
+
+namespace mongo {
+
+namespace {
+BlockingMemoryTracker globalBlockingMemoryTracker;
+}  // namespace
+
+BlockingMemoryTracker* BlockingMemoryTracker::get() {
+    return &globalBlockingMemoryTracker;
+}
+
+BlockingMemoryTracker::Reservation::Reservation(BlockingMemoryTracker* tracker)
+    : _tracker(tracker) {}
+
+BlockingMemoryTracker::Reservation::~Reservation() {
+    if (_bytes > 0) {
+        _tracker->_totalBytes.subtractAndFetch(static_cast<long long>(_bytes));
+        _tracker->_numConsumers.subtractAndFetch(1);
+    }
+}
+
+void BlockingMemoryTracker::Reservation::set(OperationContext* opCtx, size_t bytes) {
+    const long long delta = static_cast<long long>(bytes) - static_cast<long long>(_bytes);
+    if (delta != 0) {
+        _tracker->_totalBytes.addAndFetch(delta);
+        if (_bytes == 0) {
+            _tracker->_numConsumers.addAndFetch(1);
+        } else if (bytes == 0) {
+            _tracker->_numConsumers.subtractAndFetch(1);
+        }
+    }
+
+    if (opCtx) {
+        if (_opId != opCtx->getOpID()) {
+            CurOp::get(opCtx)->addBlockingMemoryBytes(static_cast<long long>(bytes));
+            _opId = opCtx->getOpID();
+        } else if (delta != 0) {
+            CurOp::get(opCtx)->addBlockingMemoryBytes(delta);
+        }
+    }
+    _bytes = bytes;
+}
+
+bool BlockingMemoryTracker::shouldRelease(size_t bytes) const {
+    const long long limit = internalQueryGlobalBlockingMemoryLimitBytes.load();
+    if (limit <= 0 || bytes == 0) {
+        return false;
+    }
+
+    const long long total = _totalBytes.load();
+    if (total <= limit) {
+        return false;
+    }
+
+    return static_cast<long long>(bytes) * std::max(1LL, _numConsumers.load()) >= total;
+}
+
+}  // namespace mongo
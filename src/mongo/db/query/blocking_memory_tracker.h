@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Accounts for the memory held by the blocking stages of every operation on this node, such as
+ * the buffered results of a SortStage or the groups of a DocumentSourceGroup, so that their total
+ * can be kept under internalQueryGlobalBlockingMemoryLimitBytes. Each stage reports its usage
+ * through a Reservation, which also charges the CurOp of the operation it runs in so that
+ * currentOp can show it. This class is thread-safe.
+ */
+class BlockingMemoryTracker {
+    MONGO_DISALLOW_COPYING(BlockingMemoryTracker);
+
+public:
+    /**
+     * The bytes held by one blocking stage.
+     */
+    class Reservation {
+        MONGO_DISALLOW_COPYING(Reservation);
+
+    public:
+        explicit Reservation(BlockingMemoryTracker* tracker = BlockingMemoryTracker::get());
+        ~Reservation();
+
+        /**
+         * Records that the stage now holds 'bytes', charging the difference to 'opCtx', which
+         * may be null. A stage whose operation context changed since the last call, as it does
+         * between getMores, charges all of its bytes to the new one.
+         */
+        void set(OperationContext* opCtx, size_t bytes);
+
+        size_t bytes() const {
+            return _bytes;
+        }
+
+    private:
+        BlockingMemoryTracker* const _tracker;
+
+        // The id of the operation last charged, if any. Operations may end before their stages
+        // are destroyed, so the stage does not hold on to the OperationContext itself.
+        boost::optional<unsigned int> _opId;
+
+        size_t _bytes = 0;
+    };
+
+    BlockingMemoryTracker() = default;
+
+    /**
+     * Returns the tracker shared by every operation in this process.
+     */
+    static BlockingMemoryTracker* get();
+
+    /**
+     * Returns true if the limit is exceeded and a stage holding 'bytes' holds at least its share
+     * of the total, in which case it should spill to disk or fail. Stages holding less than the
+     * average are left alone, so that the largest consumers give memory back first.
+     */
+    bool shouldRelease(size_t bytes) const;
+
+    long long totalBytes() const {
+        return _totalBytes.load();
+    }
+
+    long long numConsumers() const {
+        return _numConsumers.load();
+    }
+
+private:
+    // The bytes held by all reservations.
+    AtomicInt64 _totalBytes{0};
+
+    // The number of reservations holding any bytes.
+    AtomicInt64 _numConsumers{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/blocking_memory_tracker.h"
+
+#include "mongo/db/curop.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+TEST(BlockingMemoryTrackerTest, ReservationsAreTotalledAndReleased) {
+    BlockingMemoryTracker tracker;
+    {
+        BlockingMemoryTracker::Reservation first(&tracker);
+        BlockingMemoryTracker::Reservation second(&tracker);
+        first.set(nullptr, 100);
+        second.set(nullptr, 50);
+        ASSERT_EQ(150, tracker.totalBytes());
+        ASSERT_EQ(2, tracker.numConsumers());
+
+        first.set(nullptr, 0);
+        ASSERT_EQ(50, tracker.totalBytes());
+        ASSERT_EQ(1, tracker.numConsumers());
+    }
+    ASSERT_EQ(0, tracker.totalBytes());
+    ASSERT_EQ(0, tracker.numConsumers());
+}
+
+TEST(BlockingMemoryTrackerTest, OnlyConsumersAboveTheAverageReleaseOnceOverTheLimit) {
+    const long long oldLimit = internalQueryGlobalBlockingMemoryLimitBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryGlobalBlockingMemoryLimitBytes.store(oldLimit); });
+
+    BlockingMemoryTracker tracker;
+    BlockingMemoryTracker::Reservation large(&tracker);
+    BlockingMemoryTracker::Reservation small(&tracker);
+    large.set(nullptr, 900);
+    small.set(nullptr, 100);
+
+    internalQueryGlobalBlockingMemoryLimitBytes.store(0);
+    ASSERT_FALSE(tracker.shouldRelease(large.bytes()));
+
+    internalQueryGlobalBlockingMemoryLimitBytes.store(2000);
+    ASSERT_FALSE(tracker.shouldRelease(large.bytes()));
+
+    internalQueryGlobalBlockingMemoryLimitBytes.store(500);
+    ASSERT_TRUE(tracker.shouldRelease(large.bytes()));
+    ASSERT_FALSE(tracker.shouldRelease(small.bytes()));
+    ASSERT_FALSE(tracker.shouldRelease(0));
+}
+
+TEST(BlockingMemoryTrackerTest, UsageIsChargedToTheCurrentOperation) {
+    QueryTestServiceContext serviceContext;
+    auto firstOpCtx = serviceContext.makeOperationContext();
+
+    BlockingMemoryTracker tracker;
+    BlockingMemoryTracker::Reservation reservation(&tracker);
+    reservation.set(firstOpCtx.get(), 100);
+    reservation.set(firstOpCtx.get(), 300);
+    ASSERT_EQ(300, CurOp::get(firstOpCtx.get())->blockingMemoryBytes());
+
+    reservation.set(firstOpCtx.get(), 0);
+    ASSERT_EQ(0, CurOp::get(firstOpCtx.get())->blockingMemoryBytes());
+    reservation.set(firstOpCtx.get(), 200);
+    firstOpCtx.reset();
+
+    // A stage carried over to a later operation, as between getMores, charges it for all the
+    // bytes it holds.
+    auto secondOpCtx = serviceContext.makeOperationContext();
+    reservation.set(secondOpCtx.get(), 250);
+    ASSERT_EQ(250, CurOp::get(secondOpCtx.get())->blockingMemoryBytes());
+    ASSERT_EQ(250, tracker.totalBytes());
+}
+
+}  // namespace
+}  // namespace mongo
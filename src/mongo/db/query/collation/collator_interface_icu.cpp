@@ -30,6 +30,7 @@
 
 #include "mongo/db/query/collation/collator_interface_icu.h"
 
+#include <memory>
 #include <unicode/coll.h>
 #include <unicode/sortkey.h>
 
@@ -48,7 +49,20 @@ std::unique_ptr<CollatorInterface> CollatorInterfaceICU::clone() const {
     return {std::move(clone)};
 }
 
+namespace {
+
+// Sort keys up to this size, including the trailing null byte, are generated without a heap
+// allocation. This covers the keys of most short strings.
+const int32_t kSortKeyStackBufferSize = 256;
+
+}  // namespace
+
 int CollatorInterfaceICU::compare(StringData left, StringData right) const {
+    // Identical byte sequences are equal under every collation, so ICU need not decode them.
+    if (left == right) {
+        return 0;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     auto compareResult = _collator->compareUTF8(icu::StringPiece(left.rawData(), left.size()),
                                                 icu::StringPiece(right.rawData(), right.size()),
@@ -76,19 +90,23 @@ CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
     // A StringPiece is ICU's StringData. They are logically the same abstraction.
     const icu::StringPiece stringPiece(stringData.rawData(), stringData.size());
 
-    UErrorCode status = U_ZERO_ERROR;
-    icu::CollationKey icuKey;
-    _collator->getCollationKey(icu::UnicodeString::fromUTF8(stringPiece), icuKey, status);
-
-    // Any sequence of bytes, even invalid UTF-8, has defined comparison behavior in ICU (invalid
-    // subsequences are weighted as the replacement character, U+FFFD). A non-ok error code is only
-    // expected when a memory allocation fails inside ICU, which we consider fatal to the process.
-    fassert(34439, U_SUCCESS(status));
-
-    int32_t keyLength;
-    const uint8_t* keyBuffer = icuKey.getByteArray(keyLength);
-    invariant(keyLength > 0);
-    invariant(keyBuffer);
+    const icu::UnicodeString source = icu::UnicodeString::fromUTF8(stringPiece);
+
+    // Ask ICU for the sort key directly instead of through an icu::CollationKey, which always
+    // allocates. A zero length is only returned when ICU fails internally, which we consider fatal
+    // to the process, since any sequence of bytes, even invalid UTF-8, has a defined sort key.
+    uint8_t stackBuffer[kSortKeyStackBufferSize];
+    int32_t keyLength = _collator->getSortKey(source, stackBuffer, kSortKeyStackBufferSize);
+    fassert(34439, keyLength > 0);
+
+    std::unique_ptr<uint8_t[]> heapBuffer;
+    const uint8_t* keyBuffer = stackBuffer;
+    if (keyLength > kSortKeyStackBufferSize) {
+        heapBuffer.reset(new uint8_t[keyLength]);
+        const int32_t fullKeyLength = _collator->getSortKey(source, heapBuffer.get(), keyLength);
+        invariant(fullKeyLength == keyLength);
+        keyBuffer = heapBuffer.get();
+    }
 
     // The last byte of the sort key should always be null. When we construct the comparison key, we
     // omit the trailing null byte.
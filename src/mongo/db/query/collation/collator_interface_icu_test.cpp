@@ -33,6 +33,7 @@
 #include <iomanip>
 #include <iostream>
 #include <unicode/coll.h>
+#include <unicode/sortkey.h>
 
 #include "mongo/unittest/unittest.h"
 
@@ -593,4 +594,48 @@ TEST(CollatorInterfaceICUTest, ComparisonKeysForFrCaCollatorCorrect) {
               "\x2D\x45\x4F\x31\x01\x88\x44\x8E\x06\x01\x0A");
 }
 
+TEST(CollatorInterfaceICUTest, ComparisonKeyLongerThanStackBufferMatchesICUCollationKey) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "en_US";
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    std::unique_ptr<icu::Collator> referenceColl(coll->clone());
+    CollatorInterfaceICU icuCollator(collationSpec, std::move(coll));
+
+    std::string longString;
+    for (int i = 0; i < 200; ++i) {
+        longString += "c\xC3\xB4t\xC3\xA9";
+    }
+
+    icu::CollationKey referenceKey;
+    referenceColl->getCollationKey(
+        icu::UnicodeString::fromUTF8(icu::StringPiece(longString.data(), longString.size())),
+        referenceKey,
+        status);
+    ASSERT(U_SUCCESS(status));
+    int32_t referenceLength;
+    const uint8_t* referenceBytes = referenceKey.getByteArray(referenceLength);
+    ASSERT_GT(referenceLength, 256);
+
+    ASSERT_EQ(icuCollator.getComparisonKey(longString).getKeyData(),
+              StringData(reinterpret_cast<const char*>(referenceBytes), referenceLength - 1));
+}
+
+TEST(CollatorInterfaceICUTest, IdenticalStringsCompareEqual) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "fr_CA";
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale("fr", "CA"), status));
+    ASSERT(U_SUCCESS(status));
+    CollatorInterfaceICU icuCollator(collationSpec, std::move(coll));
+
+    std::string first = "c\xC3\xB4t\xC3\xA9";
+    std::string second = first;
+    ASSERT_EQ(icuCollator.compare(first, second), 0);
+    ASSERT_EQ(icuCollator.compare("", ""), 0);
+}
+
 }  // namespace
@@ -292,6 +292,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
             bob->appendNumber("flaggedButPassed", spec->flaggedButPassed);
             bob->appendNumber("flaggedInProgress", spec->flaggedInProgress);
+            bob->appendNumber("bloomFilterRejects", spec->bloomFilterRejects);
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
                                   spec->mapAfterChild[i]);
@@ -348,6 +349,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         indexBoundsBob.append("startKeyInclusive", spec->startKeyInclusive);
         indexBoundsBob.append("endKey", spec->endKey);
         indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
+        if (spec->numKeyRanges > 1) {
+            indexBoundsBob.appendNumber("numKeyRanges", spec->numKeyRanges);
+        }
         bob->append("indexBounds", indexBoundsBob.obj());
     } else if (STAGE_DELETE == stats.stageType) {
         DeleteStats* spec = static_cast<DeleteStats*>(stats.specific.get());
@@ -488,6 +492,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            if (spec->usedDisk) {
+                bob->appendBool("usedDisk", true);
+            }
         }
 
         if (spec->limit > 0) {
@@ -833,6 +840,30 @@ std::string Explain::getPlanSummary(const PlanStage* root) {
     return sb.str();
 }
 
+// static
+size_t Explain::getTotalKeysExamined(const PlanStageStats& stats) {
+    vector<const PlanStageStats*> statsNodes;
+    flattenStatsTree(&stats, &statsNodes);
+
+    size_t totalKeysExamined = 0;
+    for (const auto* node : statsNodes) {
+        totalKeysExamined += getKeysExamined(node->stageType, node->specific.get());
+    }
+    return totalKeysExamined;
+}
+
+// static
+size_t Explain::getTotalDocsExamined(const PlanStageStats& stats) {
+    vector<const PlanStageStats*> statsNodes;
+    flattenStatsTree(&stats, &statsNodes);
+
+    size_t totalDocsExamined = 0;
+    for (const auto* node : statsNodes) {
+        totalDocsExamined += getDocsExamined(node->stageType, node->specific.get());
+    }
+    return totalDocsExamined;
+}
+
 // static
 void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsOut) {
     invariant(NULL != statsOut);
@@ -122,6 +122,13 @@ public:
      */
     static void getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsOut);
 
+    /**
+     * Returns the number of index keys, or of documents, examined by all the stages in 'stats'.
+     * These are reported as 'totalKeysExamined' and 'totalDocsExamined' by explain.
+     */
+    static size_t getTotalKeysExamined(const PlanStageStats& stats);
+    static size_t getTotalDocsExamined(const PlanStageStats& stats);
+
 private:
     /**
      * Private helper that does the heavy-lifting for the public statsToBSON(...) functions
@@ -32,6 +32,7 @@
 
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds_builder.h"  // For OrderedIntervalList
@@ -48,7 +49,12 @@ namespace mongo {
  */
 class ExpressionMapping {
 public:
-    static BSONObj hash(const BSONElement& value);
+    /**
+     * Returns the hashed index key for 'value', computed with the hash function identified by
+     * 'hashVersion'.
+     */
+    static BSONObj hash(const BSONElement& value,
+                        int hashVersion = BSONElementHasher::DEFAULT_HASH_VERSION);
 
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
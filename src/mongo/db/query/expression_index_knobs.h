@@ -59,4 +59,8 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many $geoNear annulus coverings do we keep so that repeated searches around the same point
+// do not recompute them? Zero disables the cache.
+extern int internalQueryS2GeoNearCoveringCacheSize;
+
 }  // namespace mongo
@@ -51,6 +51,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
@@ -146,9 +147,20 @@ void endQueryOp(OperationContext* opCtx,
 
     if (collection) {
         collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+
+        if (const CanonicalQuery* cq = exec.getCanonicalQuery()) {
+            QueryExecStats queryStats;
+            queryStats.latency = curOp->elapsedTimeExcludingPauses();
+            queryStats.keysExamined = summaryStats.totalKeysExamined;
+            queryStats.docsExamined = summaryStats.totalDocsExamined;
+            queryStats.nReturned = numResults;
+            queryStats.planSummary = curOp->getPlanSummary();
+            collection->infoCache()->getQueryStats()->record(
+                collection->infoCache()->getPlanCache()->computeKeyHash(*cq), *cq, queryStats);
+        }
     }
 
-    if (curOp->shouldDBProfile()) {
+    if (curOp->shouldCaptureExecStats()) {
         BSONObjBuilder statsBob;
         Explain::getWinningPlanStats(&exec, &statsBob);
         curOp->debug().execStats = statsBob.obj();
@@ -453,7 +465,7 @@ Message getMore(OperationContext* opCtx,
         // the original request and subsequent getMore. It would be useful to have this information
         // for an aggregation, but the source PlanExecutor could be destroyed before we know whether
         // we need execStats and we do not want to generate for all operations due to cost.
-        if (!CursorManager::isGloballyManagedCursor(cursorid) && curOp.shouldDBProfile()) {
+        if (!CursorManager::isGloballyManagedCursor(cursorid) && curOp.shouldCaptureExecStats()) {
             BSONObjBuilder execStatsBob;
             Explain::getWinningPlanStats(exec, &execStatsBob);
             curOp.debug().execStats = execStatsBob.obj();
@@ -618,6 +630,15 @@ std::string runQuery(OperationContext* opCtx,
     BufBuilder bb(FindCommon::kInitReplyBufferSize);
     bb.skip(sizeof(QueryResult::Value));
 
+    // Make room for the whole batch before streaming into it, so that documents are copied into
+    // the reply straight from the storage engine rather than again on each regrowth.
+    if (collection) {
+        const int batchBytesHint =
+            FindCommon::estimateFirstBatchBytes(qr, collection->averageObjectSize(opCtx));
+        bb.reserveBytes(batchBytesHint);
+        bb.claimReservedBytes(batchBytesHint);
+    }
+
     // How many results have we obtained from the executor?
     int numResults = 0;
 
@@ -63,6 +63,30 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
     return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
 }
 
+int FindCommon::estimateFirstBatchBytes(const QueryRequest& qr, int avgObjSize) {
+    if (avgObjSize <= 0 || !qr.getProj().isEmpty()) {
+        return 0;
+    }
+
+    // Each document in the batch array is preceded by a type byte and its array index as a
+    // NUL-terminated field name.
+    const long long kArrayElementOverhead = 8;
+    // The extra 1K leaves room for a final document which takes the batch just past the limit.
+    const long long kMaxBatchBytes = kMaxBytesToReturnToClientAtOnce + 1024;
+
+    const long long batchSize =
+        qr.getEffectiveBatchSize().value_or(QueryRequest::kDefaultBatchSize);
+    if (batchSize <= 0) {
+        return 0;
+    }
+
+    const long long docBytes = avgObjSize + kArrayElementOverhead;
+    if (batchSize > kMaxBatchBytes / docBytes) {
+        return kMaxBatchBytes;
+    }
+    return batchSize * docBytes;
+}
+
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
     BSONObjBuilder comparatorBob;
 
@@ -103,6 +103,18 @@ public:
      */
     static bool haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered);
 
+    /**
+     * Returns how many bytes of reply buffer the first batch for 'qr' is expected to take, given
+     * that the documents in the collection average 'avgObjSize' bytes. Reserving this much before
+     * appending the batch lets each document be copied into the reply exactly once, straight out
+     * of the storage engine's cursor buffer, instead of again every time the buffer regrows.
+     *
+     * The estimate is capped at the batch byte limit, and is zero when there is nothing to
+     * estimate from, such as when 'qr' has a projection and so the batch does not hold the
+     * collection's documents as stored.
+     */
+    static int estimateFirstBatchBytes(const QueryRequest& qr, int avgObjSize);
+
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
      * BSONObj::woCompare().
@@ -44,8 +44,10 @@
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/eof.h"
+#include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/group.h"
 #include "mongo/db/exec/idhack.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/oplogstart.h"
 #include "mongo/db/exec/projection.h"
@@ -55,6 +57,7 @@
 #include "mongo/db/exec/update.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/update_lifecycle.h"
@@ -62,6 +65,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/indexability.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
@@ -72,6 +76,7 @@
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
+#include "mongo/db/query/time_window_pruning.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
@@ -128,6 +133,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
                           Collection* collection,
                           CanonicalQuery* canonicalQuery,
                           QueryPlannerParams* plannerParams) {
+    // Index statistics are only looked up when the planner is going to use them.
+    const bool useIndexStatistics = internalQueryPlannerIndexStatisticsPruneRatio.load() > 0 ||
+        internalQueryPlannerSkipScanMaxDistinctPrefixes.load() > 0;
+
     // If it's not NULL, we may have indices.  Access the catalog and fill out IndexEntry(s)
     IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii.more()) {
@@ -143,6 +152,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
                                                     ice->getFilterExpression(),
                                                     desc->infoObj(),
                                                     ice->getCollator()));
+        if (useIndexStatistics) {
+            plannerParams->indices.back().statistics =
+                collection->infoCache()->getIndexStatistics(desc->indexName());
+        }
     }
 
     // If query supports index filters, filter params.indices by indices in query settings.
@@ -231,6 +244,104 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Adds the stages which sit above the root of an execution tree built without the query planner,
+ * such as the idhack plan: a shard filter if the caller asked for one, and the projection (along
+ * with any $meta sortKey generation it needs). 'root' must produce fetched documents.
+ */
+unique_ptr<PlanStage> addShardFilterAndProjection(OperationContext* opCtx,
+                                                  const CanonicalQuery& query,
+                                                  const QueryPlannerParams& plannerParams,
+                                                  WorkingSet* ws,
+                                                  unique_ptr<PlanStage> root) {
+    // Might have to filter out orphaned docs.
+    if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        root = make_unique<ShardFilterStage>(
+            opCtx,
+            CollectionShardingState::get(opCtx, query.nss())->getMetadata(),
+            ws,
+            root.release());
+    }
+
+    // There might be a projection. The root always fetches the full document, so we don't
+    // support covered projections. However, we might use the simple inclusion fast path.
+    if (NULL != query.getProj()) {
+        ProjectionStageParams params;
+        params.projObj = query.getProj()->getProjObj();
+        params.collator = query.getCollator();
+
+        // Add a SortKeyGeneratorStage if there is a $meta sortKey projection.
+        if (query.getProj()->wantSortKey()) {
+            root = make_unique<SortKeyGeneratorStage>(
+                opCtx, root.release(), ws, query.getQueryRequest().getSort(), query.getCollator());
+        }
+
+        // Stuff the right data into the params depending on what proj impl we use.
+        if (query.getProj()->requiresDocument() || query.getProj()->wantIndexKey() ||
+            query.getProj()->wantSortKey() ||
+            (query.getProj()->hasDottedFieldPath() &&
+             !query.getProj()->hasOnlySimpleDottedInclusions())) {
+            params.fullExpression = query.root();
+            params.projImpl = ProjectionStageParams::NO_FAST_PATH;
+        } else {
+            params.projImpl = ProjectionStageParams::SIMPLE_DOC;
+        }
+
+        root = make_unique<ProjectionStage>(opCtx, params, ws, root.release());
+    }
+
+    return root;
+}
+
+/**
+ * Returns the index entry for a unique index which can answer 'query' with a single point lookup,
+ * or nullptr if there is none. This is the case when the query is one equality predicate on a
+ * value with exact index bounds, and there is a unique, non-multikey, non-partial btree index on
+ * exactly that field. Like an _id lookup, such a query matches at most one document, so there is
+ * no plan to choose and none of the modifiers which need the planner may be present.
+ */
+const IndexEntry* getUniqueIndexForPointLookup(const CanonicalQuery& query,
+                                               const QueryPlannerParams& plannerParams) {
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.showRecordId() || !qr.getHint().isEmpty() || qr.getSkip() || qr.isTailable() ||
+        !qr.getMin().isEmpty() || !qr.getMax().isEmpty() || qr.getMaxScan() || qr.returnKey() ||
+        qr.isSnapshot() || qr.isOplogReplay()) {
+        return nullptr;
+    }
+
+    // Counts are better served by the fast count plan, which never fetches.
+    if (plannerParams.options & QueryPlannerParams::IS_COUNT) {
+        return nullptr;
+    }
+
+    if (query.root()->matchType() != MatchExpression::EQ) {
+        return nullptr;
+    }
+    const auto* eq = static_cast<const EqualityMatchExpression*>(query.root());
+    const BSONElement value = eq->getData();
+    if (!Indexability::isExactBoundsGenerating(value)) {
+        return nullptr;
+    }
+
+    for (const auto& entry : plannerParams.indices) {
+        if (!entry.unique || entry.multikey || entry.filterExpr || entry.type != INDEX_BTREE ||
+            entry.keyPattern.nFields() != 1 ||
+            entry.keyPattern.firstElement().fieldNameStringData() != eq->path()) {
+            continue;
+        }
+
+        // Strings are only looked up directly under the simple collation, since otherwise the
+        // index holds collation keys. Other types are compared the same way under any collation.
+        if (value.type() == BSONType::String && (entry.collator || query.getCollator())) {
+            continue;
+        }
+
+        return &entry;
+    }
+
+    return nullptr;
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -263,6 +374,19 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     }
 
+    // Every document of a time window collection is within its window, so a query whose predicate
+    // on the time field lies outside of the window can't match anything.
+    const auto& timeWindow = collection->getTimeWindow();
+    if (timeWindow &&
+        timeWindowExcludesQuery(
+            canonicalQuery->root(), timeWindow->field, timeWindow->start, timeWindow->end)) {
+        LOG(2) << "Query is outside of the time window of collection " << collection->ns()
+               << ". Using EOF plan: " << redact(canonicalQuery->toStringShort());
+        root = make_unique<EOFStage>(opCtx);
+        return PrepareExecutionResult(
+            std::move(canonicalQuery), std::move(querySolution), std::move(root));
+    }
+
     // Fill out the planning params.  We use these for both cached solutions and non-cached.
     QueryPlannerParams plannerParams;
     plannerParams.options = plannerOptions;
@@ -282,48 +406,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
-
-        // Might have to filter out orphaned docs.
-        if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-            root = make_unique<ShardFilterStage>(
-                opCtx,
-                CollectionShardingState::get(opCtx, canonicalQuery->nss())->getMetadata(),
-                ws,
-                root.release());
-        }
-
-        // There might be a projection. The idhack stage will always fetch the full
-        // document, so we don't support covered projections. However, we might use the
-        // simple inclusion fast path.
-        if (NULL != canonicalQuery->getProj()) {
-            ProjectionStageParams params;
-            params.projObj = canonicalQuery->getProj()->getProjObj();
-            params.collator = canonicalQuery->getCollator();
-
-            // Add a SortKeyGeneratorStage if there is a $meta sortKey projection.
-            if (canonicalQuery->getProj()->wantSortKey()) {
-                root =
-                    make_unique<SortKeyGeneratorStage>(opCtx,
-                                                       root.release(),
-                                                       ws,
-                                                       canonicalQuery->getQueryRequest().getSort(),
-                                                       canonicalQuery->getCollator());
-            }
-
-            // Stuff the right data into the params depending on what proj impl we use.
-            if (canonicalQuery->getProj()->requiresDocument() ||
-                canonicalQuery->getProj()->wantIndexKey() ||
-                canonicalQuery->getProj()->wantSortKey() ||
-                canonicalQuery->getProj()->hasDottedFieldPath()) {
-                params.fullExpression = canonicalQuery->root();
-                params.projImpl = ProjectionStageParams::NO_FAST_PATH;
-            } else {
-                params.projImpl = ProjectionStageParams::SIMPLE_DOC;
-            }
-
-            root = make_unique<ProjectionStage>(opCtx, params, ws, root.release());
-        }
-
+        root = addShardFilterAndProjection(
+            opCtx, *canonicalQuery, plannerParams, ws, std::move(root));
         return PrepareExecutionResult(
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     }
@@ -337,6 +421,39 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // An equality lookup on a unique index is answered by at most one key, so, as with idhack, we
+    // skip the planner and the plan cache and scan that one point of the index.
+    if (internalQueryEnableUniqueIndexPointLookup.load()) {
+        const IndexEntry* entry = getUniqueIndexForPointLookup(*canonicalQuery, plannerParams);
+        if (entry) {
+            const auto* eq = static_cast<const EqualityMatchExpression*>(canonicalQuery->root());
+
+            IndexScanParams ixParams;
+            ixParams.descriptor =
+                collection->getIndexCatalog()->findIndexByName(opCtx, entry->name);
+            invariant(ixParams.descriptor);
+            ixParams.doNotDedup = true;
+
+            OrderedIntervalList oil(eq->path().toString());
+            oil.intervals.push_back(
+                IndexBoundsBuilder::makePointInterval(BSON("" << eq->getData())));
+            ixParams.bounds.fields.push_back(std::move(oil));
+
+            LOG(2) << "Using unique index point lookup on " << entry->name << ": "
+                   << redact(canonicalQuery->toStringShort());
+
+            root = make_unique<FetchStage>(opCtx,
+                                           ws,
+                                           new IndexScan(opCtx, ixParams, ws, nullptr),
+                                           nullptr,
+                                           collection);
+            root = addShardFilterAndProjection(
+                opCtx, *canonicalQuery, plannerParams, ws, std::move(root));
+            return PrepareExecutionResult(
+                std::move(canonicalQuery), std::move(querySolution), std::move(root));
+        }
+    }
+
     // Try to look up a cached solution for the query.
     CachedSolution* rawCS;
     if (PlanCache::shouldCacheQuery(*canonicalQuery) &&
@@ -347,6 +464,18 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         Status status = QueryPlanner::planFromCache(*canonicalQuery, plannerParams, *cs, &qs);
 
         if (status.isOK()) {
+            // Publish a template of the solution so that later queries of this shape can skip
+            // planning. This must happen before the solution is turned into a fast count.
+            if (!cs->solutionTemplate && internalQueryCacheUseSolutionTemplates.load()) {
+                if (auto solnTemplate =
+                        QueryPlanner::makeSolutionTemplate(*canonicalQuery, plannerParams, *qs)) {
+                    collection->infoCache()
+                        ->getPlanCache()
+                        ->setSolutionTemplate(*canonicalQuery, std::move(solnTemplate))
+                        .transitional_ignore();
+                }
+            }
+
             if ((plannerParams.options & QueryPlannerParams::IS_COUNT) && turnIxscanIntoCount(qs)) {
                 LOG(2) << "Using fast count: " << redact(canonicalQuery->toStringShort());
             }
@@ -637,6 +766,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getOplogStartHack(
     params.tailable = cq->getQueryRequest().isTailable();
     params.shouldTrackLatestOplogTimestamp =
         plannerOptions & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
+    params.shareOplogReads =
+        params.tailable && collection->ns().isOplog() && internalQueryShareOplogReads.load();
 
     // If the query is just a lower bound on "ts", we know that every document in the collection
     // after the first matching one must also match. To avoid wasting time running the match
@@ -670,6 +801,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorFind(
     if (ShardingState::get(opCtx)->needCollectionMetadata(opCtx, nss.ns())) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+
+    // Results of a spilled sort have no RecordId, so they cannot be used to report one.
+    if (internalQueryExecSortAllowDiskUse.load() &&
+        !canonicalQuery->getQueryRequest().showRecordId()) {
+        plannerOptions |= QueryPlannerParams::ALLOW_EXTERNAL_SORT;
+    }
     return getExecutor(
         opCtx, collection, std::move(canonicalQuery), PlanExecutor::YIELD_AUTO, plannerOptions);
 }
@@ -819,9 +956,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
     // This is the regular path for when we have a CanonicalQuery.
     unique_ptr<CanonicalQuery> cq(parsedDelete->releaseParsedQuery());
 
-    const size_t defaultPlannerOptions = 0;
+    // A findAndModify with a sort carries a limit of 1, which the delete stage enforces itself.
+    const size_t plannerOptions = !request->isMulti() && !request->getSort().isEmpty()
+        ? QueryPlannerParams::WRITE_STAGE_ENFORCES_LIMIT
+        : 0;
     StatusWith<PrepareExecutionResult> executionResult =
-        prepareExecution(opCtx, collection, ws.get(), std::move(cq), defaultPlannerOptions);
+        prepareExecution(opCtx, collection, ws.get(), std::move(cq), plannerOptions);
     if (!executionResult.isOK()) {
         return executionResult.getStatus();
     }
@@ -960,9 +1100,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
     // This is the regular path for when we have a CanonicalQuery.
     unique_ptr<CanonicalQuery> cq(parsedUpdate->releaseParsedQuery());
 
-    const size_t defaultPlannerOptions = 0;
+    // A findAndModify with a sort carries a limit of 1, which the update stage enforces itself.
+    const size_t plannerOptions = !request->isMulti() && !request->getSort().isEmpty()
+        ? QueryPlannerParams::WRITE_STAGE_ENFORCES_LIMIT
+        : 0;
     StatusWith<PrepareExecutionResult> executionResult =
-        prepareExecution(opCtx, collection, ws.get(), std::move(cq), defaultPlannerOptions);
+        prepareExecution(opCtx, collection, ws.get(), std::move(cq), plannerOptions);
     if (!executionResult.isOK()) {
         return executionResult.getStatus();
     }
@@ -1112,23 +1255,31 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
         return false;
     }
 
-    // Make sure the bounds are OK.
-    BSONObj startKey;
-    bool startKeyInclusive;
-    BSONObj endKey;
-    bool endKeyInclusive;
-
-    if (!IndexBoundsBuilder::isSingleInterval(
-            isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
-        return false;
+    // Make sure the bounds are OK. Bounds with several intervals, such as those from an $in, can
+    // still be counted if they split into a bounded number of disjoint key ranges. The count scan
+    // only moves forward, so that needs the bounds to be in index order.
+    std::vector<IndexKeyRange> ranges;
+    ranges.emplace_back();
+    if (!IndexBoundsBuilder::isSingleInterval(isn->bounds,
+                                              &ranges[0].startKey,
+                                              &ranges[0].startKeyInclusive,
+                                              &ranges[0].endKey,
+                                              &ranges[0].endKeyInclusive)) {
+        ranges.clear();
+        if (isn->direction != 1 ||
+            !IndexBoundsBuilder::isDisjointIntervals(
+                isn->bounds, internalQueryMaxScansToExplode.load(), &ranges)) {
+            return false;
+        }
     }
 
     // Make the count node that we replace the fetch + ixscan with.
     CountScanNode* csn = new CountScanNode(isn->index);
-    csn->startKey = startKey;
-    csn->startKeyInclusive = startKeyInclusive;
-    csn->endKey = endKey;
-    csn->endKeyInclusive = endKeyInclusive;
+    csn->startKey = ranges[0].startKey;
+    csn->startKeyInclusive = ranges[0].startKeyInclusive;
+    csn->endKey = ranges[0].endKey;
+    csn->endKeyInclusive = ranges[0].endKeyInclusive;
+    csn->additionalRanges.assign(ranges.begin() + 1, ranges.end());
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(csn);
     return true;
@@ -1238,6 +1389,33 @@ std::string getProjectedDottedField(const std::string& field, bool* isIDOut) {
  *    the results from the executor using the dotted field name. Using $slice will
  *    re-order the documents in the array in the results.
  */
+/**
+ * Returns true if the index with key pattern 'keyPattern' may have more than one key for a
+ * document on the path 'field'.
+ */
+bool isMultikeyOnField(const BSONObj& keyPattern,
+                       bool multikey,
+                       const MultikeyPaths& multikeyPaths,
+                       const std::string& field) {
+    if (!multikey) {
+        return false;
+    }
+
+    if (multikeyPaths.empty()) {
+        // We don't have path-level multikey information available.
+        return true;
+    }
+
+    size_t fieldNo = 0;
+    for (auto&& elem : keyPattern) {
+        if (elem.fieldNameStringData() == field) {
+            return !multikeyPaths[fieldNo].empty();
+        }
+        ++fieldNo;
+    }
+    return true;
+}
+
 BSONObj getDistinctProjection(const std::string& field) {
     std::string projectedField(field);
 
@@ -1468,7 +1646,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     Collection* collection,
     const std::string& ns,
     ParsedDistinct* parsedDistinct,
-    PlanExecutor::YieldPolicy yieldPolicy) {
+    PlanExecutor::YieldPolicy yieldPolicy,
+    size_t plannerOptions) {
     if (!collection) {
         // Treat collections that do not exist as empty collections.
         return PlanExecutor::make(opCtx,
@@ -1490,14 +1669,28 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     // We go through normal planning (with limited parameters) to see if we can produce
     // a soln with the above properties.
 
+    const bool strictDistinctOnly = plannerOptions & QueryPlannerParams::STRICT_DISTINCT_ONLY;
+    const Status noStrictDistinctPlan(ErrorCodes::BadValue,
+                                      "query cannot be answered with a DISTINCT_SCAN");
+
     QueryPlannerParams plannerParams;
-    plannerParams.options = QueryPlannerParams::NO_TABLE_SCAN;
+    plannerParams.options = QueryPlannerParams::NO_TABLE_SCAN | plannerOptions;
 
     IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
         if (desc->keyPattern().hasField(parsedDistinct->getKey())) {
+            if (strictDistinctOnly &&
+                (desc->isSparse() ||
+                 isMultikeyOnField(desc->keyPattern(),
+                                   desc->isMultikey(opCtx),
+                                   ice->getMultikeyPaths(opCtx),
+                                   parsedDistinct->getKey()))) {
+                // A sparse index has no keys for documents missing the field, and a multikey index
+                // has a key per array element rather than one for the array.
+                continue;
+            }
             plannerParams.indices.push_back(IndexEntry(desc->keyPattern(),
                                                        desc->getAccessMethodName(),
                                                        desc->isMultikey(opCtx),
@@ -1516,6 +1709,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     // If there are no suitable indices for the distinct hack bail out now into regular planning
     // with no projection.
     if (plannerParams.indices.empty()) {
+        if (strictDistinctOnly) {
+            return noStrictDistinctPlan;
+        }
         return getExecutor(opCtx, collection, parsedDistinct->releaseQuery(), yieldPolicy);
     }
 
@@ -1602,6 +1798,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     vector<QuerySolution*> solutions;
     Status status = QueryPlanner::plan(*cq, plannerParams, &solutions);
     if (!status.isOK()) {
+        if (strictDistinctOnly) {
+            return noStrictDistinctPlan;
+        }
         return getExecutor(opCtx, collection, std::move(cq), yieldPolicy);
     }
 
@@ -1643,6 +1842,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
         delete solutions[i];
     }
 
+    if (strictDistinctOnly) {
+        return noStrictDistinctPlan;
+    }
     return getExecutor(opCtx, collection, parsedDistinct->releaseQuery(), yieldPolicy);
 }
 
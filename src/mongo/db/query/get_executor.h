@@ -109,13 +109,17 @@ bool turnIxscanIntoDistinctIxscan(QuerySolution* soln, const std::string& field)
  * Distinct is unique in that it doesn't care about getting all the results; it just wants all
  * possible values of a certain field.  As such, we can skip lots of data in certain cases (see
  * body of method for detail).
+ *
+ * If 'plannerOptions' includes QueryPlannerParams::STRICT_DISTINCT_ONLY, returns a non-OK status
+ * rather than a regular executor when the query cannot be answered with a DISTINCT_SCAN.
  */
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     OperationContext* opCtx,
     Collection* collection,
     const std::string& ns,
     ParsedDistinct* parsedDistinct,
-    PlanExecutor::YieldPolicy yieldPolicy);
+    PlanExecutor::YieldPolicy yieldPolicy,
+    size_t plannerOptions = QueryPlannerParams::DEFAULT);
 
 /*
  * Get a PlanExecutor for a query executing as part of a count command.
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_advisor.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/query_stats_store.h"
+
+namespace mongo {
+
+namespace {
+
+// The name the candidate index is given while planning against it.
+const char kCandidateIndexName[] = "$indexAdvisorCandidate";
+
+bool usesCandidateIndex(const QuerySolutionNode* node) {
+    if (node->getType() == STAGE_IXSCAN &&
+        static_cast<const IndexScanNode*>(node)->index.name == kCandidateIndexName) {
+        return true;
+    }
+    for (const auto* child : node->children) {
+        if (usesCandidateIndex(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if the planner produces a solution for 'query' which uses an index with
+ * 'keyPattern' once one is added to the indexes in 'params'.
+ */
+bool plannerWouldUse(const CanonicalQuery& query,
+                     const QueryPlannerParams& params,
+                     const BSONObj& keyPattern) {
+    QueryPlannerParams hypotheticalParams = params;
+    hypotheticalParams.indices.push_back(IndexEntry(keyPattern,
+                                                    IndexNames::BTREE,
+                                                    false,  // multikey
+                                                    MultikeyPaths{},
+                                                    false,  // sparse
+                                                    false,  // unique
+                                                    kCandidateIndexName,
+                                                    nullptr,  // filterExpr
+                                                    BSONObj(),
+                                                    query.getCollator()));
+
+    std::vector<QuerySolution*> rawSolutions;
+    if (!QueryPlanner::plan(query, hypotheticalParams, &rawSolutions).isOK()) {
+        return false;
+    }
+
+    bool used = false;
+    for (auto* rawSolution : rawSolutions) {
+        std::unique_ptr<QuerySolution> solution(rawSolution);
+        used = used || usesCandidateIndex(solution->root.get());
+    }
+    return used;
+}
+
+}  // namespace
+
+const long long IndexAdvisor::kMinExaminedPerReturned;
+
+BSONObj IndexAdvisor::Candidate::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("key", keyPattern);
+    builder.append("numShapes", numShapes);
+    builder.append("numQueries", numQueries);
+    builder.append("estimatedExaminedSaved", estimatedExaminedSaved);
+    builder.append("exampleShape", exampleShape);
+    return builder.obj();
+}
+
+// static
+BSONObj IndexAdvisor::proposeKeyPattern(const CanonicalQuery& query) {
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    std::vector<StringData> equalityPaths;
+    std::vector<StringData> rangePaths;
+    for (const auto* predicate : predicates) {
+        switch (predicate->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::MATCH_IN:
+                equalityPaths.push_back(predicate->path());
+                break;
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::REGEX:
+                rangePaths.push_back(predicate->path());
+                break;
+            default:
+                break;
+        }
+    }
+
+    BSONObjBuilder keyPattern;
+    std::vector<StringData> indexedPaths;
+    auto isIndexed = [&](StringData path) {
+        return std::find(indexedPaths.begin(), indexedPaths.end(), path) != indexedPaths.end();
+    };
+
+    for (auto path : equalityPaths) {
+        if (!isIndexed(path)) {
+            keyPattern.append(path, 1);
+            indexedPaths.push_back(path);
+        }
+    }
+
+    // The sort only needs the index order once the equality predicates have fixed its prefix, so
+    // it goes next, in its own directions. Text score sorts cannot come from an index.
+    for (auto&& sortElem : query.getQueryRequest().getSort()) {
+        if (!sortElem.isNumber()) {
+            break;
+        }
+        const StringData path = sortElem.fieldNameStringData();
+        if (!isIndexed(path)) {
+            keyPattern.append(path, sortElem.numberInt() < 0 ? -1 : 1);
+            indexedPaths.push_back(path);
+        }
+    }
+
+    for (auto path : rangePaths) {
+        if (!isIndexed(path)) {
+            keyPattern.append(path, 1);
+            indexedPaths.push_back(path);
+        }
+    }
+
+    return keyPattern.obj();
+}
+
+bool IndexAdvisor::addQueryShape(const CanonicalQuery& query,
+                                 const QueryPlannerParams& params,
+                                 long long count,
+                                 long long examined,
+                                 long long nReturned) {
+    if (examined <= std::max(nReturned, 1LL) * kMinExaminedPerReturned) {
+        return false;
+    }
+
+    const BSONObj keyPattern = proposeKeyPattern(query);
+    if (keyPattern.isEmpty()) {
+        return false;
+    }
+
+    // An existing index which starts with the candidate already offers everything it would,
+    // unless it leaves out documents or orders strings differently.
+    for (const auto& index : params.indices) {
+        if (index.type == INDEX_BTREE && !index.sparse && !index.filterExpr &&
+            CollatorInterface::collatorsMatch(index.collator, query.getCollator()) &&
+            keyPattern.isPrefixOf(index.keyPattern, SimpleBSONElementComparator::kInstance)) {
+            return false;
+        }
+    }
+
+    if (!plannerWouldUse(query, params, keyPattern)) {
+        return false;
+    }
+
+    auto it = std::find_if(_candidates.begin(), _candidates.end(), [&](const Candidate& c) {
+        return SimpleBSONObjComparator::kInstance.evaluate(c.keyPattern == keyPattern);
+    });
+    if (it == _candidates.end()) {
+        _candidates.emplace_back();
+        it = _candidates.end() - 1;
+        it->keyPattern = keyPattern;
+    }
+
+    const long long examinedSaved = examined - nReturned;
+    ++it->numShapes;
+    it->numQueries += count;
+    it->estimatedExaminedSaved += examinedSaved;
+    if (it->exampleShape.isEmpty() || examinedSaved > it->exampleExaminedSaved) {
+        it->exampleShape = QueryStatsStore::makeShape(query);
+        it->exampleExaminedSaved = examinedSaved;
+    }
+    return true;
+}
+
+std::vector<IndexAdvisor::Candidate> IndexAdvisor::getCandidates() const {
+    std::vector<Candidate> candidates = _candidates;
+    std::stable_sort(
+        candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+            return lhs.estimatedExaminedSaved > rhs.estimatedExaminedSaved;
+        });
+    return candidates;
+}
+
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+struct QueryPlannerParams;
+
+/**
+ * Proposes indexes for a collection from a sample of its query workload. Each query shape which
+ * examines many more index keys and documents than it returns gets a candidate index: its
+ * equality predicates, then its sort, then its range predicates. A candidate is kept only if the
+ * query planner produces a plan using it when the shape is planned against the collection's
+ * indexes plus the candidate. Candidates proposed by several shapes are merged, and the keys and
+ * documents they would save are summed.
+ */
+class IndexAdvisor {
+    MONGO_DISALLOW_COPYING(IndexAdvisor);
+
+public:
+    /**
+     * Shapes which examine at most this many keys and documents per result are left alone.
+     */
+    static const long long kMinExaminedPerReturned = 10;
+
+    struct Candidate {
+        BSONObj toBSON() const;
+
+        BSONObj keyPattern;
+
+        // The number of distinct shapes, and of queries of those shapes, the index would serve.
+        long long numShapes = 0;
+        long long numQueries = 0;
+
+        // The keys and documents those queries examined beyond the ones they returned, which is
+        // roughly what the index would save them.
+        long long estimatedExaminedSaved = 0;
+
+        // The query, sort, projection and collation of the shape which saves the most.
+        BSONObj exampleShape;
+        long long exampleExaminedSaved = 0;
+    };
+
+    IndexAdvisor() = default;
+
+    /**
+     * Returns the index proposed for 'query', or an empty object if it has no predicates or sort
+     * which an ordinary ascending or descending index could serve.
+     */
+    static BSONObj proposeKeyPattern(const CanonicalQuery& query);
+
+    /**
+     * Considers the shape of 'query', whose 'count' runs examined 'examined' keys and documents
+     * in total to return 'nReturned' results. 'params' describes the indexes the shape is planned
+     * against. Returns true if the shape proposed a candidate.
+     */
+    bool addQueryShape(const CanonicalQuery& query,
+                       const QueryPlannerParams& params,
+                       long long count,
+                       long long examined,
+                       long long nReturned);
+
+    /**
+     * Returns the candidates, those saving the most first.
+     */
+    std::vector<Candidate> getCandidates() const;
+
+private:
+    std::vector<Candidate> _candidates;
+};
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_advisor.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("test.collection");
+
+std::unique_ptr<CanonicalQuery> canonicalize(const char* queryStr, const char* sortStr = "{}") {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson(queryStr));
+    qr->setSort(fromjson(sortStr));
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx.get(),
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+QueryPlannerParams makeParams(std::vector<BSONObj> keyPatterns) {
+    QueryPlannerParams params;
+    for (size_t i = 0; i < keyPatterns.size(); ++i) {
+        params.indices.push_back(IndexEntry(keyPatterns[i], str::stream() << "index" << i));
+    }
+    return params;
+}
+
+TEST(IndexAdvisorTest, ProposesEqualityThenSortThenRangeFields) {
+    auto query = canonicalize("{b: {$gt: 5}, c: {$in: [1, 2]}, a: 1}", "{d: -1}");
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1, c: 1, d: -1, b: 1}"),
+                      IndexAdvisor::proposeKeyPattern(*query));
+}
+
+TEST(IndexAdvisorTest, ProposesEachFieldOnce) {
+    auto query = canonicalize("{a: 1, b: {$gt: 1, $lt: 5}}", "{a: 1, b: 1}");
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1, b: 1}"), IndexAdvisor::proposeKeyPattern(*query));
+}
+
+TEST(IndexAdvisorTest, ProposesNothingForUnindexablePredicates) {
+    auto query = canonicalize("{$or: [{a: 1}, {b: 1}]}");
+    ASSERT_BSONOBJ_EQ(BSONObj(), IndexAdvisor::proposeKeyPattern(*query));
+
+    query = canonicalize("{a: {$ne: 1}}");
+    ASSERT_BSONOBJ_EQ(BSONObj(), IndexAdvisor::proposeKeyPattern(*query));
+}
+
+TEST(IndexAdvisorTest, ProposesIndexForCollectionScannedShape) {
+    IndexAdvisor advisor;
+    auto query = canonicalize("{a: 1}");
+    ASSERT_TRUE(advisor.addQueryShape(*query, makeParams({}), 5, 5000, 10));
+
+    auto candidates = advisor.getCandidates();
+    ASSERT_EQ(1U, candidates.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1}"), candidates[0].keyPattern);
+    ASSERT_EQ(1, candidates[0].numShapes);
+    ASSERT_EQ(5, candidates[0].numQueries);
+    ASSERT_EQ(4990, candidates[0].estimatedExaminedSaved);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1}"), candidates[0].exampleShape["query"].Obj());
+}
+
+TEST(IndexAdvisorTest, IgnoresSelectiveShapes) {
+    IndexAdvisor advisor;
+    auto query = canonicalize("{a: 1}");
+    ASSERT_FALSE(advisor.addQueryShape(*query, makeParams({}), 5, 50, 10));
+    ASSERT_TRUE(advisor.getCandidates().empty());
+}
+
+TEST(IndexAdvisorTest, IgnoresCandidatesCoveredByAnExistingIndex) {
+    IndexAdvisor advisor;
+    auto query = canonicalize("{a: 1}");
+    ASSERT_FALSE(
+        advisor.addQueryShape(*query, makeParams({BSON("a" << 1 << "b" << 1)}), 1, 500, 1));
+    ASSERT_TRUE(advisor.getCandidates().empty());
+
+    // An index in the opposite direction still leaves a sort on the field to be served.
+    query = canonicalize("{}", "{a: 1, b: 1}");
+    ASSERT_TRUE(
+        advisor.addQueryShape(*query, makeParams({BSON("a" << 1 << "b" << -1)}), 1, 500, 1));
+}
+
+TEST(IndexAdvisorTest, MergesShapesProposingTheSameIndexAndOrdersBySavings) {
+    IndexAdvisor advisor;
+    auto first = canonicalize("{a: 1}");
+    auto second = canonicalize("{a: {$in: [1, 2]}}");
+    auto third = canonicalize("{b: 1}");
+    ASSERT_TRUE(advisor.addQueryShape(*first, makeParams({}), 1, 1000, 0));
+    ASSERT_TRUE(advisor.addQueryShape(*third, makeParams({}), 1, 1500, 0));
+    ASSERT_TRUE(advisor.addQueryShape(*second, makeParams({}), 2, 2000, 0));
+
+    auto candidates = advisor.getCandidates();
+    ASSERT_EQ(2U, candidates.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1}"), candidates[0].keyPattern);
+    ASSERT_EQ(2, candidates[0].numShapes);
+    ASSERT_EQ(3, candidates[0].numQueries);
+    ASSERT_EQ(3000, candidates[0].estimatedExaminedSaved);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: {$in: [1, 2]}}"), candidates[0].exampleShape["query"].Obj());
+    ASSERT_BSONOBJ_EQ(fromjson("{b: 1}"), candidates[1].keyPattern);
+}
+
+}  // namespace
+}  // namespace mongo
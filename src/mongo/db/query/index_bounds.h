@@ -76,6 +76,18 @@ struct OrderedIntervalList {
     bool operator!=(const OrderedIntervalList& other) const;
 };
 
+/**
+ * A contiguous run of index keys from 'startKey' to 'endKey', in index order. The keys have
+ * empty field names, as they are compared against keys in the index itself.
+ */
+struct IndexKeyRange {
+    BSONObj startKey;
+    bool startKeyInclusive = true;
+
+    BSONObj endKey;
+    bool endKeyInclusive = true;
+};
+
 /**
  * Tied to an index.  Permissible values for all fields in the index.  Requires the index to
  * interpret.  Previously known as FieldRangeVector.
@@ -31,6 +31,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 
 #include <cmath>
+#include <iterator>
 #include <limits>
 
 #include "mongo/base/string_data.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/regex_literal.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/expression_index.h"
@@ -598,6 +600,9 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
 
         // Create our various intervals.
 
+        oilOut->intervals.reserve(oilOut->intervals.size() + ime->getEqualities().size() +
+                                  ime->getRegexes().size() + 1);
+
         IndexBoundsBuilder::BoundsTightness tightness;
         for (auto&& equality : ime->getEqualities()) {
             translateEquality(equality, index, isHashed, oilOut, &tightness);
@@ -731,46 +736,50 @@ void IndexBoundsBuilder::unionize(OrderedIntervalList* oilOut) {
         return;
     }
 
-    // Step 1: sort.
-    std::sort(iv.begin(), iv.end(), IntervalComparison);
+    // Step 1: sort. Large $in lists usually arrive already in order, so check that first.
+    if (!std::is_sorted(iv.begin(), iv.end(), IntervalComparison)) {
+        std::sort(iv.begin(), iv.end(), IntervalComparison);
+    }
+
+    // Step 2: Walk through and merge. The result is built in a separate vector so that merging
+    // many intervals stays linear rather than erasing from the middle of 'iv' each time.
+    vector<Interval> merged;
+    merged.reserve(iv.size());
+    merged.push_back(std::move(iv.front()));
+    for (size_t i = 1; i < iv.size(); ++i) {
+        Interval& last = merged.back();
 
-    // Step 2: Walk through and merge.
-    size_t i = 0;
-    while (i < iv.size() - 1) {
-        // Compare i with i + 1.
-        Interval::IntervalComparison cmp = iv[i].compare(iv[i + 1]);
+        // Compare the last merged interval with the next one.
+        Interval::IntervalComparison cmp = last.compare(iv[i]);
 
         // This means our sort didn't work.
         verify(Interval::INTERVAL_SUCCEEDS != cmp);
 
-        // Intervals are correctly ordered.
         if (Interval::INTERVAL_PRECEDES == cmp) {
-            // We can move to the next pair.
-            ++i;
+            // Intervals are correctly ordered.
+            merged.push_back(std::move(iv[i]));
         } else if (Interval::INTERVAL_EQUALS == cmp || Interval::INTERVAL_WITHIN == cmp) {
-            // Interval 'i' is equal to i+1, or is contained within i+1.
-            // Remove interval i and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i);
+            // The last interval is equal to the next one, or is contained within it.
+            last = std::move(iv[i]);
         } else if (Interval::INTERVAL_CONTAINS == cmp) {
-            // Interval 'i' contains i+1, remove i+1 and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i + 1);
+            // The last interval contains the next one, which can be dropped.
         } else if (Interval::INTERVAL_OVERLAPS_BEFORE == cmp ||
                    Interval::INTERVAL_PRECEDES_COULD_UNION == cmp) {
-            // We want to merge intervals i and i+1.
-            // Interval 'i' starts before interval 'i+1'.
+            // We want to merge the two intervals. The last interval starts before the next one.
             BSONObjBuilder bob;
-            bob.appendAs(iv[i].start, "");
-            bob.appendAs(iv[i + 1].end, "");
+            bob.appendAs(last.start, "");
+            bob.appendAs(iv[i].end, "");
             BSONObj data = bob.obj();
-            bool startInclusive = iv[i].startInclusive;
-            bool endInclusive = iv[i + 1].endInclusive;
-            iv.erase(iv.begin() + i);
-            // iv[i] is now the former iv[i + 1]
-            iv[i] = makeRangeInterval(
+            bool startInclusive = last.startInclusive;
+            bool endInclusive = iv[i].endInclusive;
+            last = makeRangeInterval(
                 data, IndexBounds::makeBoundInclusionFromBoundBools(startInclusive, endInclusive));
-            // Don't increment 'i'.
+        } else {
+            MONGO_UNREACHABLE;
         }
     }
+
+    iv.swap(merged);
 }
 
 // static
@@ -825,6 +834,59 @@ void IndexBoundsBuilder::reverseInterval(Interval* ival) {
     ival->endInclusive = tmpInc;
 }
 
+// static
+std::vector<string> IndexBoundsBuilder::caseInsensitiveRegexPrefixes(const char* regex,
+                                                                     const char* flags,
+                                                                     const IndexEntry& index) {
+    string caseSensitiveFlags;
+    bool caseInsensitive = false;
+    for (const char* flag = flags; *flag; ++flag) {
+        if (*flag == 'i') {
+            caseInsensitive = true;
+        } else {
+            caseSensitiveFlags.push_back(*flag);
+        }
+    }
+    if (!caseInsensitive) {
+        return {};
+    }
+
+    // Without the 'i' option the regex would match strings starting with 'prefix'. With it, each
+    // character of 'prefix' may appear in either case.
+    BoundsTightness tightness;
+    const string prefix = simpleRegex(regex, caseSensitiveFlags.c_str(), index, &tightness);
+
+    std::vector<string> variants{""};
+    for (char c : prefix) {
+        if (!RegexRequiredLiteral::foldsCaseWithinASCII(c)) {
+            break;
+        }
+        const bool isLetter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (!isLetter) {
+            for (auto&& variant : variants) {
+                variant.push_back(c);
+            }
+            continue;
+        }
+        if (variants.size() * 2 > kMaxCaseInsensitiveRegexPrefixes) {
+            break;
+        }
+        const char upper = c & ~0x20;
+        const char lower = c | 0x20;
+        const size_t numVariants = variants.size();
+        for (size_t i = 0; i < numVariants; ++i) {
+            variants.push_back(variants[i] + lower);
+            variants[i].push_back(upper);
+        }
+    }
+
+    if (variants.front().empty()) {
+        return {};
+    }
+    std::sort(variants.begin(), variants.end());
+    return variants;
+}
+
 // static
 void IndexBoundsBuilder::translateRegex(const RegexMatchExpression* rme,
                                         const IndexEntry& index,
@@ -833,12 +895,28 @@ void IndexBoundsBuilder::translateRegex(const RegexMatchExpression* rme,
     const string start =
         simpleRegex(rme->getString().c_str(), rme->getFlags().c_str(), index, tightnessOut);
 
+    // A case insensitive regex has no single prefix, but a short prefix can still be turned into
+    // one range per combination of upper and lower case letters.
+    std::vector<string> caseInsensitivePrefixes;
+    if (start.empty()) {
+        caseInsensitivePrefixes = caseInsensitiveRegexPrefixes(
+            rme->getString().c_str(), rme->getFlags().c_str(), index);
+    }
+
     // Note that 'tightnessOut' is set by simpleRegex above.
     if (!start.empty()) {
         string end = start;
         end[end.size() - 1]++;
         oilOut->intervals.push_back(
             makeRangeInterval(start, end, BoundInclusion::kIncludeStartKeyOnly));
+    } else if (!caseInsensitivePrefixes.empty()) {
+        for (auto&& prefix : caseInsensitivePrefixes) {
+            string end = prefix;
+            end[end.size() - 1]++;
+            oilOut->intervals.push_back(
+                makeRangeInterval(prefix, end, BoundInclusion::kIncludeStartKeyOnly));
+        }
+        *tightnessOut = IndexBoundsBuilder::INEXACT_COVERED;
     } else {
         BSONObjBuilder bob;
         bob.appendMinForType("", String);
@@ -866,7 +944,8 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(),
+                                              index.infoObj["hashVersion"].numberInt());
         }
 
         verify(dataObj.isOwned());
@@ -900,6 +979,7 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     // {a: [1, 2, 3]} will match documents like {a: [[1, 2, 3], 4, 5]}.
 
     // Case 3.
+    const size_t firstAdded = oil->intervals.size();
     oil->intervals.push_back(makePointInterval(objFromElement(data, index.collator)));
 
     if (data.Obj().isEmpty()) {
@@ -913,7 +993,9 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
         oil->intervals.push_back(makePointInterval(objFromElement(firstEl, index.collator)));
     }
 
-    std::sort(oil->intervals.begin(), oil->intervals.end(), IntervalComparison);
+    // Only the intervals added here need sorting. Sorting the whole list on every array in a
+    // large $in would make building its bounds quadratic, and translate() unionizes them anyway.
+    std::sort(oil->intervals.begin() + firstAdded, oil->intervals.end(), IntervalComparison);
     *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
 }
 
@@ -1079,4 +1161,76 @@ bool IndexBoundsBuilder::isSingleInterval(const IndexBounds& bounds,
     }
 }
 
+// static
+bool IndexBoundsBuilder::isDisjointIntervals(const IndexBounds& bounds,
+                                             size_t maxRanges,
+                                             std::vector<IndexKeyRange>* rangesOut) {
+    // Every field whose intervals are all points, and the first field after them, may contribute
+    // several intervals. We count one range per combination of those intervals.
+    size_t numExploded = 0;
+    size_t numRanges = 1;
+    for (; numExploded < bounds.fields.size(); ++numExploded) {
+        const OrderedIntervalList& oil = bounds.fields[numExploded];
+        if (oil.intervals.empty()) {
+            return false;
+        }
+
+        numRanges *= oil.intervals.size();
+        if (numRanges > maxRanges) {
+            return false;
+        }
+
+        bool allPoints = true;
+        for (const Interval& interval : oil.intervals) {
+            if (!interval.isPoint()) {
+                allPoints = false;
+                break;
+            }
+        }
+
+        if (!allPoints) {
+            ++numExploded;
+            break;
+        }
+    }
+
+    // Enumerate the combinations in index order, varying the last exploded field fastest. Since
+    // the intervals of each OIL are disjoint and in index order, so are the resulting ranges.
+    std::vector<IndexKeyRange> ranges;
+    ranges.reserve(numRanges);
+
+    IndexBounds singleBounds = bounds;
+    std::vector<size_t> positions(numExploded, 0);
+    while (true) {
+        for (size_t i = 0; i < numExploded; ++i) {
+            singleBounds.fields[i].intervals.assign(1, bounds.fields[i].intervals[positions[i]]);
+        }
+
+        IndexKeyRange range;
+        if (!isSingleInterval(singleBounds,
+                              &range.startKey,
+                              &range.startKeyInclusive,
+                              &range.endKey,
+                              &range.endKeyInclusive)) {
+            return false;
+        }
+        ranges.push_back(std::move(range));
+
+        // Advance to the next combination.
+        size_t i = numExploded;
+        while (i > 0 && ++positions[i - 1] == bounds.fields[i - 1].intervals.size()) {
+            positions[i - 1] = 0;
+            --i;
+        }
+        if (i == 0) {
+            break;
+        }
+    }
+
+    rangesOut->insert(rangesOut->end(),
+                      std::make_move_iterator(ranges.begin()),
+                      std::make_move_iterator(ranges.end()));
+    return true;
+}
+
 }  // namespace mongo
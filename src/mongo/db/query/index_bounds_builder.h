@@ -164,6 +164,20 @@ public:
      */
     static Interval allValues();
 
+    /**
+     * Returns the ASCII case variants of the prefix that every string matched by the case
+     * insensitive regex 'regex' must start with, in ascending order. The prefix is shortened so
+     * there are at most kMaxCaseInsensitiveRegexPrefixes variants, and it stops before any
+     * character that case insensitive matching can pair with a non-ASCII character. Returns an
+     * empty vector if there is no usable prefix.
+     */
+    static std::vector<std::string> caseInsensitiveRegexPrefixes(const char* regex,
+                                                                 const char* flags,
+                                                                 const IndexEntry& index);
+
+    // The most intervals built for the prefix of a case insensitive regex.
+    static const size_t kMaxCaseInsensitiveRegexPrefixes = 16;
+
     static void translateRegex(const RegexMatchExpression* rme,
                                const IndexEntry& index,
                                OrderedIntervalList* oil,
@@ -201,6 +215,18 @@ public:
                                  bool* startKeyInclusive,
                                  BSONObj* endKey,
                                  bool* endKeyInclusive);
+
+    /**
+     * Returns 'true' if the bounds 'bounds' can be represented as a sequence of disjoint key
+     * ranges, each of which isSingleInterval() accepts, and there are at most 'maxRanges' of them.
+     * This is the case for bounds such as {a: {$in: [1, 2, 3]}, b: {$gt: 5}} over the index
+     * {a: 1, b: 1}: every field up to and including the first non-point field may have several
+     * intervals, and the ranges are their cross product. The ranges are appended to 'rangesOut'
+     * in index order. Returns 'false' if otherwise, leaving 'rangesOut' untouched.
+     */
+    static bool isDisjointIntervals(const IndexBounds& bounds,
+                                    size_t maxRanges,
+                                    std::vector<IndexKeyRange>* rangesOut);
 };
 
 }  // namespace mongo
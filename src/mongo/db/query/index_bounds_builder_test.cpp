@@ -556,6 +556,53 @@ TEST(IndexBoundsBuilderTest, TranslateInArray) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateLargeInWithArraysProducesSortedUnionedBounds) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder inBuilder;
+    for (int i = 999; i >= 0; --i) {
+        inBuilder.append(i);
+        if (i % 100 == 0) {
+            // Each array adds a point interval for its first element, which duplicates one of
+            // the scalar equalities, and one for the array itself.
+            inBuilder.append(BSON_ARRAY(i));
+        }
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << inBuilder.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 1010U);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      oil.intervals[i].compare(Interval(BSON("" << i << "" << i), true, true)));
+    }
+    for (int i = 0; i < 10; ++i) {
+        BSONArray array = BSON_ARRAY(i * 100);
+        Interval arrayPoint(BSON("" << array << "" << array), true, true);
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[1000 + i].compare(arrayPoint));
+    }
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+}
+
+TEST(IndexBoundsBuilderTest, UnionizeMergesOverlappingAndContainedIntervals) {
+    OrderedIntervalList oil;
+    oil.intervals.push_back(Interval(BSON("" << 5 << "" << 6), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 1 << "" << 3), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 2 << "" << 4), true, false));
+    oil.intervals.push_back(Interval(BSON("" << 5 << "" << 5), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 4 << "" << 5), true, false));
+    oil.intervals.push_back(Interval(BSON("" << 8 << "" << 9), false, true));
+    IndexBoundsBuilder::unionize(&oil);
+    ASSERT_EQUALS(oil.intervals.size(), 2U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(BSON("" << 1 << "" << 6), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(BSON("" << 8 << "" << 9), false, true)));
+}
+
 TEST(IndexBoundsBuilderTest, TranslateLteBinData) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     BSONObj obj = fromjson(
@@ -1219,6 +1266,60 @@ TEST(IndexBoundsBuilderTest, SimplePrefixRegex) {
     ASSERT(tightness == IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, CaseInsensitivePrefixRegexUsesOneRangePerCaseVariant) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONObj obj = fromjson("{a: /^a1b/i}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.intervals.size(), 5U);
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[0].compare(Interval(fromjson("{'': 'A1B', '': 'A1C'}"), true, false)));
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[1].compare(Interval(fromjson("{'': 'A1b', '': 'A1c'}"), true, false)));
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[2].compare(Interval(fromjson("{'': 'a1B', '': 'a1C'}"), true, false)));
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[3].compare(Interval(fromjson("{'': 'a1b', '': 'a1c'}"), true, false)));
+    ASSERT_EQUALS(
+        Interval::INTERVAL_EQUALS,
+        oil.intervals[4].compare(Interval(fromjson("{'': /^a1b/i, '': /^a1b/i}"), true, true)));
+    ASSERT(tightness == IndexBoundsBuilder::INEXACT_COVERED);
+}
+
+TEST(CaseInsensitiveRegexPrefixesTest, PrefixIsShortenedToBoundTheNumberOfVariants) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    auto prefixes = IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^johnny", "i", testIndex);
+    ASSERT_EQUALS(prefixes.size(), IndexBoundsBuilder::kMaxCaseInsensitiveRegexPrefixes);
+    ASSERT_EQUALS(prefixes.front(), "JOHN");
+    ASSERT_EQUALS(prefixes.back(), "john");
+}
+
+TEST(CaseInsensitiveRegexPrefixesTest, NoPrefixesWithoutUsableAnchoredLiteral) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    // Not case insensitive.
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^foo", "", testIndex).empty());
+    // Not anchored.
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("foo", "i", testIndex).empty());
+    // 'k' also matches the Kelvin sign, so the prefix cannot start with it.
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^kate", "i", testIndex).empty());
+    // The prefix stops before 's'.
+    auto prefixes = IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^as", "i", testIndex);
+    ASSERT_EQUALS(prefixes.size(), 2U);
+    ASSERT_EQUALS(prefixes[0], "A");
+    ASSERT_EQUALS(prefixes[1], "a");
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testIndex.collator = &collator;
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^foo", "i", testIndex).empty());
+}
+
 //
 // isSingleInterval
 //
@@ -1405,6 +1506,91 @@ TEST(IndexBoundsBuilderTest, EqualitySingleMissingSingleInterval) {
     ASSERT(!testSingleInterval(bounds));
 }
 
+//
+// isDisjointIntervals
+//
+
+TEST(IndexBoundsBuilderTest, DisjointIntervalsPointsThenRange) {
+    // Several points, then one range, then "all values" is one range per point.
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    OrderedIntervalList oil_c("c");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+    oil_b.intervals.push_back(Interval(fromjson("{ '':7, '':Infinity }"), false, true));
+    oil_c.intervals.push_back(IndexBoundsBuilder::allValues());
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+    bounds.fields.push_back(oil_c);
+    ASSERT(!testSingleInterval(bounds));
+
+    std::vector<IndexKeyRange> ranges;
+    ASSERT(IndexBoundsBuilder::isDisjointIntervals(bounds, 10, &ranges));
+    ASSERT_EQUALS(ranges.size(), 2U);
+    ASSERT_BSONOBJ_EQ(ranges[0].startKey, fromjson("{'': 1, '': 7, '': {$maxKey: 1}}"));
+    ASSERT_FALSE(ranges[0].startKeyInclusive);
+    ASSERT_BSONOBJ_EQ(ranges[0].endKey, fromjson("{'': 1, '': Infinity, '': {$maxKey: 1}}"));
+    ASSERT_TRUE(ranges[0].endKeyInclusive);
+    ASSERT_BSONOBJ_EQ(ranges[1].startKey, fromjson("{'': 3, '': 7, '': {$maxKey: 1}}"));
+    ASSERT_BSONOBJ_EQ(ranges[1].endKey, fromjson("{'': 3, '': Infinity, '': {$maxKey: 1}}"));
+}
+
+TEST(IndexBoundsBuilderTest, DisjointIntervalsCrossProductOfPointsAndRanges) {
+    // Points on 'a' and several ranges on 'b' give their cross product, in index order.
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 2 << "" << 2), true, true));
+    oil_b.intervals.push_back(Interval(BSON("" << 0 << "" << 5), true, false));
+    oil_b.intervals.push_back(Interval(BSON("" << 10 << "" << 20), true, true));
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+
+    std::vector<IndexKeyRange> ranges;
+    ASSERT(IndexBoundsBuilder::isDisjointIntervals(bounds, 4, &ranges));
+    ASSERT_EQUALS(ranges.size(), 4U);
+    ASSERT_BSONOBJ_EQ(ranges[0].startKey, BSON("" << 1 << "" << 0));
+    ASSERT_BSONOBJ_EQ(ranges[0].endKey, BSON("" << 1 << "" << 5));
+    ASSERT_FALSE(ranges[0].endKeyInclusive);
+    ASSERT_BSONOBJ_EQ(ranges[1].startKey, BSON("" << 1 << "" << 10));
+    ASSERT_BSONOBJ_EQ(ranges[2].startKey, BSON("" << 2 << "" << 0));
+    ASSERT_BSONOBJ_EQ(ranges[3].endKey, BSON("" << 2 << "" << 20));
+    ASSERT_TRUE(ranges[3].endKeyInclusive);
+}
+
+TEST(IndexBoundsBuilderTest, DisjointIntervalsRespectsMaxRanges) {
+    OrderedIntervalList oil_a("a");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 2 << "" << 2), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+    bounds.fields.push_back(oil_a);
+
+    std::vector<IndexKeyRange> ranges;
+    ASSERT_FALSE(IndexBoundsBuilder::isDisjointIntervals(bounds, 2, &ranges));
+    ASSERT(ranges.empty());
+    ASSERT(IndexBoundsBuilder::isDisjointIntervals(bounds, 3, &ranges));
+    ASSERT_EQUALS(ranges.size(), 3U);
+}
+
+TEST(IndexBoundsBuilderTest, DisjointIntervalsRejectsRangeAfterMultipleIntervals) {
+    // Once a field has a non-point interval, later fields must be "all values".
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 2 << "" << 5), true, true));
+    oil_b.intervals.push_back(Interval(BSON("" << 0 << "" << 5), true, true));
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+
+    std::vector<IndexKeyRange> ranges;
+    ASSERT_FALSE(IndexBoundsBuilder::isDisjointIntervals(bounds, 10, &ranges));
+    ASSERT(ranges.empty());
+}
+
 //
 // Complementing bounds for negations
 //
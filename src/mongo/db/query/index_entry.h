@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "mongo/db/index/multikey_paths.h"
@@ -38,6 +39,7 @@
 namespace mongo {
 
 class CollatorInterface;
+class IndexStatistics;
 class MatchExpression;
 
 /**
@@ -138,6 +140,10 @@ struct IndexEntry {
     // Null if this index orders strings according to the simple binary compare. If non-null,
     // represents the collator used to generate index keys for indexed strings.
     const CollatorInterface* collator = nullptr;
+
+    // Data-distribution statistics for the index, if they have been built and the planner has
+    // been asked to use them.
+    std::shared_ptr<const IndexStatistics> statistics;
 };
 
 }  // namespace mongo
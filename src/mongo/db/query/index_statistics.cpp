@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+BSONObj ownedValue(const BSONElement& elt) {
+    BSONObjBuilder bob;
+    bob.appendAs(elt, "");
+    return bob.obj();
+}
+
+}  // namespace
+
+IndexStatistics::IndexStatistics(std::vector<Bucket> buckets, Date_t lastUpdated)
+    : _buckets(std::move(buckets)), _lastUpdated(lastUpdated) {
+    for (const auto& bucket : _buckets) {
+        _numKeys += bucket.numKeys;
+        _numDistinct += bucket.numDistinct;
+    }
+}
+
+double IndexStatistics::estimateKeys(const OrderedIntervalList& oil) const {
+    double numKeys = 0;
+    for (const auto& interval : oil.intervals) {
+        numKeys += estimateKeys(interval);
+    }
+    return std::min(numKeys, static_cast<double>(_numKeys));
+}
+
+double IndexStatistics::estimateKeys(const Interval& interval) const {
+    // Orient the interval by value, regardless of the direction of the index or the scan.
+    BSONElement low = interval.start;
+    bool lowInclusive = interval.startInclusive;
+    BSONElement high = interval.end;
+    bool highInclusive = interval.endInclusive;
+    if (compareValues(low, high) > 0) {
+        std::swap(low, high);
+        std::swap(lowInclusive, highInclusive);
+    }
+
+    const bool isPoint = interval.isPoint();
+    double numKeys = 0;
+    for (const auto& bucket : _buckets) {
+        const int lowCmp = compareValues(low, bucket.min());
+        const int highCmp = compareValues(high, bucket.max());
+
+        // Skip buckets which lie entirely outside of the interval.
+        const int lowToMax = compareValues(low, bucket.max());
+        const int highToMin = compareValues(high, bucket.min());
+        if (lowToMax > 0 || (lowToMax == 0 && !lowInclusive) || highToMin < 0 ||
+            (highToMin == 0 && !highInclusive)) {
+            continue;
+        }
+
+        if (isPoint) {
+            numKeys += static_cast<double>(bucket.numKeys) / std::max(1LL, bucket.numDistinct);
+        } else if ((lowCmp < 0 || (lowCmp == 0 && lowInclusive)) &&
+                   (highCmp > 0 || (highCmp == 0 && highInclusive))) {
+            numKeys += bucket.numKeys;
+        } else {
+            numKeys += bucket.numKeys / 2.0;
+        }
+    }
+    return numKeys;
+}
+
+BSONObj IndexStatistics::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numKeys", _numKeys);
+    bob.appendNumber("numDistinct", _numDistinct);
+    bob.appendDate("lastUpdated", _lastUpdated);
+    BSONArrayBuilder histogram(bob.subarrayStart("histogram"));
+    for (const auto& bucket : _buckets) {
+        BSONObjBuilder bucketBob(histogram.subobjStart());
+        bucketBob.appendAs(bucket.min(), "min");
+        bucketBob.appendAs(bucket.max(), "max");
+        bucketBob.appendNumber("numKeys", bucket.numKeys);
+        bucketBob.appendNumber("numDistinct", bucket.numDistinct);
+    }
+    histogram.doneFast();
+    return bob.obj();
+}
+
+IndexStatisticsBuilder::IndexStatisticsBuilder(long long keysPerBucket)
+    : _keysPerBucket(std::max(1LL, keysPerBucket)) {}
+
+void IndexStatisticsBuilder::addKey(const BSONObj& key) {
+    const BSONElement value = key.firstElement();
+    const bool isNewValue = _last.isEmpty() || compareValues(value, _last.firstElement()) != 0;
+
+    if (isNewValue && _numKeys >= _keysPerBucket) {
+        closeBucket();
+    }
+
+    if (isNewValue) {
+        _last = ownedValue(value);
+        ++_numDistinct;
+        if (_min.isEmpty() || compareValues(value, _min.firstElement()) < 0) {
+            _min = _last;
+        }
+        if (_max.isEmpty() || compareValues(value, _max.firstElement()) > 0) {
+            _max = _last;
+        }
+    }
+    ++_numKeys;
+}
+
+void IndexStatisticsBuilder::closeBucket() {
+    if (_numKeys == 0) {
+        return;
+    }
+
+    IndexStatistics::Bucket bucket;
+    BSONObjBuilder bounds;
+    bounds.appendAs(_min.firstElement(), "min");
+    bounds.appendAs(_max.firstElement(), "max");
+    bucket.bounds = bounds.obj();
+    bucket.numKeys = _numKeys;
+    bucket.numDistinct = _numDistinct;
+    _buckets.push_back(std::move(bucket));
+
+    _min = BSONObj();
+    _max = BSONObj();
+    _numKeys = 0;
+    _numDistinct = 0;
+}
+
+std::unique_ptr<IndexStatistics> IndexStatisticsBuilder::done(Date_t now) {
+    closeBucket();
+    return stdx::make_unique<IndexStatistics>(std::move(_buckets), now);
+}
+
+}  // namespace mongo
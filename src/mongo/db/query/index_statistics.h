@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Data-distribution statistics for the leading field of an index: the number of keys, an
+ * estimate of the number of distinct values, and an equi-depth histogram. Built by scanning the
+ * index in key order with an IndexStatisticsBuilder.
+ *
+ * Immutable once built, so it may be shared between threads.
+ */
+class IndexStatistics {
+    MONGO_DISALLOW_COPYING(IndexStatistics);
+
+public:
+    /**
+     * A contiguous range of values of the leading index field. Values never span buckets.
+     */
+    struct Bucket {
+        // Owned object of the form {min: <value>, max: <value>}, holding the smallest and largest
+        // value in the bucket.
+        BSONObj bounds;
+
+        long long numKeys = 0;
+        long long numDistinct = 0;
+
+        BSONElement min() const {
+            return bounds["min"];
+        }
+
+        BSONElement max() const {
+            return bounds["max"];
+        }
+    };
+
+    IndexStatistics(std::vector<Bucket> buckets, Date_t lastUpdated);
+
+    long long numKeys() const {
+        return _numKeys;
+    }
+
+    long long numDistinct() const {
+        return _numDistinct;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+    Date_t getLastUpdated() const {
+        return _lastUpdated;
+    }
+
+    /**
+     * Estimates the number of keys whose leading field falls within 'oil'. Point intervals are
+     * estimated from the average frequency of the values in their bucket; ranges which only
+     * partially cover a bucket count half of its keys.
+     *
+     * 'oil' may be in either direction and must hold values compared without a collator.
+     */
+    double estimateKeys(const OrderedIntervalList& oil) const;
+
+    /**
+     * Serializes the statistics for $indexStats.
+     */
+    BSONObj toBSON() const;
+
+private:
+    double estimateKeys(const Interval& interval) const;
+
+    std::vector<Bucket> _buckets;
+    long long _numKeys = 0;
+    long long _numDistinct = 0;
+    Date_t _lastUpdated;
+};
+
+/**
+ * Builds IndexStatistics from the keys of an index, which must be added in index order.
+ */
+class IndexStatisticsBuilder {
+    MONGO_DISALLOW_COPYING(IndexStatisticsBuilder);
+
+public:
+    /**
+     * Buckets are closed once they hold at least 'keysPerBucket' keys and the next key starts a
+     * new value.
+     */
+    explicit IndexStatisticsBuilder(long long keysPerBucket);
+
+    void addKey(const BSONObj& key);
+
+    std::unique_ptr<IndexStatistics> done(Date_t now);
+
+private:
+    void closeBucket();
+
+    const long long _keysPerBucket;
+
+    std::vector<IndexStatistics::Bucket> _buckets;
+
+    // Owned copies of the smallest and largest value seen in the current bucket, and of the
+    // value of the last key added.
+    BSONObj _min;
+    BSONObj _max;
+    BSONObj _last;
+
+    long long _numKeys = 0;
+    long long _numDistinct = 0;
+};
+
+}  // namespace mongo
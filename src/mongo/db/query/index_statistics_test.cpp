@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds statistics over the keys {"": 0} .. {"": 9}, each repeated 'copies' times and added in
+ * the given direction.
+ */
+std::unique_ptr<IndexStatistics> buildStatistics(long long keysPerBucket,
+                                                 int copies,
+                                                 bool ascending = true) {
+    IndexStatisticsBuilder builder(keysPerBucket);
+    for (int i = 0; i < 10; ++i) {
+        const int value = ascending ? i : 9 - i;
+        for (int j = 0; j < copies; ++j) {
+            builder.addKey(BSON("" << value << "" << j));
+        }
+    }
+    return builder.done(Date_t());
+}
+
+OrderedIntervalList makeOil(std::vector<Interval> intervals) {
+    OrderedIntervalList oil("a");
+    oil.intervals = std::move(intervals);
+    return oil;
+}
+
+TEST(IndexStatisticsTest, BucketsDoNotSplitValues) {
+    auto stats = buildStatistics(25, 10);
+    ASSERT_EQUALS(stats->numKeys(), 100);
+    ASSERT_EQUALS(stats->numDistinct(), 10);
+
+    // Each bucket is closed at the first new value after it holds 25 keys.
+    const auto& buckets = stats->getBuckets();
+    ASSERT_EQUALS(buckets.size(), 4U);
+    ASSERT_EQUALS(buckets[0].min().numberInt(), 0);
+    ASSERT_EQUALS(buckets[0].max().numberInt(), 2);
+    ASSERT_EQUALS(buckets[0].numKeys, 30);
+    ASSERT_EQUALS(buckets[0].numDistinct, 3);
+    ASSERT_EQUALS(buckets[3].min().numberInt(), 9);
+    ASSERT_EQUALS(buckets[3].max().numberInt(), 9);
+    ASSERT_EQUALS(buckets[3].numKeys, 10);
+}
+
+TEST(IndexStatisticsTest, EstimatePointsAndRanges) {
+    auto stats = buildStatistics(25, 10);
+
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::makePointInterval(4)})), 10);
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::makePointInterval(4),
+                                               IndexBoundsBuilder::makePointInterval(7)})),
+                  20);
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::makePointInterval(42)})), 0);
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::allValues()})), 100);
+
+    // [0, 4] covers the first bucket, {0, 1, 2}, and part of the second one, {3, 4, 5}, which
+    // counts for half of its keys.
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({Interval(BSON("" << 0 << "" << 4), true, true)})),
+                  45);
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({Interval(BSON("" << 0 << "" << 5), true, true)})),
+                  60);
+
+    // Intervals over descending indexes are handled the same way.
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({Interval(BSON("" << 4 << "" << 0), true, true)})),
+                  45);
+}
+
+TEST(IndexStatisticsTest, DescendingKeyOrder) {
+    auto stats = buildStatistics(25, 10, false);
+    ASSERT_EQUALS(stats->getBuckets().size(), 4U);
+    ASSERT_EQUALS(stats->getBuckets()[0].min().numberInt(), 7);
+    ASSERT_EQUALS(stats->getBuckets()[0].max().numberInt(), 9);
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::makePointInterval(8)})), 10);
+}
+
+TEST(IndexStatisticsTest, EmptyIndex) {
+    IndexStatisticsBuilder builder(10);
+    auto stats = builder.done(Date_t());
+    ASSERT_EQUALS(stats->numKeys(), 0);
+    ASSERT(stats->getBuckets().empty());
+    ASSERT_EQUALS(stats->estimateKeys(makeOil({IndexBoundsBuilder::allValues()})), 0);
+}
+
+TEST(IndexStatisticsTest, ToBSON) {
+    auto stats = buildStatistics(50, 1);
+    ASSERT_BSONOBJ_EQ(stats->toBSON(),
+                      BSON("numKeys" << 10 << "numDistinct" << 10 << "lastUpdated" << Date_t()
+                                     << "histogram"
+                                     << BSON_ARRAY(BSON("min" << 0 << "max" << 9 << "numKeys"
+                                                              << 10
+                                                              << "numDistinct"
+                                                              << 10))));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -87,9 +87,10 @@ public:
      * kv-store is full prior to the add() operation.
      *
      * If an entry is evicted, it will be returned in
-     * an unique_ptr for the caller to use before disposing.
+     * an unique_ptr for the caller to use before disposing,
+     * and its key is stored in 'evictedKey' if non-null.
      */
-    std::unique_ptr<V> add(const K& key, V* entry) {
+    std::unique_ptr<V> add(const K& key, V* entry, K* evictedKey = nullptr) {
         // If the key already exists, delete it first.
         KVMapConstIt i = _kvMap.find(key);
         if (i != _kvMap.end()) {
@@ -111,6 +112,9 @@ public:
             invariant(evictedEntry);
 
             _kvMap.erase(_kvList.back().first);
+            if (evictedKey) {
+                *evictedKey = std::move(_kvList.back().first);
+            }
             _kvList.pop_back();
             _currentSize--;
             invariant(_currentSize == _maxSize);
@@ -140,16 +144,14 @@ public:
             return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
         }
         KVListIt found = i->second;
-        V* foundEntry = found->second;
 
         // Promote the kv-store entry to the front of the list.
-        // It is now the most recently used.
-        _kvMap.erase(i);
-        _kvList.erase(found);
-        _kvList.push_front(std::make_pair(key, foundEntry));
-        _kvMap[key] = _kvList.begin();
+        // It is now the most recently used. Splicing leaves the
+        // iterator stored in '_kvMap' valid, so the map need not
+        // be updated.
+        _kvList.splice(_kvList.begin(), _kvList, found);
 
-        *entryOut = foundEntry;
+        *entryOut = found->second;
         return Status::OK();
     }
 
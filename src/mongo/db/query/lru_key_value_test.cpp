@@ -194,4 +194,25 @@ TEST(LRUKeyValueTest, IterationTest) {
     ASSERT(i == cache.end());
 }
 
+/**
+ * Test that add() reports the key of the entry it evicts.
+ */
+TEST(LRUKeyValueTest, EvictedKeyTest) {
+    LRUKeyValue<int, int> cache(2);
+    int evictedKey = -1;
+    ASSERT(NULL == cache.add(1, new int(10), &evictedKey).get());
+    ASSERT(NULL == cache.add(2, new int(20), &evictedKey).get());
+    ASSERT_EQUALS(evictedKey, -1);
+
+    // Promote 1, so that 2 is the least recently used.
+    assertInKVStore(cache, 1, 10);
+
+    std::unique_ptr<int> evicted = cache.add(3, new int(30), &evictedKey);
+    ASSERT(NULL != evicted.get());
+    ASSERT_EQUALS(*evicted, 20);
+    ASSERT_EQUALS(evictedKey, 2);
+    assertInKVStore(cache, 1, 10);
+    assertInKVStore(cache, 3, 30);
+}
+
 }  // namespace
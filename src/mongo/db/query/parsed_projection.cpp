@@ -36,6 +36,18 @@ namespace mongo {
 using std::unique_ptr;
 using std::string;
 
+namespace {
+
+bool isPrefixOf(StringData first, StringData second) {
+    if (first.size() >= second.size()) {
+        return false;
+    }
+
+    return second.startsWith(first) && second[first.size()] == '.';
+}
+
+}  // namespace
+
 /**
  * Parses the projection 'spec' and checks its validity with respect to the query 'query'.
  * Puts covering information into 'out'.
@@ -260,6 +272,17 @@ Status ParsedProjection::make(OperationContext* opCtx,
 
     pp->_isInclusionProjection = (includeExclude == IncludeExclude::kInclude);
 
+    // Dotted inclusions can be applied by walking the included paths as a tree, unless one of
+    // them is positional or one included path lies inside another.
+    pp->_hasOnlySimpleDottedInclusions = arrayOpType != ARRAY_OP_POSITIONAL;
+    for (auto&& first : pp->_includedFields) {
+        for (auto&& second : pp->_includedFields) {
+            if (isPrefixOf(first, second)) {
+                pp->_hasOnlySimpleDottedInclusions = false;
+            }
+        }
+    }
+
     // The positional operator uses the MatchDetails from the query
     // expression to know which array element was matched.
     pp->_requiresMatchDetails = arrayOpType == ARRAY_OP_POSITIONAL;
@@ -316,18 +339,6 @@ Status ParsedProjection::make(OperationContext* opCtx,
     return Status::OK();
 }
 
-namespace {
-
-bool isPrefixOf(StringData first, StringData second) {
-    if (first.size() >= second.size()) {
-        return false;
-    }
-
-    return second.startsWith(first) && second[first.size()] == '.';
-}
-
-}  // namespace
-
 bool ParsedProjection::isFieldRetainedExactly(StringData path) const {
     // If a path, or a parent or child of the path, is contained in _metaFields or in _arrayFields,
     // our output likely does not preserve that field.
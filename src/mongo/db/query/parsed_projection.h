@@ -120,6 +120,15 @@ public:
         return _hasDottedFieldPath;
     }
 
+    /**
+     * Returns true if the dotted paths of this inclusion projection can be applied to a document
+     * by walking them as a tree: none uses the positional operator and no included path lies
+     * inside another (e.g. returns false for {'a.$': 1} and for {a: 1, 'a.b': 1}).
+     */
+    bool hasOnlySimpleDottedInclusions() const {
+        return _hasOnlySimpleDottedInclusions;
+    }
+
 private:
     /**
      * Must go through ::make
@@ -196,6 +205,8 @@ private:
     bool _wantSortKey = false;
 
     bool _hasDottedFieldPath = false;
+
+    bool _hasOnlySimpleDottedInclusions = false;
 };
 
 }  // namespace mongo
@@ -38,13 +38,16 @@
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/base/counter.h"
 #include "mongo/client/dbclientinterface.h"  // For QueryOption_foobar
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -53,6 +56,20 @@
 namespace mongo {
 namespace {
 
+Counter64 planCacheHitsCounter;
+Counter64 planCacheMissesCounter;
+Counter64 planCacheEvictionsCounter;
+Counter64 planCacheFlipsCounter;
+
+ServerStatusMetricField<Counter64> displayPlanCacheHits("query.planCache.hits",
+                                                        &planCacheHitsCounter);
+ServerStatusMetricField<Counter64> displayPlanCacheMisses("query.planCache.misses",
+                                                          &planCacheMissesCounter);
+ServerStatusMetricField<Counter64> displayPlanCacheEvictions("query.planCache.evictions",
+                                                             &planCacheEvictionsCounter);
+ServerStatusMetricField<Counter64> displayPlanCacheFlips("query.planCache.planFlips",
+                                                         &planCacheFlipsCounter);
+
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
 const char kEncodeDiscriminatorsEnd = '>';
@@ -63,11 +80,50 @@ const char kEncodeSortSection = '~';
 const char kEncodeProjectionSection = '|';
 const char kEncodeCollationSection = '#';
 
+/**
+ * Accepts the same input as the StringBuilder used to build a PlanCacheKey, but rather than
+ * storing it computes a 64-bit FNV-1a hash over exactly the bytes the StringBuilder would have
+ * appended. Hashing a query's encoding therefore gives the same result as hashing its key.
+ */
+class PlanCacheKeyHasher {
+public:
+    PlanCacheKeyHasher& operator<<(char c) {
+        _hash = (_hash ^ static_cast<unsigned char>(c)) * kPrime;
+        return *this;
+    }
+
+    PlanCacheKeyHasher& operator<<(StringData str) {
+        for (char c : str) {
+            *this << c;
+        }
+        return *this;
+    }
+
+    PlanCacheKeyHasher& operator<<(const char* str) {
+        return *this << StringData(str);
+    }
+
+    PlanCacheKeyHasher& operator<<(bool val) {
+        return *this << (val ? '1' : '0');
+    }
+
+    PlanCacheKeyHash hash() const {
+        return _hash;
+    }
+
+private:
+    static const PlanCacheKeyHash kOffsetBasis = 14695981039346656037ULL;
+    static const PlanCacheKeyHash kPrime = 1099511628211ULL;
+
+    PlanCacheKeyHash _hash = kOffsetBasis;
+};
+
 /**
  * Encode user-provided string. Cache key delimiters seen in the
  * user string are escaped with a backslash.
  */
-void encodeUserString(StringData s, StringBuilder* keyBuilder) {
+template <typename KeyBuilder>
+void encodeUserString(StringData s, KeyBuilder* keyBuilder) {
     for (size_t i = 0; i < s.size(); ++i) {
         char c = s[i];
         switch (c) {
@@ -240,7 +296,8 @@ const char* encodeMatchType(MatchExpression::MatchType mt) {
  * - geometry type
  * - CRS (flat or spherical)
  */
-void encodeGeoMatchExpression(const GeoMatchExpression* tree, StringBuilder* keyBuilder) {
+template <typename KeyBuilder>
+void encodeGeoMatchExpression(const GeoMatchExpression* tree, KeyBuilder* keyBuilder) {
     const GeoExpression& geoQuery = tree->getGeoExpression();
 
     // Type of geo query.
@@ -258,7 +315,7 @@ void encodeGeoMatchExpression(const GeoMatchExpression* tree, StringBuilder* key
 
     // Geometry type.
     // Only one of the shared_ptrs in GeoContainer may be non-NULL.
-    *keyBuilder << geoQuery.getGeometry().getDebugType();
+    *keyBuilder << StringData(geoQuery.getGeometry().getDebugType());
 
     // CRS (flat or spherical)
     if (FLAT == geoQuery.getGeometry().getNativeCRS()) {
@@ -280,7 +337,8 @@ void encodeGeoMatchExpression(const GeoMatchExpression* tree, StringBuilder* key
  * - isNearSphere
  * - CRS (flat or spherical)
  */
-void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuilder* keyBuilder) {
+template <typename KeyBuilder>
+void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, KeyBuilder* keyBuilder) {
     const GeoNearExpression& nearQuery = tree->getData();
 
     // isNearSphere
@@ -360,6 +418,17 @@ bool PlanCache::shouldCacheQuery(const CanonicalQuery& query) {
     return true;
 }
 
+//
+// SolutionTemplate
+//
+
+SolutionTemplate::SolutionTemplate(size_t plannerOptions, std::unique_ptr<QuerySolution> solution)
+    : plannerOptions(plannerOptions), solution(std::move(solution)) {
+    invariant(this->solution);
+}
+
+SolutionTemplate::~SolutionTemplate() = default;
+
 //
 // CachedSolution
 //
@@ -371,7 +440,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.decision->stats[0]->common.works) {
+      decisionWorks(entry.decision->stats[0]->common.works),
+      solutionTemplate(entry.solutionTemplate) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -434,6 +504,9 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->projection = projection.getOwned();
     entry->collation = collation.getOwned();
     entry->timeOfCreation = timeOfCreation;
+    entry->solutionTemplate = solutionTemplate;
+    entry->stats = stats;
+    entry->previousWinningSolution = previousWinningSolution;
 
     // Copy performance stats.
     for (size_t i = 0; i < feedback.size(); ++i) {
@@ -445,6 +518,17 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     return entry;
 }
 
+BSONObj PlanCacheEntryStats::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numPlanned", numPlanned);
+    bob.appendNumber("totalTrialWorks", totalTrialWorks);
+    bob.appendNumber("totalPlanningMicros", durationCount<Microseconds>(totalPlanningTime));
+    bob.appendNumber("numCacheHits", numCacheHits);
+    bob.appendNumber("numReplans", numReplans);
+    bob.appendNumber("numPlanFlips", numPlanFlips);
+    return bob.obj();
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -556,9 +640,15 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache() : PlanCache("") {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    const size_t maxSize = std::max(internalQueryCacheSize.load(), 0);
+    const size_t stripeMaxSize = (maxSize + kNumStripes - 1) / kNumStripes;
+    for (size_t i = 0; i < kNumStripes; ++i) {
+        _stripes.push_back(stdx::make_unique<Stripe>(stripeMaxSize));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -567,7 +657,8 @@ PlanCache::~PlanCache() {}
  * Appends an encoding of each node's match type and path name
  * to the output stream.
  */
-void PlanCache::encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const {
+template <typename KeyBuilder>
+void PlanCache::encodeKeyForMatch(const MatchExpression* tree, KeyBuilder* keyBuilder) const {
     // Encode match type and path.
     *keyBuilder << encodeMatchType(tree->matchType());
 
@@ -614,7 +705,8 @@ void PlanCache::encodeKeyForMatch(const MatchExpression* tree, StringBuilder* ke
  * Sort order is normalized because it provided by
  * QueryRequest.
  */
-void PlanCache::encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const {
+template <typename KeyBuilder>
+void PlanCache::encodeKeyForSort(const BSONObj& sortObj, KeyBuilder* keyBuilder) const {
     if (sortObj.isEmpty()) {
         return;
     }
@@ -652,7 +744,8 @@ void PlanCache::encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuild
  * Orders the encoded elements in the projection by field name.
  * This handles all the special projection types ($meta, $elemMatch, etc.)
  */
-void PlanCache::encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const {
+template <typename KeyBuilder>
+void PlanCache::encodeKeyForProj(const BSONObj& projObj, KeyBuilder* keyBuilder) const {
     // Sorts the BSON elements by field name using a map.
     std::map<StringData, BSONElement> elements;
 
@@ -738,10 +831,36 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    entry->stats.numPlanned = 1;
+    for (auto&& candidateStats : why->stats) {
+        entry->stats.totalTrialWorks += candidateStats->common.works;
+    }
+    entry->stats.totalPlanningTime = why->planningTime;
+
+    const PlanCacheKey key = computeKey(query);
+    const PlanCacheKeyHash hash = hashKey(key);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheEntry* replacedEntry;
+    const bool isNewKey = !stripe.cache.get(key, &replacedEntry).isOK();
+    if (!isNewKey) {
+        carryOverStats(*replacedEntry, entry);
+    }
+    PlanCacheKey evictedKey;
+    std::unique_ptr<PlanCacheEntry> evictedEntry = stripe.cache.add(key, entry, &evictedKey);
+    if (isNewKey) {
+        ++stripe.keyHashes[hash];
+    }
 
     if (NULL != evictedEntry.get()) {
+        auto evictedHash = stripe.keyHashes.find(hashKey(evictedKey));
+        invariant(evictedHash != stripe.keyHashes.end());
+        if (--evictedHash->second == 0) {
+            stripe.keyHashes.erase(evictedHash);
+        }
+
+        planCacheEvictionsCounter.increment();
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
@@ -749,18 +868,69 @@ Status PlanCache::add(const CanonicalQuery& query,
     return Status::OK();
 }
 
-Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const {
-    PlanCacheKey key = computeKey(query);
-    verify(crOut);
+void PlanCache::carryOverStats(const PlanCacheEntry& replaced, PlanCacheEntry* entry) const {
+    entry->stats.numPlanned += replaced.stats.numPlanned;
+    entry->stats.totalTrialWorks += replaced.stats.totalTrialWorks;
+    entry->stats.totalPlanningTime += replaced.stats.totalPlanningTime;
+    entry->stats.numCacheHits = replaced.stats.numCacheHits;
+    entry->stats.numReplans = replaced.stats.numReplans + 1;
+    entry->stats.numPlanFlips = replaced.stats.numPlanFlips;
+
+    const std::string newWinner = entry->plannerData[0]->toString();
+    const std::string replacedWinner = replaced.plannerData[0]->toString();
+    if (newWinner == replacedWinner) {
+        entry->previousWinningSolution = replaced.previousWinningSolution;
+        return;
+    }
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    if (newWinner == replaced.previousWinningSolution) {
+        ++entry->stats.numPlanFlips;
+        planCacheFlipsCounter.increment();
+        log() << _ns << ": query shape switched back to a plan it had replaced. query: "
+              << redact(entry->query) << " sort: " << redact(entry->sort)
+              << " projection: " << redact(entry->projection)
+              << " collation: " << entry->collation
+              << " replans: " << entry->stats.numReplans
+              << " flips: " << entry->stats.numPlanFlips << " old plan: " << redact(replacedWinner)
+              << " new plan: " << redact(newWinner);
+    }
+    entry->previousWinningSolution = replacedWinner;
+}
+
+PlanCacheEntry* PlanCache::findEntry(Stripe& stripe,
+                                     const CanonicalQuery& query,
+                                     PlanCacheKeyHash hash,
+                                     PlanCacheKey* keyOut) const {
+    // Most lookups are for queries which have no cached plan; only build the key if some cached
+    // query shape might match it.
+    if (stripe.keyHashes.find(hash) == stripe.keyHashes.end()) {
+        return nullptr;
+    }
+
+    *keyOut = computeKey(query);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    if (!stripe.cache.get(*keyOut, &entry).isOK()) {
+        return nullptr;
     }
     invariant(entry);
+    return entry;
+}
+
+Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const {
+    verify(crOut);
+    const PlanCacheKeyHash hash = computeKeyHash(query);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheKey key;
+    PlanCacheEntry* entry = findEntry(stripe, query, hash, &key);
+    if (!entry) {
+        planCacheMissesCounter.increment();
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
+    }
 
+    planCacheHitsCounter.increment();
+    ++entry->stats.numCacheHits;
     *crOut = new CachedSolution(key, *entry);
 
     return Status::OK();
@@ -771,15 +941,15 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
         return Status(ErrorCodes::BadValue, "feedback is NULL");
     }
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
-    PlanCacheKey ck = computeKey(cq);
-
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    const PlanCacheKeyHash hash = computeKeyHash(cq);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheKey key;
+    PlanCacheEntry* entry = findEntry(stripe, cq, hash, &key);
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
     }
-    invariant(entry);
 
     // We store up to a constant number of feedback entries.
     if (entry->feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load())) {
@@ -789,35 +959,84 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     return Status::OK();
 }
 
+Status PlanCache::setSolutionTemplate(const CanonicalQuery& cq,
+                                      std::shared_ptr<const SolutionTemplate> solutionTemplate) {
+    const PlanCacheKeyHash hash = computeKeyHash(cq);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheKey key;
+    PlanCacheEntry* entry = findEntry(stripe, cq, hash, &key);
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
+    }
+
+    entry->solutionTemplate = std::move(solutionTemplate);
+    return Status::OK();
+}
+
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const PlanCacheKeyHash hash = computeKeyHash(canonicalQuery);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    auto keyHash = stripe.keyHashes.find(hash);
+    if (keyHash == stripe.keyHashes.end()) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
+    }
+
+    Status status = stripe.cache.remove(computeKey(canonicalQuery));
+    if (status.isOK() && --keyHash->second == 0) {
+        stripe.keyHashes.erase(keyHash);
+    }
+    return status;
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        stripe->cache.clear();
+        stripe->keyHashes.clear();
+    }
+}
+
+template <typename KeyBuilder>
+void PlanCache::encodeKey(const CanonicalQuery& cq, KeyBuilder* keyBuilder) const {
+    encodeKeyForMatch(cq.root(), keyBuilder);
+    encodeKeyForSort(cq.getQueryRequest().getSort(), keyBuilder);
+    encodeKeyForProj(cq.getQueryRequest().getProj(), keyBuilder);
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
     StringBuilder keyBuilder;
-    encodeKeyForMatch(cq.root(), &keyBuilder);
-    encodeKeyForSort(cq.getQueryRequest().getSort(), &keyBuilder);
-    encodeKeyForProj(cq.getQueryRequest().getProj(), &keyBuilder);
+    encodeKey(cq, &keyBuilder);
     return keyBuilder.str();
 }
 
+PlanCacheKeyHash PlanCache::computeKeyHash(const CanonicalQuery& cq) const {
+    PlanCacheKeyHasher hasher;
+    encodeKey(cq, &hasher);
+    return hasher.hash();
+}
+
+// static
+PlanCacheKeyHash PlanCache::hashKey(const PlanCacheKey& key) {
+    PlanCacheKeyHasher hasher;
+    hasher << StringData(key);
+    return hasher.hash();
+}
+
 Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOut) const {
-    PlanCacheKey key = computeKey(query);
     verify(entryOut);
-
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    const PlanCacheKeyHash hash = computeKeyHash(query);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheKey key;
+    PlanCacheEntry* entry = findEntry(stripe, query, hash, &key);
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
     }
-    invariant(entry);
 
     *entryOut = entry->clone();
 
@@ -825,25 +1044,35 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
-    typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        for (auto&& keyAndEntry : stripe->cache) {
+            entries.push_back(keyAndEntry.second->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    const PlanCacheKeyHash hash = computeKeyHash(cq);
+    Stripe& stripe = getStripe(hash);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    if (stripe.keyHashes.find(hash) == stripe.keyHashes.end()) {
+        return false;
+    }
+    return stripe.cache.hasKey(computeKey(cq));
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        size += stripe->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
@@ -29,6 +29,8 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <cstdint>
+#include <memory>
 #include <set>
 
 #include "mongo/db/exec/plan_stats.h"
@@ -39,12 +41,18 @@
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 // A PlanCacheKey is a string-ified version of a query's predicate/projection/sort.
 typedef std::string PlanCacheKey;
 
+// A PlanCacheKeyHash is a hash of a PlanCacheKey, which can be computed directly from a query
+// without building the key itself.
+typedef std::uint64_t PlanCacheKeyHash;
+
 struct PlanRankingDecision;
 struct QuerySolution;
 struct QuerySolutionNode;
@@ -188,6 +196,26 @@ struct SolutionCacheData {
     bool indexFilterApplied;
 };
 
+/**
+ * A QuerySolution planned for one instance of a query shape which can be re-bound to the literal
+ * values of any other instance of the same shape without running the query planner. Only
+ * solutions whose index bounds consist entirely of exact point intervals generated from equality
+ * predicates are eligible; see QueryPlanner::makeSolutionTemplate().
+ */
+struct SolutionTemplate {
+    SolutionTemplate(size_t plannerOptions, std::unique_ptr<QuerySolution> solution);
+    ~SolutionTemplate();
+
+    // The QueryPlannerParams options the template was planned with. The template may only be
+    // used for a query planned with the same options.
+    const size_t plannerOptions;
+
+    const std::unique_ptr<const QuerySolution> solution;
+
+private:
+    MONGO_DISALLOW_COPYING(SolutionTemplate);
+};
+
 class PlanCacheEntry;
 
 /**
@@ -221,6 +249,33 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // The entry's solution template, if one has been built. Templates are immutable once
+    // published, so they are shared with the cache entry rather than copied.
+    std::shared_ptr<const SolutionTemplate> solutionTemplate;
+};
+
+/**
+ * Planning counters for one query shape, reported by planCacheListPlans.
+ */
+struct PlanCacheEntryStats {
+    BSONObj toBSON() const;
+
+    // Number of times the shape was multi-planned with the result written to the cache.
+    long long numPlanned = 0;
+
+    // Total works and time spent by the candidate plans of those trial periods.
+    long long totalTrialWorks = 0;
+    Microseconds totalPlanningTime{0};
+
+    // Number of queries which found this shape's cached plan.
+    long long numCacheHits = 0;
+
+    // Number of times the cache entry was replaced by planning the shape again.
+    long long numReplans = 0;
+
+    // Number of those replans which switched back to the winner of the entry before last.
+    long long numPlanFlips = 0;
 };
 
 /**
@@ -269,6 +324,11 @@ public:
     BSONObj collation;
     Date_t timeOfCreation;
 
+    // A template of the winning solution which lets subsequent queries of this shape skip
+    // planning. Set lazily by the first query which plans from this entry, and only if the
+    // winning solution is eligible.
+    std::shared_ptr<const SolutionTemplate> solutionTemplate;
+
     //
     // Performance stats
     //
@@ -280,6 +340,14 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    // Counters describing how this query shape has been planned. They are carried over when the
+    // entry is replaced by a replan, so they cover the shape rather than just this entry.
+    PlanCacheEntryStats stats;
+
+    // The winning solution of the entry this one replaced, if it was different, for detecting
+    // shapes whose plan keeps switching back and forth.
+    std::string previousWinningSolution;
 };
 
 /**
@@ -353,6 +421,14 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback);
 
+    /**
+     * Attaches 'solutionTemplate' to the entry corresponding to 'cq', so that later lookups
+     * return it as part of their CachedSolution. Returns an error Status if the entry isn't in
+     * the cache anymore.
+     */
+    Status setSolutionTemplate(const CanonicalQuery& cq,
+                               std::shared_ptr<const SolutionTemplate> solutionTemplate);
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -375,6 +451,20 @@ public:
      */
     PlanCacheKey computeKey(const CanonicalQuery&) const;
 
+    /**
+     * Returns the hash of the cache key corresponding to the given canonical query. This is
+     * always equal to hashKey(computeKey(cq)), but is cheaper to compute since the key itself is
+     * never materialized.
+     *
+     * Callers must hold the collection lock when calling this method.
+     */
+    PlanCacheKeyHash computeKeyHash(const CanonicalQuery& cq) const;
+
+    /**
+     * Returns the hash of a cache key, as computed by computeKeyHash().
+     */
+    static PlanCacheKeyHash hashKey(const PlanCacheKey& key);
+
     /**
      * Returns a copy of a cache entry.
      * Used by planCacheListPlans to display plan details.
@@ -415,14 +505,60 @@ public:
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
 private:
-    void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
-    void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
-    void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
+    /**
+     * The cache is split into stripes, each with its own lock and LRU list, so that lookups for
+     * different query shapes do not contend with each other. The stripe for a query is chosen
+     * by its PlanCacheKeyHash.
+     */
+    struct Stripe {
+        explicit Stripe(size_t maxSize) : cache(maxSize) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // The number of keys in 'cache' with each hash. Lookups for a query whose hash is not
+        // present here are answered without computing the query's key.
+        stdx::unordered_map<PlanCacheKeyHash, size_t> keyHashes;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+        // Protects 'cache' and 'keyHashes'.
+        stdx::mutex mutex;
+    };
+
+    static const size_t kNumStripes = 16;
+
+    Stripe& getStripe(PlanCacheKeyHash hash) const {
+        return *_stripes[hash % kNumStripes];
+    }
+
+    /**
+     * Looks up the entry for 'query', whose key hashes to 'hash', in 'stripe'. Returns nullptr if
+     * there is none. The caller must hold 'stripe.mutex'.
+     */
+    PlanCacheEntry* findEntry(Stripe& stripe,
+                              const CanonicalQuery& query,
+                              PlanCacheKeyHash hash,
+                              PlanCacheKey* keyOut) const;
+
+    /**
+     * Copies the planning counters of 'replaced' into 'entry', which is about to replace it, and
+     * logs if 'entry' switches the shape back to the plan 'replaced' had itself replaced.
+     */
+    void carryOverStats(const PlanCacheEntry& replaced, PlanCacheEntry* entry) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    /**
+     * Encodes the cache key for 'cq' into 'keyBuilder', which is either a StringBuilder or a
+     * hasher accepting the same input.
+     */
+    template <typename KeyBuilder>
+    void encodeKey(const CanonicalQuery& cq, KeyBuilder* keyBuilder) const;
+    template <typename KeyBuilder>
+    void encodeKeyForMatch(const MatchExpression* tree, KeyBuilder* keyBuilder) const;
+    template <typename KeyBuilder>
+    void encodeKeyForSort(const BSONObj& sortObj, KeyBuilder* keyBuilder) const;
+    template <typename KeyBuilder>
+    void encodeKeyForProj(const BSONObj& projObj, KeyBuilder* keyBuilder) const;
+
+    // Each stripe holds about 1/kNumStripes of the entries allowed by internalQueryCacheSize.
+    std::vector<std::unique_ptr<Stripe>> _stripes;
 
     // Full namespace of collection.
     std::string _ns;
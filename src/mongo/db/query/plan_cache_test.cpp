@@ -449,6 +449,124 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+TEST(PlanCacheTest, AddGetAndRemoveManyShapes) {
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    QueryTestServiceContext serviceContext;
+
+    // Use enough distinct shapes that every stripe of the cache holds some of them.
+    const size_t numShapes = 100;
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (size_t i = 0; i < numShapes; ++i) {
+        queries.push_back(canonicalize(BSON("a" << 1 << ("b" + std::to_string(i)) << 1)));
+        ASSERT_FALSE(planCache.contains(*queries.back()));
+        ASSERT_OK(planCache.add(*queries.back(), solns, createDecision(1U), Date_t{}));
+    }
+    ASSERT_EQUALS(planCache.size(), numShapes);
+    ASSERT_EQUALS(planCache.getAllEntries().size(), numShapes);
+
+    // Re-adding an existing shape replaces its entry.
+    ASSERT_OK(planCache.add(*queries.front(), solns, createDecision(1U), Date_t{}));
+    ASSERT_EQUALS(planCache.size(), numShapes);
+
+    for (auto&& cq : queries) {
+        CachedSolution* rawCachedSolution;
+        ASSERT_OK(planCache.get(*cq, &rawCachedSolution));
+        unique_ptr<CachedSolution> cachedSolution(rawCachedSolution);
+        ASSERT_EQUALS(cachedSolution->key, planCache.computeKey(*cq));
+    }
+
+    // A shape which was never added is not found.
+    unique_ptr<CanonicalQuery> missing(canonicalize("{c: 1, d: 1}"));
+    CachedSolution* rawCachedSolution;
+    ASSERT_NOT_OK(planCache.get(*missing, &rawCachedSolution));
+    ASSERT_NOT_OK(planCache.remove(*missing));
+
+    for (auto&& cq : queries) {
+        ASSERT_OK(planCache.remove(*cq));
+        ASSERT_FALSE(planCache.contains(*cq));
+        ASSERT_NOT_OK(planCache.remove(*cq));
+    }
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, ReplacingAnEntryKeepsShapeStatsAndCountsPlanFlips) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QueryTestServiceContext serviceContext;
+
+    QuerySolution collScan;
+    collScan.cacheData.reset(new SolutionCacheData());
+    collScan.cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    collScan.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> collScanSolns{&collScan};
+
+    QuerySolution ixScan;
+    ixScan.cacheData.reset(new SolutionCacheData());
+    ixScan.cacheData->solnType = SolutionCacheData::WHOLE_IXSCAN_SOLN;
+    ixScan.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> ixScanSolns{&ixScan};
+
+    auto getStats = [&] {
+        PlanCacheEntry* rawEntry;
+        ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+        unique_ptr<PlanCacheEntry> entry(rawEntry);
+        return entry->stats;
+    };
+
+    auto decision = [](long long works) {
+        PlanRankingDecision* why = createDecision(1U);
+        why->stats[0]->common.works = works;
+        why->planningTime = Microseconds(10);
+        return why;
+    };
+
+    ASSERT_OK(planCache.add(*cq, collScanSolns, decision(5), Date_t{}));
+    CachedSolution* rawCachedSolution;
+    ASSERT_OK(planCache.get(*cq, &rawCachedSolution));
+    delete rawCachedSolution;
+
+    auto stats = getStats();
+    ASSERT_EQUALS(1, stats.numPlanned);
+    ASSERT_EQUALS(5, stats.totalTrialWorks);
+    ASSERT_EQUALS(1, stats.numCacheHits);
+    ASSERT_EQUALS(0, stats.numReplans);
+
+    // Switching to a new plan is a replan but not a flip.
+    ASSERT_OK(planCache.add(*cq, ixScanSolns, decision(7), Date_t{}));
+    stats = getStats();
+    ASSERT_EQUALS(2, stats.numPlanned);
+    ASSERT_EQUALS(12, stats.totalTrialWorks);
+    ASSERT_EQUALS(Microseconds(20), stats.totalPlanningTime);
+    ASSERT_EQUALS(1, stats.numCacheHits);
+    ASSERT_EQUALS(1, stats.numReplans);
+    ASSERT_EQUALS(0, stats.numPlanFlips);
+
+    // Switching back to the plan that was replaced is a flip.
+    ASSERT_OK(planCache.add(*cq, collScanSolns, decision(1), Date_t{}));
+    stats = getStats();
+    ASSERT_EQUALS(3, stats.numPlanned);
+    ASSERT_EQUALS(2, stats.numReplans);
+    ASSERT_EQUALS(1, stats.numPlanFlips);
+
+    // Replanning to the same plan is neither.
+    ASSERT_OK(planCache.add(*cq, collScanSolns, decision(1), Date_t{}));
+    stats = getStats();
+    ASSERT_EQUALS(3, stats.numReplans);
+    ASSERT_EQUALS(1, stats.numPlanFlips);
+
+    // Once the shape is removed its counters start over.
+    ASSERT_OK(planCache.remove(*cq));
+    ASSERT_OK(planCache.add(*cq, collScanSolns, decision(1), Date_t{}));
+    stats = getStats();
+    ASSERT_EQUALS(1, stats.numPlanned);
+    ASSERT_EQUALS(0, stats.numReplans);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -685,15 +803,17 @@ protected:
     /**
      * Plan 'query' from the cache with sort order 'sort', projection 'proj', and collation
      * 'collation'. A mock cache entry is created using the cacheData stored inside the
-     * QuerySolution 'soln'.
+     * QuerySolution 'soln', and carries 'solnTemplate' if one is given.
      *
      * Does not take ownership of 'soln'.
      */
-    QuerySolution* planQueryFromCache(const BSONObj& query,
-                                      const BSONObj& sort,
-                                      const BSONObj& proj,
-                                      const BSONObj& collation,
-                                      const QuerySolution& soln) const {
+    QuerySolution* planQueryFromCache(
+        const BSONObj& query,
+        const BSONObj& sort,
+        const BSONObj& proj,
+        const BSONObj& collation,
+        const QuerySolution& soln,
+        std::shared_ptr<const SolutionTemplate> solnTemplate = nullptr) const {
         QueryTestServiceContext serviceContext;
         auto opCtx = serviceContext.makeOperationContext();
 
@@ -720,6 +840,7 @@ protected:
         solutions.push_back(&qs);
         PlanCacheEntry entry(solutions, createDecision(1U));
         CachedSolution cachedSoln(ck, entry);
+        cachedSoln.solutionTemplate = std::move(solnTemplate);
 
         QuerySolution* out;
         Status s = QueryPlanner::planFromCache(*scopedCq, params, cachedSoln, &out);
@@ -797,6 +918,17 @@ protected:
         delete planSoln;
     }
 
+    /**
+     * Builds a SolutionTemplate from the solution matching 'solnJson', which must have been
+     * generated for 'query' by one of the runQuery* methods. Returns null if the solution cannot
+     * be made into a template.
+     */
+    std::shared_ptr<const SolutionTemplate> buildSolutionTemplate(const BSONObj& query,
+                                                                  const string& solnJson) const {
+        unique_ptr<CanonicalQuery> cq(canonicalize(query));
+        return QueryPlanner::makeSolutionTemplate(*cq, params, *firstMatchingSolution(solnJson));
+    }
+
     /**
      * Check that the solution will not be cached. The planner will store
      * cache data inside non-cachable solutions, but will not do so for
@@ -830,6 +962,52 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScan) {
                                     "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, SolutionTemplateRebindsEqualityBounds) {
+    addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
+    runQuery(BSON("x" << 5 << "y"
+                      << "abc"));
+
+    const string solnJson = "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}";
+    auto solnTemplate = buildSolutionTemplate(BSON("x" << 5 << "y"
+                                                       << "abc"),
+                                              solnJson);
+    ASSERT(solnTemplate);
+
+    unique_ptr<QuerySolution> soln(planQueryFromCache(BSON("x" << 7 << "y"
+                                                               << "def"),
+                                                      BSONObj(),
+                                                      BSONObj(),
+                                                      BSONObj(),
+                                                      *firstMatchingSolution(solnJson),
+                                                      solnTemplate));
+    assertSolutionMatches(soln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}, "
+                          "bounds: {x: [[7, 7, true, true]], y: [['def', 'def', true, true]]}}}}}");
+
+    // A null does not fit the template, so the query is planned from the cached index tags.
+    soln.reset(planQueryFromCache(BSON("x" << BSONNULL << "y"
+                                           << "def"),
+                                  BSONObj(),
+                                  BSONObj(),
+                                  BSONObj(),
+                                  *firstMatchingSolution(solnJson),
+                                  solnTemplate));
+    assertSolutionMatches(soln.get(),
+                          "{fetch: {filter: {x: null}, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, SolutionTemplateRequiresExactEqualityBounds) {
+    addIndex(BSON("x" << 1), "x_1");
+
+    runQuery(fromjson("{x: {$gt: 5}}"));
+    ASSERT_FALSE(buildSolutionTemplate(
+        fromjson("{x: {$gt: 5}}"), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}"));
+
+    runQuery(fromjson("{x: 5, y: 6}"));
+    ASSERT_FALSE(buildSolutionTemplate(
+        fromjson("{x: 5, y: 6}"), "{fetch: {filter: {y: 6}, node: {ixscan: {pattern: {x: 1}}}}}"));
+}
+
 TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
     addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
     runQuery(BSON("x" << 5));
@@ -1371,6 +1549,7 @@ void testComputeKey(const char* queryStr,
     unique_ptr<CanonicalQuery> cq(canonicalize(queryStr, sortStr, projStr, collationStr));
     PlanCacheKey key = planCache.computeKey(*cq);
     PlanCacheKey expectedKey(expectedStr);
+    ASSERT_EQUALS(planCache.computeKeyHash(*cq), PlanCache::hashKey(key));
     if (key == expectedKey) {
         return;
     }
@@ -48,6 +48,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
@@ -343,6 +344,15 @@ void PlanExecutor::saveState() {
     // boundaries.
     WorkingSetCommon::prepareForSnapshotChange(_workingSet.get());
 
+    // Buffered results from the last batch are not owned by any stage, so we must make sure
+    // their documents survive the snapshot change ourselves.
+    for (auto id : _batchedResults) {
+        WorkingSetMember* member = _workingSet->get(id);
+        if (member->hasObj() && !member->obj.value().isOwned()) {
+            member->obj.setValue(member->obj.value().getOwned());
+        }
+    }
+
     if (!isMarkedAsKilled()) {
         _root->saveState();
     }
@@ -398,6 +408,16 @@ void PlanExecutor::invalidate(OperationContext* opCtx, const RecordId& dl, Inval
     if (!isMarkedAsKilled()) {
         _root->invalidate(opCtx, dl, type);
     }
+
+    // Any buffered result for 'dl' already holds an owned copy of its document (see saveState()),
+    // so it only needs to be detached from the RecordId.
+    for (auto id : _batchedResults) {
+        WorkingSetMember* member = _workingSet->get(id);
+        if (member->hasRecordId() && member->hasObj() && member->recordId == dl) {
+            member->recordId = RecordId();
+            member->transitionToOwnedObj();
+        }
+    }
 }
 
 PlanExecutor::ExecState PlanExecutor::getNext(BSONObj* objOut, RecordId* dlOut) {
@@ -471,7 +491,9 @@ PlanExecutor::ExecState PlanExecutor::waitForInserts(CappedInsertNotifierData* n
     uint64_t currentNotifierVersion = notifierData->notifier->getVersion();
     auto yieldResult = _yieldPolicy->yield(nullptr, [opCtx, notifierData] {
         const auto deadline = awaitDataState(opCtx).waitForInsertsDeadline;
-        notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline);
+        const auto coalesceFor =
+            Milliseconds(std::min(std::max(internalQueryAwaitDataCoalescingMS.load(), 0), 1000));
+        notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline, coalesceFor);
     });
     notifierData->lastEOFVersion = currentNotifierVersion;
 
@@ -536,8 +558,9 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         //   1) The yield policy's timer elapsed, or
         //   2) some stage requested a yield due to a document fetch, or
         //   3) we need to yield and retry due to a WriteConflictException.
-        // In all cases, the actual yielding happens here.
-        if (_yieldPolicy->shouldYield()) {
+        // In all cases, the actual yielding happens here. We never yield while holding results
+        // from a batch, since those may point into the current storage engine snapshot.
+        if (_batchedResults.empty() && _yieldPolicy->shouldYield()) {
             auto yieldStatus = _yieldPolicy->yield(fetcher.get());
             if (!yieldStatus.isOK()) {
                 if (objOut) {
@@ -553,7 +576,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         fetcher.reset();
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -640,9 +663,48 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    if (!_batchedResults.empty()) {
+        *out = _batchedResults.front();
+        _batchedResults.pop_front();
+        return PlanStage::ADVANCED;
+    }
+
+    if (_batchTerminalState) {
+        auto terminalState = *_batchTerminalState;
+        _batchTerminalState = boost::none;
+        *out = terminalState.second;
+        return terminalState.first;
+    }
+
+    const size_t batchSize = std::max(1, internalQueryExecWorkBatchSize.load());
+    if (batchSize == 1) {
+        return _root->work(out);
+    }
+
+    std::vector<WorkingSetID> batch;
+    batch.reserve(batchSize);
+    WorkingSetID last = WorkingSet::INVALID_ID;
+    PlanStage::StageState code = _root->workBatch(batchSize, &batch, &last);
+
+    if (batch.empty()) {
+        *out = last;
+        return code;
+    }
+
+    // An IS_EOF needn't be remembered, as the root will report it again when next worked.
+    if (PlanStage::NEED_TIME != code && PlanStage::IS_EOF != code) {
+        _batchTerminalState = std::make_pair(code, last);
+    }
+    _batchedResults.assign(batch.begin() + 1, batch.end());
+    *out = batch.front();
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _batchedResults.empty() && !_batchTerminalState && _root->isEOF());
 }
 
 void PlanExecutor::markAsKilled(string reason) {
@@ -29,10 +29,12 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <queue>
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
@@ -46,11 +48,9 @@ struct CappedInsertNotifierData;
 class Collection;
 class CursorManager;
 class PlanExecutor;
-class PlanStage;
 class PlanYieldPolicy;
 class RecordId;
 struct PlanStageStats;
-class WorkingSet;
 
 /**
  * If a getMore command specified a lastKnownCommittedOpTime (as secondaries do), we want to stop
@@ -485,6 +485,13 @@ private:
 
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Produces the next unit of output from the plan, either by handing out a result buffered by
+     * an earlier call to PlanStage::workBatch() or by working the root stage. Has the same
+     * contract as PlanStage::work().
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
     /**
      * New PlanExecutor instances are created with the static make() methods above.
      */
@@ -559,6 +566,17 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results produced by the most recent call to PlanStage::workBatch() on '_root' which have not
+    // yet been handed out by workRoot(), oldest first. No yield may take place while this is
+    // non-empty, other than through saveState() which makes the buffered results safe to hold
+    // across a change of snapshot.
+    std::deque<WorkingSetID> _batchedResults;
+
+    // If the most recent batch was cut short by NEED_YIELD, DEAD or FAILURE, that state and the
+    // id which accompanied it. It is returned by workRoot() once '_batchedResults'
+    // has been drained.
+    boost::optional<std::pair<PlanStage::StageState, WorkingSetID>> _batchTerminalState;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
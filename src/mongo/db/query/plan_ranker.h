@@ -37,6 +37,7 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -70,7 +71,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(QuerySolution* s, PlanStage* r, WorkingSet* w)
-        : solution(s), root(r), ws(w), failed(false) {}
+        : solution(s), root(r), ws(w), failed(false), eliminated(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +81,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // True if the plan trailed the leader by too much and was no longer worked for the rest of
+    // the trial period. Eliminated plans are still ranked, using the work done until then.
+    bool eliminated;
 };
 
 /**
@@ -101,6 +106,8 @@ struct PlanRankingDecision {
         }
         decision->scores = scores;
         decision->candidateOrder = candidateOrder;
+        decision->tieForBest = tieForBest;
+        decision->planningTime = planningTime;
         return decision;
     }
 
@@ -125,6 +132,9 @@ struct PlanRankingDecision {
     // Reading this flag is the only reliable way for callers to determine if there was a tie,
     // because the scores kept inside the PlanRankingDecision do not incorporate the EOF bonus.
     bool tieForBest = false;
+
+    // How long the candidates were worked for before this decision was made.
+    Microseconds planningTime{0};
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_yield.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
@@ -45,18 +46,22 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy p
     : _policy(exec->getOpCtx()->lockState()->isGlobalLockedRecursively() ? PlanExecutor::NO_YIELD
                                                                          : policy),
       _forceYield(false),
-      _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
+      _clockSource(exec->getOpCtx()->getServiceContext()->getFastClockSource()),
+      _elapsedTracker(_clockSource,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _lastYieldTime(_clockSource->now()),
       _planYielding(exec) {}
 
 
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource* cs)
     : _policy(policy),
       _forceYield(false),
+      _clockSource(cs),
       _elapsedTracker(cs,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _lastYieldTime(cs->now()),
       _planYielding(nullptr) {}
 
 bool PlanYieldPolicy::shouldYield() {
@@ -65,11 +70,24 @@ bool PlanYieldPolicy::shouldYield() {
     invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
     if (_forceYield)
         return true;
-    return _elapsedTracker.intervalHasElapsed();
+    if (!_elapsedTracker.intervalHasElapsed())
+        return false;
+    return !internalQueryExecYieldAdaptive.load() || _yieldWouldHelpOthers();
+}
+
+bool PlanYieldPolicy::_yieldWouldHelpOthers() const {
+    const Milliseconds maxSnapshotAge(internalQueryExecYieldMaxSnapshotAgeMS.load());
+    if (_clockSource->now() - _lastYieldTime >= maxSnapshotAge) {
+        return true;
+    }
+
+    const Locker* locker = _planYielding->getOpCtx()->lockState();
+    return locker->hasConflictingWaiters() || locker->isTicketPoolExhausted();
 }
 
 void PlanYieldPolicy::resetTimer() {
     _elapsedTracker.resetLastTime();
+    _lastYieldTime = _clockSource->now();
 }
 
 Status PlanYieldPolicy::yield(RecordFetcher* recordFetcher) {
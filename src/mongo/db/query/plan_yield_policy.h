@@ -54,7 +54,8 @@ public:
     /**
      * Used by YIELD_AUTO plan executors in order to check whether it is time to yield.
      * PlanExecutors give up their locks periodically in order to be fair to other
-     * threads.
+     * threads. Under internalQueryExecYieldAdaptive, a periodic check only yields if another
+     * operation is waiting on this one or its storage snapshot has grown old.
      */
     virtual bool shouldYield();
 
@@ -137,11 +138,23 @@ public:
     }
 
 private:
+    /**
+     * Returns true if yielding now would help some other operation: one is queued for a lock
+     * which conflicts with ours, or for a ticket, or we have held our storage snapshot for longer
+     * than internalQueryExecYieldMaxSnapshotAgeMS.
+     */
+    bool _yieldWouldHelpOthers() const;
+
     const PlanExecutor::YieldPolicy _policy;
 
     bool _forceYield;
+    ClockSource* const _clockSource;
     ElapsedTracker _elapsedTracker;
 
+    // When we last yielded, or were created. Every yield releases the storage snapshot, so this
+    // is also roughly when the current snapshot was taken.
+    Date_t _lastYieldTime;
+
     // The plan executor which this yield policy is responsible for yielding. Must
     // not outlive the plan executor.
     PlanExecutor* const _planYielding;
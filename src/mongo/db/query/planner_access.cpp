@@ -538,12 +538,28 @@ bool QueryPlannerAccess::orNeedsFetch(const ScanBuildingState* scanState) {
     } else if (scanState->loosestBounds == IndexBoundsBuilder::INEXACT_FETCH) {
         return true;
     } else {
+        // Predicates which could not be evaluated against the index keys were counted as
+        // INEXACT_FETCH by handleFilterOr().
         invariant(scanState->loosestBounds == IndexBoundsBuilder::INEXACT_COVERED);
-        const IndexEntry& index = scanState->indices[scanState->currentIndexNumber];
-        return index.multikey;
+        return false;
     }
 }
 
+// static
+bool QueryPlannerAccess::canUseCoveredFilter(const IndexEntry& index, size_t pos) {
+    if (!index.multikey) {
+        return true;
+    }
+
+    // Without path-level multikey metadata, any field of the index may be multikey.
+    if (index.multikeyPaths.empty()) {
+        return false;
+    }
+
+    invariant(pos < index.multikeyPaths.size());
+    return index.multikeyPaths[pos].empty();
+}
+
 // static
 void QueryPlannerAccess::finishAndOutputLeaf(ScanBuildingState* scanState,
                                              vector<QuerySolutionNode*>* out) {
@@ -1220,7 +1236,7 @@ QuerySolutionNode* QueryPlannerAccess::buildIndexedDataAccess(const CanonicalQue
             if (tightness == IndexBoundsBuilder::EXACT) {
                 return soln;
             } else if (tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-                       !indices[tag->index].multikey) {
+                       canUseCoveredFilter(indices[tag->index], tag->pos)) {
                 verify(NULL == soln->filter.get());
                 soln->filter.reset(autoRoot.release());
                 return soln;
@@ -1351,8 +1367,16 @@ void QueryPlannerAccess::handleFilterOr(ScanBuildingState* scanState) {
         // for affixing later.
         ++scanState->curChild;
     } else {
-        if (scanState->tightness < scanState->loosestBounds) {
-            scanState->loosestBounds = scanState->tightness;
+        // A predicate which cannot be evaluated against the index keys needs the fetch just as
+        // much as one with loose bounds.
+        IndexBoundsBuilder::BoundsTightness tightness = scanState->tightness;
+        if (tightness == IndexBoundsBuilder::INEXACT_COVERED &&
+            !canUseCoveredFilter(scanState->indices[scanState->currentIndexNumber],
+                                 scanState->ixtag->pos)) {
+            tightness = IndexBoundsBuilder::INEXACT_FETCH;
+        }
+        if (tightness < scanState->loosestBounds) {
+            scanState->loosestBounds = tightness;
         }
 
         // Detach 'child' and add it to 'curOr'.
@@ -1376,18 +1400,20 @@ void QueryPlannerAccess::handleFilterAnd(ScanBuildingState* scanState) {
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         delete child;
     } else if (scanState->tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-               (INDEX_TEXT == index.type || !index.multikey)) {
+               (INDEX_TEXT == index.type ||
+                canUseCoveredFilter(index, scanState->ixtag->pos))) {
         // The bounds are not exact, but the information needed to
         // evaluate the predicate is in the index key. Remove the
         // MatchExpression from its parent and attach it to the filter
         // of the index scan we're building.
         //
-        // We can only use this optimization if the index is NOT multikey.
-        // Suppose that we had the multikey index {x: 1} and a document
+        // We can only use this optimization if the predicate's field is NOT
+        // multikey. Suppose that we had the multikey index {x: 1} and a document
         // {x: ["a", "b"]}. Now if we query for {x: /b/} the filter might
         // ever only be applied to the index key "a". We'd incorrectly
         // conclude that the document does not match the query :( so we
-        // gotta stick to non-multikey indices.
+        // gotta stick to fields which the path-level multikey metadata
+        // shows to never hold arrays.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
 
         addFilterToSolutionNode(scanState->currentScan.get(), child, root->matchType());
@@ -384,6 +384,15 @@ public:
      */
     static bool orNeedsFetch(const ScanBuildingState* scanState);
 
+    /**
+     * Returns true if a predicate over the field at position 'pos' of 'index', whose bounds are
+     * INEXACT_COVERED, can be evaluated against the index keys instead of the fetched document.
+     * This holds unless the field may be multikey: a key then holds just one of the field's array
+     * elements, which is not enough to evaluate the predicate against the whole document. The
+     * path-level multikey metadata lets the non-multikey fields of a multikey index qualify.
+     */
+    static bool canUseCoveredFilter(const IndexEntry& index, size_t pos);
+
     static void finishTextNode(QuerySolutionNode* node, const IndexEntry& index);
 
     /**
@@ -543,6 +543,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     SortNode* sort = new SortNode();
     sort->pattern = sortObj;
+    sort->allowDiskUse = params.options & QueryPlannerParams::ALLOW_EXTERNAL_SORT;
     sort->children.push_back(solnRoot);
     solnRoot = sort;
     // When setting the limit on the sort, we need to consider both
@@ -594,6 +595,9 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
             //
             // Not allowed for geo or text, because we assume elsewhere that those
             // stages appear just once.
+            //
+            // The OR dedups by RecordId, which spilled sort results do not have.
+            sort->allowDiskUse = false;
             OrNode* orn = new OrNode();
             orn->children.push_back(sort);
             SortNode* sortClone = static_cast<SortNode*>(sort->clone());
@@ -610,6 +614,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A limited sort on the text score alone only needs the best scoring results from an
+    // unfiltered TEXT node beneath it.
+    QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit && STAGE_TEXT == sortInput->getType() && !sortInput->filter &&
+        sortObj.nFields() == 1 && QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -791,8 +803,13 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(
             // If we have a $meta sortKey, just use the project default path, as currently the
             // project fast paths cannot handle $meta sortKey projections.
             //
-            // Similarly, the fast paths cannot handle dotted field paths.
-            if (query.getProj()->wantSortKey() || query.getProj()->hasDottedFieldPath()) {
+            // Dotted field paths can only be fast-pathed when the full document is available and
+            // the paths form a simple inclusion tree; covered data is keyed by the dotted name.
+            if (query.getProj()->wantSortKey()) {
+                projType = ProjectionNode::DEFAULT;
+            } else if (query.getProj()->hasDottedFieldPath() &&
+                       (ProjectionNode::SIMPLE_DOC != projType ||
+                        !query.getProj()->hasOnlySimpleDottedInclusions())) {
                 projType = ProjectionNode::DEFAULT;
             }
         }
@@ -842,12 +859,15 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(
     // (ie. limit in raw query is negative)
     if (!hasSortStage) {
         // We don't have a sort stage. This means that, if there is a limit, we will have
-        // to enforce it ourselves since it's not handled inside SORT.
+        // to enforce it ourselves since it's not handled inside SORT, unless the write stage
+        // above the plan does that for us.
         if (qr.getLimit()) {
-            LimitNode* limit = new LimitNode();
-            limit->limit = *qr.getLimit();
-            limit->children.push_back(solnRoot.release());
-            solnRoot.reset(limit);
+            if (!(params.options & QueryPlannerParams::WRITE_STAGE_ENFORCES_LIMIT)) {
+                LimitNode* limit = new LimitNode();
+                limit->limit = *qr.getLimit();
+                limit->children.push_back(solnRoot.release());
+                solnRoot.reset(limit);
+            }
         } else if (qr.getNToReturn() && !qr.wantMore()) {
             // We have a "legacy limit", i.e. a negative ntoreturn value from an OP_QUERY style
             // find.
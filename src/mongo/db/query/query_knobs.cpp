@@ -38,14 +38,28 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationRaceMargin, double, 0.0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationRaceInterval, int, 50);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheUseSolutionTemplates, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnableUniqueIndexPointLookup, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxBatchedIdHackKeys, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsMaxShapesPerCollection, int, 100);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerIndexStatisticsPruneRatio, double, 0.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxIntersectPerAnd, int, 3);
@@ -62,10 +76,31 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortAllowDiskUse, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortThreads, int, 4);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGlobalBlockingMemoryLimitBytes, long long, 0);
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldAdaptive, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldMaxSnapshotAgeMS, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWorkBatchSize, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecFetchBatchSize, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecAndHashBloomFilterBitsPerKey, int, 10);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryShareOplogReads, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySharedOplogBufferMaxBytes, int, 64 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySharedOplogReadBatchSize, int, 1000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
@@ -74,11 +109,53 @@ MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceBatchSize, int, 128);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSampleBlockSize, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMinLocalDocs, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinForeignToLocalRatio,
+                              double,
+                              10.0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGeoLookupMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupChangePostImageBatchSize, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxFrontierQueryBytes,
+                              int,
+                              4 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelBatchSize, int, 4096);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceBucketAutoMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalPipelineResultCacheMaxBytes, int, 0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerSkipScanMaxDistinctPrefixes, int, 0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitBlockingMergeOnMongoS, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAwaitDataCoalescingMS, int, 0);
 }  // namespace mongo
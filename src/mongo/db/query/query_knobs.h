@@ -48,6 +48,13 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// If positive, candidate plans whose score trails the leading candidate's by more than this
+// margin are dropped from the trial period, which ends as soon as a single candidate remains.
+extern AtomicDouble internalQueryPlanEvaluationRaceMargin;
+
+// How many round-robin works of the candidate plans happen between score comparisons when racing.
+extern AtomicInt32 internalQueryPlanEvaluationRaceInterval;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -72,6 +79,22 @@ extern AtomicInt32 internalQueryCacheFeedbacksStored;
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;
 
+// Do plan cache hits re-bind the literals of the query into a template of the cached solution,
+// rather than re-running the planner from the cached index tags?
+extern AtomicBool internalQueryCacheUseSolutionTemplates;
+
+// Are equality queries on a field with a unique index answered by a point lookup on that index,
+// bypassing the planner and the plan cache?
+extern AtomicBool internalQueryEnableUniqueIndexPointLookup;
+
+// Up to how many _ids may an {_id: {$in: [...]}} query list to be answered by batched lookups on
+// the _id index, bypassing the planner? Zero disables the batched lookups.
+extern AtomicInt32 internalQueryMaxBatchedIdHackKeys;
+
+// How many query shapes does each collection keep execution statistics for, for $queryStats? Zero
+// disables the statistics. Read when a collection's query caches are created.
+extern AtomicInt32 internalQueryStatsMaxShapesPerCollection;
+
 //
 // Planning and enumeration.
 //
@@ -79,6 +102,10 @@ extern AtomicDouble internalQueryCacheEvictionRatio;
 // How many indexed solutions will QueryPlanner::plan output?
 extern AtomicInt32 internalQueryPlannerMaxIndexedSolutions;
 
+// If positive, QueryPlanner::plan drops indexed solutions whose number of keys examined, as
+// estimated from index statistics, exceeds the best estimate by more than this factor.
+extern AtomicDouble internalQueryPlannerIndexStatisticsPruneRatio;
+
 // How many solutions will the enumerator consider at each OR?
 extern AtomicInt32 internalQueryEnumerationMaxOrSolutions;
 
@@ -95,6 +122,11 @@ extern AtomicInt32 internalQueryMaxScansToExplode;
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
+// If a query has no indexed plans but constrains the second field of a compound index, the
+// planner also considers skipping through that index when its statistics show at most this many
+// distinct values of the leading field. Zero disables skip scans.
+extern AtomicInt32 internalQueryPlannerSkipScanMaxDistinctPrefixes;
+
 // Ignore unknown JSON Schema keywords.
 extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
@@ -104,12 +136,55 @@ extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
 extern AtomicInt32 internalQueryExecMaxBlockingSortBytes;
 
+// Do blocking sorts in find spill to disk rather than fail when they exceed
+// internalQueryExecMaxBlockingSortBytes?
+extern AtomicBool internalQueryExecSortAllowDiskUse;
+
+// Maximum number of threads which sort a large in-memory run of the external sorter, used by
+// find and aggregation sorts, $bucketAuto and index builds.
+extern AtomicInt32 internalQueryExecSortThreads;
+
+// Total bytes the blocking stages of all operations on this node may hold, as accounted by the
+// BlockingMemoryTracker. Once it is exceeded, the stages holding more than their share spill to
+// disk or fail. Zero means no limit.
+extern AtomicInt64 internalQueryGlobalBlockingMemoryLimitBytes;
+
 // Yield after this many "should yield?" checks.
 extern AtomicInt32 internalQueryExecYieldIterations;
 
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// If true, a yield check which would yield under the two knobs above only yields when another
+// operation could use what this one holds: a conflicting lock request is queued, the global lock's
+// ticket pool is exhausted, or the storage snapshot has been held for
+// internalQueryExecYieldMaxSnapshotAgeMS. Otherwise the operation keeps running.
+extern AtomicBool internalQueryExecYieldAdaptive;
+
+// Under adaptive yielding, yield anyway once this many milliseconds have passed since the last
+// yield, so that a long uncontended scan does not pin its storage snapshot indefinitely.
+extern AtomicInt32 internalQueryExecYieldMaxSnapshotAgeMS;
+
+// How many units of work the PlanExecutor asks of the root stage in one call when it needs more
+// results. Results produced by a batch are buffered and returned before the next batch is
+// started. A value of 1 disables batching.
+extern AtomicInt32 internalQueryExecWorkBatchSize;
+
+// How many results the fetch stage collects from its child before fetching their documents in
+// RecordId order. A value of 1 fetches each result as soon as it is produced.
+extern AtomicInt32 internalQueryExecFetchBatchSize;
+
+// How many bits per RecordId the hashed AND stage uses for the bloom filter that lets it discard
+// non-matching results from its later children cheaply. Zero disables the filter.
+extern AtomicInt32 internalQueryExecAndHashBloomFilterBitsPerKey;
+
+// Whether tailable majority-read scans of the oplog, such as those under change streams, read new
+// entries through one shared buffer rather than each scanning the oplog themselves. The buffer
+// holds up to 'MaxBytes' of the newest entries and is filled 'ReadBatchSize' entries at a time.
+extern AtomicBool internalQueryShareOplogReads;
+extern AtomicInt32 internalQuerySharedOplogBufferMaxBytes;
+extern AtomicInt32 internalQuerySharedOplogReadBatchSize;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -120,7 +195,53 @@ extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// The number of documents a blocking aggregation stage requests from the stage before it at once.
+extern AtomicInt32 internalDocumentSourceBatchSize;
+
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The number of consecutive records $sample reads after each record chosen by a storage engine
+// random cursor. Values above 1 trade sample independence for far fewer random seeks, and let the
+// random cursor serve proportionally larger samples before $sample falls back to a full scan.
+extern AtomicInt32 internalDocumentSourceSampleBlockSize;
+
+// A localField/foreignField $lookup switches from one query per input document to a hash join
+// against the whole foreign collection once it has joined at least 'MinLocalDocs' input documents
+// and the foreign collection holds no more than 'ForeignToLocalRatio' records per input document
+// joined so far. The hash join is abandoned if its table grows past 'MaxMemoryBytes'; zero
+// disables it.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxMemoryBytes;
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMinLocalDocs;
+extern AtomicDouble internalDocumentSourceLookupHashJoinForeignToLocalRatio;
+
+// The number of bytes of foreign documents and polygon coverings a $geoLookup may hold in memory.
+extern AtomicInt32 internalDocumentSourceGeoLookupMaxMemoryBytes;
+
+// The number of change events a fullDocument: "updateLookup" change stream reads ahead so that it
+// can look up the post-images of all their updates with one query. 1 looks up each on its own.
+extern AtomicInt32 internalDocumentSourceLookupChangePostImageBatchSize;
+
+// The number of bytes of visited documents and frontier values a $graphLookup may hold in memory
+// before it must spill the visited documents to disk, or fail if disk use is not allowed, and the
+// number of bytes of frontier values it queries for with each $in.
+extern AtomicInt32 internalDocumentSourceGraphLookupMaxMemoryBytes;
+extern AtomicInt32 internalDocumentSourceGraphLookupMaxFrontierQueryBytes;
+
+// The number of threads an unsorted $group uses to group batches of its input in parallel, and the
+// number of documents in each batch. A parallelism of 1 groups on the calling thread only.
+extern AtomicInt32 internalDocumentSourceGroupParallelism;
+extern AtomicInt32 internalDocumentSourceGroupParallelBatchSize;
+
+// The number of bytes of input a $bucketAuto may sort in memory before it must spill to disk, or
+// fail if disk use is not allowed.
+extern AtomicInt32 internalDocumentSourceBucketAutoMaxMemoryBytes;
+
+// The number of bytes of aggregation results mongod may cache. Zero disables the cache.
+extern AtomicInt32 internalPipelineResultCacheMaxBytes;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
+
+// How long an awaitData getMore, once woken by an insert, waits for more inserts before it
+// returns its batch. Zero returns as soon as it is woken. Values are capped at one second.
+extern AtomicInt32 internalQueryAwaitDataCoalescingMS;
 }  // namespace mongo
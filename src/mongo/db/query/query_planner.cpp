@@ -41,17 +41,22 @@
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -440,6 +445,142 @@ Status QueryPlanner::tagAccordingToCache(MatchExpression* filter,
     return Status::OK();
 }
 
+namespace {
+
+/**
+ * Returns true if 'query' may use a SolutionTemplate. Options which change the shape of the
+ * solution without being part of the plan cache key, or which make index bounds depend on more
+ * than the literal values of the predicates, exclude the query.
+ */
+bool canUseSolutionTemplate(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    return !query.getCollator() && !qr.getSkip() && !qr.getLimit() && !qr.getNToReturn() &&
+        qr.getMaxScan() == 0 && !qr.returnKey() && !qr.showRecordId();
+}
+
+/**
+ * If 'root' is an equality, or a conjunction of equalities over distinct paths, fills out
+ * 'equalities' with the value of each predicate keyed by its path and returns true.
+ */
+bool extractEqualities(const MatchExpression* root, std::map<StringData, BSONElement>* equalities) {
+    if (MatchExpression::EQ == root->matchType()) {
+        const auto* eq = static_cast<const EqualityMatchExpression*>(root);
+        return equalities->emplace(eq->path(), eq->getData()).second;
+    }
+
+    if (MatchExpression::AND != root->matchType() || 0 == root->numChildren()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < root->numChildren(); ++i) {
+        if (MatchExpression::EQ != root->getChild(i)->matchType() ||
+            !extractEqualities(root->getChild(i), equalities)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the index scan at the bottom of a template solution's chain of single-child stages.
+ */
+IndexScanNode* findTemplateIndexScan(QuerySolutionNode* node) {
+    while (STAGE_IXSCAN != node->getType()) {
+        invariant(node->children.size() == 1);
+        node = node->children[0];
+    }
+    return static_cast<IndexScanNode*>(node);
+}
+
+/**
+ * Returns a copy of 'solnTemplate' with its point bounds re-bound to the equality predicates of
+ * 'query', or nullptr if 'query' does not fit the template.
+ */
+std::unique_ptr<QuerySolution> bindSolutionTemplate(const CanonicalQuery& query,
+                                                    const QuerySolution& solnTemplate) {
+    std::map<StringData, BSONElement> equalities;
+    if (!canUseSolutionTemplate(query) || !extractEqualities(query.root(), &equalities)) {
+        return nullptr;
+    }
+
+    auto soln = stdx::make_unique<QuerySolution>();
+    soln->root.reset(solnTemplate.root->clone());
+    soln->hasBlockingStage = solnTemplate.hasBlockingStage;
+    soln->indexFilterApplied = solnTemplate.indexFilterApplied;
+
+    IndexScanNode* ixscan = findTemplateIndexScan(soln->root.get());
+    size_t numBound = 0;
+    for (auto& oil : ixscan->bounds.fields) {
+        const bool isPoint = oil.intervals.size() == 1 && oil.intervals[0].isPoint();
+        auto equality = equalities.find(oil.name);
+        if (equality == equalities.end()) {
+            // Fields without a predicate must be scanned in full.
+            if (isPoint) {
+                return nullptr;
+            }
+            continue;
+        }
+        if (!isPoint) {
+            return nullptr;
+        }
+
+        // Nulls and arrays generate inexact or multi-interval bounds, which require a plan of a
+        // different shape.
+        OrderedIntervalList bound(oil.name);
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translateEquality(
+            equality->second, ixscan->index, false, &bound, &tightness);
+        if (IndexBoundsBuilder::EXACT != tightness || bound.intervals.size() != 1) {
+            return nullptr;
+        }
+        oil = std::move(bound);
+        ++numBound;
+    }
+
+    // Every predicate must be answered by the index bounds, since the template has no filters.
+    if (numBound != equalities.size()) {
+        return nullptr;
+    }
+    return soln;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<SolutionTemplate> QueryPlanner::makeSolutionTemplate(
+    const CanonicalQuery& query, const QueryPlannerParams& params, const QuerySolution& soln) {
+    if (!soln.root) {
+        return nullptr;
+    }
+
+    // The solution must be a chain of filterless, literal-free stages ending in a single scan
+    // over a btree index. Any other stage may depend on the values in the query.
+    const QuerySolutionNode* node = soln.root.get();
+    while (STAGE_IXSCAN != node->getType()) {
+        const StageType type = node->getType();
+        if (node->filter || node->children.size() != 1 ||
+            (STAGE_FETCH != type && STAGE_SHARDING_FILTER != type &&
+             STAGE_KEEP_MUTATIONS != type)) {
+            return nullptr;
+        }
+        node = node->children[0];
+    }
+
+    const IndexScanNode* ixscan = static_cast<const IndexScanNode*>(node);
+    if (ixscan->filter || INDEX_BTREE != ixscan->index.type || ixscan->index.filterExpr ||
+        ixscan->index.collator || ixscan->queryCollator || ixscan->bounds.isSimpleRange) {
+        return nullptr;
+    }
+
+    // Re-binding the solution to the query it was planned for must reproduce it exactly.
+    auto bound = bindSolutionTemplate(query, soln);
+    if (!bound || findTemplateIndexScan(bound->root.get())->bounds != ixscan->bounds) {
+        return nullptr;
+    }
+
+    return stdx::make_unique<SolutionTemplate>(params.options, std::move(bound));
+}
+
 // static
 Status QueryPlanner::planFromCache(const CanonicalQuery& query,
                                    const QueryPlannerParams& params,
@@ -451,6 +592,19 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
     // A query not suitable for caching should not have made its way into the cache.
     invariant(PlanCache::shouldCacheQuery(query));
 
+    // A template of the cached solution lets us skip planning altogether by re-binding the
+    // query's literals into the template's index bounds.
+    const auto& solnTemplate = cachedSoln.solutionTemplate;
+    if (solnTemplate && solnTemplate->plannerOptions == params.options &&
+        internalQueryCacheUseSolutionTemplates.load()) {
+        if (auto soln = bindSolutionTemplate(query, *solnTemplate->solution)) {
+            LOG(5) << "Planner: solution bound from the cached template:\n"
+                   << redact(soln->toString());
+            *out = soln.release();
+            return Status::OK();
+        }
+    }
+
     // Look up winning solution in cached solution's array.
     const SolutionCacheData& winnerCacheData = *cachedSoln.plannerData[0];
 
@@ -533,6 +687,176 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
     return Status::OK();
 }
 
+namespace {
+
+/**
+ * Returns an estimate of the number of index keys examined by 'soln', or boost::none if it cannot
+ * be estimated from index statistics. Only solutions with a single index scan are estimated.
+ */
+boost::optional<double> estimateKeysExamined(const QuerySolution& soln) {
+    const IndexScanNode* ixscan = nullptr;
+    std::vector<const QuerySolutionNode*> toVisit{soln.root.get()};
+    while (!toVisit.empty()) {
+        const QuerySolutionNode* node = toVisit.back();
+        toVisit.pop_back();
+        if (STAGE_IXSCAN == node->getType()) {
+            if (ixscan) {
+                return boost::none;
+            }
+            ixscan = static_cast<const IndexScanNode*>(node);
+        }
+        toVisit.insert(toVisit.end(), node->children.begin(), node->children.end());
+    }
+
+    if (!ixscan || !ixscan->index.statistics || ixscan->bounds.isSimpleRange ||
+        ixscan->bounds.fields.empty()) {
+        return boost::none;
+    }
+    return std::max(1.0, ixscan->index.statistics->estimateKeys(ixscan->bounds.fields[0]));
+}
+
+/**
+ * Drops the solutions in 'out' which are estimated to examine far more index keys than the best
+ * one, so that they are never worked during the trial period.
+ */
+void pruneByIndexStatistics(const CanonicalQuery& query, std::vector<QuerySolution*>* out) {
+    const double ratio = internalQueryPlannerIndexStatisticsPruneRatio.load();
+    if (ratio <= 0 || out->size() < 2) {
+        return;
+    }
+
+    // With a sort or a limit, a plan which examines many keys may still be the cheapest. Only
+    // the trial period can tell.
+    const QueryRequest& qr = query.getQueryRequest();
+    if (!qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+        return;
+    }
+
+    std::vector<boost::optional<double>> estimates;
+    boost::optional<double> best;
+    for (const QuerySolution* soln : *out) {
+        estimates.push_back(estimateKeysExamined(*soln));
+        if (estimates.back() && (!best || *estimates.back() < *best)) {
+            best = estimates.back();
+        }
+    }
+    if (!best) {
+        return;
+    }
+
+    size_t numKept = 0;
+    for (size_t i = 0; i < out->size(); ++i) {
+        QuerySolution* soln = (*out)[i];
+        if (estimates[i] && *estimates[i] > *best * ratio) {
+            LOG(5) << "Planner: pruning solution estimated to examine " << *estimates[i]
+                   << " keys, best estimate is " << *best << ":" << endl
+                   << redact(soln->toString());
+            delete soln;
+            continue;
+        }
+        (*out)[numKept++] = soln;
+    }
+    out->resize(numKept);
+}
+
+/**
+ * Returns true if 'expr' is a predicate that a skip scan can turn into bounds on the second field
+ * of an index.
+ */
+bool isSkipScanPredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Adds a skip scan solution to 'out' for each compound index whose second field has a predicate
+ * in 'query' but whose leading field does not, if index statistics show few enough distinct
+ * leading values. The solution scans every value of the leading field and the predicate's bounds
+ * on the second; the index scan's bounds checker seeks from one leading value to the next, so
+ * each distinct leading value costs a seek rather than a scan of all its keys.
+ */
+void addSkipScanSolutions(const CanonicalQuery& query,
+                          const QueryPlannerParams& params,
+                          std::vector<QuerySolution*>* out) {
+    const long long maxPrefixes = internalQueryPlannerSkipScanMaxDistinctPrefixes.load();
+    if (maxPrefixes <= 0) {
+        return;
+    }
+
+    MatchExpression* root = query.root();
+    std::vector<const MatchExpression*> leaves;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            leaves.push_back(root->getChild(i));
+        }
+    } else {
+        leaves.push_back(root);
+    }
+
+    for (const IndexEntry& index : params.indices) {
+        if (index.type != INDEX_BTREE || index.sparse || index.filterExpr ||
+            index.keyPattern.nFields() < 2 || !index.statistics ||
+            index.statistics->numDistinct() > maxPrefixes ||
+            !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+            continue;
+        }
+
+        BSONObjIterator kpIt(index.keyPattern);
+        const StringData leadingField = kpIt.next().fieldNameStringData();
+        const BSONElement secondElt = kpIt.next();
+
+        bool leadingFieldConstrained = false;
+        const MatchExpression* secondFieldPred = nullptr;
+        for (const MatchExpression* leaf : leaves) {
+            if (leaf->path() == leadingField) {
+                leadingFieldConstrained = true;
+            } else if (!secondFieldPred && leaf->path() == secondElt.fieldNameStringData() &&
+                       isSkipScanPredicate(leaf)) {
+                secondFieldPred = leaf;
+            }
+        }
+        if (leadingFieldConstrained || !secondFieldPred) {
+            continue;
+        }
+
+        auto ixscan = stdx::make_unique<IndexScanNode>(index);
+        BSONObjIterator it(index.keyPattern);
+        while (it.more()) {
+            const BSONElement elt = it.next();
+            OrderedIntervalList oil(elt.fieldName());
+            if (elt.fieldNameStringData() == secondElt.fieldNameStringData()) {
+                IndexBoundsBuilder::BoundsTightness tightness;
+                IndexBoundsBuilder::translate(secondFieldPred, elt, index, &oil, &tightness);
+            } else {
+                IndexBoundsBuilder::allValuesForField(elt, &oil);
+            }
+            ixscan->bounds.fields.push_back(std::move(oil));
+        }
+        IndexBoundsBuilder::alignBounds(&ixscan->bounds, index.keyPattern);
+
+        // The whole query is applied to the fetched documents, so the bounds need not be exact.
+        auto fetch = stdx::make_unique<FetchNode>();
+        fetch->filter = root->shallowClone();
+        fetch->children.push_back(ixscan.release());
+
+        QuerySolution* soln = QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(fetch));
+        if (soln) {
+            LOG(5) << "Planner: adding skip scan solution:" << endl << redact(soln->toString());
+            out->push_back(soln);
+        }
+    }
+}
+
+}  // namespace
+
 // static
 Status QueryPlanner::plan(const CanonicalQuery& query,
                           const QueryPlannerParams& params,
@@ -919,6 +1243,8 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
     LOG(5) << "Planner: outputted " << out->size() << " indexed solutions.";
 
+    pruneByIndexStatistics(query, out);
+
     // Produce legible error message for failed OR planning with a TEXT child.
     // TODO: support collection scan for non-TEXT children of OR.
     if (out->size() == 0 && textNode != NULL && MatchExpression::OR == query.root()->matchType()) {
@@ -1047,7 +1373,10 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
         const auto* indicesToConsider = hintIndex.isEmpty() ? &params.indices : &relevantIndices;
         for (auto&& index : *indicesToConsider) {
-            if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+            // A multikey index with path-level multikey metadata may still cover a projection of
+            // its non-multikey fields, which buildWholeIXSoln() checks.
+            if (index.type != INDEX_BTREE || (index.multikey && index.multikeyPaths.empty()) ||
+                index.sparse || index.filterExpr ||
                 !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
                 continue;
             }
@@ -1085,6 +1414,10 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collscanNeeded = (0 == out->size() && canTableScan);
 
+    // Without indexed plans, a compound index may still be usable by skipping over the values
+    // of its leading field.
+    const bool skipScanPossible = possibleToCollscan && 0 == out->size() && !isTailable;
+
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
         if (NULL != collscan) {
@@ -1096,6 +1429,10 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         }
     }
 
+    if (skipScanPossible) {
+        addSkipScanSolutions(query, params, out);
+    }
+
     return Status::OK();
 }
 
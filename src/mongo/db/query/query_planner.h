@@ -74,6 +74,16 @@ public:
                                 const CachedSolution& cachedSoln,
                                 QuerySolution** out);
 
+    /**
+     * Returns a SolutionTemplate built from 'soln', which must have been planned for 'query'
+     * using 'params', or nullptr if the solution cannot be re-bound to the literals of other
+     * queries with the same shape. planFromCache() uses the template of a CachedSolution, when
+     * it has one, instead of planning from the cached index tags.
+     */
+    static std::unique_ptr<SolutionTemplate> makeSolutionTemplate(const CanonicalQuery& query,
+                                                                  const QueryPlannerParams& params,
+                                                                  const QuerySolution& soln);
+
     /**
      * Used to generated the index tag tree that will be inserted
      * into the plan cache. This data gets stashed inside a QuerySolution
@@ -2119,4 +2119,81 @@ TEST_F(QueryPlannerTest, CanExplodeMultikeyIndexScanForSortWhenSortFieldsAreNotM
         "{ixscan: {pattern: {a: 1, 'b.c': 1}, filter: null,"
         "bounds: {a: [[2,2,true,true]], 'b.c': [['MinKey','MaxKey',true,true]]}}}]}}}}");
 }
+
+TEST_F(QueryPlannerTest, InexactCoveredPredicateOnNonMultikeyFieldIsFilteredByIndexScan) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+
+    runQuery(fromjson("{a: 1, b: /foo/}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, filter: {b: /foo/}}}}}");
+}
+
+TEST_F(QueryPlannerTest, InexactCoveredPredicateOnMultikeyFieldIsFilteredAfterFetch) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+
+    runQuery(fromjson("{a: 1, b: /foo/}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: /foo/}, node: {ixscan: {pattern: {a: 1, b: 1}, filter: null}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyIndexCoversQueryOnItsNonMultikeyFields) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("tags" << 1 << "b" << 1), multikeyPaths);
+
+    runQuerySortProj(fromjson("{tags: 'x', b: /foo/}"), BSONObj(), fromjson("{_id: 0, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, b: 1}, node: "
+        "{ixscan: {pattern: {tags: 1, b: 1}, filter: {b: /foo/}}}}}");
+}
+
+TEST_F(QueryPlannerTest, OrOfInexactCoveredPredicatesOnNonMultikeyFieldIsFilteredByIndexScan) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+
+    runQuery(fromjson("{$or: [{a: 'foo'}, {a: /bar/}]}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "filter: {$or: [{a: 'foo'}, {a: /bar/}]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, OrOfInexactCoveredPredicatesOnMultikeyFieldIsFilteredAfterFetch) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+
+    runQuery(fromjson("{$or: [{a: 'foo'}, {a: /bar/}]}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {$or: [{a: 'foo'}, {a: /bar/}]}, node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, filter: null}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyIndexCoversProjectionOfItsNonMultikeyFields) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "tags" << 1), multikeyPaths);
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: {pattern: {a: 1, tags: 1}, filter: null, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], "
+        "tags: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
 }  // namespace
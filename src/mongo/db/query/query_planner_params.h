@@ -101,6 +101,23 @@ struct QueryPlannerParams {
 
         // Set this to track the most recent timestamp seen by this cursor while scanning the oplog.
         TRACK_LATEST_OPLOG_TS = 1 << 12,
+
+        // Set this to let blocking sorts spill to disk rather than fail when they exceed the
+        // memory limit. Sorted results that were spilled have no RecordId, so this must not be
+        // set when the caller needs RecordIds.
+        ALLOW_EXTERNAL_SORT = 1 << 13,
+
+        // Set this when asking getExecutorDistinct() for a plan which must return exactly one
+        // document for each distinct value of the key, as when that plan feeds a $group. Indexes
+        // which are sparse or multikey on the key are not considered, and no plan is returned if
+        // the query cannot be answered with a DISTINCT_SCAN.
+        STRICT_DISTINCT_ONLY = 1 << 14,
+
+        // Set this when the plan feeds a single-document update or delete, which stops by itself
+        // once it has written one document. A limit is then only enforced by a blocking SORT,
+        // never by a separate LIMIT stage, so that the write stage can skip a document which a
+        // concurrent write made stop matching and take the next one in sort order.
+        WRITE_STAGE_ENFORCES_LIMIT = 1 << 15,
     };
 
     // See Options enum above.
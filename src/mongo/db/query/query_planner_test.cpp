@@ -1368,6 +1368,33 @@ TEST_F(QueryPlannerTest, DottedFieldCovering) {
     // assertSolutionExists("{proj: {spec: {_id: 0, 'a.b': 1}, node: {'a.b': 1}}}");
 }
 
+TEST_F(QueryPlannerTest, DottedFieldInclusionOfFetchedDocumentUsesSimpleProjection) {
+    runQuerySortProj(fromjson("{x: 1}"), BSONObj(), fromjson("{_id: 0, 'a.b': 1, c: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, 'a.b': 1, c: 1}, type: 'simple', node: "
+        "{cscan: {dir: 1, filter: {x: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, OverlappingDottedFieldInclusionUsesDefaultProjection) {
+    runQuerySortProj(fromjson("{x: 1}"), BSONObj(), fromjson("{_id: 0, a: 1, 'a.b': 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, 'a.b': 1}, type: 'default', node: "
+        "{cscan: {dir: 1, filter: {x: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, PositionalProjectionUsesDefaultProjection) {
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{'a.$': 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {'a.$': 1}, type: 'default', node: "
+        "{cscan: {dir: 1, filter: {a: 1}}}}}");
+}
+
 TEST_F(QueryPlannerTest, IdCovering) {
     runQuerySortProj(fromjson("{_id: {$gt: 10}}"), BSONObj(), fromjson("{_id: 1}"));
 
@@ -3803,6 +3830,23 @@ TEST_F(QueryPlannerTest, NoSplitLimitedSortAsCommand) {
         "node: {ixscan: {pattern: {a: 1}}}}}}}}}");
 }
 
+// When the write stage above the plan enforces the limit, only a blocking sort carries it.
+TEST_F(QueryPlannerTest, WriteStageEnforcesLimit) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    params.options |= QueryPlannerParams::WRITE_STAGE_ENFORCES_LIMIT;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {a: 1}, sort: {b: 1}, limit: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: {a:1}, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 1, node: {sortKeyGen: {node: {fetch: {filter: null,"
+        "node: {ixscan: {pattern: {a: 1}}}}}}}}}");
+}
+
 // Same query run as a find command with a batchSize rather than a limit should not require
 // the "split limited sort" hack, and should not have any limit represented inside the plan.
 TEST_F(QueryPlannerTest, NoSplitLimitedSortAsCommandBatchSize) {
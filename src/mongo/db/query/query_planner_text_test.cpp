@@ -472,6 +472,61 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, LimitedTextScoreSortOnlyNeedsTopKFromText) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProjSkipNToReturn(fromjson("{$text: {$search: 'foo'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  2,
+                                  -3);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{skip: {n: 2, node: {proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 5, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 5}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, UnlimitedTextScoreSortNeedsAllResultsFromText) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProj(fromjson("{$text: {$search: 'foo'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 0, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedCompoundTextScoreSortNeedsAllResultsFromText) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProjSkipNToReturn(fromjson("{$text: {$search: 'foo'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}, b: 1}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  0,
+                                  -3);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 3, pattern: {a: {$meta: 'textScore'}, b: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, PredicatesOverLeadingFieldsWithSharedPathPrefixHandledCorrectly) {
     const bool multikey = true;
     addIndex(BSON("a.x" << 1 << "a.y" << 1 << "b.x" << 1 << "b.y" << 1 << "_fts"
@@ -198,6 +198,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topK) {
+        addIndent(ss, indent + 1);
+        *ss << "topK = " << topK << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -212,6 +216,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->_sort = this->_sort;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->topK = this->topK;
 
     return copy;
 }
@@ -920,6 +925,7 @@ QuerySolutionNode* SortNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->pattern = this->pattern;
     copy->limit = this->limit;
+    copy->allowDiskUse = this->allowDiskUse;
 
     return copy;
 }
@@ -1139,6 +1145,12 @@ void CountScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     *ss << "startKey = " << startKey << '\n';
     addIndent(ss, indent + 1);
     *ss << "endKey = " << endKey << '\n';
+    for (const auto& range : additionalRanges) {
+        addIndent(ss, indent + 1);
+        *ss << "startKey = " << range.startKey << '\n';
+        addIndent(ss, indent + 1);
+        *ss << "endKey = " << range.endKey << '\n';
+    }
 }
 
 QuerySolutionNode* CountScanNode::clone() const {
@@ -1150,6 +1162,7 @@ QuerySolutionNode* CountScanNode::clone() const {
     copy->startKeyInclusive = this->startKeyInclusive;
     copy->endKey = this->endKey;
     copy->endKeyInclusive = this->endKeyInclusive;
+    copy->additionalRanges = this->additionalRanges;
 
     return copy;
 }
@@ -261,6 +261,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, the TEXT node feeds a sort on the text score with this limit, so only the
+    // documents with the 'topK' highest scores are needed.
+    size_t topK = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -620,7 +624,10 @@ struct SortKeyGeneratorNode : public QuerySolutionNode {
 };
 
 struct SortNode : public QuerySolutionNode {
-    SortNode() : _sorts(SimpleBSONObjComparator::kInstance.makeBSONObjSet()), limit(0) {}
+    SortNode()
+        : _sorts(SimpleBSONObjComparator::kInstance.makeBSONObjSet()),
+          limit(0),
+          allowDiskUse(false) {}
 
     virtual ~SortNode() {}
 
@@ -660,6 +667,9 @@ struct SortNode : public QuerySolutionNode {
 
     // Sum of both limit and skip count in the parsed query.
     size_t limit;
+
+    // Whether the sort may spill to disk. See QueryPlannerParams::ALLOW_EXTERNAL_SORT.
+    bool allowDiskUse;
 };
 
 struct LimitNode : public QuerySolutionNode {
@@ -952,6 +962,9 @@ struct CountScanNode : public QuerySolutionNode {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // Key ranges to count after [startKey, endKey], in index order.
+    std::vector<IndexKeyRange> additionalRanges;
 };
 
 /**
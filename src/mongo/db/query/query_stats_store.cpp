@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+const size_t QueryStatsStore::kNumStripes;
+
+QueryStatsEntry::QueryStatsEntry(BSONObj shape) : shape(std::move(shape)) {}
+
+void QueryStatsEntry::add(const QueryExecStats& stats, Date_t now) {
+    if (count == 0) {
+        firstSeen = now;
+    }
+    lastSeen = now;
+
+    ++count;
+    totalLatency += stats.latency;
+    minLatency = std::min(minLatency, stats.latency);
+    maxLatency = std::max(maxLatency, stats.latency);
+    keysExamined += stats.keysExamined;
+    docsExamined += stats.docsExamined;
+    nReturned += stats.nReturned;
+    latencyHistogram.increment(durationCount<Microseconds>(stats.latency),
+                               Command::ReadWriteType::kRead);
+    if (stats.planSummary != lastPlanSummary) {
+        lastPlanSummary = stats.planSummary.toString();
+    }
+}
+
+BSONObj QueryStatsEntry::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("shape", shape);
+    builder.append("count", count);
+    {
+        BSONObjBuilder latencyBuilder(builder.subobjStart("latencyMicros"));
+        latencyBuilder.append("total", durationCount<Microseconds>(totalLatency));
+        latencyBuilder.append("min", durationCount<Microseconds>(minLatency));
+        latencyBuilder.append("max", durationCount<Microseconds>(maxLatency));
+    }
+    builder.append("keysExamined", keysExamined);
+    builder.append("docsExamined", docsExamined);
+    builder.append("nReturned", nReturned);
+    {
+        BSONObjBuilder histogramBuilder(builder.subobjStart("latencyStats"));
+        latencyHistogram.append(true, &histogramBuilder);
+    }
+    builder.append("lastPlanSummary", lastPlanSummary);
+    builder.append("firstSeen", firstSeen);
+    builder.append("lastSeen", lastSeen);
+    return builder.obj();
+}
+
+QueryStatsStore::QueryStatsStore(size_t maxShapes) : _enabled(maxShapes > 0) {
+    const size_t maxShapesPerStripe =
+        std::max<size_t>(1, (maxShapes + kNumStripes - 1) / kNumStripes);
+    _stripes.reserve(kNumStripes);
+    for (size_t i = 0; i < kNumStripes; ++i) {
+        _stripes.push_back(stdx::make_unique<Stripe>(maxShapesPerStripe));
+    }
+}
+
+BSONObj QueryStatsStore::makeShape(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    BSONObjBuilder builder;
+    builder.append("query", qr.getFilter());
+    builder.append("sort", qr.getSort());
+    builder.append("projection", qr.getProj());
+    if (!qr.getCollation().isEmpty()) {
+        builder.append("collation", qr.getCollation());
+    }
+    return builder.obj();
+}
+
+void QueryStatsStore::record(PlanCacheKeyHash shapeHash,
+                             const CanonicalQuery& query,
+                             const QueryExecStats& stats) {
+    if (!_enabled) {
+        return;
+    }
+
+    const Date_t now = Date_t::now();
+    Stripe& stripe = *_stripes[shapeHash % kNumStripes];
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+
+    QueryStatsEntry* entry;
+    if (!stripe.entries.get(shapeHash, &entry).isOK()) {
+        entry = new QueryStatsEntry(makeShape(query));
+        stripe.entries.add(shapeHash, entry);
+    }
+    entry->add(stats, now);
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats() const {
+    std::vector<BSONObj> stats;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe->mutex);
+        for (auto it = stripe->entries.begin(); it != stripe->entries.end(); ++it) {
+            stats.push_back(it->second->toBSON());
+        }
+    }
+    return stats;
+}
+
+size_t QueryStatsStore::size() const {
+    size_t size = 0;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe->mutex);
+        size += stripe->entries.size();
+    }
+    return size;
+}
+
+void QueryStatsStore::clear() {
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe->mutex);
+        stripe->entries.clear();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+
+/**
+ * What one query cost, as recorded into a QueryStatsStore once its first batch is produced.
+ */
+struct QueryExecStats {
+    Microseconds latency{0};
+    long long keysExamined = 0;
+    long long docsExamined = 0;
+    long long nReturned = 0;
+    StringData planSummary;
+};
+
+/**
+ * Totals of the QueryExecStats of every recorded query of one shape.
+ */
+struct QueryStatsEntry {
+    explicit QueryStatsEntry(BSONObj shape);
+
+    void add(const QueryExecStats& stats, Date_t now);
+
+    BSONObj toBSON() const;
+
+    // The query, sort, projection and collation of the first query recorded with this shape.
+    const BSONObj shape;
+
+    long long count = 0;
+    Microseconds totalLatency{0};
+    Microseconds minLatency = Microseconds::max();
+    Microseconds maxLatency{0};
+    long long keysExamined = 0;
+    long long docsExamined = 0;
+    long long nReturned = 0;
+    OperationLatencyHistogram latencyHistogram;
+    std::string lastPlanSummary;
+    Date_t firstSeen;
+    Date_t lastSeen;
+};
+
+/**
+ * Aggregates execution statistics per query shape for one collection, so that the shapes which
+ * cost the most in total can be found. Shapes are the PlanCache's, identified by the hash of their
+ * plan cache key. The store keeps at most a fixed number of shapes, evicting the least recently
+ * recorded one, and is split into stripes with their own locks so that concurrent queries of
+ * different shapes rarely contend. This class is thread-safe.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    static const size_t kNumStripes = 8;
+
+    /**
+     * Keeps up to 'maxShapes' shapes, rounded up to a multiple of kNumStripes. Zero disables
+     * recording.
+     */
+    explicit QueryStatsStore(size_t maxShapes);
+
+    /**
+     * Returns the shape recorded for the first query of a kind: the query's filter, sort,
+     * projection and, if it has one, collation.
+     */
+    static BSONObj makeShape(const CanonicalQuery& query);
+
+    /**
+     * Adds 'stats' to the entry for 'shapeHash', creating the entry with the shape of 'query' if
+     * there is none.
+     */
+    void record(PlanCacheKeyHash shapeHash,
+                const CanonicalQuery& query,
+                const QueryExecStats& stats);
+
+    /**
+     * Returns one document per shape held, as produced by QueryStatsEntry::toBSON().
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Returns the number of shapes held.
+     */
+    size_t size() const;
+
+    /**
+     * Discards every shape.
+     */
+    void clear();
+
+private:
+    struct Stripe {
+        explicit Stripe(size_t maxShapes) : entries(maxShapes) {}
+
+        mutable stdx::mutex mutex;
+        LRUKeyValue<PlanCacheKeyHash, QueryStatsEntry> entries;
+    };
+
+    const bool _enabled;
+    std::vector<std::unique_ptr<Stripe>> _stripes;
+};
+
+}  // namespace mongo
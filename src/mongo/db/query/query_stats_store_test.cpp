@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("test.collection");
+
+std::unique_ptr<CanonicalQuery> canonicalize(const char* queryStr) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson(queryStr));
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx.get(),
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+QueryExecStats makeStats(long long latencyMicros, long long nReturned, StringData planSummary) {
+    QueryExecStats stats;
+    stats.latency = Microseconds(latencyMicros);
+    stats.keysExamined = nReturned;
+    stats.docsExamined = nReturned;
+    stats.nReturned = nReturned;
+    stats.planSummary = planSummary;
+    return stats;
+}
+
+TEST(QueryStatsStoreTest, AggregatesQueriesOfOneShape) {
+    QueryStatsStore store(100);
+    auto first = canonicalize("{a: 1}");
+    auto second = canonicalize("{a: 2}");
+    store.record(1, *first, makeStats(300, 1, "IXSCAN { a: 1 }"));
+    store.record(1, *second, makeStats(100, 2, "COLLSCAN"));
+
+    auto stats = store.getStats();
+    ASSERT_EQ(1U, stats.size());
+    const BSONObj& entry = stats[0];
+
+    // The shape is that of the first query recorded.
+    ASSERT_BSONOBJ_EQ(fromjson("{query: {a: 1}, sort: {}, projection: {}}"), entry["shape"].Obj());
+    ASSERT_EQ(2, entry["count"].numberLong());
+    ASSERT_BSONOBJ_EQ(BSON("total" << 400LL << "min" << 100LL << "max" << 300LL),
+                      entry["latencyMicros"].Obj());
+    ASSERT_EQ(3, entry["keysExamined"].numberLong());
+    ASSERT_EQ(3, entry["docsExamined"].numberLong());
+    ASSERT_EQ(3, entry["nReturned"].numberLong());
+    ASSERT_EQ(2, entry["latencyStats"]["reads"]["ops"].numberLong());
+    ASSERT_EQ(400, entry["latencyStats"]["reads"]["latency"].numberLong());
+    ASSERT_EQ("COLLSCAN", entry["lastPlanSummary"].str());
+}
+
+TEST(QueryStatsStoreTest, KeepsShapesApart) {
+    QueryStatsStore store(100);
+    auto query = canonicalize("{a: 1}");
+    store.record(1, *query, makeStats(10, 1, "COLLSCAN"));
+    store.record(2, *query, makeStats(10, 1, "COLLSCAN"));
+    store.record(2, *query, makeStats(10, 1, "COLLSCAN"));
+
+    ASSERT_EQ(2U, store.size());
+    long long total = 0;
+    for (const auto& entry : store.getStats()) {
+        total += entry["count"].numberLong();
+    }
+    ASSERT_EQ(3, total);
+}
+
+TEST(QueryStatsStoreTest, EvictsLeastRecentlyRecordedShape) {
+    // One shape per stripe, and these hashes all fall in the same stripe.
+    QueryStatsStore store(QueryStatsStore::kNumStripes);
+    const PlanCacheKeyHash hashA = 0;
+    const PlanCacheKeyHash hashB = QueryStatsStore::kNumStripes;
+    auto queryA = canonicalize("{a: 1}");
+    auto queryB = canonicalize("{b: 1}");
+
+    store.record(hashA, *queryA, makeStats(10, 1, "COLLSCAN"));
+    store.record(hashB, *queryB, makeStats(10, 1, "COLLSCAN"));
+    ASSERT_EQ(1U, store.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{b: 1}"), store.getStats()[0]["shape"]["query"].Obj());
+
+    // Recording 'hashA' again starts a new entry for it.
+    store.record(hashA, *queryA, makeStats(10, 1, "COLLSCAN"));
+    ASSERT_EQ(1U, store.size());
+    auto stats = store.getStats();
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1}"), stats[0]["shape"]["query"].Obj());
+    ASSERT_EQ(1, stats[0]["count"].numberLong());
+}
+
+TEST(QueryStatsStoreTest, ZeroCapacityRecordsNothing) {
+    QueryStatsStore store(0);
+    auto query = canonicalize("{a: 1}");
+    store.record(1, *query, makeStats(10, 1, "COLLSCAN"));
+    ASSERT_EQ(0U, store.size());
+    ASSERT(store.getStats().empty());
+}
+
+TEST(QueryStatsStoreTest, ClearDiscardsEveryShape) {
+    QueryStatsStore store(100);
+    auto query = canonicalize("{a: 1}");
+    store.record(1, *query, makeStats(10, 1, "COLLSCAN"));
+    store.record(2, *query, makeStats(10, 1, "COLLSCAN"));
+    store.clear();
+    ASSERT_EQ(0U, store.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -122,6 +122,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = sn->allowDiskUse;
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -286,6 +287,14 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            // Top-k pruning is only valid if containing a positive term is enough to match the
+            // query, and if the per-document term masks can hold every term.
+            if (params.wantTextScore && params.query.getNegatedTerms().empty() &&
+                params.query.getPositivePhr().empty() && params.query.getNegatedPhr().empty() &&
+                !params.query.getCaseSensitive() && !params.query.getDiacriticSensitive() &&
+                params.query.getTermsForBounds().size() <= 64u) {
+                params.topK = node->topK;
+            }
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -343,6 +352,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.startKeyInclusive = csn->startKeyInclusive;
             params.endKey = csn->endKey;
             params.endKeyInclusive = csn->endKeyInclusive;
+            params.additionalRanges = csn->additionalRanges;
 
             return new CountScan(opCtx, params, ws);
         }
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/time_window_pruning.h"
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+
+namespace mongo {
+
+namespace {
+
+bool isOutsideWindow(Date_t date, Date_t start, Date_t end) {
+    return date < start || date >= end;
+}
+
+bool comparisonExcludesWindow(const ComparisonMatchExpression* expr, Date_t start, Date_t end) {
+    const BSONElement& data = expr->getData();
+    if (data.type() != mongo::Date) {
+        return false;
+    }
+
+    const Date_t date = data.date();
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            return isOutsideWindow(date, start, end);
+        case MatchExpression::LT:
+            return date <= start;
+        case MatchExpression::LTE:
+            return date < start;
+        case MatchExpression::GT:
+            // Dates have millisecond precision, so the latest date in the window is 'end' - 1ms.
+            return date >= end - Milliseconds(1);
+        case MatchExpression::GTE:
+            return date >= end;
+        default:
+            return false;
+    }
+}
+
+bool inExcludesWindow(const InMatchExpression* expr, Date_t start, Date_t end) {
+    if (!expr->getRegexes().empty() || expr->getEqualities().empty()) {
+        return false;
+    }
+
+    for (auto&& equality : expr->getEqualities()) {
+        if (equality.type() != mongo::Date || !isOutsideWindow(equality.date(), start, end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool timeWindowExcludesQuery(const MatchExpression* root,
+                             StringData field,
+                             Date_t start,
+                             Date_t end) {
+    switch (root->matchType()) {
+        case MatchExpression::AND:
+            for (size_t i = 0; i < root->numChildren(); ++i) {
+                if (timeWindowExcludesQuery(root->getChild(i), field, start, end)) {
+                    return true;
+                }
+            }
+            return false;
+        case MatchExpression::OR:
+            if (root->numChildren() == 0) {
+                return false;
+            }
+            for (size_t i = 0; i < root->numChildren(); ++i) {
+                if (!timeWindowExcludesQuery(root->getChild(i), field, start, end)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::ALWAYS_FALSE:
+            return true;
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            if (root->path() != field) {
+                return false;
+            }
+            return comparisonExcludesWindow(
+                static_cast<const ComparisonMatchExpression*>(root), start, end);
+        case MatchExpression::MATCH_IN:
+            if (root->path() != field) {
+                return false;
+            }
+            return inExcludesWindow(static_cast<const InMatchExpression*>(root), start, end);
+        default:
+            return false;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/time_window_pruning.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000);
+const Date_t kEnd = Date_t::fromMillisSinceEpoch(2000);
+
+bool excludes(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = MatchExpressionParser::parse(query, expCtx);
+    ASSERT_OK(expr.getStatus());
+    return timeWindowExcludesQuery(expr.getValue().get(), "ts", kStart, kEnd);
+}
+
+TEST(TimeWindowPruningTest, ComparisonsOutsideTheWindowExcludeIt) {
+    ASSERT_TRUE(excludes(fromjson("{ts: {$date: 999}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$date: 2000}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$lt: {$date: 1000}}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$lte: {$date: 999}}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$gt: {$date: 1999}}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$gte: {$date: 2000}}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$in: [{$date: 1}, {$date: 3000}]}}")));
+}
+
+TEST(TimeWindowPruningTest, ComparisonsInsideTheWindowDoNotExcludeIt) {
+    ASSERT_FALSE(excludes(fromjson("{ts: {$date: 1000}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$date: 1999}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$lt: {$date: 1001}}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$lte: {$date: 1000}}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$gt: {$date: 1998}}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$gte: {$date: 1999}}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$in: [{$date: 1}, {$date: 1500}]}}")));
+}
+
+TEST(TimeWindowPruningTest, OnlyDatePredicatesOnTheWindowFieldAreConsidered) {
+    ASSERT_FALSE(excludes(fromjson("{other: {$date: 999}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: 5}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$in: [{$date: 1}, /a/]}}")));
+    ASSERT_FALSE(excludes(fromjson("{ts: {$not: {$gte: {$date: 1000}}}}")));
+    ASSERT_FALSE(excludes(fromjson("{}")));
+}
+
+TEST(TimeWindowPruningTest, ConjunctionsAndDisjunctions) {
+    ASSERT_TRUE(excludes(fromjson("{a: 1, ts: {$gte: {$date: 5000}}}")));
+    ASSERT_TRUE(excludes(fromjson("{ts: {$gte: {$date: 500}, $lt: {$date: 900}}}")));
+    ASSERT_TRUE(
+        excludes(fromjson("{$or: [{ts: {$lt: {$date: 900}}}, {ts: {$gte: {$date: 2000}}}]}")));
+    ASSERT_FALSE(excludes(fromjson("{$or: [{ts: {$lt: {$date: 900}}}, {a: 1}]}")));
+    ASSERT_TRUE(excludes(fromjson("{$alwaysFalse: 1}")));
+}
+
+}  // namespace
+}  // namespace mongo
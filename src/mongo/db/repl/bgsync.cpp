@@ -55,12 +55,14 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -136,6 +138,37 @@ static ServerStatusMetricField<Counter64> displayBufferSize("repl.buffer.sizeByt
 static Counter64 bufferMaxSizeGauge;
 static ServerStatusMetricField<Counter64> displayBufferMaxSize("repl.buffer.maxSizeBytes",
                                                                &bufferMaxSizeGauge);
+// The time the producer spent waiting for space in the buffer before it could add a fetched batch.
+// Fetching only waits when the applier falls behind, so this shows how much of the lag is due to
+// application rather than to the network.
+static Counter64 bufferWaitForSpaceMillis;
+static ServerStatusMetricField<Counter64> displayBufferWaitForSpaceMillis(
+    "repl.buffer.waitForSpaceMillis", &bufferWaitForSpaceMillis);
+
+// The distribution of the time operations spent in the buffer between being fetched and being
+// taken by the applier.
+static MicrosHistogramStats bufferWaitLatencyStats;
+static ServerStatusMetricField<MicrosHistogramStats> displayBufferWaitLatency(
+    "repl.latency.bufferWait", &bufferWaitLatencyStats);
+
+// The timestamp, in seconds, of the newest operation fetched into the buffer.
+static AtomicInt64 lastFetchedTimestampSecs;
+
+/**
+ * Reports how many seconds of oplog have been fetched but not applied yet: the difference between
+ * the timestamps of the newest fetched and the newest applied operations.
+ */
+class FetchedAheadOfAppliedMetric : public ServerStatusMetric {
+public:
+    FetchedAheadOfAppliedMetric() : ServerStatusMetric("repl.buffer.fetchedAheadOfAppliedSecs") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        const long long fetched = lastFetchedTimestampSecs.load();
+        const long long applied =
+            getGlobalReplicationCoordinator()->getMyLastAppliedOpTime().getTimestamp().getSecs();
+        b.append(_leafName, fetched > applied ? fetched - applied : 0LL);
+    }
+} fetchedAheadOfAppliedMetric;
 
 
 BackgroundSync::BackgroundSync(
@@ -518,7 +551,9 @@ Status BackgroundSync::_enqueueDocuments(Fetcher::Documents::const_iterator begi
     auto opCtx = cc().makeOperationContext();
 
     // Wait for enough space.
+    Timer waitForSpaceTimer;
     _oplogBuffer->waitForSpace(opCtx.get(), info.toApplyDocumentBytes);
+    bufferWaitForSpaceMillis.increment(waitForSpaceTimer.millis());
 
     {
         // Don't add more to the buffer if we are in shutdown. Continue holding the lock until we
@@ -536,10 +571,12 @@ Status BackgroundSync::_enqueueDocuments(Fetcher::Documents::const_iterator begi
 
         // Buffer docs for later application.
         _oplogBuffer->pushAllNonBlocking(opCtx.get(), begin, end);
+        _recordBufferedBatch(info.toApplyDocumentCount);
 
         // Update last fetched info.
         _lastFetchedHash = info.lastDocument.value;
         _lastOpTimeFetched = info.lastDocument.opTime;
+        lastFetchedTimestampSecs.store(_lastOpTimeFetched.getTimestamp().getSecs());
         LOG(3) << "batch resetting _lastOpTimeFetched: " << _lastOpTimeFetched;
     }
 
@@ -576,6 +613,7 @@ void BackgroundSync::consume(OperationContext* opCtx) {
     if (_oplogBuffer->tryPop(opCtx, &op)) {
         bufferCountGauge.decrement(1);
         bufferSizeGauge.decrement(getSize(op));
+        _recordConsumed();
     } else {
         invariant(inShutdown());
         // This means that shutdown() was called between the consumer's calls to peek() and
@@ -778,6 +816,10 @@ void BackgroundSync::start(OperationContext* opCtx) {
 
 void BackgroundSync::clearBuffer(OperationContext* opCtx) {
     _oplogBuffer->clear(opCtx);
+    {
+        stdx::lock_guard<stdx::mutex> lock(_bufferedBatchesMutex);
+        _bufferedBatches.clear();
+    }
     const auto count = bufferCountGauge.get();
     bufferCountGauge.decrement(count);
     const auto size = bufferSizeGauge.get();
@@ -833,8 +875,26 @@ bool BackgroundSync::shouldStopFetching() const {
     return false;
 }
 
+void BackgroundSync::_recordBufferedBatch(size_t count) {
+    stdx::lock_guard<stdx::mutex> lock(_bufferedBatchesMutex);
+    _bufferedBatches.push_back({Timer(), count});
+}
+
+void BackgroundSync::_recordConsumed() {
+    stdx::lock_guard<stdx::mutex> lock(_bufferedBatchesMutex);
+    if (_bufferedBatches.empty()) {
+        return;
+    }
+    auto& oldest = _bufferedBatches.front();
+    bufferWaitLatencyStats.record(oldest.enqueueTimer);
+    if (--oldest.remaining == 0) {
+        _bufferedBatches.pop_front();
+    }
+}
+
 void BackgroundSync::pushTestOpToBuffer(OperationContext* opCtx, const BSONObj& op) {
     _oplogBuffer->push(opCtx, op);
+    _recordBufferedBatch(1);
     bufferCountGauge.increment();
     bufferSizeGauge.increment(op.objsize());
 }
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/base/disallow_copying.h"
@@ -45,6 +46,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -208,6 +210,14 @@ private:
 
     OpTimeWithHash _readLastAppliedOpTimeWithHash(OperationContext* opCtx);
 
+    /**
+     * Remember when a batch of 'count' operations was added to the buffer, and record how long the
+     * oldest buffered operation waited once it is consumed. Together they measure the time spent
+     * in the buffer without changing what the buffer stores.
+     */
+    void _recordBufferedBatch(size_t count);
+    void _recordConsumed();
+
     // Production thread
     std::unique_ptr<OplogBuffer> _oplogBuffer;
 
@@ -232,6 +242,8 @@ private:
       *
       * (M)  Reads and writes guarded by _mutex
       *
+      * (B)  Reads and writes guarded by _bufferedBatchesMutex
+      *
      */
 
     // Protects member data of BackgroundSync.
@@ -265,6 +277,17 @@ private:
     // Current oplog fetcher tailing the oplog on the sync source.
     std::unique_ptr<OplogFetcher> _oplogFetcher;
 
+    struct BufferedBatch {
+        Timer enqueueTimer;
+        size_t remaining;
+    };
+
+    // Protects _bufferedBatches, which is written by the producer and read by the applier.
+    stdx::mutex _bufferedBatchesMutex;  // (S)
+
+    // The batches in the buffer, oldest first, with how many of their operations are unconsumed.
+    std::deque<BufferedBatch> _bufferedBatches;  // (B)
+
     // Current rollback process. If this component is active, we are currently reverting local
     // operations in the local oplog in order to bring this server to a consistent state relative
     // to the sync source.
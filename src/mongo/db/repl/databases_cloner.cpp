@@ -61,6 +61,10 @@ using UniqueLock = stdx::unique_lock<stdx::mutex>;
 // The number of attempts for the listDatabases commands.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListDatabasesAttempts, int, 3);
 
+// The maximum number of databases cloned at the same time. The 'admin' database is always cloned
+// on its own first.
+MONGO_EXPORT_SERVER_PARAMETER(maxNumInitialSyncDatabaseCloners, int, 1);
+
 }  // namespace
 
 
@@ -363,6 +367,7 @@ void DatabasesCloner::_onListDatabaseFinish(
             // Start first database cloner.
             if (_databaseCloners.empty()) {
                 startStatus = dbCloner->startup();
+                _databaseClonersStarted = 1;
             }
         } catch (...) {
             startStatus = exceptionToStatus();
@@ -430,20 +435,30 @@ void DatabasesCloner::_onEachDBCloneFinish(const Status& status, const std::stri
 
     _stats.databasesCloned++;
 
+    if (!_finishFn) {
+        // Another database cloner running at the same time has already failed.
+        return;
+    }
+
     if (_stats.databasesCloned == _databaseCloners.size()) {
         _succeed_inlock(&lk);
         return;
     }
 
-    // Start next database cloner.
-    auto&& dbCloner = _databaseCloners[_stats.databasesCloned];
-    auto startStatus = dbCloner->startup();
-    if (!startStatus.isOK()) {
-        warning() << "failed to schedule database '" << name << "' ("
-                  << (_stats.databasesCloned + 1) << " of " << _databaseCloners.size()
-                  << ") due to " << startStatus.toString();
-        _fail_inlock(&lk, startStatus);
-        return;
+    // Start as many of the next database cloners as may run at the same time.
+    const size_t maxRunning = std::max(1, maxNumInitialSyncDatabaseCloners.load());
+    while (_databaseClonersStarted < _databaseCloners.size() &&
+           _databaseClonersStarted - _stats.databasesCloned < maxRunning) {
+        auto&& dbCloner = _databaseCloners[_databaseClonersStarted];
+        ++_databaseClonersStarted;
+        auto startStatus = dbCloner->startup();
+        if (!startStatus.isOK()) {
+            warning() << "failed to schedule database '" << dbCloner->getDBName() << "' ("
+                      << _databaseClonersStarted << " of " << _databaseCloners.size()
+                      << ") due to " << startStatus.toString();
+            _fail_inlock(&lk, startStatus);
+            return;
+        }
     }
 }
 
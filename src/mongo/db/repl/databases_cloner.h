@@ -179,7 +179,8 @@ private:
 
     std::unique_ptr<RemoteCommandRetryScheduler> _listDBsScheduler;  // (M) scheduler for listDBs.
     std::vector<std::shared_ptr<DatabaseCloner>> _databaseCloners;   // (M) database cloners by name
-    Stats _stats;                                                    // (M)
+    size_t _databaseClonersStarted = 0;  // (M) number of cloners in '_databaseCloners' started.
+    Stats _stats;                        // (M)
 
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
@@ -38,6 +38,7 @@
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
 #include "mongo/stdx/mutex.h"
@@ -812,6 +813,64 @@ TEST_F(DBsClonerTest, FailingToScheduleSecondDatabaseClonerShouldCancelTheCloner
     ASSERT_EQUALS(ErrorCodes::OperationFailed, result);
 }
 
+TEST_F(DBsClonerTest, ClonesDatabasesAfterTheFirstOneConcurrentlyWhenConfigured) {
+    ServerParameter* maxDatabaseCloners =
+        ServerParameterSet::getGlobal()->getMap().find("maxNumInitialSyncDatabaseCloners")->second;
+    ASSERT_OK(maxDatabaseCloners->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(maxDatabaseCloners->setFromString("1")); });
+
+    Status result = getDetectableErrorStatus();
+    DatabasesCloner cloner{&getStorage(),
+                           &getExecutor(),
+                           &getDbWorkThreadPool(),
+                           HostAndPort{"local:1234"},
+                           [](const BSONObj&) { return true; },
+                           [&result](const Status& status) {
+                               log() << "setting result to " << status;
+                               result = status;
+                           }};
+
+    ASSERT_OK(cloner.startup());
+    ASSERT_TRUE(cloner.isActive());
+
+    auto net = getNet();
+    executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+    // listDatabases
+    scheduleNetworkResponse("listDatabases",
+                            fromjson("{ok:1, databases:[{name:'a'}, {name:'b'}, {name:'c'}]}"));
+    net->runReadyNetworkOperations();
+    ASSERT_TRUE(cloner.isActive());
+
+    // The first database is cloned on its own.
+    ASSERT_EQUALS("a", net->getFrontOfUnscheduledQueue()->getRequest().dbname);
+    scheduleNetworkResponse(
+        "listCollections",
+        fromjson("{ok:1, cursor:{id:NumberLong(0), ns:'a.$cmd.listCollections', firstBatch: []}}"));
+    ASSERT_FALSE(net->hasReadyRequests());
+    net->runReadyNetworkOperations();
+    ASSERT_TRUE(cloner.isActive());
+
+    // Once it is done, the two remaining databases are cloned at the same time.
+    std::vector<executor::NetworkInterfaceMock::NetworkOperationIterator> listCollections;
+    while (net->hasReadyRequests()) {
+        verifyNextRequestCommandName("listCollections");
+        listCollections.push_back(net->getNextReadyRequest());
+    }
+    ASSERT_EQUALS(2U, listCollections.size());
+    for (auto&& noi : listCollections) {
+        const std::string ns = noi->getRequest().dbname + ".$cmd.listCollections";
+        scheduleNetworkResponse(
+            noi, BSON("ok" << 1 << "cursor" << BSON("id" << 0LL << "ns" << ns << "firstBatch"
+                                                          << BSONArray())));
+    }
+    finishProcessingNetworkResponse();
+
+    cloner.join();
+    ASSERT_FALSE(cloner.isActive());
+    ASSERT_OK(result);
+    ASSERT_EQUALS(3U, cloner.getStats().databasesCloned);
+}
+
 TEST_F(DBsClonerTest, DatabaseClonerChecksAdminDbUsingStorageInterfaceAfterCopyingAdminDb) {
     Status result = getDetectableErrorStatus();
 
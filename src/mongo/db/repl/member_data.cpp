@@ -30,7 +30,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 
 #include "mongo/db/repl/member_data.h"
 #include "mongo/db/repl/rslog.h"
@@ -46,6 +48,14 @@ MemberData::MemberData() : _health(-1), _authIssue(false), _configIndex(-1), _is
 }
 
 bool MemberData::setUpValues(Date_t now, ReplSetHeartbeatResponse&& hbResponse) {
+    // Only intervals between two successful responses describe a live member; the gap spanning
+    // an outage would inflate the distribution the failure detector measures against.
+    if (_health == 1 && now > _lastHeartbeat) {
+        _heartbeatIntervals.push_back(now - _lastHeartbeat);
+        if (_heartbeatIntervals.size() > kMaxHeartbeatIntervalSamples) {
+            _heartbeatIntervals.pop_front();
+        }
+    }
     _health = 1;
     if (_upSince == Date_t()) {
         _upSince = now;
@@ -162,5 +172,58 @@ bool MemberData::advanceLastDurableOpTime(OpTime opTime, Date_t now) {
     return false;
 }
 
+double MemberData::getHeartbeatPhi(Milliseconds sinceLastHeartbeat) const {
+    if (_heartbeatIntervals.size() < kMinHeartbeatIntervalSamples) {
+        return 0.0;
+    }
+
+    double mean = 0.0;
+    for (const auto& interval : _heartbeatIntervals) {
+        mean += durationCount<Milliseconds>(interval);
+    }
+    mean /= _heartbeatIntervals.size();
+
+    double variance = 0.0;
+    for (const auto& interval : _heartbeatIntervals) {
+        const double diff = durationCount<Milliseconds>(interval) - mean;
+        variance += diff * diff;
+    }
+    variance /= _heartbeatIntervals.size();
+
+    // Perfectly regular heartbeats would otherwise make any delay infinitely suspicious.
+    const double stdDev = std::max({std::sqrt(variance), mean / 10, 1.0});
+
+    // Logistic approximation of the upper tail of a normal distribution with this mean and
+    // standard deviation.
+    const double y = (durationCount<Milliseconds>(sinceLastHeartbeat) - mean) / stdDev;
+    const double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (y > 0) {
+        return -std::log10(e / (1.0 + e));
+    }
+    return -std::log10(1.0 - 1.0 / (1.0 + e));
+}
+
+Milliseconds MemberData::getHeartbeatSuspicionDelay(double phiThreshold,
+                                                    Milliseconds maxDelay) const {
+    if (_heartbeatIntervals.size() < kMinHeartbeatIntervalSamples ||
+        getHeartbeatPhi(maxDelay) < phiThreshold) {
+        return maxDelay;
+    }
+
+    // The suspicion level only grows with the delay, so search for where it crosses over. The
+    // delay is kept positive so callers can schedule work strictly after the last response.
+    long long low = 1;
+    long long high = durationCount<Milliseconds>(maxDelay);
+    while (low < high) {
+        const long long mid = low + (high - low) / 2;
+        if (getHeartbeatPhi(Milliseconds(mid)) >= phiThreshold) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return Milliseconds(low);
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/repl_set_heartbeat_response.h"
@@ -162,6 +164,22 @@ public:
      */
     void setAuthIssue(Date_t now);
 
+    /**
+     * Returns the phi-accrual suspicion level that this member has failed when
+     * 'sinceLastHeartbeat' has passed since its last successful heartbeat response, based on the
+     * distribution of the intervals between its recent successful heartbeat responses. A phi of
+     * N means the chance of a live member being this late is about 10^-N. Returns 0 until
+     * enough intervals have been observed.
+     */
+    double getHeartbeatPhi(Milliseconds sinceLastHeartbeat) const;
+
+    /**
+     * Returns the shortest time after this member's last successful heartbeat response at which
+     * its suspicion level reaches 'phiThreshold', capped at 'maxDelay'. Returns 'maxDelay' until
+     * enough intervals have been observed.
+     */
+    Milliseconds getHeartbeatSuspicionDelay(double phiThreshold, Milliseconds maxDelay) const;
+
     /**
      * Reset the boolean to record the last restart.
      */
@@ -234,6 +252,11 @@ public:
     }
 
 private:
+    // The number of heartbeat intervals kept for the failure detector, and the number needed
+    // before it produces a suspicion level.
+    static const size_t kMaxHeartbeatIntervalSamples = 100;
+    static const size_t kMinHeartbeatIntervalSamples = 10;
+
     // -1 = not checked yet, 0 = member is down/unreachable, 1 = member is up
     int _health;
 
@@ -243,6 +266,8 @@ private:
     Date_t _lastHeartbeat;
     // This is the last time we got a heartbeat request from a given member.
     Date_t _lastHeartbeatRecv;
+    // Intervals between consecutive successful heartbeat responses, oldest first.
+    std::deque<Milliseconds> _heartbeatIntervals;
 
     // Did the last heartbeat show a failure to authenticate?
     bool _authIssue;
@@ -0,0 +1,229 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_compressed_queue.h"
+
+#include <snappy.h>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Limit buffer to 256MB, the same limit as OplogBufferBlockingQueue.
+const size_t kOplogBufferSize = 256 * 1024 * 1024;
+
+size_t getDocumentSize(const BSONObj& o) {
+    return static_cast<size_t>(o.objsize());
+}
+
+}  // namespace
+
+OplogBufferCompressedQueue::OplogBufferCompressedQueue() = default;
+
+void OplogBufferCompressedQueue::startup(OperationContext*) {}
+
+void OplogBufferCompressedQueue::shutdown(OperationContext* opCtx) {
+    clear(opCtx);
+}
+
+void OplogBufferCompressedQueue::pushEvenIfFull(OperationContext*, const Value& value) {
+    Batch batch{value};
+    auto block = _compress(batch.cbegin(), batch.cend());
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pushBlock_inlock(std::move(block));
+}
+
+void OplogBufferCompressedQueue::push(OperationContext*, const Value& value) {
+    Batch batch{value};
+    auto block = _compress(batch.cbegin(), batch.cend());
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waitForSpace_inlock(block.data.size(), lk);
+    _pushBlock_inlock(std::move(block));
+}
+
+void OplogBufferCompressedQueue::pushAllNonBlocking(OperationContext*,
+                                                    Batch::const_iterator begin,
+                                                    Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+    auto block = _compress(begin, end);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pushBlock_inlock(std::move(block));
+}
+
+void OplogBufferCompressedQueue::waitForSpace(OperationContext*, std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waitForSpace_inlock(size, lk);
+}
+
+bool OplogBufferCompressedQueue::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferCompressedQueue::getMaxSize() const {
+    return kOplogBufferSize;
+}
+
+std::size_t OplogBufferCompressedQueue::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferCompressedQueue::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferCompressedQueue::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clearing = true;
+    _blocks.clear();
+    _front.clear();
+    _size = 0;
+    _count = 0;
+    _cvNoLongerFull.notify_one();
+    _cvNoLongerEmpty.notify_one();
+}
+
+bool OplogBufferCompressedQueue::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_fillFront_inlock()) {
+        return false;
+    }
+    *value = std::move(_front.front());
+    _front.pop_front();
+    _size -= getDocumentSize(*value);
+    --_count;
+    _cvNoLongerFull.notify_one();
+    return true;
+}
+
+bool OplogBufferCompressedQueue::waitForData(Seconds waitDuration) {
+    const auto deadline = stdx::chrono::system_clock::now() + waitDuration.toSystemDuration();
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _clearing = false;
+    while (_count == 0 && !_clearing) {
+        if (stdx::cv_status::timeout == _cvNoLongerEmpty.wait_until(lk, deadline)) {
+            return false;
+        }
+    }
+    return !_clearing;
+}
+
+bool OplogBufferCompressedQueue::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_fillFront_inlock()) {
+        return false;
+    }
+    *value = _front.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferCompressedQueue::lastObjectPushed(
+    OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_blocks.empty()) {
+        return _blocks.back().last;
+    }
+    if (!_front.empty()) {
+        return _front.back();
+    }
+    return boost::none;
+}
+
+OplogBufferCompressedQueue::Block OplogBufferCompressedQueue::_compress(
+    Batch::const_iterator begin, Batch::const_iterator end) {
+    std::string raw;
+    for (auto it = begin; it != end; ++it) {
+        raw.append(it->objdata(), it->objsize());
+    }
+
+    Block block;
+    snappy::Compress(raw.data(), raw.size(), &block.data);
+    block.count = std::distance(begin, end);
+    block.last = std::prev(end)->getOwned();
+    return block;
+}
+
+void OplogBufferCompressedQueue::_pushBlock_inlock(Block block) {
+    const bool startedEmpty = _count == 0;
+    _clearing = false;
+    _size += block.data.size();
+    _count += block.count;
+    _blocks.push_back(std::move(block));
+    if (startedEmpty) {
+        _cvNoLongerEmpty.notify_one();
+    }
+}
+
+void OplogBufferCompressedQueue::_waitForSpace_inlock(std::size_t size,
+                                                      stdx::unique_lock<stdx::mutex>& lk) {
+    while (_size + size > kOplogBufferSize) {
+        _cvNoLongerFull.wait(lk);
+    }
+}
+
+bool OplogBufferCompressedQueue::_fillFront_inlock() {
+    if (!_front.empty()) {
+        return true;
+    }
+    if (_blocks.empty()) {
+        return false;
+    }
+
+    auto block = std::move(_blocks.front());
+    _blocks.pop_front();
+
+    std::string raw;
+    invariant(snappy::Uncompress(block.data.data(), block.data.size(), &raw));
+
+    std::size_t offset = 0;
+    while (offset < raw.size()) {
+        BSONObj obj(raw.data() + offset);
+        offset += obj.objsize();
+        _front.push_back(obj.getOwned());
+    }
+    invariant(offset == raw.size());
+    invariant(_front.size() == block.count);
+
+    // The entries now count against the buffer at their decompressed size. This may take the
+    // buffer over its limit, which only delays the producer until the entries are consumed.
+    _size -= block.data.size();
+    _size += raw.size();
+    return true;
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * In-memory oplog buffer which holds each batch pushed onto it as a single snappy-compressed
+ * block. Blocks are decompressed lazily, one at a time, when the consumer peeks at or pops the
+ * first entry of the block.
+ *
+ * The size reported by getSize() and bounded by getMaxSize() is the compressed size of the
+ * blocks plus the size of the decompressed entries not yet consumed. This allows considerably
+ * more operations to be buffered than OplogBufferBlockingQueue under the same memory limit.
+ *
+ * Like OplogBufferBlockingQueue, this buffer supports a single producer and a single consumer.
+ */
+class OplogBufferCompressedQueue final : public OplogBuffer {
+public:
+    OplogBufferCompressedQueue();
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+private:
+    struct Block {
+        // Snappy-compressed concatenation of the BSON documents in this block.
+        std::string data;
+        std::size_t count = 0;
+        // Kept uncompressed to answer lastObjectPushed() without decompressing the block.
+        Value last;
+    };
+
+    /**
+     * Compresses the documents in [begin, end) into a single block. Called without the mutex held.
+     */
+    static Block _compress(Batch::const_iterator begin, Batch::const_iterator end);
+
+    void _pushBlock_inlock(Block block);
+
+    void _waitForSpace_inlock(std::size_t size, stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Decompresses the oldest block into '_front' if '_front' has been fully consumed.
+     * Returns false if there is nothing left in the buffer.
+     */
+    bool _fillFront_inlock();
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _cvNoLongerFull;
+    stdx::condition_variable _cvNoLongerEmpty;
+
+    // Compressed blocks, oldest first.
+    std::deque<Block> _blocks;
+
+    // Decompressed entries of the oldest block taken off '_blocks' that have not been popped yet.
+    std::deque<Value> _front;
+
+    std::size_t _size = 0;
+    std::size_t _count = 0;
+    bool _clearing = false;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_compressed_queue.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+OplogBuffer::Batch makeBatch(int first, int count) {
+    OplogBuffer::Batch batch;
+    for (int i = first; i < first + count; ++i) {
+        batch.push_back(BSON("ts" << Timestamp(i, 1) << "o" << BSON("x" << std::string(100, 'a'))));
+    }
+    return batch;
+}
+
+TEST(OplogBufferCompressedQueueTest, PopAndPeekReturnDocumentsInOrderAcrossBlocks) {
+    OplogBufferCompressedQueue buffer;
+    auto first = makeBatch(0, 3);
+    auto second = makeBatch(3, 2);
+    buffer.pushAllNonBlocking(nullptr, first.cbegin(), first.cend());
+    buffer.pushAllNonBlocking(nullptr, second.cbegin(), second.cend());
+    buffer.push(nullptr, BSON("ts" << Timestamp(5, 1)));
+    ASSERT_EQUALS(6U, buffer.getCount());
+
+    OplogBuffer::Value doc;
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(buffer.peek(nullptr, &doc));
+        ASSERT_EQUALS(Timestamp(i, 1), doc["ts"].timestamp());
+        ASSERT_TRUE(buffer.tryPop(nullptr, &doc));
+        ASSERT_EQUALS(Timestamp(i, 1), doc["ts"].timestamp());
+    }
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_FALSE(buffer.tryPop(nullptr, &doc));
+    ASSERT_FALSE(buffer.peek(nullptr, &doc));
+}
+
+TEST(OplogBufferCompressedQueueTest, BlocksAreAccountedAtTheirCompressedSize) {
+    OplogBufferCompressedQueue buffer;
+    auto batch = makeBatch(0, 100);
+    std::size_t uncompressedSize = 0;
+    for (const auto& doc : batch) {
+        uncompressedSize += doc.objsize();
+    }
+
+    buffer.pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    ASSERT_EQUALS(100U, buffer.getCount());
+    ASSERT_LESS_THAN(buffer.getSize(), uncompressedSize);
+
+    // Peeking decompresses the block, after which its entries are accounted individually.
+    OplogBuffer::Value doc;
+    ASSERT_TRUE(buffer.peek(nullptr, &doc));
+    ASSERT_EQUALS(uncompressedSize, buffer.getSize());
+    ASSERT_TRUE(buffer.tryPop(nullptr, &doc));
+    ASSERT_EQUALS(uncompressedSize - doc.objsize(), buffer.getSize());
+}
+
+TEST(OplogBufferCompressedQueueTest, LastObjectPushedReturnsNewestEntry) {
+    OplogBufferCompressedQueue buffer;
+    ASSERT_FALSE(buffer.lastObjectPushed(nullptr));
+
+    auto batch = makeBatch(0, 2);
+    buffer.pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    ASSERT_BSONOBJ_EQ(batch.back(), *buffer.lastObjectPushed(nullptr));
+
+    // The newest entry is still reported once its block has been decompressed.
+    OplogBuffer::Value doc;
+    ASSERT_TRUE(buffer.tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(batch.back(), *buffer.lastObjectPushed(nullptr));
+
+    ASSERT_TRUE(buffer.tryPop(nullptr, &doc));
+    ASSERT_FALSE(buffer.lastObjectPushed(nullptr));
+}
+
+TEST(OplogBufferCompressedQueueTest, ClearRemovesAllEntries) {
+    OplogBufferCompressedQueue buffer;
+    auto batch = makeBatch(0, 4);
+    buffer.pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    buffer.pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+
+    OplogBuffer::Value doc;
+    ASSERT_TRUE(buffer.tryPop(nullptr, &doc));
+    buffer.clear(nullptr);
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getCount());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_FALSE(buffer.tryPop(nullptr, &doc));
+}
+
+TEST(OplogBufferCompressedQueueTest, WaitForDataReturnsWhenABatchIsPushed) {
+    OplogBufferCompressedQueue buffer;
+    ASSERT_FALSE(buffer.waitForData(Seconds(0)));
+
+    auto batch = makeBatch(0, 2);
+    stdx::thread producer(
+        [&] { buffer.pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend()); });
+    ASSERT_TRUE(buffer.waitForData(Seconds(60)));
+    producer.join();
+    ASSERT_EQUALS(2U, buffer.getCount());
+}
+
+}  // namespace
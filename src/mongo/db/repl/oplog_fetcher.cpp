@@ -56,6 +56,11 @@ namespace {
 TimerStats getmoreReplStats;
 ServerStatusMetricField<TimerStats> displayBatchesRecieved("repl.network.getmores",
                                                            &getmoreReplStats);
+// The distribution of the time each batch took to arrive from the sync source. Together with the
+// other repl.latency histograms this breaks replication lag down by stage.
+MicrosHistogramStats fetchLatencyStats;
+ServerStatusMetricField<MicrosHistogramStats> displayFetchLatency("repl.latency.fetch",
+                                                                  &fetchLatencyStats);
 // The oplog entries read via the oplog reader
 Counter64 opsReadStats;
 ServerStatusMetricField<Counter64> displayOpsRead("repl.network.ops", &opsReadStats);
@@ -479,6 +484,7 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
 
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
+    fetchLatencyStats.recordMicros(durationCount<Microseconds>(queryResponse.elapsedMillis));
 
     // TODO: back pressure handling will be added in SERVER-23499.
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
@@ -62,6 +62,7 @@
 #include "mongo/db/repl/noop_writer.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_compressed_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -127,6 +128,15 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
                                       std::string,
                                       kCollectionOplogBufferName);
 
+const char kNoneOplogBufferCompressionName[] = "none";
+const char kSnappyOplogBufferCompressionName[] = "snappy";
+
+// Set this to specify whether the in-memory oplog buffers hold each fetched batch as a single
+// compressed block, which lets more operations be buffered within the same memory limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(oplogBufferCompression,
+                                      std::string,
+                                      kNoneOplogBufferCompressionName);
+
 // Set this to specify size of read ahead buffer in the OplogBufferCollection.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPeekCacheSize, int, 10000);
 
@@ -166,6 +176,25 @@ MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     return Status::OK();
 }
 
+MONGO_INITIALIZER(oplogBufferCompression)(InitializerContext*) {
+    if ((oplogBufferCompression != kNoneOplogBufferCompressionName) &&
+        (oplogBufferCompression != kSnappyOplogBufferCompressionName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported oplog buffer compression option: " + oplogBufferCompression);
+    }
+    return Status::OK();
+}
+
+/**
+ * Returns a new in-memory oplog buffer, compressed if so configured.
+ */
+std::unique_ptr<OplogBuffer> makeInMemoryOplogBuffer() {
+    if (oplogBufferCompression == kSnappyOplogBufferCompressionName) {
+        return stdx::make_unique<OplogBufferCompressedQueue>();
+    }
+    return stdx::make_unique<OplogBufferBlockingQueue>();
+}
+
 /**
  * Returns new thread pool for thread pool task executor.
  */
@@ -888,13 +917,13 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
         return stdx::make_unique<OplogBufferProxy>(
             stdx::make_unique<OplogBufferCollection>(StorageInterface::get(opCtx), options));
     } else {
-        return stdx::make_unique<OplogBufferBlockingQueue>();
+        return makeInMemoryOplogBuffer();
     }
 }
 
 std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeSteadyStateOplogBuffer(
     OperationContext* opCtx) const {
-    return stdx::make_unique<OplogBufferBlockingQueue>();
+    return makeInMemoryOplogBuffer();
 }
 
 std::size_t ReplicationCoordinatorExternalStateImpl::getOplogFetcherMaxFetcherRestarts() const {
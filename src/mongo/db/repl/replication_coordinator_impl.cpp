@@ -225,6 +225,7 @@ void ReplicationCoordinatorImpl::CallbackWaiter::notify_inlock() {
 }
 
 
+template <typename List>
 class ReplicationCoordinatorImpl::WaiterGuard {
 public:
     /**
@@ -238,7 +239,7 @@ public:
      * _list is guarded by ReplicationCoordinatorImpl::_mutex, thus it is illegal to construct one
      * of these without holding _mutex
      */
-    WaiterGuard(WaiterList* list, Waiter* waiter) : _list(list), _waiter(waiter) {
+    WaiterGuard(List* list, Waiter* waiter) : _list(list), _waiter(waiter) {
         list->add_inlock(_waiter);
     }
 
@@ -247,7 +248,7 @@ public:
     }
 
 private:
-    WaiterList* _list;
+    List* _list;
     Waiter* _waiter;
 };
 
@@ -299,6 +300,76 @@ bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
     return true;
 }
 
+// static
+ReplicationCoordinatorImpl::ReplicationWaiterList::GroupKey
+ReplicationCoordinatorImpl::ReplicationWaiterList::_groupKey(WaiterType waiter) {
+    invariant(waiter->writeConcern);
+    const WriteConcernOptions& writeConcern = *waiter->writeConcern;
+    return GroupKey(writeConcern.wNumNodes, writeConcern.wMode, writeConcern.syncMode);
+}
+
+void ReplicationCoordinatorImpl::ReplicationWaiterList::add_inlock(WaiterType waiter) {
+    _groups[_groupKey(waiter)].emplace(waiter->opTime, waiter);
+}
+
+bool ReplicationCoordinatorImpl::ReplicationWaiterList::remove_inlock(WaiterType waiter) {
+    auto groupIt = _groups.find(_groupKey(waiter));
+    if (groupIt == _groups.end()) {
+        return false;
+    }
+
+    auto& group = groupIt->second;
+    auto range = group.equal_range(waiter->opTime);
+    auto it = std::find_if(
+        range.first, range.second, [waiter](const auto& entry) { return entry.second == waiter; });
+    if (it == range.second) {
+        return false;
+    }
+
+    group.erase(it);
+    if (group.empty()) {
+        _groups.erase(groupIt);
+    }
+    return true;
+}
+
+void ReplicationCoordinatorImpl::ReplicationWaiterList::signalAndRemoveSatisfiedPrefix_inlock(
+    stdx::function<bool(WaiterType)> func) {
+    std::vector<WaiterType> satisfied;
+    for (auto groupIt = _groups.begin(); groupIt != _groups.end();) {
+        auto& group = groupIt->second;
+        auto it = group.begin();
+        while (it != group.end() && func(it->second)) {
+            satisfied.push_back(it->second);
+            ++it;
+        }
+        group.erase(group.begin(), it);
+
+        if (group.empty()) {
+            groupIt = _groups.erase(groupIt);
+        } else {
+            ++groupIt;
+        }
+    }
+
+    // It's important to call notify() after the waiters have been removed from the list since
+    // notify() might remove the waiter itself.
+    for (auto& waiter : satisfied) {
+        waiter->notify_inlock();
+    }
+}
+
+void ReplicationCoordinatorImpl::ReplicationWaiterList::signalAndRemoveAll_inlock() {
+    auto groups = std::move(_groups);
+    _groups.clear();
+    // Call notify() after removing the waiters from the list.
+    for (auto& group : groups) {
+        for (auto& entry : group.second) {
+            entry.second->notify_inlock();
+        }
+    }
+}
+
 namespace {
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
@@ -1283,7 +1354,7 @@ Status ReplicationCoordinatorImpl::_waitUntilOpTime(OperationContext* opCtx,
         // We just need to wait for the opTime to catch up to what we need (not majority RC).
         stdx::condition_variable condVar;
         ThreadWaiter waiter(targetOpTime, nullptr, &condVar);
-        WaiterGuard guard(&_opTimeWaiterList, &waiter);
+        WaiterGuard<WaiterList> guard(&_opTimeWaiterList, &waiter);
 
         LOG(3) << "waitUntilOpTime: OpID " << opCtx->getOpID() << " is waiting for OpTime "
                << waiter << " until " << opCtx->getDeadline();
@@ -1475,6 +1546,14 @@ bool ReplicationCoordinatorImpl::_doneWaitingForReplication_inlock(
 
             // Fallthrough to wait for "majority" write concern.
         }
+        // If the commit point has already reached the opTime, the write is majority committed and
+        // there is no need to examine every member's position. This holds unless the waiter needs
+        // durable optimes but the commit point is computed from applied optimes.
+        if (isV1ElectionProtocol() &&
+            (!useDurableOpTime || _rsConfig.getWriteConcernMajorityShouldJournal()) &&
+            _topCoord->getLastCommittedOpTime() >= opTime) {
+            return true;
+        }
         // Continue and wait for replication to the majority (of voters).
         // *** Needed for J:True, writeConcernMajorityShouldJournal:False (appliedOpTime snapshot).
         patternName = ReplSetConfig::kMajorityWriteConcernModeName;
@@ -1595,7 +1674,7 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
     // Must hold _mutex before constructing waitInfo as it will modify _replicationWaiterList
     stdx::condition_variable condVar;
     ThreadWaiter waiter(opTime, &writeConcern, &condVar);
-    WaiterGuard guard(&_replicationWaiterList, &waiter);
+    WaiterGuard<ReplicationWaiterList> guard(&_replicationWaiterList, &waiter);
     while (!_doneWaitingForReplication_inlock(opTime, minSnapshot, writeConcern)) {
 
         if (_inShutdown) {
@@ -2891,7 +2970,7 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    _replicationWaiterList.signalAndRemoveIf_inlock([this](Waiter* waiter) {
+    _replicationWaiterList.signalAndRemoveSatisfiedPrefix_inlock([this](Waiter* waiter) {
         return _doneWaitingForReplication_inlock(
             waiter->opTime, Timestamp(), *waiter->writeConcern);
     });
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -507,6 +509,7 @@ private:
         FinishFunc finishCallback = nullptr;
     };
 
+    template <typename List>
     class WaiterGuard;
 
     class WaiterList {
@@ -526,6 +529,33 @@ private:
         std::vector<WaiterType> _list;
     };
 
+    // Waiters for a write concern, grouped by write concern and ordered by OpTime within each
+    // group. For a given write concern, a waiter whose OpTime is satisfied implies that every
+    // waiter with an earlier OpTime is too, so waking the ready waiters only needs to examine the
+    // satisfied prefix of each group rather than every waiter.
+    class ReplicationWaiterList {
+    public:
+        using WaiterType = Waiter*;
+
+        // Adds waiter into the list. The waiter must have a write concern.
+        void add_inlock(WaiterType waiter);
+        // Returns whether waiter is found and removed.
+        bool remove_inlock(WaiterType waiter);
+        // Signals and removes, in OpTime order, the waiters of each group up to the first one
+        // which does not satisfy the condition.
+        void signalAndRemoveSatisfiedPrefix_inlock(stdx::function<bool(WaiterType)> fun);
+        // Signals and removes all waiters from the list.
+        void signalAndRemoveAll_inlock();
+
+    private:
+        // The parts of a write concern which decide whether it is satisfied at an OpTime.
+        using GroupKey = std::tuple<int, std::string, WriteConcernOptions::SyncMode>;
+
+        static GroupKey _groupKey(WaiterType waiter);
+
+        std::map<GroupKey, std::multimap<OpTime, WaiterType>> _groups;
+    };
+
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
 
     // The state and logic of primary catchup.
@@ -1176,7 +1206,7 @@ private:
     OID _myRID;  // (M)
 
     // list of information about clients waiting on replication.  Does *not* own the WaiterInfos.
-    WaiterList _replicationWaiterList;  // (M)
+    ReplicationWaiterList _replicationWaiterList;  // (M)
 
     // list of information about clients waiting for a particular opTime.
     // Does *not* own the WaiterInfos.
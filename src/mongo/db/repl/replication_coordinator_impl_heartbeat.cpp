@@ -191,6 +191,7 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     const Date_t now = _replExecutor->now();
     Milliseconds networkTime(0);
     StatusWith<ReplSetHeartbeatResponse> hbStatusResponse(hbResponse);
+    bool heardFromPrimary = false;
 
     if (responseStatus.isOK()) {
         networkTime = cbData.response.elapsedMillis.value_or(Milliseconds{0});
@@ -198,11 +199,8 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
         // and update tests.
         const auto& hbResponse = hbStatusResponse.getValue();
         _updateTerm_inlock(hbResponse.getTerm());
-        // Postpone election timeout if we have a successful heartbeat response from the primary.
-        if (hbResponse.hasState() && hbResponse.getState().primary() &&
-            hbResponse.getTerm() == _topCoord->getTerm()) {
-            _cancelAndRescheduleElectionTimeout_inlock();
-        }
+        heardFromPrimary = hbResponse.hasState() && hbResponse.getState().primary() &&
+            hbResponse.getTerm() == _topCoord->getTerm();
     } else {
         LOG_FOR_HEARTBEATS(0) << "Error in heartbeat (requestId: " << cbData.request.id << ") to "
                               << target << ", response status: " << responseStatus;
@@ -213,6 +211,12 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     HeartbeatResponseAction action =
         _topCoord->processHeartbeatResponse(now, networkTime, target, hbStatusResponse);
 
+    // Postpone election timeout if we have a successful heartbeat response from the primary. This
+    // waits until the response has been recorded so the failure detector can account for it.
+    if (heardFromPrimary) {
+        _cancelAndRescheduleElectionTimeout_inlock();
+    }
+
     if (action.getAction() == HeartbeatResponseAction::NoAction && hbStatusResponse.isOK() &&
         hbStatusResponse.getValue().hasState() &&
         hbStatusResponse.getValue().getState() != MemberState::RS_PRIMARY &&
@@ -790,9 +794,18 @@ void ReplicationCoordinatorImpl::_cancelAndRescheduleElectionTimeout_inlock() {
         return;
     }
 
+    // When the failure detector suspects the primary sooner than the election timeout, shrink the
+    // random offset in proportion so it still only staggers candidates rather than delaying them.
+    const Milliseconds electionTimeout = _rsConfig.getElectionTimeoutPeriod();
+    const Milliseconds timeout = _topCoord->getPrimaryFailureDetectionTimeout(electionTimeout);
     Milliseconds randomOffset = _getRandomizedElectionOffset_inlock();
+    if (timeout < electionTimeout) {
+        randomOffset = Milliseconds(durationCount<Milliseconds>(randomOffset) *
+                                    durationCount<Milliseconds>(timeout) /
+                                    durationCount<Milliseconds>(electionTimeout));
+    }
     auto now = _replExecutor->now();
-    auto when = now + _rsConfig.getElectionTimeoutPeriod() + randomOffset;
+    auto when = now + timeout + randomOffset;
     invariant(when > now);
     LOG(4) << "Scheduling election timeout callback at " << when;
     _handleElectionTimeoutWhen = when;
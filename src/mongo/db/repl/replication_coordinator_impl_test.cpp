@@ -1136,6 +1136,66 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesConcurrentWaitersWithDifferentWriteConcernsAndOpTimes) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+
+    WriteConcernOptions twoNodes;
+    twoNodes.wTimeout = WriteConcernOptions::kNoTimeout;
+    twoNodes.wNumNodes = 2;
+    WriteConcernOptions threeNodes = twoNodes;
+    threeNodes.wNumNodes = 3;
+
+    // Two waiters with the same write concern at different optimes, and one with another write
+    // concern.
+    ReplicationAwaiter awaiter1(getReplCoord(), getServiceContext());
+    awaiter1.setOpTime(time1);
+    awaiter1.setWriteConcern(twoNodes);
+    awaiter1.start();
+    ReplicationAwaiter awaiter2(getReplCoord(), getServiceContext());
+    awaiter2.setOpTime(time2);
+    awaiter2.setWriteConcern(twoNodes);
+    awaiter2.start();
+    ReplicationAwaiter awaiter3(getReplCoord(), getServiceContext());
+    awaiter3.setOpTime(time1);
+    awaiter3.setWriteConcern(threeNodes);
+    awaiter3.start();
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(awaiter1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiter2.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(awaiter3.getResult().status);
+}
+
 TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBeforeBeingSatisified) {
     assertStartSuccess(BSON("_id"
                             << "mySet"
@@ -28,15 +28,18 @@
 
 #pragma once
 
+#include <tuple>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
 
-class NamespaceString;
 class OperationContext;
 
 namespace repl {
@@ -88,6 +91,27 @@ public:
                                                               UUID uuid,
                                                               const BSONObj& filter) const = 0;
 
+    /**
+     * Fetches the documents whose _id is one of 'ids' from the collection with the given UUID on
+     * the sync source, in no particular order. Documents that do not exist on the sync source are
+     * not returned. Returns the namespace matching the UUID on the sync source as well.
+     *
+     * The default implementation fetches the documents one at a time using findOneByUUID().
+     */
+    virtual std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+        std::vector<BSONObj> docs;
+        NamespaceString nss;
+        for (auto&& id : ids) {
+            BSONObj doc;
+            std::tie(doc, nss) = findOneByUUID(db, uuid, BSON("_id" << id));
+            if (!doc.isEmpty()) {
+                docs.push_back(doc);
+            }
+        }
+        return {std::move(docs), nss};
+    }
+
     /**
      * Clones a single collection from the sync source.
      */
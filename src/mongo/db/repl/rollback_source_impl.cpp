@@ -30,11 +30,13 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/oplogreader.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -79,6 +81,67 @@ std::pair<BSONObj, NamespaceString> RollbackSourceImpl::findOneByUUID(const std:
     return _getConnection()->findOneByUUID(db, uuid, filter);
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceImpl::findByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder cmdBuilder;
+    uuid.appendToBuilder(&cmdBuilder, "find");
+    {
+        BSONObjBuilder filterBuilder(cmdBuilder.subobjStart("filter"));
+        BSONObjBuilder idBuilder(filterBuilder.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (auto&& id : ids) {
+            inBuilder.append(id);
+        }
+    }
+    // Match _id values exactly, regardless of the collection's default collation.
+    cmdBuilder.append("collation",
+                      BSON("locale"
+                           << "simple"));
+    cmdBuilder.append("batchSize", static_cast<long long>(ids.size()));
+    BSONObj cmd = cmdBuilder.obj();
+
+    BSONObj res;
+    auto conn = _getConnection();
+    conn->runCommand(db, cmd, res, QueryOption_SlaveOk);
+    uassertStatusOK(getStatusFromCommandResult(res));
+
+    BSONObj cursorObj = res.getObjectField("cursor");
+    NamespaceString nss(cursorObj["ns"].valueStringData());
+    std::vector<BSONObj> docs;
+    for (auto&& elem : cursorObj.getObjectField("firstBatch")) {
+        docs.push_back(elem.Obj().getOwned());
+    }
+
+    long long cursorId = cursorObj["id"].safeNumberLong();
+    if (cursorId == 0) {
+        return {std::move(docs), nss};
+    }
+
+    // The documents did not fit in a single batch. Rather than iterating the cursor, fetch the
+    // remaining documents one at a time, since this only happens when they are very large.
+    BSONObj killRes;
+    conn->runCommand(
+        db, BSON("killCursors" << nss.coll() << "cursors" << BSON_ARRAY(cursorId)), killRes);
+
+    const StringData::ComparatorInterface* stringComparator = nullptr;
+    BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, stringComparator);
+    auto fetchedIds = eltCmp.makeBSONEltSet();
+    for (auto&& doc : docs) {
+        fetchedIds.insert(doc["_id"]);
+    }
+    for (auto&& id : ids) {
+        if (fetchedIds.count(id)) {
+            continue;
+        }
+        BSONObj doc;
+        std::tie(doc, nss) = findOneByUUID(db, uuid, BSON("_id" << id));
+        if (!doc.isEmpty()) {
+            docs.push_back(doc);
+        }
+    }
+    return {std::move(docs), nss};
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
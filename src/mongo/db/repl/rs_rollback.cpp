@@ -68,6 +68,7 @@
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
@@ -88,6 +89,10 @@ namespace repl {
 
 using namespace rollback_internal;
 
+// The maximum number of documents from one collection to refetch from the sync source with a
+// single query during rollback.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackRefetchBatchSize, int, 1000);
+
 bool DocID::operator<(const DocID& other) const {
     int comp = uuid.toString().compare(other.uuid.toString());
     if (comp < 0)
@@ -983,22 +988,30 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
 
     log() << "Starting refetching documents";
 
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
-        UUID uuid = doc.uuid;
+    const std::size_t batchSize = std::max(1, rollbackRefetchBatchSize.load());
+    auto it = fixUpInfo.docsToRefetch.begin();
+    while (it != fixUpInfo.docsToRefetch.end()) {
+        // Documents are ordered by collection UUID, so each batch holds consecutive documents
+        // from a single collection.
+        UUID uuid = it->uuid;
         NamespaceString nss = catalog.lookupNSSByUUID(uuid);
+        std::vector<DocID> batch;
+        std::vector<BSONElement> ids;
+        for (; it != fixUpInfo.docsToRefetch.end() && it->uuid == uuid && batch.size() < batchSize;
+             ++it) {
+            invariant(!it->_id.eoo());  // This is checked when we insert to the set.
+            batch.push_back(*it);
+            ids.push_back(it->_id);
+        }
 
         try {
-            LOG(2) << "Refetching document, collection: " << nss << ", UUID: " << uuid << ", "
-                   << redact(doc._id);
-            // TODO : Slow. Lots of round trips.
-            numFetched++;
+            LOG(2) << "Refetching " << batch.size() << " documents, collection: " << nss
+                   << ", UUID: " << uuid;
+            numFetched += batch.size();
 
-            BSONObj good;
+            std::vector<BSONObj> goodDocs;
             NamespaceString resNss;
-            std::tie(good, resNss) =
-                rollbackSource.findOneByUUID(nss.db().toString(), uuid, doc._id.wrap());
+            std::tie(goodDocs, resNss) = rollbackSource.findByUUID(nss.db().toString(), uuid, ids);
 
             // To prevent inconsistencies in the transactions collection, rollback fails if the UUID
             // of the collection is different on the sync source than on the node rolling back,
@@ -1015,17 +1028,29 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                        "resync is required.");
             }
 
-            totalSize += good.objsize();
-
-            // Checks that the total amount of data that needs to be refetched is at most
-            // 300 MB. We do not roll back more than 300 MB of documents in order to
-            // prevent out of memory errors from too much data being stored. See SERVER-23392.
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back.");
+            // Documents which were not returned no longer exist on the sync source. An empty good
+            // version indicates we should delete them.
+            auto& collectionGoodVersions = goodVersions[uuid];
+            for (auto&& doc : batch) {
+                collectionGoodVersions.insert(std::pair<DocID, BSONObj>(doc, BSONObj()));
             }
+            for (auto&& good : goodDocs) {
+                auto goodVersion =
+                    collectionGoodVersions.find(DocID(BSONObj(), good["_id"], uuid));
+                if (goodVersion == collectionGoodVersions.end()) {
+                    continue;
+                }
+                goodVersion->second = good;
 
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[uuid].insert(std::pair<DocID, BSONObj>(doc, good));
+                totalSize += good.objsize();
+
+                // Checks that the total amount of data that needs to be refetched is at most
+                // 300 MB. We do not roll back more than 300 MB of documents in order to
+                // prevent out of memory errors from too much data being stored. See SERVER-23392.
+                if (totalSize >= 300 * 1024 * 1024) {
+                    throw RSFatalException("replSet too much data to roll back.");
+                }
+            }
 
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
@@ -1034,11 +1059,16 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
             if (ex.code() == ErrorCodes::CommandNotSupportedOnView)
                 continue;
 
-            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _id: " << redact(doc._id)
-                  << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
-                  << redact(ex);
+            log() << "Rollback couldn't re-fetch " << batch.size()
+                  << " documents from uuid: " << uuid << ' ' << numFetched << '/'
+                  << fixUpInfo.docsToRefetch.size() << ": " << redact(ex);
             throw;
         }
+
+        if (numFetched % 10000 < batch.size() || it == fixUpInfo.docsToRefetch.end()) {
+            log() << "Refetched " << numFetched << '/' << fixUpInfo.docsToRefetch.size()
+                  << " documents";
+        }
     }
 
     log() << "Finished refetching documents. Total size of documents refetched: "
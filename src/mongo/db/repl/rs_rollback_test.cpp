@@ -56,10 +56,12 @@
 #include "mongo/db/repl/rollback_test_fixture.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -1758,6 +1760,85 @@ TEST_F(RSRollbackTest, RollbackApplyOpsCommand) {
         << result;
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsOfACollectionInBatches) {
+    createOplog(_opCtx.get());
+    CollectionOptions options;
+    options.uuid = UUID::gen();
+    auto coll = _createCollection(_opCtx.get(), "test.t", options);
+    auto uuid = coll->uuid().get();
+
+    auto refetchBatchSize =
+        ServerParameterSet::getGlobal()->getMap().find("rollbackRefetchBatchSize")->second;
+    ASSERT_OK(refetchBatchSize->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(refetchBatchSize->setFromString("1000")); });
+
+    auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    OplogInterfaceMock::Operations localOperations;
+    for (int i = 5; i >= 1; --i) {
+        localOperations.push_back(
+            std::make_pair(BSON("ts" << Timestamp(Seconds(1 + i), 0) << "h" << 1LL << "op"
+                                     << "i"
+                                     << "ui"
+                                     << uuid
+                                     << "ns"
+                                     << "test.t"
+                                     << "o"
+                                     << BSON("_id" << i)),
+                           RecordId(1 + i)));
+    }
+    localOperations.push_back(commonOperation);
+
+    // Only the documents with even _ids exist on the sync source.
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+
+        std::pair<BSONObj, NamespaceString> findOneByUUID(const std::string& db,
+                                                          UUID uuid,
+                                                          const BSONObj& filter) const override {
+            FAIL("Unexpected findOneByUUID request") << filter;
+            return {};
+        }
+
+        std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+            const std::string& db,
+            UUID uuid,
+            const std::vector<BSONElement>& ids) const override {
+            batchSizes.push_back(ids.size());
+            std::vector<BSONObj> docs;
+            for (auto&& id : ids) {
+                if (id.numberInt() % 2 == 0) {
+                    docs.push_back(BSON("_id" << id.numberInt() << "v" << 1));
+                }
+            }
+            return {docs, NamespaceString("test.t")};
+        }
+
+        mutable std::vector<std::size_t> batchSizes;
+    } rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+
+    ASSERT_OK(syncRollback(_opCtx.get(),
+                           OplogInterfaceMock(localOperations),
+                           rollbackSource,
+                           {},
+                           _coordinator,
+                           _replicationProcess.get()));
+    ASSERT_EQUALS(3U, rollbackSource.batchSizes.size());
+    ASSERT_EQUALS(2U, rollbackSource.batchSizes[0]);
+    ASSERT_EQUALS(2U, rollbackSource.batchSizes[1]);
+    ASSERT_EQUALS(1U, rollbackSource.batchSizes[2]);
+
+    AutoGetCollectionForReadCommand acr(_opCtx.get(), NamespaceString("test.t"));
+    BSONObj result;
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT_EQUALS(i % 2 == 0,
+                      Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << i), result))
+            << i;
+    }
+}
+
 TEST_F(RSRollbackTest, RollbackCreateCollectionCommand) {
     createOplog(_opCtx.get());
     CollectionOptions options;
@@ -35,6 +35,8 @@
 
 #include "third_party/murmurhash3/MurmurHash3.h"
 #include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <deque>
 #include <memory>
 
 #include "mongo/base/counter.h"
@@ -79,6 +81,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -120,6 +123,39 @@ public:
 
 } exportedWriterThreadCountParam;
 
+/**
+ * Number of writer vectors per writer thread that the operations of a batch are hashed into. Each
+ * non-empty vector is scheduled separately on the writer pool, so with more vectors than threads
+ * a thread that finishes its vector early picks up another one instead of idling until the
+ * slowest vector of the batch is applied. Operations on the same document, or on the same capped
+ * collection, always hash to the same vector and are applied in order.
+ */
+AtomicInt32 replWriterVectorsPerThread(1);
+
+class ExportedWriterVectorsPerThreadParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedWriterVectorsPerThreadParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "replWriterVectorsPerThread",
+              &replWriterVectorsPerThread) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "replWriterVectorsPerThread must be between 1 and 64");
+        }
+
+        return Status::OK();
+    }
+
+} exportedWriterVectorsPerThreadParam;
+
+// Set this to false to apply each applyOps oplog entry as a single command, by a single writer
+// thread, instead of distributing its inner operations among the writer vectors.
+MONGO_EXPORT_SERVER_PARAMETER(replExpandApplyOpsEntries, bool, true);
+
 class ExportedBatchLimitOperationsParameter
     : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
 public:
@@ -152,6 +188,36 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Number of writer vectors applied, and the time the writer threads spent applying them or waiting
+// for the other writer threads to finish their share of a batch. Comparing the two shows whether
+// replWriterThreadCount or replWriterVectorsPerThread should be changed.
+Counter64 writerVectorsApplied;
+ServerStatusMetricField<Counter64> displayWriterVectorsApplied("repl.apply.writerVectors",
+                                                               &writerVectorsApplied);
+Counter64 writerBusyMicros;
+ServerStatusMetricField<Counter64> displayWriterBusyMicros("repl.apply.writerBusyMicros",
+                                                           &writerBusyMicros);
+Counter64 writerIdleMicros;
+ServerStatusMetricField<Counter64> displayWriterIdleMicros("repl.apply.writerIdleMicros",
+                                                           &writerIdleMicros);
+
+// The distribution of the time each batch spent in each stage after leaving the oplog buffer:
+// being assembled by the batcher, being written to the local oplog (which overlaps with assigning
+// its operations to writer vectors), being applied by the writer threads and, on durable storage
+// engines, waiting for the journal before it counts as durable.
+MicrosHistogramStats batchingLatencyStats;
+ServerStatusMetricField<MicrosHistogramStats> displayBatchingLatency("repl.latency.batching",
+                                                                     &batchingLatencyStats);
+MicrosHistogramStats oplogWriteLatencyStats;
+ServerStatusMetricField<MicrosHistogramStats> displayOplogWriteLatency("repl.latency.oplogWrite",
+                                                                       &oplogWriteLatencyStats);
+MicrosHistogramStats applyLatencyStats;
+ServerStatusMetricField<MicrosHistogramStats> displayApplyLatency("repl.latency.apply",
+                                                                  &applyLatencyStats);
+MicrosHistogramStats journalWaitLatencyStats;
+ServerStatusMetricField<MicrosHistogramStats> displayJournalWaitLatency(
+    "repl.latency.journalWait", &journalWaitLatencyStats);
+
 void initializePrefetchThread() {
     if (!Client::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -267,7 +333,9 @@ void ApplyBatchFinalizerForJournal::_run() {
         }
 
         auto opCtx = cc().makeOperationContext();
+        Timer journalWaitTimer;
         opCtx->recoveryUnit()->waitUntilDurable();
+        journalWaitLatencyStats.record(journalWaitTimer);
         _recordDurable(latestOpTime);
     }
 }
@@ -459,16 +527,21 @@ void prefetchOps(const MultiApplier::Operations& ops, OldThreadPool* prefetcherP
 
 // Doles out all the work to the writer pool threads.
 // Does not modify writerVectors, but passes non-const pointers to inner vectors into func.
+// Adds the time spent applying each vector to 'busyMicros'.
 void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
               OldThreadPool* writerPool,
               const MultiApplier::ApplyOperationFn& func,
-              std::vector<Status>* statusVector) {
+              std::vector<Status>* statusVector,
+              AtomicInt64* busyMicros) {
     invariant(writerVectors.size() == statusVector->size());
     TimerHolder timer(&applyBatchStats);
     for (size_t i = 0; i < writerVectors.size(); i++) {
         if (!writerVectors[i].empty()) {
-            writerPool->schedule([&func, &writerVectors, statusVector, i] {
+            writerPool->schedule([&func, &writerVectors, statusVector, busyMicros, i] {
+                Timer busyTimer;
                 (*statusVector)[i] = func(&writerVectors[i]);
+                busyMicros->fetchAndAdd(busyTimer.micros());
+                writerVectorsApplied.increment();
             });
         }
     }
@@ -621,9 +694,73 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * If 'op' is an applyOps entry whose inner operations may be applied independently of each other,
+ * appends an oplog entry for each inner operation to 'derivedOps' and returns true. This is the
+ * case when the entry consists only of inserts, updates and deletes, and carries no preCondition
+ * or other options that the applyOps command would have to honor.
+ *
+ * Applying the inner operations in parallel preserves the atomicity of the applyOps entry as seen
+ * by readers, since commands are always applied in a batch of their own and readers are excluded
+ * while a batch is applied.
+ */
+bool expandApplyOpsEntry(const OplogEntry& op, std::deque<OplogEntry>* derivedOps) {
+    if (!op.isCommand() || op.getCommandType() != OplogEntry::CommandType::kApplyOps) {
+        return false;
+    }
+
+    const BSONObj& cmd = op.getObject();
+    for (auto&& field : cmd) {
+        if (field.fieldNameStringData() != "applyOps") {
+            return false;
+        }
+    }
+    BSONElement innerOpsElem = cmd["applyOps"];
+    if (innerOpsElem.type() != Array) {
+        return false;
+    }
+
+    std::vector<OplogEntry> innerOps;
+    for (auto&& innerOpElem : innerOpsElem.Obj()) {
+        if (innerOpElem.type() != Object) {
+            return false;
+        }
+
+        // Inner operations do not carry an optime of their own, so they are applied at the optime
+        // of the applyOps entry.
+        const BSONObj innerOpObj = innerOpElem.Obj();
+        BSONObjBuilder builder;
+        builder.appendElements(innerOpObj);
+        for (auto fieldName : {"ts", "t", "h", "wall"}) {
+            BSONElement field = op.raw[fieldName];
+            if (!field.eoo() && !innerOpObj.hasField(fieldName)) {
+                builder.append(field);
+            }
+        }
+
+        auto innerOp = OplogEntry::parse(builder.obj());
+        if (!innerOp.isOK() || !innerOp.getValue().isCrudOpType() ||
+            innerOp.getValue().getNamespace().isSystemDotIndexes()) {
+            return false;
+        }
+        innerOps.push_back(std::move(innerOp.getValue()));
+    }
+    if (innerOps.empty()) {
+        return false;
+    }
+
+    for (auto&& innerOp : innerOps) {
+        derivedOps->push_back(std::move(innerOp));
+    }
+    return true;
+}
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
+ * derivedOps - Populated with the inner operations of applyOps entries in 'ops' that are applied
+ *      individually. These operations, rather than the applyOps entries, are added to the writer
+ *      vectors.
  * writerVectors - Set of operations for each worker thread to apply.
  * latestSessionRecords - Populated map of the "latest" transaction table records for each logical
  *      session id present in the given operations. Each record represents the final state of the
@@ -632,17 +769,19 @@ private:
 void fillWriterVectorsAndLatestSessionRecords(
     OperationContext* opCtx,
     MultiApplier::Operations* ops,
+    std::deque<OplogEntry>* derivedOps,
     std::vector<MultiApplier::OperationPtrs>* writerVectors,
     SessionRecordMap* latestSessionRecords) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getGlobalStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
+    const bool expandApplyOps = replExpandApplyOpsEntries.load();
     const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
-    for (auto&& op : *ops) {
+    auto addToWriterVector = [&](OplogEntry& op) {
         StringMapTraits::HashedKey hashedNs(op.getNamespace().ns());
         uint32_t hash = hashedNs.hash();
 
@@ -669,6 +808,14 @@ void fillWriterVectorsAndLatestSessionRecords(
             }
         }
 
+        auto& writer = (*writerVectors)[hash % numWriters];
+        if (writer.empty()) {
+            writer.reserve(8);  // Skip a few growth rounds
+        }
+        writer.push_back(&op);
+    };
+
+    for (auto&& op : *ops) {
         const auto& sessionInfo = op.getOperationSessionInfo();
         if (sessionInfo.getTxnNumber()) {
             const auto& lsid = *sessionInfo.getSessionId();
@@ -688,11 +835,16 @@ void fillWriterVectorsAndLatestSessionRecords(
             }
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
-        if (writer.empty()) {
-            writer.reserve(8);  // Skip a few growth rounds
+        // Elements of a deque stay in place as more are appended, so the writer vectors may point
+        // into it.
+        const auto numDerivedOps = derivedOps->size();
+        if (expandApplyOps && expandApplyOpsEntry(op, derivedOps)) {
+            for (auto i = numDerivedOps; i < derivedOps->size(); ++i) {
+                addToWriterVector((*derivedOps)[i]);
+            }
+        } else {
+            addToWriterVector(op);
         }
-        writer.push_back(&op);
     }
 }
 
@@ -835,9 +987,17 @@ private:
 
             OpQueue ops;
             // tryPopAndWaitForMore adds to ops and returns true when we need to end a batch early.
+            // The batch is timed from its first operation, so time spent idle waiting for the
+            // buffer to fill is not counted.
+            boost::optional<Timer> batchingTimer;
             {
                 auto opCtx = cc().makeOperationContext();
-                while (!_syncTail->tryPopAndWaitForMore(opCtx.get(), &ops, batchLimits)) {
+                bool batchDone = false;
+                while (!batchDone) {
+                    batchDone = _syncTail->tryPopAndWaitForMore(opCtx.get(), &ops, batchLimits);
+                    if (!batchingTimer && !ops.empty()) {
+                        batchingTimer.emplace();
+                    }
                 }
             }
 
@@ -845,6 +1005,10 @@ private:
                 continue;  // Don't emit empty batches.
             }
 
+            if (batchingTimer) {
+                batchingLatencyStats.record(*batchingTimer);
+            }
+
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
             _cv.wait(lk, [&] { return _ops.empty(); });
@@ -1507,7 +1671,9 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
                 "attempting to replicate ops while primary"};
     }
 
-    std::vector<Status> statusVector(workerPool->getNumThreads(), Status::OK());
+    const size_t numWriterVectors =
+        workerPool->getNumThreads() * static_cast<size_t>(replWriterVectorsPerThread.load());
+    std::vector<Status> statusVector(numWriterVectors, Status::OK());
     {
         // We must wait for the all work we've dispatched to complete before leaving this block
         // because the spawned threads refer to objects on the stack
@@ -1515,23 +1681,35 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
 
         // Write batch of ops into oplog.
         consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
+        Timer oplogWriteTimer;
         scheduleWritesToOplog(opCtx, workerPool, ops);
 
-        std::vector<MultiApplier::OperationPtrs> writerVectors(workerPool->getNumThreads());
+        std::deque<OplogEntry> derivedOps;
+        std::vector<MultiApplier::OperationPtrs> writerVectors(numWriterVectors);
         SessionRecordMap latestSessionRecords;
         fillWriterVectorsAndLatestSessionRecords(
-            opCtx, &ops, &writerVectors, &latestSessionRecords);
+            opCtx, &ops, &derivedOps, &writerVectors, &latestSessionRecords);
 
         // Wait for writes to finish before applying ops.
         workerPool->join();
+        oplogWriteLatencyStats.record(oplogWriteTimer);
 
         // Reset consistency markers in case the node fails while applying ops.
         consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
         consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
 
-        applyOps(writerVectors, workerPool, applyOperation, &statusVector);
+        Timer applyTimer;
+        AtomicInt64 busyMicros;
+        applyOps(writerVectors, workerPool, applyOperation, &statusVector, &busyMicros);
         workerPool->join();
 
+        const long long batchBusyMicros = busyMicros.load();
+        const long long batchApplyMicros = applyTimer.micros();
+        const long long batchThreadMicros = batchApplyMicros * workerPool->getNumThreads();
+        applyLatencyStats.recordMicros(batchApplyMicros);
+        writerBusyMicros.increment(batchBusyMicros);
+        writerIdleMicros.increment(std::max(0LL, batchThreadMicros - batchBusyMicros));
+
         // Update the transaction table to point to the latest oplog entries for each session id.
         scheduleTxnTableUpdates(opCtx, workerPool, latestSessionRecords);
         workerPool->join();
@@ -61,6 +61,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/session_catalog.h"
@@ -574,6 +575,147 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2, unittest::assertGet(OplogEntry::parse(operationsWrittenToOplog[1].doc)));
 }
 
+TEST_F(SyncTailTest, MultiApplySplitsBatchIntoMoreWriterVectorsThanThreadsWhenConfigured) {
+    ServerParameter* vectorsPerThread =
+        ServerParameterSet::getGlobal()->getMap().find("replWriterVectorsPerThread")->second;
+    ASSERT_OK(vectorsPerThread->setFromString("8"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(vectorsPerThread->setFromString("1")); });
+
+    OldThreadPool writerPool(1);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterVectorToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterVectorToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    // Insert and then update one document in each of several collections.
+    const int kNumCollections = 20;
+    MultiApplier::Operations ops;
+    for (int i = 0; i < kNumCollections; ++i) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), 2 * i), 1LL}, nss, BSON("_id" << 0 << "x" << 0)));
+        ops.push_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(1), 2 * i + 1), 1LL},
+                                                   nss,
+                                                   BSON("_id" << 0),
+                                                   BSON("$set" << BSON("x" << 1))));
+    }
+
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<InsertStatement>&) {
+            return Status::OK();
+        };
+
+    auto lastOpTime =
+        unittest::assertGet(multiApply(_opCtx.get(), &writerPool, ops, applyOperationFn));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    // Even with a single writer thread, the batch is applied as several independent vectors, and
+    // the operations on each document are applied by one vector in their original order.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_GREATER_THAN(operationsApplied.size(), 1U);
+    size_t numApplied = 0;
+    for (auto&& operationsAppliedByVector : operationsApplied) {
+        numApplied += operationsAppliedByVector.size();
+        for (size_t i = 0; i < operationsAppliedByVector.size(); ++i) {
+            const auto& op = operationsAppliedByVector[i];
+            if (op.getOpType() != OpTypeEnum::kUpdate) {
+                continue;
+            }
+            ASSERT_GREATER_THAN(i, 0U);
+            const auto& previous = operationsAppliedByVector[i - 1];
+            ASSERT(OpTypeEnum::kInsert == previous.getOpType());
+            ASSERT_EQUALS(op.getNamespace(), previous.getNamespace());
+        }
+    }
+    ASSERT_EQUALS(ops.size(), numApplied);
+}
+
+TEST_F(SyncTailTest, MultiApplyDistributesInnerOperationsOfApplyOpsEntryAmongWriters) {
+    OldThreadPool writerPool(4);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterVectorToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterVectorToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<InsertStatement>&) {
+            return Status::OK();
+        };
+
+    // Insert into several collections, since the test storage engine does not support document
+    // level locking and operations on one collection are therefore applied by a single writer.
+    const int kNumInnerOps = 20;
+    BSONArrayBuilder innerOps;
+    for (int i = 0; i < kNumInnerOps; ++i) {
+        innerOps.append(BSON("op"
+                             << "i"
+                             << "ns"
+                             << "test.t" + std::to_string(i)
+                             << "o"
+                             << BSON("_id" << 0)));
+    }
+    OpTime applyOpsOpTime(Timestamp(Seconds(1), 0), 1LL);
+    auto applyOpsOp = makeCommandOplogEntry(
+        applyOpsOpTime, NamespaceString("admin"), BSON("applyOps" << innerOps.arr()));
+
+    auto lastOpTime = unittest::assertGet(
+        multiApply(_opCtx.get(), &writerPool, {applyOpsOp}, applyOperationFn));
+    ASSERT_EQUALS(applyOpsOpTime, lastOpTime);
+
+    // The inner inserts are applied individually, at the optime of the applyOps entry, by several
+    // writers.
+    {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        ASSERT_GREATER_THAN(operationsApplied.size(), 1U);
+        size_t numApplied = 0;
+        for (auto&& operationsAppliedByVector : operationsApplied) {
+            for (auto&& op : operationsAppliedByVector) {
+                ASSERT(OpTypeEnum::kInsert == op.getOpType());
+                ASSERT_EQUALS("test", op.getNamespace().db());
+                ASSERT_EQUALS(applyOpsOpTime, op.getOpTime());
+                ++numApplied;
+            }
+        }
+        ASSERT_EQUALS(static_cast<size_t>(kNumInnerOps), numApplied);
+        operationsApplied.clear();
+    }
+
+    // An applyOps entry with a precondition is applied as a single command.
+    auto applyOpsWithPreConditionOp =
+        makeCommandOplogEntry({Timestamp(Seconds(2), 0), 1LL},
+                              NamespaceString("admin"),
+                              BSON("applyOps" << BSON_ARRAY(BSON("op"
+                                                                 << "i"
+                                                                 << "ns"
+                                                                 << "test.t0"
+                                                                 << "o"
+                                                                 << BSON("_id" << 0)))
+                                              << "preCondition"
+                                              << BSONArray()));
+    ASSERT_OK(multiApply(_opCtx.get(), &writerPool, {applyOpsWithPreConditionOp}, applyOperationFn)
+                  .getStatus());
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(1U, operationsApplied.size());
+    ASSERT_EQUALS(1U, operationsApplied[0].size());
+    ASSERT(OpTypeEnum::kCommand == operationsApplied[0][0].getOpType());
+}
+
 TEST_F(SyncTailTest, MultiApplyUpdatesTheTransactionTable) {
     // Set up the transactions collection, which can only be done by the primary.
     ASSERT_OK(ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_PRIMARY));
@@ -72,6 +72,17 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(priorityTakeoverFreshnessWindowSeconds, in
 // re-evaluated if it lags behind another node by more than 'maxSyncSourceLagSecs' seconds.
 MONGO_FP_DECLARE(disableMaxSyncSourceLagSecs);
 
+// The maximum number of other members that may already be syncing from a member for it to be
+// preferred as a sync source. Members at the limit are only chosen when no other candidate is
+// eligible. This spreads secondaries across sync sources instead of having them all pull from the
+// closest member, usually the primary. A value of 0 means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(maxSyncSourceDownstreamSyncers, int, 0);
+
+// Lets a secondary call an election as soon as the primary's heartbeat responses are overdue
+// relative to their usual spacing, instead of always waiting for the full election timeout.
+// Higher values tolerate more jitter before suspecting the primary. 0 disables it.
+MONGO_EXPORT_SERVER_PARAMETER(heartbeatPhiAccrualThreshold, double, 0.0);
+
 constexpr Milliseconds TopologyCoordinator::PingStats::UninitializedPing;
 
 std::string TopologyCoordinator::roleToString(TopologyCoordinator::Role role) {
@@ -333,6 +344,16 @@ HostAndPort TopologyCoordinator::chooseNewSyncSource(Date_t now,
                            << itMemberConfig.getHostAndPort();
                     continue;
                 }
+                // Candidate must not already serve as many syncing members as allowed.
+                const int maxDownstreamSyncers = maxSyncSourceDownstreamSyncers.load();
+                if (maxDownstreamSyncers > 0 &&
+                    _getNumDownstreamSyncers(itMemberConfig.getHostAndPort()) >=
+                        maxDownstreamSyncers) {
+                    LOG(2) << "Cannot select sync source because it already has "
+                           << maxDownstreamSyncers << " members syncing from it: "
+                           << itMemberConfig.getHostAndPort();
+                    continue;
+                }
             }
             // Candidate must build indexes if we build indexes, to be considered.
             if (_selfConfig().shouldBuildIndexes()) {
@@ -404,6 +425,20 @@ bool TopologyCoordinator::_memberIsBlacklisted(const MemberConfig& memberConfig,
     return false;
 }
 
+int TopologyCoordinator::_getNumDownstreamSyncers(const HostAndPort& host) const {
+    int count = 0;
+    for (std::vector<MemberData>::const_iterator it = _memberData.begin(); it != _memberData.end();
+         ++it) {
+        if (indexOfIterator(_memberData, it) == _selfIndex || !it->up()) {
+            continue;
+        }
+        if (it->getSyncSource() == host) {
+            ++count;
+        }
+    }
+    return count;
+}
+
 void TopologyCoordinator::blacklistSyncSource(const HostAndPort& host, Date_t until) {
     LOG(2) << "blacklisting " << host << " until " << until.toString();
     _syncSourceBlacklist[host] = until;
@@ -2249,6 +2284,16 @@ int TopologyCoordinator::getCurrentPrimaryIndex() const {
     return _currentPrimaryIndex;
 }
 
+Milliseconds TopologyCoordinator::getPrimaryFailureDetectionTimeout(
+    Milliseconds electionTimeout) const {
+    const double phiThreshold = heartbeatPhiAccrualThreshold.load();
+    if (phiThreshold <= 0 || _currentPrimaryIndex == -1 || _currentPrimaryIndex == _selfIndex) {
+        return electionTimeout;
+    }
+    return _memberData.at(_currentPrimaryIndex)
+        .getHeartbeatSuspicionDelay(phiThreshold, electionTimeout);
+}
+
 Date_t TopologyCoordinator::getStepDownTime() const {
     return _stepDownUntil;
 }
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/repl_set_heartbeat_response.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
@@ -52,6 +53,10 @@ class ReplSetConfig;
 class TagSubgroup;
 struct MemberState;
 
+// The phi-accrual suspicion level at which a secondary considers the primary failed and stops
+// waiting out the rest of the election timeout. Zero disables the failure detector.
+extern AtomicDouble heartbeatPhiAccrualThreshold;
+
 /**
  * Replication Topology Coordinator
  *
@@ -692,6 +697,14 @@ public:
      */
     int getCurrentPrimaryIndex() const;
 
+    /**
+     * Returns how long after a successful heartbeat response from the current primary it should
+     * be considered failed: the delay at which its phi-accrual suspicion level reaches
+     * heartbeatPhiAccrualThreshold, or 'electionTimeout' if that is sooner, the detector is
+     * disabled or there is no other member known to be primary.
+     */
+    Milliseconds getPrimaryFailureDetectionTimeout(Milliseconds electionTimeout) const;
+
     enum StartElectionReason {
         kElectionTimeout,
         kPriorityTakeover,
@@ -879,6 +892,12 @@ private:
      **/
     bool _memberIsBlacklisted(const MemberConfig& memberConfig, Date_t now) const;
 
+    /**
+     * Returns the number of other members that are up and whose last heartbeat reported "host"
+     * as their sync source.
+     */
+    int _getNumDownstreamSyncers(const HostAndPort& host) const;
+
     /**
      * Returns true if we are a one-node replica set, we're the one member,
      * we're electable, we're not in maintenance mode, and we are currently in followerMode
@@ -38,6 +38,7 @@
 #include "mongo/db/repl/repl_set_request_votes_args.h"
 #include "mongo/db/repl/topology_coordinator.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/logger/logger.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
@@ -203,14 +204,16 @@ protected:
                                                 const std::string& setName,
                                                 MemberState memberState,
                                                 const OpTime& lastOpTimeSender,
-                                                Milliseconds roundTripTime = Milliseconds(1)) {
+                                                Milliseconds roundTripTime = Milliseconds(1),
+                                                const HostAndPort& syncingTo = HostAndPort()) {
         return _receiveHeartbeatHelper(Status::OK(),
                                        member,
                                        setName,
                                        memberState,
                                        Timestamp(),
                                        lastOpTimeSender,
-                                       roundTripTime);
+                                       roundTripTime,
+                                       syncingTo);
     }
 
 private:
@@ -220,13 +223,15 @@ private:
                                                     MemberState memberState,
                                                     Timestamp electionTime,
                                                     const OpTime& lastOpTimeSender,
-                                                    Milliseconds roundTripTime) {
+                                                    Milliseconds roundTripTime,
+                                                    const HostAndPort& syncingTo = HostAndPort()) {
         ReplSetHeartbeatResponse hb;
         hb.setConfigVersion(1);
         hb.setState(memberState);
         hb.setDurableOpTime(lastOpTimeSender);
         hb.setAppliedOpTime(lastOpTimeSender);
         hb.setElectionTime(electionTime);
+        hb.setSyncingTo(syncingTo);
 
         StatusWith<ReplSetHeartbeatResponse> hbResponse = responseStatus.isOK()
             ? StatusWith<ReplSetHeartbeatResponse>(hb)
@@ -499,6 +504,76 @@ TEST_F(TopoCoordTest, NodeReturnsClosestValidSyncSourceAsSyncSource) {
 }
 
 
+TEST_F(TopoCoordTest, NodeSkipsSyncSourceWithTooManyDownstreamSyncersWhenLimitIsSet) {
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2")
+                                    << BSON("_id" << 30 << "host"
+                                                  << "h3")
+                                    << BSON("_id" << 40 << "host"
+                                                  << "h4"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    // h2 is the closest member and both h3 and h4 sync from it.
+    OpTime lastOpTime(Timestamp(10, 0), 0);
+    for (int i = 0; i < 2; ++i) {
+        heartbeatFromMember(
+            HostAndPort("h2"), "rs0", MemberState::RS_SECONDARY, lastOpTime, Milliseconds(100));
+        heartbeatFromMember(HostAndPort("h3"),
+                            "rs0",
+                            MemberState::RS_SECONDARY,
+                            lastOpTime,
+                            Milliseconds(200),
+                            HostAndPort("h2"));
+        heartbeatFromMember(HostAndPort("h4"),
+                            "rs0",
+                            MemberState::RS_SECONDARY,
+                            lastOpTime,
+                            Milliseconds(300),
+                            HostAndPort("h2"));
+    }
+
+    // With no limit, the closest member is chosen.
+    getTopoCoord().chooseNewSyncSource(
+        now()++, OpTime(), TopologyCoordinator::ChainingPreference::kUseConfiguration);
+    ASSERT_EQUALS(HostAndPort("h2"), getTopoCoord().getSyncSourceAddress());
+
+    auto maxDownstreamSyncers =
+        ServerParameterSet::getGlobal()->getMap().find("maxSyncSourceDownstreamSyncers")->second;
+    ASSERT_OK(maxDownstreamSyncers->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(maxDownstreamSyncers->setFromString("0")); });
+
+    // h2 already has two members syncing from it, so the next closest member is chosen.
+    getTopoCoord().chooseNewSyncSource(
+        now()++, OpTime(), TopologyCoordinator::ChainingPreference::kUseConfiguration);
+    ASSERT_EQUALS(HostAndPort("h3"), getTopoCoord().getSyncSourceAddress());
+
+    // If every candidate is at the limit, the closest one is chosen anyway.
+    ASSERT_OK(maxDownstreamSyncers->setFromString("1"));
+    heartbeatFromMember(HostAndPort("h2"),
+                        "rs0",
+                        MemberState::RS_SECONDARY,
+                        lastOpTime,
+                        Milliseconds(100),
+                        HostAndPort("h4"));
+    heartbeatFromMember(HostAndPort("h4"),
+                        "rs0",
+                        MemberState::RS_SECONDARY,
+                        lastOpTime,
+                        Milliseconds(300),
+                        HostAndPort("h3"));
+    getTopoCoord().chooseNewSyncSource(
+        now()++, OpTime(), TopologyCoordinator::ChainingPreference::kUseConfiguration);
+    ASSERT_EQUALS(HostAndPort("h2"), getTopoCoord().getSyncSourceAddress());
+}
+
 TEST_F(TopoCoordTest, ChooseOnlyPrimaryAsSyncSourceWhenChainingIsDisallowed) {
     updateConfig(BSON("_id"
                       << "rs0"
@@ -913,6 +913,94 @@ TEST_F(TopoCoordTest, ChooseNoSyncSourceWhenPrimaryIsBlacklistedAndChainingIsDis
     ASSERT_EQUALS(HostAndPort("h2"), getTopoCoord().getSyncSourceAddress());
 }
 
+TEST_F(TopoCoordTest, PrimaryFailureDetectionTimeoutFollowsRegularHeartbeats) {
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    const Milliseconds electionTimeout(10000);
+    const double oldThreshold = heartbeatPhiAccrualThreshold.load();
+    ON_BLOCK_EXIT([&] { heartbeatPhiAccrualThreshold.store(oldThreshold); });
+    heartbeatPhiAccrualThreshold.store(8.0);
+
+    auto heartbeatFromPrimary = [&](Milliseconds interval) {
+        now() += interval - Milliseconds(10);
+        heartbeatFromMember(HostAndPort("h2"),
+                            "rs0",
+                            MemberState::RS_PRIMARY,
+                            OpTime(Timestamp(1, 0), 0),
+                            Milliseconds(10));
+    };
+    heartbeatFromPrimary(Milliseconds(2000));
+    ASSERT_EQUALS(1, getCurrentPrimaryIndex());
+
+    // Too few intervals have been seen to judge the primary by them.
+    for (int i = 0; i < 5; ++i) {
+        heartbeatFromPrimary(Milliseconds(2000));
+    }
+    ASSERT_EQUALS(electionTimeout,
+                  getTopoCoord().getPrimaryFailureDetectionTimeout(electionTimeout));
+
+    for (int i = 0; i < 20; ++i) {
+        heartbeatFromPrimary(Milliseconds(2000));
+    }
+    const Milliseconds timeout = getTopoCoord().getPrimaryFailureDetectionTimeout(electionTimeout);
+    ASSERT_GREATER_THAN(timeout, Milliseconds(2000));
+    ASSERT_LESS_THAN(timeout, Milliseconds(4000));
+
+    // Disabling the failure detector restores the election timeout.
+    heartbeatPhiAccrualThreshold.store(0.0);
+    ASSERT_EQUALS(electionTimeout,
+                  getTopoCoord().getPrimaryFailureDetectionTimeout(electionTimeout));
+}
+
+TEST_F(TopoCoordTest, PrimaryFailureDetectionTimeoutToleratesJitteryHeartbeats) {
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    const Milliseconds electionTimeout(10000);
+    const double oldThreshold = heartbeatPhiAccrualThreshold.load();
+    ON_BLOCK_EXIT([&] { heartbeatPhiAccrualThreshold.store(oldThreshold); });
+    heartbeatPhiAccrualThreshold.store(8.0);
+
+    auto heartbeatFromPrimary = [&](Milliseconds interval) {
+        now() += interval - Milliseconds(10);
+        heartbeatFromMember(HostAndPort("h2"),
+                            "rs0",
+                            MemberState::RS_PRIMARY,
+                            OpTime(Timestamp(1, 0), 0),
+                            Milliseconds(10));
+    };
+    heartbeatFromPrimary(Milliseconds(2000));
+    ASSERT_EQUALS(1, getCurrentPrimaryIndex());
+
+    // Heartbeats averaging the same two seconds, but far less regularly, make the same threshold
+    // wait out a much longer silence.
+    for (int i = 0; i < 20; ++i) {
+        heartbeatFromPrimary(Milliseconds(i % 2 ? 1000 : 3000));
+    }
+    const Milliseconds timeout = getTopoCoord().getPrimaryFailureDetectionTimeout(electionTimeout);
+    ASSERT_GREATER_THAN(timeout, Milliseconds(6000));
+    ASSERT_LESS_THAN(timeout, electionTimeout);
+}
+
 TEST_F(TopoCoordTest, NodeChangesToRecoveringWhenOnlyUnauthorizedNodesAreUp) {
     updateConfig(BSON("_id"
                       << "rs0"
@@ -33,6 +33,7 @@
 #include "mongo/db/s/balancer/balancer_policy.h"
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -53,6 +54,16 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// Minimum difference in operations per second between the busiest and the least busy shard of a
+// zone for a load balancing migration to be initiated. Prevents moving chunks around on idle
+// clusters, where the ratio of the rates is meaningless.
+const double kMinOpsRateDifferenceForLoadBalancing = 100;
+
+// When larger than 1, the balancer will additionally move chunks off shards, which serve more than
+// that many times the operations per second of the least busy shard of the same zone, as long as
+// doing so does not cause a chunk count imbalance. A value of 0 disables load-based balancing.
+MONGO_EXPORT_SERVER_PARAMETER(balancerOpsRateImbalanceRatio, double, 0);
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -436,6 +447,19 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   &migrations,
                                   &usedShards))
             ;
+
+        // 4) Once the chunk counts are even, relieve the busiest shard of the zone
+        const double opsRateImbalanceRatio = balancerOpsRateImbalanceRatio.load();
+        if (opsRateImbalanceRatio > 1) {
+            _singleZoneLoadBalance(shardStats,
+                                   distribution,
+                                   tag,
+                                   idealNumberOfChunksPerShardForTag,
+                                   imbalanceThreshold,
+                                   opsRateImbalanceRatio,
+                                   &migrations,
+                                   &usedShards);
+        }
     }
 
     return migrations;
@@ -528,6 +552,69 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            size_t imbalanceThreshold,
+                                            double opsRateImbalanceRatio,
+                                            vector<MigrateInfo>* migrations,
+                                            set<ShardId>* usedShards) {
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId) || stat.opsPerSec < 0)
+            continue;
+
+        const size_t numChunks = distribution.numberOfChunksInShardWithTag(stat.shardId, tag);
+
+        if (numChunks > 0 && (!from || stat.opsPerSec > from->opsPerSec)) {
+            from = &stat;
+        }
+
+        // The receiver must stay below the point at which the chunk count balancing would
+        // consider it overloaded, otherwise the chunk would be moved back on the next round
+        if (numChunks + 1 >= idealNumberOfChunksPerShardForTag + imbalanceThreshold)
+            continue;
+
+        if (!isShardSuitableReceiver(stat, tag).isOK())
+            continue;
+
+        if (!to || stat.opsPerSec < to->opsPerSec) {
+            to = &stat;
+        }
+    }
+
+    if (!from || !to || from->shardId == to->shardId)
+        return false;
+
+    if (from->opsPerSec - to->opsPerSec < kMinOpsRateDifferenceForLoadBalancing ||
+        from->opsPerSec < opsRateImbalanceRatio * to->opsPerSec)
+        return false;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from->shardId << " ops/sec " << from->opsPerSec;
+    LOG(1) << "receiver   : " << to->shardId << " ops/sec " << to->opsPerSec;
+    LOG(1) << "ratio      : " << opsRateImbalanceRatio;
+
+    for (const auto& chunk : distribution.getChunks(from->shardId)) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo())
+            continue;
+
+        migrations->emplace_back(to->shardId, chunk);
+        invariant(usedShards->insert(from->shardId).second);
+        invariant(usedShards->insert(to->shardId).second);
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -230,6 +230,25 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Selects one chunk for the specified zone (if appropriate) to be moved from the shard serving
+     * the highest rate of operations to the one serving the lowest, if the two rates differ by more
+     * than the configured ratio. Only used when the chunk counts are already balanced within the
+     * imbalance threshold and never selects a receiver which would end up with enough chunks to
+     * make the chunk count balancing move a chunk back. Shards, which have not yet reported an
+     * operation rate are not considered.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                       const DistributionStatus& distribution,
+                                       const std::string& tag,
+                                       size_t idealNumberOfChunksPerShardForTag,
+                                       size_t imbalanceThreshold,
+                                       double opsRateImbalanceRatio,
+                                       std::vector<MigrateInfo>* migrations,
+                                       std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
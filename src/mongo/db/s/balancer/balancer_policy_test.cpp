@@ -32,6 +32,7 @@
 
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
@@ -553,6 +554,115 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(BalancerPolicy::balance(cluster.first, distribution, false).empty());
 }
 
+/**
+ * Sets the balancerOpsRateImbalanceRatio server parameter for the duration of a test.
+ */
+class OpsRateImbalanceRatioGuard {
+public:
+    explicit OpsRateImbalanceRatioGuard(const std::string& value) {
+        const auto& parameters = ServerParameterSet::getGlobal()->getMap();
+        auto param = parameters.find("balancerOpsRateImbalanceRatio");
+        invariant(param != parameters.end());
+        _param = param->second;
+
+        BSONObjBuilder builder;
+        _param->append(nullptr, builder, "value");
+        _originalValue = builder.obj();
+
+        ASSERT_OK(_param->setFromString(value));
+    }
+
+    ~OpsRateImbalanceRatioGuard() {
+        invariantOK(_param->set(_originalValue["value"]));
+    }
+
+private:
+    ServerParameter* _param;
+    BSONObj _originalValue;
+};
+
+ShardStatistics makeShardStatsWithOpsRate(const ShardId& shardId, double opsPerSec) {
+    ShardStatistics stat(shardId, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion);
+    stat.opsPerSec = opsPerSec;
+    return stat;
+}
+
+TEST(BalancerPolicy, LoadBalancingDisabledByDefault) {
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 10000), 3},
+                                    {makeShardStatsWithOpsRate(kShardId1, 0), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, 0), 2}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingMovesChunkOffBusiestShard) {
+    OpsRateImbalanceRatioGuard ratioGuard("2");
+
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 1000), 3},
+                                    {makeShardStatsWithOpsRate(kShardId1, 100), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, 400), 2}});
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, LoadBalancingRespectsRatio) {
+    OpsRateImbalanceRatioGuard ratioGuard("2");
+
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 1000), 3},
+                                    {makeShardStatsWithOpsRate(kShardId1, 600), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, 800), 2}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingIgnoresIdleClusters) {
+    OpsRateImbalanceRatioGuard ratioGuard("2");
+
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 50), 3},
+                                    {makeShardStatsWithOpsRate(kShardId1, 0), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, 0), 2}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingIgnoresShardsWithUnknownRate) {
+    OpsRateImbalanceRatioGuard ratioGuard("2");
+
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 1000), 3},
+                                    {makeShardStatsWithOpsRate(kShardId1, -1), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, -1), 2}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingDoesNotCauseChunkCountImbalance) {
+    OpsRateImbalanceRatioGuard ratioGuard("2");
+
+    // With fewer than 20 chunks the threshold is 1, so moving a chunk to either of the other
+    // shards would make the chunk count balancing move it back
+    auto cluster = generateCluster({{makeShardStatsWithOpsRate(kShardId0, 1000), 2},
+                                    {makeShardStatsWithOpsRate(kShardId1, 0), 2},
+                                    {makeShardStatsWithOpsRate(kShardId2, 0), 2}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -92,6 +92,11 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Rate of operations (inserts, queries, updates, deletes, getMores and commands) per
+        // second served by this shard's primary since the previous statistics refresh. Negative
+        // if not yet known, for example on the first refresh or after the shard has restarted.
+        double opsPerSec{-1};
     };
 
     virtual ~ClusterStatistics();
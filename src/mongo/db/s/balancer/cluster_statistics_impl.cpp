@@ -51,16 +51,15 @@ using std::vector;
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard and returns its response.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -81,15 +80,31 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
+/**
+ * Sums up all the operation counters reported in the 'opcounters' section of a serverStatus
+ * response.
+ *
+ * Returns NoSuchKey if the section is not present.
+ */
+StatusWith<long long> extractTotalOpCounters(const BSONObj& serverStatus) {
+    BSONElement opCountersElem;
+    Status status =
+        bsonExtractTypedField(serverStatus, kOpCountersField, Object, &opCountersElem);
     if (!status.isOK()) {
         return status;
     }
 
-    return version;
+    long long totalOps = 0;
+    for (const auto& counter : opCountersElem.Obj()) {
+        if (counter.isNumber()) {
+            totalOps += counter.safeNumberLong();
+        }
+    }
+
+    return totalOps;
 }
 
 }  // namespace
@@ -136,15 +151,30 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
         }
 
         string mongoDVersion;
+        double opsPerSec = -1;
+
+        // Since the mongod version is only used for reporting and the operation rate is only an
+        // optional input to the balancer policy, there is no need to fail the entire round if
+        // either cannot be retrieved, so just leave them unset
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const BSONObj& serverStatus = serverStatusStatus.getValue();
+
+            Status versionStatus =
+                bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            auto totalOpsStatus = extractTotalOpCounters(serverStatus);
+            if (totalOpsStatus.isOK()) {
+                opsPerSec = _updateOpsRate(
+                    shard.getName(), Date_t::now(), totalOpsStatus.getValue());
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
-            log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+            log() << "Unable to obtain server status for " << shard.getName()
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<string> shardTags;
@@ -159,9 +189,35 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSec = opsPerSec;
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateOpsRate(const ShardId& shardId,
+                                             Date_t now,
+                                             long long totalOps) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _opCountersSamples.find(shardId);
+    if (it == _opCountersSamples.end()) {
+        _opCountersSamples.emplace(shardId, OpCountersSample{now, totalOps});
+        return -1;
+    }
+
+    const OpCountersSample previous = it->second;
+    it->second = OpCountersSample{now, totalOps};
+
+    const auto elapsedMillis = durationCount<Milliseconds>(now - previous.sampledAt);
+
+    // The counters are reset when the shard's primary restarts or changes, in which case there is
+    // no meaningful rate to report until the next sample
+    if (elapsedMillis <= 0 || totalOps < previous.totalOps) {
+        return -1;
+    }
+
+    return static_cast<double>(totalOps - previous.totalOps) * 1000 / elapsedMillis;
+}
+
 }  // namespace mongo
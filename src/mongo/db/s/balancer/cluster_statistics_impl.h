@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -36,6 +40,9 @@ namespace mongo {
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
  * fetch the statistics and does not perform any caching. If any of the shards fails to report
  * statistics fails the entire refresh.
+ *
+ * The only state retained between refreshes is the last operation counter sample of each shard,
+ * which is used to derive the per-shard operation rate.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -43,6 +50,24 @@ public:
     ~ClusterStatisticsImpl();
 
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
+
+private:
+    struct OpCountersSample {
+        Date_t sampledAt;
+        long long totalOps;
+    };
+
+    /**
+     * Records the latest operation counter total for the specified shard and returns the rate of
+     * operations per second since the previous sample, or -1 if it cannot be computed.
+     */
+    double _updateOpsRate(const ShardId& shardId, Date_t now, long long totalOps);
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // Last operation counter sample obtained from each shard
+    std::map<ShardId, OpCountersSample> _opCountersSamples;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -55,6 +56,10 @@
 namespace mongo {
 namespace {
 
+// The minimum time between the starts of two autosplit tasks on this shard, across all
+// collections. Autosplits triggered sooner are dropped and retriggered by further writes.
+MONGO_EXPORT_SERVER_PARAMETER(chunkSplitterMinIntervalMS, int, 0);
+
 /**
  * Constructs the default options for the thread pool used to schedule splits.
  */
@@ -262,6 +267,19 @@ void ChunkSplitter::trySplitting(const NamespaceString& nss,
     if (!_isPrimary) {
         return;
     }
+
+    const Milliseconds minInterval(chunkSplitterMinIntervalMS.load());
+    if (minInterval > Milliseconds(0)) {
+        stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+        const auto now = Date_t::now();
+        if (now < _nextSplitAllowed) {
+            LOG(1) << "won't auto split " << nss << " because another split started less than "
+                   << minInterval << " ago";
+            return;
+        }
+        _nextSplitAllowed = now + minInterval;
+    }
+
     uassertStatusOK(_threadPool.schedule([ this, nss, min, max, dataWritten ]() noexcept {
         _runAutosplit(nss, min, max, dataWritten);
     }));
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -65,7 +66,8 @@ public:
     void interruptChunkSplitter();
 
     /**
-     * Schedules an autosplit task. This function throws on scheduling failure.
+     * Schedules an autosplit task. This function throws on scheduling failure. Does nothing if
+     * another autosplit on this shard started less than chunkSplitterMinIntervalMS ago.
      */
     void trySplitting(const NamespaceString& nss,
                       const BSONObj& min,
@@ -92,6 +94,9 @@ private:
     // The ChunkSplitter is only active on a primary node.
     bool _isPrimary;
 
+    // The earliest time at which the next autosplit task may be scheduled.
+    Date_t _nextSplitAllowed;
+
     // Thread pool for parallelizing splits.
     ThreadPool _threadPool;
 };
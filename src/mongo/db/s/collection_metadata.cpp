@@ -117,6 +117,23 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
     return rangeContains(it->first, it->second, key);
 }
 
+boost::optional<ChunkRange> CollectionMetadata::getOwnedRangeContaining(
+    const BSONObj& key) const {
+    if (_rangesMap.empty()) {
+        return boost::none;
+    }
+
+    auto it = _rangesMap.upper_bound(key);
+    if (it != _rangesMap.begin())
+        it--;
+
+    if (!rangeContains(it->first, it->second, key)) {
+        return boost::none;
+    }
+
+    return ChunkRange(it->first, it->second);
+}
+
 bool CollectionMetadata::getNextChunk(const BSONObj& lookupKey, ChunkType* chunk) const {
     RangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
     RangeMap::const_iterator lowerChunkIt = upperChunkIt;
@@ -75,6 +75,14 @@ public:
      */
     bool keyBelongsToMe(const BSONObj& key) const;
 
+    /**
+     * Returns the bounds of the range of contiguous chunks owned by this shard, which contains the
+     * document key 'key', or boost::none if the key does not belong to this chunkset. Used by
+     * callers which check many keys in order to avoid the map lookup of keyBelongsToMe for keys,
+     * which fall in the same range as the previous one. Key must be the full shard key.
+     */
+    boost::optional<ChunkRange> getOwnedRangeContaining(const BSONObj& key) const;
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
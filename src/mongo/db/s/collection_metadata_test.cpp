@@ -107,6 +107,10 @@ TEST_F(NoChunkFixture, IsKeyValid) {
                                                            << "abcde")));
 }
 
+TEST_F(NoChunkFixture, GetOwnedRangeContainingFromEmpty) {
+    ASSERT(!makeCollectionMetadata()->getOwnedRangeContaining(BSON("a" << 10)));
+}
+
 TEST_F(NoChunkFixture, getNextFromEmpty) {
     ChunkType nextChunk;
     ASSERT(
@@ -325,6 +329,28 @@ TEST_F(ThreeChunkWithRangeGapFixture, ShardOwnsDoc) {
     ASSERT(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 40)));
 }
 
+TEST_F(ThreeChunkWithRangeGapFixture, GetOwnedRangeContainingMergesContiguousChunks) {
+    auto metadata(makeCollectionMetadata());
+
+    auto range = metadata->getOwnedRangeContaining(BSON("a" << 5));
+    ASSERT(range);
+    ASSERT_BSONOBJ_EQ(BSON("a" << MINKEY), range->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), range->getMax());
+
+    range = metadata->getOwnedRangeContaining(BSON("a" << 10));
+    ASSERT(range);
+    ASSERT_BSONOBJ_EQ(BSON("a" << MINKEY), range->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), range->getMax());
+
+    range = metadata->getOwnedRangeContaining(BSON("a" << 30));
+    ASSERT(range);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 30), range->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << MAXKEY), range->getMax());
+
+    ASSERT(!metadata->getOwnedRangeContaining(BSON("a" << 20)));
+    ASSERT(!metadata->getOwnedRangeContaining(BSON("a" << 25)));
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, ShardDoesntOwnDoc) {
     ASSERT_FALSE(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 20)));
     ASSERT_FALSE(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 25)));
@@ -33,7 +33,9 @@
 #include "mongo/db/s/collection_range_deleter.h"
 
 #include <algorithm>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/catalog_raii.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -48,6 +50,7 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -58,8 +61,26 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 0);
+
 namespace {
 
+// The time to wait after each batch of deletions, giving way to other writes.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 0);
+
+// If true, after each batch the range deleter also waits as long as the batch took to replicate
+// to a majority, so that it slows down as secondaries fall behind.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterPaceOnReplicationLag, bool, false);
+
+// If both are set to an hour of the day (UTC), ranges holding more than
+// rangeDeleterDeferRangesLargerThan documents are only deleted in the window starting at
+// rangeDeleterWindowStartHour and ending before rangeDeleterWindowEndHour. The window may span
+// midnight.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterWindowStartHour, int, -1);
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterWindowEndHour, int, -1);
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterDeferRangesLargerThan, long long, 0);
+
 using Deletion = CollectionRangeDeleter::Deletion;
 using DeleteNotification = CollectionRangeDeleter::DeleteNotification;
 
@@ -80,6 +101,77 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns boost::none if range deletions may run at 'now', and otherwise the time the next
+ * deletion window opens.
+ */
+boost::optional<Date_t> nextDeletionWindow(Date_t now) {
+    const int startHour = rangeDeleterWindowStartHour.load();
+    const int endHour = rangeDeleterWindowEndHour.load();
+    if (startHour < 0 || startHour > 23 || endHour < 0 || endHour > 23 || startHour == endHour) {
+        return boost::none;
+    }
+
+    const long long kMillisPerHour = durationCount<Milliseconds>(Hours(1));
+    const long long kMillisPerDay = 24 * kMillisPerHour;
+    const long long millis = now.toMillisSinceEpoch();
+    const long long millisOfDay = millis % kMillisPerDay;
+    const long long hour = millisOfDay / kMillisPerHour;
+    const bool inWindow = startHour < endHour ? (hour >= startHour && hour < endHour)
+                                              : (hour >= startHour || hour < endHour);
+    if (inWindow) {
+        return boost::none;
+    }
+
+    long long windowStart = millis - millisOfDay + startHour * kMillisPerHour;
+    if (windowStart <= millis) {
+        windowStart += kMillisPerDay;
+    }
+    return Date_t::fromMillisSinceEpoch(windowStart);
+}
+
+/**
+ * Finds the index to delete 'range' in order of, and the range's bounds in that index.
+ */
+StatusWith<std::tuple<IndexDescriptor*, BSONObj, BSONObj>> findShardKeyIndexBounds(
+    OperationContext* opCtx,
+    Collection* collection,
+    BSONObj const& keyPattern,
+    ChunkRange const& range) {
+    auto const& nss = collection->ns();
+
+    // The IndexChunk has a keyPattern that may apply to more than one index - we need to
+    // select the index and get the full index keyPattern here.
+    auto catalog = collection->getIndexCatalog();
+    const IndexDescriptor* idx = catalog->findShardKeyPrefixedIndex(opCtx, keyPattern, false);
+    if (!idx) {
+        std::string msg = str::stream() << "Unable to find shard key index for "
+                                        << keyPattern.toString() << " in " << nss.ns();
+        LOG(0) << msg;
+        return {ErrorCodes::InternalError, msg};
+    }
+
+    // Extend bounds to match the index we found
+    const KeyPattern indexKeyPattern(idx->keyPattern());
+    const auto extend = [&](const auto& key) {
+        return Helpers::toKeyFormat(indexKeyPattern.extendRangeBound(key, false));
+    };
+
+    const auto min = extend(range.getMin());
+    const auto max = extend(range.getMax());
+
+    const auto indexName = idx->indexName();
+    IndexDescriptor* descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+    if (!descriptor) {
+        std::string msg = str::stream() << "shard key index with name " << indexName << " on '"
+                                        << nss.ns() << "' was dropped";
+        LOG(0) << msg;
+        return {ErrorCodes::InternalError, msg};
+    }
+
+    return std::make_tuple(descriptor, min, max);
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -198,6 +290,19 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
+
+            // Large ranges wait for the deletion window, if there is one.
+            if (auto windowStart = nextDeletionWindow(Date_t::now())) {
+                const long long largeRange = rangeDeleterDeferRangesLargerThan.load();
+                auto isLarge =
+                    self->_rangeHasMoreThan(opCtx, collection, keyPattern, *range, largeRange);
+                if (isLarge.isOK() && isLarge.getValue()) {
+                    LOG(0) << "Deferring deletion of large " << nss.ns() << " range "
+                           << redact(range->toString()) << " until " << *windowStart;
+                    return *windowStart;
+                }
+            }
+
             wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
         } catch (const DBException& e) {
             wrote = e.toStatus();
@@ -229,6 +334,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     const auto clientOpTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
 
     // Wait for replication outside the lock
+    const Date_t replicationWaitStart = Date_t::now();
     const auto status = [&] {
         try {
             WriteConcernResult unusedWCResult;
@@ -263,7 +369,15 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     }
 
     notification.abandon();
-    return Date_t{};
+
+    Milliseconds pause(rangeDeleterBatchDelayMS.load());
+    if (rangeDeleterPaceOnReplicationLag.load()) {
+        pause = std::max(pause, Milliseconds(Date_t::now() - replicationWaitStart));
+    }
+    if (pause <= Milliseconds(0)) {
+        return Date_t{};
+    }
+    return Date_t::now() + pause;
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -276,44 +390,26 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
 
     auto const& nss = collection->ns();
 
-    // The IndexChunk has a keyPattern that may apply to more than one index - we need to
-    // select the index and get the full index keyPattern here.
-    auto catalog = collection->getIndexCatalog();
-    const IndexDescriptor* idx = catalog->findShardKeyPrefixedIndex(opCtx, keyPattern, false);
-    if (!idx) {
-        std::string msg = str::stream() << "Unable to find shard key index for "
-                                        << keyPattern.toString() << " in " << nss.ns();
-        LOG(0) << msg;
-        return {ErrorCodes::InternalError, msg};
+    auto swBounds = findShardKeyIndexBounds(opCtx, collection, keyPattern, range);
+    if (!swBounds.isOK()) {
+        return swBounds.getStatus();
     }
-
-    // Extend bounds to match the index we found
-    const KeyPattern indexKeyPattern(idx->keyPattern());
-    const auto extend = [&](const auto& key) {
-        return Helpers::toKeyFormat(indexKeyPattern.extendRangeBound(key, false));
-    };
-
-    const auto min = extend(range.getMin());
-    const auto max = extend(range.getMax());
+    IndexDescriptor* descriptor;
+    BSONObj min;
+    BSONObj max;
+    std::tie(descriptor, min, max) = swBounds.getValue();
 
     LOG(1) << "begin removal of " << min << " to " << max << " in " << nss.ns();
 
-    const auto indexName = idx->indexName();
-    IndexDescriptor* descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
-    if (!descriptor) {
-        std::string msg = str::stream() << "shard key index with name " << indexName << " on '"
-                                        << nss.ns() << "' was dropped";
-        LOG(0) << msg;
-        return {ErrorCodes::InternalError, msg};
-    }
-
     boost::optional<Helpers::RemoveSaver> saver;
     if (serverGlobalParams.moveParanoia) {
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
-    int numDeleted = 0;
-    do {
+    // Collect the batch with a single scan in shard key order, so that the deletions walk the
+    // index sequentially instead of seeking back to the start of the range for every document.
+    std::vector<std::pair<RecordId, BSONObj>> batch;
+    {
         auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
         auto manual = PlanExecutor::YIELD_MANUAL;
         auto forward = InternalPlanner::FORWARD;
@@ -322,34 +418,79 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         auto exec = InternalPlanner::indexScan(
             opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
-        }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << WorkingSetCommon::toStatusString(obj)
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
-            break;
+        while (batch.size() < static_cast<size_t>(maxToDelete)) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning() << PlanExecutor::statestr(state)
+                          << " - cursor error while trying to delete " << redact(min) << " to "
+                          << redact(max) << " in " << nss << ": "
+                          << WorkingSetCommon::toStatusString(obj)
+                          << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+            batch.emplace_back(rloc, saver ? obj.getOwned() : BSONObj());
         }
-        invariant(PlanExecutor::ADVANCED == state);
+    }
 
+    int numDeleted = 0;
+    for (auto&& entry : batch) {
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+            // The document may have been removed since it was scanned, if a write conflict
+            // made us take a new snapshot.
+            Snapshotted<BSONObj> unused;
+            if (!collection->findDoc(opCtx, entry.first, &unused)) {
+                return;
+            }
+
             WriteUnitOfWork wuow(opCtx);
             if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+                uassertStatusOK(saver->goingToDelete(entry.second));
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
+            collection->deleteDocument(opCtx, kUninitializedStmtId, entry.first, nullptr, true);
             wuow.commit();
         });
-    } while (++numDeleted < maxToDelete);
+        ++numDeleted;
+    }
 
     return numDeleted;
 }
 
+StatusWith<bool> CollectionRangeDeleter::_rangeHasMoreThan(OperationContext* opCtx,
+                                                          Collection* collection,
+                                                          BSONObj const& keyPattern,
+                                                          ChunkRange const& range,
+                                                          long long limit) {
+    auto swBounds = findShardKeyIndexBounds(opCtx, collection, keyPattern, range);
+    if (!swBounds.isOK()) {
+        return swBounds.getStatus();
+    }
+    IndexDescriptor* descriptor;
+    BSONObj min;
+    BSONObj max;
+    std::tie(descriptor, min, max) = swBounds.getValue();
+
+    auto exec = InternalPlanner::indexScan(opCtx,
+                                           collection,
+                                           descriptor,
+                                           min,
+                                           max,
+                                           BoundInclusion::kIncludeStartKeyOnly,
+                                           PlanExecutor::YIELD_MANUAL);
+    long long numKeys = 0;
+    while (exec->getNext(nullptr, nullptr) == PlanExecutor::ADVANCED) {
+        if (++numKeys > limit) {
+            return true;
+        }
+    }
+    return false;
+}
+
 auto CollectionRangeDeleter::overlaps(ChunkRange const& range) const
     -> boost::optional<DeleteNotification> {
     auto result = checkOverlap(_orphans, range);
@@ -32,6 +32,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/time_support.h"
@@ -42,6 +43,10 @@ class BSONObj;
 class Collection;
 class OperationContext;
 
+// The number of documents the range deleter removes per batch, or 0 to use
+// internalQueryExecYieldIterations.
+extern AtomicInt32 rangeDeleterBatchSize;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -183,6 +188,16 @@ private:
                                 ChunkRange const& range,
                                 int maxToDelete);
 
+    /**
+     * Returns true if the range in progress still holds more than 'limit' documents. Must be
+     * called under the collection lock.
+     */
+    StatusWith<bool> _rangeHasMoreThan(OperationContext* opCtx,
+                                       Collection* collection,
+                                       const BSONObj& keyPattern,
+                                       ChunkRange const& range,
+                                       long long limit);
+
     /**
      * Removes the latest-scheduled range from the ranges to be cleaned up, and notifies any
      * interested callers of this->overlaps(range) with specified status.
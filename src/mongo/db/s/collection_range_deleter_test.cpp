@@ -40,6 +40,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
@@ -238,6 +239,106 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kPattern << "startRangeDeletion")));
 }
 
+/**
+ * Sets a server parameter for the lifetime of the object, then restores the given original value.
+ */
+class ServerParameterForTest {
+public:
+    ServerParameterForTest(const std::string& name,
+                           const std::string& value,
+                           std::string original)
+        : _parameter(ServerParameterSet::getGlobal()->getMap().find(name)->second),
+          _original(std::move(original)) {
+        ASSERT_OK(_parameter->setFromString(value));
+    }
+
+    ~ServerParameterForTest() {
+        ASSERT_OK(_parameter->setFromString(_original));
+    }
+
+    void set(const std::string& value) {
+        ASSERT_OK(_parameter->setFromString(value));
+    }
+
+private:
+    ServerParameter* const _parameter;
+    const std::string _original;
+};
+
+// Tests that a batch deletes the documents with the lowest shard keys in the range first.
+TEST_F(CollectionRangeDeleterTest, BatchDeletesInShardKeyOrder) {
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 3));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSONObj()));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kPattern << 3)));
+
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSONObj()));
+    ASSERT_FALSE(next(rangeDeleter, 2));
+}
+
+// Tests that the range deleter waits rangeDeleterBatchDelayMS after each batch.
+TEST_F(CollectionRangeDeleterTest, BatchDelayDefersNextBatch) {
+    ServerParameterForTest delay("rangeDeleterBatchDelayMS", "3600000", "0");
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    auto when = next(rangeDeleter, 1);
+    ASSERT_TRUE(when);
+    ASSERT_GT(*when, Date_t::now() + Minutes(30));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSONObj()));
+}
+
+// Tests that ranges holding more than rangeDeleterDeferRangesLargerThan documents wait for the
+// deletion window, while smaller ones do not.
+TEST_F(CollectionRangeDeleterTest, LargeRangeWaitsForDeletionWindow) {
+    // A one hour window starting at the next hour, which excludes the current time.
+    const long long hour = Date_t::now().toMillisSinceEpoch() / (60 * 60 * 1000) % 24;
+    ServerParameterForTest start(
+        "rangeDeleterWindowStartHour", std::to_string((hour + 1) % 24), "-1");
+    ServerParameterForTest end("rangeDeleterWindowEndHour", std::to_string((hour + 2) % 24), "-1");
+    ServerParameterForTest largerThan("rangeDeleterDeferRangesLargerThan", "1", "0");
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    auto when = next(rangeDeleter, 1);
+    ASSERT_TRUE(when);
+    ASSERT_GT(*when, Date_t::now());
+    ASSERT_EQUALS(2ULL, dbclient.count(kNss.toString(), BSONObj()));
+
+    largerThan.set("5");
+    when = next(rangeDeleter, 1);
+    ASSERT_TRUE(when);
+    ASSERT_EQ(*when, Date_t{});
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSONObj()));
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
@@ -76,7 +76,8 @@ const long long kMaxSizeMBDefault = 0;
 BSONObj makeCreateIndexesCmd(const NamespaceString& nss,
                              const BSONObj& keys,
                              const BSONObj& collation,
-                             bool unique) {
+                             bool unique,
+                             int hashVersion) {
     BSONObjBuilder index;
 
     // Required fields for an index.
@@ -115,6 +116,10 @@ BSONObj makeCreateIndexesCmd(const NamespaceString& nss,
         index.appendBool("unique", unique);
     }
 
+    if (hashVersion != BSONElementHasher::DEFAULT_HASH_VERSION) {
+        index.append(IndexDescriptor::kHashVersionFieldName, hashVersion);
+    }
+
     // The outer createIndexes command.
 
     BSONObjBuilder createIndexes;
@@ -153,6 +158,15 @@ void validateAndDeduceFullRequestOptions(OperationContext* opCtx,
             "the hashed field by declaring an additional (non-hashed) unique index on the field.",
             !shardKeyPattern.isHashedPattern() || !request->getUnique());
 
+    // Ensure the hash version is known and only given for hashed shard keys.
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "Unsupported hashVersion " << request->getHashVersion(),
+            BSONElementHasher::isValidHashVersion(request->getHashVersion()));
+    uassert(ErrorCodes::InvalidOptions,
+            "hashVersion can only be specified for a hashed shard key",
+            shardKeyPattern.isHashedPattern() ||
+                request->getHashVersion() == BSONElementHasher::DEFAULT_HASH_VERSION);
+
     // Ensure the namespace is valid.
     uassert(ErrorCodes::IllegalOperation,
             "can't shard system namespaces",
@@ -275,6 +289,7 @@ boost::optional<CollectionType> checkIfAlreadyShardedWithSameOptions(
         requestedOptions.setKeyPattern(KeyPattern(request.getKey()));
         requestedOptions.setDefaultCollation(*request.getCollation());
         requestedOptions.setUnique(request.getUnique());
+        requestedOptions.setHashVersion(request.getHashVersion());
 
         // If the collection is already sharded, fail if the deduced options in this request do not
         // match the options the collection was originally sharded with.
@@ -324,7 +339,8 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
     //         ii. is not a sparse index, partial index, or index with a non-simple collation
     //         iii. contains no null values
     //         iv. is not multikey (maybe lift this restriction later)
-    //         v. if a hashed index, has default seed (lift this restriction later)
+    //         v. if a hashed index, has default seed (lift this restriction later) and the
+    //            requested hashVersion
     //
     // 3. If the proposed shard key is specified as unique, there must exist a useful,
     //    unique index exactly equal to the proposedKey (not just a prefix).
@@ -371,6 +387,19 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
                                   << idx["seed"].numberInt(),
                     !shardKeyPattern.isHashedPattern() || idx["seed"].eoo() ||
                         idx["seed"].numberInt() == BSONElementHasher::DEFAULT_HASH_SEED);
+            // The shard key values are computed with the hash function of the index, so both must
+            // agree on the hash version.
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "can't shard collection " << nss.ns()
+                                  << " with hashed shard key "
+                                  << proposedKey
+                                  << " and hashVersion "
+                                  << request.getHashVersion()
+                                  << " because the hashed index uses hashVersion "
+                                  << idx[IndexDescriptor::kHashVersionFieldName].numberInt(),
+                    !shardKeyPattern.isHashedPattern() ||
+                        idx[IndexDescriptor::kHashVersionFieldName].numberInt() ==
+                            request.getHashVersion());
             hasUsefulIndexForKey = true;
         }
     }
@@ -426,7 +455,8 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
         BSONObj collation =
             !request.getCollation()->isEmpty() ? CollationSpec::kSimpleSpec : BSONObj();
         auto createIndexesCmd =
-            makeCreateIndexesCmd(nss, proposedKey, collation, request.getUnique());
+            makeCreateIndexesCmd(
+                nss, proposedKey, collation, request.getUnique(), request.getHashVersion());
 
         const auto swResponse = primaryShard->runCommandWithFixedRetryAttempts(
             opCtx,
@@ -785,7 +815,7 @@ public:
         // Get variables required throughout this command.
 
         auto proposedKey(request.getKey().getOwned());
-        ShardKeyPattern shardKeyPattern(proposedKey);
+        ShardKeyPattern shardKeyPattern(proposedKey, request.getHashVersion());
 
         std::vector<ShardId> shardIds;
         Grid::get(opCtx)->shardRegistry()->getAllShardIds(&shardIds);
@@ -41,6 +41,7 @@
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
@@ -52,6 +53,7 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -70,6 +72,15 @@ using str::stream;
 
 namespace {
 
+// Maximum number of cloned documents to insert in a single write unit of work and, when
+// secondaryThrottle is on, waited for before inserting more. A value of 0 means to insert every
+// batch returned by _migrateClone at once.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionBatchSize, int, 0);
+
+// Time to sleep between inserting consecutive batches of cloned documents, which allows to limit
+// the impact of migrations on the recipient shard's workload.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionBatchDelayMS, int, 0);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 // Note: Even though we're setting UNSET here,
                                                 // kMajority implies JOURNAL if journaling is
@@ -105,11 +116,25 @@ string stateToString(MigrationDestinationManager::State state) {
     }
 }
 
-bool isInRange(const BSONObj& obj,
+/**
+ * Must be called with the collection lock held. A hashed shard key is computed with the hash
+ * version recorded in this shard's filtering metadata for 'nss'.
+ */
+bool isInRange(OperationContext* opCtx,
+               const NamespaceString& nss,
+               const BSONObj& obj,
                const BSONObj& min,
                const BSONObj& max,
                const BSONObj& shardKeyPattern) {
-    ShardKeyPattern shardKey(shardKeyPattern);
+    int hashVersion = BSONElementHasher::DEFAULT_HASH_VERSION;
+    if (KeyPattern::isHashedKeyPattern(shardKeyPattern)) {
+        auto metadata = CollectionShardingState::get(opCtx, nss)->getMetadata();
+        if (metadata) {
+            hashVersion = metadata->getChunkManager()->getShardKeyPattern().getHashVersion();
+        }
+    }
+
+    ShardKeyPattern shardKey(shardKeyPattern, hashVersion);
     BSONObj k = shardKey.extractShardKeyFromDoc(obj);
     return k.woCompare(min) >= 0 && k.woCompare(max) < 0;
 }
@@ -130,12 +155,75 @@ bool willOverrideLocalId(OperationContext* opCtx,
                          BSONObj* localDoc) {
     *localDoc = BSONObj();
     if (Helpers::findById(opCtx, db, nss.ns(), remoteDoc, *localDoc)) {
-        return !isInRange(*localDoc, min, max, shardKeyPattern);
+        return !isInRange(opCtx, nss, *localDoc, min, max, shardKeyPattern);
     }
 
     return false;
 }
 
+/**
+ * Inserts the documents in the range [begin, end) obtained from the donor shard's _migrateClone
+ * into the local collection, using a single write unit of work for all documents, which are not
+ * yet present locally.
+ *
+ * Throws if any of the documents has the same _id as a local document, which does not belong to
+ * the chunk being migrated.
+ */
+void insertClonedDocuments(OperationContext* opCtx,
+                           const NamespaceString& nss,
+                           const BSONObj& min,
+                           const BSONObj& max,
+                           const BSONObj& shardKeyPattern,
+                           std::vector<BSONObj>::const_iterator begin,
+                           std::vector<BSONObj>::const_iterator end) {
+    OldClientWriteContext cx(opCtx, nss.ns());
+
+    std::vector<InsertStatement> inserts;
+
+    for (auto it = begin; it != end; ++it) {
+        const BSONObj& docToClone = *it;
+
+        BSONObj localDoc;
+        if (willOverrideLocalId(
+                opCtx, nss, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
+            string errMsg = str::stream() << "cannot migrate chunk, local document "
+                                          << redact(localDoc) << " has same _id as cloned "
+                                          << "remote document " << redact(docToClone);
+
+            warning() << errMsg;
+
+            // Exception will abort migration cleanly
+            uasserted(16976, errMsg);
+        }
+
+        // Any orphans within the chunk range are deleted before cloning starts, but if a document
+        // with the same _id is still present, overwrite it as opposed to failing the whole batch
+        // with a duplicate key error
+        if (!localDoc.isEmpty()) {
+            Helpers::upsert(opCtx, nss.ns(), docToClone, true);
+            continue;
+        }
+
+        inserts.emplace_back(docToClone);
+    }
+
+    if (inserts.empty())
+        return;
+
+    writeConflictRetry(opCtx, "migrateCloneInsert", nss.ns(), [&] {
+        Collection* const collection = cx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Collection " << nss.ns()
+                              << " was dropped in the middle of the migration",
+                collection);
+
+        WriteUnitOfWork wuow(opCtx);
+        uassertStatusOK(collection->insertDocuments(
+            opCtx, inserts.cbegin(), inserts.cend(), nullptr, false, true));
+        wuow.commit();
+    });
+}
+
 /**
  * Returns true if the majority of the nodes and the nodes corresponding to the given writeConcern
  * (if not empty) have applied till the specified lastOp.
@@ -708,11 +796,20 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            std::vector<BSONObj> docsToClone;
+            for (const auto& docElem : res["objects"].Obj()) {
+                docsToClone.push_back(docElem.Obj());
+            }
+
+            if (docsToClone.empty())
+                break;
+
+            const int batchSizeParam = migrateCloneInsertionBatchSize.load();
+            const size_t batchSize = batchSizeParam > 0 ? static_cast<size_t>(batchSizeParam)
+                                                        : docsToClone.size();
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
+            auto batchBegin = docsToClone.cbegin();
+            while (batchBegin != docsToClone.cend()) {
                 opCtx->checkForInterrupt();
 
                 if (getState() == ABORT) {
@@ -720,38 +817,18 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                     return;
                 }
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(opCtx, _nss.ns());
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << redact(localDoc)
-                                                      << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
+                const auto batchEnd = batchBegin +
+                    std::min(batchSize, static_cast<size_t>(docsToClone.cend() - batchBegin));
 
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
-                }
-                thisTime++;
+                insertClonedDocuments(
+                    opCtx, _nss, min, max, shardKeyPattern, batchBegin, batchEnd);
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    for (auto it = batchBegin; it != batchEnd; ++it) {
+                        _numCloned++;
+                        _clonedBytes += it->objsize();
+                    }
                 }
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
@@ -767,10 +844,14 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                         massertStatusOK(replStatus.status);
                     }
                 }
-            }
 
-            if (thisTime == 0)
-                break;
+                batchBegin = batchEnd;
+
+                const int batchDelayMS = migrateCloneInsertionBatchDelayMS.load();
+                if (batchDelayMS > 0) {
+                    opCtx->sleepFor(Milliseconds(batchDelayMS));
+                }
+            }
         }
 
         timing.done(3);
@@ -965,7 +1046,7 @@ bool MigrationDestinationManager::_applyMigrateOp(OperationContext* opCtx,
             // do not apply delete if doc does not belong to the chunk being migrated
             BSONObj fullObj;
             if (Helpers::findById(opCtx, ctx.db(), nss.ns(), id, fullObj)) {
-                if (!isInRange(fullObj, min, max, shardKeyPattern)) {
+                if (!isInRange(opCtx, nss, fullObj, min, max, shardKeyPattern)) {
                     if (MONGO_FAIL_POINT(failMigrationReceivedOutOfRangeOperation)) {
                         invariant(0);
                     }
@@ -998,7 +1079,7 @@ bool MigrationDestinationManager::_applyMigrateOp(OperationContext* opCtx,
             BSONObj updatedDoc = i.next().Obj();
 
             // do not apply insert/update if doc does not belong to the chunk being migrated
-            if (!isInRange(updatedDoc, min, max, shardKeyPattern)) {
+            if (!isInRange(opCtx, nss, updatedDoc, min, max, shardKeyPattern)) {
                 if (MONGO_FAIL_POINT(failMigrationReceivedOutOfRangeOperation)) {
                     invariant(0);
                 }
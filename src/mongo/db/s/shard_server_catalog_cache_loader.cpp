@@ -88,6 +88,7 @@ Status persistCollectionAndChangedChunks(OperationContext* opCtx,
                                                      collAndChunks.shardKeyPattern,
                                                      collAndChunks.defaultCollation,
                                                      collAndChunks.shardKeyIsUnique);
+    update.setHashVersion(collAndChunks.shardKeyHashVersion);
     Status status = updateShardCollectionsEntry(opCtx,
                                                 BSON(ShardCollectionType::ns() << nss.ns()),
                                                 update.toBSON(),
@@ -192,12 +193,14 @@ CollectionAndChangedChunks getPersistedMetadataSinceVersion(OperationContext* op
     auto changedChunks = uassertStatusOK(
         readShardChunks(opCtx, nss, diff.query, diff.sort, boost::none, startingVersion.epoch()));
 
-    return CollectionAndChangedChunks{shardCollectionEntry.getUUID(),
-                                      shardCollectionEntry.getEpoch(),
-                                      shardCollectionEntry.getKeyPattern().toBSON(),
-                                      shardCollectionEntry.getDefaultCollation(),
-                                      shardCollectionEntry.getUnique(),
-                                      std::move(changedChunks)};
+    CollectionAndChangedChunks collAndChunks{shardCollectionEntry.getUUID(),
+                                             shardCollectionEntry.getEpoch(),
+                                             shardCollectionEntry.getKeyPattern().toBSON(),
+                                             shardCollectionEntry.getDefaultCollation(),
+                                             shardCollectionEntry.getUnique(),
+                                             std::move(changedChunks)};
+    collAndChunks.shardKeyHashVersion = shardCollectionEntry.getHashVersion();
+    return collAndChunks;
 }
 
 /**
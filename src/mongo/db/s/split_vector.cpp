@@ -38,22 +38,120 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 namespace {
 
+// When positive, a split point lookup which is not forced draws this many keys from a random
+// cursor over the shard key index and picks the split points from those falling in the chunk,
+// instead of scanning every key in the chunk.
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorSampleSize, int, 0);
+
 const int kMaxObjectPerChunk{250000};
 
+// A sampled lookup gives up, and the chunk is scanned, if fewer than one in this many random keys
+// fall in the chunk.
+const int kMaxSampleDrawsPerKey{10};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Picks split points for the index range [minKey, maxKey) from a random sample of the keys of
+ * 'idx', such that each resulting chunk holds approximately 'keyCount' keys. The returned split
+ * points are in shard key format and ascending order, and never include 'min'.
+ *
+ * Returns boost::none if the index does not support random cursors, or if too few of the sampled
+ * keys fall in the range to estimate its contents. The range must then be scanned instead.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitKeys(OperationContext* opCtx,
+                                                      Collection* collection,
+                                                      IndexDescriptor* idx,
+                                                      const BSONObj& keyPattern,
+                                                      const BSONObj& min,
+                                                      const BSONObj& minKey,
+                                                      const BSONObj& maxKey,
+                                                      long long recCount,
+                                                      long long keyCount,
+                                                      boost::optional<long long> maxSplitPoints,
+                                                      int sampleSize) {
+    auto cursor = collection->getIndexCatalog()->getIndex(idx)->newRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    const Ordering ordering = Ordering::make(idx->keyPattern());
+    const long long maxDraws = static_cast<long long>(sampleSize) * kMaxSampleDrawsPerKey;
+
+    std::vector<BSONObj> sampledKeys;
+    long long draws = 0;
+    while (draws < maxDraws && sampledKeys.size() < static_cast<size_t>(sampleSize)) {
+        auto entry = cursor->next(SortedDataInterface::Cursor::kWantKey);
+        if (!entry) {
+            return boost::none;
+        }
+        ++draws;
+
+        if (entry->key.woCompare(minKey, ordering, false) >= 0 &&
+            entry->key.woCompare(maxKey, ordering, false) < 0) {
+            sampledKeys.push_back(dotted_path_support::extractElementsBasedOnTemplate(
+                prettyKey(idx->keyPattern(), entry->key.getOwned()), keyPattern));
+        }
+    }
+
+    if (sampledKeys.size() < static_cast<size_t>(sampleSize / kMaxSampleDrawsPerKey) ||
+        sampledKeys.empty()) {
+        LOG(1) << "only " << sampledKeys.size() << " of " << draws << " sampled keys of "
+               << collection->ns() << " fell in " << redact(minKey) << " -->> " << redact(maxKey)
+               << ", scanning the range instead";
+        return boost::none;
+    }
+
+    // Each draw lands in the range with probability (keys in range) / (keys in index)
+    const double estimatedKeysInRange =
+        static_cast<double>(recCount) * sampledKeys.size() / static_cast<double>(draws);
+    long long numSplitPoints = static_cast<long long>(estimatedKeysInRange / keyCount);
+    if (maxSplitPoints && maxSplitPoints.get()) {
+        numSplitPoints = std::min(numSplitPoints, maxSplitPoints.get());
+    }
+
+    std::sort(sampledKeys.begin(),
+              sampledKeys.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Split at the sampled keys whose ranks correspond to every 'keyCount'-th key of the range. A
+    // key repeated more often than a chunk can hold yields a single split point.
+    std::vector<BSONObj> splitKeys;
+    for (long long i = 1; i <= numSplitPoints; ++i) {
+        const size_t rank = static_cast<size_t>(static_cast<double>(i) * keyCount *
+                                                sampledKeys.size() / estimatedKeysInRange);
+        if (rank >= sampledKeys.size()) {
+            break;
+        }
+
+        const BSONObj& key = sampledKeys[rank];
+        if (key.woCompare(min) <= 0 ||
+            (!splitKeys.empty() && key.woCompare(splitKeys.back()) == 0)) {
+            continue;
+        }
+        splitKeys.push_back(key);
+    }
+
+    LOG(1) << "picked " << splitKeys.size() << " split points for " << collection->ns() << " "
+           << redact(minKey) << " -->> " << redact(maxKey) << " from " << sampledKeys.size()
+           << " of " << draws << " sampled keys";
+    return splitKeys;
+}
+
 }  // namespace
 
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
@@ -151,6 +249,24 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        const int sampleSize = splitVectorSampleSize.load();
+        if (!force && sampleSize > 0) {
+            auto sampledSplitKeys = sampleSplitKeys(opCtx,
+                                                    collection,
+                                                    idx,
+                                                    keyPattern,
+                                                    min,
+                                                    minKey,
+                                                    maxKey,
+                                                    recCount,
+                                                    keyCount,
+                                                    maxSplitPoints,
+                                                    sampleSize);
+            if (sampledSplitKeys) {
+                return std::move(*sampledSplitKeys);
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
@@ -33,8 +33,10 @@
 #include "mongo/db/s/split_vector.h"
 
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -300,5 +302,28 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SampledSplitVectorInHalf) {
+    auto sampleSize = ServerParameterSet::getGlobal()->getMap().find("splitVectorSampleSize");
+    ASSERT(sampleSize != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(sampleSize->second->setFromString("1000"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(sampleSize->second->setFromString("0")); });
+
+    // Storage engines without random index cursors fall back to scanning the chunk, so only the
+    // approximate position of the split point can be relied on.
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 0),
+                                                                     BSON(kPattern << 100),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 100LL));
+    ASSERT_EQ(1U, splitKeys.size());
+    ASSERT_GT(splitKeys.front()[kPattern].numberInt(), 0);
+    ASSERT_LT(splitKeys.front()[kPattern].numberInt(), 100);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -66,6 +66,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/slow_op_recorder.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/metadata.h"
@@ -82,6 +83,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/op_msg.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -428,7 +430,7 @@ bool runCommandImpl(OperationContext* opCtx,
                     const OpMsgRequest& request,
                     rpc::ReplyBuilderInterface* replyBuilder,
                     LogicalTime startOperationTime) {
-    auto bytesToReserve = command->reserveBytesForReply();
+    auto bytesToReserve = command->replyBufferSizeHint();
 
 // SERVER-22100: In Windows DEBUG builds, the CRT heap debugging overhead, in conjunction with the
 // additional memory pressure introduced by reply buffer pre-allocation, causes the concurrency
@@ -542,6 +544,7 @@ bool runCommandImpl(OperationContext* opCtx,
     }
 
     inPlaceReplyBob.doneFast();
+    command->recordReplySize(inPlaceReplyBob.len());
 
     BSONObjBuilder metadataBob;
     appendReplyMetadata(opCtx, request, &metadataBob);
@@ -573,6 +576,12 @@ void execCommandDatabase(OperationContext* opCtx,
             CurOp::get(opCtx)->setCommand_inlock(command);
         }
 
+        const auto targetElem = request.body.firstElement();
+        const std::string profilerNs = targetElem.type() == String
+            ? str::stream() << request.getDatabase() << '.' << targetElem.valueStringData()
+            : request.getDatabase().toString();
+        SamplingProfiler::ThreadTag profilerTag(command->getName(), profilerNs);
+
         // TODO: move this back to runCommands when mongos supports OperationContext
         // see SERVER-18515 for details.
         rpc::readRequestMetadata(opCtx, request.body);
@@ -688,7 +697,7 @@ void execCommandDatabase(OperationContext* opCtx,
             LOG(2) << "command: " << request.getCommandName();
         }
 
-        if (command->maintenanceMode()) {
+        if (command->maintenanceMode(request.body)) {
             mmSetter.reset(new MaintenanceModeSetter(opCtx));
         }
 
@@ -827,10 +836,15 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
 
 DbResponse runCommands(OperationContext* opCtx, const Message& message) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    BSONObj exhaustInvocation;
     [&] {
         OpMsgRequest request;
         try {  // Parse.
             request = rpc::opMsgRequestFromAnyProtocol(message);
+            if (OpMsg::isFlagSet(message, OpMsg::kExhaustSupported) &&
+                request.getCommandName() == "getMore") {
+                exhaustInvocation = request.body.getOwned();
+            }
         } catch (const DBException& ex) {
             // If this error needs to fail the connection, propagate it out.
             if (ErrorCodes::isConnectionFatalMessageParseError(ex.code()))
@@ -898,7 +912,19 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
+    // If the client allows it and the cursor is still open, stream the next batch back without
+    // waiting for the client to ask for it. TCP flow control throttles the server when the client
+    // falls behind.
+    if (!exhaustInvocation.isEmpty()) {
+        const auto replyBody = OpMsg::parse(response).body;
+        const auto cursorElem = replyBody["cursor"];
+        if (replyBody["ok"].trueValue() && cursorElem.type() == BSONType::Object &&
+            cursorElem.Obj()["id"].numberLong() != 0) {
+            OpMsg::setFlag(&response, OpMsg::kMoreToCome);
+            return DbResponse{std::move(response), {}, std::move(exhaustInvocation)};
+        }
+    }
+
     return DbResponse{std::move(response)};
 }
 
@@ -1113,6 +1139,7 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
 
     const char* ns = dbmsg.messageShouldHaveNs() ? dbmsg.getns() : NULL;
     const NamespaceString nsString = ns ? NamespaceString(ns) : NamespaceString();
+    SamplingProfiler::ThreadTag profilerTag(networkOpToString(op), nsString.ns());
 
     if (op == dbQuery) {
         if (nsString.isCommand()) {
@@ -1188,6 +1215,7 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
     currentOp.ensureStarted();
     currentOp.done();
     debug.executionTimeMicros = durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses());
+    debug.cpuNanos = currentOp.cpuNanos();
 
     Top::get(opCtx->getServiceContext())
         .incrementGlobalLatencyStats(
@@ -1205,6 +1233,10 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
         log() << debug.report(&c, currentOp, lockerInfo.stats);
     }
 
+    if (shouldSample && SlowOpRecorder::shouldRecord(debug.executionTimeMicros)) {
+        recordSlowOp(opCtx);
+    }
+
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
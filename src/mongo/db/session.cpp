@@ -131,6 +131,24 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
     return result;
 }
 
+/**
+ * Returns whether 'doc' has every field of 'query' with an equal value. The queries which this file
+ * builds for the transactions table are equality matches on plain values, so this gives the same
+ * answer as a matcher without having to parse one for every retryable write.
+ */
+bool matchesEqualityQuery(const BSONObj& doc, const BSONObj& query) {
+    for (const auto& queryElem : query) {
+        dassert(!queryElem.isABSONObj() || queryElem.Obj().firstElementFieldName()[0] != '$');
+
+        const auto docElem = doc[queryElem.fieldNameStringData()];
+        if (docElem.eoo() || docElem.woCompare(queryElem, false) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequest) {
     // Current code only supports replacement update.
     dassert(UpdateDriver::isDocReplacement(updateRequest.getUpdates()));
@@ -181,11 +199,8 @@ void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequ
     auto originalDoc = originalRecordData.toBson();
 
     invariant(collection->getDefaultCollator() == nullptr);
-    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(opCtx, nullptr));
 
-    auto matcher = fassertStatusOK(
-        40673, MatchExpressionParser::parse(updateRequest.getQuery(), std::move(expCtx)));
-    if (!matcher->matchesBSON(originalDoc)) {
+    if (!matchesEqualityQuery(originalDoc, updateRequest.getQuery())) {
         // Document no longer match what we expect so throw WCE to make the caller re-examine.
         throw WriteConflictException();
     }
@@ -47,10 +47,16 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
+#include <exception>
 #include <snappy.h>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
@@ -58,7 +64,9 @@
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/posix_fadvise.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
@@ -102,6 +110,79 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Calls 'func' with each index in [0, count), running the calls on up to 'count' threads including
+ * the calling one. Rethrows the first exception thrown by any call once all of them are done.
+ */
+template <typename Func>
+void runOnThreads(size_t count, const Func& func) {
+    std::vector<std::exception_ptr> errors(count);
+    auto run = [&](size_t i) {
+        try {
+            func(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 1; i < count; i++) {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * Stable sorts [begin, end) with 'less' on up to 'numThreads' threads. Equal slices are sorted
+ * concurrently and then merged in pairs, each round of merges also running concurrently. Inputs too
+ * small to be worth the threads are sorted on the calling thread.
+ */
+template <typename Iterator, typename Less>
+void parallelStableSort(Iterator begin, Iterator end, const Less& less, size_t numThreads) {
+    const size_t kMinElementsPerThread = 16 * 1024;
+    const size_t size = std::distance(begin, end);
+    numThreads = std::min(numThreads, size / kMinElementsPerThread);
+    if (numThreads <= 1) {
+        std::stable_sort(begin, end, less);
+        return;
+    }
+
+    // Slice i is [bounds[i], bounds[i + 1]).
+    std::vector<Iterator> bounds;
+    for (size_t i = 0; i <= numThreads; i++) {
+        bounds.push_back(begin + size * i / numThreads);
+    }
+
+    runOnThreads(numThreads, [&](size_t i) { std::stable_sort(bounds[i], bounds[i + 1], less); });
+
+    while (bounds.size() > 2) {
+        const size_t numMerges = (bounds.size() - 1) / 2;
+        runOnThreads(numMerges, [&](size_t i) {
+            std::inplace_merge(bounds[2 * i], bounds[2 * i + 1], bounds[2 * i + 2], less);
+        });
+
+        // Every other bound remains, plus the end if there was an odd number of slices.
+        std::vector<Iterator> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != bounds.back()) {
+            merged.push_back(bounds.back());
+        }
+        bounds.swap(merged);
+    }
+}
+
 /** Ensures a named file is deleted when this object goes out of scope */
 class FileDeleter {
 public:
@@ -168,6 +249,19 @@ public:
         massert(16815,
                 str::stream() << "unexpected empty file: " << _fileName,
                 boost::filesystem::file_size(_fileName) != 0);
+
+#if defined(POSIX_FADV_WILLNEED)
+        // Only used to ask the kernel to read ahead of _file, so failing to open it is harmless.
+        _readAheadFd = ::open(_fileName.c_str(), O_RDONLY);
+#endif
+    }
+
+    ~FileIterator() {
+#if defined(POSIX_FADV_WILLNEED)
+        if (_readAheadFd >= 0) {
+            ::close(_readAheadFd);
+        }
+#endif
     }
 
     bool more() {
@@ -208,6 +302,9 @@ private:
         read(_buffer.get(), blockSize);
         massert(16816, "file too short?", !_done);
 
+        _fileOffset += sizeof(rawSize) + blockSize;
+        readAhead();
+
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
@@ -247,6 +344,22 @@ private:
         _reader.reset(new BufReader(_buffer.get(), uncompressedSize));
     }
 
+    /**
+     * Keeps the kernel reading the blocks following the current one in the background, so that a
+     * merge over many files rarely waits on disk for its next block.
+     */
+    void readAhead() {
+#if defined(POSIX_FADV_WILLNEED)
+        const long long kReadAheadBytes = 1024 * 1024;
+        if (_readAheadFd < 0 || _fileOffset + kReadAheadBytes / 2 < _readAheadUntil) {
+            return;
+        }
+
+        posix_fadvise(_readAheadFd, _fileOffset, kReadAheadBytes, POSIX_FADV_WILLNEED);
+        _readAheadUntil = _fileOffset + kReadAheadBytes;
+#endif
+    }
+
     // sets _done to true on EOF - asserts on any other error
     void read(void* out, size_t size) {
         _file.read(reinterpret_cast<char*>(out), size);
@@ -270,6 +383,11 @@ private:
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
+
+    // Offset in the file of the next block, and how far it has been read ahead of.
+    long long _fileOffset = 0;
+    long long _readAheadUntil = 0;
+    int _readAheadFd = -1;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -455,7 +573,7 @@ private:
 
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        parallelStableSort(_data.begin(), _data.end(), less, _opts.sortThreads);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
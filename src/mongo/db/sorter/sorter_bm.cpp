@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include <boost/filesystem.hpp>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+using KeySorter = Sorter<BSONObj, RecordId>;
+
+class KeyComparator {
+public:
+    int operator()(const std::pair<BSONObj, RecordId>& lhs,
+                   const std::pair<BSONObj, RecordId>& rhs) const {
+        return lhs.first.woCompare(rhs.first, BSONObj(), false);
+    }
+};
+
+const int kNumKeys = 10 * 1000;
+
+std::vector<BSONObj> makeKeys() {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<long long> dist;
+
+    std::vector<BSONObj> keys;
+    for (int i = 0; i < kNumKeys; ++i) {
+        keys.push_back(BSON("" << dist(gen) << ""
+                               << "padding"));
+    }
+    return keys;
+}
+
+void sortKeys(unittest::BenchmarkState& state, const SortOptions& opts) {
+    const std::vector<BSONObj> keys = makeKeys();
+
+    while (state.keepRunning()) {
+        std::unique_ptr<KeySorter> sorter(KeySorter::make(opts, KeyComparator()));
+        for (int i = 0; i < kNumKeys; ++i) {
+            sorter->add(keys[i], RecordId(i + 1));
+        }
+
+        std::unique_ptr<KeySorter::Iterator> it(sorter->done());
+        while (it->more()) {
+            unittest::doNotOptimizeAway(it->next());
+        }
+    }
+
+    state.setItemsProcessed(state.iterations() * kNumKeys);
+}
+
+MONGO_BENCHMARK(SorterInMemory) {
+    sortKeys(state, SortOptions());
+}
+
+MONGO_BENCHMARK(SorterTopK) {
+    sortKeys(state, SortOptions().Limit(100));
+}
+
+MONGO_BENCHMARK(SorterLimitOne) {
+    sortKeys(state, SortOptions().Limit(1));
+}
+
+MONGO_BENCHMARK(SorterExternal) {
+    const auto tempDir =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("sorter_bm-%%%%");
+    boost::filesystem::create_directories(tempDir);
+
+    // Small enough that every sort spills several files
+    sortKeys(state,
+             SortOptions().ExtSortAllowed().MaxMemoryUsageBytes(64 * 1024).TempDir(
+                 tempDir.string()));
+
+    boost::filesystem::remove_all(tempDir);
+}
+
+}  // namespace
+}  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BSONObj, mongo::RecordId, mongo::KeyComparator);
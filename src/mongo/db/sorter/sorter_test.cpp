@@ -541,8 +541,58 @@ class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     }
     enum { MEM_LIMIT = 32 * 1024 };
 };
+
+template <size_t MemLimit, bool Random = true>
+class LotsOfDataParallelSort : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        // Make sure every in-memory run is large enough to be sorted on several threads.
+        MONGO_STATIC_ASSERT(MemLimit / sizeof(IWPair) > 4 * 16 * 1024);
+
+        return opts.MaxMemoryUsageBytes(MemLimit).ExtSortAllowed().SortThreads(4);
+    }
+};
 }
 
+class ParallelStableSortTests {
+public:
+    void run() {
+        // Many equal keys, each with values in insertion order, so that stability can be checked.
+        const int kNumItems = 200 * 1000;
+        std::vector<IWPair> data;
+        for (int i = 0; i < kNumItems; i++) {
+            data.emplace_back((i * 7919) % 1000, i);
+        }
+
+        IWComparator comp(ASC);
+        auto less = [&](const IWPair& lhs, const IWPair& rhs) { return comp(lhs, rhs) < 0; };
+        for (size_t numThreads : {1, 2, 3, 8}) {
+            std::vector<IWPair> sorted = data;
+            parallelStableSort(sorted.begin(), sorted.end(), less, numThreads);
+
+            std::vector<IWPair> expected = data;
+            std::stable_sort(expected.begin(), expected.end(), less);
+            for (int i = 0; i < kNumItems; i++) {
+                ASSERT_EQUALS(static_cast<int>(sorted[i].first),
+                              static_cast<int>(expected[i].first));
+                ASSERT_EQUALS(static_cast<int>(sorted[i].second),
+                              static_cast<int>(expected[i].second));
+            }
+        }
+
+        // Exceptions thrown while sorting on other threads reach the caller.
+        std::vector<IWPair> sorted = data;
+        ASSERT_THROWS_CODE(parallelStableSort(sorted.begin(),
+                                              sorted.end(),
+                                              [](const IWPair& lhs, const IWPair& rhs) -> bool {
+                                                  uasserted(ErrorCodes::InternalError, "failed");
+                                              },
+                                              4),
+                           AssertionException,
+                           ErrorCodes::InternalError);
+    }
+};
+
 class SorterSuite : public mongo::unittest::Suite {
 public:
     SorterSuite() : Suite("sorter") {}
@@ -562,6 +612,9 @@ public:
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/true>>();    // fits in mem
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/false>>();  // spills
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true>>();   // spills
+        add<SorterTests::LotsOfDataParallelSort<64 * 1024 * 1024>>();        // fits in mem
+        add<SorterTests::LotsOfDataParallelSort<1024 * 1024>>();             // spills
+        add<ParallelStableSortTests>();
     }
 };
 
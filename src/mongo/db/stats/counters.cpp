@@ -41,41 +41,62 @@ namespace mongo {
 
 using std::endl;
 
+namespace {
+
+// Each thread picks its OpCounters shard once, round robin, so that shards stay evenly used no
+// matter how threads are scheduled onto cores.
+AtomicUInt32 nextShardIndex;
+thread_local unsigned threadShardIndex = nextShardIndex.fetchAndAdd(1);
+
+}  // namespace
+
 OpCounters::OpCounters() {}
 
+OpCounters::Shard& OpCounters::_shard() {
+    return _shards[threadShardIndex % kNumShards];
+}
+
+unsigned OpCounters::_sum(AtomicUInt32 Shard::*counter) const {
+    unsigned total = 0;
+    for (const auto& shard : _shards) {
+        total += (shard.*counter).loadRelaxed();
+    }
+    return total;
+}
+
 void OpCounters::gotInserts(int n) {
     RARELY _checkWrap();
-    _insert.fetchAndAdd(n);
+    _shard().insert.fetchAndAdd(n);
 }
 
 void OpCounters::gotInsert() {
     RARELY _checkWrap();
-    _insert.fetchAndAdd(1);
+    _shard().insert.fetchAndAdd(1);
 }
 
 void OpCounters::gotQuery() {
     RARELY _checkWrap();
-    _query.fetchAndAdd(1);
+    _shard().query.fetchAndAdd(1);
 }
 
 void OpCounters::gotUpdate() {
     RARELY _checkWrap();
-    _update.fetchAndAdd(1);
+    _shard().update.fetchAndAdd(1);
 }
 
 void OpCounters::gotDelete() {
     RARELY _checkWrap();
-    _delete.fetchAndAdd(1);
+    _shard().del.fetchAndAdd(1);
 }
 
 void OpCounters::gotGetMore() {
     RARELY _checkWrap();
-    _getmore.fetchAndAdd(1);
+    _shard().getmore.fetchAndAdd(1);
 }
 
 void OpCounters::gotCommand() {
     RARELY _checkWrap();
-    _command.fetchAndAdd(1);
+    _shard().command.fetchAndAdd(1);
 }
 
 void OpCounters::gotOp(int op, bool isCommand) {
@@ -109,28 +130,29 @@ void OpCounters::gotOp(int op, bool isCommand) {
 void OpCounters::_checkWrap() {
     const unsigned MAX = 1 << 30;
 
-    bool wrap = _insert.loadRelaxed() > MAX || _query.loadRelaxed() > MAX ||
-        _update.loadRelaxed() > MAX || _delete.loadRelaxed() > MAX ||
-        _getmore.loadRelaxed() > MAX || _command.loadRelaxed() > MAX;
+    bool wrap = getInsert() > MAX || getQuery() > MAX || getUpdate() > MAX || getDelete() > MAX ||
+        getGetMore() > MAX || getCommand() > MAX;
 
     if (wrap) {
-        _insert.store(0);
-        _query.store(0);
-        _update.store(0);
-        _delete.store(0);
-        _getmore.store(0);
-        _command.store(0);
+        for (auto& shard : _shards) {
+            shard.insert.store(0);
+            shard.query.store(0);
+            shard.update.store(0);
+            shard.del.store(0);
+            shard.getmore.store(0);
+            shard.command.store(0);
+        }
     }
 }
 
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.append("insert", getInsert());
+    b.append("query", getQuery());
+    b.append("update", getUpdate());
+    b.append("delete", getDelete());
+    b.append("getmore", getGetMore());
+    b.append("command", getCommand());
     return b.obj();
 }
 
@@ -42,6 +42,10 @@ namespace mongo {
 /**
  * for storing operation counters
  * note: not thread safe.  ok with that for speed
+ *
+ * Each counter is split across cache-line sized shards and every thread increments the shard it
+ * was assigned on first use, so that operations on different cores do not contend on the same
+ * line. Readers sum the shards.
  */
 class OpCounters {
 public:
@@ -59,34 +63,44 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicUInt32* getInsert() const {
-        return &_insert;
+    unsigned getInsert() const {
+        return _sum(&Shard::insert);
     }
-    const AtomicUInt32* getQuery() const {
-        return &_query;
+    unsigned getQuery() const {
+        return _sum(&Shard::query);
     }
-    const AtomicUInt32* getUpdate() const {
-        return &_update;
+    unsigned getUpdate() const {
+        return _sum(&Shard::update);
     }
-    const AtomicUInt32* getDelete() const {
-        return &_delete;
+    unsigned getDelete() const {
+        return _sum(&Shard::del);
     }
-    const AtomicUInt32* getGetMore() const {
-        return &_getmore;
+    unsigned getGetMore() const {
+        return _sum(&Shard::getmore);
     }
-    const AtomicUInt32* getCommand() const {
-        return &_command;
+    unsigned getCommand() const {
+        return _sum(&Shard::command);
     }
 
 private:
+    struct Shard {
+        AtomicUInt32 insert;
+        AtomicUInt32 query;
+        AtomicUInt32 update;
+        AtomicUInt32 del;
+        AtomicUInt32 getmore;
+        AtomicUInt32 command;
+    };
+    static_assert(sizeof(Shard) <= stdx::hardware_constructive_interference_size,
+                  "cache line spill");
+
+    enum { kNumShards = 32 };
+
+    Shard& _shard();
+    unsigned _sum(AtomicUInt32 Shard::*counter) const;
     void _checkWrap();
 
-    CacheAligned<AtomicUInt32> _insert;
-    CacheAligned<AtomicUInt32> _query;
-    CacheAligned<AtomicUInt32> _update;
-    CacheAligned<AtomicUInt32> _delete;
-    CacheAligned<AtomicUInt32> _getmore;
-    CacheAligned<AtomicUInt32> _command;
+    CacheAligned<Shard> _shards[kNumShards];
 };
 
 extern OpCounters globalOpCounters;
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(OpCountersTest, GetObjStartsAtZero) {
+    OpCounters counters;
+    ASSERT_BSONOBJ_EQ(BSON("insert" << 0 << "query" << 0 << "update" << 0 << "delete" << 0
+                                    << "getmore"
+                                    << 0
+                                    << "command"
+                                    << 0),
+                      counters.getObj());
+}
+
+TEST(OpCountersTest, IncrementsFromManyThreadsAreSummed) {
+    OpCounters counters;
+    const int kThreads = 40;
+    const int kIterations = 1000;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kIterations; j++) {
+                counters.gotInserts(2);
+                counters.gotQuery();
+                counters.gotCommand();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(2u * kThreads * kIterations, counters.getInsert());
+    ASSERT_EQ(1u * kThreads * kIterations, counters.getQuery());
+    ASSERT_EQ(1u * kThreads * kIterations, counters.getCommand());
+    ASSERT_EQ(0u, counters.getUpdate());
+    ASSERT_EQ(static_cast<int>(kThreads * kIterations), counters.getObj()["query"].numberInt());
+}
+
+}  // namespace
@@ -32,6 +32,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/lock_contention_sampler.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -124,5 +125,28 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+/**
+ * Only the sample counters are reported here. The samples themselves are available through the
+ * $lockContention aggregation stage; their varying shape would cause too many schema changes for
+ * FTDC to compress well.
+ */
+class LockContentionServerStatusSection : public ServerStatusSection {
+public:
+    LockContentionServerStatusSection() : ServerStatusSection("lockContention") {}
+
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    virtual BSONObj generateSection(OperationContext* opCtx,
+                                    const BSONElement& configElement) const {
+        BSONObjBuilder ret;
+        LockContentionSampler::get().report(&ret);
+        return ret.obj();
+    }
+
+} lockContentionServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/slow_op_recorder.h"
+
+#include <algorithm>
+
+#include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSlowOpRecorder = ServiceContext::declareDecoration<SlowOpRecorder>();
+
+AtomicInt32 slowOpRecorderMaxEntries(100);
+
+class SlowOpRecorderMaxEntriesParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    SlowOpRecorderMaxEntriesParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "slowOpRecorderMaxEntries",
+              &slowOpRecorderMaxEntries) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0 || potentialNewValue > 10000) {
+            return Status(ErrorCodes::BadValue,
+                          "slowOpRecorderMaxEntries must be between 0 and 10000");
+        }
+        return Status::OK();
+    }
+} slowOpRecorderMaxEntriesParameter;
+
+}  // namespace
+
+constexpr size_t SlowOpRecorder::kMaxTotalBytes;
+
+// static
+SlowOpRecorder& SlowOpRecorder::get(ServiceContext* service) {
+    return getSlowOpRecorder(service);
+}
+
+// static
+bool SlowOpRecorder::isEnabled() {
+    return slowOpRecorderMaxEntries.load() > 0;
+}
+
+// static
+bool SlowOpRecorder::shouldRecord(long long executionTimeMicros) {
+    return isEnabled() && executionTimeMicros > serverGlobalParams.slowMS * 1000LL;
+}
+
+void SlowOpRecorder::record(BSONObj entry) {
+    record(std::move(entry), static_cast<size_t>(std::max(0, slowOpRecorderMaxEntries.load())));
+}
+
+void SlowOpRecorder::record(BSONObj entry, size_t maxEntries) {
+    if (maxEntries == 0) {
+        return;
+    }
+
+    // Copy outside of the mutex so that recording never stalls readers on a large memcpy.
+    entry = entry.getOwned();
+    const size_t entryBytes = entry.objsize();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.push_back(std::move(entry));
+    _totalBytes += entryBytes;
+
+    while (_entries.size() > maxEntries || (_totalBytes > kMaxTotalBytes && _entries.size() > 1)) {
+        _totalBytes -= _entries.front().objsize();
+        _entries.pop_front();
+        ++_numDiscarded;
+    }
+}
+
+std::vector<BSONObj> SlowOpRecorder::getEntries() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return {_entries.begin(), _entries.end()};
+}
+
+long long SlowOpRecorder::getNumDiscarded() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numDiscarded;
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A bounded, in-memory record of the operations that exceeded the slow operation threshold
+ * (slowms). Each entry has the same shape as a system.profile document, including the execution
+ * stats of the winning plan, but recording one only appends to a buffer rather than writing to a
+ * collection. When the buffer is full the oldest entries are discarded.
+ *
+ * The number of retained entries is set by the 'slowOpRecorderMaxEntries' server parameter; zero
+ * disables recording.
+ */
+class SlowOpRecorder {
+    MONGO_DISALLOW_COPYING(SlowOpRecorder);
+
+public:
+    /**
+     * Upper bound on the total size of the retained entries, regardless of their number.
+     */
+    static constexpr size_t kMaxTotalBytes = 16 * 1024 * 1024;
+
+    static SlowOpRecorder& get(ServiceContext* service);
+
+    SlowOpRecorder() = default;
+
+    /**
+     * Returns true if slow operations are being recorded.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns true if an operation which ran for 'executionTimeMicros' should be recorded.
+     */
+    static bool shouldRecord(long long executionTimeMicros);
+
+    /**
+     * Appends 'entry', discarding the oldest entries so that at most 'slowOpRecorderMaxEntries'
+     * remain.
+     */
+    void record(BSONObj entry);
+
+    /**
+     * Like record(BSONObj) but retains at most 'maxEntries' entries.
+     */
+    void record(BSONObj entry, size_t maxEntries);
+
+    /**
+     * Returns the retained entries, oldest first.
+     */
+    std::vector<BSONObj> getEntries() const;
+
+    /**
+     * Returns the number of entries discarded to respect the bounds since startup.
+     */
+    long long getNumDiscarded() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    std::deque<BSONObj> _entries;
+    size_t _totalBytes = 0;
+    long long _numDiscarded = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/slow_op_recorder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(SlowOpRecorderTest, ReturnsEntriesOldestFirst) {
+    SlowOpRecorder recorder;
+    recorder.record(BSON("n" << 1), 10);
+    recorder.record(BSON("n" << 2), 10);
+
+    auto entries = recorder.getEntries();
+    ASSERT_EQ(2U, entries.size());
+    ASSERT_BSONOBJ_EQ(BSON("n" << 1), entries[0]);
+    ASSERT_BSONOBJ_EQ(BSON("n" << 2), entries[1]);
+    ASSERT_EQ(0, recorder.getNumDiscarded());
+}
+
+TEST(SlowOpRecorderTest, DiscardsOldestEntriesBeyondMaxEntries) {
+    SlowOpRecorder recorder;
+    for (int i = 0; i < 5; ++i) {
+        recorder.record(BSON("n" << i), 3);
+    }
+
+    auto entries = recorder.getEntries();
+    ASSERT_EQ(3U, entries.size());
+    ASSERT_EQ(2, entries.front()["n"].numberInt());
+    ASSERT_EQ(4, entries.back()["n"].numberInt());
+    ASSERT_EQ(2, recorder.getNumDiscarded());
+}
+
+TEST(SlowOpRecorderTest, ZeroMaxEntriesRecordsNothing) {
+    SlowOpRecorder recorder;
+    recorder.record(BSON("n" << 1), 0);
+    ASSERT_TRUE(recorder.getEntries().empty());
+}
+
+TEST(SlowOpRecorderTest, DiscardsOldestEntriesBeyondMaxTotalBytes) {
+    SlowOpRecorder recorder;
+    const std::string payload(1024 * 1024, 'x');
+    const size_t numEntries = SlowOpRecorder::kMaxTotalBytes / payload.size() + 4;
+    for (size_t i = 0; i < numEntries; ++i) {
+        recorder.record(BSON("n" << static_cast<long long>(i) << "payload" << payload), 10000);
+    }
+
+    auto entries = recorder.getEntries();
+    ASSERT_LT(entries.size(), numEntries);
+    size_t totalBytes = 0;
+    for (auto&& entry : entries) {
+        totalBytes += entry.objsize();
+    }
+    ASSERT_LTE(totalBytes, SlowOpRecorder::kMaxTotalBytes);
+    ASSERT_EQ(static_cast<long long>(numEntries - 1), entries.back()["n"].numberLong());
+}
+
+TEST(SlowOpRecorderTest, EntriesAreOwned) {
+    SlowOpRecorder recorder;
+    {
+        BSONObjBuilder bob;
+        bob.append("n", 1);
+        recorder.record(bob.done(), 10);
+    }
+    ASSERT_BSONOBJ_EQ(BSON("n" << 1), recorder.getEntries()[0]);
+}
+
+}  // namespace
@@ -109,6 +109,44 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* result) {
+    AutoGetCollectionForReadCommand ctx(opCtx, nss);
+    if (!ctx.getDb()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Database [" << nss.db().toString() << "] not found."};
+    }
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Collection [" << nss.toString() << "] not found."};
+    }
+
+    {
+        BSONObjBuilder collectionStats(result->subobjStart("collection"));
+        collection->getRecordStore()->appendCacheStats(opCtx, &collectionStats);
+    }
+
+    BSONObjBuilder indexStats(result->subobjStart("indexes"));
+
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        const IndexDescriptor* descriptor = i.next();
+        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
+        invariant(iam);
+
+        BSONObjBuilder bob;
+        if (iam->appendCacheStats(opCtx, &bob)) {
+            indexStats.append(descriptor->indexName(), bob.obj());
+        }
+    }
+
+    return Status::OK();
+}
+
 Status appendCollectionRecordCount(OperationContext* opCtx,
                                    const NamespaceString& nss,
                                    BSONObjBuilder* result) {
@@ -44,6 +44,14 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
                                     const BSONObj& param,
                                     BSONObjBuilder* builder);
 
+/**
+ * Appends to 'builder' the storage engine cache residency and I/O statistics of the collection
+ * represented by 'nss', under "collection", and of each of its indexes, under "indexes".
+ */
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* builder);
+
 /**
  * Appends the collection record count to 'builder' for the collection represented by 'nss'.
  */
@@ -69,4 +69,37 @@ BSONObj TimerStats::getReport() const {
     b.appendNumber("totalMillis", t);
     return b.obj();
 }
+
+void MicrosHistogramStats::recordMicros(long long micros) {
+    _count.fetchAndAdd(1);
+    _totalMicros.fetchAndAdd(micros);
+    _buckets[getBucket(micros)].fetchAndAdd(1);
+}
+
+long long MicrosHistogramStats::record(const Timer& timer) {
+    long long micros = timer.micros();
+    recordMicros(micros);
+    return micros;
+}
+
+size_t MicrosHistogramStats::getBucket(long long micros) {
+    size_t bucket = 0;
+    while (micros >= 2 && bucket < kNumBuckets - 1) {
+        micros >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+BSONObj MicrosHistogramStats::getReport() const {
+    BSONObjBuilder b;
+    b.appendNumber("count", _count.loadRelaxed());
+    b.appendNumber("totalMicros", _totalMicros.loadRelaxed());
+    BSONArrayBuilder buckets(b.subarrayStart("buckets"));
+    for (const auto& bucket : _buckets) {
+        buckets.append(bucket.loadRelaxed());
+    }
+    buckets.doneFast();
+    return b.obj();
+}
 }
@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -59,6 +62,44 @@ private:
     AtomicInt64 _totalMillis;
 };
 
+/**
+ * Holds a distribution of durations in microseconds, so that tail latencies can be seen and not
+ * only the mean that TimerStats gives. Durations are counted in power-of-two buckets: bucket 0
+ * holds durations under 2 microseconds, bucket i holds durations in [2^i, 2^(i+1)) and the last
+ * bucket holds everything longer. The report always has kNumBuckets entries so its shape is
+ * stable for diagnostic data collection.
+ */
+class MicrosHistogramStats {
+public:
+    // The last bucket starts at 2^25 microseconds, about 33 seconds.
+    static const size_t kNumBuckets = 26;
+
+    void recordMicros(long long micros);
+
+    /**
+     * @return number of micros
+     */
+    long long record(const Timer& timer);
+
+    /**
+     * Returns the bucket a duration of 'micros' is counted in.
+     */
+    static size_t getBucket(long long micros);
+
+    /**
+     * Reports {count, totalMicros, buckets}, where 'buckets' is an array of kNumBuckets counts.
+     */
+    BSONObj getReport() const;
+    operator BSONObj() const {
+        return getReport();
+    }
+
+private:
+    AtomicInt64 _count;
+    AtomicInt64 _totalMicros;
+    std::array<AtomicInt64, kNumBuckets> _buckets;
+};
+
 /**
  * Holds an instance of a Timer such that we the time is recorded
  * when the TimerHolder goes out of scope
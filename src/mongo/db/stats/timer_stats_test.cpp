@@ -48,4 +48,34 @@ TEST(TimerStatsTest, GetReportOneRecording) {
     ASSERT_BSONOBJ_EQ(BSON("num" << 1 << "totalMillis" << millis), timerStats.getReport());
 }
 
+TEST(MicrosHistogramStatsTest, GetBucket) {
+    ASSERT_EQ(0U, MicrosHistogramStats::getBucket(0));
+    ASSERT_EQ(0U, MicrosHistogramStats::getBucket(1));
+    ASSERT_EQ(1U, MicrosHistogramStats::getBucket(2));
+    ASSERT_EQ(1U, MicrosHistogramStats::getBucket(3));
+    ASSERT_EQ(10U, MicrosHistogramStats::getBucket(1024));
+    ASSERT_EQ(10U, MicrosHistogramStats::getBucket(2047));
+    ASSERT_EQ(MicrosHistogramStats::kNumBuckets - 1,
+              MicrosHistogramStats::getBucket(1LL << (MicrosHistogramStats::kNumBuckets - 1)));
+    ASSERT_EQ(MicrosHistogramStats::kNumBuckets - 1, MicrosHistogramStats::getBucket(1LL << 40));
+}
+
+TEST(MicrosHistogramStatsTest, GetReportHasAllBuckets) {
+    MicrosHistogramStats stats;
+    stats.recordMicros(1);
+    stats.recordMicros(1500);
+    stats.recordMicros(1600);
+
+    BSONObj report = stats.getReport();
+    ASSERT_EQ(3, report["count"].numberLong());
+    ASSERT_EQ(3101, report["totalMicros"].numberLong());
+
+    std::vector<BSONElement> buckets = report["buckets"].Array();
+    ASSERT_EQ(MicrosHistogramStats::kNumBuckets, buckets.size());
+    for (size_t i = 0; i < buckets.size(); i++) {
+        long long expected = i == 0 ? 1 : i == 10 ? 2 : 0;
+        ASSERT_EQ(expected, buckets[i].numberLong()) << "bucket " << i;
+    }
+}
+
 }  // namespace
@@ -65,7 +65,8 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       insert(older.insert, newer.insert),
       update(older.update, newer.update),
       remove(older.remove, newer.remove),
-      commands(older.commands, newer.commands) {}
+      commands(older.commands, newer.commands),
+      writeConflicts(older.writeConflicts, newer.writeConflicts) {}
 
 // static
 Top& Top::get(ServiceContext* service) {
@@ -149,6 +150,15 @@ void Top::collectionDropped(StringData ns, bool databaseDropped) {
     }
 }
 
+void Top::incrementWriteConflicts(StringData ns, long long backoffMicros) {
+    if (ns.empty() || ns[0] == '?')
+        return;
+
+    auto hashedNs = UsageMap::HashedKey(ns);
+    stdx::lock_guard<SimpleMutex> lk(_lock);
+    _usage[hashedNs].writeConflicts.inc(backoffMicros);
+}
+
 void Top::cloneMap(Top::UsageMap& out) const {
     stdx::lock_guard<SimpleMutex> lk(_lock);
     out = _usage;
@@ -185,6 +195,7 @@ void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
         _appendStatsEntry(b, "update", coll.update);
         _appendStatsEntry(b, "remove", coll.remove);
         _appendStatsEntry(b, "commands", coll.commands);
+        _appendStatsEntry(b, "writeConflicts", coll.writeConflicts);
 
         bb.done();
     }
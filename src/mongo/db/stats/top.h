@@ -81,6 +81,10 @@ public:
         UsageData update;
         UsageData remove;
         UsageData commands;
+
+        // 'count' is the number of write conflicts retried on the collection and 'time' the
+        // microseconds spent backing off before those retries.
+        UsageData writeConflicts;
         OperationLatencyHistogram opLatencyHistogram;
     };
 
@@ -107,6 +111,11 @@ public:
 
     void collectionDropped(StringData ns, bool databaseDropped = false);
 
+    /**
+     * Records a write conflict on 'ns' which is retried after backing off for 'backoffMicros'.
+     */
+    void incrementWriteConflicts(StringData ns, long long backoffMicros);
+
     /**
      * Appends the collection-level latency statistics
      */
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/jsobj.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/unittest/unittest.h"
 
@@ -39,4 +40,20 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, IncrementWriteConflicts) {
+    Top top;
+    top.incrementWriteConflicts("test.coll", 0);
+    top.incrementWriteConflicts("test.coll", 250);
+    top.incrementWriteConflicts("test.other", 100);
+
+    BSONObjBuilder builder;
+    top.append(builder);
+    BSONObj totals = builder.obj();
+
+    ASSERT_EQ(2, totals["test.coll"]["writeConflicts"]["count"].numberLong());
+    ASSERT_EQ(250, totals["test.coll"]["writeConflicts"]["time"].numberLong());
+    ASSERT_EQ(1, totals["test.other"]["writeConflicts"]["count"].numberLong());
+    ASSERT_EQ(0, totals["test.other"]["queries"]["count"].numberLong());
+}
+
 }  // namespace
@@ -69,9 +69,12 @@ std::unique_ptr<RecordStore> EphemeralForTestEngine::getRecordStore(
             &_dataMap[ident],
             true,
             options.cappedSize ? options.cappedSize : 4096,
-            options.cappedMaxDocs ? options.cappedMaxDocs : -1);
+            options.cappedMaxDocs ? options.cappedMaxDocs : -1,
+            nullptr,
+            &_memoryUsage);
     } else {
-        return stdx::make_unique<EphemeralForTestRecordStore>(ns, &_dataMap[ident]);
+        return stdx::make_unique<EphemeralForTestRecordStore>(
+            ns, &_dataMap[ident], false, -1, -1, nullptr, &_memoryUsage);
     }
 }
 
@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -114,6 +115,11 @@ private:
     typedef StringMap<std::shared_ptr<void>> DataMap;
 
     mutable stdx::mutex _mutex;
+
+    // Bytes of record data held by all record stores of this engine. Declared before '_dataMap'
+    // since the data releases its bytes from here when it is destroyed.
+    AtomicInt64 _memoryUsage;
+
     DataMap _dataMap;  // All actual data is owned in here
 
     // Notified when we write as everything is considered "journalled" since repl depends on it.
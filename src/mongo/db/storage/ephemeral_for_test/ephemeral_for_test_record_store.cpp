@@ -36,6 +36,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/stdx/memory.h"
@@ -47,6 +48,8 @@ namespace mongo {
 
 using std::shared_ptr;
 
+MONGO_EXPORT_SERVER_PARAMETER(ephemeralForTestMaxDataSizeMB, long long, 0);
+
 class EphemeralForTestRecordStore::InsertChange : public RecoveryUnit::Change {
 public:
     InsertChange(OperationContext* opCtx, Data* data, RecordId loc)
@@ -57,7 +60,7 @@ public:
 
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->adjustDataSize(-it->second.size);
             _data->records.erase(it);
         }
     }
@@ -83,10 +86,10 @@ public:
 
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->adjustDataSize(-it->second.size);
         }
 
-        _data->dataSize += _rec.size;
+        _data->adjustDataSize(_rec.size);
         _data->records[_loc] = _rec;
     }
 
@@ -103,7 +106,8 @@ public:
         using std::swap;
 
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
-        swap(_dataSize, _data->dataSize);
+        _dataSize = _data->dataSize;
+        _data->adjustDataSize(-_dataSize);
         swap(_records, _data->records);
     }
 
@@ -112,7 +116,7 @@ public:
         using std::swap;
 
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
-        swap(_dataSize, _data->dataSize);
+        _data->adjustDataSize(_dataSize - _data->dataSize);
         swap(_records, _data->records);
     }
 
@@ -271,14 +275,15 @@ EphemeralForTestRecordStore::EphemeralForTestRecordStore(StringData ns,
                                                          bool isCapped,
                                                          int64_t cappedMaxSize,
                                                          int64_t cappedMaxDocs,
-                                                         CappedCallback* cappedCallback)
+                                                         CappedCallback* cappedCallback,
+                                                         AtomicInt64* memoryUsage)
     : RecordStore(ns),
       _isCapped(isCapped),
       _cappedMaxSize(cappedMaxSize),
       _cappedMaxDocs(cappedMaxDocs),
       _cappedCallback(cappedCallback),
       _data(*dataInOut ? static_cast<Data*>(dataInOut->get())
-                       : new Data(ns, NamespaceString::oplog(ns))) {
+                       : new Data(ns, NamespaceString::oplog(ns), memoryUsage)) {
     if (!*dataInOut) {
         dataInOut->reset(_data);  // takes ownership
     }
@@ -347,7 +352,7 @@ void EphemeralForTestRecordStore::deleteRecord_inlock(OperationContext* opCtx,
                                                       const RecordId& loc) {
     EphemeralForTestRecord* rec = recordFor(loc);
     opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *rec));
-    _data->dataSize -= rec->size;
+    _data->adjustDataSize(-rec->size);
     invariant(_data->records.erase(loc) == 1);
 }
 
@@ -379,6 +384,23 @@ void EphemeralForTestRecordStore::cappedDeleteAsNeeded_inlock(OperationContext*
     }
 }
 
+Status EphemeralForTestRecordStore::checkMemoryLimit(int64_t bytesToAdd) const {
+    const long long maxDataSizeMB = ephemeralForTestMaxDataSizeMB.load();
+    if (_isCapped || !_data->memoryUsage || maxDataSizeMB <= 0 || bytesToAdd <= 0) {
+        return Status::OK();
+    }
+
+    const int64_t maxDataSizeBytes = maxDataSizeMB * 1024 * 1024;
+    if (_data->memoryUsage->load() + bytesToAdd > maxDataSizeBytes) {
+        return Status(ErrorCodes::ExceededMemoryLimit,
+                      str::stream() << "Writing " << bytesToAdd << " bytes to " << ns()
+                                    << " would exceed the in-memory data limit of "
+                                    << maxDataSizeMB
+                                    << "MB set by ephemeralForTestMaxDataSizeMB");
+    }
+    return Status::OK();
+}
+
 StatusWith<RecordId> EphemeralForTestRecordStore::extractAndCheckLocForOplog(const char* data,
                                                                              int len) const {
     StatusWith<RecordId> status = oploghack::extractKey(data, len);
@@ -405,6 +427,11 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(
         return StatusWith<RecordId>(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
     }
 
+    Status memoryStatus = checkMemoryLimit(len);
+    if (!memoryStatus.isOK()) {
+        return memoryStatus;
+    }
+
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
     EphemeralForTestRecord rec(len);
     memcpy(rec.data.get(), data, len);
@@ -420,7 +447,7 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(
     }
 
     opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
-    _data->dataSize += len;
+    _data->adjustDataSize(len);
     _data->records[loc] = rec;
 
     cappedDeleteAsNeeded_inlock(opCtx);
@@ -443,6 +470,11 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
             return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
         }
 
+        Status memoryStatus = checkMemoryLimit(len);
+        if (!memoryStatus.isOK()) {
+            return memoryStatus;
+        }
+
         EphemeralForTestRecord rec(len);
         docs[i]->writeDocument(rec.data.get());
 
@@ -457,7 +489,7 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
         }
 
         opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
-        _data->dataSize += len;
+        _data->adjustDataSize(len);
         _data->records[loc] = rec;
 
         cappedDeleteAsNeeded_inlock(opCtx);
@@ -482,6 +514,11 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* opCtx,
     // Documents in capped collections cannot change size. We check that above the storage layer.
     invariant(!_isCapped || len == oldLen);
 
+    Status memoryStatus = checkMemoryLimit(len - oldLen);
+    if (!memoryStatus.isOK()) {
+        return memoryStatus;
+    }
+
     if (notifier) {
         // The in-memory KV engine uses the invalidation framework (does not support
         // doc-locking), and therefore must notify that it is updating a document.
@@ -495,7 +532,7 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* opCtx,
     memcpy(newRecord.data.get(), data, len);
 
     opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
-    _data->dataSize += len - oldLen;
+    _data->adjustDataSize(len - oldLen);
     *oldRecord = newRecord;
 
     cappedDeleteAsNeeded_inlock(opCtx);
@@ -569,7 +606,7 @@ void EphemeralForTestRecordStore::cappedTruncateAfter(OperationContext* opCtx,
         }
 
         opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, id, record));
-        _data->dataSize -= record.size;
+        _data->adjustDataSize(-record.size);
         _data->records.erase(it++);
     }
 }
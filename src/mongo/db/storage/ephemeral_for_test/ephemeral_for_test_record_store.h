@@ -36,14 +36,22 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
+// The most megabytes of record data the ephemeralForTest engine may hold outside of capped
+// collections. Zero means unlimited.
+extern AtomicInt64 ephemeralForTestMaxDataSizeMB;
+
 /**
  * A RecordStore that stores all data in-memory.
  *
  * @param cappedMaxSize - required if isCapped. limit uses dataSize() in this impl.
+ * @param memoryUsage - if not null, the count of record bytes held by every record store of the
+ *                      engine, which inserts and updates of non-capped records keep within the
+ *                      ephemeralForTestMaxDataSizeMB server parameter.
  */
 class EphemeralForTestRecordStore : public RecordStore {
 public:
@@ -52,7 +60,8 @@ public:
                                          bool isCapped = false,
                                          int64_t cappedMaxSize = -1,
                                          int64_t cappedMaxDocs = -1,
-                                         CappedCallback* cappedCallback = nullptr);
+                                         CappedCallback* cappedCallback = nullptr,
+                                         AtomicInt64* memoryUsage = nullptr);
 
     virtual const char* name() const;
 
@@ -128,7 +137,7 @@ public:
                                         long long numRecords,
                                         long long dataSize) {
         invariant(_data->records.size() == size_t(numRecords));
-        _data->dataSize = dataSize;
+        _data->adjustDataSize(dataSize - _data->dataSize);
     }
 
 protected:
@@ -172,6 +181,13 @@ private:
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
 
     RecordId allocateLoc();
+
+    /**
+     * Returns ExceededMemoryLimit if adding 'bytesToAdd' bytes of record data would take the
+     * engine past its limit.
+     */
+    Status checkMemoryLimit(int64_t bytesToAdd) const;
+
     bool cappedAndNeedDelete_inlock(OperationContext* opCtx) const;
     void cappedDeleteAsNeeded_inlock(OperationContext* opCtx);
     void deleteRecord_inlock(OperationContext* opCtx, const RecordId& dl);
@@ -184,14 +200,29 @@ private:
 
     // This is the "persistent" data.
     struct Data {
-        Data(StringData ns, bool isOplog)
-            : dataSize(0), recordsMutex(), nextId(1), isOplog(isOplog) {}
+        Data(StringData ns, bool isOplog, AtomicInt64* memoryUsage)
+            : dataSize(0), recordsMutex(), nextId(1), isOplog(isOplog), memoryUsage(memoryUsage) {}
+
+        ~Data() {
+            adjustDataSize(-dataSize);
+        }
+
+        /**
+         * Changes 'dataSize' by 'delta', and the engine's memory usage along with it.
+         */
+        void adjustDataSize(int64_t delta) {
+            dataSize += delta;
+            if (memoryUsage) {
+                memoryUsage->fetchAndAdd(delta);
+            }
+        }
 
         int64_t dataSize;
         stdx::recursive_mutex recordsMutex;
         Records records;
         int64_t nextId;
         const bool isOplog;
+        AtomicInt64* const memoryUsage;
     };
 
     Data* const _data;
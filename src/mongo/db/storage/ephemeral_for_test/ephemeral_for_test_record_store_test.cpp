@@ -37,6 +37,7 @@
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -84,5 +85,66 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+TEST(EphemeralForTestRecordStoreTest, InsertsAndUpdatesStayWithinMemoryLimit) {
+    const long long oldMaxDataSizeMB = ephemeralForTestMaxDataSizeMB.load();
+    ephemeralForTestMaxDataSizeMB.store(1);
+    ON_BLOCK_EXIT([&] { ephemeralForTestMaxDataSizeMB.store(oldMaxDataSizeMB); });
+
+    EphemeralForTestHarnessHelper harnessHelper;
+    AtomicInt64 memoryUsage;
+    std::shared_ptr<void> otherData;
+    auto rs = stdx::make_unique<EphemeralForTestRecordStore>(
+        "a.b", &harnessHelper.data, false, -1, -1, nullptr, &memoryUsage);
+    auto otherRs = stdx::make_unique<EphemeralForTestRecordStore>(
+        "a.c", &otherData, false, -1, -1, nullptr, &memoryUsage);
+    auto opCtx = harnessHelper.newOperationContext();
+
+    const std::string record(600 * 1024, 'x');
+    RecordId loc;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), record.c_str(), record.size(), Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+    ASSERT_EQ(static_cast<long long>(record.size()), memoryUsage.load());
+
+    // The limit applies across all record stores sharing the memory usage.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res =
+            otherRs->insertRecord(opCtx.get(), record.c_str(), record.size(), Timestamp(), false);
+        ASSERT_EQ(ErrorCodes::ExceededMemoryLimit, res.getStatus());
+    }
+
+    // Growing a record past the limit fails, while shrinking it does not.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        const std::string bigger(record.size() * 2, 'x');
+        ASSERT_EQ(
+            ErrorCodes::ExceededMemoryLimit,
+            rs->updateRecord(opCtx.get(), loc, bigger.c_str(), bigger.size(), false, nullptr));
+        ASSERT_OK(rs->updateRecord(opCtx.get(), loc, "y", 1, false, nullptr));
+        uow.commit();
+    }
+    ASSERT_EQ(1, memoryUsage.load());
+
+    // Rolled back writes release their memory.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(
+            otherRs->insertRecord(opCtx.get(), record.c_str(), record.size(), Timestamp(), false)
+                .getStatus());
+        ASSERT_EQ(static_cast<long long>(record.size()) + 1, memoryUsage.load());
+    }
+    ASSERT_EQ(1, memoryUsage.load());
+
+    // Dropping the data releases its memory.
+    rs.reset();
+    harnessHelper.data.reset();
+    ASSERT_EQ(0, memoryUsage.load());
+}
 }  // namespace
 }  // namespace mongo
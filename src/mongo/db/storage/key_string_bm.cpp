@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+void encodeKey(unittest::BenchmarkState& state, const BSONObj& key) {
+    KeyString ks(KeyString::Version::V1);
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kAllAscending, RecordId(42));
+        unittest::doNotOptimizeAway(ks.getBuffer());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void decodeKey(unittest::BenchmarkState& state, const BSONObj& key) {
+    KeyString ks(KeyString::Version::V1, key, kAllAscending);
+    while (state.keepRunning()) {
+        auto decoded =
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits());
+        unittest::doNotOptimizeAway(decoded);
+    }
+    state.setBytesProcessed(state.iterations() * ks.getSize());
+}
+
+const BSONObj kIntKey = BSON("" << 123456);
+const BSONObj kDoubleKey = BSON("" << 1234.5678);
+const BSONObj kStringKey = BSON(""
+                                << "the quick brown fox jumps over the lazy dog");
+const BSONObj kCompoundKey = BSON("" << 1 << ""
+                                     << "abcdef"
+                                     << ""
+                                     << 3.14
+                                     << ""
+                                     << OID("5a0b8b0d2a9e1f0001234567"));
+
+MONGO_BENCHMARK(KeyStringEncodeInt) {
+    encodeKey(state, kIntKey);
+}
+
+MONGO_BENCHMARK(KeyStringEncodeDouble) {
+    encodeKey(state, kDoubleKey);
+}
+
+MONGO_BENCHMARK(KeyStringEncodeString) {
+    encodeKey(state, kStringKey);
+}
+
+MONGO_BENCHMARK(KeyStringEncodeCompound) {
+    encodeKey(state, kCompoundKey);
+}
+
+MONGO_BENCHMARK(KeyStringDecodeInt) {
+    decodeKey(state, kIntKey);
+}
+
+MONGO_BENCHMARK(KeyStringDecodeString) {
+    decodeKey(state, kStringKey);
+}
+
+MONGO_BENCHMARK(KeyStringDecodeCompound) {
+    decodeKey(state, kCompoundKey);
+}
+
+MONGO_BENCHMARK(KeyStringCompare) {
+    KeyString a(KeyString::Version::V1, kCompoundKey, kAllAscending, RecordId(1));
+    KeyString b(KeyString::Version::V1, kCompoundKey, kAllAscending, RecordId(2));
+    while (state.keepRunning()) {
+        unittest::doNotOptimizeAway(a.compare(b));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -1161,6 +1161,36 @@ TEST_F(KeyStringTest, RecordIds) {
     }
 }
 
+TEST_F(KeyStringTest, RecordIdSuffixSizeGrowsWithRecordId) {
+    // Index entries carry a RecordId suffix, so small RecordIds must only cost a couple of bytes.
+    const BSONObj key = BSON("" << 1 << "" << "abc");
+    const size_t keySize = KeyString(version, key, ALL_ASCENDING).getSize();
+
+    ASSERT_EQ(KeyString(version, key, ALL_ASCENDING, RecordId(1)).getSize(), keySize + 2);
+    ASSERT_EQ(KeyString(version, key, ALL_ASCENDING, RecordId(1023)).getSize(), keySize + 2);
+    ASSERT_EQ(KeyString(version, key, ALL_ASCENDING, RecordId(1024)).getSize(), keySize + 3);
+    ASSERT_EQ(KeyString(version, key, ALL_ASCENDING, RecordId(1 << 18)).getSize(), keySize + 4);
+    ASSERT_EQ(KeyString(version, key, ALL_ASCENDING, RecordId::max()).getSize(), keySize + 9);
+}
+
+TEST_F(KeyStringTest, CommonHomogeneousKeysNeedNoTypeBits) {
+    // Keys made up only of these types are stored without a TypeBits value in the index.
+    const BSONObj keys[] = {
+        BSON("" << 1 << "" << 2),
+        BSON("" << "a" << "" << "b"),
+        BSON("" << OID() << "" << Date_t::fromMillisSinceEpoch(1)),
+        BSON("" << true << "" << BSONNULL),
+        BSON("" << BSON("a" << 1) << "" << BSON_ARRAY("x" << 3)),
+    };
+    for (auto&& key : keys) {
+        ASSERT(KeyString(version, key, ALL_ASCENDING).getTypeBits().isAllZeros()) << key;
+    }
+
+    // Types which collate equal to a more common type need TypeBits to round trip.
+    ASSERT_FALSE(KeyString(version, BSON("" << 1LL), ALL_ASCENDING).getTypeBits().isAllZeros());
+    ASSERT_FALSE(KeyString(version, BSON("" << 1.5), ALL_ASCENDING).getTypeBits().isAllZeros());
+}
+
 namespace {
 const uint64_t kMinPerfMicros = 20 * 1000;
 const uint64_t kMinPerfSamples = 50 * 1000;
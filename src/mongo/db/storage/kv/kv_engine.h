@@ -273,6 +273,13 @@ public:
      */
     virtual void replicationBatchIsComplete() const {};
 
+    /**
+     * See `StorageEngine::appendIdentCacheStats()`
+     */
+    virtual void appendIdentCacheStats(OperationContext* opCtx,
+                                       size_t topN,
+                                       BSONObjBuilder* builder) const {}
+
     /**
      * The destructor will never be called from mongod, but may be called from tests.
      * Engines may assume that this will only be called in the case of clean shutdown, even if
@@ -31,10 +31,17 @@
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 
 #include <algorithm>
+#include <exception>
+#include <map>
+#include <vector>
 
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -46,6 +53,9 @@ using std::vector;
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
+
+// The number of threads opening the collections of different databases at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(storageCatalogLoadThreads, int, 1);
 }
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
@@ -113,7 +123,9 @@ KVStorageEngine::KVStorageEngine(
     std::vector<std::string> collections;
     _catalog->getAllCollections(&collections);
 
-    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    // Collections of the same database are opened by one thread, as a database catalog entry
+    // is not safe to initialize concurrently.
+    std::map<KVDatabaseCatalogEntryBase*, std::vector<std::string>> collectionsByDb;
     for (size_t i = 0; i < collections.size(); i++) {
         std::string coll = collections[i];
         NamespaceString nss(coll);
@@ -124,10 +136,55 @@ KVStorageEngine::KVStorageEngine(
         if (!db) {
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
+        collectionsByDb[db].push_back(coll);
+    }
+    std::vector<std::pair<KVDatabaseCatalogEntryBase*, std::vector<std::string>>> work(
+        collectionsByDb.begin(), collectionsByDb.end());
+
+    stdx::mutex resultMutex;
+    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::exception_ptr firstError;
+    AtomicWord<size_t> nextDb(0);
+    auto loadCollections = [&] {
+        OperationContextNoop threadOpCtx(_engine->newRecoveryUnit());
+        KVPrefix threadMaxPrefix = KVPrefix::kNotPrefixed;
+        try {
+            for (size_t i = nextDb.fetchAndAdd(1); i < work.size(); i = nextDb.fetchAndAdd(1)) {
+                for (const auto& coll : work[i].second) {
+                    work[i].first->initCollection(&threadOpCtx, coll, options.forRepair);
+                    auto maxPrefixForCollection =
+                        _catalog->getMetaData(&threadOpCtx, coll).getMaxPrefix();
+                    threadMaxPrefix = std::max(threadMaxPrefix, maxPrefixForCollection);
+                }
+            }
+        } catch (...) {
+            stdx::lock_guard<stdx::mutex> lk(resultMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+        threadOpCtx.recoveryUnit()->abandonSnapshot();
+
+        stdx::lock_guard<stdx::mutex> lk(resultMutex);
+        maxSeenPrefix = std::max(maxSeenPrefix, threadMaxPrefix);
+    };
 
-        db->initCollection(&opCtx, coll, options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(&opCtx, coll).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
+    const size_t numThreads =
+        std::min(static_cast<size_t>(std::max(storageCatalogLoadThreads, 1)), work.size());
+    if (numThreads > 1) {
+        log() << "Opening " << collections.size() << " collections in " << work.size()
+              << " databases on " << numThreads << " threads";
+    }
+    std::vector<stdx::thread> threads;
+    for (size_t i = 1; i < numThreads; i++) {
+        threads.emplace_back(loadCollections);
+    }
+    loadCollections();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
     }
 
     KVPrefix::setLargestPrefix(maxSeenPrefix);
@@ -383,4 +440,10 @@ bool KVStorageEngine::supportsRecoverToStableTimestamp() const {
 void KVStorageEngine::replicationBatchIsComplete() const {
     return _engine->replicationBatchIsComplete();
 }
+
+void KVStorageEngine::appendIdentCacheStats(OperationContext* opCtx,
+                                            size_t topN,
+                                            BSONObjBuilder* builder) const {
+    _engine->appendIdentCacheStats(opCtx, topN, builder);
+}
 }  // namespace mongo
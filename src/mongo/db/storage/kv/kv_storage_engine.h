@@ -123,6 +123,10 @@ public:
 
     virtual void replicationBatchIsComplete() const override;
 
+    virtual void appendIdentCacheStats(OperationContext* opCtx,
+                                       size_t topN,
+                                       BSONObjBuilder* builder) const override;
+
     SnapshotManager* getSnapshotManager() const final;
 
     void setJournalListener(JournalListener* jl) final;
@@ -331,6 +331,8 @@ Status RecordStoreV1Base::insertRecordsWithDocWriter(OperationContext* opCtx,
 
         _details->incrementStats(opCtx, r->netLength(), 1);
 
+        onInsertedRecord(opCtx, r, loc.getValue());
+
         if (idsOut)
             idsOut[i] = loc.getValue().toRecordId();
     }
@@ -376,6 +378,8 @@ StatusWith<RecordId> RecordStoreV1Base::_insertRecord(OperationContext* opCtx,
 
     _details->incrementStats(opCtx, r->netLength(), 1);
 
+    onInsertedRecord(opCtx, r, loc.getValue());
+
     return StatusWith<RecordId>(loc.getValue().toRecordId());
 }
 
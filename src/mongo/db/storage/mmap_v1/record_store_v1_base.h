@@ -278,6 +278,13 @@ protected:
     // TODO: document, remove, what have you
     virtual void addDeletedRec(OperationContext* opCtx, const DiskLoc& dloc) = 0;
 
+    /**
+     * Called after the record at 'loc' has been written and linked into its extent by an insert.
+     */
+    virtual void onInsertedRecord(OperationContext* opCtx,
+                                  const MmapV1RecordHeader* r,
+                                  const DiskLoc& loc) {}
+
     // TODO: another sad one
     virtual DeletedRecord* drec(const DiskLoc& loc) const;
 
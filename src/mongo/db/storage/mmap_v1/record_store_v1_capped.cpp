@@ -33,12 +33,14 @@
 #include "mongo/db/storage/mmap_v1/record_store_v1_capped.h"
 
 #include "mongo/db/client.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/mmap_v1/extent.h"
 #include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage/mmap_v1/record.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_capped_iterator.h"
+#include "mongo/db/storage/oplog_hack.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -74,7 +76,9 @@ CappedRecordStoreV1::CappedRecordStoreV1(OperationContext* opCtx,
                                          RecordStoreV1MetaData* details,
                                          ExtentManager* em,
                                          bool isSystemIndexes)
-    : RecordStoreV1Base(ns, details, em, isSystemIndexes), _cappedCallback(collection) {
+    : RecordStoreV1Base(ns, details, em, isSystemIndexes),
+      _cappedCallback(collection),
+      _isOplog(NamespaceString::oplog(ns)) {
     DiskLoc extentLoc = details->firstExtent(opCtx);
     while (!extentLoc.isNull()) {
         _extentAdvice.push_back(_extentManager->cacheHint(extentLoc, ExtentManager::Sequential));
@@ -84,6 +88,10 @@ CappedRecordStoreV1::CappedRecordStoreV1(OperationContext* opCtx,
 
     // this is for VERY VERY old versions of capped collections
     cappedCheckMigrate(opCtx);
+
+    if (_isOplog) {
+        _sampleExtentsForOplogStart(opCtx);
+    }
 }
 
 CappedRecordStoreV1::~CappedRecordStoreV1() {}
@@ -173,6 +181,7 @@ StatusWith<DiskLoc> CappedRecordStoreV1::allocRecord(OperationContext* opCtx,
             Status status = _cappedCallback->aboutToDeleteCapped(opCtx, fr, dataFor(opCtx, fr));
             if (!status.isOK())
                 return StatusWith<DiskLoc>(status);
+            _removeOplogStartSample(theCapExtent()->firstRecord);
             deleteRecord(opCtx, fr);
 
             _compact(opCtx);
@@ -221,6 +230,8 @@ StatusWith<DiskLoc> CappedRecordStoreV1::allocRecord(OperationContext* opCtx,
 }
 
 Status CappedRecordStoreV1::truncate(OperationContext* opCtx) {
+    _clearOplogStartSamples();
+
     setLastDelRecLastExtent(opCtx, DiskLoc());
     setListOfAllDeletedRecords(opCtx, DiskLoc());
 
@@ -254,9 +265,102 @@ Status CappedRecordStoreV1::truncate(OperationContext* opCtx) {
 void CappedRecordStoreV1::cappedTruncateAfter(OperationContext* opCtx,
                                               RecordId end,
                                               bool inclusive) {
+    // Samples of the truncated entries would point at deleted records. Only the samples which are
+    // still valid could be kept, but truncation is rare enough to start over instead.
+    _clearOplogStartSamples();
     cappedTruncateAfter(opCtx, _ns.c_str(), DiskLoc::fromRecordId(end), inclusive);
 }
 
+/**
+ * Adds a sample to the oplog start index once the insert of its record commits.
+ */
+class CappedRecordStoreV1::OplogStartSampleInsertion final : public RecoveryUnit::Change {
+public:
+    OplogStartSampleInsertion(CappedRecordStoreV1* rs, RecordId key, DiskLoc loc)
+        : _rs(rs), _key(key), _loc(loc) {}
+
+    void commit() final {
+        stdx::lock_guard<stdx::mutex> lk(_rs->_oplogStartSamplesMutex);
+        _rs->_oplogStartSamples[_key] = _loc;
+    }
+
+    void rollback() final {}
+
+private:
+    CappedRecordStoreV1* const _rs;
+    const RecordId _key;
+    const DiskLoc _loc;
+};
+
+void CappedRecordStoreV1::onInsertedRecord(OperationContext* opCtx,
+                                           const MmapV1RecordHeader* r,
+                                           const DiskLoc& loc) {
+    if (!_isOplog) {
+        return;
+    }
+
+    // Sample the first entry after every kOplogStartSampleIntervalBytes of inserts.
+    _bytesSinceOplogStartSample += r->netLength();
+    if (_bytesSinceOplogStartSample < kOplogStartSampleIntervalBytes) {
+        return;
+    }
+    auto key = oploghack::extractKey(r->data(), r->netLength());
+    if (!key.isOK()) {
+        return;
+    }
+    _bytesSinceOplogStartSample = 0;
+    opCtx->recoveryUnit()->registerChange(
+        new OplogStartSampleInsertion(this, key.getValue(), loc));
+}
+
+void CappedRecordStoreV1::_sampleExtentsForOplogStart(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_oplogStartSamplesMutex);
+    const Extent* ext;
+    for (DiskLoc extLoc = _details->firstExtent(opCtx); !extLoc.isNull(); extLoc = ext->xnext) {
+        ext = _getExtent(opCtx, extLoc);
+        if (ext->firstRecord.isNull()) {
+            continue;
+        }
+        const MmapV1RecordHeader* r = recordFor(ext->firstRecord);
+        auto key = oploghack::extractKey(r->data(), r->netLength());
+        if (key.isOK()) {
+            _oplogStartSamples[key.getValue()] = ext->firstRecord;
+        }
+    }
+}
+
+void CappedRecordStoreV1::_removeOplogStartSample(const DiskLoc& loc) {
+    if (!_isOplog) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_oplogStartSamplesMutex);
+    if (!_oplogStartSamples.empty() && _oplogStartSamples.begin()->second == loc) {
+        _oplogStartSamples.erase(_oplogStartSamples.begin());
+    }
+}
+
+void CappedRecordStoreV1::_clearOplogStartSamples() {
+    stdx::lock_guard<stdx::mutex> lk(_oplogStartSamplesMutex);
+    _oplogStartSamples.clear();
+    _bytesSinceOplogStartSample = 0;
+}
+
+boost::optional<RecordId> CappedRecordStoreV1::oplogStartHack(
+    OperationContext* opCtx, const RecordId& startingPosition) const {
+    if (!_isOplog) {
+        return boost::none;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_oplogStartSamplesMutex);
+    auto it = _oplogStartSamples.upper_bound(startingPosition);
+    if (it == _oplogStartSamples.begin()) {
+        // The oldest entries may not have been sampled, so let the caller search for the start.
+        return boost::none;
+    }
+    --it;
+    return it->second.toRecordId();
+}
+
 /* combine adjacent deleted records *for the current extent* of the capped collection
 
    this is O(n^2) but we call it for capped tables where typically n==1 or 2!
@@ -30,11 +30,14 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/mmap_v1/diskloc.h"
 #include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_base.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -68,6 +71,14 @@ public:
 
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* opCtx) const final;
 
+    /**
+     * Returns the sampled oplog entry with the latest timestamp at or before 'startingPosition',
+     * which is at most kOplogStartSampleIntervalBytes of records before the exact one. Returns
+     * boost::none if this is not the oplog or no such entry has been sampled.
+     */
+    boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
+                                             const RecordId& startingPosition) const final;
+
     // Start from firstExtent by default.
     DiskLoc firstRecord(OperationContext* opCtx, const DiskLoc& startExtent = DiskLoc()) const;
     // Start from lastExtent by default.
@@ -91,7 +102,30 @@ protected:
 
     void addDeletedRec(OperationContext* opCtx, const DiskLoc& dloc) final;
 
+    void onInsertedRecord(OperationContext* opCtx,
+                          const MmapV1RecordHeader* r,
+                          const DiskLoc& loc) final;
+
 private:
+    class OplogStartSampleInsertion;
+
+    // How many bytes of oplog entries are inserted between two samples.
+    static const long long kOplogStartSampleIntervalBytes = 1024 * 1024;
+
+    /**
+     * Samples the first record of every extent, so that oplogStartHack() can seek into the entries
+     * which were inserted before this record store was opened.
+     */
+    void _sampleExtentsForOplogStart(OperationContext* opCtx);
+
+    /**
+     * Forgets the sample at 'loc', if there is one, because its record is about to be deleted.
+     * Capped deletes remove the oldest record, so only the oldest sample is checked.
+     */
+    void _removeOplogStartSample(const DiskLoc& loc);
+
+    void _clearOplogStartSamples();
+
     // -- start copy from cap.cpp --
     void _compact(OperationContext* opCtx);
     DiskLoc cappedFirstDeletedInCurExtent() const;
@@ -124,6 +158,14 @@ private:
 
     OwnedPointerVector<ExtentManager::CacheHint> _extentAdvice;
 
+    const bool _isOplog;
+
+    // A sparse index from the oplog hack keys of sampled oplog entries to their locations. It is
+    // only kept in memory, and is only maintained for the oplog.
+    mutable stdx::mutex _oplogStartSamplesMutex;
+    std::map<RecordId, DiskLoc> _oplogStartSamples;
+    long long _bytesSinceOplogStartSample = 0;
+
     friend class CappedRecordStoreV1Iterator;
 };
 }
@@ -591,6 +591,16 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const = 0;
 
+    /**
+     * Appends the storage engine's cache residency and I/O counters for this RecordStore. Unlike
+     * appendCustomStats(), this must be cheap enough to call periodically.
+     *
+     * Returns true if stats were appended.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const {
+        return false;
+    }
+
     /**
      * Load all data into cache.
      * What cache depends on implementation.
@@ -608,6 +618,8 @@ public:
     /**
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
+     * Implementations which only keep a sample of the oplog's entries may return an earlier entry,
+     * since scanning forwards from it still finds the starting point.
      *
      * If you don't implement the oplogStartHack, just use the default implementation which
      * returns boost::none.
@@ -148,6 +148,16 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends the storage engine's cache residency and I/O counters for this index. Unlike
+     * appendCustomStats(), this must be cheap enough to call periodically.
+     *
+     * Returns true if stats were appended.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+        return false;
+    }
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
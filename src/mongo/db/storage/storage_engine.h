@@ -40,6 +40,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class DatabaseCatalogEntry;
 class JournalListener;
 class OperationContext;
@@ -343,6 +344,15 @@ public:
      */
     virtual void replicationBatchIsComplete() const {};
 
+    /**
+     * Appends to "builder" one sub-document per ident, keyed by ident, holding the cache
+     * residency and I/O counters of the "topN" idents which occupy the most storage engine cache.
+     * Engines without such statistics append nothing.
+     */
+    virtual void appendIdentCacheStats(OperationContext* opCtx,
+                                       size_t topN,
+                                       BSONObjBuilder* builder) const {}
+
     // (CollectionName, IndexName)
     typedef std::pair<std::string, std::string> CollectionIndexNamePair;
 
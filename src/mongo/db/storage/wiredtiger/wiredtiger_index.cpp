@@ -49,6 +49,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
@@ -390,6 +391,11 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
     return true;
 }
 
+bool WiredTigerIndex::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    return WiredTigerUtil::appendCacheStats(s, uri(), output).isOK();
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx,
                                     const BSONObj& key,
                                     const RecordId& id) {
@@ -98,6 +98,7 @@ public:
     virtual bool appendCustomStats(OperationContext* opCtx,
                                    BSONObjBuilder* output,
                                    double scale) const;
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const override;
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& id);
 
     virtual bool isEmpty(OperationContext* opCtx);
@@ -37,6 +37,7 @@
 #define NVALGRIND
 #endif
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
@@ -267,10 +268,12 @@ class TicketServerParameter : public ServerParameter {
 
 public:
     TicketServerParameter(TicketHolder* holder, const std::string& name)
-        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true), _holder(holder) {}
+        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true),
+          _holder(holder),
+          _configured(holder->outof()) {}
 
     virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
-        b.append(name, _holder->outof());
+        b.append(name, _configured.load());
     }
 
     virtual Status set(const BSONElement& newValueElement) {
@@ -292,11 +295,24 @@ public:
             return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be > 0");
         }
 
-        return _holder->resize(newNum);
+        Status status = _holder->resize(newNum);
+        if (status.isOK()) {
+            _configured.store(newNum);
+        }
+        return status;
+    }
+
+    /**
+     * The value most recently set by the user. When adaptive tickets are enabled the holder may be
+     * running below this, but never above it.
+     */
+    int configured() const {
+        return _configured.load();
     }
 
 private:
     TicketHolder* _holder;
+    AtomicInt32 _configured;
 };
 
 TicketHolder openWriteTransaction(128);
@@ -307,11 +323,158 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, the concurrent transaction limits above become ceilings and a background thread
+// lowers the ticket counts while application threads are being drafted into cache eviction.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactions, bool, false);
+
+// With adaptive concurrent transactions, the number of transaction IDs that open snapshots may keep
+// pinned before the ticket counts are cut as if the cache were under pressure. Slow readers holding
+// old snapshots prevent eviction of the history they can see, so admitting more of them only makes
+// that worse. Zero disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMaxPinnedTransactionRange, long long, 0);
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
+
+stdx::function<bool(StringData)> requestCappedDeleteCallback = [](StringData) -> bool {
+    return false;
+};
 }  // namespace
 
+/**
+ * Adjusts the read and write ticket counts once a second. While application threads are doing
+ * eviction, or open snapshots pin more than wiredTigerMaxPinnedTransactionRange transaction IDs,
+ * the cache cannot keep up with the current concurrency, so both limits are cut by a quarter;
+ * otherwise they grow back by a few tickets at a time until they reach the configured values.
+ */
+class WiredTigerKVEngine::WiredTigerTicketTuner : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTuner(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        boost::optional<int64_t> lastAppEvictions;
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, stdx::chrono::seconds(1));
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            StatusWith<int64_t> appEvictions = Status(ErrorCodes::InternalError, "");
+            bool pinningTooMuchHistory = false;
+            try {
+                UniqueWiredTigerSession session = _sessionCache->getSession();
+                appEvictions = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+                    session->getSession(),
+                    "statistics:",
+                    "statistics=(fast)",
+                    WT_STAT_CONN_CACHE_EVICTION_APP);
+                pinningTooMuchHistory = _isPinningTooMuchHistory(session->getSession());
+            } catch (const AssertionException& e) {
+                invariant(e.code() == ErrorCodes::ShutdownInProgress);
+                break;
+            }
+            if (!appEvictions.isOK()) {
+                continue;
+            }
+
+            const bool underPressure = pinningTooMuchHistory ||
+                (lastAppEvictions && appEvictions.getValue() > *lastAppEvictions);
+            lastAppEvictions = appEvictions.getValue();
+
+            _tune(&openWriteTransaction, openWriteTransactionParam, underPressure);
+            _tune(&openReadTransaction, openReadTransactionParam, underPressure);
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    /**
+     * Returns true if open snapshots, other than a running checkpoint's, pin a wider range of
+     * transaction IDs than wiredTigerMaxPinnedTransactionRange allows.
+     */
+    static bool _isPinningTooMuchHistory(WT_SESSION* session) {
+        const long long maxPinnedRange = wiredTigerMaxPinnedTransactionRange.load();
+        if (maxPinnedRange <= 0) {
+            return false;
+        }
+
+        auto pinnedRange = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            session, "statistics:", "statistics=(fast)", WT_STAT_CONN_TXN_PINNED_RANGE);
+        auto checkpointPinnedRange = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            session, "statistics:", "statistics=(fast)", WT_STAT_CONN_TXN_PINNED_CHECKPOINT_RANGE);
+        if (!pinnedRange.isOK() || !checkpointPinnedRange.isOK()) {
+            return false;
+        }
+
+        // A checkpoint pins history while it runs; that is not something fewer tickets can help.
+        if (pinnedRange.getValue() <= checkpointPinnedRange.getValue() ||
+            pinnedRange.getValue() <= maxPinnedRange) {
+            return false;
+        }
+
+        LOG(1) << "open snapshots pin " << pinnedRange.getValue()
+               << " transaction IDs, more than wiredTigerMaxPinnedTransactionRange ("
+               << maxPinnedRange << ")";
+        return true;
+    }
+
+    static void _tune(TicketHolder* holder,
+                      const TicketServerParameter& param,
+                      bool underPressure) {
+        const int current = holder->outof();
+        const int ceiling = param.configured();
+        // TicketHolder refuses to go below 5 tickets.
+        const int floor = std::min(5, ceiling);
+        const int growthStep = 4;
+
+        int target;
+        if (underPressure) {
+            target = std::max(floor, current - current / 4);
+        } else {
+            target = std::min(ceiling, current + growthStep);
+        }
+        if (target == current) {
+            return;
+        }
+
+        // Shrinking waits for tickets to be returned, so this may block until enough in-flight
+        // operations finish.
+        Status status = holder->resize(target);
+        if (!status.isOK()) {
+            LOG(1) << "unable to resize " << param.name() << " to " << target << ": " << status;
+            return;
+        }
+        LOG(2) << "adjusted " << param.name() << " from " << current << " to " << target;
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -424,6 +587,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _checkpointThread->go();
     }
 
+    if (wiredTigerAdaptiveConcurrentTransactions && !_readOnly) {
+        _ticketTuner = stdx::make_unique<WiredTigerTicketTuner>(_sessionCache.get());
+        _ticketTuner->go();
+    }
+
     _sizeStorerUri = "table:sizeStorer";
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -465,6 +633,8 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.done();
     }
     bb.done();
+
+    WiredTigerSessionCache::appendGlobalStats(b);
 }
 
 void WiredTigerKVEngine::cleanShutdown() {
@@ -473,6 +643,8 @@ void WiredTigerKVEngine::cleanShutdown() {
         syncSizeInfo(true);
     if (_conn) {
         // these must be the last things we do before _conn->close();
+        if (_ticketTuner)
+            _ticketTuner->shutdown();
         if (_journalFlusher)
             _journalFlusher->shutdown();
         if (_checkpointThread)
@@ -957,6 +1129,46 @@ std::vector<std::string> WiredTigerKVEngine::getAllIdents(OperationContext* opCt
     return all;
 }
 
+void WiredTigerKVEngine::appendIdentCacheStats(OperationContext* opCtx,
+                                               size_t topN,
+                                               BSONObjBuilder* builder) const {
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+
+    stdx::lock_guard<stdx::mutex> lk(_identCacheRankingMutex);
+    const Date_t now = _clockSource->now();
+    if (topN != _identCacheRankingTopN || now - _identCacheRankingTime >= Minutes(1)) {
+        std::vector<std::pair<long long, std::string>> ranked;
+        for (auto&& ident : getAllIdents(opCtx)) {
+            auto bytesInCache =
+                WiredTigerUtil::getStatisticsValueAs<long long>(session,
+                                                                "statistics:" + _uri(ident),
+                                                                "statistics=(fast)",
+                                                                WT_STAT_DSRC_CACHE_BYTES_INUSE);
+            if (bytesInCache.isOK()) {
+                ranked.emplace_back(bytesInCache.getValue(), std::move(ident));
+            }
+        }
+
+        const size_t numRanked = std::min(topN, ranked.size());
+        std::partial_sort(ranked.begin(),
+                          ranked.begin() + numRanked,
+                          ranked.end(),
+                          [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+        _identCacheRanking.clear();
+        for (size_t i = 0; i < numRanked; ++i) {
+            _identCacheRanking.push_back(std::move(ranked[i].second));
+        }
+        _identCacheRankingTime = now;
+        _identCacheRankingTopN = topN;
+    }
+
+    for (auto&& ident : _identCacheRanking) {
+        BSONObjBuilder identBuilder(builder->subobjStart(ident));
+        WiredTigerUtil::appendCacheStats(session, _uri(ident), &identBuilder).ignore();
+    }
+}
+
 int WiredTigerKVEngine::reconfigure(const char* str) {
     return _conn->reconfigure(_conn, str);
 }
@@ -996,6 +1208,14 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return initRsOplogBackgroundThreadCallback(ns);
 }
 
+void WiredTigerKVEngine::setRequestCappedDeleteCallback(stdx::function<bool(StringData)> cb) {
+    requestCappedDeleteCallback = std::move(cb);
+}
+
+bool WiredTigerKVEngine::requestCappedDelete(StringData ns) {
+    return requestCappedDeleteCallback(ns);
+}
+
 void WiredTigerKVEngine::setOldestTimestamp(Timestamp oldestTimestamp) {
     invariant(oldestTimestamp != Timestamp::min());
 
@@ -155,6 +155,15 @@ public:
 
     std::vector<std::string> getAllIdents(OperationContext* opCtx) const;
 
+    /**
+     * Appends cache statistics for the 'topN' idents with the most bytes in the cache. The ranking
+     * visits every ident, so it is only refreshed once a minute; in between, the statistics of the
+     * previously ranked idents are reported.
+     */
+    void appendIdentCacheStats(OperationContext* opCtx,
+                               size_t topN,
+                               BSONObjBuilder* builder) const override;
+
     virtual void cleanShutdown();
 
     SnapshotManager* getSnapshotManager() const final {
@@ -239,11 +248,25 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Sets the implementation for `requestCappedDelete`. Intended to be called from a
+     * MONGO_INITIALIZER, or by tests, in a single threaded context.
+     */
+    static void setRequestCappedDeleteCallback(stdx::function<bool(StringData)> cb);
+
+    /**
+     * Asks the background capped deleter to truncate the capped collection 'ns' back within its
+     * size. Returns false if there is no background deleter, in which case the caller must delete
+     * inline.
+     */
+    static bool requestCappedDelete(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketTuner;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -282,6 +305,7 @@ private:
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketTuner> _ticketTuner;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -292,6 +316,12 @@ private:
 
     mutable Date_t _previousCheckedDropsQueued;
 
+    // Protects the idents last ranked by appendIdentCacheStats().
+    mutable stdx::mutex _identCacheRankingMutex;
+    mutable std::vector<std::string> _identCacheRanking;
+    mutable Date_t _identCacheRankingTime;
+    mutable size_t _identCacheRankingTopN = 0;
+
     std::unique_ptr<WiredTigerSession> _backupSession;
 };
 }
@@ -38,12 +38,14 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -62,6 +64,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -82,8 +85,20 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// getManyCursors() splits a scan into roughly one range cursor per this many records, up to
+// kMaxParallelScanPartitions cursors.
+const long long kRecordsPerParallelScanPartition = 1000;
+const long long kMaxParallelScanPartitions = 256;
+
+// When positive, reclaimOplog truncates the oldest stone in ranges of at most this many records,
+// each in its own transaction, rather than all at once. This bounds the amount of work, and the
+// cache pressure, of a single truncation.
+MONGO_EXPORT_SERVER_PARAMETER(oplogTruncateMaxRecordsPerBatch, int, 0);
 }  // namespace
 
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerCappedDeleteInBackground, bool, false);
+
 MONGO_FP_DECLARE(WTWriteConflictException);
 MONGO_FP_DECLARE(WTWriteConflictExceptionForReads);
 
@@ -154,7 +169,11 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
+    Timer timer;
     _calculateStones(opCtx, numStonesToKeep);
+    _totalTimeProcessing = Microseconds(timer.micros());
+    log() << "Placed " << _stones.size() << " oplog stones by " << _processingMethod << " in "
+          << durationCount<Milliseconds>(_totalTimeProcessing) << "ms";
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -202,6 +221,26 @@ void WiredTigerRecordStore::OplogStones::popOldestStone() {
     _stones.pop_front();
 }
 
+void WiredTigerRecordStore::OplogStones::shrinkOldestStone(int64_t records, int64_t bytes) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_stones.empty());
+    // The stone's size is only an estimate, so never let it become negative.
+    Stone& oldest = _stones.front();
+    oldest.records = std::max(int64_t(0), oldest.records - records);
+    oldest.bytes = std::max(int64_t(0), oldest.bytes - bytes);
+}
+
+void WiredTigerRecordStore::OplogStones::getStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("numStones", static_cast<long long>(_stones.size()));
+    builder->append("currentStoneRecords", static_cast<long long>(_currentRecords.load()));
+    builder->append("currentStoneBytes", static_cast<long long>(_currentBytes.load()));
+    builder->append("minBytesPerStone", static_cast<long long>(_minBytesPerStone));
+    builder->append("processingMethod", _processingMethod);
+    builder->append("totalTimeProcessingMicros",
+                    durationCount<Microseconds>(_totalTimeProcessing));
+}
+
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
     stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
     if (!lk) {
@@ -302,6 +341,8 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
         return;
     }
 
+    _processingMethod = "sampling";
+
     // Use the oplog's average record size to estimate the number of records in each stone, and thus
     // estimate the combined size of the records.
     double avgRecordSize = double(dataSize) / double(numRecords);
@@ -313,6 +354,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
 
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* opCtx) {
     log() << "Scanning the oplog to determine where to place markers for truncation";
+    _processingMethod = "scanning";
 
     long long numRecords = 0;
     long long dataSize = 0;
@@ -614,13 +656,15 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
+      _cappedDeleteInBackground(params.isCapped && !_isOplog && params.cappedMaxDocs == -1 &&
+                                wiredTigerCappedDeleteInBackground),
+      _cappedDeleteRequested(false),
       _cappedSleep(0),
       _cappedSleepMS(0),
       _cappedCallback(params.cappedCallback),
       _shuttingDown(false),
       _cappedDeleteCheckCount(0),
       _sizeStorer(params.sizeStorer),
-      _sizeStorerCounter(0),
       _kvEngine(kvEngine) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
                                ctx, _uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
@@ -859,6 +903,20 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    // Leave the truncation to the background capped deleter while the overshoot is tolerable, so
+    // that inserts do not serialize on the deleter mutex. Past that, fall through to deleting
+    // inline with back-pressure.
+    if (_cappedDeleteInBackground &&
+        (_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack)) {
+        // Only the first insert over the cap asks for a truncation, later ones rely on it.
+        if (_cappedDeleteRequested.swap(true) || WiredTigerKVEngine::requestCappedDelete(ns())) {
+            return 0;
+        }
+
+        // There is no background deleter, so delete inline.
+        _cappedDeleteRequested.store(false);
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -1019,6 +1077,23 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* opC
     return docsRemoved;
 }
 
+void WiredTigerRecordStore::cappedDeleteInBackground(OperationContext* opCtx) {
+    invariant(_cappedDeleteInBackground);
+
+    // Clear the request before truncating, so that an insert which goes over the cap again while
+    // this runs asks for another pass.
+    _cappedDeleteRequested.store(false);
+
+    stdx::lock_guard<stdx::timed_mutex> lock(_cappedDeleterMutex);
+    while (cappedAndNeedDelete()) {
+        // Any record allocated so far may be truncated. A record which is not committed yet makes
+        // the truncation conflict, and is left to a later pass.
+        if (cappedDeleteAsNeeded_inlock(opCtx, RecordId(_nextIdNum.load())) == 0) {
+            break;
+        }
+    }
+}
+
 bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx) {
     // Create another reference to the oplog stones while holding a lock on the collection to
     // prevent it from being destructed.
@@ -1059,27 +1134,79 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
         WT_SESSION* session = ru->getSession()->getSession();
 
         try {
+            Timer timer;
             WriteUnitOfWork wuow(opCtx);
 
             WiredTigerCursor startwrap(_uri, _tableId, true, opCtx);
             WT_CURSOR* start = startwrap.get();
             setKey(start, _oplogStones->firstRecord);
 
+            // Unless the stone is small enough, only truncate its first records and leave the
+            // rest of it for the next iteration.
+            RecordId truncateEnd = stone->lastRecord;
+            int64_t recordsRemoved = stone->records;
+            int64_t bytesRemoved = stone->bytes;
+            const int64_t maxRecordsPerBatch = oplogTruncateMaxRecordsPerBatch.load();
+            bool wholeStone = true;
+            if (maxRecordsPerBatch > 0 && stone->records > maxRecordsPerBatch) {
+                WiredTigerCursor scanwrap(_uri, _tableId, true, opCtx);
+                WT_CURSOR* scan = scanwrap.get();
+                setKey(scan, _oplogStones->firstRecord);
+                int cmp;
+                int ret = WT_OP_CHECK(scan->search_near(scan, &cmp));
+                if (ret == 0 && cmp < 0) {
+                    ret = WT_OP_CHECK(scan->next(scan));
+                }
+
+                int64_t records = 0;
+                int64_t bytes = 0;
+                RecordId last;
+                while (ret == 0 && records < maxRecordsPerBatch) {
+                    RecordId id = getKey(scan);
+                    if (id >= stone->lastRecord) {
+                        break;
+                    }
+                    WT_ITEM value;
+                    invariantWTOK(scan->get_value(scan, &value));
+                    ++records;
+                    bytes += value.size;
+                    last = id;
+                    ret = WT_OP_CHECK(scan->next(scan));
+                }
+                if (ret != WT_NOTFOUND) {
+                    invariantWTOK(ret);
+                }
+
+                if (records == maxRecordsPerBatch) {
+                    wholeStone = false;
+                    truncateEnd = last;
+                    recordsRemoved = records;
+                    bytesRemoved = bytes;
+                }
+            }
+
             WiredTigerCursor endwrap(_uri, _tableId, true, opCtx);
             WT_CURSOR* end = endwrap.get();
-            setKey(end, stone->lastRecord);
+            setKey(end, truncateEnd);
 
             invariantWTOK(session->truncate(session, nullptr, start, end, nullptr));
-            _changeNumRecords(opCtx, -stone->records);
-            _increaseDataSize(opCtx, -stone->bytes);
+            _changeNumRecords(opCtx, -recordsRemoved);
+            _increaseDataSize(opCtx, -bytesRemoved);
 
             wuow.commit();
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            if (wholeStone) {
+                // Remove the stone after a successful truncation.
+                _oplogStones->popOldestStone();
+            } else {
+                _oplogStones->shrinkOldestStone(recordsRemoved, bytesRemoved);
+            }
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
-            _oplogStones->firstRecord = stone->lastRecord;
+            _oplogStones->firstRecord = truncateEnd;
+
+            _truncateCount.fetchAndAdd(1);
+            _totalTimeTruncatingMicros.fetchAndAdd(timer.micros());
         } catch (const WriteConflictException&) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
@@ -1089,6 +1216,13 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
            << " records totaling to " << _dataSize.load() << " bytes";
 }
 
+void WiredTigerRecordStore::getOplogTruncateStats(BSONObjBuilder& builder) const {
+    invariant(_oplogStones);
+    _oplogStones->getStats(&builder);
+    builder.append("truncateCount", _truncateCount.load());
+    builder.append("totalTimeTruncatingMicros", _totalTimeTruncatingMicros.load());
+}
+
 Status WiredTigerRecordStore::insertRecords(OperationContext* opCtx,
                                             std::vector<Record>* records,
                                             std::vector<Timestamp>* timestamps,
@@ -1117,6 +1251,9 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
+
+    // Reserve the RecordIds of the whole batch at once rather than one record at a time.
+    const RecordId firstId = _isOplog ? RecordId() : _nextId(nRecords);
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         if (_isOplog) {
@@ -1125,10 +1262,8 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
         } else {
-            record.id = _nextId();
+            record.id = RecordId(firstId.repr() + static_cast<int64_t>(i));
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1319,8 +1454,40 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
 
 std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors(
     OperationContext* opCtx) const {
-    std::vector<std::unique_ptr<RecordCursor>> cursors(1);
-    cursors[0] = getCursor(opCtx, /*forward=*/true);
+    std::vector<std::unique_ptr<RecordCursor>> cursors;
+
+    // Capped collections must be read in insertion order, so they are never partitioned.
+    const long long numPartitions = _isCapped
+        ? 1
+        : std::min(std::max(numRecords(opCtx) / kRecordsPerParallelScanPartition, 1LL),
+                   kMaxParallelScanPartitions);
+    if (numPartitions == 1) {
+        cursors.push_back(getCursor(opCtx, /*forward=*/true));
+        return cursors;
+    }
+
+    // Split the RecordIds between the first and the last record into ranges of equal width. Since
+    // RecordIds are assigned in increasing order on insert, this approximates an even split of
+    // the records themselves.
+    auto first = getCursor(opCtx, /*forward=*/true)->next();
+    auto last = getCursor(opCtx, /*forward=*/false)->next();
+    if (!first || !last || last->id.repr() - first->id.repr() < numPartitions) {
+        cursors.push_back(getCursor(opCtx, /*forward=*/true));
+        return cursors;
+    }
+
+    const int64_t width = (last->id.repr() - first->id.repr()) / numPartitions + 1;
+    for (long long i = 0; i < numPartitions; ++i) {
+        // Leave the outermost ranges unbounded so that concurrent inserts beyond the current
+        // endpoints are not skipped.
+        RecordId start = (i == 0) ? RecordId() : RecordId(first->id.repr() + i * width);
+        RecordId end = (i == numPartitions - 1) ? RecordId()
+                                                : RecordId(first->id.repr() + (i + 1) * width);
+
+        auto cursor = getCursor(opCtx, /*forward=*/true);
+        checked_cast<WiredTigerRecordStoreCursorBase*>(cursor.get())->setRange(start, end);
+        cursors.push_back(std::move(cursor));
+    }
     return cursors;
 }
 
@@ -1354,7 +1521,14 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
+        const std::string config = str::stream()
+            << "timeout=" << (options && options->online ? options->onlineRoundSecs : 0);
+        int ret = s->compact(s, getURI().c_str(), config.c_str());
+        if (ret == ETIMEDOUT || (ret == EBUSY && options && options->online)) {
+            // An online compaction continues in the next round.
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "compaction of " << getURI() << " did not finish");
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -1473,6 +1647,12 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
     }
 }
 
+bool WiredTigerRecordStore::appendCacheStats(OperationContext* opCtx,
+                                             BSONObjBuilder* result) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    return WiredTigerUtil::appendCacheStats(s, getURI(), result).isOK();
+}
+
 Status WiredTigerRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* output) const {
     if (_isEphemeral) {
         // Everything is already in memory.
@@ -1527,10 +1707,19 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+void WiredTigerRecordStore::setSizeStorer(WiredTigerSizeStorer* ss) {
+    _sizeStorer = ss;
+    if (_sizeStorer) {
+        _sizeStorer->onCreate(this, _numRecords.load(), _dataSize.load());
+    }
+}
+
+RecordId WiredTigerRecordStore::_nextId(int64_t count) {
     invariant(!_isOplog);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    invariant(count > 0);
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(count));
     invariant(out.isNormal());
+    invariant(RecordId(out.repr() + count - 1).isNormal());
     return out;
 }
 
@@ -1576,10 +1765,6 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
 
     if (_dataSize.fetchAndAdd(amount) < 0)
         _dataSize.store(std::max(amount, int64_t(0)));
-
-    if (_sizeStorer && _sizeStorerCounter++ % 1000 == 0) {
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
-    }
 }
 
 void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
@@ -1718,6 +1903,11 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         id = getKey(c);
     }
 
+    if (!_rangeEnd.isNull() && id >= _rangeEnd) {
+        _eof = true;
+        return {};
+    }
+
     if (_forward && _lastReturnedId >= id) {
         log() << "WTCursor::next -- c->next_key ( " << id
               << ") was not greater than _lastReturnedId (" << _lastReturnedId
@@ -1830,6 +2020,24 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     return true;
 }
 
+void WiredTigerRecordStoreCursorBase::setRange(const RecordId& start, const RecordId& end) {
+    invariant(_forward);
+    invariant(!_rs._isCapped);
+    invariant(_lastReturnedId.isNull());
+
+    _rangeEnd = end;
+    if (start.isNull()) {
+        return;
+    }
+
+    // Pretend that we have already returned the record just before 'start'. Restoring will then
+    // position the cursor so that the next call to next() returns the first record in range, and
+    // a save and restore before that point will do the same.
+    _lastReturnedId = RecordId(start.repr() - 1);
+    save();
+    restore();
+}
+
 void WiredTigerRecordStoreCursorBase::detachFromOperationContext() {
     _opCtx = nullptr;
     _cursor = boost::none;
@@ -68,6 +68,11 @@ class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
 
+// When true, capped collections other than the oplog which have no maximum document count leave
+// their truncation to a background deleter, and inserts only delete inline once the collection
+// has overshot its size by more than twice the slack.
+extern bool wiredTigerCappedDeleteInBackground;
+
 class WiredTigerRecordStore : public RecordStore {
     friend class WiredTigerRecordStoreCursorBase;
 
@@ -206,6 +211,8 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const;
 
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const override;
+
     virtual Status touch(OperationContext* opCtx, BSONObjBuilder* output) const;
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
@@ -239,9 +246,7 @@ public:
         return _tableId;
     }
 
-    void setSizeStorer(WiredTigerSizeStorer* ss) {
-        _sizeStorer = ss;
-    }
+    void setSizeStorer(WiredTigerSizeStorer* ss);
 
     bool isOpHidden_forTest(const RecordId& id) const;
 
@@ -249,10 +254,23 @@ public:
 
     void reclaimOplog(OperationContext* opCtx);
 
+    /**
+     * Appends the state of the oplog stones and how much time was spent truncating the oplog.
+     * Must only be called on a record store with oplog stones.
+     */
+    void getOplogTruncateStats(BSONObjBuilder& builder) const;
+
     int64_t cappedDeleteAsNeeded(OperationContext* opCtx, const RecordId& justInserted);
 
     int64_t cappedDeleteAsNeeded_inlock(OperationContext* opCtx, const RecordId& justInserted);
 
+    /**
+     * Truncates the oldest records of a capped collection which deletes in the background until
+     * it is back within its size. Called by the background capped deleter, with the collection
+     * locked, after an insert requested it.
+     */
+    void cappedDeleteInBackground(OperationContext* opCtx);
+
     stdx::timed_mutex& cappedDeleterMutex() {
         return _cappedDeleterMutex;
     }
@@ -264,7 +282,8 @@ public:
 
     class OplogStones;
 
-    // Exposed only for testing.
+    // Exposed for testing and for reporting oplog truncation statistics. Null unless this record
+    // store is the oplog of a replica set member.
     OplogStones* oplogStones() {
         return _oplogStones.get();
     };
@@ -287,7 +306,10 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Reserves 'count' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _nextId(int64_t count = 1);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
@@ -309,6 +331,12 @@ private:
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
+    // True if truncation is left to the background capped deleter. See
+    // wiredTigerCappedDeleteInBackground.
+    const bool _cappedDeleteInBackground;
+    // Set once an insert has asked the background capped deleter to truncate this collection, and
+    // cleared when the deleter starts on it.
+    AtomicWord<bool> _cappedDeleteRequested;
     RecordId _cappedFirstRecord;
     AtomicInt64 _cappedSleep;
     AtomicInt64 _cappedSleepMS;
@@ -324,13 +352,18 @@ private:
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
-    WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
-    int _sizeStorerCounter;
+    // Not owned, can be NULL. The size storer reads _numRecords and _dataSize when it syncs, so
+    // the insert and delete paths never touch it.
+    WiredTigerSizeStorer* _sizeStorer;
 
     WiredTigerKVEngine* _kvEngine;  // not owned.
 
     // Non-null if this record store is underlying the active oplog.
     std::shared_ptr<OplogStones> _oplogStones;
+
+    // Number of truncations done by reclaimOplog and the total time they took.
+    AtomicInt64 _truncateCount;
+    AtomicInt64 _totalTimeTruncatingMicros;
 };
 
 
@@ -398,6 +431,13 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx);
 
+    /**
+     * Restricts this forward cursor to the records whose RecordIds lie in [start, end). A null
+     * 'start' or 'end' leaves the range unbounded on that side. Must be called before the cursor
+     * has returned any records. Used to partition a scan of a non-capped record store.
+     */
+    void setRange(const RecordId& start, const RecordId& end);
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -424,6 +464,7 @@ protected:
     boost::optional<WiredTigerCursor> _cursor;
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
+    RecordId _rangeEnd;        // If not null, the cursor is EOF once it reaches this record.
 
 private:
     bool isVisible(const RecordId& id);
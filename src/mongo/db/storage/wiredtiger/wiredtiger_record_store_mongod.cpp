@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -151,10 +153,123 @@ bool initRsOplogBackgroundThread(StringData ns) {
     return true;
 }
 
+// Capped collections which an insert has asked the background capped deleter to truncate.
+std::set<NamespaceString> _cappedDeleteRequests;
+bool _cappedDeleterStarted = false;
+stdx::mutex _cappedDeleteMutex;
+stdx::condition_variable _cappedDeleteCV;
+
+/**
+ * Truncates the capped collections which delete in the background, one at a time, as inserts
+ * push them over their size. A single thread serves all of them.
+ */
+class WiredTigerCappedDeleterThread : public BackgroundJob {
+public:
+    WiredTigerCappedDeleterThread() : BackgroundJob(true /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WTCappedDeleter";
+    }
+
+    void _deleteExcessDocuments(const NamespaceString& nss) {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+
+        try {
+            AutoGetDb autoDb(&opCtx, nss.db(), MODE_IX);
+            Database* db = autoDb.getDb();
+            if (!db) {
+                return;
+            }
+
+            Lock::CollectionLock collectionLock(opCtx.lockState(), nss.ns(), MODE_IX);
+            Collection* collection = db->getCollection(&opCtx, nss);
+            if (!collection) {
+                return;  // Dropped since the request.
+            }
+
+            OldClientContext ctx(&opCtx, nss.ns(), false);
+            WiredTigerRecordStore* rs =
+                checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+            rs->cappedDeleteInBackground(&opCtx);
+        } catch (const DBException& e) {
+            // The next insert over the cap asks for another attempt.
+            warning() << "error truncating capped collection " << nss << ": " << redact(e);
+        }
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        while (!globalInShutdownDeprecated()) {
+            std::set<NamespaceString> requests;
+            {
+                stdx::unique_lock<stdx::mutex> lock(_cappedDeleteMutex);
+                _cappedDeleteCV.wait_for(lock, stdx::chrono::seconds(1), [] {
+                    return !_cappedDeleteRequests.empty();
+                });
+                requests.swap(_cappedDeleteRequests);
+            }
+
+            for (auto&& nss : requests) {
+                _deleteExcessDocuments(nss);
+            }
+        }
+    }
+};
+
+bool requestCappedDelete(StringData ns) {
+    if (storageGlobalParams.repair || storageGlobalParams.readOnly) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_cappedDeleteMutex);
+    if (!_cappedDeleterStarted) {
+        log() << "Starting WiredTigerCappedDeleterThread";
+        BackgroundJob* backgroundThread = new WiredTigerCappedDeleterThread();
+        backgroundThread->go();
+        _cappedDeleterStarted = true;
+    }
+    _cappedDeleteRequests.insert(NamespaceString(ns));
+    _cappedDeleteCV.notify_one();
+    return true;
+}
+
+class OplogTruncationServerStatus : public ServerStatusSection {
+public:
+    OplogTruncationServerStatus() : ServerStatusSection("oplogTruncation") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        AutoGetCollectionForRead autoColl(opCtx, NamespaceString::kRsOplogNamespace);
+        Collection* oplog = autoColl.getCollection();
+        if (!oplog) {
+            return BSONObj();
+        }
+
+        auto rs = dynamic_cast<WiredTigerRecordStore*>(oplog->getRecordStore());
+        if (!rs || !rs->oplogStones()) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder builder;
+        rs->getOplogTruncateStats(builder);
+        return builder.obj();
+    }
+} oplogTruncationServerStatus;
+
 MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* context) {
     WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(initRsOplogBackgroundThread);
     return Status::OK();
 }
 
+MONGO_INITIALIZER(SetRequestCappedDeleteCallback)(InitializerContext* context) {
+    WiredTigerKVEngine::setRequestCappedDeleteCallback(requestCappedDelete);
+    return Status::OK();
+}
+
 }  // namespace
 }  // namespace mongo
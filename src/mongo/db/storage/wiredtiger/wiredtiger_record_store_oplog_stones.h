@@ -30,14 +30,17 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <string>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class RecordId;
 
@@ -73,6 +76,16 @@ public:
 
     void popOldestStone();
 
+    // Subtracts the given number of records and bytes from the oldest stone after the oplog was
+    // truncated up to a point before its last record.
+    void shrinkOldestStone(int64_t records, int64_t bytes);
+
+    /**
+     * Appends the number of stones, the contents of the stone being filled and how the stones
+     * were initially placed.
+     */
+    void getStats(BSONObjBuilder* builder) const;
+
     void createNewStoneIfNeeded(RecordId lastRecord);
 
     void updateCurrentStoneAfterInsertOnCommit(OperationContext* opCtx,
@@ -127,6 +140,11 @@ private:
 
     static const uint64_t kRandomSamplesPerStone = 10;
 
+    // How the stones were placed when the oplog was opened, "scanning" or "sampling", and how
+    // long that took.
+    std::string _processingMethod;
+    Microseconds _totalTimeProcessing{0};
+
     WiredTigerRecordStore* _rs;
 
     stdx::mutex _oplogReclaimMutex;
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <time.h>
@@ -40,6 +41,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -261,6 +263,51 @@ TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     ASSERT(!cursor->next());
 }
 
+TEST(WiredTigerRecordStoreTest, CappedDeleteInBackground) {
+    wiredTigerCappedDeleteInBackground = true;
+    int numRequests = 0;
+    WiredTigerKVEngine::setRequestCappedDeleteCallback([&numRequests](StringData ns) {
+        ASSERT_EQ("a.b", ns);
+        ++numRequests;
+        return true;
+    });
+    ON_BLOCK_EXIT([] {
+        wiredTigerCappedDeleteInBackground = false;
+        WiredTigerKVEngine::setRequestCappedDeleteCallback([](StringData) { return false; });
+    });
+
+    // The slack is a tenth of the maximum size, 1000 bytes.
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    auto insertRecords = [&](int count) {
+        std::string data(100, 'x');
+        for (int i = 0; i < count; ++i) {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp(), false)
+                          .getStatus());
+            uow.commit();
+        }
+    };
+
+    // Inserts over the cap leave the truncation to the background deleter, and only the first one
+    // asks for it.
+    insertRecords(105);
+    ASSERT_EQ(105, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(1, numRequests);
+
+    wtrs->cappedDeleteInBackground(opCtx.get());
+    ASSERT_EQ(100, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10000, rs->dataSize(opCtx.get()));
+
+    // Once the overshoot reaches twice the slack, inserts delete inline.
+    insertRecords(50);
+    ASSERT_EQ(2, numRequests);
+    ASSERT_LT(rs->dataSize(opCtx.get()), 12000);
+}
+
 RecordId _oplogOrderInsertOplog(OperationContext* opCtx,
                                 const unique_ptr<RecordStore>& rs,
                                 int inc) {
@@ -403,6 +450,58 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+// Verify that the range cursors returned by getManyCursors() partition the record store, returning
+// every record exactly once and in order within each partition, even across a yield.
+TEST(WiredTigerRecordStoreTest, GetManyCursorsPartitionsRecordStore) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 5500;
+    std::set<RecordId> inserted;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        for (int i = 0; i < nToInsert; ++i) {
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            inserted.insert(res.getValue());
+            uow.commit();
+        }
+    }
+
+    // Delete a few records including the first one, so that partition boundaries may fall on ids
+    // which no longer exist.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (RecordId id : {*inserted.begin(), RecordId(inserted.begin()->repr() + 1000)}) {
+            rs->deleteRecord(opCtx.get(), id);
+            inserted.erase(id);
+        }
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursors = rs->getManyCursors(opCtx.get());
+    ASSERT_GT(cursors.size(), 1U);
+
+    std::set<RecordId> seen;
+    for (auto&& cursor : cursors) {
+        // Yield before the first call to next() to make sure the range survives a restore.
+        cursor->save();
+        opCtx->recoveryUnit()->abandonSnapshot();
+        ASSERT_TRUE(cursor->restore());
+
+        RecordId previous;
+        while (auto record = cursor->next()) {
+            ASSERT_LT(previous, record->id);
+            ASSERT_TRUE(seen.insert(record->id).second);
+            previous = record->id;
+        }
+    }
+    ASSERT(inserted == seen);
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
@@ -806,6 +905,66 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that the oldest stone is truncated in several ranges when the number of records truncated
+// at once is limited, and that truncation stops once cappedMaxSize is no longer exceeded.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesInBatches) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    ServerParameter* maxRecordsPerBatch =
+        ServerParameterSet::getGlobal()->getMap().find("oplogTruncateMaxRecordsPerBatch")->second;
+    ASSERT_OK(maxRecordsPerBatch->setFromString("1"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(maxRecordsPerBatch->setFromString("0")); });
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 150U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        for (int i = 1; i <= 6; ++i) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, i), 40),
+                      RecordId(1, i));
+        }
+
+        ASSERT_EQ(6, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(240, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(0, oplogStones->currentRecords());
+        ASSERT_EQ(0, oplogStones->currentBytes());
+    }
+
+    // The first stone is removed one record at a time, and the second one is kept.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(120, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+
+        auto cursor = rs->getCursor(opCtx.get());
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(RecordId(1, 4), record->id);
+
+        BSONObjBuilder stats;
+        wtrs->getOplogTruncateStats(stats);
+        ASSERT_EQ(3, stats.obj()["truncateCount"].numberLong());
+    }
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
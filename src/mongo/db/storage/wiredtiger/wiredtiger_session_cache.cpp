@@ -35,9 +35,14 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+#include <array>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -45,12 +50,82 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+// Process-wide counters reported in serverStatus, see WiredTigerSessionCache::appendGlobalStats.
+AtomicUInt64 sessionsOpened;
+AtomicUInt64 sessionsReused;
+AtomicUInt64 cursorsOpened;
+AtomicUInt64 cursorsReused;
+
+// Upper bound on how long a journal flush is held back so that more concurrent waiters can share
+// it. The actual delay is also bounded by half of the latency of the previous flush, so a fast
+// journal device is never slowed down by more than it would gain. Zero disables the delay.
+AtomicInt32 wiredTigerGroupCommitMaxDelayMicros(0);
+
+class ExportedGroupCommitMaxDelayParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedGroupCommitMaxDelayParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "wiredTigerGroupCommitMaxDelayMicros",
+              &wiredTigerGroupCommitMaxDelayMicros) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 0 || potentialNewValue > 10000) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerGroupCommitMaxDelayMicros must be between 0 and 10000");
+        }
+
+        return Status::OK();
+    }
+
+} exportedGroupCommitMaxDelayParameter;
+
+// Journal flushes done by waitUntilDurable, the callers they made durable, and histograms of
+// their latency and of the number of callers waiting when they started. Bucket i counts values
+// below 4^(i+1), the last bucket counts everything larger.
+const size_t kGroupCommitHistogramBuckets = 8;
+AtomicUInt64 groupCommitFlushes;
+AtomicUInt64 groupCommitWaiters;
+AtomicUInt64 groupCommitTotalFlushMicros;
+AtomicUInt64 groupCommitLastFlushMicros;
+std::array<AtomicUInt64, kGroupCommitHistogramBuckets> groupCommitLatencyMicros;
+std::array<AtomicUInt64, kGroupCommitHistogramBuckets> groupCommitBatchSize;
+
+void incrementHistogram(std::array<AtomicUInt64, kGroupCommitHistogramBuckets>* histogram,
+                        uint64_t value) {
+    size_t bucket = 0;
+    for (uint64_t bound = 4; value >= bound && bucket < kGroupCommitHistogramBuckets - 1;
+         bound *= 4) {
+        ++bucket;
+    }
+    (*histogram)[bucket].fetchAndAdd(1);
+}
+
+void appendHistogram(BSONObjBuilder* b,
+                     StringData name,
+                     const std::array<AtomicUInt64, kGroupCommitHistogramBuckets>& histogram) {
+    BSONArrayBuilder arr(b->subarrayStart(name));
+    uint64_t bound = 4;
+    for (size_t i = 0; i < kGroupCommitHistogramBuckets; ++i, bound *= 4) {
+        BSONObjBuilder bucket(arr.subobjStart());
+        if (i < kGroupCommitHistogramBuckets - 1) {
+            bucket.append("lessThan", static_cast<long long>(bound));
+        }
+        bucket.append("count", static_cast<long long>(histogram[i].load()));
+    }
+}
+}  // namespace
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch),
       _cursorEpoch(cursorEpoch),
+      _cache(nullptr),
       _session(NULL),
       _cursorGen(0),
       _cursorsCached(0),
@@ -86,6 +161,7 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
             _cursors.erase(i);
             _cursorsOut++;
             _cursorsCached--;
+            cursorsReused.fetchAndAdd(1);
             return c;
         }
     }
@@ -95,8 +171,10 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
         _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
     if (ret != ENOENT)
         invariantWTOK(ret);
-    if (c)
+    if (c) {
         _cursorsOut++;
+        cursorsOpened.fetchAndAdd(1);
+    }
     return c;
 }
 
@@ -238,6 +316,10 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    groupCommitWaiters.fetchAndAdd(1);
+    _durableWaiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _durableWaiters.fetchAndSubtract(1); });
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -247,7 +329,22 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // When other threads are waiting too, hold the flush back briefly so that callers arriving
+    // meanwhile read the current lastSyncTime and are made durable by this flush rather than
+    // queueing for the next one.
+    const long long maxDelayMicros = wiredTigerGroupCommitMaxDelayMicros.load();
+    if (maxDelayMicros > 0 && _durableWaiters.load() > 1) {
+        const long long lastFlushMicros =
+            static_cast<long long>(groupCommitLastFlushMicros.load());
+        const long long delayMicros = std::min(maxDelayMicros, lastFlushMicros / 2);
+        if (delayMicros > 0) {
+            sleepmicros(delayMicros);
+        }
+    }
+
     _lastSyncTime.store(current + 1);
+    incrementHistogram(&groupCommitBatchSize, _durableWaiters.load());
 
     // Nobody has synched yet, so we have to sync ourselves.
 
@@ -263,6 +360,7 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     }
 
     // Use the journal when available, or a checkpoint otherwise.
+    Timer flushTimer;
     if (_engine && _engine->isDurable()) {
         invariantWTOK(_waitUntilDurableSession->log_flush(_waitUntilDurableSession, "sync=on"));
         LOG(4) << "flushed journal";
@@ -271,12 +369,21 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
     _journalListener->onDurable(token);
+
+    const uint64_t flushMicros = flushTimer.micros();
+    groupCommitFlushes.fetchAndAdd(1);
+    groupCommitTotalFlushMicros.fetchAndAdd(flushMicros);
+    groupCommitLastFlushMicros.store(flushMicros);
+    incrementHistogram(&groupCommitLatencyMicros, flushMicros);
 }
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -284,24 +391,30 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions released
+    // after this point recheck the epoch under their partition's lock and are not cached.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (auto&& partition : _partitions) {
+        SessionCache swap;
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition.lock);
+            partition.sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -314,18 +427,24 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Start with this thread's partition, and only take a session cached by another thread
+    // before opening a new one.
+    const size_t home = _threadPartition();
+    for (size_t n = 0; n < kNumPartitions; ++n) {
+        CachePartition& partition = _partitions[(home + n) % kNumPartitions];
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        if (!partition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
+            sessionsReused.fetchAndAdd(1);
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
+    sessionsOpened.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -369,10 +488,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        CachePartition& partition = _partitions[_threadPartition()];
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -384,6 +504,30 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+size_t WiredTigerSessionCache::_threadPartition() {
+    // Threads are spread over the partitions in the order in which they first use a session
+    // cache, which balances them better than hashing their thread ids.
+    static AtomicUInt32 nextPartition;
+    thread_local size_t partition = nextPartition.fetchAndAdd(1) % kNumPartitions;
+    return partition;
+}
+
+void WiredTigerSessionCache::appendGlobalStats(BSONObjBuilder& b) {
+    BSONObjBuilder bb(b.subobjStart("sessionCache"));
+    bb.append("sessionsOpened", static_cast<long long>(sessionsOpened.load()));
+    bb.append("sessionsReused", static_cast<long long>(sessionsReused.load()));
+    bb.append("cursorsOpened", static_cast<long long>(cursorsOpened.load()));
+    bb.append("cursorsReused", static_cast<long long>(cursorsReused.load()));
+    bb.done();
+
+    BSONObjBuilder gc(b.subobjStart("groupCommit"));
+    gc.append("flushes", static_cast<long long>(groupCommitFlushes.load()));
+    gc.append("waiters", static_cast<long long>(groupCommitWaiters.load()));
+    gc.append("totalFlushMicros", static_cast<long long>(groupCommitTotalFlushMicros.load()));
+    appendHistogram(&gc, "flushLatencyMicros", groupCommitLatencyMicros);
+    appendHistogram(&gc, "waitersPerFlush", groupCommitBatchSize);
+    gc.done();
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -31,8 +31,10 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -44,6 +46,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -194,6 +197,9 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers that do not force a checkpoint share a single journal flush, see
+     * wiredTigerGroupCommitMaxDelayMicros.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
@@ -218,6 +224,13 @@ public:
         return _engine;
     }
 
+    /**
+     * Appends counters describing how often sessions and cursors were reused from a cache rather
+     * than opened, and how waitUntilDurable callers were grouped into journal flushes, for all
+     * session caches in this process.
+     */
+    static void appendGlobalStats(BSONObjBuilder& b);
+
 private:
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
@@ -229,9 +242,23 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // Released sessions are cached in one of several partitions, each with its own lock, so that
+    // threads getting and releasing sessions concurrently rarely contend. A thread always starts
+    // with the same partition, which keeps a session and its cached cursors on one thread as
+    // long as that thread keeps reusing them.
+    struct CachePartition {
+        stdx::mutex lock;
+        SessionCache sessions;
+    };
+    static const size_t kNumPartitions = 16;
+    std::array<CachePartition, kNumPartitions> _partitions;
+
+    /**
+     * Returns the index of the partition the calling thread gets and releases sessions through.
+     */
+    static size_t _threadPartition();
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -243,6 +270,9 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Number of threads currently in waitUntilDurable without forcing a checkpoint.
+    AtomicUInt32 _durableWaiters;
+
     // Protects _journalListener.
     stdx::mutex _journalListenerMutex;
     // Notified when we commit to the journal.
@@ -240,9 +240,18 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     invariantWTOK(session->commit_transaction(session, NULL));
 
     {
+        // Only clean the entries that still hold the values just written. Anything that changed
+        // while the transaction was running stays dirty and goes out with the next sync.
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+        for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
+            Map::iterator current = _entries.find(it->first);
+            if (current == _entries.end())
+                continue;
+            Entry& entry = current->second;
+            if (entry.numRecords == it->second.numRecords &&
+                entry.dataSize == it->second.dataSize) {
+                entry.dirty = false;
+            }
         }
     }
 }
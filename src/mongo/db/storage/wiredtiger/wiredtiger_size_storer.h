@@ -65,7 +65,8 @@ public:
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table. Counts of registered record stores are read
+     * from the record stores themselves here, so several changes are written out as one.
      */
     void syncCache(bool syncToDisk);
 
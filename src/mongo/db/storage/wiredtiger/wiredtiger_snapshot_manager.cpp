@@ -55,6 +55,7 @@ void WiredTigerSnapshotManager::setCommittedSnapshot(const Timestamp& timestamp)
 
     invariant(!_committedSnapshot || *_committedSnapshot <= timestamp);
     _committedSnapshot = timestamp;
+    _makeReadTimestampConfig(timestamp, &_committedSnapshotConfig);
 }
 
 void WiredTigerSnapshotManager::cleanupUnneededSnapshots() {}
@@ -77,33 +78,46 @@ boost::optional<Timestamp> WiredTigerSnapshotManager::getMinSnapshotForNextCommi
     return _committedSnapshot;
 }
 
-Status WiredTigerSnapshotManager::beginTransactionAtTimestamp(Timestamp pointInTime,
-                                                              WT_SESSION* session) const {
-    char readTSConfigString[15 /* read_timestamp= */ + (8 * 2) /* 8 hexadecimal characters */ +
-                            1 /* trailing null */];
+void WiredTigerSnapshotManager::_makeReadTimestampConfig(Timestamp pointInTime,
+                                                         ReadTimestampConfig* config) {
     auto size = std::snprintf(
-        readTSConfigString, sizeof(readTSConfigString), "read_timestamp=%llx", pointInTime.asULL());
+        config->data(), config->size(), "read_timestamp=%llx", pointInTime.asULL());
     if (size < 0) {
         int e = errno;
         error() << "error snprintf " << errnoWithDescription(e);
         fassertFailedNoTrace(40664);
     }
-    invariant(static_cast<std::size_t>(size) < sizeof(readTSConfigString));
+    invariant(static_cast<std::size_t>(size) < config->size());
+}
 
-    return wtRCToStatus(session->begin_transaction(session, readTSConfigString));
+Status WiredTigerSnapshotManager::beginTransactionAtTimestamp(Timestamp pointInTime,
+                                                              WT_SESSION* session) const {
+    ReadTimestampConfig readTSConfig;
+    _makeReadTimestampConfig(pointInTime, &readTSConfig);
+
+    return wtRCToStatus(session->begin_transaction(session, readTSConfig.data()));
 }
 
 Timestamp WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     WT_SESSION* session) const {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
-    uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
-            "Committed view disappeared while running operation",
-            _committedSnapshot);
+    // Copy out the committed snapshot and its prepared configuration, and start the transaction
+    // without holding the mutex, so that concurrent majority reads do not serialize on it.
+    Timestamp committedSnapshot;
+    ReadTimestampConfig readTSConfig;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+        uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
+                "Committed view disappeared while running operation",
+                _committedSnapshot);
+
+        committedSnapshot = *_committedSnapshot;
+        readTSConfig = _committedSnapshotConfig;
+    }
 
-    auto status = beginTransactionAtTimestamp(_committedSnapshot.get(), session);
+    auto status = wtRCToStatus(session->begin_transaction(session, readTSConfig.data()));
     fassertStatusOK(30635, status);
-    return *_committedSnapshot;
+    return committedSnapshot;
 }
 
 void WiredTigerSnapshotManager::beginTransactionOnOplog(WiredTigerOplogManager* oplogManager,
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional.hpp>
 #include <wiredtiger.h>
 
@@ -94,8 +95,19 @@ public:
     boost::optional<Timestamp> getMinSnapshotForNextCommittedRead() const;
 
 private:
+    using ReadTimestampConfig = std::array<char,
+                                           15 /* read_timestamp= */ +
+                                               (8 * 2) /* 16 hexadecimal digits */ +
+                                               1 /* trailing null */>;
+
+    static void _makeReadTimestampConfig(Timestamp pointInTime, ReadTimestampConfig* config);
+
     mutable stdx::mutex _mutex;  // Guards all members.
     boost::optional<Timestamp> _committedSnapshot;
+
+    // The begin_transaction configuration for reading at _committedSnapshot, built once when the
+    // snapshot advances so that majority reads only need to copy it.
+    ReadTimestampConfig _committedSnapshotConfig;
     WT_SESSION* _session;
     WT_CONNECTION* _conn;
 };
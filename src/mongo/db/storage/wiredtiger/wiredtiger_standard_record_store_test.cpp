@@ -296,6 +296,44 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// Syncing writes the live counts of an attached record store without any explicit update.
+TEST(WiredTigerRecordStoreTest, SizeStorerSyncReadsRecordStoreCounts) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    string sizeStorerUri = "table:sizeStorerSync";
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri, enableWtLogging);
+    checked_cast<WiredTigerRecordStore*>(rs.get())->setSizeStorer(&ss);
+
+    int N = 2500;
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < N; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false).getStatus());
+        }
+        uow.commit();
+    }
+
+    ss.syncCache(true);
+
+    {
+        WiredTigerSizeStorer ss2(harnessHelper->conn(), sizeStorerUri, enableWtLogging);
+        ss2.fillCache();
+        long long numRecords;
+        long long dataSize;
+        ss2.loadFromCache(uri, &numRecords, &dataSize);
+        ASSERT_EQUALS(N, numRecords);
+        ASSERT_EQUALS(N * 2, dataSize);
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
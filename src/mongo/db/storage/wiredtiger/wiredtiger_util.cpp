@@ -317,6 +317,74 @@ StatusWith<uint64_t> WiredTigerUtil::getStatisticsValue(WT_SESSION* session,
     return StatusWith<uint64_t>(value);
 }
 
+Status WiredTigerUtil::appendCacheStats(WT_SESSION* session,
+                                        const std::string& uri,
+                                        BSONObjBuilder* bob) {
+    invariant(session);
+    const std::string statisticsURI = "statistics:" + uri;
+    WT_CURSOR* cursor = NULL;
+    int ret =
+        session->open_cursor(session, statisticsURI.c_str(), NULL, "statistics=(fast)", &cursor);
+    if (ret != 0) {
+        return {ErrorCodes::CursorNotFound,
+                str::stream() << "unable to open cursor at URI " << statisticsURI << ". reason: "
+                              << wiredtiger_strerror(ret)};
+    }
+    invariant(cursor);
+    ON_BLOCK_EXIT(cursor->close, cursor);
+
+    struct CacheStat {
+        const char* name;
+        std::initializer_list<int> keys;
+    };
+    const CacheStat cacheStats[] = {
+        {"bytesInCache", {WT_STAT_DSRC_CACHE_BYTES_INUSE}},
+        {"bytesDirty", {WT_STAT_DSRC_CACHE_BYTES_DIRTY}},
+        {"pagesReadIntoCache", {WT_STAT_DSRC_CACHE_READ}},
+        {"pagesWrittenFromCache", {WT_STAT_DSRC_CACHE_WRITE}},
+        {"pagesEvicted", {WT_STAT_DSRC_CACHE_EVICTION_CLEAN, WT_STAT_DSRC_CACHE_EVICTION_DIRTY}},
+        {"cursorSearches", {WT_STAT_DSRC_CURSOR_SEARCH, WT_STAT_DSRC_CURSOR_SEARCH_NEAR}},
+        {"cursorScans", {WT_STAT_DSRC_CURSOR_NEXT, WT_STAT_DSRC_CURSOR_PREV}},
+        {"cursorInserts", {WT_STAT_DSRC_CURSOR_INSERT}},
+        {"cursorUpdates", {WT_STAT_DSRC_CURSOR_UPDATE, WT_STAT_DSRC_CURSOR_MODIFY}},
+        {"cursorRemoves", {WT_STAT_DSRC_CURSOR_REMOVE}},
+    };
+
+    // Read everything before appending, so that a failure leaves 'bob' untouched.
+    std::vector<long long> values;
+    for (const auto& stat : cacheStats) {
+        uint64_t total = 0;
+        for (int key : stat.keys) {
+            cursor->set_key(cursor, key);
+            ret = cursor->search(cursor);
+            if (ret != 0) {
+                return {ErrorCodes::NoSuchKey,
+                        str::stream() << "unable to find key " << key << " at URI "
+                                      << statisticsURI
+                                      << ". reason: "
+                                      << wiredtiger_strerror(ret)};
+            }
+
+            uint64_t value;
+            ret = cursor->get_value(cursor, NULL, NULL, &value);
+            if (ret != 0) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "unable to get value for key " << key << " at URI "
+                                      << statisticsURI
+                                      << ". reason: "
+                                      << wiredtiger_strerror(ret)};
+            }
+            total += value;
+        }
+        values.push_back(_castStatisticsValue<long long>(total));
+    }
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        bob->appendNumber(cacheStats[i].name, values[i]);
+    }
+    return Status::OK();
+}
+
 int64_t WiredTigerUtil::getIdentSize(WT_SESSION* s, const std::string& uri) {
     StatusWith<int64_t> result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
         s, "statistics:" + uri, "statistics=(size)", WT_STAT_DSRC_BLOCK_SIZE);
@@ -176,6 +176,16 @@ public:
 
     static int64_t getIdentSize(WT_SESSION* s, const std::string& uri);
 
+    /**
+     * Appends a summary of the cache residency and I/O of the table at 'uri': bytes currently in
+     * the cache, pages read into and written from the cache, pages evicted and cursor operations.
+     * Only "fast" statistics are read, so this is cheap enough to call periodically. Nothing is
+     * appended on error.
+     */
+    static Status appendCacheStats(WT_SESSION* session,
+                                   const std::string& uri,
+                                   BSONObjBuilder* bob);
+
 
     /**
      * Return amount of memory to use for the WiredTiger cache based on either the startup
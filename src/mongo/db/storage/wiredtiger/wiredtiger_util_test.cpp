@@ -34,6 +34,7 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
@@ -360,4 +361,52 @@ TEST(WiredTigerUtilTest, GetStatisticsValueAsUInt8) {
     ASSERT_EQUALS(static_cast<uint8_t>(100), resultInt16.getValue());
 }
 
+TEST(WiredTigerUtilTest, AppendCacheStatsMissingTable) {
+    WiredTigerUtilHarnessHelper harnessHelper("statistics=(all)");
+    WiredTigerRecoveryUnit recoveryUnit(harnessHelper.getSessionCache(),
+                                        harnessHelper.getOplogManager());
+    WiredTigerSession* session = recoveryUnit.getSession();
+    BSONObjBuilder bob;
+    Status status =
+        WiredTigerUtil::appendCacheStats(session->getSession(), "table:no_such_table", &bob);
+    ASSERT_EQUALS(ErrorCodes::CursorNotFound, status.code());
+    ASSERT_TRUE(bob.obj().isEmpty());
+}
+
+TEST(WiredTigerUtilTest, AppendCacheStatsAfterInsert) {
+    WiredTigerUtilHarnessHelper harnessHelper("statistics=(all)");
+    WiredTigerRecoveryUnit recoveryUnit(harnessHelper.getSessionCache(),
+                                        harnessHelper.getOplogManager());
+    WiredTigerSession* session = recoveryUnit.getSession();
+    WT_SESSION* wtSession = session->getSession();
+    ASSERT_OK(wtRCToStatus(
+        wtSession->create(wtSession, "table:mytable", "key_format=S,value_format=S")));
+
+    WT_CURSOR* cursor;
+    ASSERT_OK(wtRCToStatus(
+        wtSession->open_cursor(wtSession, "table:mytable", NULL, NULL, &cursor)));
+    cursor->set_key(cursor, "key");
+    cursor->set_value(cursor, "value");
+    ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+    ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+
+    BSONObjBuilder bob;
+    ASSERT_OK(WiredTigerUtil::appendCacheStats(wtSession, "table:mytable", &bob));
+    BSONObj stats = bob.obj();
+    for (auto&& field : {"bytesInCache",
+                         "bytesDirty",
+                         "pagesReadIntoCache",
+                         "pagesWrittenFromCache",
+                         "pagesEvicted",
+                         "cursorSearches",
+                         "cursorScans",
+                         "cursorInserts",
+                         "cursorUpdates",
+                         "cursorRemoves"}) {
+        ASSERT_TRUE(stats[field].isNumber()) << field << " missing from " << stats;
+    }
+    ASSERT_EQUALS(1, stats["cursorInserts"].numberLong());
+    ASSERT_GREATER_THAN(stats["bytesInCache"].numberLong(), 0);
+}
+
 }  // namespace mongo
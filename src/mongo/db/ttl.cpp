@@ -34,6 +34,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -41,6 +43,7 @@
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/drop_collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
@@ -48,6 +51,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
@@ -55,23 +59,157 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlDeleteBatches;
+Counter64 ttlDroppedTimeWindows;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlDeleteBatchesDisplay("ttl.deleteBatches", &ttlDeleteBatches);
+ServerStatusMetricField<Counter64> ttlDroppedTimeWindowsDisplay("ttl.droppedTimeWindows",
+                                                                &ttlDroppedTimeWindows);
 
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// Number of threads which expire documents from TTL indexes concurrently. With a single worker,
+// indexes are processed one at a time on the TTLMonitor thread.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ttlMonitorNumWorkers, int, 1);
+
+// Maximum number of index keys whose documents are deleted by a single batch. Locks are released
+// between batches.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 10000);
+
+// Upper bound on the rate at which all TTL workers together delete documents. Zero or less means
+// unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorDeletesPerSecond, int, 0);
+
+namespace {
+
+/**
+ * Spreads deletions from all TTL workers over time so that together they stay within
+ * 'ttlMonitorDeletesPerSecond'.
+ */
+class TTLDeleteBudget {
+    MONGO_DISALLOW_COPYING(TTLDeleteBudget);
+
+public:
+    TTLDeleteBudget() = default;
+
+    /**
+     * Charges 'numDeleted' deletions against the budget and returns how long the caller should
+     * wait before deleting more documents.
+     */
+    Milliseconds charge(long long numDeleted, int deletesPerSecond) {
+        if (deletesPerSecond <= 0 || numDeleted <= 0) {
+            return Milliseconds(0);
+        }
+
+        const Date_t now = Date_t::now();
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _nextAvailable = std::max(_nextAvailable, now) +
+            Milliseconds(numDeleted * 1000 / deletesPerSecond);
+        return _nextAvailable - now;
+    }
+
+private:
+    stdx::mutex _mutex;
+    Date_t _nextAvailable;
+};
+
+/**
+ * Per-index statistics reported in serverStatus under metrics.ttl.indexes.
+ */
+struct TTLIndexStats {
+    long long passes = 0;
+    long long deletedDocuments = 0;
+    long long lastPassDeletedDocuments = 0;
+    long long lastPassBatches = 0;
+    Milliseconds lastPassDuration{0};
+
+    // How long ago the oldest expired document which has not yet been deleted expired, as of the
+    // start of the most recent batch. Zero once a pass has caught up.
+    Seconds backlog{0};
+    bool inProgress = false;
+};
+
+class TTLIndexStatsRegistry {
+    MONGO_DISALLOW_COPYING(TTLIndexStatsRegistry);
+
+public:
+    using IndexId = std::pair<std::string, std::string>;
+
+    TTLIndexStatsRegistry() = default;
+
+    template <typename Func>
+    void update(const IndexId& index, Func func) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        func(&_stats[index]);
+    }
+
+    /**
+     * Forgets the statistics of indexes which are not in 'current', which is sorted.
+     */
+    void retainOnly(const std::vector<IndexId>& current) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto it = _stats.begin(); it != _stats.end();) {
+            if (std::binary_search(current.begin(), current.end(), it->first)) {
+                ++it;
+            } else {
+                it = _stats.erase(it);
+            }
+        }
+    }
+
+    void append(StringData fieldName, BSONObjBuilder* builder) const {
+        BSONArrayBuilder indexes(builder->subarrayStart(fieldName));
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& entry : _stats) {
+            const TTLIndexStats& stats = entry.second;
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", entry.first.first);
+            index.append("name", entry.first.second);
+            index.append("passes", stats.passes);
+            index.append("deletedDocuments", stats.deletedDocuments);
+            index.append("lastPassDeletedDocuments", stats.lastPassDeletedDocuments);
+            index.append("lastPassBatches", stats.lastPassBatches);
+            index.append("lastPassMillis", durationCount<Milliseconds>(stats.lastPassDuration));
+            index.append("backlogSecs", durationCount<Seconds>(stats.backlog));
+            index.append("inProgress", stats.inProgress);
+        }
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<IndexId, TTLIndexStats> _stats;
+};
+
+TTLDeleteBudget ttlDeleteBudget;
+TTLIndexStatsRegistry ttlIndexStats;
+
+class TTLIndexStatsMetric : public ServerStatusMetric {
+public:
+    TTLIndexStatsMetric() : ServerStatusMetric("ttl.indexes") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        ttlIndexStats.append(_leafName, &b);
+    }
+} ttlIndexStatsMetric;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -87,6 +225,21 @@ public:
         Client::initThread(name().c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
 
+        const int numWorkers = ttlMonitorNumWorkers;
+        if (numWorkers > 1) {
+            ThreadPool::Options options;
+            options.poolName = "TTLWorkers";
+            options.threadNamePrefix = "TTLWorker-";
+            options.minThreads = 0;
+            options.maxThreads = numWorkers;
+            options.onCreateThread = [](const std::string& threadName) {
+                Client::initThread(threadName.c_str());
+                AuthorizationSession::get(cc())->grantInternalAuthorization();
+            };
+            _workers = stdx::make_unique<ThreadPool>(options);
+            _workers->startup();
+        }
+
         while (!globalInShutdownDeprecated()) {
             {
                 MONGO_IDLE_THREAD_BLOCK;
@@ -129,6 +282,8 @@ private:
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
         std::vector<BSONObj> ttlIndexes;
+        std::vector<TTLIndexStatsRegistry::IndexId> ttlIndexIds;
+        std::vector<NamespaceString> expiredTimeWindows;
 
         ttlPasses.increment();
 
@@ -142,6 +297,14 @@ private:
                 continue;
             }
 
+            // Expired time windows are dropped as a whole, so their documents need not be deleted.
+            const auto& timeWindow = coll->getTimeWindow();
+            const auto expiresAt = timeWindow ? timeWindow->expiresAt() : boost::none;
+            if (expiresAt && *expiresAt <= Date_t::now()) {
+                expiredTimeWindows.push_back(collectionNSS);
+                continue;
+            }
+
             CollectionCatalogEntry* collEntry = coll->getCatalogEntry();
             std::vector<std::string> indexNames;
             collEntry->getAllIndexes(&opCtx, &indexNames);
@@ -149,24 +312,82 @@ private:
                 BSONObj spec = collEntry->getIndexSpec(&opCtx, name);
                 if (spec.hasField(secondsExpireField)) {
                     ttlIndexes.push_back(spec.getOwned());
+                    ttlIndexIds.emplace_back(collectionNS, name);
                 }
             }
         }
 
+        for (const NamespaceString& nss : expiredTimeWindows) {
+            dropExpiredTimeWindow(&opCtx, nss);
+        }
+
+        std::sort(ttlIndexIds.begin(), ttlIndexIds.end());
+        ttlIndexStats.retainOnly(ttlIndexIds);
+
+        if (!_workers) {
+            for (const BSONObj& idx : ttlIndexes) {
+                doTTLForIndexNoThrow(&opCtx, idx);
+            }
+            return;
+        }
+
+        // Each worker expires documents from one index at a time, using its own operation context.
         for (const BSONObj& idx : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, idx);
-            } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                // Continue on to the next index.
-                continue;
+            Status status = _workers->schedule([this, idx] {
+                const ServiceContext::UniqueOperationContext workerOpCtx =
+                    cc().makeOperationContext();
+                doTTLForIndexNoThrow(workerOpCtx.get(), idx);
+            });
+            if (!status.isOK()) {
+                // The pool only refuses work once it is shutting down.
+                LOG(1) << "unable to schedule ttl job for " << idx << ": " << redact(status);
+                break;
+            }
+        }
+
+        MONGO_IDLE_THREAD_BLOCK;
+        _workers->waitForIdle();
+    }
+
+    /**
+     * Drops the time window collection 'nss', whose documents have all expired.
+     */
+    void dropExpiredTimeWindow(OperationContext* opCtx, const NamespaceString& nss) {
+        if (nss.isDropPendingNamespace() || !userAllowedWriteNS(nss).isOK()) {
+            return;
+        }
+
+        try {
+            BSONObjBuilder result;
+            const auto mode = DropCollectionSystemCollectionMode::kDisallowSystemCollectionDrops;
+            Status status = dropCollection(opCtx, nss, result, {}, mode);
+            if (status.isOK()) {
+                ttlDroppedTimeWindows.increment();
+                LOG(1) << "dropped expired time window " << nss;
+            } else if (status != ErrorCodes::NamespaceNotFound &&
+                       status != ErrorCodes::NotMaster) {
+                error() << "failed to drop expired time window " << nss << ": " << redact(status);
             }
+        } catch (const DBException& dbex) {
+            error() << "Error dropping expired time window " << nss << " -- " << dbex.toString();
+        }
+    }
+
+    void doTTLForIndexNoThrow(OperationContext* opCtx, const BSONObj& idx) {
+        try {
+            doTTLForIndex(opCtx, idx);
+        } catch (const DBException& dbex) {
+            error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
         }
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * Expired documents are deleted in batches of consecutive index keys, releasing locks and
+     * waiting on the shared deletion budget between batches. Only documents which had expired when
+     * the pass over this index started are deleted, so that a pass always finishes.
      */
     void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
@@ -180,39 +401,103 @@ private:
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
             return;
         }
 
-        LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
+        const TTLIndexStatsRegistry::IndexId indexId(collectionNSS.ns(), idx["name"].String());
+        LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << indexId.second;
+
+        const Date_t passStart = Date_t::now();
+        ttlIndexStats.update(indexId, [](TTLIndexStats* stats) { stats->inProgress = true; });
+
+        long long numDeleted = 0;
+        long long numBatches = 0;
+        ON_BLOCK_EXIT([&] {
+            const Milliseconds duration = Date_t::now() - passStart;
+            ttlIndexStats.update(indexId, [&](TTLIndexStats* stats) {
+                stats->passes++;
+                stats->deletedDocuments += numDeleted;
+                stats->lastPassDeletedDocuments = numDeleted;
+                stats->lastPassBatches = numBatches;
+                stats->lastPassDuration = duration;
+                stats->inProgress = false;
+            });
+        });
+
+        const Date_t kDawnOfTime =
+            Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+        BSONObj batchStartKey = BSON("" << kDawnOfTime);
+        while (true) {
+            if (globalInShutdownDeprecated() || !ttlMonitorEnabled.load() || lockedForWriting()) {
+                return;
+            }
+
+            long long batchDeleted = 0;
+            const bool mayHaveMore =
+                doTTLBatchForIndex(opCtx, indexId, passStart, &batchStartKey, &batchDeleted);
+            if (batchDeleted < 0) {
+                return;
+            }
+
+            numDeleted += batchDeleted;
+            numBatches++;
+            if (!mayHaveMore) {
+                return;
+            }
 
+            const Milliseconds wait =
+                ttlDeleteBudget.charge(batchDeleted, ttlMonitorDeletesPerSecond.load());
+            if (wait > Milliseconds(0)) {
+                MONGO_IDLE_THREAD_BLOCK;
+                opCtx->sleepFor(wait);
+            }
+        }
+    }
+
+    /**
+     * Deletes the expired documents of the next batch of keys of the TTL index 'indexId', starting
+     * at '*batchStartKey', and advances '*batchStartKey' to the last key of the batch.
+     *
+     * Sets '*numDeleted' to the number of documents deleted, or to -1 if the index can't be
+     * processed right now. Returns whether expired keys may remain after this batch.
+     */
+    bool doTTLBatchForIndex(OperationContext* opCtx,
+                            const TTLIndexStatsRegistry::IndexId& indexId,
+                            Date_t passStart,
+                            BSONObj* batchStartKey,
+                            long long* numDeleted) {
+        *numDeleted = -1;
+
+        const NamespaceString collectionNSS(indexId.first);
         AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
+        IndexDescriptor* desc =
+            collection->getIndexCatalog()->findIndexByName(opCtx, indexId.second);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
-                   << "ttl job for: " << idx;
-            return;
+                   << "ttl job for: " << indexId.first << " " << indexId.second;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
         // before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        const BSONObj idx = desc->infoObj();
+        const BSONObj key = idx["key"].Obj();
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -220,13 +505,12 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
+        const Date_t expirationTime = passStart - Seconds(secondsExpireElt.numberLong());
         const BSONObj endKey = BSON("" << expirationTime);
         // The canonical check as to whether a key pattern element is "ascending" or
         // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
@@ -234,6 +518,36 @@ private:
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
+        // Find the last key of this batch by walking the expired keys. The first of them is the
+        // oldest expired key left, which tells how far behind expiration is.
+        const long long batchSize = std::max(1, ttlMonitorBatchSize.load());
+        const int deletesPerSecond = ttlMonitorDeletesPerSecond.load();
+        const long long batchLimit =
+            deletesPerSecond > 0 ? std::min<long long>(batchSize, deletesPerSecond) : batchSize;
+        BSONObj batchEndKey;
+        long long numKeys = 0;
+        {
+            auto cursor = collection->getIndexCatalog()->getIndex(desc)->newCursor(
+                opCtx, direction == InternalPlanner::Direction::FORWARD);
+            cursor->setEndPosition(endKey, true);
+            auto entry = cursor->seek(*batchStartKey, true);
+            Seconds backlog(0);
+            if (entry) {
+                backlog = duration_cast<Seconds>(expirationTime - entry->key.firstElement().date());
+            }
+            ttlIndexStats.update(indexId, [&](TTLIndexStats* stats) { stats->backlog = backlog; });
+
+            for (; entry && numKeys < batchLimit; entry = cursor->next()) {
+                batchEndKey = entry->key.getOwned();
+                numKeys++;
+            }
+        }
+
+        if (numKeys == 0) {
+            *numDeleted = 0;
+            return false;
+        }
+
         // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
         // queries for the expired documents correctly so that we do not delete documents that are
         // not actually expired when our snapshot changes during deletion.
@@ -254,8 +568,8 @@ private:
                                                  collection,
                                                  params,
                                                  desc,
-                                                 startKey,
-                                                 endKey,
+                                                 *batchStartKey,
+                                                 batchEndKey,
                                                  BoundInclusion::kIncludeBothStartAndEndKeys,
                                                  PlanExecutor::YIELD_AUTO,
                                                  direction);
@@ -264,13 +578,21 @@ private:
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return false;
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        *numDeleted = DeleteStage::getNumDeleted(*exec);
+        ttlDeletedDocuments.increment(*numDeleted);
+        ttlDeleteBatches.increment();
+        LOG(1) << "deleted: " << *numDeleted;
+
+        // The next batch starts at the last key of this one, in case documents with that key were
+        // inserted while the batch ran.
+        *batchStartKey = batchEndKey;
+        return numKeys == batchLimit;
     }
+
+    std::unique_ptr<ThreadPool> _workers;
 };
 
 namespace {
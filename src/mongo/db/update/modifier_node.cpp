@@ -38,6 +38,26 @@ namespace mongo {
 
 namespace {
 
+/**
+ * Returns true if modifying 'path' may change the index keys of the document, and adds the indexes
+ * whose keys may change to 'applyParams.affectedIndexes' if it is provided.
+ */
+bool checkIndexesAffected(const UpdateNode::ApplyParams& applyParams, StringData path) {
+    if (!applyParams.indexData) {
+        return false;
+    }
+
+    auto affectedIndexes = applyParams.indexData->getAffectedIndexes(path);
+    if (affectedIndexes.none()) {
+        return false;
+    }
+
+    if (applyParams.affectedIndexes) {
+        *applyParams.affectedIndexes |= affectedIndexes;
+    }
+    return true;
+}
+
 /**
  * Checks that no immutable paths were modified in the case where we are modifying an existing path
  * in the document.
@@ -189,8 +209,7 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
 
     ApplyResult applyResult;
 
-    if (!applyParams.indexData ||
-        !applyParams.indexData->mightBeIndexed(applyParams.pathTaken->dottedField())) {
+    if (!checkIndexesAffected(applyParams, applyParams.pathTaken->dottedField())) {
         applyResult.indexesAffected = false;
     }
 
@@ -286,10 +305,10 @@ UpdateNode::ApplyResult ModifierNode::applyToNonexistentElement(ApplyParams appl
         // an index {"a.b": 1}, and we set "a.1.c" and implicitly create an array element in "a",
         // then we may need to add a null key to the index, even though "a.1.c" does not appear to
         // affect the index.
-        if (!applyParams.indexData ||
-            !applyParams.indexData->mightBeIndexed(applyParams.element.getType() != BSONType::Array
-                                                       ? fullPath
-                                                       : applyParams.pathTaken->dottedField())) {
+        if (!checkIndexesAffected(applyParams,
+                                  applyParams.element.getType() != BSONType::Array
+                                      ? StringData(fullPath)
+                                      : applyParams.pathTaken->dottedField())) {
             applyResult.indexesAffected = false;
         }
 
@@ -34,13 +34,117 @@
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/logical_time.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(logReplacementUpdatesAsDiffs, bool, false);
+
 namespace {
 constexpr StringData kIdFieldName = "_id"_sd;
+
+/**
+ * Returns true if 'name' can be used as a top-level path in a $set or $unset oplog entry.
+ */
+bool isLoggableFieldName(StringData name) {
+    return !name.empty() && name[0] != '$' && name.find('.') == std::string::npos;
+}
+
+/**
+ * Logs the replacement of 'original' by 'replacement' as top-level $set and $unset operations when
+ * applying those operations to 'original' produces exactly 'replacement' and the resulting oplog
+ * entry is smaller than the replacement document. Returns false, without logging anything, if the
+ * whole document must be logged instead.
+ *
+ * Since $set appends new fields to the end of the document, the operations only reproduce the
+ * replacement if the fields it shares with 'original' keep their relative order and all of its new
+ * fields come after them.
+ */
+bool logReplacementAsDiff(const BSONObj& original,
+                          const BSONObj& replacement,
+                          LogBuilder* logBuilder) {
+    // Map each field of the original document to its position and value.
+    StringMap<std::pair<size_t, BSONElement>> originalFields;
+    size_t position = 0;
+    for (auto&& elem : original) {
+        auto name = elem.fieldNameStringData();
+        if (originalFields.find(name) != originalFields.end()) {
+            return false;
+        }
+        originalFields[name] = {position++, elem};
+    }
+
+    std::vector<BSONElement> sets;
+    StringMap<bool> retained;
+    size_t diffSize = 0;
+    size_t lastRetainedPosition = 0;
+    bool addedField = false;
+    for (auto&& elem : replacement) {
+        auto name = elem.fieldNameStringData();
+        if (retained.find(name) != retained.end()) {
+            return false;
+        }
+        retained[name] = true;
+
+        auto originalField = originalFields.find(name);
+        if (originalField == originalFields.end()) {
+            if (!isLoggableFieldName(name)) {
+                return false;
+            }
+            addedField = true;
+            sets.push_back(elem);
+            diffSize += elem.size();
+            continue;
+        }
+
+        // A retained field must not move relative to the other retained fields, and may not come
+        // after a field that $set would append.
+        auto originalPosition = originalField->second.first;
+        if (addedField || originalPosition < lastRetainedPosition) {
+            return false;
+        }
+        lastRetainedPosition = originalPosition;
+
+        if (!elem.binaryEqual(originalField->second.second)) {
+            if (!isLoggableFieldName(name)) {
+                return false;
+            }
+            sets.push_back(elem);
+            diffSize += elem.size();
+        }
+    }
+
+    std::vector<StringData> unsets;
+    for (auto&& elem : original) {
+        auto name = elem.fieldNameStringData();
+        if (retained.find(name) == retained.end()) {
+            if (!isLoggableFieldName(name)) {
+                return false;
+            }
+            unsets.push_back(name);
+            // Each $unset is logged as a boolean field: a type byte, the name and its terminating
+            // null, and the value byte.
+            diffSize += name.size() + 3;
+        }
+    }
+
+    if (diffSize >= static_cast<size_t>(replacement.objsize())) {
+        return false;
+    }
+
+    for (auto&& elem : sets) {
+        invariantOK(logBuilder->addToSetsWithNewFieldName(elem.fieldNameStringData(), elem));
+    }
+    for (auto&& name : unsets) {
+        invariantOK(logBuilder->addToUnsets(name));
+    }
+    invariantOK(logBuilder->setUpdateSemantics(UpdateSemantics::kUpdateNode));
+    return true;
+}
+
 }  // namespace
 
 ObjectReplaceNode::ObjectReplaceNode(BSONObj val)
@@ -142,6 +246,12 @@ UpdateNode::ApplyResult ObjectReplaceNode::apply(ApplyParams applyParams) const
         }
     }
 
+    if (applyParams.logBuilder && logReplacementUpdatesAsDiffs.load() &&
+        logReplacementAsDiff(
+            original, applyParams.element.getDocument().getObject(), applyParams.logBuilder)) {
+        return ApplyResult();
+    }
+
     if (applyParams.logBuilder) {
         auto replacementObject = applyParams.logBuilder->getDocument().end();
         invariantOK(applyParams.logBuilder->getReplacementObject(&replacementObject));
@@ -29,10 +29,17 @@
 #pragma once
 
 #include "mongo/db/update/update_node.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
 
+/**
+ * When true, a replacement that only changes a few top-level fields is logged as $set and $unset
+ * operations rather than as the whole new document.
+ */
+extern AtomicBool logReplacementUpdatesAsDiffs;
+
 /**
  * An UpdateNode representing a replacement-style update.
  */
@@ -56,7 +63,8 @@ public:
      * contain an _id, the _id from the original document is preserved. 'applyParams.element' must
      * be the root of the document. 'applyParams.pathToCreate' and 'applyParams.pathTaken' must be
      * empty. Always returns a result stating that indexes are affected when the replacement is not
-     * a noop.
+     * a noop. If 'logReplacementUpdatesAsDiffs' is set, the replacement may be logged as $set and
+     * $unset operations on the top-level fields that changed.
      */
     ApplyResult apply(ApplyParams applyParams) const final;
 
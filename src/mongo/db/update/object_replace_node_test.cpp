@@ -297,5 +297,78 @@ TEST_F(ObjectReplaceNodeTest, NoLogBuilder) {
     ASSERT_FALSE(doc.isInPlaceModeEnabled());
 }
 
+/**
+ * Enables logging replacements as diffs for the lifetime of the object.
+ */
+class LogReplacementUpdatesAsDiffsGuard {
+public:
+    LogReplacementUpdatesAsDiffsGuard() : _previous(logReplacementUpdatesAsDiffs.swap(true)) {}
+
+    ~LogReplacementUpdatesAsDiffsGuard() {
+        logReplacementUpdatesAsDiffs.store(_previous);
+    }
+
+private:
+    const bool _previous;
+};
+
+TEST_F(ObjectReplaceNodeTest, LogsChangedTopLevelFieldsAsDiff) {
+    LogReplacementUpdatesAsDiffsGuard guard;
+    auto obj = fromjson("{_id: 0, a: 2, b: 'unchanged long string value', d: 1}");
+    ObjectReplaceNode node(obj);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 'unchanged long string value', c: 1}"));
+    auto result = node.apply(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_EQUALS(fromjson("{_id: 0, a: 2, b: 'unchanged long string value', d: 1}"), doc);
+    ASSERT_EQUALS(fromjson("{$v: 1, $set: {a: 2, d: 1}, $unset: {c: true}}"), getLogDoc());
+}
+
+TEST_F(ObjectReplaceNodeTest, LogsDiffWhenPreservingIdOfExistingDocument) {
+    LogReplacementUpdatesAsDiffsGuard guard;
+    auto obj = fromjson("{a: 'unchanged long string value', b: 2}");
+    ObjectReplaceNode node(obj);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 'unchanged long string value', b: 1}"));
+    auto result = node.apply(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, a: 'unchanged long string value', b: 2}"), doc);
+    ASSERT_EQUALS(fromjson("{$v: 1, $set: {b: 2}}"), getLogDoc());
+}
+
+TEST_F(ObjectReplaceNodeTest, LogsWholeDocumentWhenRetainedFieldsAreReordered) {
+    LogReplacementUpdatesAsDiffsGuard guard;
+    auto obj = fromjson("{_id: 0, b: 'unchanged long string value', a: 1}");
+    ObjectReplaceNode node(obj);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 'unchanged long string value'}"));
+    auto result = node.apply(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, b: 'unchanged long string value', a: 1}"), getLogDoc());
+}
+
+TEST_F(ObjectReplaceNodeTest, LogsWholeDocumentWhenRetainedFieldFollowsNewField) {
+    LogReplacementUpdatesAsDiffsGuard guard;
+    auto obj = fromjson("{_id: 0, c: 1, b: 'unchanged long string value'}");
+    ObjectReplaceNode node(obj);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 'unchanged long string value'}"));
+    auto result = node.apply(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, c: 1, b: 'unchanged long string value'}"), getLogDoc());
+}
+
+TEST_F(ObjectReplaceNodeTest, LogsWholeDocumentWhenDiffIsNotSmaller) {
+    LogReplacementUpdatesAsDiffsGuard guard;
+    auto obj = fromjson("{c: 1, d: 1}");
+    ObjectReplaceNode node(obj);
+
+    mutablebson::Document doc(fromjson("{a: 1, b: 1}"));
+    auto result = node.apply(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{c: 1, d: 1}"), getLogDoc());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -209,7 +209,8 @@ ModifierNode::ModifyResult PushNode::insertElementsWithPosition(
     if (arraySize == 0) {
         invariantOK(array->pushBack(firstElementToInsert));
         result = ModifyResult::kNormalUpdate;
-    } else if (position > arraySize) {
+    } else if (position >= arraySize) {
+        // Inserting at the position just past the last element is also an append.
         invariantOK(array->pushBack(firstElementToInsert));
         result = ModifyResult::kArrayAppendUpdate;
     } else if (position > 0) {
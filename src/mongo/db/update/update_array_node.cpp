@@ -99,10 +99,9 @@ UpdateNode::ApplyResult UpdateArrayNode::apply(ApplyParams applyParams) const {
     const bool childrenShouldLogThemselves = matchingElements.size() <= 1;
 
     // Keep track of which array elements were actually modified (non-noop updates) for logging
-    // purposes. We only need to keep track of one element, since if more than one element is
-    // modified, we log the whole array.
-    boost::optional<mutablebson::Element> modifiedElement;
-    size_t nModified = 0;
+    // purposes.
+    std::vector<mutablebson::Element> modifiedElements;
+    size_t arraySize = 0;
 
     // Update array elements.
     auto applyResult = ApplyResult::noopResult();
@@ -145,33 +144,38 @@ UpdateNode::ApplyResult UpdateArrayNode::apply(ApplyParams applyParams) const {
                 applyResult.indexesAffected || childApplyResult.indexesAffected;
             applyResult.noop = applyResult.noop && childApplyResult.noop;
             if (!childApplyResult.noop) {
-                modifiedElement = childElement;
-                ++nModified;
+                modifiedElements.push_back(childElement);
             }
         }
 
         ++i;
+        ++arraySize;
     }
 
-    // If the child updates have not been logged, log the updated array elements.
-    if (!childrenShouldLogThemselves && applyParams.logBuilder) {
-        if (nModified > 1) {
+    // If the child updates have not been logged, log the updated array elements. When only a small
+    // fraction of a large array changed, logging each modified element keeps the oplog entry
+    // proportional to the size of the change rather than to the size of the array.
+    if (!childrenShouldLogThemselves && applyParams.logBuilder && !modifiedElements.empty()) {
+        if (modifiedElements.size() > 1 &&
+            modifiedElements.size() * kMinArraySizeToModifiedRatioForElementLogging > arraySize) {
 
             // Log the entire array.
             auto logElement = applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
                 applyParams.pathTaken->dottedField(), applyParams.element);
             invariant(logElement.ok());
             uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
-        } else if (nModified == 1) {
-
-            // Log the modified array element.
-            invariant(modifiedElement);
-            FieldRefTempAppend tempAppend(*(applyParams.pathTaken),
-                                          modifiedElement->getFieldName());
-            auto logElement = applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
-                applyParams.pathTaken->dottedField(), *modifiedElement);
-            invariant(logElement.ok());
-            uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
+        } else {
+
+            // Log each modified array element.
+            for (auto&& modifiedElement : modifiedElements) {
+                FieldRefTempAppend tempAppend(*(applyParams.pathTaken),
+                                              modifiedElement.getFieldName());
+                auto logElement =
+                    applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
+                        applyParams.pathTaken->dottedField(), modifiedElement);
+                invariant(logElement.ok());
+                uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
+            }
         }
     }
 
@@ -45,6 +45,12 @@ namespace mongo {
  */
 class UpdateArrayNode : public UpdateInternalNode {
 public:
+    /**
+     * When several array elements are modified, they are logged individually as long as the array
+     * has at least this many elements per modified element. Otherwise, the entire array is logged.
+     */
+    static constexpr size_t kMinArraySizeToModifiedRatioForElementLogging = 2;
+
     /**
      * Creates a new UpdateArrayNode by merging two input UpdateArrayNode objects and their
      * children. Each child that lives on one side of the merge but not the other (according to the
@@ -122,6 +122,32 @@ TEST_F(UpdateArrayNodeTest, UpdateIsAppliedToAllMatchingElements) {
     ASSERT_EQUALS(fromjson("{$set: {a: [2, 1, 2]}}"), getLogDoc());
 }
 
+TEST_F(UpdateArrayNodeTest, UpdateToFewElementsOfLargerArrayLogsEachModifiedElement) {
+    auto update = fromjson("{$set: {'a.$[i]': 2}}");
+    auto arrayFilter = fromjson("{i: 0}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    auto parsedFilter = assertGet(MatchExpressionParser::parse(arrayFilter, expCtx));
+    arrayFilters["i"] = assertGet(ExpressionWithPlaceholder::make(std::move(parsedFilter)));
+    std::set<std::string> foundIdentifiers;
+    UpdateObjectNode root;
+    ASSERT_OK(UpdateObjectNode::parseAndMerge(&root,
+                                              modifiertable::ModifierType::MOD_SET,
+                                              update["$set"]["a.$[i]"],
+                                              expCtx,
+                                              arrayFilters,
+                                              foundIdentifiers));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 1, 1, 0, 1]}"));
+    addIndexedPath("a");
+    auto result = root.apply(getApplyParams(doc.root()));
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [2, 1, 1, 1, 2, 1]}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {'a.0': 2, 'a.4': 2}}"), getLogDoc());
+}
+
 DEATH_TEST_F(UpdateArrayNodeTest,
              ArrayElementsMustNotBeDeserialized,
              "Invariant failure childElement.hasValue()") {
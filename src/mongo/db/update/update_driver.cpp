@@ -28,6 +28,7 @@
 
 #include "mongo/db/update/update_driver.h"
 
+#include <algorithm>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/string_data.h"
@@ -60,6 +61,30 @@ using pathsupport::EqualityMatches;
 
 namespace {
 
+/**
+ * Returns true if $set may overwrite a value of type 'type' in place with another value of the same
+ * type and size, without any storage validation.
+ */
+bool isInPlaceSettableType(BSONType type) {
+    switch (type) {
+        case NumberDouble:
+        case NumberInt:
+        case NumberLong:
+        case NumberDecimal:
+        case Bool:
+        case Date:
+        case jstOID:
+        case String:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+namespace {
+
 StatusWith<UpdateSemantics> updateSemanticsFromElement(BSONElement element) {
     if (element.type() != BSONType::NumberInt && element.type() != BSONType::NumberLong) {
         return {ErrorCodes::BadValue, "'$v' (UpdateSemantics) field must be an integer."};
@@ -192,9 +217,47 @@ Status UpdateDriver::parse(
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
     _root = std::move(root);
 
+    if (!_positional && arrayFilters.empty()) {
+        collectInPlaceMods(updateExpr);
+    }
+
     return Status::OK();
 }
 
+void UpdateDriver::collectInPlaceMods(const BSONObj& updateExpr) {
+    // 'updateExpr' has already been parsed successfully, so each modifier's argument is an object
+    // and no two modifications conflict.
+    std::vector<InPlaceMod> mods;
+    for (auto&& modifier : updateExpr) {
+        const StringData modifierName = modifier.fieldNameStringData();
+        if (modifierName == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        const bool isInc = (modifierName == "$inc");
+        if (!isInc && modifierName != "$set") {
+            return;
+        }
+
+        for (auto&& field : modifier.embeddedObject()) {
+            const StringData fieldName = field.fieldNameStringData();
+            if (fieldName.empty() || fieldName[0] == '$' ||
+                fieldName.find('.') != std::string::npos || fieldName == "_id") {
+                return;
+            }
+            if (isInc ? !field.isNumber() : !isInPlaceSettableType(field.type())) {
+                return;
+            }
+            mods.push_back({fieldName.toString(), isInc, field});
+        }
+    }
+
+    std::sort(mods.begin(), mods.end(), [](const InPlaceMod& lhs, const InPlaceMod& rhs) {
+        return lhs.fieldName < rhs.fieldName;
+    });
+    _inPlaceMods = std::move(mods);
+}
+
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
                                                      const BSONObj& query,
                                                      const FieldRefSet& immutablePaths,
@@ -254,6 +317,7 @@ Status UpdateDriver::update(StringData matchedField,
     // TODO: assert that update() is called at most once in a !_multi case.
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _affectedIndexes.reset();
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -264,6 +328,7 @@ Status UpdateDriver::update(StringData matchedField,
     applyParams.fromOplogApplication = _fromOplogApplication;
     applyParams.validateForStorage = validateForStorage;
     applyParams.indexData = _indexedFields;
+    applyParams.affectedIndexes = &_affectedIndexes;
     if (_logOp && logOpRec) {
         applyParams.logBuilder = &logBuilder;
     }
@@ -272,6 +337,10 @@ Status UpdateDriver::update(StringData matchedField,
         _affectIndices = true;
         doc->disableInPlaceUpdates();
     }
+    if (_affectIndices && (isDocReplacement() || _affectedIndexes.none())) {
+        // A replacement may change any indexed field.
+        _affectedIndexes.set();
+    }
     if (docWasModified) {
         *docWasModified = !applyResult.noop;
     }
@@ -295,6 +364,117 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateInPlace(const BSONObj& original,
+                                 const FieldRefSet& immutablePaths,
+                                 mutablebson::DamageVector* damages,
+                                 const char** source,
+                                 BSONObj* logOpRec,
+                                 bool* docWasModified) {
+    if (_inPlaceMods.empty()) {
+        return false;
+    }
+
+    // The caller adds or moves _id when it is not the first field, which changes the layout.
+    if (original.firstElement().fieldNameStringData() != "_id") {
+        return false;
+    }
+
+    for (auto&& mod : _inPlaceMods) {
+        if (_indexedFields && _indexedFields->mightBeIndexed(mod.fieldName)) {
+            return false;
+        }
+        for (auto&& immutablePath : immutablePaths) {
+            if (immutablePath->getPart(0) == mod.fieldName) {
+                return false;
+            }
+        }
+    }
+
+    // Find the first field with each targeted name in a single pass over the document.
+    _inPlaceTargets.assign(_inPlaceMods.size(), BSONElement());
+    size_t numFound = 0;
+    for (auto&& elem : original) {
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _inPlaceMods.size(); ++i) {
+            if (_inPlaceTargets[i].eoo() && fieldName == _inPlaceMods[i].fieldName) {
+                _inPlaceTargets[i] = elem;
+                ++numFound;
+                break;
+            }
+        }
+        if (numFound == _inPlaceMods.size()) {
+            break;
+        }
+    }
+    if (numFound != _inPlaceMods.size()) {
+        return false;
+    }
+
+    // Compute the new values with the same no-op rules as SetNode and ArithmeticNode, keeping only
+    // the targets of the modifications which are not no-ops.
+    BSONObjBuilder newValues;
+    size_t numModified = 0;
+    for (size_t i = 0; i < _inPlaceMods.size(); ++i) {
+        const InPlaceMod& mod = _inPlaceMods[i];
+        const BSONElement target = _inPlaceTargets[i];
+        if (mod.isInc) {
+            if (!target.isNumber()) {
+                return false;
+            }
+            SafeNum originalValue(target);
+            SafeNum valueToSet(mod.value);
+            valueToSet += originalValue;
+            if (valueToSet.isIdentical(originalValue)) {
+                continue;
+            }
+            if (!valueToSet.isValid() || valueToSet.type() != target.type()) {
+                return false;
+            }
+            valueToSet.toBSON(mod.fieldName, &newValues);
+        } else {
+            if (target.binaryEqualValues(mod.value)) {
+                continue;
+            }
+            if (target.type() != mod.value.type() || target.valuesize() != mod.value.valuesize()) {
+                return false;
+            }
+            newValues.appendAs(mod.value, mod.fieldName);
+        }
+        _inPlaceTargets[numModified++] = target;
+    }
+    _inPlaceSource = newValues.obj();
+
+    damages->clear();
+    size_t i = 0;
+    for (auto&& newValue : _inPlaceSource) {
+        const BSONElement& target = _inPlaceTargets[i++];
+        mutablebson::DamageEvent damage;
+        damage.sourceOffset = newValue.value() - _inPlaceSource.objdata();
+        damage.targetOffset = target.value() - original.objdata();
+        damage.size = target.valuesize();
+        damages->push_back(damage);
+    }
+    *source = _inPlaceSource.objdata();
+
+    _affectIndices = false;
+    _affectedIndexes.reset();
+    if (docWasModified) {
+        *docWasModified = (numModified > 0);
+    }
+    if (_logOp && logOpRec) {
+        // Matches the entry update() logs: a $v field followed by a $set of each modified field.
+        BSONObjBuilder logBuilder;
+        logBuilder.append(LogBuilder::kUpdateSemanticsFieldName,
+                          static_cast<int>(UpdateSemantics::kUpdateNode));
+        if (numModified > 0) {
+            logBuilder.append("$set", _inPlaceSource);
+        }
+        *logOpRec = logBuilder.obj();
+    }
+
+    return true;
+}
+
 bool UpdateDriver::isDocReplacement() const {
     return _replacementMode;
 }
@@ -303,6 +483,10 @@ bool UpdateDriver::modsAffectIndices() const {
     return _affectIndices;
 }
 
+const UpdateIndexData::IndexSet& UpdateDriver::getAffectedIndexes() const {
+    return _affectedIndexes;
+}
+
 void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
@@ -102,6 +102,24 @@ public:
                   BSONObj* logOpRec = nullptr,
                   bool* docWasModified = nullptr);
 
+    /**
+     * Tries to apply the update directly to the serialized 'original' document, without building a
+     * mutable document. This only succeeds when the update consists of $set and $inc on existing,
+     * non-indexed, top-level fields of a document whose first field is _id, and every new value
+     * has the same type and size as the value it replaces.
+     *
+     * On success, returns true, fills 'damages' with the byte ranges to overwrite in 'original'
+     * from the buffer pointed to by '*source', and sets 'logOpRec' and 'docWasModified' as
+     * update() would. The source buffer remains valid until the next call on this driver. Returns
+     * false if the caller must fall back to update().
+     */
+    bool updateInPlace(const BSONObj& original,
+                       const FieldRefSet& immutablePaths,
+                       mutablebson::DamageVector* damages,
+                       const char** source,
+                       BSONObj* logOpRec = nullptr,
+                       bool* docWasModified = nullptr);
+
     //
     // Accessors
     //
@@ -110,6 +128,13 @@ public:
     static bool isDocReplacement(const BSONObj& updateExpr);
 
     bool modsAffectIndices() const;
+
+    /**
+     * Returns the indexes, as numbered by the UpdateIndexData given to refreshIndexKeys(), whose
+     * keys the last update() may have changed. Only meaningful if modsAffectIndices() is true.
+     */
+    const UpdateIndexData::IndexSet& getAffectedIndexes() const;
+
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
     bool logOp() const;
@@ -145,6 +170,18 @@ private:
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    /**
+     * Fills '_inPlaceMods' if 'updateExpr' is eligible for updateInPlace().
+     */
+    void collectInPlaceMods(const BSONObj& updateExpr);
+
+    // A top-level $set or $inc which updateInPlace() may apply to the serialized document.
+    struct InPlaceMod {
+        std::string fieldName;
+        bool isInc;
+        BSONElement value;  // Points into the update expression.
+    };
+
     //
     // immutable properties after parsing
     //
@@ -156,6 +193,10 @@ private:
     // The root of the UpdateNode tree.
     std::unique_ptr<UpdateNode> _root;
 
+    // The modifications of an update eligible for updateInPlace(), sorted by field name, which is
+    // the order the UpdateNode tree applies and logs them in. Empty if the update is not eligible.
+    std::vector<InPlaceMod> _inPlaceMods;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
@@ -178,6 +219,10 @@ private:
     // at each call to update.
     bool _affectIndices = false;
 
+    // Which indexes the mods may affect, valid when '_affectIndices' is true. Is set anew at each
+    // call to update.
+    UpdateIndexData::IndexSet _affectedIndexes;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional = false;
 
@@ -189,6 +234,11 @@ private:
 
     // The document used to build the oplog entry for the update.
     mutablebson::Document _logDoc;
+
+    // Scratch space for updateInPlace(): the elements its modifications target, and the new values
+    // its damages are copied from.
+    std::vector<BSONElement> _inPlaceTargets;
+    BSONObj _inPlaceSource;
 };
 
 }  // namespace mongo
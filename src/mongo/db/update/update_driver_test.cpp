@@ -29,6 +29,7 @@
 #include "mongo/db/update/update_driver.h"
 
 
+#include <cstring>
 #include <map>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -156,6 +157,117 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+//
+// Tests of applying simple updates directly to the serialized document
+//
+
+/**
+ * Applies 'update' to 'original' with updateInPlace() and checks that it succeeds and produces the
+ * same document, oplog entry and modified flag as update().
+ */
+void assertUpdateInPlaceMatchesUpdate(const BSONObj& original, const BSONObj& update) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    const FieldRefSet emptyImmutablePaths;
+
+    UpdateDriver driver(expCtx);
+    driver.setLogOp(true);
+    ASSERT_OK(driver.parse(update, arrayFilters));
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    BSONObj inPlaceLog;
+    bool inPlaceModified = false;
+    ASSERT_TRUE(driver.updateInPlace(
+        original, emptyImmutablePaths, &damages, &source, &inPlaceLog, &inPlaceModified));
+    ASSERT_FALSE(driver.modsAffectIndices());
+
+    std::string updated(original.objdata(), original.objsize());
+    for (auto&& damage : damages) {
+        std::memcpy(&updated[damage.targetOffset], source + damage.sourceOffset, damage.size);
+    }
+
+    mutablebson::Document doc(original);
+    BSONObj log;
+    bool modified = false;
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths, &log, &modified));
+
+    ASSERT_BSONOBJ_EQ(doc.getObject(), BSONObj(updated.data()));
+    ASSERT_BSONOBJ_EQ(log, inPlaceLog);
+    ASSERT_EQ(modified, inPlaceModified);
+    ASSERT_EQ(modified, !damages.empty());
+}
+
+/**
+ * Returns whether updateInPlace() accepts 'update' applied to 'original'.
+ */
+bool updateInPlaceApplies(const BSONObj& original,
+                          const BSONObj& update,
+                          const UpdateIndexData* indexData = nullptr,
+                          const FieldRefSet& immutablePaths = FieldRefSet()) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    UpdateDriver driver(expCtx);
+    ASSERT_OK(driver.parse(update, arrayFilters));
+    driver.refreshIndexKeys(indexData);
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    return driver.updateInPlace(original, immutablePaths, &damages, &source);
+}
+
+TEST(UpdateInPlace, IncAndSetSameSizeValues) {
+    assertUpdateInPlaceMatchesUpdate(
+        fromjson("{_id: 1, a: 1, b: 'xyz', c: 2.5, d: {e: 1}, f: NumberLong(7)}"),
+        fromjson("{$inc: {f: 3, a: 5, c: -1}, $set: {b: 'abc'}}"));
+}
+
+TEST(UpdateInPlace, NoOpUpdates) {
+    assertUpdateInPlaceMatchesUpdate(fromjson("{_id: 1, a: 1, b: 'xyz'}"),
+                                     fromjson("{$inc: {a: 0}, $set: {b: 'xyz'}}"));
+}
+
+TEST(UpdateInPlace, PartialNoOp) {
+    assertUpdateInPlaceMatchesUpdate(fromjson("{_id: 1, a: 1, b: true}"),
+                                     fromjson("{$set: {a: 1, b: false}}"));
+}
+
+TEST(UpdateInPlace, FallsBackWhenLayoutChanges) {
+    const BSONObj original = fromjson("{_id: 1, a: 2147483647, b: 'xyz', c: 1}");
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$inc: {a: 1}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$inc: {c: 0.5}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {b: 'abcd'}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {c: 'x'}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$inc: {b: 1}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {missing: 1}}")));
+}
+
+TEST(UpdateInPlace, FallsBackForUnsupportedUpdates) {
+    const BSONObj original = fromjson("{_id: 1, a: 1, b: {c: 1}}");
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {'b.c': 2}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {b: {c: 2}}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$set: {a: 2}, $unset: {b: 1}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$mul: {a: 2}}")));
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{a: 2}")));
+    ASSERT_FALSE(updateInPlaceApplies(fromjson("{a: 1, _id: 1}"), fromjson("{$set: {a: 2}}")));
+}
+
+TEST(UpdateInPlace, FallsBackForIndexedAndImmutableFields) {
+    const BSONObj original = fromjson("{_id: 1, a: 1, b: 1}");
+    UpdateIndexData indexData;
+    indexData.addPath("a.x");
+    ASSERT_FALSE(updateInPlaceApplies(original, fromjson("{$inc: {a: 1}}"), &indexData));
+    ASSERT_TRUE(updateInPlaceApplies(original, fromjson("{$inc: {b: 1}}"), &indexData));
+
+    FieldRef shardKeyPath("b.c");
+    FieldRefSet immutablePaths;
+    immutablePaths.insert(&shardKeyPath);
+    ASSERT_FALSE(
+        updateInPlaceApplies(original, fromjson("{$inc: {b: 1}}"), nullptr, immutablePaths));
+    ASSERT_TRUE(
+        updateInPlaceApplies(original, fromjson("{$inc: {a: 1}}"), nullptr, immutablePaths));
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
@@ -119,6 +119,9 @@ public:
         // Used to determine whether indexes are affected.
         const UpdateIndexData* indexData = nullptr;
 
+        // If provided, UpdateNode::apply will add the indexes affected by the update here.
+        UpdateIndexData::IndexSet* affectedIndexes = nullptr;
+
         // If provided, UpdateNode::apply will log the update here.
         LogBuilder* logBuilder = nullptr;
     };
@@ -31,81 +31,179 @@
 #include "mongo/db/update_index_data.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
 using std::string;
 
-UpdateIndexData::UpdateIndexData() : _allPathsIndexed(false) {}
+UpdateIndexData::UpdateIndexData() = default;
 
 void UpdateIndexData::addPath(StringData path) {
-    string s;
-    if (getCanonicalIndexField(path, &s)) {
-        _canonicalPaths.insert(s);
-    } else {
-        _canonicalPaths.insert(path.toString());
-    }
+    _addPath(path, IndexSet().set());
+}
+
+void UpdateIndexData::addPath(StringData path, StringData indexName) {
+    _addPath(path, _indexSetFor(indexName));
 }
 
 void UpdateIndexData::addPathComponent(StringData pathComponent) {
-    _pathComponents.insert(pathComponent.toString());
+    _addPathComponent(pathComponent, IndexSet().set());
+}
+
+void UpdateIndexData::addPathComponent(StringData pathComponent, StringData indexName) {
+    _addPathComponent(pathComponent, _indexSetFor(indexName));
 }
 
 void UpdateIndexData::allPathsIndexed() {
-    _allPathsIndexed = true;
+    _allPathsIndexes.set();
+}
+
+void UpdateIndexData::allPathsIndexed(StringData indexName) {
+    _allPathsIndexes |= _indexSetFor(indexName);
 }
 
 void UpdateIndexData::clear() {
-    _canonicalPaths.clear();
+    _root.indexesAtPath.reset();
+    _root.indexesAtOrBelowPath.reset();
+    _root.children.clear();
     _pathComponents.clear();
-    _allPathsIndexed = false;
+    _allPathsIndexes.reset();
+    _indexOrdinals.clear();
 }
 
 bool UpdateIndexData::mightBeIndexed(StringData path) const {
-    if (_allPathsIndexed) {
-        return true;
+    return getAffectedIndexes(path).any();
+}
+
+UpdateIndexData::IndexSet UpdateIndexData::getAffectedIndexes(StringData path) const {
+    IndexSet affected = _allPathsIndexes;
+    if (path.empty()) {
+        return affected;
     }
 
-    StringData use = path;
-    string x;
-    if (getCanonicalIndexField(path, &x))
-        use = StringData(x);
+    FieldRef pathFieldRef(path);
 
-    for (std::set<string>::const_iterator i = _canonicalPaths.begin(); i != _canonicalPaths.end();
-         ++i) {
-        StringData idx(*i);
+    // Walk down the trie along the canonical form of 'path'. Every index on a prefix of 'path' is
+    // affected, and if the whole path is found, so is every index on the path or a path below it.
+    const PathNode* node = &_root;
+    for (size_t partIdx = 0; partIdx < pathFieldRef.numParts() && node; ++partIdx) {
+        if (_isSkippedPart(pathFieldRef, partIdx)) {
+            continue;
+        }
 
-        if (_startsWith(use, idx))
-            return true;
+        const StringData part = pathFieldRef.getPart(partIdx);
+        const PathNode* child = nullptr;
+        for (auto&& entry : node->children) {
+            if (entry.first == part) {
+                child = entry.second.get();
+                break;
+            }
+        }
 
-        if (_startsWith(idx, use))
-            return true;
+        node = child;
+        if (node) {
+            affected |= node->indexesAtPath;
+        }
+    }
+    if (node) {
+        affected |= node->indexesAtOrBelowPath;
     }
 
-    FieldRef pathFieldRef(path);
-    for (std::set<string>::const_iterator i = _pathComponents.begin(); i != _pathComponents.end();
-         ++i) {
-        const string& pathComponent = *i;
+    for (auto&& pathComponent : _pathComponents) {
         for (size_t partIdx = 0; partIdx < pathFieldRef.numParts(); ++partIdx) {
-            if (pathComponent == pathFieldRef.getPart(partIdx)) {
-                return true;
+            if (pathComponent.first == pathFieldRef.getPart(partIdx)) {
+                affected |= pathComponent.second;
+                break;
             }
         }
     }
 
-    return false;
+    return affected;
 }
 
-bool UpdateIndexData::_startsWith(StringData a, StringData b) const {
-    if (!a.startsWith(b))
-        return false;
+bool UpdateIndexData::isIndexAffected(const IndexSet& affectedIndexes,
+                                      StringData indexName) const {
+    auto it = _indexOrdinals.find(indexName);
+    if (it == _indexOrdinals.end()) {
+        return true;
+    }
+    return affectedIndexes.test(it->second);
+}
 
-    // make sure there is a dot or EOL right after
+UpdateIndexData::IndexSet UpdateIndexData::_indexSetFor(StringData indexName) {
+    auto it = _indexOrdinals.find(indexName);
+    if (it == _indexOrdinals.end()) {
+        if (_indexOrdinals.size() >= kMaxTrackedIndexes) {
+            // Leave the index unregistered, which makes isIndexAffected() treat it as affected by
+            // any update that affects some index.
+            return IndexSet().set();
+        }
+        const size_t ordinal = _indexOrdinals.size();
+        _indexOrdinals[indexName] = ordinal;
+        return IndexSet().set(ordinal);
+    }
+    return IndexSet().set(it->second);
+}
 
-    if (a.size() == b.size())
-        return true;
+void UpdateIndexData::_addPath(StringData path, const IndexSet& indexes) {
+    FieldRef pathFieldRef(path);
+
+    PathNode* node = &_root;
+    node->indexesAtOrBelowPath |= indexes;
+    for (size_t partIdx = 0; partIdx < pathFieldRef.numParts(); ++partIdx) {
+        if (_isSkippedPart(pathFieldRef, partIdx)) {
+            continue;
+        }
 
-    return a[b.size()] == '.';
+        const StringData part = pathFieldRef.getPart(partIdx);
+        PathNode* child = nullptr;
+        for (auto&& entry : node->children) {
+            if (entry.first == part) {
+                child = entry.second.get();
+                break;
+            }
+        }
+        if (!child) {
+            node->children.emplace_back(part.toString(), stdx::make_unique<PathNode>());
+            child = node->children.back().second.get();
+        }
+
+        node = child;
+        node->indexesAtOrBelowPath |= indexes;
+    }
+    node->indexesAtPath |= indexes;
+}
+
+void UpdateIndexData::_addPathComponent(StringData pathComponent, const IndexSet& indexes) {
+    for (auto&& entry : _pathComponents) {
+        if (entry.first == pathComponent) {
+            entry.second |= indexes;
+            return;
+        }
+    }
+    _pathComponents.emplace_back(pathComponent.toString(), indexes);
+}
+
+bool UpdateIndexData::_isSkippedPart(const FieldRef& path, size_t partIdx) {
+    // Matches getCanonicalIndexField(), which drops "$" and all-digit parts other than the first.
+    if (partIdx == 0) {
+        return false;
+    }
+
+    const StringData part = path.getPart(partIdx);
+    if (part.empty()) {
+        return false;
+    }
+    if (part == "$") {
+        return true;
+    }
+    for (char c : part) {
+        if (!isdigit(c)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool getCanonicalIndexField(StringData fullName, string* out) {
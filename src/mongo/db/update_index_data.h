@@ -30,12 +30,20 @@
 
 #pragma once
 
-#include <set>
+#include <bitset>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
+class FieldRef;
+
 /**
  * a.$ -> a
  * @return true if out is set and we made a change
@@ -46,39 +54,97 @@ bool getCanonicalIndexField(StringData fullName, std::string* out);
 /**
  * Holds pre-processed index spec information to allow update to quickly determine if an update
  * can be applied as a delta to a document, or if the document must be re-indexed.
+ *
+ * Indexed paths are kept in a trie of path components, where each node records which indexes
+ * index the path ending there and which index it or any path below it. This lets an update
+ * compute exactly which indexes a modified path affects in a single walk down the trie.
  */
 class UpdateIndexData {
+    MONGO_DISALLOW_COPYING(UpdateIndexData);
+
 public:
+    /**
+     * The most indexes which can be tracked individually. Indexes beyond this are treated as
+     * affected by every update that affects any index.
+     */
+    static constexpr size_t kMaxTrackedIndexes = 64;
+
+    /**
+     * A set of indexes, where bit 'i' is the 'i'th index registered with this UpdateIndexData.
+     */
+    using IndexSet = std::bitset<kMaxTrackedIndexes>;
+
     UpdateIndexData();
 
     /**
      * Register a path.  Any update targeting this path (or a parent of this path) will
      * trigger a recomputation of the document's index keys.
+     *
+     * If 'indexName' is given, only the keys of that index need to be recomputed. Otherwise the
+     * keys of every index do.
      */
     void addPath(StringData path);
+    void addPath(StringData path, StringData indexName);
 
     /**
      * Register a path component.  Any update targeting a path that contains this exact
      * component will trigger a recomputation of the document's index keys.
      */
     void addPathComponent(StringData pathComponent);
+    void addPathComponent(StringData pathComponent, StringData indexName);
 
     /**
      * Register the "wildcard" path.  All updates will trigger a recomputation of the document's
      * index keys.
      */
     void allPathsIndexed();
+    void allPathsIndexed(StringData indexName);
 
     void clear();
 
     bool mightBeIndexed(StringData path) const;
 
+    /**
+     * Returns the set of indexes whose keys an update to 'path' may change. Indexes registered
+     * without a name are represented by every bit of the set.
+     */
+    IndexSet getAffectedIndexes(StringData path) const;
+
+    /**
+     * Returns true if 'affectedIndexes', as returned by getAffectedIndexes(), includes the index
+     * named 'indexName'. Indexes which were never registered by name are always affected.
+     */
+    bool isIndexAffected(const IndexSet& affectedIndexes, StringData indexName) const;
+
 private:
-    bool _startsWith(StringData a, StringData b) const;
+    struct PathNode {
+        // Indexes which index the path ending at this node.
+        IndexSet indexesAtPath;
+
+        // Indexes which index the path ending at this node or any path below it.
+        IndexSet indexesAtOrBelowPath;
+
+        std::vector<std::pair<std::string, std::unique_ptr<PathNode>>> children;
+    };
+
+    /**
+     * Returns the set containing only the index named 'indexName', registering it if needed.
+     */
+    IndexSet _indexSetFor(StringData indexName);
+
+    void _addPath(StringData path, const IndexSet& indexes);
+    void _addPathComponent(StringData pathComponent, const IndexSet& indexes);
+
+    /**
+     * Returns true if the 'partIdx'th part of 'path' is skipped by getCanonicalIndexField().
+     */
+    static bool _isSkippedPart(const FieldRef& path, size_t partIdx);
 
-    std::set<std::string> _canonicalPaths;
-    std::set<std::string> _pathComponents;
+    PathNode _root;
+    std::vector<std::pair<std::string, IndexSet>> _pathComponents;
+    IndexSet _allPathsIndexes;
 
-    bool _allPathsIndexed;
+    // Maps the name of each index registered by name to its bit in an IndexSet.
+    StringMap<size_t> _indexOrdinals;
 };
 }
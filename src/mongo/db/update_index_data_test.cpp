@@ -92,6 +92,67 @@ TEST(UpdateIndexDataTest, AllPathsIndexed2) {
     ASSERT_FALSE(a.mightBeIndexed("a"));
 }
 
+TEST(UpdateIndexDataTest, AffectedIndexesByPath) {
+    UpdateIndexData a;
+    a.addPath("a.b", "a.b_1");
+    a.addPath("a.c", "a.c_1");
+    a.addPath("d", "d_1_a.b_1");
+    a.addPath("a.b", "d_1_a.b_1");
+
+    auto affected = a.getAffectedIndexes("a.b.x");
+    ASSERT_TRUE(a.isIndexAffected(affected, "a.b_1"));
+    ASSERT_FALSE(a.isIndexAffected(affected, "a.c_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "d_1_a.b_1"));
+
+    affected = a.getAffectedIndexes("a.1.c");
+    ASSERT_FALSE(a.isIndexAffected(affected, "a.b_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "a.c_1"));
+    ASSERT_FALSE(a.isIndexAffected(affected, "d_1_a.b_1"));
+
+    affected = a.getAffectedIndexes("a");
+    ASSERT_TRUE(a.isIndexAffected(affected, "a.b_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "a.c_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "d_1_a.b_1"));
+
+    affected = a.getAffectedIndexes("d");
+    ASSERT_FALSE(a.isIndexAffected(affected, "a.b_1"));
+    ASSERT_FALSE(a.isIndexAffected(affected, "a.c_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "d_1_a.b_1"));
+
+    ASSERT_TRUE(a.getAffectedIndexes("e").none());
+    ASSERT_TRUE(a.getAffectedIndexes("a.d").none());
+
+    // Indexes which were never registered are always affected.
+    ASSERT_TRUE(a.isIndexAffected(UpdateIndexData::IndexSet(), "e_1"));
+}
+
+TEST(UpdateIndexDataTest, AffectedIndexesByComponentAndWildcard) {
+    UpdateIndexData a;
+    a.addPath("a", "a_1");
+    a.addPathComponent("language", "text");
+    a.allPathsIndexed("wildcardText");
+
+    auto affected = a.getAffectedIndexes("b.language");
+    ASSERT_FALSE(a.isIndexAffected(affected, "a_1"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "text"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "wildcardText"));
+
+    affected = a.getAffectedIndexes("b");
+    ASSERT_FALSE(a.isIndexAffected(affected, "a_1"));
+    ASSERT_FALSE(a.isIndexAffected(affected, "text"));
+    ASSERT_TRUE(a.isIndexAffected(affected, "wildcardText"));
+}
+
+TEST(UpdateIndexDataTest, UnnamedPathsAffectAllIndexes) {
+    UpdateIndexData a;
+    a.addPath("a", "a_1");
+    a.addPath("b");
+
+    auto affected = a.getAffectedIndexes("b");
+    ASSERT_TRUE(a.isIndexAffected(affected, "a_1"));
+    ASSERT_TRUE(a.mightBeIndexed("b"));
+}
+
 TEST(UpdateIndexDataTest, getCanonicalIndexField1) {
     string x;
 
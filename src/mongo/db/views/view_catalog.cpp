@@ -84,6 +84,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _resolvedViews.clear();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -159,8 +160,10 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
+        this->_resolvedViews.clear();
         this->_viewGraphNeedsRefresh = true;
     });
 
@@ -335,6 +338,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     return _createOrUpdateView_inlock(
@@ -362,9 +366,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -404,6 +410,24 @@ std::shared_ptr<ViewDefinition> ViewCatalog::lookup(OperationContext* opCtx, Str
 StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                                                   const NamespaceString& nss) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // An invalid catalog is reloaded by the lookups below, which also clears the resolved views.
+    if (_valid.load()) {
+        auto it = _resolvedViews.find(nss.ns());
+        if (it != _resolvedViews.end()) {
+            return it->second;
+        }
+    }
+
+    auto resolved = _resolveView_inlock(opCtx, nss);
+    if (resolved.isOK() && _valid.load() && resolved.getValue().getNamespace() != nss) {
+        _resolvedViews.emplace(nss.ns(), resolved.getValue());
+    }
+    return resolved;
+}
+
+StatusWith<ResolvedView> ViewCatalog::_resolveView_inlock(OperationContext* opCtx,
+                                                          const NamespaceString& nss) {
     const NamespaceString* resolvedNss = &nss;
     std::vector<BSONObj> resolvedPipeline;
     BSONObj collation;
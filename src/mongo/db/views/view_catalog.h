@@ -163,6 +163,8 @@ private:
                                      const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup_inlock(OperationContext* opCtx, StringData ns);
+    StatusWith<ResolvedView> _resolveView_inlock(OperationContext* opCtx,
+                                                 const NamespaceString& nss);
     Status _reloadIfNeeded_inlock(OperationContext* opCtx);
 
     void _requireValidCatalog_inlock(OperationContext* opCtx) {
@@ -172,6 +174,11 @@ private:
 
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+
+    // Views that resolveView() has already resolved, by view namespace. Cleared whenever a view
+    // definition changes, because a change to one view changes every view defined on top of it.
+    StringMap<ResolvedView> _resolvedViews;
+
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
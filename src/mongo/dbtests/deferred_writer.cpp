@@ -370,6 +370,33 @@ private:
     static const int kDocsPerWorker = 100;
 };
 
+/**
+ * Test that inserts into other namespaces create missing collections, but not missing databases.
+ */
+class DeferredWriterTestOtherNamespaces : public DeferredWriterTestBase {
+public:
+    void run(void) {
+        const NamespaceString otherNss("unittests", "deferred_writer_tests_other");
+        const NamespaceString missingDbNss("deferred_writer_tests_missing_db", "coll");
+        ensureEmpty();
+        if (AutoGetCollection(_opCtx.get(), otherNss, MODE_IS).getCollection()) {
+            _client.dropCollection(otherNss.toString());
+        }
+
+        {
+            auto gw = getWriter();
+            auto writer = gw.get();
+            ASSERT_TRUE(writer->insertDocument(otherNss, getObj()));
+            ASSERT_TRUE(writer->insertDocument(otherNss, getObj()));
+            ASSERT_TRUE(writer->insertDocument(missingDbNss, getObj()));
+        }
+
+        ASSERT_EQ(0U, readCollection().size());
+        ASSERT_EQ(2U, _client.count(otherNss.ns()));
+        ASSERT_FALSE(AutoGetDb(_opCtx.get(), missingDbNss.db(), MODE_IS).getDb());
+    }
+};
+
 class DeferredWriterTests : public Suite {
 public:
     DeferredWriterTests() : Suite("deferred_writer_tests") {}
@@ -381,6 +408,7 @@ public:
         add<DeferredWriterTestNoDeadlock>();
         add<DeferredWriterTestCap>();
         add<DeferredWriterTestAsync>();
+        add<DeferredWriterTestOtherNamespaces>();
     }
 } deferredWriterTests;
 }
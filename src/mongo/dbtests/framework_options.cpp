@@ -101,6 +101,12 @@ Status addTestFrameworkOptions(moe::OptionSection* options) {
     options->addOptionChaining(
         "perfHist", "perfHist", moe::Unsigned, "number of back runs of perf stats to display");
 
+    options->addOptionChaining("perfResultsFile",
+                               "perfResultsFile",
+                               moe::String,
+                               "file to which perf tests append their results, one JSON document "
+                               "per line");
+
     options
         ->addOptionChaining(
             "storage.engine", "storageEngine", moe::String, "what storage engine to use")
@@ -162,6 +168,10 @@ Status storeTestFrameworkOptions(const moe::Environment& params,
         frameworkGlobalParams.perfHist = params["perfHist"].as<unsigned>();
     }
 
+    if (params.count("perfResultsFile")) {
+        frameworkGlobalParams.perfResultsFile = params["perfResultsFile"].as<string>();
+    }
+
     bool nodur = false;
     if (params.count("nodur")) {
         nodur = true;
@@ -2420,6 +2420,22 @@ class QuoteTest6 : public Base {
     }
 };
 
+class ConsecutiveStringValues : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", "a much longer value with an \"escape\" in it");
+        b.append("b", "short");
+        b.append("c", "");
+        b.append("d", -12);
+        b.append("e", "tab\tend");
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ a : \"a much longer value with an \\\"escape\\\" in it\","
+               " b : 'short', c : \"\", d :  -12, e : \"tab\\tend\" }";
+    }
+};
+
 class ObjectId : public Base {
     virtual BSONObj bson() const {
         OID id;
@@ -2934,6 +2950,7 @@ public:
         add<FromJsonTests::QuoteTest4>();
         add<FromJsonTests::QuoteTest5>();
         add<FromJsonTests::QuoteTest6>();
+        add<FromJsonTests::ConsecutiveStringValues>();
         add<FromJsonTests::ObjectId>();
         add<FromJsonTests::ObjectId2>();
         add<FromJsonTests::NumericIntMin>();
@@ -34,7 +34,9 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/oplog_hack.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace OplogStartTests {
 
@@ -398,6 +400,46 @@ class OplogStartEOF : public SizedExtentHopBase {
     }
 };
 
+/**
+ * The record store of an oplog seeks close to the entry at a timestamp without the OplogStart
+ * stage, and never past it.
+ */
+class OplogStartHackSeeksAtOrBeforeStart {
+public:
+    void run() {
+        const NamespaceString oplogNss("local.oplog.oplogstarttests");
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::GlobalWrite lk(&opCtx);
+        DBDirectClient client(&opCtx);
+
+        ON_BLOCK_EXIT([&] { client.dropCollection(oplogNss.ns()); });
+        ASSERT(client.createCollection(oplogNss.ns(), 16 * 1024 * 1024, true));
+
+        // Insert 8MB of entries, so that the record store samples several of them.
+        const string payload(8 * 1024, 'a');
+        for (int i = 1; i <= 1000; ++i) {
+            client.insert(oplogNss.ns(), BSON("ts" << Timestamp(1000, i) << "payload" << payload));
+        }
+
+        OldClientContext context(&opCtx, oplogNss.ns());
+        RecordStore* rs = context.db()->getCollection(&opCtx, oplogNss)->getRecordStore();
+        const Timestamp target(1000, 500);
+        auto start = rs->oplogStartHack(&opCtx, oploghack::keyForOptime(target).getValue());
+
+        if (getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+            ASSERT(start);
+        }
+        if (start) {
+            ASSERT(!start->isNull());
+            const Timestamp startTs = rs->dataFor(&opCtx, *start).toBson()["ts"].timestamp();
+            ASSERT_LTE(startTs, target);
+            // The start is no more than a sample interval of 1MB before the target.
+            ASSERT_GT(startTs, Timestamp(1000, 500 - 130));
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("oplogstart") {}
@@ -405,6 +447,7 @@ public:
     void setupTests() {
         add<OplogStartIsOldest>();
         add<OplogStartIsNewest>();
+        add<OplogStartHackSeeksAtOrBeforeStart>();
 
         // These tests rely on extent allocation details specific to mmapv1.
         // TODO figure out a way to generically test this.
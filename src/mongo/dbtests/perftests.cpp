@@ -0,0 +1,531 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Performance tests which run storage engine level workloads directly, through the Collection API
+ * and the query execution stages, against the storage engine chosen with --storageEngine. Each test
+ * reports its throughput as a JSON document on a line of its own, so that runs against different
+ * commits or storage engines can be compared. These tests are built into the perftest binary
+ * rather than dbtest, for example:
+ *
+ *     ./perftest --storageEngine=wiredTiger --perfResultsFile=perf.json [suite]...
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/sort.h"
+#include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/dbtests/framework_options.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/timer.h"
+#include "mongo/util/version.h"
+
+namespace PerfTests {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+static const NamespaceString nss("unittests.perftests");
+
+// Each test repeats its workload for at least this long.
+const int kMinRunMillis = 2000;
+
+// The number of documents in the collection for the tests which read or modify existing data.
+const int kNumDocs = 10000;
+
+/**
+ * Base class for the performance tests. run() calls prep() once, then repeats prepIteration()
+ * and timed() until kMinRunMillis have passed, and reports the number of operations done by
+ * timed() per second spent in it.
+ */
+class PerfTestBase {
+public:
+    PerfTestBase() : _client(&_opCtx) {
+        _client.dropCollection(nss.ns());
+    }
+
+    virtual ~PerfTestBase() {
+        _client.dropCollection(nss.ns());
+    }
+
+    void run() {
+        prep();
+
+        long long ops = 0;
+        long long iterations = 0;
+        long long micros = 0;
+        Timer total;
+        do {
+            prepIteration();
+            Timer timer;
+            ops += timed();
+            micros += timer.micros();
+            ++iterations;
+        } while (total.millis() < kMinRunMillis);
+
+        _report(ops, iterations, micros);
+    }
+
+protected:
+    virtual std::string name() const = 0;
+
+    /**
+     * Sets up the data the workload runs against. Not timed.
+     */
+    virtual void prep() {}
+
+    /**
+     * Sets up the data one iteration of the workload runs against. Not timed.
+     */
+    virtual void prepIteration() {}
+
+    /**
+     * Runs one iteration of the workload and returns the number of operations it did.
+     */
+    virtual long long timed() = 0;
+
+    static BSONObj makeDoc(int i) {
+        return BSON("_id" << i << "a" << i << "b" << (i * 7919) % kNumDocs << "g" << i % 100
+                          << "s"
+                          << "performance test document payload");
+    }
+
+    /**
+     * Inserts documents makeDoc(first) up to but not including makeDoc(last) through the
+     * Collection API, each in its own WriteUnitOfWork.
+     */
+    void insertDocs(int first, int last) {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            WriteUnitOfWork wunit(&_opCtx);
+            collection = ctx.db()->createCollection(&_opCtx, nss.ns());
+            wunit.commit();
+        }
+
+        OpDebug* const nullOpDebug = nullptr;
+        for (int i = first; i < last; ++i) {
+            WriteUnitOfWork wunit(&_opCtx);
+            ASSERT_OK(collection->insertDocument(
+                &_opCtx, InsertStatement(makeDoc(i)), nullOpDebug, false));
+            wunit.commit();
+        }
+    }
+
+    void addIndex(const BSONObj& keyPattern) {
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), keyPattern));
+    }
+
+    /**
+     * Runs 'root' to EOF and returns the number of results it produced.
+     */
+    long long countResults(unique_ptr<WorkingSet> ws,
+                           unique_ptr<PlanStage> root,
+                           Collection* collection) {
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_opCtx, std::move(ws), std::move(root), collection, PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+
+        long long count = 0;
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            ++count;
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+        return count;
+    }
+
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_txnPtr;
+    DBDirectClient _client;
+
+private:
+    void _report(long long ops, long long iterations, long long micros) {
+        BSONObjBuilder bob;
+        bob.append("name", name());
+        bob.append("storageEngine", storageGlobalParams.engine);
+        bob.append("gitVersion", VersionInfoInterface::instance().gitVersion());
+        bob.append("ops", ops);
+        bob.append("iterations", iterations);
+        bob.append("micros", micros);
+        bob.append("opsPerSec", micros > 0 ? ops * 1000.0 * 1000.0 / micros : 0.0);
+        const std::string result = bob.obj().jsonString();
+
+        if (frameworkGlobalParams.perfResultsFile.empty()) {
+            std::cout << result << std::endl;
+        } else {
+            std::ofstream out(frameworkGlobalParams.perfResultsFile, std::ios::app);
+            out << result << std::endl;
+        }
+    }
+};
+
+/**
+ * Inserts documents, each in its own WriteUnitOfWork, into a collection with only the _id index.
+ */
+class Insert : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "Insert";
+    }
+
+    long long timed() override {
+        insertDocs(_next, _next + kBatchSize);
+        _next += kBatchSize;
+        return kBatchSize;
+    }
+
+    static const int kBatchSize = 1000;
+    int _next = 0;
+};
+
+/**
+ * As Insert, into a collection with two secondary indexes.
+ */
+class InsertIndexed : public Insert {
+protected:
+    std::string name() const override {
+        return "InsertIndexed";
+    }
+
+    void prep() override {
+        insertDocs(-1, 0);
+        addIndex(BSON("a" << 1));
+        addIndex(BSON("b" << 1));
+    }
+};
+
+/**
+ * Replaces every document in turn with one whose indexed field 'b' has changed, each in its own
+ * WriteUnitOfWork.
+ */
+class Update : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "Update";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+        addIndex(BSON("b" << 1));
+    }
+
+    long long timed() override {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* collection = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        auto cursor = collection->getCursor(&_opCtx);
+        while (auto record = cursor->next()) {
+            recordIds.push_back(record->id);
+        }
+        cursor.reset();
+
+        OpDebug* const nullOpDebug = nullptr;
+        for (auto&& recordId : recordIds) {
+            WriteUnitOfWork wunit(&_opCtx);
+            Snapshotted<BSONObj> oldDoc = collection->docFor(&_opCtx, recordId);
+            BSONObjBuilder newDoc;
+            for (auto&& elem : oldDoc.value()) {
+                if (elem.fieldNameStringData() == "b") {
+                    newDoc.append("b", elem.numberInt() + 1);
+                } else {
+                    newDoc.append(elem);
+                }
+            }
+
+            OplogUpdateEntryArgs args;
+            args.nss = nss;
+            args.criteria = BSON("_id" << oldDoc.value()["_id"]);
+            const bool enforceQuota = false;
+            const bool indexesAffected = true;
+            collection->updateDocument(&_opCtx,
+                                       recordId,
+                                       oldDoc,
+                                       newDoc.obj(),
+                                       enforceQuota,
+                                       indexesAffected,
+                                       nullOpDebug,
+                                       &args);
+            wunit.commit();
+        }
+        return recordIds.size();
+    }
+};
+
+/**
+ * Deletes every document, each in its own WriteUnitOfWork. The documents are inserted again
+ * before each iteration, outside of the timed section.
+ */
+class Delete : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "Delete";
+    }
+
+    void prep() override {
+        insertDocs(-1, 0);
+        addIndex(BSON("b" << 1));
+    }
+
+    void prepIteration() override {
+        insertDocs(0, kNumDocs);
+    }
+
+    long long timed() override {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* collection = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        auto cursor = collection->getCursor(&_opCtx);
+        while (auto record = cursor->next()) {
+            if (record->data.toBson()["_id"].numberInt() >= 0) {
+                recordIds.push_back(record->id);
+            }
+        }
+        cursor.reset();
+
+        OpDebug* const nullOpDebug = nullptr;
+        for (auto&& recordId : recordIds) {
+            WriteUnitOfWork wunit(&_opCtx);
+            collection->deleteDocument(&_opCtx, kUninitializedStmtId, recordId, nullOpDebug);
+            wunit.commit();
+        }
+        return recordIds.size();
+    }
+};
+
+/**
+ * Reads the whole collection with a CollectionScan stage.
+ */
+class CollectionScanRate : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "CollectionScan";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+    }
+
+    long long timed() override {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        auto ws = make_unique<WorkingSet>();
+        auto scan = make_unique<CollectionScan>(&_opCtx, params, ws.get(), nullptr);
+        return countResults(std::move(ws), std::move(scan), ctx.getCollection());
+    }
+};
+
+/**
+ * Reads every key of a secondary index with an IndexScan stage, without fetching documents.
+ */
+class IndexScanRate : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "IndexScan";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+        addIndex(BSON("b" << 1));
+    }
+
+    long long timed() override {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        vector<IndexDescriptor*> indexes;
+        ctx.getCollection()->getIndexCatalog()->findIndexesByKeyPattern(
+            &_opCtx, BSON("b" << 1), false, &indexes);
+        ASSERT_EQ(1U, indexes.size());
+
+        IndexScanParams params;
+        params.descriptor = indexes[0];
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << MINKEY);
+        params.bounds.endKey = BSON("" << MAXKEY);
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = 1;
+
+        auto ws = make_unique<WorkingSet>();
+        auto scan = make_unique<IndexScan>(&_opCtx, params, ws.get(), nullptr);
+        return countResults(std::move(ws), std::move(scan), ctx.getCollection());
+    }
+};
+
+/**
+ * Sorts the whole collection on an unindexed field with a blocking SortStage.
+ */
+class Sort : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "Sort";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+    }
+
+    long long timed() override {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        CollectionScanParams scanParams;
+        scanParams.collection = ctx.getCollection();
+        scanParams.direction = CollectionScanParams::FORWARD;
+        scanParams.tailable = false;
+
+        SortStageParams params;
+        params.collection = ctx.getCollection();
+        params.pattern = BSON("b" << 1);
+        params.limit = 0;
+
+        auto ws = make_unique<WorkingSet>();
+        auto scan = make_unique<CollectionScan>(&_opCtx, scanParams, ws.get(), nullptr);
+        auto keyGen = make_unique<SortKeyGeneratorStage>(
+            &_opCtx, scan.release(), ws.get(), params.pattern, nullptr);
+        auto sort = make_unique<SortStage>(&_opCtx, params, ws.get(), keyGen.release());
+        return countResults(std::move(ws), std::move(sort), ctx.getCollection());
+    }
+};
+
+/**
+ * Groups the whole collection into 100 groups with an aggregation $group.
+ */
+class Group : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "Group";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+    }
+
+    long long timed() override {
+        BSONObj result;
+        ASSERT(_client.runCommand(
+            nss.db().toString(),
+            BSON("aggregate" << nss.coll() << "pipeline"
+                             << BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                                 << "$g"
+                                                                 << "total"
+                                                                 << BSON("$sum"
+                                                                         << "$a"))))
+                             << "cursor"
+                             << BSONObj()),
+            result))
+            << result;
+        ASSERT_EQ(100, result["cursor"]["firstBatch"].Array().size());
+        return kNumDocs;
+    }
+};
+
+/**
+ * Plans a query which two indexes can answer equally well, so that every execution has to run
+ * the candidate plans against each other. The plan cache is cleared before each planning.
+ */
+class MultiPlan : public PerfTestBase {
+protected:
+    std::string name() const override {
+        return "MultiPlan";
+    }
+
+    void prep() override {
+        insertDocs(0, kNumDocs);
+        addIndex(BSON("a" << 1));
+        addIndex(BSON("b" << 1));
+    }
+
+    long long timed() override {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        for (int i = 0; i < kPlansPerIteration; ++i) {
+            collection->infoCache()->clearQueryCache();
+
+            auto qr = make_unique<QueryRequest>(nss);
+            qr->setFilter(BSON("a" << BSON("$gte" << 0) << "b" << BSON("$gte" << 0)));
+            auto statusWithCQ = CanonicalQuery::canonicalize(&_opCtx, std::move(qr));
+            ASSERT_OK(statusWithCQ.getStatus());
+
+            // Making the executor picks the best plan.
+            auto statusWithPlanExecutor = getExecutorFind(&_opCtx,
+                                                          collection,
+                                                          nss,
+                                                          std::move(statusWithCQ.getValue()),
+                                                          PlanExecutor::NO_YIELD);
+            ASSERT_OK(statusWithPlanExecutor.getStatus());
+        }
+        return kPlansPerIteration;
+    }
+
+    static const int kPlansPerIteration = 10;
+};
+
+class All : public Suite {
+public:
+    All() : Suite("perf") {}
+
+    void setupTests() {
+        add<Insert>();
+        add<InsertIndexed>();
+        add<Update>();
+        add<Delete>();
+        add<CollectionScanRate>();
+        add<IndexScanRate>();
+        add<Sort>();
+        add<Group>();
+        add<MultiPlan>();
+    }
+};
+
+SuiteInstance<All> all;
+
+}  // namespace PerfTests
@@ -407,6 +407,59 @@ public:
     }
 };
 
+// An AND with two index scan children. The second scan skips the keys whose RecordIds were not
+// produced by the first, using the bloom filter built by the AND.
+class QueryStageAndHashBloomFilterSkipsKeys : public QueryStageAndBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll);
+
+        // Foo <= 20
+        IndexScanParams params;
+        params.descriptor = getIndex(BSON("foo" << 1), coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 20);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params.descriptor = getIndex(BSON("bar" << 1), coll);
+        params.bounds.startKey = BSON("" << 10);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = 1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        ASSERT_EQUALS(11, countResults(ah.get()));
+
+        // The second scan examines all 40 of its keys. Only its look ahead result and the 10
+        // keys with bar <= 20 after it can pass the filter, barring false positives.
+        auto stats = ah->getStats();
+        const AndHashStats* ahStats = static_cast<const AndHashStats*>(stats->specific.get());
+        ASSERT_GREATER_THAN_OR_EQUALS(ahStats->bloomFilterRejects, 25U);
+        ASSERT_EQUALS(stats->children[1]->common.advanced + ahStats->bloomFilterRejects, 40U);
+    }
+};
+
 // An AND with two children.
 // Add large keys (512 bytes) to index of first child to cause
 // internal buffer within hashed AND to exceed threshold (32MB)
@@ -1455,6 +1508,7 @@ public:
     void setupTests() {
         add<QueryStageAndHashInvalidation>();
         add<QueryStageAndHashTwoLeaf>();
+        add<QueryStageAndHashBloomFilterSkipsKeys>();
         add<QueryStageAndHashTwoLeafFirstChildLargeKeys>();
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
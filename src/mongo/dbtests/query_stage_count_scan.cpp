@@ -207,6 +207,47 @@ public:
     }
 };
 
+//
+// Check that every key range is counted, and that a document with keys in several ranges is
+// counted once
+//
+class QueryStageCountScanMultipleRanges : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+
+        // Insert some docs, one of which has keys in both ranges below
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i));
+        }
+        insert(BSON("a" << BSON_ARRAY(1 << 8)));
+
+        // Add an index
+        addIndex(BSON("a" << 1));
+
+        // Count [1, 2] and (6, 8]
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        params.startKey = BSON("" << 1);
+        params.startKeyInclusive = true;
+        params.endKey = BSON("" << 2);
+        params.endKeyInclusive = true;
+
+        IndexKeyRange secondRange;
+        secondRange.startKey = BSON("" << 6);
+        secondRange.startKeyInclusive = false;
+        secondRange.endKey = BSON("" << 8);
+        secondRange.endKeyInclusive = true;
+        params.additionalRanges.push_back(secondRange);
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws);
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(5, numCounted);
+    }
+};
+
 //
 // Check that cursor returns no results if all docs are below lower bound
 //
@@ -649,6 +690,7 @@ public:
         add<QueryStageCountScanDups>();
         add<QueryStageCountScanInclusiveBounds>();
         add<QueryStageCountScanExclusiveBounds>();
+        add<QueryStageCountScanMultipleRanges>();
         add<QueryStageCountScanLowerBound>();
         add<QueryStageCountScanNothingInInterval>();
         add<QueryStageCountScanNothingInIntervalFirstMatchTooHigh>();
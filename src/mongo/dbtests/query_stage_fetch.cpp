@@ -43,8 +43,10 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageFetch {
 
@@ -219,6 +221,66 @@ public:
     }
 };
 
+//
+// Fetch a window of results at a time. The results must come back in the order the child
+// produced them, without the ones whose documents are gone.
+//
+class FetchStageBatched : public QueryStageFetchBase {
+public:
+    void run() {
+        const int originalBatchSize = internalQueryExecFetchBatchSize.load();
+        internalQueryExecFetchBatchSize.store(4);
+        ON_BLOCK_EXIT([&] { internalQueryExecFetchBatchSize.store(originalBatchSize); });
+
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(10), recordIds.size());
+        remove(BSON("foo" << 3));
+
+        // Feed the RecordIds to the fetch stage in descending order.
+        WorkingSet ws;
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), NULL, coll));
+
+        std::vector<int> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = fetchStage->work(&id))) {
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, state);
+            if (PlanStage::ADVANCED == state) {
+                results.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+            }
+        }
+
+        const std::vector<int> expected{9, 8, 7, 6, 5, 4, 2, 1, 0};
+        ASSERT_EQUALS(expected.size(), results.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUALS(expected[i], results[i]);
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -226,6 +288,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatched>();
     }
 };
 
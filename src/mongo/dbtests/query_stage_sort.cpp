@@ -41,8 +41,10 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 /**
  * This file tests db/exec/sort.cpp
@@ -157,6 +159,7 @@ public:
         params.collection = coll;
         params.pattern = BSON("foo" << direction);
         params.limit = limit();
+        params.allowDiskUse = allowDiskUse();
 
         auto keyGenStage = make_unique<SortKeyGeneratorStage>(
             &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, nullptr);
@@ -216,6 +219,11 @@ public:
         return 0;
     };
 
+    // Returns whether the sort may spill to disk.
+    virtual bool allowDiskUse() const {
+        return false;
+    }
+
 
     static const char* ns() {
         return "unittests.QueryStageSort";
@@ -303,6 +311,26 @@ public:
     }
 };
 
+// Sort a big bunch of objects with a memory limit small enough to force a spill to disk.
+template <int LIMIT>
+class QueryStageSortSpill : public QueryStageSortExt {
+public:
+    virtual int limit() const {
+        return LIMIT;
+    }
+
+    virtual bool allowDiskUse() const {
+        return true;
+    }
+
+    void run() {
+        const int originalMaxBytes = internalQueryExecMaxBlockingSortBytes.load();
+        internalQueryExecMaxBlockingSortBytes.store(64 * 1024);
+        ON_BLOCK_EXIT([&] { internalQueryExecMaxBlockingSortBytes.store(originalMaxBytes); });
+        QueryStageSortExt::run();
+    }
+};
+
 // Mutation invalidation of docs fed to sort.
 class QueryStageSortMutationInvalidation : public QueryStageSortTestBase {
 public:
@@ -590,6 +618,8 @@ public:
         // and a special case for limit == 1
         add<QueryStageSortDecWithLimit<1>>();
         add<QueryStageSortExt>();
+        add<QueryStageSortSpill<0>>();
+        add<QueryStageSortSpill<5000>>();
         add<QueryStageSortMutationInvalidation>();
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
@@ -199,6 +199,58 @@ TEST_F(QueryStageSubplanTest, QueryStageSubplanPlanFromCache) {
     ASSERT_FALSE(subplan->branchPlannedFromCache(1));
 }
 
+/**
+ * Ensure that $or branches with the same shape as an earlier branch reuse its plan rather than
+ * being planned again.
+ */
+TEST_F(QueryStageSubplanTest, QueryStageSubplanReuseSameShapeBranch) {
+    OldClientWriteContext ctx(opCtx(), nss.ns());
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+
+    for (int i = 0; i < 10; i++) {
+        insert(BSON("a" << 1 << "b" << i << "c" << i));
+    }
+
+    // The first and third branches have the same shape, with two competing indices.
+    BSONObj query = fromjson("{$or: [{a: 1, b: 3}, {c: 1}, {a: 1, b: 5}]}");
+
+    Collection* collection = ctx.getCollection();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(query);
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx(), std::move(qr));
+    ASSERT_OK(statusWithCQ.getStatus());
+    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    // Get planner params.
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx(), collection, cq.get(), &plannerParams);
+
+    WorkingSet ws;
+    std::unique_ptr<SubplanStage> subplan(
+        new SubplanStage(opCtx(), collection, &ws, plannerParams, cq.get()));
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+    ASSERT_FALSE(subplan->branchPlannedFromEarlierBranch(0));
+    ASSERT_FALSE(subplan->branchPlannedFromEarlierBranch(1));
+    ASSERT_TRUE(subplan->branchPlannedFromEarlierBranch(2));
+
+    // Once the winner is cached, both branches are planned from the cache.
+    ws.clear();
+    subplan.reset(new SubplanStage(opCtx(), collection, &ws, plannerParams, cq.get()));
+
+    ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+    ASSERT_TRUE(subplan->branchPlannedFromCache(0));
+    ASSERT_TRUE(subplan->branchPlannedFromCache(2));
+    ASSERT_FALSE(subplan->branchPlannedFromEarlierBranch(2));
+}
+
 /**
  * Ensure that the subplan stage doesn't create a plan cache entry if there are no query results.
  */
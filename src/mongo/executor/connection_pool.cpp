@@ -200,6 +200,10 @@ private:
 
     size_t _created;
 
+    // Number of connections to reopen after a drop when the warmUpAfterDrop option is set. Reset
+    // once that many connections have been established again.
+    size_t _warmUpTarget;
+
     /**
      * The current state of the pool
      *
@@ -331,6 +335,7 @@ ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAnd
       _inFulfillRequests(false),
       _inSpawnConnections(false),
       _created(0),
+      _warmUpTarget(0),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -510,6 +515,11 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
 // Drop connections and fail all requests
 void ConnectionPool::SpecificPool::processFailure(const Status& status,
                                                   stdx::unique_lock<stdx::mutex> lk) {
+    // Remember how big the pool was so that it can be rebuilt in one go
+    if (_parent->_options.warmUpAfterDrop) {
+        _warmUpTarget = std::max(_warmUpTarget, openConnections(lk));
+    }
+
     // Bump the generation so we don't reuse any pending or checked out
     // connections
     _generation++;
@@ -615,11 +625,16 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     _inSpawnConnections = true;
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
-    // We want minConnections <= outstanding requests <= maxConnections
+    // Once the connections lost in a drop have been reestablished, go back to following demand
+    if (_warmUpTarget && _readyPool.size() + _checkedOutPool.size() >= _warmUpTarget) {
+        _warmUpTarget = 0;
+    }
+
+    // We want minConnections <= outstanding requests (or the warm up target) <= maxConnections
     auto target = [&] {
-        return std::max(
-            _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+        const auto demand = std::max(_requests.size() + _checkedOutPool.size(), _warmUpTarget);
+        return std::max(_parent->_options.minConnections,
+                        std::min(demand, _parent->_options.maxConnections));
     };
 
     // While all of our inflight connections are less than our target
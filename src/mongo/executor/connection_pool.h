@@ -117,6 +117,14 @@ public:
          * out connections or new requests
          */
         Milliseconds hostTimeout = kDefaultHostTimeout;
+
+        /**
+         * If set, a pool whose connections are dropped because of a failure reopens as many
+         * connections as it had open at the time of the drop as soon as it is next used, rather
+         * than one per outstanding request. This spares the burst of requests that typically
+         * follows a failover from paying for connection setup one request at a time.
+         */
+        bool warmUpAfterDrop = false;
     };
 
     explicit ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> impl,
@@ -1214,6 +1214,70 @@ TEST_F(ConnectionPoolTest, dropConnections) {
     ASSERT(reachedB);
 }
 
+/**
+ * Verify that with warmUpAfterDrop set, the first request after a drop reopens as many connections
+ * as were open when the pool was dropped, and that the pool follows demand again afterwards.
+ */
+TEST_F(ConnectionPoolTest, warmUpAfterDrop) {
+    ConnectionPool::Options options;
+    options.warmUpAfterDrop = true;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    // Check out three connections at once
+    std::vector<ConnectionPool::ConnectionHandle> handles;
+    for (int i = 0; i < 3; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(HostAndPort(),
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     handles.push_back(std::move(swConn.getValue()));
+                 });
+    }
+    ASSERT_EQ(3UL, handles.size());
+    ASSERT_EQ(3UL, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    pool.dropConnections(HostAndPort());
+
+    // The old connections lapse when they come back
+    for (auto& handle : handles) {
+        doneWith(handle);
+    }
+    handles.clear();
+    ASSERT_EQ(0UL, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    // A single request reopens all three
+    bool reachedA = false;
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 reachedA = true;
+                 doneWith(swConn.getValue());
+             });
+    ASSERT(reachedA);
+    ASSERT_EQ(3UL, pool.getNumConnectionsPerHost(HostAndPort()));
+    ASSERT_EQ(2UL, ConnectionImpl::setupQueueDepth());
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(0UL, ConnectionImpl::setupQueueDepth());
+
+    // Now that the pool is warm, another request is served without opening anything new
+    bool reachedB = false;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 reachedB = true;
+                 doneWith(swConn.getValue());
+             });
+    ASSERT(reachedB);
+    ASSERT_EQ(0UL, ConnectionImpl::setupQueueDepth());
+    ASSERT_EQ(3UL, pool.getNumConnectionsPerHost(HostAndPort()));
+}
+
 /**
  * Verify that timeouts during setup don't prematurely time out unrelated requests
  */
@@ -0,0 +1,216 @@
+/*    Copyright 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/encoder.h"
+#include "mongo/logger/log_severity.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender for writing to instances of RotatableFileWriter from a background thread.
+ *
+ * Events are encoded on the thread that logs them and queued. A single writer thread takes
+ * everything queued so far and writes it to the file under one acquisition of the writer. Events
+ * of severity Error or higher are still queued, to keep the file in order, but append() waits
+ * until they have been written, so nothing that precedes a crash is lost.
+ *
+ * When "maxBufferedRecords" events are waiting, append() either waits for room or drops the event,
+ * depending on the OverflowPolicy. The writer reports how many events were dropped in the file.
+ */
+template <typename Event>
+class AsyncFileAppender : public Appender<Event> {
+    MONGO_DISALLOW_COPYING(AsyncFileAppender);
+
+public:
+    typedef Encoder<Event> EventEncoder;
+
+    enum class OverflowPolicy { kBlock, kDrop };
+
+    /**
+     * Constructs an appender, that owns "encoder", but not "writer."  Caller must
+     * keep "writer" in scope at least as long as the constructed appender.
+     */
+    AsyncFileAppender(EventEncoder* encoder,
+                      RotatableFileWriter* writer,
+                      size_t maxBufferedRecords,
+                      OverflowPolicy overflowPolicy)
+        : _encoder(encoder),
+          _writer(writer),
+          _maxBufferedRecords(maxBufferedRecords),
+          _overflowPolicy(overflowPolicy),
+          _thread([this] { _run(); }) {}
+
+    virtual ~AsyncFileAppender() {
+        flushAndStop();
+    }
+
+    virtual Status append(const Event& event) {
+        std::ostringstream os;
+        _encoder->encode(event, os);
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_stopped) {
+            // Write through, holding _mutex so that concurrent callers keep their order.
+            return _write({os.str()}, 0);
+        }
+
+        const bool waitForWrite = event.getSeverity() >= LogSeverity::Error();
+        if (_buffer.size() >= _maxBufferedRecords) {
+            if (_overflowPolicy == OverflowPolicy::kDrop && !waitForWrite) {
+                ++_dropped;
+                return Status::OK();
+            }
+            _spaceAvailable.wait(
+                lk, [this] { return _stopped || _buffer.size() < _maxBufferedRecords; });
+            if (_stopped) {
+                return _write({os.str()}, 0);
+            }
+        }
+
+        _buffer.push_back(os.str());
+        const unsigned long long sequence = ++_enqueued;
+        _recordsAvailable.notify_one();
+
+        if (waitForWrite) {
+            _recordsWritten.wait(lk, [&] { return _written >= sequence; });
+        }
+        return _lastStatus;
+    }
+
+    /**
+     * Writes everything queued so far, stops the writer thread and makes later calls to append()
+     * write to the file directly.
+     */
+    void flushAndStop() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_stopping)
+                return;
+            _stopping = true;
+            _recordsAvailable.notify_one();
+        }
+        _thread.join();
+    }
+
+    /**
+     * Returns the number of events dropped because the buffer was full.
+     */
+    unsigned long long droppedCount() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _totalDropped + _dropped;
+    }
+
+private:
+    void _run() {
+        setThreadName("logWriter");
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _recordsAvailable.wait(lk, [this] { return _stopping || !_buffer.empty(); });
+            if (_buffer.empty() && _dropped == 0) {
+                // Only reached once _stopping is set and everything has been written.
+                break;
+            }
+
+            std::deque<std::string> batch;
+            batch.swap(_buffer);
+            const unsigned long long dropped = _dropped;
+            _totalDropped += _dropped;
+            _dropped = 0;
+            const unsigned long long sequence = _enqueued;
+            _spaceAvailable.notify_all();
+            lk.unlock();
+
+            Status status = _write(batch, dropped);
+
+            lk.lock();
+            _lastStatus = status;
+            _written = sequence;
+            _recordsWritten.notify_all();
+        }
+
+        _stopped = true;
+        _spaceAvailable.notify_all();
+    }
+
+    Status _write(const std::deque<std::string>& batch, unsigned long long dropped) {
+        RotatableFileWriter::Use useWriter(_writer);
+        Status status = useWriter.status();
+        if (!status.isOK())
+            return status;
+        if (dropped) {
+            useWriter.stream() << "*** " << dropped
+                               << " log messages were dropped because the log buffer was full ***"
+                               << std::endl;
+        }
+        for (const auto& record : batch) {
+            useWriter.stream() << record;
+        }
+        useWriter.stream().flush();
+        return useWriter.status();
+    }
+
+    std::unique_ptr<EventEncoder> _encoder;
+    RotatableFileWriter* _writer;
+    const size_t _maxBufferedRecords;
+    const OverflowPolicy _overflowPolicy;
+
+    // Guards all members below.
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _recordsAvailable;
+    stdx::condition_variable _spaceAvailable;
+    stdx::condition_variable _recordsWritten;
+    std::deque<std::string> _buffer;
+    unsigned long long _enqueued = 0;
+    unsigned long long _written = 0;
+    unsigned long long _dropped = 0;
+    unsigned long long _totalDropped = 0;
+    Status _lastStatus = Status::OK();
+    bool _stopping = false;
+    bool _stopped = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
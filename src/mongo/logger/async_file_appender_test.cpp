@@ -0,0 +1,146 @@
+/*    Copyright 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_file_appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncFileAppender.txt");
+
+typedef AsyncFileAppender<MessageEventEphemeral> Appender;
+
+class AsyncFileAppenderTest : public mongo::unittest::Test {
+public:
+    AsyncFileAppenderTest() {
+        unlink(logFileName.c_str());
+        RotatableFileWriter::Use writerUse(&_writer);
+        ASSERT_OK(writerUse.setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncFileAppenderTest() {
+        unlink(logFileName.c_str());
+    }
+
+protected:
+    static MessageEventEphemeral makeEvent(LogSeverity severity, StringData message) {
+        return MessageEventEphemeral(Date_t::now(), severity, "test", message);
+    }
+
+    std::vector<std::string> readLines() {
+        std::vector<std::string> lines;
+        std::ifstream ifs(logFileName.c_str());
+        std::string line;
+        while (std::getline(ifs, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    RotatableFileWriter _writer;
+};
+
+TEST_F(AsyncFileAppenderTest, WritesAllMessagesInOrder) {
+    Appender appender(
+        new MessageEventUnadornedEncoder, &_writer, 4, Appender::OverflowPolicy::kBlock);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), std::to_string(i))));
+    }
+    appender.flushAndStop();
+
+    auto lines = readLines();
+    ASSERT_EQUALS(100U, lines.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQUALS(std::to_string(i), lines[i]);
+    }
+    ASSERT_EQUALS(0U, appender.droppedCount());
+}
+
+TEST_F(AsyncFileAppenderTest, ErrorsAreWrittenBeforeAppendReturns) {
+    Appender appender(
+        new MessageEventUnadornedEncoder, &_writer, 16, Appender::OverflowPolicy::kBlock);
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "first")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Error(), "second")));
+
+    auto lines = readLines();
+    ASSERT_EQUALS(2U, lines.size());
+    ASSERT_EQUALS("first", lines[0]);
+    ASSERT_EQUALS("second", lines[1]);
+}
+
+TEST_F(AsyncFileAppenderTest, WritesThroughAfterStopping) {
+    Appender appender(
+        new MessageEventUnadornedEncoder, &_writer, 16, Appender::OverflowPolicy::kBlock);
+    appender.flushAndStop();
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "after stop")));
+
+    auto lines = readLines();
+    ASSERT_EQUALS(1U, lines.size());
+    ASSERT_EQUALS("after stop", lines[0]);
+}
+
+TEST_F(AsyncFileAppenderTest, DroppedMessagesAreCountedAndReported) {
+    Appender appender(
+        new MessageEventUnadornedEncoder, &_writer, 1, Appender::OverflowPolicy::kDrop);
+
+    // Hold the writer so that the background thread cannot empty the buffer.
+    {
+        RotatableFileWriter::Use writerUse(&_writer);
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), std::to_string(i))));
+        }
+    }
+    appender.flushAndStop();
+
+    const unsigned long long dropped = appender.droppedCount();
+    ASSERT_GREATER_THAN(dropped, 0U);
+
+    // The writer may have taken a batch before it blocked, so drops can be reported twice.
+    auto lines = readLines();
+    size_t reports = 0;
+    for (const auto& line : lines) {
+        if (line.find("log messages were dropped") != std::string::npos)
+            ++reports;
+    }
+    ASSERT_GREATER_THAN(reports, 0U);
+    ASSERT_EQUALS(50U - dropped + reports, lines.size());
+}
+
+}  // namespace
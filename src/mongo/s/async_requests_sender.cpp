@@ -33,6 +33,7 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -48,6 +49,14 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Maximum number of times to ask the targeter for a host when looking for a host to send a hedged
+// request to, which is different from the one the original request was sent to.
+const int kMaxNumHedgeHostSelectionAttempts = 3;
+
+// If positive, reads which allow hedging and may run on secondaries are sent to a second host of
+// the same shard if the first host has not responded within this many milliseconds.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadDelayMS, int, 0);
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -55,7 +64,8 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
                                          const std::string db,
                                          const std::vector<AsyncRequestsSender::Request>& requests,
                                          const ReadPreferenceSetting& readPreference,
-                                         Shard::RetryPolicy retryPolicy)
+                                         Shard::RetryPolicy retryPolicy,
+                                         bool allowHedging)
     : _opCtx(opCtx),
       _executor(executor),
       _db(std::move(db)),
@@ -65,6 +75,11 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
         _remotes.emplace_back(request.shardId, request.cmdObj);
     }
 
+    const int hedgeDelayMS = hedgedReadDelayMS.load();
+    if (allowHedging && hedgeDelayMS > 0 && readPreference.pref != ReadPreference::PrimaryOnly) {
+        _hedgeDelay = Milliseconds(hedgeDelayMS);
+    }
+
     // Initialize command metadata to handle the read preference.
     _metadataObj = readPreference.toContainingBSON();
 
@@ -98,7 +113,14 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
         // Otherwise, wait for some response to be received.
         if (_interruptStatus.isOK()) {
             try {
-                _notification->get(_opCtx);
+                // If a hedged request is pending, only wait until it is due to be sent
+                const auto hedgeDeadline = _getEarliestHedgeDeadline();
+                if (!hedgeDeadline) {
+                    _notification->get(_opCtx);
+                } else if (!_notification->waitFor(
+                               _opCtx, std::max(Milliseconds(0), *hedgeDeadline - Date_t::now()))) {
+                    _scheduleHedgedRequests();
+                }
             } catch (const AssertionException& ex) {
                 // If the operation is interrupted, we cancel outstanding requests and switch to
                 // waiting for the (canceled) callbacks to finish without checking for interrupts.
@@ -133,6 +155,10 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
+        remote.hedgeDeadline = boost::none;
     }
 }
 
@@ -145,10 +171,11 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
         _scheduleRequests(lk);
     }
 
-    // Check if any remote is ready.
+    // Check if any remote is ready. A remote, which received a response to one of its hedged
+    // requests is only ready once the other request has been canceled and its callback has run.
     invariant(!_remotes.empty());
     for (auto& remote : _remotes) {
-        if (remote.swResponse && !remote.done) {
+        if (remote.swResponse && !remote.done && !remote.hasOutstandingRequest()) {
             remote.done = true;
             if (remote.swResponse->isOK()) {
                 invariant(remote.shardHostAndPort);
@@ -177,6 +204,11 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
     for (size_t i = 0; i < _remotes.size(); ++i) {
         auto& remote = _remotes[i];
 
+        // Wait for all outstanding requests of a remote to complete before deciding whether to
+        // retry it
+        if (remote.hasOutstandingRequest())
+            continue;
+
         // First check if the remote had a retriable error, and if so, clear its response field so
         // it will be retried.
         if (remote.swResponse && !remote.done) {
@@ -211,7 +243,7 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse) {
             auto scheduleStatus = _scheduleRequest(lk, i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -240,34 +272,127 @@ Status AsyncRequestsSender::_scheduleRequest(WithLock, size_t remoteIndex) {
     executor::RemoteCommandRequest request(
         *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
 
+    const HostAndPort host = *remote.shardHostAndPort;
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request, [=](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
-            _handleResponse(cbData, remoteIndex);
+            _handleResponse(cbData, remoteIndex, host, false);
         });
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.targeter->noteRequestSent(host);
+
+    if (_hedgeDelay > Milliseconds(0)) {
+        remote.hedgeDeadline = Date_t::now() + _hedgeDelay;
+    }
+
     return Status::OK();
 }
 
+boost::optional<Date_t> AsyncRequestsSender::_getEarliestHedgeDeadline() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    boost::optional<Date_t> earliest;
+    for (const auto& remote : _remotes) {
+        if (remote.hedgeDeadline && (!earliest || *remote.hedgeDeadline < *earliest)) {
+            earliest = remote.hedgeDeadline;
+        }
+    }
+
+    return earliest;
+}
+
+void AsyncRequestsSender::_scheduleHedgedRequests() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    const auto now = Date_t::now();
+
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
+
+        if (!remote.hedgeDeadline || *remote.hedgeDeadline > now)
+            continue;
+
+        // Only hedge each request once
+        remote.hedgeDeadline = boost::none;
+
+        if (_stopRetrying || remote.swResponse || !remote.cbHandle.isValid())
+            continue;
+
+        // The targeter picks randomly among the eligible hosts, so ask it a few times for a host
+        // other than the one, which has not responded yet
+        boost::optional<HostAndPort> hedgeHost;
+        for (int attempt = 0; attempt < kMaxNumHedgeHostSelectionAttempts; ++attempt) {
+            auto findHostStatus =
+                remote.targeter->findHostWithMaxWait(_readPreference, Milliseconds(0));
+            if (!findHostStatus.isOK())
+                break;
+
+            if (findHostStatus.getValue() != *remote.shardHostAndPort) {
+                hedgeHost = std::move(findHostStatus.getValue());
+                break;
+            }
+        }
+
+        if (!hedgeHost)
+            continue;
+
+        LOG(1) << "Sending hedged request to " << *hedgeHost << " for shard " << remote.shardId
+               << " because " << *remote.shardHostAndPort << " did not respond within "
+               << _hedgeDelay;
+
+        executor::RemoteCommandRequest request(
+            *hedgeHost, _db, remote.cmdObj, _metadataObj, _opCtx);
+
+        const HostAndPort host = *hedgeHost;
+        auto callbackStatus = _executor->scheduleRemoteCommand(
+            request, [=](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                _handleResponse(cbData, i, host, true);
+            });
+        if (!callbackStatus.isOK()) {
+            // The original request is still outstanding, so just do without the hedged one
+            continue;
+        }
+
+        remote.hedgeCbHandle = callbackStatus.getValue();
+        remote.targeter->noteRequestSent(host);
+    }
+}
+
 void AsyncRequestsSender::_handleResponse(
-    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t remoteIndex) {
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+    size_t remoteIndex,
+    const HostAndPort& host,
+    bool isHedge) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     auto& remote = _remotes[remoteIndex];
-    invariant(!remote.swResponse);
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
-
-    // Store the response or error.
-    if (cbData.response.status.isOK()) {
-        remote.swResponse = std::move(cbData.response);
-    } else {
-        remote.swResponse = std::move(cbData.response.status);
+    // 'remote' for this request.
+    (isHedge ? remote.hedgeCbHandle : remote.cbHandle) = executor::TaskExecutor::CallbackHandle();
+    remote.targeter->noteResponseReceived(host);
+    remote.hedgeDeadline = boost::none;
+
+    auto& otherCbHandle = isHedge ? remote.cbHandle : remote.hedgeCbHandle;
+
+    // Use the first response received for the remote, unless it is an error and the other request
+    // may still succeed. Responses from the other request are discarded, but the notification is
+    // still signaled so that the remote is returned once it has no outstanding requests.
+    if (!remote.swResponse && (cbData.response.status.isOK() || !otherCbHandle.isValid())) {
+        if (cbData.response.status.isOK()) {
+            remote.swResponse = std::move(cbData.response);
+        } else {
+            remote.swResponse = std::move(cbData.response.status);
+        }
+
+        remote.shardHostAndPort = host;
+
+        if (otherCbHandle.isValid()) {
+            _executor->cancel(otherCbHandle);
+        }
     }
 
     // Signal the notification indicating that a remote received a response.
@@ -302,12 +427,14 @@ Status AsyncRequestsSender::RemoteData::resolveShardIdToHostAndPort(
                       str::stream() << "Could not find shard " << shardId);
     }
 
-    auto findHostStatus = shard->getTargeter()->findHostWithMaxWait(readPref, Seconds{20});
+    auto shardTargeter = shard->getTargeter();
+    auto findHostStatus = shardTargeter->findHostWithMaxWait(readPref, Seconds{20});
     if (!findHostStatus.isOK()) {
         return findHostStatus.getStatus();
     }
 
     shardHostAndPort = std::move(findHostStatus.getValue());
+    targeter = std::move(shardTargeter);
 
     return Status::OK();
 }
@@ -121,13 +121,20 @@ public:
     /**
      * Constructs a new AsyncRequestsSender. The OperationContext* and TaskExecutor* must remain
      * valid for the lifetime of the ARS.
+     *
+     * If 'allowHedging' is true, the read preference permits reading from secondaries and the
+     * hedgedReadDelayMS server parameter is positive, a request which has not received a response
+     * within that delay is additionally sent to another host of the same shard, which matches the
+     * read preference. The first response received is used and the other request is canceled.
+     * Must only be used for commands which are safe to run more than once.
      */
     AsyncRequestsSender(OperationContext* opCtx,
                         executor::TaskExecutor* executor,
                         const std::string db,
                         const std::vector<AsyncRequestsSender::Request>& requests,
                         const ReadPreferenceSetting& readPreference,
-                        Shard::RetryPolicy retryPolicy);
+                        Shard::RetryPolicy retryPolicy,
+                        bool allowHedging = false);
 
     /**
      * Ensures pending network I/O for any outstanding requests has been canceled and waits for
@@ -194,14 +201,33 @@ private:
         // sent.
         boost::optional<HostAndPort> shardHostAndPort;
 
+        // The targeter which selected 'shardHostAndPort'. Is notified when a request is sent to
+        // the host and when its response is received, so it can account for the host's load.
+        std::shared_ptr<RemoteCommandTargeter> targeter;
+
         // The number of times we've retried sending the command to this remote.
         int retryCount = 0;
 
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // The callback handle to an outstanding hedged request for this remote, which was sent to
+        // a different host than 'shardHostAndPort' because the original request was slow.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
+        // The time after which a hedged request should be sent, if there is still no response. Is
+        // unset if hedging is disabled or the hedged request has already been sent.
+        boost::optional<Date_t> hedgeDeadline;
+
         // Whether this remote's result has been returned.
         bool done = false;
+
+        /**
+         * Returns true if either the original or the hedged request has not completed yet.
+         */
+        bool hasOutstandingRequest() const {
+            return cbHandle.isValid() || hedgeCbHandle.isValid();
+        }
     };
 
     /**
@@ -240,16 +266,33 @@ private:
      */
     Status _scheduleRequest(WithLock, size_t remoteIndex);
 
+    /**
+     * Returns the earliest time at which a hedged request should be sent for any of the remotes,
+     * or boost::none if no hedged requests are pending.
+     */
+    boost::optional<Date_t> _getEarliestHedgeDeadline();
+
+    /**
+     * For each remote whose hedge deadline has passed without a response, sends the request to
+     * another host, which matches the read preference, if one is available.
+     */
+    void _scheduleHedgedRequests();
+
     /**
      * The callback for a remote command.
      *
      * 'remoteIndex' is the position of the relevant remote node in '_remotes', and therefore
      * indicates which node the response came from and where the response should be buffered.
+     * 'host' is the host the request was sent to and 'isHedge' indicates whether it was the
+     * hedged request.
      *
-     * Stores the response or error in the remote and signals the notification.
+     * Stores the response or error in the remote and signals the notification. If the remote
+     * already has a response from its other request, discards this one.
      */
     void _handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
-                         size_t remoteIndex);
+                         size_t remoteIndex,
+                         const HostAndPort& host,
+                         bool isHedge);
 
     OperationContext* _opCtx;
 
@@ -268,6 +311,10 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // How long to wait for a response before sending a hedged request. Zero if hedging is not
+    // enabled.
+    Milliseconds _hedgeDelay{0};
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
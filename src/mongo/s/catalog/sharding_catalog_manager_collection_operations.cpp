@@ -283,6 +283,9 @@ void ShardingCatalogManager::shardCollection(OperationContext* opCtx,
         coll.setKeyPattern(fieldsAndOrder.toBSON());
         coll.setDefaultCollation(defaultCollator ? defaultCollator->getSpec().toBSON() : BSONObj());
         coll.setUnique(unique);
+        if (fieldsAndOrder.isHashedPattern()) {
+            coll.setHashVersion(fieldsAndOrder.getHashVersion());
+        }
 
         uassertStatusOK(ShardingCatalogClientImpl::updateShardingCatalogEntryForCollection(
             opCtx, ns, coll, true /*upsert*/));
@@ -36,6 +36,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace {
@@ -53,6 +54,7 @@ const BSONField<Date_t> CollectionType::updatedAt("lastmod");
 const BSONField<BSONObj> CollectionType::keyPattern("key");
 const BSONField<BSONObj> CollectionType::defaultCollation("defaultCollation");
 const BSONField<bool> CollectionType::unique("unique");
+const BSONField<int> CollectionType::hashVersion("hashVersion");
 const BSONField<UUID> CollectionType::uuid("uuid");
 
 StatusWith<CollectionType> CollectionType::fromBSON(const BSONObj& source) {
@@ -149,6 +151,22 @@ StatusWith<CollectionType> CollectionType::fromBSON(const BSONObj& source) {
         }
     }
 
+    {
+        long long collHashVersion;
+        Status status = bsonExtractIntegerField(source, hashVersion.name(), &collHashVersion);
+        if (status.isOK()) {
+            if (!BSONElementHasher::isValidHashVersion(collHashVersion)) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "Unsupported shard key hash version " << collHashVersion};
+            }
+            coll._hashVersion = static_cast<int>(collHashVersion);
+        } else if (status == ErrorCodes::NoSuchKey) {
+            // Hash version can be missing in which case it is presumed the default
+        } else {
+            return status;
+        }
+    }
+
     {
         BSONElement uuidElem;
         Status status = bsonExtractField(source, uuid.name(), &uuidElem);
@@ -243,6 +261,10 @@ BSONObj CollectionType::toBSON() const {
         builder.append(unique.name(), _unique.get());
     }
 
+    if (_hashVersion.is_initialized()) {
+        builder.append(hashVersion.name(), _hashVersion.get());
+    }
+
     if (_uuid.is_initialized()) {
         _uuid->appendToBuilder(&builder, uuid.name());
     }
@@ -285,7 +307,7 @@ bool CollectionType::hasSameOptions(CollectionType& other) {
                                                     other.getKeyPattern().toBSON()) &&
         SimpleBSONObjComparator::kInstance.evaluate(_defaultCollation ==
                                                     other.getDefaultCollation()) &&
-        *_unique == other.getUnique();
+        *_unique == other.getUnique() && getHashVersion() == other.getHashVersion();
 }
 
 }  // namespace mongo
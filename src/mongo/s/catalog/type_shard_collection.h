@@ -31,6 +31,7 @@
 #include <boost/optional.hpp>
 #include <string>
 
+#include "mongo/db/hasher.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
@@ -61,6 +62,7 @@ class StatusWith;
  *          "locale" : "fr_CA"
  *      },
  *      "unique" : false,
+ *      "hashVersion" : 1,                                   // optional
  *      "refreshing" : true,                                 // optional
  *      "lastRefreshedCollectionVersion" : Timestamp(1, 0),  // optional
  *      "enterCriticalSectionCounter" : 4                    // optional
@@ -79,6 +81,7 @@ public:
     static const BSONField<BSONObj> keyPattern;
     static const BSONField<BSONObj> defaultCollation;
     static const BSONField<bool> unique;
+    static const BSONField<int> hashVersion;
     static const BSONField<bool> refreshing;
     static const BSONField<Date_t> lastRefreshedCollectionVersion;
     static const BSONField<int> enterCriticalSectionCounter;
@@ -139,6 +142,13 @@ public:
         _unique = unique;
     }
 
+    int getHashVersion() const {
+        return _hashVersion;
+    }
+    void setHashVersion(int hashVersion) {
+        _hashVersion = hashVersion;
+    }
+
     bool hasRefreshing() const {
         return _refreshing.is_initialized();
     }
@@ -174,6 +184,9 @@ private:
     // Uniqueness of the sharding key.
     bool _unique;
 
+    // Hash function version of a hashed sharding key. Only persisted if not the default.
+    int _hashVersion{BSONElementHasher::DEFAULT_HASH_VERSION};
+
     // Refresh fields set by primaries and used by shard secondaries to safely refresh chunk
     // metadata. '_refreshing' indicates whether the chunks collection is currently being updated,
     // which means read results won't provide a complete view of the chunk metadata.
@@ -32,17 +32,24 @@
 
 #include "mongo/s/catalog_cache.h"
 
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
 
@@ -53,6 +60,21 @@ namespace {
 // server is found to be inconsistent.
 const int kMaxInconsistentRoutingInfoRefreshAttempts = 3;
 
+// A routing table snapshot file is a sequence of BSON objects. The first identifies the format
+// version. Each collection is then described by a header object, followed by its chunks in the
+// format of config.chunks.
+const char kSnapshotFormatVersionField[] = "routingTableSnapshotVersion";
+const int kSnapshotFormatVersion = 1;
+
+const char kSnapshotNsField[] = "ns";
+const char kSnapshotUUIDField[] = "uuid";
+const char kSnapshotEpochField[] = "epoch";
+const char kSnapshotKeyField[] = "key";
+const char kSnapshotUniqueField[] = "unique";
+const char kSnapshotHashVersionField[] = "hashVersion";
+const char kSnapshotDefaultCollationField[] = "defaultCollation";
+const char kSnapshotNumChunksField[] = "numChunks";
+
 /**
  * Given an (optional) initial routing table and a set of changed chunks returned by the catalog
  * cache loader, produces a new routing table with the changes applied.
@@ -100,7 +122,8 @@ std::shared_ptr<ChunkManager> refreshCollectionRoutingInfo(
                                      std::move(defaultCollator),
                                      collectionAndChunks.shardKeyIsUnique,
                                      collectionAndChunks.epoch,
-                                     collectionAndChunks.changedChunks);
+                                     collectionAndChunks.changedChunks,
+                                     collectionAndChunks.shardKeyHashVersion);
     }();
 
     std::set<ShardId> shardIds;
@@ -283,6 +306,188 @@ void CatalogCache::purgeAllDatabases() {
     _databases.clear();
 }
 
+Status CatalogCache::saveRoutingTableSnapshot(const std::string& path) {
+    std::vector<std::shared_ptr<ChunkManager>> routingTables;
+    {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+        for (const auto& db : _databases) {
+            for (const auto& coll : db.second->collections) {
+                if (!coll.second.needsRefresh && coll.second.routingInfo) {
+                    routingTables.push_back(coll.second.routingInfo);
+                }
+            }
+        }
+    }
+
+    // Routing tables are immutable, so they can be written out without holding the mutex
+    const boost::filesystem::path snapshotPath(path);
+    const boost::filesystem::path snapshotTempPath(path + ".tmp");
+    try {
+        std::ofstream ofs(snapshotTempPath.c_str(),
+                          std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs) {
+            return Status(ErrorCodes::FileNotOpen,
+                          str::stream() << "Failed to open routing table snapshot file "
+                                        << snapshotTempPath.string()
+                                        << ": "
+                                        << errnoWithDescription());
+        }
+
+        const auto writeObj = [&ofs](const BSONObj& obj) {
+            ofs.write(obj.objdata(), obj.objsize());
+        };
+
+        writeObj(BSON(kSnapshotFormatVersionField << kSnapshotFormatVersion));
+
+        for (const auto& cm : routingTables) {
+            BSONObjBuilder header;
+            header.append(kSnapshotNsField, cm->getns());
+            if (cm->getUUID()) {
+                cm->getUUID()->appendToBuilder(&header, kSnapshotUUIDField);
+            }
+            header.append(kSnapshotEpochField, cm->getVersion().epoch());
+            header.append(kSnapshotKeyField, cm->getShardKeyPattern().toBSON());
+            header.append(kSnapshotUniqueField, cm->isUnique());
+            header.append(kSnapshotHashVersionField, cm->getShardKeyPattern().getHashVersion());
+            if (cm->getDefaultCollator()) {
+                header.append(kSnapshotDefaultCollationField,
+                              cm->getDefaultCollator()->getSpec().toBSON());
+            }
+            header.append(kSnapshotNumChunksField, cm->numChunks());
+            writeObj(header.obj());
+
+            const NamespaceString nss(cm->getns());
+            for (const auto& chunk : cm->chunks()) {
+                ChunkType chunkType(nss,
+                                    ChunkRange(chunk->getMin(), chunk->getMax()),
+                                    chunk->getLastmod(),
+                                    chunk->getShardId());
+                chunkType.setJumbo(chunk->isJumbo());
+                writeObj(chunkType.toConfigBSON());
+            }
+        }
+
+        ofs.close();
+        if (!ofs) {
+            return Status(ErrorCodes::FileStreamFailed,
+                          str::stream() << "Failed to write routing table snapshot file "
+                                        << snapshotTempPath.string()
+                                        << ": "
+                                        << errnoWithDescription());
+        }
+
+        boost::filesystem::rename(snapshotTempPath, snapshotPath);
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "Unexpected error writing routing table snapshot file "
+                                    << snapshotPath.string()
+                                    << ": "
+                                    << ex.what());
+    }
+
+    log() << "Wrote the routing tables of " << routingTables.size() << " collections to "
+          << snapshotPath.string();
+    return Status::OK();
+}
+
+Status CatalogCache::loadRoutingTableSnapshot(OperationContext* opCtx, const std::string& path) {
+    const boost::filesystem::path snapshotPath(path);
+
+    std::vector<char> buffer;
+    try {
+        if (!boost::filesystem::exists(snapshotPath)) {
+            return Status(ErrorCodes::NonExistentPath,
+                          str::stream() << "Routing table snapshot file " << snapshotPath.string()
+                                        << " not found.");
+        }
+
+        buffer.resize(boost::filesystem::file_size(snapshotPath));
+
+        std::ifstream ifs(snapshotPath.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!ifs || !ifs.read(buffer.data(), buffer.size())) {
+            return Status(ErrorCodes::FileStreamFailed,
+                          str::stream() << "Failed to read routing table snapshot file "
+                                        << snapshotPath.string());
+        }
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "Unexpected error reading routing table snapshot file "
+                                    << snapshotPath.string()
+                                    << ": "
+                                    << ex.what());
+    }
+
+    StringMap<std::shared_ptr<ChunkManager>> routingTables;
+    try {
+        const char* pos = buffer.data();
+        const char* const end = pos + buffer.size();
+
+        const auto nextObj = [&]() {
+            uassert(ErrorCodes::FailedToParse, "Routing table snapshot is truncated", pos < end);
+            uassertStatusOK(validateBSON(pos, end - pos, BSONVersion::kLatest));
+            BSONObj obj(pos);
+            pos += obj.objsize();
+            return obj;
+        };
+
+        const BSONObj formatVersion = nextObj();
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << "Unsupported routing table snapshot format " << formatVersion,
+                formatVersion[kSnapshotFormatVersionField].numberInt() == kSnapshotFormatVersion);
+
+        while (pos < end) {
+            const BSONObj header = nextObj();
+
+            const NamespaceString nss(header[kSnapshotNsField].String());
+
+            boost::optional<UUID> uuid;
+            if (header.hasField(kSnapshotUUIDField)) {
+                uuid = uassertStatusOK(UUID::parse(header[kSnapshotUUIDField]));
+            }
+
+            std::unique_ptr<CollatorInterface> defaultCollator;
+            if (header.hasField(kSnapshotDefaultCollationField)) {
+                defaultCollator = uassertStatusOK(
+                    CollatorFactoryInterface::get(opCtx->getServiceContext())
+                        ->makeFromBSON(header[kSnapshotDefaultCollationField].Obj()));
+            }
+
+            const long long numChunks = header[kSnapshotNumChunksField].numberLong();
+            std::vector<ChunkType> chunks;
+            chunks.reserve(numChunks);
+            for (long long i = 0; i < numChunks; ++i) {
+                chunks.push_back(uassertStatusOK(ChunkType::fromConfigBSON(nextObj())));
+            }
+
+            // The routing table must be built from chunks sorted by ascending version
+            std::sort(chunks.begin(), chunks.end(), [](const ChunkType& a, const ChunkType& b) {
+                return a.getVersion().toLong() < b.getVersion().toLong();
+            });
+
+            routingTables[nss.ns()] =
+                ChunkManager::makeNew(nss,
+                                      uuid,
+                                      KeyPattern(header[kSnapshotKeyField].Obj().getOwned()),
+                                      std::move(defaultCollator),
+                                      header[kSnapshotUniqueField].trueValue(),
+                                      header[kSnapshotEpochField].OID(),
+                                      chunks,
+                                      header[kSnapshotHashVersionField].numberInt());
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus().withContext(str::stream()
+                                         << "Failed to parse routing table snapshot file "
+                                         << snapshotPath.string());
+    }
+
+    log() << "Loaded the routing tables of " << routingTables.size() << " collections from "
+          << snapshotPath.string();
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    _snapshotRoutingInfo = std::move(routingTables);
+    return Status::OK();
+}
+
 std::shared_ptr<CatalogCache::DatabaseInfoEntry> CatalogCache::_getDatabase(OperationContext* opCtx,
                                                                             StringData dbName) {
     stdx::lock_guard<stdx::mutex> lg(_mutex);
@@ -312,7 +517,15 @@ std::shared_ptr<CatalogCache::DatabaseInfoEntry> CatalogCache::_getDatabase(Oper
             continue;
         }
 
-        collectionEntries[coll.getNs().ns()].needsRefresh = true;
+        auto& collEntry = collectionEntries[coll.getNs().ns()];
+        collEntry.needsRefresh = true;
+
+        // If the routing table snapshot has the collection, its first refresh can start from there
+        auto itSnapshot = _snapshotRoutingInfo.find(coll.getNs().ns());
+        if (itSnapshot != _snapshotRoutingInfo.end()) {
+            collEntry.routingInfo = std::move(itSnapshot->second);
+            _snapshotRoutingInfo.erase(itSnapshot);
+        }
     }
 
     return _databases[dbName] = std::shared_ptr<DatabaseInfoEntry>(new DatabaseInfoEntry{
@@ -124,6 +124,21 @@ public:
      */
     void purgeAllDatabases();
 
+    /**
+     * Writes the routing tables of all sharded collections currently cached to the file at 'path',
+     * replacing its previous contents. Routing tables waiting for a refresh are not written.
+     */
+    Status saveRoutingTableSnapshot(const std::string& path);
+
+    /**
+     * Reads routing tables written by saveRoutingTableSnapshot. Each is used as the starting point
+     * of the first refresh of its collection, so that refresh only fetches the chunks which changed
+     * since the snapshot was written rather than the collection's entire routing table. Routing
+     * tables for collections which have since been dropped or recreated are discarded by that
+     * refresh. Must be called before the cache is first used.
+     */
+    Status loadRoutingTableSnapshot(OperationContext* opCtx, const std::string& path);
+
 private:
     // Make the cache entries friends so they can access the private classes below
     friend class CachedDatabaseInfo;
@@ -182,6 +197,10 @@ private:
 
     // Map from DB name to the info for that database
     DatabaseInfoMap _databases;
+
+    // Routing tables loaded by loadRoutingTableSnapshot which have not yet been placed in the entry
+    // of their collection, keyed by namespace
+    StringMap<std::shared_ptr<ChunkManager>> _snapshotRoutingInfo;
 };
 
 /**
@@ -81,6 +81,7 @@ public:
         BSONObj shardKeyPattern;
         BSONObj defaultCollation;
         bool shardKeyIsUnique{false};
+        int shardKeyHashVersion{BSONElementHasher::DEFAULT_HASH_VERSION};
 
         // The chunks which have changed sorted by their chunkVersion. This list might potentially
         // contain all the chunks in the collection.
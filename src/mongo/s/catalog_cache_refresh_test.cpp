@@ -30,12 +30,16 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
+
 #include "mongo/db/query/query_request.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
+#include "mongo/s/grid.h"
+#include "mongo/unittest/temp_dir.h"
 
 namespace mongo {
 namespace {
@@ -612,5 +616,70 @@ TEST_F(CatalogCacheRefreshTest, IncrementalLoadAfterMoveLastChunk) {
     ASSERT_EQ(version, cm->getVersion({"1"}));
 }
 
+TEST_F(CatalogCacheRefreshTest, IncrementalLoadFromRoutingTableSnapshot) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(
+        makeChunkManager(kNss, shardKeyPattern, nullptr, false, {BSON("_id" << 0)}));
+    ASSERT_EQ(2, initialRoutingInfo->numChunks());
+
+    const ChunkVersion version = initialRoutingInfo->getVersion();
+
+    auto const catalogCache = Grid::get(serviceContext())->catalogCache();
+
+    unittest::TempDir tempDir("IncrementalLoadFromRoutingTableSnapshot");
+    const std::string snapshotPath = tempDir.path() + "/routingTables.bson";
+    ASSERT_OK(catalogCache->saveRoutingTableSnapshot(snapshotPath));
+
+    // Simulate a restart by dropping everything the cache knows
+    catalogCache->purgeAllDatabases();
+    ASSERT_OK(catalogCache->loadRoutingTableSnapshot(operationContext(), snapshotPath));
+
+    auto future = scheduleRoutingInfoRefresh(kNss);
+
+    expectGetDatabase();
+    expectGetCollection(version.epoch(), shardKeyPattern);
+    expectGetCollection(version.epoch(), shardKeyPattern);
+
+    // Only the chunks changed since the snapshot should be requested
+    onFindCommand([&](const RemoteCommandRequest& request) {
+        const auto diffQuery =
+            assertGet(QueryRequest::makeFromFindCommand(kNss, request.cmdObj, false));
+        ASSERT_BSONOBJ_EQ(
+            BSON("ns" << kNss.ns() << "lastmod"
+                      << BSON("$gte" << Timestamp(version.majorVersion(), version.minorVersion()))),
+            diffQuery->getFilter());
+
+        ChunkType chunk(
+            kNss, {BSON("_id" << 0), shardKeyPattern.getKeyPattern().globalMax()}, version, {"1"});
+
+        return std::vector<BSONObj>{chunk.toConfigBSON()};
+    });
+
+    auto routingInfo = future.timed_get(kFutureTimeout);
+    ASSERT(routingInfo->cm());
+    auto cm = routingInfo->cm();
+
+    ASSERT_EQ(2, cm->numChunks());
+    ASSERT_EQ(version, cm->getVersion());
+    ASSERT_EQ(ChunkVersion(1, 0, version.epoch()), cm->getVersion({"0"}));
+    ASSERT_EQ(version, cm->getVersion({"1"}));
+}
+
+TEST_F(CatalogCacheRefreshTest, CorruptRoutingTableSnapshotIsRejected) {
+    unittest::TempDir tempDir("CorruptRoutingTableSnapshotIsRejected");
+    const std::string snapshotPath = tempDir.path() + "/routingTables.bson";
+    {
+        std::ofstream ofs(snapshotPath.c_str(), std::ios_base::out | std::ios_base::binary);
+        ofs << "not a snapshot";
+    }
+
+    auto const catalogCache = Grid::get(serviceContext())->catalogCache();
+    ASSERT_NOT_OK(catalogCache->loadRoutingTableSnapshot(operationContext(), snapshotPath));
+    ASSERT_EQ(ErrorCodes::NonExistentPath,
+              catalogCache->loadRoutingTableSnapshot(operationContext(),
+                                                     tempDir.path() + "/missing.bson"));
+}
+
 }  // namespace
 }  // namespace mongo
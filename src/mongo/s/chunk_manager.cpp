@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -49,6 +51,15 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created ChunkManager
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Chunk bounds are compared in ascending order on every field, regardless of the direction of the
+// shard key pattern, which matches the ordering of the chunk map.
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+std::string toKeyString(const BSONObj& key) {
+    KeyString keyString(KeyString::Version::V1, key, kAllAscending);
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (const auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -64,16 +75,19 @@ ChunkManager::ChunkManager(NamespaceString nss,
                            KeyPattern shardKeyPattern,
                            std::unique_ptr<CollatorInterface> defaultCollator,
                            bool unique,
+                           int shardKeyHashVersion,
                            ChunkMap chunkMap,
-                           ChunkVersion collectionVersion)
+                           ChunkVersion collectionVersion,
+                           const ChunkKeyStringIndex& previousChunkKeyStringIndex)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
       _uuid(uuid),
-      _shardKeyPattern(shardKeyPattern),
+      _shardKeyPattern(shardKeyPattern, shardKeyHashVersion),
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
       _chunkMapViews(_constructChunkMapViews(collectionVersion.epoch(), _chunkMap)),
+      _chunkKeyStringIndex(_constructChunkKeyStringIndex(_chunkMap, previousChunkKeyStringIndex)),
       _collectionVersion(collectionVersion) {}
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
@@ -89,12 +103,21 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardK
         }
     }
 
-    const auto it = _chunkMap.upper_bound(shardKey);
+    // Find the first chunk whose max is greater than the key. The KeyString encoding orders keys
+    // the same way as the chunk map, so this is the chunk that would own the key.
+    const std::string shardKeyString = toKeyString(shardKey);
+    const auto it = std::upper_bound(
+        _chunkKeyStringIndex.begin(),
+        _chunkKeyStringIndex.end(),
+        shardKeyString,
+        [](const std::string& key, const ChunkWithMaxKeyString& entry) {
+            return key < entry.maxKeyString;
+        });
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
-            it != _chunkMap.end() && it->second->containsKey(shardKey));
+            it != _chunkKeyStringIndex.end() && it->chunk->containsKey(shardKey));
 
-    return it->second;
+    return it->chunk;
 }
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
@@ -141,7 +164,8 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     //   Query { a : { $gte : 1, $lt : 2 },
     //            b : { $gte : 3, $lt : 4 } }
     //   => Bounds { a : [1, 2), b : [3, 4) }
-    IndexBounds bounds = getIndexBoundsForQuery(_shardKeyPattern.toBSON(), *cq);
+    IndexBounds bounds =
+        getIndexBoundsForQuery(_shardKeyPattern.toBSON(), *cq, _shardKeyPattern.getHashVersion());
 
     // Transforms bounds for each shard key field into full shard key ranges
     // for example :
@@ -200,7 +224,8 @@ void ChunkManager::getAllShardIds(std::set<ShardId>* all) const {
 }
 
 IndexBounds ChunkManager::getIndexBoundsForQuery(const BSONObj& key,
-                                                 const CanonicalQuery& canonicalQuery) {
+                                                 const CanonicalQuery& canonicalQuery,
+                                                 int hashVersion) {
     // $text is not allowed in planning since we don't have text index on mongos.
     // TODO: Treat $text query as a no-op in planning on mongos. So with shard key {a: 1},
     //       the query { a: 2, $text: { ... } } will only target to {a: 2}.
@@ -233,7 +258,7 @@ IndexBounds ChunkManager::getIndexBoundsForQuery(const BSONObj& key,
                           false /* unique */,
                           "shardkey",
                           NULL /* filterExpr */,
-                          BSONObj(),
+                          BSON("hashVersion" << hashVersion),
                           NULL /* collator */);
     plannerParams.indices.push_back(indexEntry);
 
@@ -346,6 +371,37 @@ std::string ChunkManager::toString() const {
     return sb.str();
 }
 
+ChunkManager::ChunkKeyStringIndex ChunkManager::_constructChunkKeyStringIndex(
+    const ChunkMap& chunkMap, const ChunkKeyStringIndex& previousIndex) {
+    ChunkKeyStringIndex index;
+    index.reserve(chunkMap.size());
+
+    // Both the chunk map and the previous index are sorted by max key and the chunks, which were
+    // not touched by the update, are shared between them, so they can be merged in a single pass
+    auto previousIt = previousIndex.cbegin();
+
+    for (const auto& chunkMapEntry : chunkMap) {
+        if (previousIt != previousIndex.cend() && previousIt->chunk == chunkMapEntry.second) {
+            index.push_back(*previousIt);
+            ++previousIt;
+            continue;
+        }
+
+        auto maxKeyString = toKeyString(chunkMapEntry.first);
+        dassert(index.empty() || index.back().maxKeyString < maxKeyString);
+
+        // Any chunks of the previous index which end at or before this new chunk's max were
+        // overlapped by it and are no longer part of the routing table
+        while (previousIt != previousIndex.cend() && previousIt->maxKeyString <= maxKeyString) {
+            ++previousIt;
+        }
+
+        index.push_back({std::move(maxKeyString), chunkMapEntry.second});
+    }
+
+    return index;
+}
+
 ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epoch,
                                                                   const ChunkMap& chunkMap) {
 
@@ -435,7 +491,8 @@ std::shared_ptr<ChunkManager> ChunkManager::makeNew(
     std::unique_ptr<CollatorInterface> defaultCollator,
     bool unique,
     OID epoch,
-    const std::vector<ChunkType>& chunks) {
+    const std::vector<ChunkType>& chunks,
+    int shardKeyHashVersion) {
 
     return ChunkManager(
                std::move(nss),
@@ -443,16 +500,20 @@ std::shared_ptr<ChunkManager> ChunkManager::makeNew(
                std::move(shardKeyPattern),
                std::move(defaultCollator),
                std::move(unique),
+               shardKeyHashVersion,
                SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>(),
-               {0, 0, epoch})
+               {0, 0, epoch},
+               {})
         .makeUpdated(chunks);
 }
 
 std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
 
+    // Validate the changes and compute the resulting collection version before touching the
+    // routing table, so that a refresh which brings no new chunk versions does not pay for copying
+    // the chunk map
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
         const auto& chunkVersion = chunk.getVersion();
@@ -466,7 +527,24 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         // Chunks must always come in incrementally sorted order
         invariant(chunkVersion >= collectionVersion);
         collectionVersion = chunkVersion;
+    }
 
+    // If at least one diff was applied, the metadata is correct, but it might not have changed so
+    // in this case there is no need to recreate the chunk manager.
+    //
+    // NOTE: In addition to the above statement, it is also important that we return the same chunk
+    // manager object, because the write commands' code relies on changes of the chunk manager's
+    // sequence number to detect batch writes not making progress because of chunks moving across
+    // shards too frequently.
+    if (collectionVersion == startingCollectionVersion) {
+        return shared_from_this();
+    }
+
+    // The copy only duplicates the map's structure, the Chunk entries themselves are shared with
+    // this routing table
+    auto chunkMap = _chunkMap;
+
+    for (const auto& chunk : changedChunks) {
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
         // min
         const auto low = chunkMap.upper_bound(chunk.getMin());
@@ -482,24 +560,15 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         chunkMap.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
     }
 
-    // If at least one diff was applied, the metadata is correct, but it might not have changed so
-    // in this case there is no need to recreate the chunk manager.
-    //
-    // NOTE: In addition to the above statement, it is also important that we return the same chunk
-    // manager object, because the write commands' code relies on changes of the chunk manager's
-    // sequence number to detect batch writes not making progress because of chunks moving across
-    // shards too frequently.
-    if (collectionVersion == startingCollectionVersion) {
-        return shared_from_this();
-    }
-
     return std::shared_ptr<ChunkManager>(
         new ChunkManager(_nss,
                          _uuid,
                          KeyPattern(getShardKeyPattern().getKeyPattern()),
                          CollatorInterface::cloneCollator(getDefaultCollator()),
                          isUnique(),
+                         getShardKeyPattern().getHashVersion(),
                          std::move(chunkMap),
-                         collectionVersion));
+                         collectionVersion,
+                         _chunkKeyStringIndex));
 }
 }  // namespace mongo
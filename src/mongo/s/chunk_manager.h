@@ -31,6 +31,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
@@ -109,7 +110,8 @@ public:
      *
      * "defaultCollator" is the default collation for the collection, "unique" indicates whether
      * or not the shard key for each document will be globally unique, and "epoch" is the globally
-     * unique identifier for this version of the collection.
+     * unique identifier for this version of the collection. "shardKeyHashVersion" identifies the
+     * hash function of a hashed shard key.
      *
      * The "chunks" vector must contain the chunk routing information sorted in ascending order by
      * chunk version, and adhere to the requirements of the routing table update algorithm.
@@ -120,7 +122,9 @@ public:
                                                  std::unique_ptr<CollatorInterface> defaultCollator,
                                                  bool unique,
                                                  OID epoch,
-                                                 const std::vector<ChunkType>& chunks);
+                                                 const std::vector<ChunkType>& chunks,
+                                                 int shardKeyHashVersion =
+                                                     BSONElementHasher::DEFAULT_HASH_VERSION);
 
     /**
      * Constructs a new instance with a routing table updated according to the changes described
@@ -216,8 +220,12 @@ public:
     //   Query { a : { $gte : 1, $lt : 2 },
     //            b : { $gte : 3, $lt : 4 } }
     //   => Bounds { a : [1, 2), b : [3, 4) }
-    static IndexBounds getIndexBoundsForQuery(const BSONObj& key,
-                                              const CanonicalQuery& canonicalQuery);
+    //
+    // For a hashed key, equality values are hashed with the function identified by 'hashVersion'.
+    static IndexBounds getIndexBoundsForQuery(
+        const BSONObj& key,
+        const CanonicalQuery& canonicalQuery,
+        int hashVersion = BSONElementHasher::DEFAULT_HASH_VERSION);
 
     // Collapse query solution tree.
     //
@@ -236,6 +244,10 @@ public:
 
     std::string toString() const;
 
+    const boost::optional<UUID>& getUUID() const {
+        return _uuid;
+    }
+
     bool uuidMatches(UUID uuid) const {
         return _uuid && *_uuid == uuid;
     }
@@ -279,13 +291,35 @@ private:
      */
     static ChunkMapViews _constructChunkMapViews(const OID& epoch, const ChunkMap& chunkMap);
 
+    /**
+     * A chunk together with the KeyString encoding of its max key, for routing by binary search
+     * over plain byte comparisons rather than BSONObj comparisons.
+     */
+    struct ChunkWithMaxKeyString {
+        std::string maxKeyString;
+        std::shared_ptr<Chunk> chunk;
+    };
+
+    using ChunkKeyStringIndex = std::vector<ChunkWithMaxKeyString>;
+
+    /**
+     * Returns the chunks of the chunkMap, ordered by max key, with their KeyString encoded max.
+     * Chunks which are also present in 'previousIndex' (the index of the routing table this one
+     * was derived from) reuse their existing encoding, so an incremental refresh only encodes the
+     * bounds of the chunks which changed.
+     */
+    static ChunkKeyStringIndex _constructChunkKeyStringIndex(
+        const ChunkMap& chunkMap, const ChunkKeyStringIndex& previousIndex);
+
     ChunkManager(NamespaceString nss,
                  boost::optional<UUID>,
                  KeyPattern shardKeyPattern,
                  std::unique_ptr<CollatorInterface> defaultCollator,
                  bool unique,
+                 int shardKeyHashVersion,
                  ChunkMap chunkMap,
-                 ChunkVersion collectionVersion);
+                 ChunkVersion collectionVersion,
+                 const ChunkKeyStringIndex& previousChunkKeyStringIndex);
 
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
@@ -313,6 +347,10 @@ private:
     // Different transformations of the chunk map for efficient querying
     const ChunkMapViews _chunkMapViews;
 
+    // The chunks of the chunk map as a flat array sorted by the KeyString encoding of their max,
+    // used to find the chunk which owns a given shard key
+    const ChunkKeyStringIndex _chunkKeyStringIndex;
+
     // Max version across all chunks
     const ChunkVersion _collectionVersion;
 
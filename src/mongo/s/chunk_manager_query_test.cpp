@@ -33,6 +33,7 @@
 #include <set>
 
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/chunk_manager.h"
 
@@ -438,5 +439,57 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkAcrossNumericTypes) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10), BSON("a" << 20)});
+
+    ASSERT_EQ(ShardId("0"),
+              chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 9.5))
+                  ->getShardId());
+    ASSERT_EQ(ShardId("1"),
+              chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 10LL))
+                  ->getShardId());
+    ASSERT_EQ(ShardId("1"),
+              chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 19.99))
+                  ->getShardId());
+    ASSERT_EQ(ShardId("2"),
+              chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 20.0))
+                  ->getShardId());
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkAfterIncrementalUpdate) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10), BSON("a" << 20)});
+
+    // Nothing changed, so the same routing table must be returned
+    ASSERT_EQ(chunkManager.get(), chunkManager->makeUpdated({}).get());
+
+    ChunkVersion version = chunkManager->getVersion();
+    version.incMajor();
+    ChunkType lowerHalf(kNss, {BSON("a" << 10), BSON("a" << 15)}, version, ShardId("1"));
+    version.incMinor();
+    ChunkType upperHalf(kNss, {BSON("a" << 15), BSON("a" << 20)}, version, ShardId("2"));
+
+    auto updated = chunkManager->makeUpdated({lowerHalf, upperHalf});
+    ASSERT_EQ(4, updated->numChunks());
+    ASSERT_EQ(version, updated->getVersion());
+
+    ASSERT_EQ(ShardId("0"),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("a" << 5))->getShardId());
+    ASSERT_EQ(ShardId("1"),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("a" << 12))->getShardId());
+    ASSERT_EQ(ShardId("2"),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("a" << 15))->getShardId());
+    ASSERT_EQ(ShardId("2"),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("a" << 25))->getShardId());
+
+    // The original routing table is not affected by the update
+    ASSERT_EQ(ShardId("1"),
+              chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 17))
+                  ->getShardId());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -34,12 +34,15 @@
 
 #include <boost/intrusive_ptr.hpp>
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -645,6 +648,83 @@ BSONObj getDefaultCollationForUnshardedCollection(const Shard* primaryShard,
     return defaultCollation;
 }
 
+/**
+ * Returns true if 'lhs' and 'rhs' have the same shard key and their chunks have identical bounds
+ * and owning shards, so that documents of both collections with the same shard key value are
+ * always stored on the same shard.
+ */
+bool areColocated(const ChunkManager& lhs, const ChunkManager& rhs) {
+    if (SimpleBSONObjComparator::kInstance.evaluate(lhs.getShardKeyPattern().toBSON() !=
+                                                    rhs.getShardKeyPattern().toBSON()) ||
+        lhs.numChunks() != rhs.numChunks()) {
+        return false;
+    }
+
+    auto rhsIt = rhs.chunks().begin();
+    for (const auto& lhsChunk : lhs.chunks()) {
+        const auto& rhsChunk = *rhsIt++;
+        if (lhsChunk->getShardId() != rhsChunk->getShardId() ||
+            SimpleBSONObjComparator::kInstance.evaluate(lhsChunk->getMin() !=
+                                                        rhsChunk->getMin()) ||
+            SimpleBSONObjComparator::kInstance.evaluate(lhsChunk->getMax() !=
+                                                        rhsChunk->getMax())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Marks the $lookup stages of 'pipeline' which can join against their sharded foreign collection
+ * on each shard, and fails the aggregation if any other stage involves a sharded collection. A
+ * $lookup is a shard-local join if the local and foreign collections are co-located, both sharded
+ * on exactly the joined field, and the values of that field have not been changed by an earlier
+ * stage. Since routing is done with the simple collation, so must be the join.
+ */
+void markShardLocalLookups(
+    Pipeline* pipeline,
+    const ChunkManager& executionNsChunkManager,
+    const StringMap<std::shared_ptr<ChunkManager>>& shardedInvolvedNamespaces) {
+    const auto& shardKey = executionNsChunkManager.getShardKeyPattern().toBSON();
+
+    // Only $match stages may precede a shard-local $lookup, so that each local document still has
+    // the shard key value it was routed by.
+    bool onlyMatchesSoFar = true;
+
+    for (auto&& source : pipeline->getSources()) {
+        auto lookup = dynamic_cast<DocumentSourceLookUp*>(source.get());
+        if (lookup && onlyMatchesSoFar && !lookup->wasConstructedWithPipelineSyntax() &&
+            !pipeline->getContext()->getCollator() && shardKey.nFields() == 1) {
+            const auto it = shardedInvolvedNamespaces.find(lookup->getFromNs().ns());
+            const auto shardKeyField = shardKey.firstElementFieldName();
+
+            if (it != shardedInvolvedNamespaces.end() &&
+                lookup->getLocalField().fullPath() == shardKeyField &&
+                lookup->getForeignField().fullPath() == shardKeyField &&
+                areColocated(executionNsChunkManager, *it->second)) {
+                LOG(1) << "Executing $lookup from " << lookup->getFromNs().ns()
+                       << " as a shard-local join";
+                lookup->setRunShardLocal();
+                onlyMatchesSoFar = false;
+                continue;
+            }
+        }
+
+        std::vector<NamespaceString> involvedNamespaces;
+        source->addInvolvedCollections(&involvedNamespaces);
+        for (const auto& nss : involvedNamespaces) {
+            uassert(28769,
+                    str::stream() << nss.ns() << " cannot be sharded",
+                    shardedInvolvedNamespaces.find(nss.ns()) == shardedInvolvedNamespaces.end());
+        }
+
+        if (!dynamic_cast<DocumentSourceMatch*>(source.get())) {
+            onlyMatchesSoFar = false;
+        }
+    }
+}
+
 }  // namespace
 
 Status ClusterAggregate::runAggregate(OperationContext* opCtx,
@@ -684,11 +764,19 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     // command on an unsharded collection.
     StringMap<ExpressionContext::ResolvedNamespace> resolvedNamespaces;
 
+    // A sharded involved collection is only permitted as the foreign collection of a shard-local
+    // $lookup, which is verified once the pipeline has been parsed.
+    StringMap<std::shared_ptr<ChunkManager>> shardedInvolvedNamespaces;
+
     for (auto&& nss : liteParsedPipeline.getInvolvedNamespaces()) {
         const auto resolvedNsRoutingInfo =
             uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
-        uassert(
-            28769, str::stream() << nss.ns() << " cannot be sharded", !resolvedNsRoutingInfo.cm());
+        if (resolvedNsRoutingInfo.cm()) {
+            uassert(28769,
+                    str::stream() << nss.ns() << " cannot be sharded",
+                    internalQueryAllowShardLocalLookup.load() && executionNsRoutingInfo.cm());
+            shardedInvolvedNamespaces.try_emplace(nss.ns(), resolvedNsRoutingInfo.cm());
+        }
         resolvedNamespaces.try_emplace(nss.coll(), nss, std::vector<BSONObj>{});
     }
 
@@ -734,11 +822,16 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
                               std::make_shared<PipelineS::MongoSInterface>(),
                               std::move(resolvedNamespaces));
     mergeCtx->inMongos = true;
-    // explicitly *not* setting mergeCtx->tempDir
+    mergeCtx->tempDir = internalQueryMongosTempDir;
 
     auto pipeline = uassertStatusOK(Pipeline::parse(request.getPipeline(), mergeCtx));
     pipeline->optimizePipeline();
 
+    if (!shardedInvolvedNamespaces.empty()) {
+        markShardLocalLookups(
+            pipeline.get(), *executionNsRoutingInfo.cm(), shardedInvolvedNamespaces);
+    }
+
     // Check whether the entire pipeline must be run on mongoS.
     if (pipeline->requiredToRunOnMongos()) {
         uassert(ErrorCodes::IllegalOperation,
@@ -87,38 +87,26 @@ StatusWith<CachedCollectionRoutingInfo> getCollectionRoutingInfo(
     return swRoutingInfo;
 }
 
-}  // namespace
-
-boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
-    const boost::intrusive_ptr<ExpressionContext>& expCtx,
-    const NamespaceString& nss,
-    UUID collectionUUID,
-    const Document& filter,
-    boost::optional<BSONObj> readConcern) {
-    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
-
-    // Create the find command to be dispatched to the shard in order to return the post-change
-    // document.
-    auto filterObj = filter.toBson();
-    BSONObjBuilder cmdBuilder;
+/**
+ * Dispatches 'findCmd', a find command with the given 'filter', to every shard which 'filter'
+ * targets in the collection set on 'foreignExpCtx', retrying if the routing information is stale.
+ * If 'requireSingleShard' is true, throws if the query targets more than one shard. Returns
+ * boost::none if the collection does not exist or has been dropped and re-created.
+ */
+boost::optional<std::vector<ClusterClientCursorParams::RemoteCursor>> establishLookupCursors(
+    const intrusive_ptr<ExpressionContext>& foreignExpCtx,
+    BSONObj findCmd,
+    const BSONObj& filter,
+    bool requireSingleShard) {
+    auto opCtx = foreignExpCtx->opCtx;
+    const auto& nss = foreignExpCtx->ns;
     bool findCmdIsByUuid(foreignExpCtx->uuid);
-    if (findCmdIsByUuid) {
-        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
-    } else {
-        cmdBuilder.append("find", nss.coll());
-    }
-    cmdBuilder.append("filter", filterObj);
-    cmdBuilder.append("comment", expCtx->comment);
-    if (readConcern) {
-        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
-    }
 
     auto swShardResult = makeStatusWith<std::vector<ClusterClientCursorParams::RemoteCursor>>();
-    auto findCmd = cmdBuilder.obj();
     size_t numAttempts = 0;
     do {
         // Verify that the collection exists, with the correct UUID.
-        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+        auto catalogCache = Grid::get(opCtx)->catalogCache();
         auto swRoutingInfo = getCollectionRoutingInfo(foreignExpCtx);
         if (swRoutingInfo == ErrorCodes::NamespaceNotFound) {
             return boost::none;
@@ -134,18 +122,31 @@ boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
             findCmdIsByUuid = false;
         }
 
-        // Get the ID and version of the single shard to which this query will be sent.
-        auto shardInfo = getSingleTargetedShardForQuery(expCtx->opCtx, routingInfo, filterObj);
+        // Get the IDs and versions of the shards to which this query will be sent.
+        std::vector<std::pair<ShardId, BSONObj>> requests;
+        if (requireSingleShard) {
+            auto shardInfo = getSingleTargetedShardForQuery(opCtx, routingInfo, filter);
+            requests.emplace_back(shardInfo.first, appendShardVersion(findCmd, shardInfo.second));
+        } else if (auto chunkMgr = routingInfo.cm()) {
+            std::set<ShardId> shardIds;
+            chunkMgr->getShardIdsForQuery(opCtx, filter, CollationSpec::kSimpleSpec, &shardIds);
+            for (auto&& shardId : shardIds) {
+                requests.emplace_back(shardId,
+                                      appendShardVersion(findCmd, chunkMgr->getVersion(shardId)));
+            }
+        } else {
+            requests.emplace_back(routingInfo.primaryId(),
+                                  appendShardVersion(findCmd, ChunkVersion::UNSHARDED()));
+        }
 
-        // Dispatch the request. This will only be sent to a single shard and only a single result
-        // will be returned. The 'establishCursors' method conveniently prepares the result into a
-        // cursor response for us.
+        // Dispatch the requests. The 'establishCursors' method conveniently prepares the results
+        // into cursor responses for us.
         swShardResult =
-            establishCursors(expCtx->opCtx,
-                             Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
+            establishCursors(opCtx,
+                             Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
                              nss,
-                             ReadPreferenceSetting::get(expCtx->opCtx),
-                             {{shardInfo.first, appendShardVersion(findCmd, shardInfo.second)}},
+                             ReadPreferenceSetting::get(opCtx),
+                             requests,
                              false,
                              nullptr);
 
@@ -160,16 +161,59 @@ boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
         }
     } while (!swShardResult.isOK() && ++numAttempts < kMaxNumStaleVersionRetries);
 
-    auto shardResult = uassertStatusOK(std::move(swShardResult));
-    invariant(shardResult.size() == 1u);
+    return uassertStatusOK(std::move(swShardResult));
+}
 
-    auto& cursor = shardResult.front().cursorResponse;
+/**
+ * Returns the beginning of a find command on the collection set on 'foreignExpCtx', with the given
+ * filter, comment and read concern.
+ */
+BSONObjBuilder makeLookupFindCommand(const intrusive_ptr<ExpressionContext>& foreignExpCtx,
+                                     const BSONObj& filter,
+                                     const boost::optional<BSONObj>& readConcern) {
+    BSONObjBuilder cmdBuilder;
+    if (foreignExpCtx->uuid) {
+        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+    } else {
+        cmdBuilder.append("find", foreignExpCtx->ns.coll());
+    }
+    cmdBuilder.append("filter", filter);
+    cmdBuilder.append("comment", foreignExpCtx->comment);
+    if (readConcern) {
+        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+    }
+    return cmdBuilder;
+}
+
+}  // namespace
+
+boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const Document& filter,
+    boost::optional<BSONObj> readConcern) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    // Create the find command to be dispatched to the shard in order to return the post-change
+    // document.
+    auto filterObj = filter.toBson();
+    auto findCmd = makeLookupFindCommand(foreignExpCtx, filterObj, readConcern).obj();
+
+    // This will only be sent to a single shard and only a single result will be returned.
+    auto shardResult = establishLookupCursors(foreignExpCtx, findCmd, filterObj, true);
+    if (!shardResult) {
+        return boost::none;
+    }
+    invariant(shardResult->size() == 1u);
+
+    auto& cursor = shardResult->front().cursorResponse;
     auto& batch = cursor.getBatch();
 
     // We should have at most 1 result, and the cursor should be exhausted.
     uassert(ErrorCodes::InternalError,
             str::stream() << "Shard cursor was unexpectedly open after lookup: "
-                          << shardResult.front().hostAndPort
+                          << shardResult->front().hostAndPort
                           << ", id: "
                           << cursor.getCursorId(),
             cursor.getCursorId() == 0);
@@ -184,6 +228,43 @@ boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
     return (!batch.empty() ? Document(batch.front()) : boost::optional<Document>{});
 }
 
+std::vector<Document> PipelineS::MongoSInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filter,
+    long long maxResults,
+    boost::optional<BSONObj> readConcern) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    // Ask each targeted shard for a single batch which can hold every matching document. A shard
+    // whose batch is cut short by the reply size limit closes its cursor all the same, and the
+    // caller looks up the documents it did not return individually.
+    auto cmdBuilder = makeLookupFindCommand(foreignExpCtx, filter, readConcern);
+    cmdBuilder.append("batchSize", maxResults);
+    cmdBuilder.append("singleBatch", true);
+
+    auto shardResults = establishLookupCursors(foreignExpCtx, cmdBuilder.obj(), filter, false);
+    if (!shardResults) {
+        return {};
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    for (auto&& shardResult : *shardResults) {
+        auto& cursor = shardResult.cursorResponse;
+        uassert(ErrorCodes::InternalError,
+                str::stream() << "Shard cursor was unexpectedly open after lookup: "
+                              << shardResult.hostAndPort
+                              << ", id: "
+                              << cursor.getCursorId(),
+                cursor.getCursorId() == 0);
+        for (auto&& obj : cursor.getBatch()) {
+            lookedUpDocuments.emplace_back(obj);
+        }
+    }
+    return lookedUpDocuments;
+}
+
 std::vector<GenericCursor> PipelineS::MongoSInterface::getCursors(
     const intrusive_ptr<ExpressionContext>& expCtx) const {
     invariant(hasGlobalServiceContext());
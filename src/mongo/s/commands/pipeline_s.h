@@ -65,11 +65,22 @@ public:
             MONGO_UNREACHABLE;
         }
 
+        BSONObj upsert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       const NamespaceString& ns,
+                       const std::vector<BSONObj>& objs) final {
+            MONGO_UNREACHABLE;
+        }
+
         CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                               const NamespaceString& ns) final {
             MONGO_UNREACHABLE;
         }
 
+        std::vector<BSONObj> getQueryStats(OperationContext* opCtx,
+                                           const NamespaceString& ns) final {
+            MONGO_UNREACHABLE;
+        }
+
         void appendLatencyStats(OperationContext* opCtx,
                                 const NamespaceString& nss,
                                 bool includeHistograms,
@@ -84,6 +95,12 @@ public:
             MONGO_UNREACHABLE;
         }
 
+        Status appendCacheStats(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final {
+            MONGO_UNREACHABLE;
+        }
+
         Status appendRecordCount(OperationContext* opCtx,
                                  const NamespaceString& nss,
                                  BSONObjBuilder* builder) const final {
@@ -139,8 +156,23 @@ public:
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
 
+        std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                              const NamespaceString& nss,
+                                              UUID collectionUUID,
+                                              const BSONObj& filter,
+                                              long long maxResults,
+                                              boost::optional<BSONObj> readConcern) final;
+
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
+
+        std::vector<BSONObj> getLockContentionSamples(OperationContext* opCtx) const final {
+            MONGO_UNREACHABLE;
+        }
+
+        std::vector<BSONObj> getSlowOps(OperationContext* opCtx) const final {
+            MONGO_UNREACHABLE;
+        }
     };
 
 private:
@@ -32,12 +32,16 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard_registry.h"
@@ -51,6 +55,13 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Number of results buffered for a remote at or below which the merger issues that remote's next
+// getMore without waiting for its buffer to run dry. Zero disables prefetching.
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMongosPrefetchThreshold, int, 0);
+
+// The maximum number of fields of a sort key pattern which an Ordering can describe.
+const int kMaxOrderingFields = 32;
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -76,6 +87,26 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the Ordering to KeyString encode sort keys with, or boost::none if there is no sort or
+ * the sort key pattern has too many fields to be described by an Ordering.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const BSONObj& sortKeyPattern) {
+    if (sortKeyPattern.isEmpty() || sortKeyPattern.nFields() > kMaxOrderingFields) {
+        return boost::none;
+    }
+    return Ordering::make(sortKeyPattern);
+}
+
+/**
+ * Returns the KeyString encoding of 'sortKey', which compares against other encodings the same way
+ * compareSortKeys() orders the sort keys themselves.
+ */
+std::string encodeSortKey(const BSONObj& sortKey, Ordering ordering) {
+    const KeyString keyString(KeyString::Version::V1, sortKey, ordering);
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -84,7 +115,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
     : _opCtx(opCtx),
       _executor(executor),
       _params(params),
-      _mergeQueue(MergingComparator(_remotes, _params->sort, _params->compareWholeSortKey)) {
+      _sortKeyOrdering(makeSortKeyOrdering(_params->sort)),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params->sort,
+                                    _params->compareWholeSortKey,
+                                    static_cast<bool>(_sortKeyOrdering))) {
     size_t remoteIndex = 0;
     for (const auto& remote : _params->remotes) {
         _remotes.emplace_back(remote.hostAndPort,
@@ -108,6 +143,16 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 AsyncResultsMerger::~AsyncResultsMerger() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     invariant(_remotesExhausted(lk) || _lifecycleState == kKillComplete);
+
+    if (shouldLog(logger::LogSeverity::Debug(2))) {
+        for (const auto& remote : _remotes) {
+            LOG(2) << "Merged results from cursor " << remote.cursorId << " on "
+                   << remote.shardHostAndPort << ": fetched " << remote.fetchedCount
+                   << " documents with " << remote.numGetMores << " getMores ("
+                   << remote.numPrefetchedGetMores << " prefetched), buffering at most "
+                   << remote.maxBufferedCount << " documents";
+        }
+    }
 }
 
 bool AsyncResultsMerger::remotesExhausted() {
@@ -273,7 +318,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return hasSort ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_params->tailableMode != TailableMode::kTailable);
 
@@ -289,6 +334,9 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyStringBuffer.pop();
+    }
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -296,10 +344,12 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         _mergeQueue.push(smallestRemote);
     }
 
+    _prefetchNextBatchIfNeeded(lk, smallestRemote);
+
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -317,6 +367,8 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _prefetchNextBatchIfNeeded(lk, _gettingFromRemote);
+
             return front;
         }
 
@@ -366,9 +418,32 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    ++remote.numGetMores;
     return Status::OK();
 }
 
+void AsyncResultsMerger::_prefetchNextBatchIfNeeded(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    // Results of tailable cursors are handed to the client batch by batch, so their getMores must
+    // not be issued ahead of time.
+    const auto prefetchThreshold = internalQueryMongosPrefetchThreshold.load();
+    if (prefetchThreshold <= 0 || _params->tailableMode != TailableMode::kNormal ||
+        _lifecycleState != kAlive || !_opCtx) {
+        return;
+    }
+
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.docBuffer.size() > static_cast<size_t>(prefetchThreshold)) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+    if (remote.status.isOK()) {
+        ++remote.numPrefetchedGetMores;
+    }
+}
+
 /*
  * Note: When nextEvent() is called to do retries, only the remotes with retriable errors will
  * be rescheduled because:
@@ -540,6 +615,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyStringBuffer;
+        std::swap(remote.sortKeyStringBuffer, emptySortKeyStringBuffer);
         remote.cursorId = 0;
     }
 }
@@ -589,6 +666,11 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
+
+    // When getMores are prefetched, the batch may arrive while earlier results of this remote are
+    // still buffered, in which case the remote is already on the merge queue.
+    const bool hadBufferedResults = remote.hasNext();
+
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (!_params->sort.isEmpty()) {
@@ -610,14 +692,20 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
             }
         }
 
+        if (_sortKeyOrdering) {
+            remote.sortKeyStringBuffer.push(encodeSortKey(
+                extractSortKey(obj, _params->compareWholeSortKey), *_sortKeyOrdering));
+        }
+
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
+    remote.maxBufferedCount = std::max(remote.maxBufferedCount, remote.docBuffer.size());
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
-    if (!_params->sort.isEmpty() && !response.getBatch().empty()) {
+    if (!_params->sort.isEmpty() && !response.getBatch().empty() && !hadBufferedResults) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -727,6 +815,12 @@ std::shared_ptr<Shard> AsyncResultsMerger::RemoteCursorData::getShard() {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_useSortKeyStrings) {
+        const auto& leftSortKeyString = _remotes[lhs].sortKeyStringBuffer.front();
+        const auto& rightSortKeyString = _remotes[rhs].sortKeyStringBuffer.front();
+        return leftSortKeyString > rightSortKeyString;
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
@@ -30,11 +30,13 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -255,6 +257,11 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // Used only if there is a sort which can be KeyString encoded. Holds the KeyString encoded
+        // sort key of each result in 'docBuffer', in the same order, so that the merge can compare
+        // sort keys with a memcmp instead of re-parsing them as BSON on every comparison.
+        std::queue<std::string> sortKeyStringBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -265,14 +272,24 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Statistics about the buffering of results from this remote, logged when the merger is
+        // destroyed.
+        long long numGetMores = 0;
+        long long numPrefetchedGetMores = 0;
+        size_t maxBufferedCount = 0;
     };
 
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool useSortKeyStrings)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _useSortKeyStrings(useSortKeyStrings) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -285,6 +302,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, the remotes' buffered sort keys are compared through their KeyString encoding
+        // in 'sortKeyStringBuffer' rather than as BSON.
+        const bool _useSortKeyStrings;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -307,6 +328,14 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Called after a result has been consumed from the remote at 'remoteIndex'. If the number of
+     * results buffered for that remote has fallen to the internalQueryMongosPrefetchThreshold
+     * low-water mark, schedules its next getMore ahead of time, so that the merge does not stall
+     * waiting for the remote once its buffer runs dry.
+     */
+    void _prefetchNextBatchIfNeeded(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -399,6 +428,10 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
+    // Set if there is a sort and the sort key pattern can be represented as an Ordering, in which
+    // case the sort keys of all buffered results are KeyString encoded using it.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // The top of this priority queue is the index into '_remotes' for the remote host that has the
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
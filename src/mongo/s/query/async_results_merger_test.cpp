@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
@@ -44,6 +45,7 @@
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -596,6 +598,65 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergePrefetchesGetMoreBelowThreshold) {
+    auto prefetchThreshold =
+        ServerParameterSet::getGlobal()->getMap().find("internalQueryMongosPrefetchThreshold");
+    ASSERT(prefetchThreshold != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(prefetchThreshold->second->setFromString("1"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(prefetchThreshold->second->setFromString("0")); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 3}}")};
+    cursors.emplace_back(kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 5, batch1));
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                   fromjson("{$sortKey: {'': 4}}")};
+    cursors.emplace_back(kTestShardIds[1], kTestShardHosts[1], CursorResponse(_nss, 0, batch2));
+    makeCursorFromExistingCursors(std::move(cursors), findCmd);
+
+    // Both remotes have buffered results, so no getMore is needed to start merging.
+    ASSERT_TRUE(arm->ready());
+    network()->enterNetwork();
+    ASSERT_FALSE(network()->hasReadyRequests());
+    network()->exitNetwork();
+
+    // Consuming the first result leaves a single buffered result for the first shard, which brings
+    // it to the prefetch threshold and schedules its getMore while results remain buffered.
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    auto request = getFirstPendingRequest();
+    ASSERT_EQ(kTestShardHosts[0], request.target);
+    auto getMoreRequest = GetMoreRequest::parseFromBSON("anydbname", request.cmdObj);
+    ASSERT_OK(getMoreRequest.getStatus());
+    ASSERT_EQ(getMoreRequest.getValue().cursorid, 5LL);
+
+    // The merge continues from the buffered results while the getMore is outstanding.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 2}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: {'': 5}}")};
+    responses.emplace_back(_nss, CursorId(0), batch3);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    // The prefetched batch is appended behind the results which were still buffered.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 3}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 5}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
@@ -36,5 +36,7 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryAlwaysMergeOnPrimaryShard, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitMergingOnMongoS, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAllowShardLocalLookup, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(internalQueryMongosTempDir, std::string, "");
 
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/platform/atomic_word.h"
 
 namespace mongo {
@@ -45,4 +47,18 @@ extern AtomicBool internalQueryAlwaysMergeOnPrimaryShard;
 // of merging on mongoS will always do so.
 extern AtomicBool internalQueryProhibitMergingOnMongoS;
 
+// If set to true on mongos, a $lookup whose foreign collection is sharded may run on each shard
+// against the shard's own foreign documents, provided that both collections are sharded on the
+// joined field, with identical chunk bounds and chunk owners. False by default, in which case a
+// sharded foreign collection fails the aggregation. Note that co-location is only verified when the
+// aggregation starts, so a chunk migration of either collection while it runs may cause a local
+// document to miss foreign matches.
+extern AtomicBool internalQueryAllowShardLocalLookup;
+
+// The directory in which mongos writes temporary files when it merges an aggregation which allows
+// disk use and one of its blocking stages, such as $sort or $group, exceeds its memory limit. Empty
+// by default, in which case aggregations which allow disk use and contain such stages are merged on
+// a shard instead.
+extern std::string internalQueryMongosTempDir;
+
 }  // namespace mongo
@@ -61,13 +61,22 @@ StatusWith<std::vector<ClusterClientCursorParams::RemoteCursor>> establishCursor
         requests.emplace_back(remote.first, remote.second);
     }
 
+    // Only plain finds are hedged, since they have no side effects other than the cursor they
+    // establish. A cursor established by a hedged request, which lost the race is not known to
+    // mongos and is left for the shard to time out.
+    const bool allowHedging =
+        std::all_of(remotes.begin(), remotes.end(), [](const std::pair<ShardId, BSONObj>& remote) {
+            return StringData(remote.second.firstElementFieldName()) == "find";
+        });
+
     // Send the requests
     AsyncRequestsSender ars(opCtx,
                             executor,
                             nss.db().toString(),
                             std::move(requests),
                             readPref,
-                            Shard::RetryPolicy::kIdempotent);
+                            Shard::RetryPolicy::kIdempotent,
+                            allowHedging);
 
     // Get the responses
     std::vector<ClusterClientCursorParams::RemoteCursor> remoteCursors;
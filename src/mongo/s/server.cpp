@@ -61,6 +61,7 @@
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/db/session_killer.h"
@@ -128,6 +129,9 @@ using logger::LogComponent;
 
 namespace {
 
+// File in which mongos keeps a snapshot of its routing tables across restarts. Empty disables it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(routingTableSnapshotPath, std::string, "");
+
 boost::optional<ShardingUptimeReporter> shardingUptimeReporter;
 
 static constexpr auto kRetryInterval = Seconds{1};
@@ -221,6 +225,15 @@ static void cleanupTask() {
             pool->shutdownAndJoin();
         }
 
+        if (auto catalogCache = Grid::get(opCtx)->catalogCache()) {
+            if (!routingTableSnapshotPath.empty()) {
+                Status status = catalogCache->saveRoutingTableSnapshot(routingTableSnapshotPath);
+                if (!status.isOK()) {
+                    warning() << "Failed to save the routing table snapshot" << causedBy(status);
+                }
+            }
+        }
+
         if (auto catalog = Grid::get(opCtx)->catalogClient()) {
             catalog->shutDown(opCtx);
         }
@@ -317,6 +330,15 @@ static Status initializeSharding(OperationContext* opCtx) {
         return status;
     }
 
+    if (!routingTableSnapshotPath.empty()) {
+        // A missing or unreadable snapshot only means the routing tables are loaded from scratch
+        Status snapshotStatus = Grid::get(opCtx)->catalogCache()->loadRoutingTableSnapshot(
+            opCtx, routingTableSnapshotPath);
+        if (!snapshotStatus.isOK()) {
+            log() << "Not using the routing table snapshot" << causedBy(snapshotStatus);
+        }
+    }
+
     status = waitForShardRegistryReload(opCtx);
     if (!status.isOK()) {
         return status;
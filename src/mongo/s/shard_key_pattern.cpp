@@ -128,13 +128,14 @@ Status ShardKeyPattern::checkShardKeySize(const BSONObj& shardKey) {
                           << " bytes"};
 }
 
-ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern)
+ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern, int hashVersion)
     : _keyPatternPaths(parseShardKeyPattern(keyPattern)),
       _keyPattern(_keyPatternPaths.empty() ? BSONObj() : keyPattern),
+      _hashVersion(hashVersion),
       _hasId(keyPattern.hasField("_id"_sd)) {}
 
-ShardKeyPattern::ShardKeyPattern(const KeyPattern& keyPattern)
-    : ShardKeyPattern(keyPattern.toBSON()) {}
+ShardKeyPattern::ShardKeyPattern(const KeyPattern& keyPattern, int hashVersion)
+    : ShardKeyPattern(keyPattern.toBSON(), hashVersion) {}
 
 bool ShardKeyPattern::isValid() const {
     return !_keyPattern.toBSON().isEmpty();
@@ -242,7 +243,8 @@ BSONObj ShardKeyPattern::extractShardKeyFromMatchable(const MatchableDocument& m
         if (isHashedPatternEl(patternEl)) {
             keyBuilder.append(
                 patternEl.fieldName(),
-                BSONElementHasher::hash64(matchEl, BSONElementHasher::DEFAULT_HASH_SEED));
+                BSONElementHasher::hash64(
+                    matchEl, BSONElementHasher::DEFAULT_HASH_SEED, _hashVersion));
         } else {
             // NOTE: The matched element may *not* have the same field name as the path -
             // index keys don't contain field names, for example
@@ -331,7 +333,8 @@ BSONObj ShardKeyPattern::extractShardKeyFromQuery(const CanonicalQuery& query) c
         if (isHashedPattern()) {
             keyBuilder.append(
                 patternPath.dottedField(),
-                BSONElementHasher::hash64(equalEl, BSONElementHasher::DEFAULT_HASH_SEED));
+                BSONElementHasher::hash64(
+                    equalEl, BSONElementHasher::DEFAULT_HASH_SEED, _hashVersion));
         } else {
             // NOTE: The equal element may *not* have the same field name as the path -
             // nested $and, $eq, for example
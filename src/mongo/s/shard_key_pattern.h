@@ -33,6 +33,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/matchable.h"
@@ -79,18 +80,31 @@ public:
     /**
      * Constructs a shard key pattern from a BSON pattern document.  If the document is not a
      * valid shard key pattern, !isValid() will be true and key extraction will fail.
+     *
+     * For a hashed pattern, 'hashVersion' selects the hash function used to compute shard key
+     * values and must match the "hashVersion" of the hashed index backing the shard key.
      */
-    explicit ShardKeyPattern(const BSONObj& keyPattern);
+    explicit ShardKeyPattern(const BSONObj& keyPattern,
+                             int hashVersion = BSONElementHasher::DEFAULT_HASH_VERSION);
 
     /**
      * Constructs a shard key pattern from a key pattern, see above.
      */
-    explicit ShardKeyPattern(const KeyPattern& keyPattern);
+    explicit ShardKeyPattern(const KeyPattern& keyPattern,
+                             int hashVersion = BSONElementHasher::DEFAULT_HASH_VERSION);
 
     bool isValid() const;
 
     bool isHashedPattern() const;
 
+    /**
+     * Returns the version of the hash function used for a hashed shard key. Always the default
+     * version for patterns which are not hashed.
+     */
+    int getHashVersion() const {
+        return _hashVersion;
+    }
+
     const KeyPattern& getKeyPattern() const;
 
     const std::vector<std::unique_ptr<FieldRef>>& getKeyPatternFields() const;
@@ -238,6 +252,8 @@ private:
 
     KeyPattern _keyPattern;
 
+    int _hashVersion;
+
     bool _hasId;
 };
 
@@ -428,6 +428,24 @@ TEST(ShardKeyPattern, ExtractQueryShardKeyHashed) {
     ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << BSON_ARRAY(BSON("b" << value)))), BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractShardKeyHashedUsesHashVersion) {
+    const string value = "12345";
+    const BSONObj bsonValue = BSON("" << value);
+    const long long hashValue = BSONElementHasher::hash64(bsonValue.firstElement(),
+                                                          BSONElementHasher::DEFAULT_HASH_SEED,
+                                                          BSONElementHasher::FAST_HASH_VERSION);
+    ASSERT_NOT_EQUALS(
+        hashValue,
+        BSONElementHasher::hash64(bsonValue.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED));
+
+    ShardKeyPattern pattern(BSON("a.b"
+                                 << "hashed"),
+                            BSONElementHasher::FAST_HASH_VERSION);
+    ASSERT_EQUALS(pattern.getHashVersion(), BSONElementHasher::FAST_HASH_VERSION);
+    ASSERT_BSONOBJ_EQ(docKey(pattern, BSON("a" << BSON("b" << value))), BSON("a.b" << hashValue));
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a.b" << value)), BSON("a.b" << hashValue));
+}
+
 static bool indexComp(const ShardKeyPattern& pattern, const BSONObj& indexPattern) {
     return pattern.isUniqueIndexCompatible(indexPattern);
 }
@@ -305,7 +305,14 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
             writeOp.cancelWrites(nullptr);
-            break;
+
+            // Ordered batches must stop at the first write, which does not fit. The writes of an
+            // unordered batch are independent of each other though, so keep filling the batches
+            // for the shards which still have room and leave this write for the next round.
+            if (ordered)
+                break;
+
+            continue;
         }
 
         //
@@ -1553,5 +1553,64 @@ TEST_F(BatchWriteOpLimitTests, OneBigOneSmall) {
     ASSERT(batchOp.isFinished());
 }
 
+// Unordered batch where one shard's batch fills up - the other shard's writes should still be sent
+// in the first round
+TEST_F(BatchWriteOpLimitTests, FullShardBatchDoesNotHoldBackOtherShardsUnordered) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    // Create a BSONObj (slightly) bigger than the maximum size by including a max-size string
+    const std::string bigString(BSONObjMaxUserSize, 'x');
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        insertOp.setDocuments({BSON("x" << -1 << "data" << bigString),
+                               BSON("x" << -2),
+                               BSON("x" << 1),
+                               BSON("x" << 2)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 2u);
+    ASSERT_EQUALS(targeted[endpointA.shardName]->getWrites().size(), 1u);
+    ASSERT_EQUALS(targeted[endpointB.shardName]->getWrites().size(), 2u);
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+    batchOp.noteBatchResponse(*targeted[endpointA.shardName], response, NULL);
+
+    buildResponse(2, &response);
+    batchOp.noteBatchResponse(*targeted[endpointB.shardName], response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getEndpoint().shardName, endpointA.shardName);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 1u);
+
+    buildResponse(1, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 4);
+}
+
 }  // namespace
 }  // namespace mongo
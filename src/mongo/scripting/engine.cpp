@@ -39,6 +39,7 @@
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
@@ -327,6 +328,18 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+
+// The number of idle scopes kept for reuse, across all pools.
+MONGO_EXPORT_SERVER_PARAMETER(jsScopePoolSize, int, 10);
+
+// The number of operations a scope serves before it is discarded. Compiled functions are cached
+// per scope, so scopes which are reused longer compile their functions less often.
+MONGO_EXPORT_SERVER_PARAMETER(jsScopeMaxReuse, int, 100);
+
+// Scopes which have compiled more functions than this are discarded rather than kept for reuse,
+// to bound the memory held by idle scopes.
+MONGO_EXPORT_SERVER_PARAMETER(jsScopeMaxCachedFunctions, int, 1000);
+
 class ScopeCache {
 public:
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
@@ -339,13 +352,21 @@ public:
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > jsScopeMaxReuse.load())
             return;  // used too many times to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
+        if (scope->getNumCachedFunctions() > static_cast<size_t>(jsScopeMaxCachedFunctions.load()))
+            return;  // holding on to too many compiled functions
+
+        const int maxPoolSize = jsScopePoolSize.load();
+        if (maxPoolSize <= 0) {
+            _pools.clear();
+            return;
+        }
+        while (_pools.size() >= static_cast<size_t>(maxPoolSize)) {
             // prefer to keep recently-used scopes
             _pools.pop_back();
         }
@@ -384,10 +405,7 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
-
+    // Note: if jsScopePoolSize is made much larger, reconsider choice of datastructure for _pools
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
     stdx::mutex _mutex;
@@ -182,6 +182,11 @@ public:
         return _numTimesUsed;
     }
 
+    /** gets the number of compiled functions cached by this scope */
+    size_t getNumCachedFunctions() const {
+        return _cachedFunctions.size();
+    }
+
     /** return true if last invoke() return'd native code */
     virtual bool isLastRetNativeCode() {
         return _lastRetIsNativeCode;
@@ -32,6 +32,9 @@
 
 #include "mongo/shell/bench.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclientcursor.h"
@@ -39,6 +42,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/thread.h"
@@ -62,7 +66,8 @@ const std::map<OpType, std::string> kOpTypeNames{{OpType::NONE, "none"},
                                                  {OpType::CREATEINDEX, "createIndex"},
                                                  {OpType::DROPINDEX, "dropIndex"},
                                                  {OpType::LET, "let"},
-                                                 {OpType::CPULOAD, "cpuload"}};
+                                                 {OpType::CPULOAD, "cpuload"},
+                                                 {OpType::AGGREGATE, "aggregate"}};
 
 // When specified to the connection's 'runCommand' call indicates that the command should be
 // executed with no query options. This is only meaningful if a command is run via OP_QUERY against
@@ -238,6 +243,59 @@ BenchRunEventCounter::BenchRunEventCounter() = default;
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, other._maxTimeMicros);
+    for (int i = 0; i < kNumBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+}
+
+void BenchRunEventCounter::countOne(long long timeMicros) {
+    timeMicros = std::max(timeMicros, 0LL);
+    ++_numEvents;
+    _totalTimeMicros += timeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, timeMicros);
+    ++_buckets[_bucketIndex(timeMicros)];
+}
+
+long long BenchRunEventCounter::getPercentileMicros(double percentile) const {
+    if (_numEvents == 0) {
+        return 0;
+    }
+
+    const unsigned long long rank = std::max(
+        1ULL, static_cast<unsigned long long>(std::ceil(percentile / 100.0 * _numEvents)));
+
+    unsigned long long seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(_bucketUpperBound(i), _maxTimeMicros);
+        }
+    }
+    return _maxTimeMicros;
+}
+
+int BenchRunEventCounter::_bucketIndex(unsigned long long timeMicros) {
+    if (timeMicros < static_cast<unsigned long long>(kSubBuckets)) {
+        return static_cast<int>(timeMicros);
+    }
+
+    // Keep the kSubBucketBits bits below the most significant one.
+    const int shift = 63 - countLeadingZeros64(timeMicros) - kSubBucketBits;
+    return kSubBuckets * (shift + 1) + static_cast<int>((timeMicros >> shift) - kSubBuckets);
+}
+
+long long BenchRunEventCounter::_bucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+
+    const int shift = index / kSubBuckets - 1;
+    const unsigned long long subBucket = index % kSubBuckets;
+    if (shift + kSubBucketBits + 1 >= 63) {
+        return std::numeric_limits<long long>::max();
+    }
+    return static_cast<long long>(((kSubBuckets + subBucket + 1) << shift) - 1);
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -252,6 +310,7 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     deleteCounter.updateFrom(other.deleteCounter);
     queryCounter.updateFrom(other.queryCounter);
     commandCounter.updateFrom(other.commandCounter);
+    aggregateCounter.updateFrom(other.aggregateCounter);
 
     for (const auto& trappedError : other.trappedErrors) {
         trappedErrors.push_back(trappedError);
@@ -270,6 +329,8 @@ void BenchRunConfig::initializeToDefaults() {
 
     parallel = 1;
     seconds = 1.0;
+    hosts.clear();
+    opsPerSecond = 0;
     hideResults = true;
     handleErrors = false;
     hideErrors = false;
@@ -304,7 +365,7 @@ BenchRunOp opFromBson(const BSONObj& op) {
             uassert(34378,
                     str::stream() << "Field 'batchSize' only valid for find op types. Type is "
                                   << opType,
-                    (opType == "find") || (opType == "query"));
+                    (opType == "find") || (opType == "query") || (opType == "aggregate"));
             myOp.batchSize = arg.numberInt();
         } else if (name == "check") {
             // check function gets thrown into a scoped function. Leaving that parsing in main loop.
@@ -354,7 +415,7 @@ BenchRunOp opFromBson(const BSONObj& op) {
             uassert(34400,
                     str::stream() << "Field 'Expected' only valid for find op type. Type is "
                                   << opType,
-                    (opType == "find") || (opType == "query"));
+                    (opType == "find") || (opType == "query") || (opType == "aggregate"));
             myOp.expected = arg.numberInt();
         } else if (name == "filter") {
             uassert(
@@ -425,6 +486,8 @@ BenchRunOp opFromBson(const BSONObj& op) {
                 myOp.op = OpType::LET;
             } else if (type == "cpuload") {
                 myOp.op = OpType::CPULOAD;
+            } else if (type == "aggregate") {
+                myOp.op = OpType::AGGREGATE;
             } else {
                 uassert(34387,
                         str::stream() << "benchRun passed an unsupported op type: " << type,
@@ -440,6 +503,17 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << opType,
                     (opType == "command") || (opType == "query") || (opType == "find"));
             myOp.options = arg.numberInt();
+        } else if (name == "pipeline") {
+            uassert(40683,
+                    str::stream() << "Field 'pipeline' is only valid for aggregate op type. "
+                                     "Type is "
+                                  << opType,
+                    opType == "aggregate");
+            uassert(40684,
+                    str::stream() << "Field 'pipeline' should be an array, instead it's type: "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            myOp.pipeline = arg.Obj();
         } else if (name == "query") {
             uassert(34389,
                     str::stream() << "Field 'query' is only valid for findOne, find, update, and "
@@ -508,6 +582,9 @@ BenchRunOp opFromBson(const BSONObj& op) {
 
     uassert(34395, "Benchrun op has an zero length ns", !myOp.ns.empty());
     uassert(34396, "Benchrun op doesn't have an optype set", myOp.op != OpType::NONE);
+    uassert(40685,
+            "Benchrun aggregate op requires a 'pipeline' field",
+            myOp.op != OpType::AGGREGATE || myOp.myBsonOp.hasField("pipeline"));
     return myOp;
 }
 
@@ -522,6 +599,20 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.type() == String);
             host = arg.String();
+        } else if (name == "hosts") {
+            uassert(40686,
+                    str::stream() << "Field '" << name << "' should be an array. . Type is "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            for (auto hostElem : arg.Obj()) {
+                uassert(40687,
+                        str::stream() << "Field '" << name
+                                      << "' should only contain strings. . Type is "
+                                      << typeName(hostElem.type()),
+                        hostElem.type() == String);
+                hosts.push_back(hostElem.String());
+            }
+            uassert(40688, str::stream() << "Field '" << name << "' is empty", !hosts.empty());
         } else if (name == "db") {
             uassert(34405,
                     str::stream() << "Field '" << name << "' should be a string. . Type is "
@@ -558,6 +649,15 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             seconds = arg.number();
+        } else if (name == "opsPerSecond") {
+            uassert(40689,
+                    str::stream() << "Field '" << name << "' should be a number. . Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber());
+            opsPerSecond = arg.number();
+            uassert(40690,
+                    str::stream() << "Field '" << name << "' must not be negative",
+                    opsPerSecond >= 0);
         } else if (name == "useSessions") {
             uassert(40641,
                     str::stream() << "Field '" << name << "' should be a boolean. . Type is "
@@ -615,8 +715,9 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
     }
 }
 
-std::unique_ptr<DBClientBase> BenchRunConfig::createConnection() const {
-    const ConnectionString connectionString = uassertStatusOK(ConnectionString::parse(host));
+std::unique_ptr<DBClientBase> BenchRunConfig::createConnection(size_t connectionIndex) const {
+    const auto& target = hosts.empty() ? host : hosts[connectionIndex % hosts.size()];
+    const ConnectionString connectionString = uassertStatusOK(ConnectionString::parse(target));
 
     std::string errorMessage;
     std::unique_ptr<DBClientBase> connection(connectionString.connect("BenchRun", errorMessage));
@@ -751,10 +852,30 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     std::unique_ptr<Scope> scope{getGlobalScriptEngine()->newScopeForCurrentThread()};
     verify(scope.get());
 
+    // In open-loop mode every worker issues its share of the target rate on a fixed schedule. An
+    // operation which starts late because the previous one was slow is charged for the time it
+    // spent waiting, so the reported latencies reflect what a client arriving on schedule sees.
+    const double scheduleIntervalMicros =
+        _config->opsPerSecond > 0 ? 1000000.0 * _config->parallel / _config->opsPerSecond : 0;
+    Timer scheduleTimer;
+    long long numScheduledOps = 0;
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
                 break;
+
+            long long queuedMicros = 0;
+            if (scheduleIntervalMicros > 0) {
+                const auto intendedStartMicros =
+                    static_cast<long long>(numScheduledOps++ * scheduleIntervalMicros);
+                const auto nowMicros = scheduleTimer.micros();
+                if (nowMicros < intendedStartMicros) {
+                    sleepmicros(intendedStartMicros - nowMicros);
+                }
+                queuedMicros = std::max(0LL, scheduleTimer.micros() - intendedStartMicros);
+            }
+
             auto& stats = shouldCollectStats() ? _stats : _statsBlackHole;
 
             ScriptingFunction scopeFunc = 0;
@@ -802,10 +923,10 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             qr->setWantMore(false);
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, queuedMicros);
                             runQueryWithReadCommands(conn, lsid, std::move(qr), &result);
                         } else {
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, queuedMicros);
                             result = conn->findOne(op.ns,
                                                    fixedQuery,
                                                    nullptr,
@@ -831,7 +952,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         bool ok;
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.commandCounter);
+                            BenchRunEventTrace _bret(&stats.commandCounter, queuedMicros);
                             ok = runCommandWithSession(conn,
                                                        op.ns,
                                                        fixQuery(op.command, bsonTemplateEvaluator),
@@ -918,12 +1039,12 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.queryCounter);
+                            BenchRunEventTrace _bret(&stats.queryCounter, queuedMicros);
                             count = runQueryWithReadCommands(conn, lsid, std::move(qr), nullptr);
                         } else {
                             // Use special query function for exhaust query option.
                             if (op.options & QueryOption_Exhaust) {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, queuedMicros);
                                 stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                                 count = conn->query(
                                     castedDoNothing,
@@ -932,7 +1053,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                     &op.projection,
                                     op.options | DBClientCursor::QueryOptionLocal_forceOpQuery);
                             } else {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, queuedMicros);
                                 std::unique_ptr<DBClientCursor> cursor(conn->query(
                                     op.ns,
                                     fixedQuery,
@@ -967,10 +1088,88 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         if (!_config->hideResults || op.showResult)
                             log() << "Result from benchRun thread [query] : " << count;
                     } break;
+                    case OpType::AGGREGATE: {
+                        const NamespaceString nss(op.ns);
+                        BSONObjBuilder cursorBuilder;
+                        if (op.batchSize) {
+                            cursorBuilder.append("batchSize", op.batchSize);
+                        }
+
+                        BSONObjBuilder cmdBuilder;
+                        cmdBuilder.append("aggregate", nss.coll());
+                        cmdBuilder.appendArray("pipeline",
+                                               fixQuery(op.pipeline, bsonTemplateEvaluator));
+                        cmdBuilder.append("cursor", cursorBuilder.obj());
+                        const BSONObj aggCmd = cmdBuilder.obj();
+
+                        int count;
+                        {
+                            BenchRunEventTrace _bret(&stats.aggregateCounter, queuedMicros);
+                            BSONObj aggCommandResult;
+                            uassert(ErrorCodes::CommandFailed,
+                                    str::stream() << "aggregate command failed; reply was: "
+                                                  << aggCommandResult,
+                                    runCommandWithSession(conn,
+                                                          nss.db().toString(),
+                                                          aggCmd,
+                                                          kNoOptions,
+                                                          lsid,
+                                                          &aggCommandResult));
+
+                            auto cursorResponse =
+                                uassertStatusOK(CursorResponse::parseFromBSON(aggCommandResult));
+                            count = cursorResponse.getBatch().size();
+                            while (cursorResponse.getCursorId() != 0) {
+                                GetMoreRequest getMoreRequest(
+                                    cursorResponse.getNSS(),
+                                    cursorResponse.getCursorId(),
+                                    op.batchSize ? boost::optional<long long>(op.batchSize)
+                                                 : boost::none,
+                                    boost::none,   // maxTimeMS
+                                    boost::none,   // term
+                                    boost::none);  // lastKnownCommittedOpTime
+                                BSONObj getMoreCommandResult;
+                                uassert(ErrorCodes::CommandFailed,
+                                        str::stream() << "getMore command failed; reply was: "
+                                                      << getMoreCommandResult,
+                                        runCommandWithSession(conn,
+                                                              nss.db().toString(),
+                                                              getMoreRequest.toBSON(),
+                                                              kNoOptions,
+                                                              lsid,
+                                                              &getMoreCommandResult));
+                                cursorResponse = uassertStatusOK(
+                                    CursorResponse::parseFromBSON(getMoreCommandResult));
+                                count += cursorResponse.getBatch().size();
+                            }
+                        }
+
+                        if (op.expected >= 0 && count != op.expected) {
+                            log() << "bench aggregate on: " << op.ns << " expected: " << op.expected
+                                  << " got: " << count;
+                            verify(false);
+                        }
+
+                        if (op.useCheck) {
+                            BSONObj thisValue = BSON("count" << count << "context" << op.context);
+                            int err = scope->invoke(scopeFunc, 0, &thisValue, 1000 * 60, false);
+                            if (err) {
+                                log() << "Error checking in benchRun thread [aggregate]"
+                                      << causedBy(scope->getError());
+
+                                stats.errCount++;
+
+                                return;
+                            }
+                        }
+
+                        if (!_config->hideResults || op.showResult)
+                            log() << "Result from benchRun thread [aggregate] : " << count;
+                    } break;
                     case OpType::UPDATE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.updateCounter);
+                            BenchRunEventTrace _bret(&stats.updateCounter, queuedMicros);
                             BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
                             BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
 
@@ -1032,7 +1231,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::INSERT: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.insertCounter);
+                            BenchRunEventTrace _bret(&stats.insertCounter, queuedMicros);
 
                             BSONObj insertDoc;
                             if (op.useWriteCmd) {
@@ -1106,7 +1305,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::REMOVE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.deleteCounter);
+                            BenchRunEventTrace _bret(&stats.deleteCounter, queuedMicros);
                             BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
                             if (op.useWriteCmd) {
                                 BSONObjBuilder builder;
@@ -1236,7 +1435,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
 void BenchRunWorker::run() {
     try {
-        auto conn(_config->createConnection());
+        auto conn(_config->createConnection(_id));
 
         if (!_config->username.empty()) {
             std::string errmsg;
@@ -1377,6 +1576,27 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable("updateLatencyAverageMicros", stats.updateCounter);
     appendAverageMicrosIfAvailable("queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable("commandsLatencyAverageMicros", stats.commandCounter);
+    appendAverageMicrosIfAvailable("aggregateLatencyAverageMicros", stats.aggregateCounter);
+
+    const auto appendPercentilesIfAvailable = [&buf](StringData name,
+                                                     const BenchRunEventCounter& counter) {
+        if (counter.getNumEvents() > 0) {
+            BSONObjBuilder percentiles(buf.subobjStart(name));
+            percentiles.append("p50", counter.getPercentileMicros(50));
+            percentiles.append("p95", counter.getPercentileMicros(95));
+            percentiles.append("p99", counter.getPercentileMicros(99));
+            percentiles.append("p999", counter.getPercentileMicros(99.9));
+            percentiles.append("max", counter.getMaxTimeMicros());
+        }
+    };
+
+    appendPercentilesIfAvailable("findOneLatencyPercentilesMicros", stats.findOneCounter);
+    appendPercentilesIfAvailable("insertLatencyPercentilesMicros", stats.insertCounter);
+    appendPercentilesIfAvailable("deleteLatencyPercentilesMicros", stats.deleteCounter);
+    appendPercentilesIfAvailable("updateLatencyPercentilesMicros", stats.updateCounter);
+    appendPercentilesIfAvailable("queryLatencyPercentilesMicros", stats.queryCounter);
+    appendPercentilesIfAvailable("commandsLatencyPercentilesMicros", stats.commandCounter);
+    appendPercentilesIfAvailable("aggregateLatencyPercentilesMicros", stats.aggregateCounter);
 
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
@@ -1391,6 +1611,7 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendPerSec("update", stats.updateCounter.getNumEvents());
     appendPerSec("query", stats.queryCounter.getNumEvents());
     appendPerSec("command", stats.commandCounter.getNumEvents());
+    appendPerSec("aggregate", stats.aggregateCounter.getNumEvents());
 
     BSONObj zoo = buf.obj();
 
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional.hpp>
 #include <string>
 
@@ -56,7 +57,8 @@ enum class OpType {
     CREATEINDEX,
     DROPINDEX,
     LET,
-    CPULOAD
+    CPULOAD,
+    AGGREGATE
 };
 
 /**
@@ -80,6 +82,7 @@ public:
     std::string ns;
     OpType op = OpType::NONE;
     int options = 0;
+    BSONObj pipeline;
     BSONObj projection;
     BSONObj query;
     bool safe = false;
@@ -119,14 +122,23 @@ public:
 
     void initializeFromBson(const BSONObj& args);
 
-    // Create a new connection to the mongo instance specified by this configuration.
-    std::unique_ptr<DBClientBase> createConnection() const;
+    /**
+     * Create a new connection to the mongo instance specified by this configuration. When several
+     * hosts are configured, 'connectionIndex' selects one of them in round-robin order.
+     */
+    std::unique_ptr<DBClientBase> createConnection(size_t connectionIndex = 0) const;
 
     /**
      * Connection std::string describing the host to which to connect.
      */
     std::string host;
 
+    /**
+     * Optional list of connection strings, e.g. one per mongos. When non-empty, it takes the place
+     * of 'host' and the worker threads are spread across the entries.
+     */
+    std::vector<std::string> hosts;
+
     /**
      * Name of the database on which to operate.
      */
@@ -156,6 +168,15 @@ public:
      */
     double seconds;
 
+    /**
+     * Target aggregate arrival rate across all threads, in operations per second. When zero (the
+     * default) each thread issues its next operation as soon as the previous one completes. When
+     * positive, operations are issued on a fixed schedule and their latency is measured from the
+     * time at which they were scheduled to start, so that a stalled server is not hidden by the
+     * load generator backing off (coordinated omission).
+     */
+    double opsPerSecond{0};
+
     /**
      * Whether the individual benchRun thread connections should be creating and using sessions.
      */
@@ -215,10 +236,7 @@ public:
     /**
      * Count one instance of the event, which took "timeMicros" microseconds.
      */
-    void countOne(long long timeMicros) {
-        ++_numEvents;
-        _totalTimeMicros += timeMicros;
-    }
+    void countOne(long long timeMicros);
 
     /**
      * Get the total number of microseconds ellapsed during all observed events.
@@ -234,9 +252,34 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the longest observed event, in microseconds.
+     */
+    long long getMaxTimeMicros() const {
+        return _maxTimeMicros;
+    }
+
+    /**
+     * Get an upper bound on the latency, in microseconds, below which "percentile" percent of the
+     * observed events fall. The bound is within roughly 6% of the exact value. Returns 0 if no
+     * events were observed.
+     */
+    long long getPercentileMicros(double percentile) const;
+
 private:
+    // Latencies are kept in a log-linear histogram: values up to kSubBuckets are recorded
+    // exactly, and every power of two above that is split into kSubBuckets equal-width buckets.
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets = kSubBuckets * (64 - kSubBucketBits + 1);
+
+    static int _bucketIndex(unsigned long long timeMicros);
+    static long long _bucketUpperBound(int index);
+
     long long _totalTimeMicros{0};
     unsigned long long _numEvents{0};
+    long long _maxTimeMicros{0};
+    std::array<unsigned long long, kNumBuckets> _buckets{};
 };
 
 /**
@@ -260,6 +303,15 @@ public:
         initialize(eventCounter, eventCounter, false);
     }
 
+    /**
+     * Traces an event which was due to start "queuedMicros" microseconds ago. The delay is added
+     * to the recorded latency.
+     */
+    BenchRunEventTrace(BenchRunEventCounter* eventCounter, long long queuedMicros)
+        : _queuedMicros(queuedMicros) {
+        initialize(eventCounter, eventCounter, false);
+    }
+
     BenchRunEventTrace(BenchRunEventCounter* successCounter,
                        BenchRunEventCounter* failCounter,
                        bool defaultToFailure = true) {
@@ -267,7 +319,7 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)->countOne(_queuedMicros + _timer.micros());
     }
 
     void succeed() {
@@ -287,6 +339,7 @@ private:
     }
 
     Timer _timer;
+    long long _queuedMicros{0};
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -309,6 +362,7 @@ struct BenchRunStats {
     BenchRunEventCounter deleteCounter;
     BenchRunEventCounter queryCounter;
     BenchRunEventCounter commandCounter;
+    BenchRunEventCounter aggregateCounter;
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
@@ -40,6 +41,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/scopeguard.h"
 
 #include <string>
 #include <vector>
@@ -233,6 +235,21 @@ TEST(ZlibMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
 }
 
+TEST(ZlibMessageCompressor, FidelityAtEveryCompressionLevel) {
+    auto levelParam =
+        ServerParameterSet::getGlobal()->getMap().find("zlibMessageCompressionLevel")->second;
+    ON_BLOCK_EXIT([&] { levelParam->setFromString("-1").transitional_ignore(); });
+
+    auto testMessage = buildMessage();
+    for (int level = 1; level <= 9; ++level) {
+        ASSERT_OK(levelParam->setFromString(std::to_string(level)));
+        checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
+    }
+
+    ASSERT_NOT_OK(levelParam->setFromString("0"));
+    ASSERT_NOT_OK(levelParam->setFromString("10"));
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<SnappyMessageCompressor>());
 }
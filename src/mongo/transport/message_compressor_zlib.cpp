@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zlib.h"
@@ -38,6 +39,37 @@
 #include <zlib.h>
 
 namespace mongo {
+namespace {
+
+/**
+ * zlib level used to compress outgoing messages, from 1 (fastest) to 9 (smallest), or -1 for the
+ * zlib default. Decompression does not depend on the level the peer compressed with, so this can
+ * be tuned per node, e.g. raised on links where bandwidth is more expensive than CPU.
+ */
+AtomicInt32 zlibMessageCompressionLevel(Z_DEFAULT_COMPRESSION);
+
+class ExportedZlibMessageCompressionLevelParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedZlibMessageCompressionLevelParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "zlibMessageCompressionLevel",
+              &zlibMessageCompressionLevel) {}
+
+    Status validate(const std::int32_t& potentialNewValue) override {
+        if (potentialNewValue != Z_DEFAULT_COMPRESSION &&
+            (potentialNewValue < Z_BEST_SPEED || potentialNewValue > Z_BEST_COMPRESSION)) {
+            return Status(ErrorCodes::BadValue,
+                          "zlibMessageCompressionLevel must be -1 or between 1 and 9");
+        }
+
+        return Status::OK();
+    }
+
+} exportedZlibMessageCompressionLevelParam;
+
+}  // namespace
 
 ZlibMessageCompressor::ZlibMessageCompressor() : MessageCompressorBase(MessageCompressor::kZlib) {}
 
@@ -52,7 +84,7 @@ StatusWith<std::size_t> ZlibMessageCompressor::compressData(ConstDataRange input
                           reinterpret_cast<uLongf*>(&outLength),
                           reinterpret_cast<const Bytef*>(input.data()),
                           input.length(),
-                          Z_DEFAULT_COMPRESSION);
+                          zlibMessageCompressionLevel.load());
 
     if (ret != Z_OK) {
         return Status{ErrorCodes::BadValue, "Could not compress input"};
@@ -63,6 +63,10 @@ public:
         // MayYieldBeforeSchedule indicates that the executor may yield on the current thread before
         // scheduling the task.
         kMayYieldBeforeSchedule = 1 << 3,
+
+        // PriorityTask indicates that the task is latency critical and may be run ahead of tasks
+        // that were queued before it. Executors that do not queue tasks ignore this flag.
+        kPriorityTask = 1 << 4,
     };
 
     /*
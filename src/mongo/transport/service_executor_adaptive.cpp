@@ -78,6 +78,10 @@ MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorIdlePctThreshold, int, 60);
 // value.
 MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorRecursionLimit, int, 8);
 
+// When set on a system with several NUMA nodes, each worker thread is pinned to the CPUs of one
+// node, with threads assigned to nodes round-robin.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(adaptiveServiceExecutorPinWorkersToNumaNodes, bool, false);
+
 constexpr auto kTotalQueued = "totalQueued"_sd;
 constexpr auto kTotalExecuted = "totalExecuted"_sd;
 constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
@@ -86,6 +90,8 @@ constexpr auto kTotalTimeQueuedUs = "totalTimeQueuedMicros"_sd;
 constexpr auto kThreadsInUse = "threadsInUse"_sd;
 constexpr auto kThreadsRunning = "threadsRunning"_sd;
 constexpr auto kThreadsPending = "threadsPending"_sd;
+constexpr auto kPriorityTasksQueued = "priorityTasksQueued"_sd;
+constexpr auto kTotalPriorityExecuted = "totalPriorityExecuted"_sd;
 constexpr auto kExecutorLabel = "executor"_sd;
 constexpr auto kExecutorName = "adaptive"_sd;
 
@@ -141,6 +147,10 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool pinWorkersToNumaNodes() const final {
+        return adaptiveServiceExecutorPinWorkersToNumaNodes;
+    }
 };
 
 }  // namespace
@@ -166,6 +176,16 @@ ServiceExecutorAdaptive::~ServiceExecutorAdaptive() {
 
 Status ServiceExecutorAdaptive::start() {
     invariant(!_isRunning.load());
+    if (_config->pinWorkersToNumaNodes()) {
+        _numaNodeCpus = ProcessInfo::getNumaNodeCpus();
+        if (_numaNodeCpus.empty()) {
+            log() << "Not pinning worker threads to NUMA nodes since the system does not have "
+                     "more than one";
+        } else {
+            log() << "Pinning worker threads to " << _numaNodeCpus.size() << " NUMA nodes";
+        }
+    }
+
     _isRunning.store(true);
     _controllerThread = stdx::thread(&ServiceExecutorAdaptive::_controllerThreadRoutine, this);
     for (auto i = 0; i < _config->reservedThreads(); i++) {
@@ -206,7 +226,21 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
     }
 
-    auto wrappedTask = [ this, task = std::move(task), scheduleTime, pendingCounterPtr, taskName ] {
+    const bool isPriorityTask = flags & kPriorityTask;
+    auto wrappedTask = [
+        this,
+        task = std::move(task),
+        scheduleTime,
+        pendingCounterPtr,
+        taskName,
+        isPriorityTask
+    ] {
+        // Give latency critical tasks a chance to run before this one. At most one is run per
+        // regular task so that a flood of priority tasks cannot starve everything else.
+        if (!isPriorityTask && _localThreadState->recursionDepth == 0) {
+            _runPriorityTasks(1);
+        }
+
         pendingCounterPtr->subtractAndFetch(1);
         auto start = _tickSource->getTicks();
         _totalSpentQueued.addAndFetch(start - scheduleTime);
@@ -241,9 +275,19 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
     // can be called immediately and recursively.
+    //
+    // Priority tasks that cannot be dispatched go on the priority queue, where the next worker to
+    // start a task will find them, and a task to drain them is posted in case none does first.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _ioContext->dispatch(std::move(wrappedTask));
+    } else if (isPriorityTask) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_priorityTasksMutex);
+            _priorityTasks.emplace_back(std::move(wrappedTask));
+        }
+        _priorityTasksQueued.addAndFetch(1);
+        _ioContext->post([this] { _runPriorityTasks(1); });
     } else {
         _ioContext->post(std::move(wrappedTask));
     }
@@ -263,6 +307,23 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     return Status::OK();
 }
 
+void ServiceExecutorAdaptive::_runPriorityTasks(size_t maxTasks) {
+    for (size_t i = 0; i < maxTasks && _priorityTasksQueued.load() > 0; ++i) {
+        Task task;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_priorityTasksMutex);
+            if (_priorityTasks.empty()) {
+                return;
+            }
+            task = std::move(_priorityTasks.front());
+            _priorityTasks.pop_front();
+        }
+        _priorityTasksQueued.subtractAndFetch(1);
+        _totalPriorityExecuted.addAndFetch(1);
+        task();
+    }
+}
+
 bool ServiceExecutorAdaptive::_isStarved() const {
     // If threads are still starting, then assume we won't be starved pretty soon, return false
     if (_threadsPending.load() > 0)
@@ -489,6 +550,13 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
 
     log() << "Started new database worker thread " << threadId;
 
+    if (!_numaNodeCpus.empty()) {
+        const auto node = _nextNumaNode.fetchAndAdd(1) % _numaNodeCpus.size();
+        if (!ProcessInfo::bindCurrentThreadToCpus(_numaNodeCpus[node])) {
+            warning() << "Failed to pin worker thread " << threadId << " to NUMA node " << node;
+        }
+    }
+
     // Whether a thread is "pending" reflects whether its had a chance to do any useful work.
     // When a thread is pending, it will only try to run one task through ASIO, and report back
     // as soon as possible so that the thread controller knows not to keep starting threads while
@@ -631,7 +699,9 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
             << ticksToMicros(_getThreadTimerTotal(ThreadTimer::Executing, lk), _tickSource)  //
             << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource)    //
             << kThreadsRunning << _threadsRunning.load()                                     //
-            << kThreadsPending << _threadsPending.load();
+            << kThreadsPending << _threadsPending.load()                                     //
+            << kPriorityTasksQueued << _priorityTasksQueued.load()                           //
+            << kTotalPriorityExecuted << _totalPriorityExecuted.load();
 
     BSONObjBuilder metricsByTask(section.subobjStart("metricsByTask"));
     MetricsArray totalMetrics;
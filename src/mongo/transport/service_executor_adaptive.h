@@ -29,6 +29,7 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <vector>
 
 #include "mongo/db/service_context.h"
@@ -80,6 +81,10 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether worker threads are spread round-robin across the NUMA nodes of the system, each
+        // restricted to the CPUs of its node, so that the memory they allocate stays local.
+        virtual bool pinWorkersToNumaNodes() const = 0;
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, std::shared_ptr<asio::io_context> ioCtx);
@@ -194,6 +199,7 @@ private:
     void _controllerThreadRoutine();
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
+    void _runPriorityTasks(size_t maxTasks);
 
     enum class ThreadTimer { Running, Executing };
 
@@ -207,6 +213,11 @@ private:
 
     std::unique_ptr<Options> _config;
 
+    // The CPUs of each NUMA node worker threads are pinned to, indexed by node. Empty unless
+    // pinWorkersToNumaNodes() is set and the system has more than one node.
+    std::vector<std::vector<int>> _numaNodeCpus;
+    AtomicWord<unsigned> _nextNumaNode{0};
+
     mutable stdx::mutex _threadsMutex;
     ThreadList _threads;
     stdx::thread _controllerThread;
@@ -225,8 +236,16 @@ private:
     AtomicWord<TickSource::Tick> _pastThreadsSpentRunning{0};
     static thread_local ThreadState* _localThreadState;
 
+    // Tasks scheduled with kPriorityTask that have not run yet. Each of them also has a drain
+    // task posted on the io_context, but any worker picks the oldest one up before starting its
+    // next regular task, so they do not wait behind everything queued on the io_context.
+    stdx::mutex _priorityTasksMutex;
+    std::deque<Task> _priorityTasks;
+    AtomicWord<int> _priorityTasksQueued{0};
+
     // These counters are only used for reporting in serverStatus.
     AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalPriorityExecuted{0};
     AtomicWord<int64_t> _totalExecuted{0};
     AtomicWord<TickSource::Tick> _totalSpentQueued{0};
 
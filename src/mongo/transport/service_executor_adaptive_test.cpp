@@ -72,6 +72,10 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int maxRecursion() const final {
         return 0;
     }
+
+    bool pinWorkersToNumaNodes() const final {
+        return false;
+    }
 };
 
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
@@ -32,6 +32,7 @@
 
 #include "boost/optional.hpp"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/transport/service_executor_adaptive.h"
 #include "mongo/transport/service_executor_synchronous.h"
@@ -74,6 +75,10 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool pinWorkersToNumaNodes() const final {
+        return false;
+    }
 };
 
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
@@ -106,7 +111,9 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
-void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
+void scheduleBasicTask(ServiceExecutor* exec,
+                       bool expectSuccess,
+                       ServiceExecutor::ScheduleFlags flags = ServiceExecutor::kEmptyFlags) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
     auto task = [&cond, &mutex] {
@@ -115,8 +122,7 @@ void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     };
 
     stdx::unique_lock<stdx::mutex> lk(mutex);
-    auto status = exec->schedule(
-        std::move(task), ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession);
+    auto status = exec->schedule(std::move(task), flags, ServiceExecutorTaskName::kSSMStartSession);
     if (expectSuccess) {
         ASSERT_OK(status);
         cond.wait(lk);
@@ -132,6 +138,18 @@ TEST_F(ServiceExecutorAdaptiveFixture, BasicTaskRuns) {
     scheduleBasicTask(executor.get(), true);
 }
 
+TEST_F(ServiceExecutorAdaptiveFixture, PriorityTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    scheduleBasicTask(executor.get(), true, ServiceExecutor::kPriorityTask);
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj()["serviceExecutorTaskStats"].Obj();
+    ASSERT_EQ(stats["totalPriorityExecuted"].numberLong(), 1);
+}
+
 TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
@@ -35,6 +35,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
@@ -56,6 +57,11 @@
 
 namespace mongo {
 namespace {
+
+// When set, work for sessions from other cluster members (replication, heartbeats, mongos) is
+// scheduled as priority tasks, so that a backlog of client requests does not delay it.
+MONGO_EXPORT_SERVER_PARAMETER(serviceExecutorPrioritizeInternalClients, bool, false);
+
 // Set up proper headers for formatting an exhaust request, if we need to
 bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     MsgData::View header = dbresponse.response.header();
@@ -89,6 +95,20 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Sets up the OP_MSG command that continues an exhaust cursor as the next message to process
+void setOpMsgExhaustMessage(Message* m, const DbResponse& dbresponse) {
+    invariant(!dbresponse.nextInvocation.isEmpty());
+    const auto responseId = dbresponse.response.header().getId();
+
+    OpMsg next;
+    next.body = dbresponse.nextInvocation;
+    *m = next.serialize();
+    OpMsg::setFlag(m, OpMsg::kExhaustSupported);
+
+    // Like the legacy exhaust path, each reply is sent in response to the previous one.
+    m->header().setId(responseId);
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -380,6 +400,9 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
+        } else if (!dbresponse.nextInvocation.isEmpty()) {
+            setOpMsgExhaustMessage(&_inMessage, dbresponse);
+            _inExhaust = true;
         } else {
             _inExhaust = false;
             _inMessage.reset();
@@ -461,6 +484,11 @@ void ServiceStateMachine::_scheduleNextWithGuard(ThreadGuard guard,
                                                  transport::ServiceExecutor::ScheduleFlags flags,
                                                  transport::ServiceExecutorTaskName taskName,
                                                  Ownership ownershipModel) {
+    if (serviceExecutorPrioritizeInternalClients.load() &&
+        (_session()->getTags() & transport::Session::kInternalClient)) {
+        flags = flags | transport::ServiceExecutor::kPriorityTask;
+    }
+
     auto func = [ ssm = shared_from_this(), ownershipModel ] {
         ThreadGuard guard(ssm.get());
         if (ownershipModel == Ownership::kStatic)
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/service_state_machine.h"
+#include "mongo/transport/transport_layer_mock.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/clock_source_mock.h"
+#include "mongo/util/net/op_msg.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+using namespace transport;
+
+/**
+ * Replies {ok: 1} to every request without running a command, so only the state machine, message
+ * and Client/OperationContext overheads are measured.
+ */
+class PingSEP : public ServiceEntryPoint {
+public:
+    void startSession(SessionHandle session) override {}
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        OpMsgBuilder builder;
+        builder.setBody(BSON("ok" << 1));
+        return DbResponse{builder.finish()};
+    }
+
+    void endAllSessions(Session::TagMask tags) override {}
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    Stats sessionStats() const override {
+        return {};
+    }
+
+    size_t numOpenSessions() const override {
+        return 0ULL;
+    }
+};
+
+/**
+ * Sources the same ping request forever.
+ */
+class PingTL : public TransportLayerMock {
+public:
+    PingTL() {
+        OpMsgBuilder builder;
+        builder.setBody(BSON("ping" << 1));
+        _request = builder.finish();
+    }
+
+    Ticket sourceMessage(const SessionHandle& session,
+                         Message* message,
+                         Date_t expiration = Ticket::kNoExpirationDate) override {
+        *message = _request;
+        return TransportLayerMock::sourceMessage(session, message, expiration);
+    }
+
+    void asyncWait(Ticket&& ticket, TicketCallback callback) override {
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    Message _request;
+};
+
+class NoopServiceExecutor : public ServiceExecutor {
+public:
+    Status start() override {
+        return Status::OK();
+    }
+
+    Status shutdown(Milliseconds timeout) override {
+        return Status::OK();
+    }
+
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override {
+        return Status::OK();
+    }
+
+    Mode transportMode() const override {
+        return Mode::kSynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override {}
+};
+
+PingTL* pingTL;
+
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    auto sc = stdx::make_unique<ServiceContextNoop>();
+
+    sc->setTickSource(stdx::make_unique<TickSourceMock>());
+    sc->setFastClockSource(stdx::make_unique<ClockSourceMock>());
+    sc->setServiceEntryPoint(stdx::make_unique<PingSEP>());
+    sc->setServiceExecutor(stdx::make_unique<NoopServiceExecutor>());
+
+    auto tl = stdx::make_unique<PingTL>();
+    pingTL = tl.get();
+    sc->setTransportLayer(std::move(tl));
+
+    setGlobalServiceContext(std::move(sc));
+
+    return pingTL->start();
+}
+
+// One iteration sources a request, runs it through the entry point, and sinks the reply
+MONGO_BENCHMARK(ServiceStateMachinePingRoundTrip) {
+    auto ssm = ServiceStateMachine::create(
+        getGlobalServiceContext(), pingTL->createSession(), Mode::kSynchronous);
+
+    while (state.keepRunning()) {
+        // Source -> Process
+        ssm->runNext();
+        // Process -> Sink -> Source
+        ssm->runNext();
+    }
+
+    invariant(ssm->state() == ServiceStateMachine::State::Source);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -70,6 +70,7 @@ public:
 
         auto req = OpMsgRequest::parse(request);
         ASSERT_BSONOBJ_EQ(BSON("ping" << 1), req.body);
+        _lastRequestAllowedExhaust = OpMsg::isFlagSet(request, OpMsg::kExhaustSupported);
 
         // Build out a dummy reply
         OpMsgBuilder builder;
@@ -78,6 +79,11 @@ public:
         if (_uassertInHandler)
             uassert(40469, "Synthetic uassert failure", false);
 
+        if (_exhaustReplies > 0) {
+            --_exhaustReplies;
+            return DbResponse{builder.finish(), {}, BSON("ping" << 1)};
+        }
+
         return DbResponse{builder.finish()};
     }
 
@@ -105,9 +111,19 @@ public:
         return ret;
     }
 
+    void setExhaustReplies(int exhaustReplies) {
+        _exhaustReplies = exhaustReplies;
+    }
+
+    bool lastRequestAllowedExhaust() const {
+        return _lastRequestAllowedExhaust;
+    }
+
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    int _exhaustReplies = 0;
+    bool _lastRequestAllowedExhaust = false;
 };
 
 using namespace transport;
@@ -341,6 +357,27 @@ TEST_F(ServiceStateMachineFixture, TestOkaySimpleCommand) {
     checkPingOk();
 }
 
+TEST_F(ServiceStateMachineFixture, TestOpMsgExhaustRunsAgainWithoutSourcing) {
+    _sep->setExhaustReplies(2);
+
+    // The first reply asks for the command to be run again, so the next step processes the
+    // synthesized request instead of sourcing a new one.
+    runPingTest(State::Process, State::Process);
+    checkPingOk();
+    ASSERT_FALSE(_sep->lastRequestAllowedExhaust());
+
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+    checkPingOk();
+    ASSERT_TRUE(_sep->lastRequestAllowedExhaust());
+
+    // The last reply ends the stream and the state machine goes back to sourcing requests.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    checkPingOk();
+    ASSERT_TRUE(_sep->lastRequestAllowedExhaust());
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
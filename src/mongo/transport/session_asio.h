@@ -35,6 +35,7 @@
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/transport_layer_asio.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/shared_buffer.h"
 #ifdef MONGO_CONFIG_SSL
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_types.h"
@@ -113,6 +114,30 @@ public:
 #endif
     }
 
+    /**
+     * Returns the buffer the previous incoming Message was read into, if nothing else refers to it
+     * anymore, so that sourcing a small message does not need a fresh allocation. Returns a null
+     * SharedBuffer otherwise.
+     */
+    SharedBuffer takeRecvBuffer() {
+        if (!_recvBuffer || _recvBuffer.isShared()) {
+            return SharedBuffer();
+        }
+        return std::move(_recvBuffer);
+    }
+
+    /**
+     * Remembers the buffer an incoming Message was read into so that it can be reused for the next
+     * one once that Message has been released. Large buffers are not kept alive on idle sessions.
+     */
+    void cacheRecvBuffer(const SharedBuffer& buffer) {
+        if (buffer.capacity() <= kMaxCachedRecvBufferSize) {
+            _recvBuffer = buffer;
+        } else {
+            _recvBuffer = SharedBuffer();
+        }
+    }
+
     template <typename MutableBufferSequence, typename CompleteHandler>
     void read(bool sync, const MutableBufferSequence& buffers, CompleteHandler&& handler) {
 #ifdef MONGO_CONFIG_SSL
@@ -170,6 +195,8 @@ public:
     }
 
 private:
+    static constexpr size_t kMaxCachedRecvBufferSize = 16 * 1024;
+
     template <typename Stream, typename MutableBufferSequence, typename CompleteHandler>
     void opportunisticRead(bool sync,
                            Stream& stream,
@@ -300,6 +327,9 @@ private:
     bool _ranHandshake = false;
 #endif
 
+    // Only touched by the source ticket currently being filled, of which there is at most one.
+    SharedBuffer _recvBuffer;
+
     TransportLayerASIO* const _tl;
 };
 
@@ -78,6 +78,9 @@ void TransportLayerASIO::ASIOSourceTicket::_bodyCallback(const std::error_code&
         return;
     }
 
+    if (auto session = getSession()) {
+        session->cacheRecvBuffer(_buffer);
+    }
     _target->setData(std::move(_buffer));
     networkCounter.hitPhysicalIn(_target->size());
     finishFill(Status::OK());
@@ -110,7 +113,9 @@ void TransportLayerASIO::ASIOSourceTicket::_headerCallback(const std::error_code
         return;
     }
 
-    _buffer.realloc(msgLen);
+    if (_buffer.capacity() < msgLen) {
+        _buffer.realloc(msgLen);
+    }
     MsgData::View msgView(_buffer.get());
 
     session->read(isSync(),
@@ -124,7 +129,10 @@ void TransportLayerASIO::ASIOSourceTicket::fillImpl() {
         return;
 
     const auto initBufSize = kHeaderSize;
-    _buffer = SharedBuffer::allocate(initBufSize);
+    _buffer = session->takeRecvBuffer();
+    if (_buffer.capacity() < initBufSize) {
+        _buffer = SharedBuffer::allocate(initBufSize);
+    }
 
     session->read(isSync(),
                   asio::buffer(_buffer.get(), initBufSize),
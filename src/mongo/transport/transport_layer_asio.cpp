@@ -43,12 +43,14 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/system_error.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/ticket.h"
 #include "mongo/transport/ticket_asio.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/sock.h"
@@ -61,6 +63,19 @@
 
 namespace mongo {
 namespace transport {
+namespace {
+
+// Number of listener threads to run, each with its own io_context and its own SO_REUSEPORT
+// acceptor for every TCP bind address, so that the kernel spreads incoming connections across
+// them. Note that with more than one listener a second process bound to the same port by the same
+// user will share connections rather than fail to start.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(transportLayerASIOListenerCount, int, 1);
+
+#ifdef SO_REUSEPORT
+using ReusePortOption = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+}  // namespace
 
 TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
     : port(params->port),
@@ -75,7 +90,6 @@ TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
 TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
                                        ServiceEntryPoint* sep)
     : _workerIOContext(std::make_shared<asio::io_context>()),
-      _acceptorIOContext(stdx::make_unique<asio::io_context>()),
 #ifdef MONGO_CONFIG_SSL
       _sslContext(nullptr),
 #endif
@@ -147,6 +161,24 @@ Status TransportLayerASIO::setup() {
 
     _listenerPort = _listenerOptions.port;
 
+    size_t listenerCount = 1;
+    if (transportLayerASIOListenerCount < 1) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "transportLayerASIOListenerCount must be at least 1, got "
+                                    << transportLayerASIOListenerCount);
+    }
+#ifdef SO_REUSEPORT
+    listenerCount = static_cast<size_t>(transportLayerASIOListenerCount);
+#else
+    if (transportLayerASIOListenerCount > 1) {
+        warning() << "SO_REUSEPORT is not supported on this platform, "
+                  << "ignoring transportLayerASIOListenerCount";
+    }
+#endif
+    for (size_t i = 0; i < listenerCount; ++i) {
+        _acceptorIOContexts.emplace_back(stdx::make_unique<asio::io_context>());
+    }
+
     for (auto& ip : listenAddrs) {
         std::error_code ec;
         if (ip.empty()) {
@@ -178,44 +210,67 @@ Status TransportLayerASIO::setup() {
                 fassertFailedNoTrace(40488);
             }
 
-            GenericAcceptor acceptor(*_acceptorIOContext);
-            acceptor.open(endpoint.protocol());
-            acceptor.set_option(GenericAcceptor::reuse_address(true));
+            // UNIX domain sockets do not support spreading connections across SO_REUSEPORT
+            // listeners, so they always get a single acceptor on the first listener.
+            const bool isTCP = addr.getType() == AF_INET || addr.getType() == AF_INET6;
+            const size_t numAcceptors = isTCP ? _acceptorIOContexts.size() : 1;
+
+            for (size_t i = 0; i < numAcceptors; ++i) {
+                GenericAcceptor acceptor(*_acceptorIOContexts[i]);
+                acceptor.open(endpoint.protocol());
+                acceptor.set_option(GenericAcceptor::reuse_address(true));
+
+#ifdef SO_REUSEPORT
+                if (numAcceptors > 1) {
+                    acceptor.set_option(ReusePortOption(true), ec);
+                    if (ec) {
+                        return errorCodeToStatus(ec);
+                    }
+                }
+#endif
 
-            acceptor.non_blocking(true, ec);
-            if (ec) {
-                return errorCodeToStatus(ec);
-            }
+                acceptor.non_blocking(true, ec);
+                if (ec) {
+                    return errorCodeToStatus(ec);
+                }
 
-            acceptor.bind(endpoint, ec);
-            if (ec) {
-                return errorCodeToStatus(ec);
-            }
+                acceptor.bind(endpoint, ec);
+                if (ec) {
+                    return errorCodeToStatus(ec);
+                }
+
+                if (i > 0) {
+                    _acceptors.emplace_back(addr, std::move(acceptor));
+                    continue;
+                }
 
 #ifndef _WIN32
-            if (addr.getType() == AF_UNIX) {
-                if (::chmod(ip.c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
-                    error() << "Failed to chmod socket file " << ip << " "
-                            << errnoWithDescription(errno);
-                    fassertFailedNoTrace(40487);
+                if (addr.getType() == AF_UNIX) {
+                    if (::chmod(ip.c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
+                        error() << "Failed to chmod socket file " << ip << " "
+                                << errnoWithDescription(errno);
+                        fassertFailedNoTrace(40487);
+                    }
                 }
-            }
 #endif
-            if (_listenerOptions.port == 0 &&
-                (addr.getType() == AF_INET || addr.getType() == AF_INET6)) {
-                if (_listenerPort != _listenerOptions.port) {
-                    return Status(ErrorCodes::BadValue,
-                                  "Port 0 (ephemeral port) is not allowed when"
-                                  " listening on multiple IP interfaces");
-                }
-                std::error_code ec;
-                auto endpoint = acceptor.local_endpoint(ec);
-                if (ec) {
-                    return errorCodeToStatus(ec);
+                if (_listenerOptions.port == 0 && isTCP) {
+                    if (_listenerPort != _listenerOptions.port) {
+                        return Status(ErrorCodes::BadValue,
+                                      "Port 0 (ephemeral port) is not allowed when"
+                                      " listening on multiple IP interfaces");
+                    }
+                    std::error_code ec;
+                    auto localEndpoint = acceptor.local_endpoint(ec);
+                    if (ec) {
+                        return errorCodeToStatus(ec);
+                    }
+                    _listenerPort = endpointToHostAndPort(localEndpoint).port();
+
+                    // The remaining listeners must share the port the kernel just picked.
+                    endpoint = localEndpoint;
                 }
-                _listenerPort = endpointToHostAndPort(endpoint).port();
+                _acceptors.emplace_back(addr, std::move(acceptor));
             }
-            _acceptors.emplace_back(std::move(addr), std::move(acceptor));
         }
     }
 
@@ -245,18 +300,25 @@ Status TransportLayerASIO::start() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _running.store(true);
 
-    _listenerThread = stdx::thread([this] {
-        setThreadName("listener");
-        while (_running.load()) {
-            asio::io_context::work work(*_acceptorIOContext);
-            try {
-                _acceptorIOContext->run();
-            } catch (...) {
-                severe() << "Uncaught exception in the listener: " << exceptionToStatus();
-                fassertFailed(40491);
+    for (size_t i = 0; i < _acceptorIOContexts.size(); ++i) {
+        auto acceptorIOContext = _acceptorIOContexts[i].get();
+        _listenerThreads.emplace_back([this, i, acceptorIOContext] {
+            std::string threadName = "listener";
+            if (i > 0) {
+                threadName = str::stream() << threadName << "-" << i;
             }
-        }
-    });
+            setThreadName(threadName);
+            while (_running.load()) {
+                asio::io_context::work work(*acceptorIOContext);
+                try {
+                    acceptorIOContext->run();
+                } catch (...) {
+                    severe() << "Uncaught exception in the listener: " << exceptionToStatus();
+                    fassertFailed(40491);
+                }
+            }
+        });
+    }
 
     for (auto& acceptor : _acceptors) {
         acceptor.second.listen(serverGlobalParams.listenBacklog);
@@ -293,15 +355,19 @@ void TransportLayerASIO::shutdown() {
         }
     }
 
-    // If the listener thread is joinable (that is, we created/started a listener thread), then
-    // the io_context is owned exclusively by the TransportLayer and we should stop it and join
-    // the listener thread.
+    // If we started the listener threads, then the acceptor io_contexts are owned exclusively by
+    // the TransportLayer and we should stop them and join the listener threads.
     //
     // Otherwise the ServiceExecutor may need to continue running the io_context to drain running
     // connections, so we just cancel the acceptors and return.
-    if (_listenerThread.joinable()) {
-        _acceptorIOContext->stop();
-        _listenerThread.join();
+    if (!_listenerThreads.empty()) {
+        for (auto& acceptorIOContext : _acceptorIOContexts) {
+            acceptorIOContext->stop();
+        }
+        for (auto& listenerThread : _listenerThreads) {
+            listenerThread.join();
+        }
+        _listenerThreads.clear();
     }
 }
 
@@ -136,7 +136,7 @@ private:
 
     // There are two IO contexts that are used by TransportLayerASIO. The _workerIOContext
     // contains all the accepted sockets and all normal networking activity. The
-    // _acceptorIOContext contains all the sockets in _acceptors.
+    // _acceptorIOContexts contain all the sockets in _acceptors, one io_context per listener.
     //
     // TransportLayerASIO should never call run() on the _workerIOContext.
     // In synchronous mode, this will cause a massive performance degradation due to
@@ -145,9 +145,11 @@ private:
     // with the acceptors epoll set, thus avoiding those wakeups.  Calling run will
     // undo that benefit.
     //
-    // TransportLayerASIO should run its own thread that calls run() on the _acceptorIOContext
-    // to process calls to async_accept - this is the equivalent of the "listener" thread in
-    // other TransportLayers.
+    // TransportLayerASIO should run its own thread for each of the _acceptorIOContexts that calls
+    // run() on it to process calls to async_accept - this is the equivalent of the "listener"
+    // thread in other TransportLayers. When there is more than one listener, every TCP address
+    // gets one SO_REUSEPORT acceptor per listener so the kernel spreads new connections across
+    // the listener threads.
     //
     // The underlying problem that caused this is here:
     // https://github.com/chriskohlhoff/asio/issues/240
@@ -158,7 +160,7 @@ private:
     // other io_service associated state before we drop the refcount
     // on the io_context, which may destroy it.
     std::shared_ptr<asio::io_context> _workerIOContext;
-    std::unique_ptr<asio::io_context> _acceptorIOContext;
+    std::vector<std::unique_ptr<asio::io_context>> _acceptorIOContexts;
 
 #ifdef MONGO_CONFIG_SSL
     std::unique_ptr<asio::ssl::context> _sslContext;
@@ -166,8 +168,7 @@ private:
 
     std::vector<std::pair<SockAddr, GenericAcceptor>> _acceptors;
 
-    // Only used if _listenerOptions.async is false.
-    stdx::thread _listenerThread;
+    std::vector<stdx::thread> _listenerThreads;
 
     ServiceEntryPoint* const _sep = nullptr;
     AtomicWord<bool> _running{false};
@@ -32,11 +32,14 @@
 #include "mongo/transport/transport_layer_asio.h"
 
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -81,9 +84,9 @@ public:
         _transport = tl;
     }
 
-    void waitForConnect() {
+    void waitForConnect(size_t numSessions = 1) {
         stdx::unique_lock<stdx::mutex> lock(_mutex);
-        _cv.wait(lock, [&] { return !_sessions.empty(); });
+        _cv.wait(lock, [&] { return _sessions.size() >= numSessions; });
     }
 
 private:
@@ -153,5 +156,45 @@ TEST(TransportLayerASIO, PortZeroConnect) {
     tla.shutdown();
 }
 
+TEST(TransportLayerASIO, PortZeroConnectWithMultipleListeners) {
+    auto listenerCountParam =
+        ServerParameterSet::getGlobal()->getMap().find("transportLayerASIOListenerCount")->second;
+    ASSERT_OK(listenerCountParam->setFromString("4"));
+    ON_BLOCK_EXIT([&] { listenerCountParam->setFromString("1").transitional_ignore(); });
+
+    ServiceEntryPointUtil sepu;
+
+    auto options = [] {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerASIO::Options opts(&params);
+        opts.port = 0;
+        return opts;
+    }();
+
+    transport::TransportLayerASIO tla(options, &sepu);
+    sepu.setTransportLayer(&tla);
+
+    ASSERT_OK(tla.setup());
+    ASSERT_OK(tla.start());
+    int port = tla.listenerPort();
+    ASSERT_GT(port, 0);
+
+    // Every connection must be accepted no matter which listener the kernel hands it to.
+    const size_t kNumConnections = 16;
+    std::vector<std::unique_ptr<SimpleConnectionThread>> connectThreads;
+    for (size_t i = 0; i < kNumConnections; ++i) {
+        connectThreads.emplace_back(stdx::make_unique<SimpleConnectionThread>(port));
+    }
+    sepu.waitForConnect(kNumConnections);
+    ASSERT_EQ(kNumConnections, sepu.numOpenSessions());
+
+    for (auto& connectThread : connectThreads) {
+        connectThread->stop();
+    }
+    sepu.endAllSessions({});
+    tla.shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace unittest {
+
+namespace {
+
+// A run never uses more iterations than this, regardless of how fast the benchmark is.
+const std::uint64_t kMaxIterations = 1000 * 1000 * 1000;
+
+std::vector<std::pair<std::string, BenchmarkFunction>>& getRegistry() {
+    static std::vector<std::pair<std::string, BenchmarkFunction>> registry;
+    return registry;
+}
+
+void report(const std::string& name, const BenchmarkState& state) {
+    double seconds = durationCount<Nanoseconds>(state.elapsed()) / 1e9;
+    double nanosPerIteration = durationCount<Nanoseconds>(state.elapsed()) /
+        static_cast<double>(std::max<std::uint64_t>(state.iterations(), 1));
+
+    std::cout << std::left << std::setw(50) << name << std::right << std::setw(14)
+              << state.iterations() << std::setw(16) << std::fixed << std::setprecision(1)
+              << nanosPerIteration << " ns/iter";
+
+    if (seconds > 0 && state.bytesProcessed() > 0) {
+        std::cout << std::setw(12) << std::setprecision(2)
+                  << state.bytesProcessed() / seconds / (1024 * 1024) << " MB/s";
+    }
+
+    if (seconds > 0 && state.itemsProcessed() > 0) {
+        std::cout << std::setw(14) << std::setprecision(0) << state.itemsProcessed() / seconds
+                  << " items/s";
+    }
+
+    std::cout << std::endl;
+}
+
+}  // namespace
+
+void BenchmarkState::_start() {
+    _started = true;
+    resumeTiming();
+}
+
+void BenchmarkState::_stop() {
+    if (_running) {
+        pauseTiming();
+    }
+}
+
+void BenchmarkState::pauseTiming() {
+    invariant(_running);
+    _elapsed += duration_cast<Nanoseconds>(stdx::chrono::steady_clock::now() - _startTime);
+    _running = false;
+}
+
+void BenchmarkState::resumeTiming() {
+    invariant(!_running);
+    _running = true;
+    _startTime = stdx::chrono::steady_clock::now();
+}
+
+BenchmarkRegistration::BenchmarkRegistration(StringData name, BenchmarkFunction fn) {
+    getRegistry().emplace_back(name.toString(), fn);
+}
+
+std::vector<std::string> getAllBenchmarkNames() {
+    std::vector<std::string> names;
+    for (const auto& benchmark : getRegistry()) {
+        names.push_back(benchmark.first);
+    }
+    return names;
+}
+
+int runBenchmarks(const BenchmarkOptions& options) {
+    bool found = false;
+
+    for (const auto& benchmark : getRegistry()) {
+        if (!options.filter.empty() && benchmark.first.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        found = true;
+
+        for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+            std::uint64_t iterations = 1;
+
+            while (true) {
+                BenchmarkState state(iterations);
+                benchmark.second(state);
+
+                if (state.elapsed() >= options.minTime || iterations >= kMaxIterations) {
+                    report(benchmark.first, state);
+                    break;
+                }
+
+                // Aim a little past the minimum time based on this run, but grow by at most 10x
+                // at a time since short runs are noisy.
+                double multiplier = 10;
+                if (state.elapsed() > Nanoseconds(0)) {
+                    multiplier = std::min(1.4 * durationCount<Nanoseconds>(options.minTime) /
+                                              durationCount<Nanoseconds>(state.elapsed()),
+                                          multiplier);
+                }
+
+                iterations = std::min(
+                    std::max(iterations + 1, static_cast<std::uint64_t>(iterations * multiplier)),
+                    kMaxIterations);
+            }
+        }
+    }
+
+    if (!found) {
+        std::cerr << "No benchmarks matched filter '" << options.filter << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void doNotOptimizeAwayHelper(const volatile void* p) {
+    static const volatile void* volatile sink;
+    sink = p;
+}
+
+}  // namespace unittest
+}  // namespace mongo
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/*
+ * A small C++ microbenchmark framework.
+ *
+ * Benchmarks are registered with MONGO_BENCHMARK and time the body of the keepRunning() loop:
+ *
+ *     MONGO_BENCHMARK(BSONObjBuilderSmallDocument) {
+ *         while (state.keepRunning()) {
+ *             BSONObjBuilder bob;
+ *             bob.append("a", 1);
+ *             unittest::doNotOptimizeAway(bob.obj());
+ *         }
+ *     }
+ *
+ * Each benchmark is run with an increasing number of iterations until a run takes at least the
+ * minimum benchmark time, and the time per iteration of that run is reported.
+ *
+ * Benchmark binaries are declared with env.Benchmark in SConscript files, and built with
+ * "scons benchmarks". See mongo/unittest/benchmark_main.cpp for command line options.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace unittest {
+
+/**
+ * Passed to each benchmark body, controls the number of iterations and the timer.
+ */
+class BenchmarkState {
+    MONGO_DISALLOW_COPYING(BenchmarkState);
+
+public:
+    explicit BenchmarkState(std::uint64_t iterations) : _remaining(iterations) {}
+
+    /**
+     * Returns true while the benchmark should run another iteration. Starts the timer on the first
+     * call, and stops it on the last one.
+     */
+    bool keepRunning() {
+        if (!_started) {
+            _start();
+        }
+
+        if (_remaining == 0) {
+            _stop();
+            return false;
+        }
+
+        --_remaining;
+        ++_iterations;
+        return true;
+    }
+
+    /**
+     * Exclude the code between pauseTiming and resumeTiming, i.e. per-iteration setup, from the
+     * measurement. Both are expensive compared to the operations usually measured, so prefer doing
+     * setup before the loop.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Record the number of bytes or items processed by the run, reported as a rate.
+     */
+    void setBytesProcessed(std::uint64_t bytes) {
+        _bytesProcessed = bytes;
+    }
+    void setItemsProcessed(std::uint64_t items) {
+        _itemsProcessed = items;
+    }
+
+    std::uint64_t iterations() const {
+        return _iterations;
+    }
+
+    Nanoseconds elapsed() const {
+        return _elapsed;
+    }
+
+    std::uint64_t bytesProcessed() const {
+        return _bytesProcessed;
+    }
+
+    std::uint64_t itemsProcessed() const {
+        return _itemsProcessed;
+    }
+
+private:
+    void _start();
+    void _stop();
+
+    std::uint64_t _remaining;
+    std::uint64_t _iterations{0};
+    std::uint64_t _bytesProcessed{0};
+    std::uint64_t _itemsProcessed{0};
+
+    bool _started{false};
+    bool _running{false};
+    stdx::chrono::steady_clock::time_point _startTime;
+    Nanoseconds _elapsed{0};
+};
+
+using BenchmarkFunction = void (*)(BenchmarkState&);
+
+/**
+ * Adds a benchmark to the global list at static initialization time. Use MONGO_BENCHMARK.
+ */
+class BenchmarkRegistration {
+    MONGO_DISALLOW_COPYING(BenchmarkRegistration);
+
+public:
+    BenchmarkRegistration(StringData name, BenchmarkFunction fn);
+};
+
+/**
+ * Options for runBenchmarks.
+ */
+struct BenchmarkOptions {
+    // Only run benchmarks whose name contains this substring. Empty runs all benchmarks.
+    std::string filter;
+
+    // Minimum time a measured run must take.
+    Milliseconds minTime{500};
+
+    // Number of measured runs of each benchmark, each one is reported.
+    int repetitions{1};
+};
+
+/**
+ * Names of all registered benchmarks, in registration order.
+ */
+std::vector<std::string> getAllBenchmarkNames();
+
+/**
+ * Run the registered benchmarks selected by options, printing one line per measured run.
+ *
+ * Returns the process exit code.
+ */
+int runBenchmarks(const BenchmarkOptions& options);
+
+void doNotOptimizeAwayHelper(const volatile void* p);
+
+/**
+ * Forces the compiler to materialize value, so that the computation producing it is not removed as
+ * dead code.
+ */
+template <typename T>
+inline void doNotOptimizeAway(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    doNotOptimizeAwayHelper(&value);
+#endif
+}
+
+}  // namespace unittest
+}  // namespace mongo
+
+#define MONGO_BENCHMARK(NAME)                                                                 \
+    static void _mongoBenchmark_##NAME(::mongo::unittest::BenchmarkState& state);             \
+    static const ::mongo::unittest::BenchmarkRegistration _mongoBenchmarkRegistration_##NAME( \
+        #NAME, &_mongoBenchmark_##NAME);                                                      \
+    static void _mongoBenchmark_##NAME(::mongo::unittest::BenchmarkState& state)
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/align/aligned_allocator.hpp>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+/**
+ * Holds an immutable value of type T which many threads can read without taking a lock, while a
+ * writer replaces it wholesale with a new version.
+ *
+ * Readers run a callback against the currently published version from within read(). Each reader
+ * announces itself in one of two epoch counters, spread over cache-line sized shards, before it
+ * loads the published pointer. publish() swaps in the new version, flips the epoch, and waits for
+ * all readers still registered in the previous epoch to leave before destroying the old version.
+ *
+ * This is intended for read-mostly registries that are consulted on every operation but change
+ * rarely. Writers must be serialized by the caller and pay for a full copy plus a wait for
+ * in-flight readers, so callbacks passed to read() must be short and must not call publish().
+ */
+template <typename T>
+class EpochSnapshot {
+    MONGO_DISALLOW_COPYING(EpochSnapshot);
+
+public:
+    explicit EpochSnapshot(T initial = T())
+        : _shards(kNumShards), _current(new T(std::move(initial))) {}
+
+    ~EpochSnapshot() {
+        delete _current.load();
+    }
+
+    /**
+     * Invokes 'fn' with a const reference to the currently published version and returns its
+     * result. The reference must not escape the callback.
+     */
+    template <typename Fn>
+    auto read(Fn&& fn) const -> decltype(fn(std::declval<const T&>())) {
+        auto& shard = _shards[_threadShardIndex() % kNumShards];
+        for (;;) {
+            const auto epoch = _epoch.load() & 1;
+            shard.active[epoch].fetchAndAdd(1);
+            // A writer may have flipped the epoch between the load and the announcement above. It
+            // is not waiting for us then, so back out and register in the new epoch instead.
+            if ((_epoch.load() & 1) != epoch) {
+                shard.active[epoch].fetchAndSubtract(1);
+                continue;
+            }
+
+            struct Leave {
+                ~Leave() {
+                    counter.fetchAndSubtract(1);
+                }
+                AtomicInt64& counter;
+            } leave{shard.active[epoch]};
+            return fn(*_current.load());
+        }
+    }
+
+    /**
+     * Publishes 'newValue' as the current version. Returns once no reader can still observe the
+     * previous version, which has then been destroyed. Concurrent calls must be serialized by the
+     * caller.
+     */
+    void publish(T newValue) {
+        std::unique_ptr<const T> old(_current.swap(new T(std::move(newValue))));
+        const auto oldEpoch = _epoch.fetchAndAdd(1) & 1;
+        for (auto&& shard : _shards) {
+            while (shard.active[oldEpoch].load() != 0) {
+                stdx::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct Shard {
+        AtomicInt64 active[2];
+    };
+
+    enum { kNumShards = 16 };
+
+    // Each thread picks its shard once, round robin, the same way for every EpochSnapshot.
+    static unsigned _threadShardIndex() {
+        static AtomicUInt32 nextShardIndex;
+        thread_local unsigned threadShardIndex = nextShardIndex.fetchAndAdd(1);
+        return threadShardIndex;
+    }
+
+    // Heap allocated through an aligned allocator so that the shards stay on separate cache lines
+    // wherever the EpochSnapshot itself lives.
+    using ShardVector =
+        std::vector<CacheAligned<Shard>, boost::alignment::aligned_allocator<CacheAligned<Shard>>>;
+    mutable ShardVector _shards;
+    AtomicUInt64 _epoch{0};
+    AtomicWord<const T*> _current;
+};
+
+}  // namespace mongo
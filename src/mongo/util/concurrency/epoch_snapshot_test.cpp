@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/epoch_snapshot.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Counts live instances so tests can check when EpochSnapshot destroys old versions.
+ */
+struct Tracked {
+    explicit Tracked(int value, AtomicInt32* live) : value(value), live(live) {
+        live->fetchAndAdd(1);
+    }
+    Tracked(const Tracked& other) : Tracked(other.value, other.live) {}
+    Tracked(Tracked&& other) : Tracked(other.value, other.live) {}
+    ~Tracked() {
+        live->fetchAndSubtract(1);
+    }
+
+    int value;
+    AtomicInt32* live;
+};
+
+TEST(EpochSnapshotTest, ReadSeesInitialValue) {
+    EpochSnapshot<int> snapshot(7);
+    ASSERT_EQ(7, snapshot.read([](const int& value) { return value; }));
+}
+
+TEST(EpochSnapshotTest, ReadSeesPublishedValue) {
+    EpochSnapshot<std::vector<int>> snapshot;
+    ASSERT_EQ(0U, snapshot.read([](const std::vector<int>& v) { return v.size(); }));
+
+    snapshot.publish({1, 2, 3});
+    ASSERT_EQ(3U, snapshot.read([](const std::vector<int>& v) { return v.size(); }));
+    ASSERT_EQ(2, snapshot.read([](const std::vector<int>& v) { return v[1]; }));
+}
+
+TEST(EpochSnapshotTest, PublishDestroysPreviousVersion) {
+    AtomicInt32 live;
+    {
+        EpochSnapshot<Tracked> snapshot(Tracked(0, &live));
+        ASSERT_EQ(1, live.load());
+
+        for (int i = 1; i <= 10; ++i) {
+            snapshot.publish(Tracked(i, &live));
+            ASSERT_EQ(1, live.load());
+            ASSERT_EQ(i, snapshot.read([](const Tracked& t) { return t.value; }));
+        }
+    }
+    ASSERT_EQ(0, live.load());
+}
+
+TEST(EpochSnapshotTest, ConcurrentReadersAlwaysSeeCompleteVersions) {
+    const size_t kVersionSize = 64;
+    const int kNumVersions = 500;
+    const int kNumReaders = 4;
+
+    EpochSnapshot<std::vector<int>> snapshot(std::vector<int>(kVersionSize, 0));
+    AtomicWord<bool> done{false};
+    AtomicInt32 torn;
+
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < kNumReaders; ++i) {
+        readers.emplace_back([&] {
+            int lastSeen = 0;
+            while (!done.load()) {
+                auto seen = snapshot.read([&](const std::vector<int>& v) {
+                    for (auto&& element : v) {
+                        if (element != v.front()) {
+                            torn.fetchAndAdd(1);
+                        }
+                    }
+                    return v.front();
+                });
+                // Versions are published in increasing order, so no reader may go backwards.
+                if (seen < lastSeen) {
+                    torn.fetchAndAdd(1);
+                }
+                lastSeen = seen;
+            }
+        });
+    }
+
+    for (int version = 1; version <= kNumVersions; ++version) {
+        snapshot.publish(std::vector<int>(kVersionSize, version));
+    }
+    done.store(true);
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(0, torn.load());
+    ASSERT_EQ(kNumVersions, snapshot.read([](const std::vector<int>& v) { return v.back(); }));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedThreadPoolId{1};
+
+// The pool and queue index of the worker running on this thread, if any. Lets schedule() push
+// tasks from a worker onto that worker's own queue.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ */
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads, but it must have at least 1";
+        fassertFailed(40680);
+    }
+    return options;
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))), _workers(_options.numThreads) {}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        lk.unlock();
+        join();
+        lk.lock();
+    }
+
+    invariant(_threads.empty());
+    for (const auto& worker : _workers) {
+        invariant(worker.tasks.empty());
+    }
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(40681);
+    }
+    _setState_inlock(running);
+    _startWorkerThreads_inlock();
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _stateChange.wait(lk, [this] {
+        switch (_state) {
+            case preStart:
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(40682);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+
+    // If the pool was never started, start the workers now so that they run the tasks that were
+    // scheduled before shutdown. Tasks cannot be run inline, because they can create
+    // OperationContexts and the join() caller may already have one associated with the thread.
+    if (_threads.empty()) {
+        _startWorkerThreads_inlock();
+    }
+
+    std::vector<stdx::thread> threadsToJoin;
+    swap(threadsToJoin, _threads);
+    lk.unlock();
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+    lk.lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    // Count the task before checking the state. A worker only exits once it has seen the pool
+    // shutting down and then seen nothing queued, so if this check passes, some worker is certain
+    // to find the task.
+    _numQueued.fetchAndAdd(1);
+    const auto state = _atomicState.load();
+    if (state != preStart && state != running) {
+        _numQueued.subtractAndFetch(1);
+        return Status(ErrorCodes::ShutdownInProgress,
+                      str::stream() << "Shutdown of thread pool " << _options.poolName
+                                    << " in progress");
+    }
+
+    Worker& worker = (currentPool == this)
+        ? _workers[currentWorkerIndex]
+        : _workers[_nextWorker.fetchAndAdd(1) % _workers.size()];
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+    }
+
+    if (_numParked.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_parkMutex);
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+void WorkStealingThreadPool::_startWorkerThreads_inlock() {
+    invariant(_threads.empty());
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _threads.emplace_back([this, threadName, i] {
+            setThreadName(threadName);
+            _options.onCreateThread(threadName);
+            LOG(1) << "starting thread in pool " << _options.poolName;
+            _consumeTasks(i);
+            LOG(1) << "shutting down thread in pool " << _options.poolName;
+        });
+    }
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+    ON_BLOCK_EXIT([] { currentPool = nullptr; });
+
+    while (true) {
+        Task task;
+        if (_findTask(workerIndex, &task)) {
+            _numQueued.subtractAndFetch(1);
+            try {
+                task();
+            } catch (...) {
+                severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                         << exceptionToStatus();
+                std::terminate();
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < _options.spinIterations && _numQueued.load() == 0 &&
+             _atomicState.load() == running;
+             ++i) {
+            stdx::this_thread::yield();
+        }
+
+        // The state must be read before the queue count; see schedule().
+        if (_atomicState.load() != running && _numQueued.load() == 0) {
+            return;
+        }
+        if (_numQueued.load() > 0) {
+            continue;
+        }
+        _park();
+    }
+}
+
+bool WorkStealingThreadPool::_findTask(size_t workerIndex, Task* task) {
+    {
+        Worker& own = _workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(own.mutex);
+        if (!own.tasks.empty()) {
+            *task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Skip queues that are busy rather than waiting on them. Nothing is lost, because the caller
+    // will not park while any task is still counted in _numQueued.
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        Worker& victim = _workers[(workerIndex + i) % _workers.size()];
+        stdx::unique_lock<stdx::mutex> lk(victim.mutex, stdx::try_to_lock);
+        if (lk && !victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_park() {
+    stdx::unique_lock<stdx::mutex> lk(_parkMutex);
+    _numParked.fetchAndAdd(1);
+    while (_numQueued.load() == 0 && _atomicState.load() == running) {
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(lk);
+    }
+    _numParked.subtractAndFetch(1);
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _atomicState.store(newState);
+    {
+        // Wake parked workers so that they notice the pool is shutting down.
+        stdx::lock_guard<stdx::mutex> lk(_parkMutex);
+        _workAvailable.notify_all();
+    }
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
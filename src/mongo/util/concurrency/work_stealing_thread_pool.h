@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/align/aligned_allocator.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A fixed-size thread pool in which every worker owns its own task queue.
+ *
+ * Tasks scheduled from one of the pool's own threads go onto that thread's queue, and tasks
+ * scheduled from outside are spread across the queues round robin, so there is no single queue
+ * for schedulers to contend on. A worker runs its own tasks newest first, and when it runs out it
+ * steals the oldest tasks from the other workers. An idle worker spins for a while before it
+ * parks, so bursts of short tasks do not pay for condition variable wakeups.
+ *
+ * Use this instead of ThreadPool for many short tasks on a pool whose size need not change.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this
+        // empty, the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, all started by startup().
+        size_t numThreads = 4;
+
+        // Number of times an idle worker looks for work again before it parks.
+        size_t spinIterations = 1000;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+private:
+    /**
+     * Lifecycle of the pool, with the same meaning as ThreadPool's:
+     *
+     * preStart -> running -> joinRequired -> joining -> shutdownComplete
+     *        \               ^
+     *         \_____________/
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * The task queue owned by one worker thread. The owner pushes and pops at the back, thieves
+     * and external schedulers use the front and back respectively, so the mutex is rarely
+     * contended.
+     */
+    struct Worker {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    template <typename T>
+    using CacheAlignedVector = std::vector<CacheAligned<T>,
+                                           boost::alignment::aligned_allocator<CacheAligned<T>>>;
+
+    /**
+     * Starts all worker threads. Caller must hold _mutex.
+     */
+    void _startWorkerThreads_inlock();
+
+    /**
+     * This is the run loop of the worker thread with index "workerIndex".
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Pops the newest task of worker "workerIndex", or steals the oldest task of another worker.
+     * Returns false if no task was found.
+     */
+    bool _findTask(size_t workerIndex, Task* task);
+
+    /**
+     * Blocks the calling worker until there may be queued work or the pool is shutting down.
+     */
+    void _park();
+
+    void _shutdown_inlock();
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    CacheAlignedVector<Worker> _workers;
+
+    // Number of tasks that have been scheduled but not yet taken off a queue. It is raised before
+    // a task is queued, so that workers never exit or park while a schedule() is in flight.
+    AtomicInt64 _numQueued{0};
+
+    // Round-robin cursor used to pick a queue for tasks scheduled from outside the pool.
+    AtomicUInt32 _nextWorker{0};
+
+    // Mirror of _state for the lock-free checks in schedule() and the worker loop.
+    AtomicInt32 _atomicState{preStart};
+
+    // Parking lot for idle workers.
+    stdx::mutex _parkMutex;
+    stdx::condition_variable _workAvailable;
+    AtomicInt32 _numParked{0};
+
+    // Mutex guarding the lifecycle state and the thread list.
+    stdx::mutex _mutex;
+    stdx::condition_variable _stateChange;
+    LifecycleState _state = preStart;
+    std::vector<stdx::thread> _threads;
+};
+
+}  // namespace mongo
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, RunsTasksScheduledFromManyThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    const int kSchedulers = 8;
+    const int kTasksPerScheduler = 10000;
+    AtomicInt64 executed{0};
+
+    std::vector<stdx::thread> schedulers;
+    for (int i = 0; i < kSchedulers; i++) {
+        schedulers.emplace_back([&] {
+            for (int j = 0; j < kTasksPerScheduler; j++) {
+                ASSERT_OK(pool.schedule([&] { executed.fetchAndAdd(1); }));
+            }
+        });
+    }
+    for (auto& scheduler : schedulers) {
+        scheduler.join();
+    }
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(kSchedulers * kTasksPerScheduler, executed.load());
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealTasksQueuedByABusyWorker) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // One task queues the remaining work onto its own worker's queue and then blocks, so the
+    // children can only run if other workers steal them.
+    const int kChildren = 3;
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    int childrenRun = 0;
+    ASSERT_OK(pool.schedule([&] {
+        for (int i = 0; i < kChildren; i++) {
+            ASSERT_OK(pool.schedule([&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                ++childrenRun;
+                cv.notify_all();
+            }));
+        }
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return childrenRun == kChildren; });
+    }));
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(kChildren, childrenRun);
+}
+
+TEST(WorkStealingThreadPoolTest, ParkedWorkersWakeForNewTasks) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    options.spinIterations = 0;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    for (int round = 0; round < 100; round++) {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        bool done = false;
+        ASSERT_OK(pool.schedule([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            done = true;
+            cv.notify_all();
+        }));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return done; });
+    }
+
+    pool.shutdown();
+    pool.join();
+}
+
+}  // namespace
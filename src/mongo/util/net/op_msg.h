@@ -47,6 +47,10 @@ struct OpMsg {
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
 
+    // Set by a client on a getMore to let the server stream the following batches of the cursor
+    // back, each with kMoreToCome set, without waiting for another getMore.
+    static constexpr uint32_t kExhaustSupported = 1 << 16;
+
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
      * Returns 0 for other message kinds since they are the equivalent of no flags set.
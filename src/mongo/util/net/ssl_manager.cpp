@@ -64,6 +64,8 @@
 #include <openssl/asn1.h>
 #include <openssl/asn1t.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
 #include <openssl/x509_vfy.h>
 #include <openssl/x509v3.h>
 #if defined(_WIN32)
@@ -205,6 +207,128 @@ UniqueBIO makeUniqueMemBio(std::vector<std::uint8_t>& v) {
     return rv;
 }
 
+/**
+ * Lifetime of the TLS sessions a server caches, which is also how often the keys protecting
+ * session tickets are rotated. A client reconnecting within this window can resume its session
+ * instead of going through a full handshake.
+ */
+int opensslSessionTimeoutSecs = 300;
+
+class OpenSSLSessionTimeoutParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    OpenSSLSessionTimeoutParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "opensslSessionTimeoutSecs",
+              &opensslSessionTimeoutSecs) {}
+
+    Status validate(const int& potentialNewValue) final {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue, "opensslSessionTimeoutSecs must be at least 1");
+        }
+        return Status::OK();
+    }
+} openSSLSessionTimeout;
+
+/**
+ * Keys used to encrypt and authenticate session tickets. The current key is replaced once it is
+ * older than opensslSessionTimeoutSecs. The previous key is kept so that tickets issued just before
+ * a rotation can still be decrypted, and a client presenting one gets a fresh ticket.
+ */
+class SessionTicketKeys {
+public:
+    struct Key {
+        unsigned char name[16];
+        unsigned char aesKey[16];
+        unsigned char hmacKey[16];
+        Date_t created;
+    };
+
+    /**
+     * Returns the key to issue new tickets with, rotating it first if it has expired.
+     */
+    bool getCurrent(Key* key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const auto now = Date_t::now();
+        if (!_current || now - _current->created >= Seconds(opensslSessionTimeoutSecs)) {
+            Key newKey;
+            if (RAND_bytes(newKey.name, sizeof(newKey.name)) != 1 ||
+                RAND_bytes(newKey.aesKey, sizeof(newKey.aesKey)) != 1 ||
+                RAND_bytes(newKey.hmacKey, sizeof(newKey.hmacKey)) != 1) {
+                return false;
+            }
+            newKey.created = now;
+            _previous = std::move(_current);
+            _current = newKey;
+        }
+        *key = *_current;
+        return true;
+    }
+
+    /**
+     * Finds the key a ticket was issued with. Returns false if it is unknown or has been retired.
+     */
+    bool find(const unsigned char* name, Key* key, bool* isCurrent) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const auto matches = [name](const boost::optional<Key>& candidate) {
+            return candidate && memcmp(candidate->name, name, sizeof(candidate->name)) == 0;
+        };
+        if (matches(_current)) {
+            *key = *_current;
+            *isCurrent = true;
+            return true;
+        }
+        if (matches(_previous)) {
+            *key = *_previous;
+            *isCurrent = false;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    stdx::mutex _mutex;
+    boost::optional<Key> _current;
+    boost::optional<Key> _previous;
+};
+
+SessionTicketKeys sessionTicketKeys;
+
+int sessionTicketKeyCallback(SSL* ssl,
+                             unsigned char* keyName,
+                             unsigned char* iv,
+                             EVP_CIPHER_CTX* cipherCtx,
+                             HMAC_CTX* hmacCtx,
+                             int encrypt) {
+    SessionTicketKeys::Key key;
+    if (encrypt) {
+        if (!sessionTicketKeys.getCurrent(&key) || RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1) {
+            return -1;
+        }
+        memcpy(keyName, key.name, sizeof(key.name));
+        if (EVP_EncryptInit_ex(cipherCtx, EVP_aes_128_cbc(), nullptr, key.aesKey, iv) != 1 ||
+            HMAC_Init_ex(hmacCtx, key.hmacKey, sizeof(key.hmacKey), EVP_sha256(), nullptr) != 1) {
+            return -1;
+        }
+        return 1;
+    }
+
+    // An unknown key means the ticket was issued before the last rotation or by another process,
+    // in which case we fall back to a full handshake.
+    bool isCurrent = false;
+    if (!sessionTicketKeys.find(keyName, &key, &isCurrent)) {
+        return 0;
+    }
+    if (HMAC_Init_ex(hmacCtx, key.hmacKey, sizeof(key.hmacKey), EVP_sha256(), nullptr) != 1 ||
+        EVP_DecryptInit_ex(cipherCtx, EVP_aes_128_cbc(), nullptr, key.aesKey, iv) != 1) {
+        return -1;
+    }
+
+    // Returning 2 asks OpenSSL to issue a new ticket under the current key.
+    return isCurrent ? 1 : 2;
+}
+
 // Old copies of OpenSSL will not have constants to disable protocols they don't support.
 // Define them to values we can OR together safely to generically disable these protocols across
 // all versions of OpenSSL.
@@ -804,6 +928,15 @@ Status SSLManager::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Let reconnecting clients resume their sessions, either from the server side session cache
+    // or from a session ticket encrypted with a periodically rotated key.
+    ::SSL_CTX_set_timeout(context, opensslSessionTimeoutSecs);
+    if (1 != ::SSL_CTX_set_tlsext_ticket_key_cb(context, sessionTicketKeyCallback)) {
+        return Status(ErrorCodes::InvalidSSLConfiguration,
+                      str::stream() << "Can not set session ticket key callback: "
+                                    << getSSLErrorMessage(ERR_get_error()));
+    }
+
     if (direction == ConnectionDirection::kOutgoing && !params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -34,4 +34,6 @@ namespace mongo {
 
 PeriodicRunner::~PeriodicRunner() = default;
 
+void PeriodicRunner::appendStats(BSONObjBuilder* builder) const {}
+
 }  // namespace mongo
@@ -28,12 +28,15 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class Client;
 
 /**
@@ -52,7 +55,16 @@ public:
 
     struct PeriodicJob {
         PeriodicJob(Job callable, Milliseconds period)
-            : job(std::move(callable)), interval(period) {}
+            : PeriodicJob(std::string(), std::move(callable), period) {}
+
+        PeriodicJob(std::string jobName, Job callable, Milliseconds period)
+            : name(std::move(jobName)), job(std::move(callable)), interval(period) {}
+
+        /**
+         * A name under which the runner reports statistics for this job. Unnamed jobs are reported
+         * by their scheduling order.
+         */
+        std::string name;
 
         /**
          * A task to be run at regular intervals by the runner.
@@ -92,6 +104,12 @@ public:
      * runner should no longer execute once shutdown() is called.
      */
     virtual void shutdown() = 0;
+
+    /**
+     * Appends per-job execution statistics to 'builder'. Runners that do not keep statistics
+     * append nothing.
+     */
+    virtual void appendStats(BSONObjBuilder* builder) const;
 };
 
 }  // namespace mongo
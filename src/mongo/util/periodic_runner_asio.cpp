@@ -35,17 +35,49 @@
 
 #include "mongo/util/periodic_runner_asio.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+// Spreads each run of a periodic job by up to this percentage of its interval, so that hosts
+// started together do not keep running their periodic work in lock step.
+AtomicInt32 periodicRunnerJitterPercent(0);
+
+class PeriodicRunnerJitterPercentParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    PeriodicRunnerJitterPercentParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "periodicRunnerJitterPercent",
+              &periodicRunnerJitterPercent) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0 || potentialNewValue > 50) {
+            return Status(ErrorCodes::BadValue,
+                          "periodicRunnerJitterPercent has to be >= 0 and <= 50");
+        }
+        return Status::OK();
+    }
+} periodicRunnerJitterPercentParameter;
+
+}  // namespace
+
 PeriodicRunnerASIO::PeriodicRunnerASIO(
     std::unique_ptr<executor::AsyncTimerFactoryInterface> timerFactory)
     : _io_service(),
       _strand(_io_service),
       _timerFactory(std::move(timerFactory)),
-      _state(State::kReady) {}
+      _state(State::kReady),
+      _random(SecureRandom::create()->nextInt64()) {}
 
 PeriodicRunnerASIO::~PeriodicRunnerASIO() {
     // We must call shutdown here to join our background thread.
@@ -91,15 +123,34 @@ void PeriodicRunnerASIO::_scheduleJob(std::weak_ptr<PeriodicJobASIO> job, bool f
                 return;
             }
 
-            lockedJob->start = _timerFactory->now();
+            lockedJob->start = _timerFactory->now() + _jitter(lockedJob->interval);
 
+            Timer timer;
             lockedJob->job(Client::getCurrent());
+            const long long elapsedMillis = timer.millis();
+
+            lockedJob->runs.fetchAndAdd(1);
+            lockedJob->totalMillis.fetchAndAdd(elapsedMillis);
+            lockedJob->lastMillis.store(elapsedMillis);
+            if (elapsedMillis > lockedJob->maxMillis.load()) {
+                lockedJob->maxMillis.store(elapsedMillis);
+            }
         }
 
         _io_service.post([this, job]() mutable { _scheduleJob(job, false); });
     });
 }
 
+Milliseconds PeriodicRunnerASIO::_jitter(Milliseconds interval) {
+    const long long maxOffset = interval.count() * periodicRunnerJitterPercent.load() / 100;
+    if (maxOffset <= 0) {
+        return Milliseconds(0);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_randomMutex);
+    return Milliseconds(_random.nextInt64(2 * maxOffset + 1) - maxOffset);
+}
+
 void PeriodicRunnerASIO::_spawnThreads(WithLock) {
     while (_threads.size() < _jobs.size()) {
         _threads.emplace_back([this] {
@@ -160,4 +211,19 @@ void PeriodicRunnerASIO::shutdown() {
     }
 }
 
+void PeriodicRunnerASIO::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_stateMutex);
+    for (size_t i = 0; i < _jobs.size(); ++i) {
+        const auto& job = _jobs[i];
+        const std::string fieldName =
+            job->name.empty() ? std::string(str::stream() << "job" << i) : job->name;
+        BSONObjBuilder jobBuilder(builder->subobjStart(fieldName));
+        jobBuilder.append("intervalMillis", durationCount<Milliseconds>(job->interval));
+        jobBuilder.append("runs", job->runs.load());
+        jobBuilder.append("totalMillis", job->totalMillis.load());
+        jobBuilder.append("lastMillis", job->lastMillis.load());
+        jobBuilder.append("maxMillis", job->maxMillis.load());
+    }
+}
+
 }  // namespace mongo
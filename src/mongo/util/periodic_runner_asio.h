@@ -32,6 +32,8 @@
 
 #include "mongo/executor/async_timer_interface.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/periodic_runner.h"
@@ -88,19 +90,33 @@ public:
      */
     void shutdown() override;
 
+    /**
+     * Appends, for every scheduled job, how often it ran and how long its runs took.
+     */
+    void appendStats(BSONObjBuilder* builder) const override;
+
 private:
     struct PeriodicJobASIO {
         explicit PeriodicJobASIO(PeriodicJob callable,
                                  Date_t startTime,
                                  std::shared_ptr<executor::AsyncTimerInterface> sharedTimer)
-            : job(std::move(callable.job)),
+            : name(std::move(callable.name)),
+              job(std::move(callable.job)),
               interval(callable.interval),
               start(startTime),
               timer(sharedTimer) {}
+        std::string name;
         Job job;
         Milliseconds interval;
         Date_t start;
         std::shared_ptr<executor::AsyncTimerInterface> timer;
+
+        // Execution statistics. A job never runs concurrently with itself, so these have a single
+        // writer and are only atomic so that appendStats() may read them at any time.
+        AtomicInt64 runs;
+        AtomicInt64 totalMillis;
+        AtomicInt64 lastMillis;
+        AtomicInt64 maxMillis;
     };
 
     // Internally, we will transition through these states
@@ -110,6 +126,12 @@ private:
 
     void _spawnThreads(WithLock);
 
+    /**
+     * Returns a random offset within periodicRunnerJitterPercent of 'interval', in either
+     * direction, by which to shift the next run of a job.
+     */
+    Milliseconds _jitter(Milliseconds interval);
+
     asio::io_service _io_service;
     asio::io_service::strand _strand;
 
@@ -117,10 +139,13 @@ private:
 
     std::unique_ptr<executor::AsyncTimerFactoryInterface> _timerFactory;
 
-    stdx::mutex _stateMutex;
+    mutable stdx::mutex _stateMutex;
     State _state;
 
     std::vector<std::shared_ptr<PeriodicJobASIO>> _jobs;
+
+    stdx::mutex _randomMutex;
+    PseudoRandom _random;
 };
 
 }  // namespace mongo
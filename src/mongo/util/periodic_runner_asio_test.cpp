@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/async_timer_interface.h"
 #include "mongo/executor/async_timer_mock.h"
 #include "mongo/stdx/condition_variable.h"
@@ -221,6 +222,54 @@ TEST_F(PeriodicRunnerASIOTest, TwoJobsTest) {
     }
 }
 
+TEST_F(PeriodicRunnerASIOTest, AppendStatsReportsRunsPerJob) {
+    int count = 0;
+    Milliseconds interval{5};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    PeriodicRunner::PeriodicJob job("countingJob",
+                                    [&count, &mutex, &cv](Client*) {
+                                        {
+                                            stdx::unique_lock<stdx::mutex> lk(mutex);
+                                            count++;
+                                        }
+                                        cv.notify_all();
+                                    },
+                                    interval);
+    PeriodicRunner::PeriodicJob unnamedJob([](Client*) {}, Milliseconds(1000));
+
+    runner()->scheduleJob(std::move(job));
+    runner()->scheduleJob(std::move(unnamedJob));
+
+    for (int i = 0; i < 3; i++) {
+        timerFactory().fastForward(interval);
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&count, &i] { return count > i; });
+        }
+        sleepForReschedule(2);
+    }
+
+    // The statistics are recorded right after the job returns, so wait for the last run's.
+    auto getStats = [this] {
+        BSONObjBuilder builder;
+        runner()->appendStats(&builder);
+        return builder.obj();
+    };
+    BSONObj stats = getStats();
+    while (stats["countingJob"]["runs"].numberLong() < 3) {
+        sleepmillis(2);
+        stats = getStats();
+    }
+
+    ASSERT_EQ(3, stats["countingJob"]["runs"].numberLong());
+    ASSERT_EQ(5, stats["countingJob"]["intervalMillis"].numberLong());
+    ASSERT_EQ(0, stats["job1"]["runs"].numberLong());
+    ASSERT_EQ(1000, stats["job1"]["intervalMillis"].numberLong());
+}
+
 TEST_F(PeriodicRunnerASIOTest, TwoJobsDontDeadlock) {
     stdx::mutex mutex;
     stdx::condition_variable cv;
@@ -32,6 +32,7 @@
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/process_id.h"
@@ -124,6 +125,18 @@ public:
         return sysInfo().hasNuma;
     }
 
+    /**
+     * Get the CPUs of each NUMA node, indexed by node. Returns an empty vector if the system has
+     * fewer than two nodes or its topology cannot be determined.
+     */
+    static std::vector<std::vector<int>> getNumaNodeCpus();
+
+    /**
+     * Restrict the calling thread to run only on 'cpus'. Returns false if this is unsupported on
+     * this platform or fails.
+     */
+    static bool bindCurrentThreadToCpus(const std::vector<int>& cpus);
+
     /**
      * Determine if file zeroing is necessary for newly allocated data files.
      */
@@ -36,6 +36,7 @@
 #include <iostream>
 #include <malloc.h>
 #include <sched.h>
+#include <sstream>
 #include <stdio.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
@@ -54,6 +55,7 @@
 
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace std;
 
@@ -548,6 +550,60 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+std::vector<std::vector<int>> ProcessInfo::getNumaNodeCpus() {
+    std::vector<std::vector<int>> nodeCpus;
+    for (int node = 0;; ++node) {
+        const std::string cpuListFile =
+            str::stream() << "/sys/devices/system/node/node" << node << "/cpulist";
+        if (access(cpuListFile.c_str(), R_OK) != 0) {
+            break;
+        }
+
+        // The file lists the CPUs of the node as comma separated ranges, such as "0-7,16-23".
+        std::vector<int> cpus;
+        std::istringstream cpuList(LinuxSysHelper::readLineFromFile(cpuListFile.c_str()));
+        std::string range;
+        while (std::getline(cpuList, range, ',')) {
+            int first = 0;
+            int last = 0;
+            const int numParsed = sscanf(range.c_str(), "%d-%d", &first, &last);
+            if (numParsed < 1) {
+                continue;
+            }
+            if (numParsed == 1) {
+                last = first;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        nodeCpus.push_back(std::move(cpus));
+    }
+
+    if (nodeCpus.size() < 2) {
+        return {};
+    }
+    return nodeCpus;
+}
+
+bool ProcessInfo::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool anySet = false;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+            anySet = true;
+        }
+    }
+    if (!anySet) {
+        return false;
+    }
+
+    // A pid of zero refers to the calling thread.
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
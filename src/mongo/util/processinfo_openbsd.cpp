@@ -187,6 +187,14 @@ bool ProcessInfo::supported() {
     return true;
 }
 
+std::vector<std::vector<int>> ProcessInfo::getNumaNodeCpus() {
+    return {};
+}
+
+bool ProcessInfo::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
@@ -221,6 +221,14 @@ bool ProcessInfo::checkNumaEnabled() {
     return groups > 1;
 }
 
+std::vector<std::vector<int>> ProcessInfo::getNumaNodeCpus() {
+    return {};
+}
+
+bool ProcessInfo::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
@@ -69,4 +69,17 @@ TEST(ProcessInfo, GetNumCoresReturnsNonZeroNumberOfProcessors) {
     ProcessInfo::initializeSystemInfo();
     ASSERT_GREATER_THAN(processInfo.getNumCores(), 0u);
 }
+
+TEST(ProcessInfo, NumaNodeCpusAreEmptyOrHaveSeveralNodes) {
+    const auto nodeCpus = ProcessInfo::getNumaNodeCpus();
+    if (nodeCpus.empty()) {
+        return;
+    }
+    ASSERT_GREATER_THAN_OR_EQUALS(nodeCpus.size(), 2u);
+    for (auto&& cpus : nodeCpus) {
+        for (int cpu : cpus) {
+            ASSERT_GREATER_THAN_OR_EQUALS(cpu, 0);
+        }
+    }
+}
 }
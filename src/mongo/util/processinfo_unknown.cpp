@@ -65,6 +65,14 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+std::vector<std::vector<int>> ProcessInfo::getNumaNodeCpus() {
+    return {};
+}
+
+bool ProcessInfo::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return false;
 }
@@ -463,6 +463,14 @@ bool ProcessInfo::checkNumaEnabled() {
     return numaNodeCount > 1;
 }
 
+std::vector<std::vector<int>> ProcessInfo::getNumaNodeCpus() {
+    return {};
+}
+
+bool ProcessInfo::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return psapiGlobal->supported;
 }
@@ -37,6 +37,25 @@ namespace mongo {
 
 using std::ostringstream;
 
+void SafeNum::toBSON(StringData fieldName, BSONObjBuilder* bob) const {
+    switch (_type) {
+        case NumberInt:
+            bob->append(fieldName, _value.int32Val);
+            break;
+        case NumberLong:
+            bob->append(fieldName, static_cast<long long>(_value.int64Val));
+            break;
+        case NumberDouble:
+            bob->append(fieldName, _value.doubleVal);
+            break;
+        case NumberDecimal:
+            bob->append(fieldName, Decimal128(_value.decimalVal));
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
 SafeNum::SafeNum(const BSONElement& element) {
     switch (element.type()) {
         case NumberInt:
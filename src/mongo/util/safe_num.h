@@ -159,7 +159,10 @@ public:
     friend class mutablebson::Element;
     friend class mutablebson::Document;
 
-    // TODO: output to builder
+    /**
+     * Appends this number to 'bob' under 'fieldName', with its current type. Must be valid.
+     */
+    void toBSON(StringData fieldName, BSONObjBuilder* bob) const;
 
     //
     // accessors
@@ -0,0 +1,326 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/mongoutils/str.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/time.h>
+
+#include "mongo/util/errno_util.h"
+#include "mongo/util/stacktrace.h"
+#endif
+
+namespace mongo {
+namespace {
+
+// The tag of the current thread. Plain data so that the signal handler can read it without any
+// initialization or locking; the handler always runs on the thread whose tag it reads, so it only
+// needs to be protected against observing a half-written tag.
+struct ThreadTagState {
+    char data[SamplingProfiler::kMaxTagLength];
+    size_t length;
+};
+
+thread_local ThreadTagState currentThreadTag;
+
+void writeThreadTag(const char* data, size_t length) {
+    currentThreadTag.length = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    memcpy(currentThreadTag.data, data, length);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    currentThreadTag.length = length;
+}
+
+size_t appendToTag(char* buffer, size_t length, StringData part) {
+    const size_t toCopy = std::min(part.size(), SamplingProfiler::kMaxTagLength - length);
+    memcpy(buffer + length, part.rawData(), toCopy);
+    return length + toCopy;
+}
+
+}  // namespace
+
+SamplingProfiler::ThreadTag::ThreadTag(StringData tag) : _savedLength(currentThreadTag.length) {
+    memcpy(_saved, currentThreadTag.data, _savedLength);
+
+    char buffer[kMaxTagLength];
+    writeThreadTag(buffer, appendToTag(buffer, 0, tag));
+}
+
+SamplingProfiler::ThreadTag::ThreadTag(StringData first, StringData second)
+    : _savedLength(currentThreadTag.length) {
+    memcpy(_saved, currentThreadTag.data, _savedLength);
+
+    char buffer[kMaxTagLength];
+    size_t length = appendToTag(buffer, 0, first);
+    if (!second.empty()) {
+        length = appendToTag(buffer, length, " ");
+        length = appendToTag(buffer, length, second);
+    }
+    writeThreadTag(buffer, length);
+}
+
+SamplingProfiler::ThreadTag::~ThreadTag() {
+    writeThreadTag(_saved, _savedLength);
+}
+
+#if defined(_WIN32)
+
+Status SamplingProfiler::start(int samplesPerSecond, size_t maxSamples) {
+    return {ErrorCodes::IllegalOperation, "Sampling profiler is not supported on this platform"};
+}
+
+StatusWith<SamplingProfiler::Profile> SamplingProfiler::stop() {
+    return {ErrorCodes::IllegalOperation, "Sampling profiler is not supported on this platform"};
+}
+
+bool SamplingProfiler::isRunning() {
+    return false;
+}
+
+#else
+
+namespace {
+
+struct Sample {
+    std::atomic<bool> complete{false};  // NOLINT
+    int firstFrame = 0;  // frames before this one belong to the signal handler
+    int numFrames = 0;
+    void* frames[SamplingProfiler::kMaxFramesPerSample];
+    size_t tagLength = 0;
+    char tag[SamplingProfiler::kMaxTagLength];
+};
+
+// Serializes start() and stop().
+stdx::mutex sessionMutex;
+bool signalHandlerInstalled = false;
+std::unique_ptr<Sample[]> sampleStorage;
+
+// State shared with the signal handler.
+std::atomic<Sample*> activeSamples{nullptr};  // NOLINT
+std::atomic<size_t> sampleCapacity{0};        // NOLINT
+std::atomic<size_t> nextSample{0};            // NOLINT
+std::atomic<long long> droppedSamples{0};     // NOLINT
+std::atomic<int> runningHandlers{0};          // NOLINT
+
+void onProfilingSignal(int, siginfo_t*, void*) {
+    const int savedErrno = errno;
+
+    // Announce ourselves before looking at the buffer, so that stop() can wait for us to leave it.
+    runningHandlers.fetch_add(1);
+    if (Sample* const samples = activeSamples.load()) {
+        const size_t slot = nextSample.fetch_add(1);
+        if (slot < sampleCapacity.load()) {
+            Sample& sample = samples[slot];
+            sample.numFrames = rawBacktrace(sample.frames, SamplingProfiler::kMaxFramesPerSample);
+
+            // The handler returns into the signal trampoline, which sits directly on top of the
+            // interrupted frame. Depending on inlining, the frames above it vary in number.
+            void* const trampoline = __builtin_return_address(0);
+            sample.firstFrame = 0;
+            for (int i = 0; i < sample.numFrames; ++i) {
+                if (sample.frames[i] == trampoline) {
+                    sample.firstFrame = i + 1;
+                    break;
+                }
+            }
+            sample.tagLength = currentThreadTag.length;
+            memcpy(sample.tag, currentThreadTag.data, sample.tagLength);
+            sample.complete.store(true, std::memory_order_release);
+        } else {
+            droppedSamples.fetch_add(1);
+        }
+    }
+    runningHandlers.fetch_sub(1);
+
+    errno = savedErrno;
+}
+
+Status setProfilingTimer(int samplesPerSecond) {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    if (samplesPerSecond > 0) {
+        timer.it_interval.tv_usec = 1000000 / samplesPerSecond;
+        timer.it_value = timer.it_interval;
+    }
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int err = errno;
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to set the profiling timer: "
+                              << errnoWithDescription(err)};
+    }
+    return Status::OK();
+}
+
+std::string symbolizeFrame(void* address) {
+    Dl_info dli;
+    if (dladdr(address, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (!demangled) {
+            return dli.dli_sname;
+        }
+
+        // Strip off the function parameters, as they are very verbose.
+        std::string name(demangled);
+        free(demangled);
+        const auto paren = name.find('(');
+        if (paren != std::string::npos && paren > 0) {
+            name.resize(paren);
+        }
+        // Semicolons separate frames in the collapsed format.
+        std::replace(name.begin(), name.end(), ';', ':');
+        return name;
+    }
+
+    std::ostringstream s;
+    s << address;
+    return s.str();
+}
+
+}  // namespace
+
+Status SamplingProfiler::start(int samplesPerSecond, size_t maxSamples) {
+    if (samplesPerSecond < 1 || samplesPerSecond > 1000) {
+        return {ErrorCodes::BadValue, "samplesPerSecond must be between 1 and 1000"};
+    }
+    if (maxSamples < 1) {
+        return {ErrorCodes::BadValue, "maxSamples must be positive"};
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(sessionMutex);
+    if (activeSamples.load()) {
+        return {ErrorCodes::ConflictingOperationInProgress,
+                "A sampling profiler session is already running"};
+    }
+
+    // The first call into the unwinder may allocate, so make sure it does not happen in the
+    // signal handler.
+    void* warmUpFrame;
+    rawBacktrace(&warmUpFrame, 1);
+
+    // The handler is never uninstalled: a SIGPROF which is still pending after the timer is
+    // disarmed would otherwise terminate the process.
+    if (!signalHandlerInstalled) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = onProfilingSignal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            const int err = errno;
+            return {ErrorCodes::InternalError,
+                    str::stream() << "Failed to install the profiling signal handler: "
+                                  << errnoWithDescription(err)};
+        }
+        signalHandlerInstalled = true;
+    }
+
+    sampleStorage.reset(new Sample[maxSamples]);
+    nextSample.store(0);
+    droppedSamples.store(0);
+    sampleCapacity.store(maxSamples);
+    activeSamples.store(sampleStorage.get());
+
+    Status status = setProfilingTimer(samplesPerSecond);
+    if (!status.isOK()) {
+        activeSamples.store(nullptr);
+        sampleStorage.reset();
+    }
+    return status;
+}
+
+StatusWith<SamplingProfiler::Profile> SamplingProfiler::stop() {
+    stdx::lock_guard<stdx::mutex> lk(sessionMutex);
+    if (!activeSamples.load()) {
+        return {ErrorCodes::IllegalOperation, "No sampling profiler session is running"};
+    }
+
+    // Disarming the timer cannot fail with valid arguments; the samples are collected regardless.
+    setProfilingTimer(0).ignore();
+    activeSamples.store(nullptr);
+    while (runningHandlers.load() > 0) {
+        stdx::this_thread::yield();
+    }
+
+    Profile profile;
+    profile.numDroppedSamples = droppedSamples.load();
+
+    std::map<void*, std::string> symbols;
+    const size_t numSlots = std::min(nextSample.load(), sampleCapacity.load());
+    for (size_t i = 0; i < numSlots; ++i) {
+        const Sample& sample = sampleStorage[i];
+        if (!sample.complete.load(std::memory_order_acquire)) {
+            ++profile.numDroppedSamples;
+            continue;
+        }
+
+        std::string stack(sample.tag, sample.tagLength);
+        for (int frame = sample.numFrames - 1; frame >= sample.firstFrame; --frame) {
+            auto it = symbols.find(sample.frames[frame]);
+            if (it == symbols.end()) {
+                it = symbols
+                         .emplace(sample.frames[frame], symbolizeFrame(sample.frames[frame]))
+                         .first;
+            }
+            if (!stack.empty()) {
+                stack.push_back(';');
+            }
+            stack.append(it->second);
+        }
+
+        ++profile.collapsedStacks[stack];
+        ++profile.numSamples;
+    }
+
+    sampleStorage.reset();
+    return profile;
+}
+
+bool SamplingProfiler::isRunning() {
+    return activeSamples.load() != nullptr;
+}
+
+#endif
+
+}  // namespace mongo
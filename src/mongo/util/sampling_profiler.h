@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * In-process sampling CPU profiler.
+ *
+ * While running, the profiler arms a process-wide CPU-time interval timer (ITIMER_PROF). Every
+ * time it fires, the thread consuming CPU records its stack, along with the tag set on that thread
+ * through SamplingProfiler::ThreadTag, into a pre-allocated buffer. The signal handler does not
+ * allocate or take locks. Stacks are only symbolized and aggregated once profiling stops.
+ *
+ * Only one profiling session may run at a time. Not supported on Windows.
+ */
+class SamplingProfiler {
+public:
+    static constexpr int kMaxFramesPerSample = 64;
+    static constexpr size_t kMaxTagLength = 128;
+
+    /**
+     * Aggregated result of a profiling session. Stacks are keyed in "collapsed" form: the tag
+     * followed by the frames from the outermost caller to the sampled function, separated by
+     * semicolons. This is the input format of flame graph tools.
+     */
+    struct Profile {
+        std::map<std::string, long long> collapsedStacks;
+        long long numSamples = 0;
+        long long numDroppedSamples = 0;
+    };
+
+    /**
+     * Labels the samples taken on the current thread for as long as this object is in scope.
+     * Tags longer than kMaxTagLength are truncated. Tags nest: destroying a ThreadTag restores the
+     * enclosing one.
+     */
+    class ThreadTag {
+        MONGO_DISALLOW_COPYING(ThreadTag);
+
+    public:
+        explicit ThreadTag(StringData tag);
+        ThreadTag(StringData first, StringData second);
+        ~ThreadTag();
+
+    private:
+        char _saved[kMaxTagLength];
+        size_t _savedLength;
+    };
+
+    /**
+     * Starts sampling at "samplesPerSecond" per second of process CPU time, keeping at most
+     * "maxSamples" samples. Returns ConflictingOperationInProgress if a session is already
+     * running.
+     */
+    static Status start(int samplesPerSecond, size_t maxSamples);
+
+    /**
+     * Stops the running session and returns its aggregated samples.
+     */
+    static StatusWith<Profile> stop();
+
+    /**
+     * Returns true if a profiling session is running.
+     */
+    static bool isRunning();
+};
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+#if !defined(_WIN32)
+
+// Spins for 200ms, which at 1000 samples per second of CPU time yields about 200 samples.
+void burnCpu() {
+    volatile uint64_t x = 1;  // NOLINT
+    Timer timer;
+    while (timer.millis() < 200) {
+        for (int i = 0; i < 100000; ++i) {
+            x = x * 13 + i;
+        }
+    }
+}
+
+TEST(SamplingProfilerTest, CollectsTaggedStacks) {
+    ASSERT_OK(SamplingProfiler::start(1000, 10000));
+    ASSERT_TRUE(SamplingProfiler::isRunning());
+    {
+        SamplingProfiler::ThreadTag outer("find", "test.coll");
+        {
+            SamplingProfiler::ThreadTag inner("aggregate");
+            burnCpu();
+        }
+        burnCpu();
+    }
+    auto swProfile = SamplingProfiler::stop();
+    ASSERT_OK(swProfile.getStatus());
+    ASSERT_FALSE(SamplingProfiler::isRunning());
+
+    const auto& profile = swProfile.getValue();
+    ASSERT_GT(profile.numSamples, 0);
+
+    long long counted = 0;
+    long long innerSamples = 0;
+    long long outerSamples = 0;
+    for (const auto& stack : profile.collapsedStacks) {
+        counted += stack.second;
+        if (stack.first.find("aggregate;") == 0) {
+            innerSamples += stack.second;
+        } else if (stack.first.find("find test.coll;") == 0) {
+            outerSamples += stack.second;
+        }
+    }
+    ASSERT_EQ(profile.numSamples, counted);
+    ASSERT_GT(innerSamples, 0);
+    ASSERT_GT(outerSamples, 0);
+}
+
+TEST(SamplingProfilerTest, CountsDroppedSamples) {
+    ASSERT_OK(SamplingProfiler::start(1000, 1));
+    burnCpu();
+    auto swProfile = SamplingProfiler::stop();
+    ASSERT_OK(swProfile.getStatus());
+    ASSERT_EQ(1, swProfile.getValue().numSamples);
+    ASSERT_GT(swProfile.getValue().numDroppedSamples, 0);
+}
+
+TEST(SamplingProfilerTest, OnlyOneSessionAtATime) {
+    ASSERT_OK(SamplingProfiler::start(100, 10));
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress, SamplingProfiler::start(100, 10));
+    ASSERT_OK(SamplingProfiler::stop().getStatus());
+    ASSERT_EQ(ErrorCodes::IllegalOperation, SamplingProfiler::stop().getStatus());
+}
+
+TEST(SamplingProfilerTest, RejectsInvalidOptions) {
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(0, 10));
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(1001, 10));
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(100, 0));
+    ASSERT_FALSE(SamplingProfiler::isRunning());
+}
+
+TEST(SamplingProfilerTest, TruncatesLongTags) {
+    ASSERT_OK(SamplingProfiler::start(1000, 10000));
+    {
+        SamplingProfiler::ThreadTag tag(std::string(2 * SamplingProfiler::kMaxTagLength, 'x'));
+        burnCpu();
+    }
+    auto swProfile = SamplingProfiler::stop();
+    ASSERT_OK(swProfile.getStatus());
+
+    const std::string expectedTag(SamplingProfiler::kMaxTagLength, 'x');
+    for (const auto& stack : swProfile.getValue().collapsedStacks) {
+        if (stack.first.find('x') == 0) {
+            ASSERT_EQ(expectedTag + ";", stack.first.substr(0, expectedTag.size() + 1));
+        }
+    }
+}
+
+#endif
+
+}  // namespace
+}  // namespace mongo
@@ -45,6 +45,13 @@ namespace mongo {
 void printStackTrace(std::ostream& os);
 void printStackTrace();
 
+#if !defined(_WIN32)
+// Store up to "maxFrames" return addresses of the current thread's stack in "addresses", and
+// return how many were stored, or 0 if the platform cannot unwind. Does not allocate, so it may be
+// called from a signal handler once it has been called at least once outside of one.
+int rawBacktrace(void** addresses, int maxFrames);
+#endif
+
 #if defined(_WIN32)
 // Print stack trace (using a specified stack context) to "os", default to the log stream.
 void printWindowsStackTrace(CONTEXT& context, std::ostream& os);
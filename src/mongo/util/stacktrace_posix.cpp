@@ -245,6 +245,14 @@ void printStackTrace(std::ostream& os) {
 
 #endif
 
+int rawBacktrace(void** addresses, int maxFrames) {
+#if defined(MONGO_NO_BACKTRACE)
+    return 0;
+#else
+    return backtrace(addresses, maxFrames);
+#endif
+}
+
 namespace {
 
 void addOSComponentsToSoMap(BSONObjBuilder* soMap);
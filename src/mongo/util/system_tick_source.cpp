@@ -38,6 +38,14 @@
 #include <unistd.h>
 #endif
 
+#if defined(__linux__) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONGO_TICK_SOURCE_HAVE_TSC
+#include <cpuid.h>
+#include <fstream>
+#include <string>
+#include <x86intrin.h>
+#endif
+
 #include "mongo/base/init.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
@@ -115,6 +123,58 @@ TickSource::Tick timerNowPosixMonotonicClock() {
     return result;
 }
 
+#if defined(MONGO_TICK_SOURCE_HAVE_TSC)
+
+/**
+ * Implementation for timer reading the x86 time stamp counter directly, which saves the
+ * scaling and the seqlock loop that clock_gettime() does in the vDSO.
+ */
+TickSource::Tick timerNowTsc() {
+    return static_cast<TickSource::Tick>(__rdtsc());
+}
+
+/**
+ * The TSC is only a usable tick source if it runs at a constant rate in every P- and C-state
+ * (invariant TSC) and the kernel also trusts it to be synchronized across CPUs, which it shows
+ * by using it as the system clocksource. Anything else, including most hypervisors that do not
+ * pass the TSC through, keeps using CLOCK_MONOTONIC.
+ */
+bool tscIsUsable() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        return false;
+    }
+
+    std::ifstream clocksource("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string name;
+    return (clocksource >> name) && name == "tsc";
+}
+
+/**
+ * Returns the TSC frequency, exactly from CPUID leaf 0x15 where the processor reports it, and
+ * otherwise measured against CLOCK_MONOTONIC.
+ */
+TickSource::Tick tscTicksPerSecond() {
+    unsigned int denominator, numerator, crystalHz, edx;
+    if (__get_cpuid(0x15, &denominator, &numerator, &crystalHz, &edx) && denominator &&
+        numerator && crystalHz) {
+        return static_cast<TickSource::Tick>(crystalHz) * numerator / denominator;
+    }
+
+    const TickSource::Tick startNanos = timerNowPosixMonotonicClock();
+    const TickSource::Tick startTicks = timerNowTsc();
+    TickSource::Tick elapsedNanos;
+    do {
+        elapsedNanos = timerNowPosixMonotonicClock() - startNanos;
+    } while (elapsedNanos < 10 * kNanosPerSecond / kMillisPerSecond);
+    const TickSource::Tick elapsedTicks = timerNowTsc() - startTicks;
+
+    return static_cast<TickSource::Tick>(static_cast<long double>(elapsedTicks) *
+                                         kNanosPerSecond / elapsedNanos);
+}
+
+#endif  // MONGO_TICK_SOURCE_HAVE_TSC
+
 void initTickSource() {
     // If the monotonic clock is not available at runtime (sysconf() returns 0 or -1),
     // do not override the generic implementation or modify ticksPerSecond.
@@ -131,6 +191,16 @@ void initTickSource() {
     timespec the_time;
     fassert(16162, !clock_gettime(CLOCK_MONOTONIC, &the_time));
     fassert(16163, static_cast<long long>(the_time.tv_sec) < maxSecs);
+
+#if defined(MONGO_TICK_SOURCE_HAVE_TSC)
+    if (tscIsUsable()) {
+        const TickSource::Tick tscHz = tscTicksPerSecond();
+        if (tscHz > 0) {
+            ticksPerSecond = tscHz;
+            _timerNow = &timerNowTsc;
+        }
+    }
+#endif
 }
 #else
 void initTickSource() {}